@@ -622,6 +622,27 @@ undefine([Ac_cachevar])dnl
 ])# PGAC_SSE42_CRC32_INTRINSICS
 
 
+# PGAC_AVX2_TARGET_RUNTIME_CHECK
+# ------------------------------
+# Check if the compiler can compile individual functions for AVX2, using
+# __attribute__((target("avx2"))), and check at runtime whether the CPU
+# supports it, using __builtin_cpu_supports("avx2").  If so, sets
+# pgac_cv_avx2_target_runtime_check to yes.
+AC_DEFUN([PGAC_AVX2_TARGET_RUNTIME_CHECK],
+[AC_CACHE_CHECK([for __attribute__((target("avx2"))) and __builtin_cpu_supports], pgac_cv_avx2_target_runtime_check,
+[AC_LINK_IFELSE([AC_LANG_PROGRAM([__attribute__((target("avx2")))
+static int
+avx2_test(int x)
+{
+	return x + 1;
+}],
+  [if (__builtin_cpu_supports("avx2"))
+     return avx2_test(0);])],
+  [pgac_cv_avx2_target_runtime_check=yes],
+  [pgac_cv_avx2_target_runtime_check=no])])
+])# PGAC_AVX2_TARGET_RUNTIME_CHECK
+
+
 # PGAC_ARMV8_CRC32C_INTRINSICS
 # ----------------------------
 # Check if the compiler supports the CRC32C instructions using the __crc32cb,
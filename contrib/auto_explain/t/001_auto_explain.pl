@@ -6,7 +6,7 @@ use warnings;
 
 use PostgresNode;
 use TestLib;
-use Test::More tests => 4;
+use Test::More tests => 7;
 
 my $node = get_new_node('main');
 $node->init;
@@ -21,6 +21,22 @@ $node->safe_psql("postgres", "SELECT * FROM pg_class;");
 $node->safe_psql("postgres",
 	"SELECT * FROM pg_proc WHERE proname = 'int4pl';");
 
+# COPY TO with PARALLEL runs a query, which can use a parallel scan, but not
+# of the table's inheritance children
+$node->safe_psql(
+	"postgres", q{
+CREATE TABLE copy_parallel (a int) WITH (parallel_workers = 2);
+INSERT INTO copy_parallel SELECT generate_series(1, 1000);
+CREATE TABLE copy_parallel_child () INHERITS (copy_parallel);
+INSERT INTO copy_parallel_child VALUES (0);
+ANALYZE copy_parallel;
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+SET max_parallel_workers_per_gather = 2;
+COPY copy_parallel TO stdout (parallel);
+});
+
 # emit some json too
 $node->append_conf('postgresql.conf', "auto_explain.log_format = json");
 $node->reload;
@@ -28,6 +44,12 @@ $node->safe_psql("postgres", "SELECT * FROM pg_proc;");
 $node->safe_psql("postgres",
 	"SELECT * FROM pg_class WHERE relname = 'pg_class';");
 
+# time only a sample of node executions
+$node->append_conf('postgresql.conf', "auto_explain.log_timing_sampled = on");
+$node->reload;
+$node->safe_psql("postgres",
+	"SELECT count(*) FROM generate_series(1, 1000) AS g;");
+
 $node->stop('fast');
 
 my $log = $node->logfile();
@@ -44,6 +66,16 @@ like(
 	qr/Index Scan using pg_proc_proname_args_nsp_index on pg_proc/,
 	"index scan logged, text mode");
 
+like(
+	$log_contents,
+	qr/Query Text: COPY copy_parallel TO stdout \(parallel\).*?Gather.*?Parallel Seq Scan on copy_parallel /s,
+	"parallel scan for COPY PARALLEL logged, text mode");
+
+unlike(
+	$log_contents,
+	qr/Seq Scan on copy_parallel_child/,
+	"COPY PARALLEL does not scan inheritance children");
+
 like(
 	$log_contents,
 	qr/"Node Type": "Seq Scan"[^}]*"Relation Name": "pg_proc"/s,
@@ -53,3 +85,8 @@ like(
 	$log_contents,
 	qr/"Node Type": "Index Scan"[^}]*"Index Name": "pg_class_relname_nsp_index"/s,
 	"index scan logged, json mode");
+
+like(
+	$log_contents,
+	qr/"Node Type": "Function Scan"[^}]*"Actual Total Time": [0-9.]+[^}]*"Actual Rows": 1000,/s,
+	"sampled timing logged, json mode");
@@ -27,12 +27,17 @@
 #include "commands/vacuum.h"
 #include "foreign/fdwapi.h"
 #include "foreign/foreign.h"
+#include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
+#include "optimizer/cost.h"
 #include "optimizer/optimizer.h"
 #include "optimizer/pathnode.h"
+#include "optimizer/paths.h"
 #include "optimizer/planmain.h"
 #include "optimizer/restrictinfo.h"
+#include "port/atomics.h"
+#include "storage/fd.h"
 #include "utils/acl.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
@@ -79,6 +84,9 @@ static const struct FileFdwOption valid_options[] = {
 	 * force_quote is not supported by file_fdw because it's for COPY TO.
 	 */
 
+	/* Scan options */
+	{"parallel", ForeignTableRelationId},
+
 	/* Sentinel */
 	{NULL, InvalidOid}
 };
@@ -96,6 +104,18 @@ typedef struct FileFdwPlanState
 	double		ntuples;		/* estimate of number of data rows */
 } FileFdwPlanState;
 
+/*
+ * Shared state of a parallel scan.  The file is divided into chunks of
+ * chunksize bytes, which the participating processes claim one at a time.
+ * A chunk's rows are those whose lines start within it.
+ */
+typedef struct FileFdwParallelState
+{
+	off_t		filesize;		/* size of the file when the scan started */
+	off_t		chunksize;		/* size of each chunk */
+	pg_atomic_uint64 nextchunk; /* next chunk to be claimed */
+} FileFdwParallelState;
+
 /*
  * FDW-specific information for ForeignScanState.fdw_state.
  */
@@ -105,9 +125,29 @@ typedef struct FileFdwExecutionState
 	bool		is_program;		/* true if filename represents an OS command */
 	List	   *options;		/* merged COPY options, excluding filename and
 								 * is_program */
-	CopyFromState cstate;		/* COPY execution state */
+	CopyFromState cstate;		/* COPY execution state, or NULL if not
+								 * started yet */
+
+	/* for parallel scans */
+	FileFdwParallelState *pstate;	/* shared state, or NULL */
+	int			fd;				/* file descriptor, or -1 if not open */
+	off_t		readpos;		/* next byte to read of the current chunk */
+	off_t		readend;		/* end of the current chunk's lines */
 } FileFdwExecutionState;
 
+/*
+ * Number of chunks per participating process that a parallel scan divides
+ * the file into.  More chunks balance the load better, at the price of
+ * looking for the line boundaries around each of them.
+ */
+#define FILE_FDW_CHUNKS_PER_PROCESS	16
+
+/*
+ * The scan whose data file_read_chunks() is currently reading.  COPY's data
+ * source callback has no argument to pass this in.
+ */
+static FileFdwExecutionState *chunk_festate = NULL;
+
 /*
  * SQL functions
  */
@@ -140,6 +180,17 @@ static bool fileAnalyzeForeignTable(Relation relation,
 									BlockNumber *totalpages);
 static bool fileIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
 										  RangeTblEntry *rte);
+static Size fileEstimateDSMForeignScan(ForeignScanState *node,
+									   ParallelContext *pcxt);
+static void fileInitializeDSMForeignScan(ForeignScanState *node,
+										 ParallelContext *pcxt,
+										 void *coordinate);
+static void fileReInitializeDSMForeignScan(ForeignScanState *node,
+										   ParallelContext *pcxt,
+										   void *coordinate);
+static void fileInitializeWorkerForeignScan(ForeignScanState *node,
+											shm_toc *toc,
+											void *coordinate);
 
 /*
  * Helper functions
@@ -150,6 +201,16 @@ static void fileGetOptions(Oid foreigntableid,
 						   bool *is_program,
 						   List **other_options);
 static List *get_file_fdw_attribute_options(Oid relid);
+static bool file_scan_can_be_split(Oid foreigntableid,
+								   FileFdwPlanState *fdw_private);
+static void file_add_partial_path(PlannerInfo *root, RelOptInfo *baserel,
+								  FileFdwPlanState *fdw_private,
+								  Cost startup_cost, Cost total_cost,
+								  List *coptions);
+static void file_begin_copy(ForeignScanState *node,
+							FileFdwExecutionState *festate);
+static int	file_read_chunks(void *outbuf, int minread, int maxread);
+static off_t file_line_start(FileFdwExecutionState *festate, off_t offset);
 static bool check_selective_binary_conversion(RelOptInfo *baserel,
 											  Oid foreigntableid,
 											  List **columns);
@@ -182,6 +243,10 @@ file_fdw_handler(PG_FUNCTION_ARGS)
 	fdwroutine->EndForeignScan = fileEndForeignScan;
 	fdwroutine->AnalyzeForeignTable = fileAnalyzeForeignTable;
 	fdwroutine->IsForeignScanParallelSafe = fileIsForeignScanParallelSafe;
+	fdwroutine->EstimateDSMForeignScan = fileEstimateDSMForeignScan;
+	fdwroutine->InitializeDSMForeignScan = fileInitializeDSMForeignScan;
+	fdwroutine->ReInitializeDSMForeignScan = fileReInitializeDSMForeignScan;
+	fdwroutine->InitializeWorkerForeignScan = fileInitializeWorkerForeignScan;
 
 	PG_RETURN_POINTER(fdwroutine);
 }
@@ -309,6 +374,9 @@ file_fdw_validator(PG_FUNCTION_ARGS)
 			force_null = def;
 			(void) defGetBoolean(def);
 		}
+		/* parallel is ours, not COPY's; just check that it's a boolean */
+		else if (strcmp(def->defname, "parallel") == 0)
+			(void) defGetBoolean(def);
 		else
 			other_options = lappend(other_options, def);
 	}
@@ -383,7 +451,8 @@ fileGetOptions(Oid foreigntableid,
 
 	/*
 	 * Separate out the filename or program option (we assume there is only
-	 * one).
+	 * one).  The parallel option is none of COPY's business either; we look
+	 * it up separately where it's needed.
 	 */
 	*filename = NULL;
 	*is_program = false;
@@ -395,15 +464,15 @@ fileGetOptions(Oid foreigntableid,
 		{
 			*filename = defGetString(def);
 			options = foreach_delete_current(options, lc);
-			break;
 		}
 		else if (strcmp(def->defname, "program") == 0)
 		{
 			*filename = defGetString(def);
 			*is_program = true;
 			options = foreach_delete_current(options, lc);
-			break;
 		}
+		else if (strcmp(def->defname, "parallel") == 0)
+			options = foreach_delete_current(options, lc);
 	}
 
 	/*
@@ -570,6 +639,15 @@ fileGetForeignPaths(PlannerInfo *root,
 									 NULL,	/* no extra plan */
 									 coptions));
 
+	/*
+	 * If the scan could be split between parallel workers, add a partial
+	 * path as well.  It can't be parameterized.
+	 */
+	if (baserel->consider_parallel && baserel->lateral_relids == NULL &&
+		file_scan_can_be_split(foreigntableid, fdw_private))
+		file_add_partial_path(root, baserel, fdw_private,
+							  startup_cost, total_cost, coptions);
+
 	/*
 	 * If data file was sorted, and we knew it somehow, we could insert
 	 * appropriate pathkeys into the ForeignPath node to tell the planner
@@ -655,7 +733,6 @@ fileBeginForeignScan(ForeignScanState *node, int eflags)
 	char	   *filename;
 	bool		is_program;
 	List	   *options;
-	CopyFromState cstate;
 	FileFdwExecutionState *festate;
 
 	/*
@@ -671,19 +748,6 @@ fileBeginForeignScan(ForeignScanState *node, int eflags)
 	/* Add any options from the plan (currently only convert_selectively) */
 	options = list_concat(options, plan->fdw_private);
 
-	/*
-	 * Create CopyState from FDW options.  We always acquire all columns, so
-	 * as to match the expected ScanTupleSlot signature.
-	 */
-	cstate = BeginCopyFrom(NULL,
-						   node->ss.ss_currentRelation,
-						   NULL,
-						   filename,
-						   is_program,
-						   NULL,
-						   NIL,
-						   options);
-
 	/*
 	 * Save state in node->fdw_state.  We must save enough information to call
 	 * BeginCopyFrom() again.
@@ -692,9 +756,51 @@ fileBeginForeignScan(ForeignScanState *node, int eflags)
 	festate->filename = filename;
 	festate->is_program = is_program;
 	festate->options = options;
-	festate->cstate = cstate;
+	festate->cstate = NULL;
+	festate->pstate = NULL;
+	festate->fd = -1;
+	festate->readpos = 0;
+	festate->readend = 0;
 
 	node->fdw_state = (void *) festate;
+
+	/*
+	 * A parallel scan doesn't know yet whether it will read the whole file,
+	 * or the chunks it claims from the shared state that is set up later;
+	 * fileIterateForeignScan starts it.
+	 */
+	if (!plan->scan.plan.parallel_aware)
+		file_begin_copy(node, festate);
+}
+
+/*
+ * file_begin_copy
+ *		Create the CopyState that reads the file or program's data
+ *
+ * We always acquire all columns, so as to match the expected ScanTupleSlot
+ * signature.
+ */
+static void
+file_begin_copy(ForeignScanState *node, FileFdwExecutionState *festate)
+{
+	if (festate->pstate)
+		festate->cstate = BeginCopyFrom(NULL,
+										node->ss.ss_currentRelation,
+										NULL,
+										NULL,
+										false,
+										file_read_chunks,
+										NIL,
+										festate->options);
+	else
+		festate->cstate = BeginCopyFrom(NULL,
+										node->ss.ss_currentRelation,
+										NULL,
+										festate->filename,
+										festate->is_program,
+										NULL,
+										NIL,
+										festate->options);
 }
 
 /*
@@ -710,6 +816,12 @@ fileIterateForeignScan(ForeignScanState *node)
 	bool		found;
 	ErrorContextCallback errcallback;
 
+	/* Any chunks read while we're in here belong to this scan */
+	chunk_festate = festate;
+
+	if (festate->cstate == NULL)
+		file_begin_copy(node, festate);
+
 	/* Set up callback to identify error line number. */
 	errcallback.callback = CopyFromErrorCallback;
 	errcallback.arg = (void *) festate->cstate;
@@ -745,17 +857,18 @@ static void
 fileReScanForeignScan(ForeignScanState *node)
 {
 	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+	ForeignScan *plan = (ForeignScan *) node->ss.ps.plan;
 
-	EndCopyFrom(festate->cstate);
+	if (festate->cstate)
+		EndCopyFrom(festate->cstate);
+	festate->cstate = NULL;
+
+	/* A parallel scan starts over with the first chunk it claims */
+	festate->readpos = 0;
+	festate->readend = 0;
 
-	festate->cstate = BeginCopyFrom(NULL,
-									node->ss.ss_currentRelation,
-									NULL,
-									festate->filename,
-									festate->is_program,
-									NULL,
-									NIL,
-									festate->options);
+	if (!plan->scan.plan.parallel_aware)
+		file_begin_copy(node, festate);
 }
 
 /*
@@ -769,7 +882,14 @@ fileEndForeignScan(ForeignScanState *node)
 
 	/* if festate is NULL, we are in EXPLAIN; nothing to do */
 	if (festate)
-		EndCopyFrom(festate->cstate);
+	{
+		if (festate->cstate)
+			EndCopyFrom(festate->cstate);
+		if (festate->fd >= 0)
+			CloseTransientFile(festate->fd);
+		if (chunk_festate == festate)
+			chunk_festate = NULL;
+	}
 }
 
 /*
@@ -834,6 +954,307 @@ fileIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel,
 	return true;
 }
 
+/*
+ * fileEstimateDSMForeignScan
+ *		Estimate the size of the shared state of a parallel scan
+ */
+static Size
+fileEstimateDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt)
+{
+	return sizeof(FileFdwParallelState);
+}
+
+/*
+ * fileInitializeDSMForeignScan
+ *		Divide the file into chunks for a parallel scan
+ */
+static void
+fileInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt,
+							 void *coordinate)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+	FileFdwParallelState *pstate = (FileFdwParallelState *) coordinate;
+	struct stat stat_buf;
+	int			encoding = pg_get_client_encoding();
+	ListCell   *lc;
+
+	if (stat(festate->filename, &stat_buf) < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not stat file \"%s\": %m",
+						festate->filename)));
+
+	pstate->filesize = stat_buf.st_size;
+	pstate->chunksize = pstate->filesize /
+		(FILE_FDW_CHUNKS_PER_PROCESS * (pcxt->nworkers + 1));
+	pstate->chunksize = Max(pstate->chunksize, 1);
+	pg_atomic_init_u64(&pstate->nextchunk, 0);
+
+	/*
+	 * In the client-only encodings, the second byte of a multibyte character
+	 * can look like a backslash, so file_line_start() could take a newline
+	 * to be escaped when it isn't.  Read such files in a single chunk.
+	 */
+	foreach(lc, festate->options)
+	{
+		DefElem    *def = (DefElem *) lfirst(lc);
+
+		if (strcmp(def->defname, "encoding") == 0)
+			encoding = pg_char_to_encoding(defGetString(def));
+	}
+	if (!PG_VALID_BE_ENCODING(encoding))
+		pstate->chunksize = pstate->filesize + 1;
+
+	festate->pstate = pstate;
+}
+
+/*
+ * fileReInitializeDSMForeignScan
+ *		Reset the shared state of a parallel scan, before a rescan
+ */
+static void
+fileReInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt,
+							   void *coordinate)
+{
+	FileFdwParallelState *pstate = (FileFdwParallelState *) coordinate;
+
+	pg_atomic_write_u64(&pstate->nextchunk, 0);
+}
+
+/*
+ * fileInitializeWorkerForeignScan
+ *		Attach a parallel worker to the shared state of a parallel scan
+ */
+static void
+fileInitializeWorkerForeignScan(ForeignScanState *node, shm_toc *toc,
+								void *coordinate)
+{
+	FileFdwExecutionState *festate = (FileFdwExecutionState *) node->fdw_state;
+
+	festate->pstate = (FileFdwParallelState *) coordinate;
+}
+
+/*
+ * file_scan_can_be_split
+ *		Check whether the scan can be divided between parallel workers
+ *
+ * Only reading a file can be divided, and only in text format: that's the
+ * only format in which every unescaped newline ends a row, so that a worker
+ * can find where the rows start by looking at a few bytes before its chunk.
+ * CSV fields can contain newlines within quotes, and the binary format has
+ * no line structure at all.  And the user has to ask for it, since rows are
+ * returned in no particular order, and the line number reported with a
+ * data error counts the lines each process has read.
+ */
+static bool
+file_scan_can_be_split(Oid foreigntableid, FileFdwPlanState *fdw_private)
+{
+	ForeignTable *table = GetForeignTable(foreigntableid);
+	bool		parallel = false;
+	ListCell   *lc;
+
+	if (fdw_private->is_program)
+		return false;
+
+	foreach(lc, table->options)
+	{
+		DefElem    *def = (DefElem *) lfirst(lc);
+
+		if (strcmp(def->defname, "parallel") == 0)
+			parallel = defGetBoolean(def);
+	}
+	if (!parallel)
+		return false;
+
+	foreach(lc, fdw_private->options)
+	{
+		DefElem    *def = (DefElem *) lfirst(lc);
+
+		if (strcmp(def->defname, "format") == 0 &&
+			strcmp(defGetString(def), "text") != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * file_add_partial_path
+ *		Add a path that scans a part of the file, for use below a Gather
+ */
+static void
+file_add_partial_path(PlannerInfo *root, RelOptInfo *baserel,
+					  FileFdwPlanState *fdw_private,
+					  Cost startup_cost, Cost total_cost,
+					  List *coptions)
+{
+	ForeignPath *path;
+	int			parallel_workers;
+	double		parallel_divisor;
+
+	parallel_workers = compute_parallel_worker(baserel, fdw_private->pages,
+											   -1,
+											   max_parallel_workers_per_gather);
+	if (parallel_workers <= 0)
+		return;
+
+	/* Count the leader's share, as cost_seqscan() does */
+	parallel_divisor = parallel_workers;
+	if (parallel_leader_participation)
+	{
+		double		leader_contribution;
+
+		leader_contribution = 1.0 - (0.3 * parallel_workers);
+		if (leader_contribution > 0)
+			parallel_divisor += leader_contribution;
+	}
+
+	path = create_foreignscan_path(root, baserel,
+								   NULL,	/* default pathtarget */
+								   clamp_row_est(baserel->rows / parallel_divisor),
+								   startup_cost,
+								   startup_cost +
+								   (total_cost - startup_cost) / parallel_divisor,
+								   NIL, /* no pathkeys */
+								   NULL,	/* no required outer rels */
+								   NULL,	/* no extra plan */
+								   coptions);
+	path->path.parallel_aware = true;
+	path->path.parallel_workers = parallel_workers;
+
+	add_partial_path(baserel, (Path *) path);
+}
+
+/*
+ * file_read_chunks
+ *		COPY data source callback for a parallel scan
+ *
+ * Returns the lines of the chunks this process claims, one chunk after the
+ * other.  Since the chunks end at line boundaries, COPY sees a stream of
+ * whole lines, as it would reading the file.
+ */
+static int
+file_read_chunks(void *outbuf, int minread, int maxread)
+{
+	FileFdwExecutionState *festate = chunk_festate;
+	FileFdwParallelState *pstate = festate->pstate;
+	int			nread;
+
+	Assert(festate != NULL && pstate != NULL);
+
+	while (festate->readpos >= festate->readend)
+	{
+		uint64		chunk;
+		off_t		start;
+		off_t		end;
+
+		chunk = pg_atomic_fetch_add_u64(&pstate->nextchunk, 1);
+		if (chunk >= (uint64) (pstate->filesize / pstate->chunksize + 1))
+			return 0;			/* no more chunks; EOF */
+
+		start = chunk * pstate->chunksize;
+		end = Min(start + pstate->chunksize, pstate->filesize);
+
+		if (festate->fd < 0)
+		{
+			festate->fd = OpenTransientFile(festate->filename,
+											O_RDONLY | PG_BINARY);
+			if (festate->fd < 0)
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not open file \"%s\" for reading: %m",
+								festate->filename)));
+		}
+
+		/* a chunk's lines may well all start in an earlier chunk */
+		festate->readpos = file_line_start(festate, start);
+		festate->readend = file_line_start(festate, end);
+	}
+
+	nread = pg_pread(festate->fd, outbuf,
+					 Min(maxread, festate->readend - festate->readpos),
+					 festate->readpos);
+	if (nread < 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not read file \"%s\": %m",
+						festate->filename)));
+	if (nread == 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("file \"%s\" was truncated during the scan",
+						festate->filename)));
+	festate->readpos += nread;
+
+	return nread;
+}
+
+/*
+ * file_line_start
+ *		Find the start of the first line that starts at or after 'offset'
+ *
+ * A line starts after a newline that isn't escaped by a backslash, which it
+ * is if an odd number of backslashes precedes it.  Returns the file size if
+ * no line starts there.
+ */
+static off_t
+file_line_start(FileFdwExecutionState *festate, off_t offset)
+{
+	off_t		filesize = festate->pstate->filesize;
+	char		buf[BLCKSZ];
+	off_t		pos;
+
+	if (offset == 0 || offset >= filesize)
+		return Min(offset, filesize);
+
+	/* the line starts right at 'offset' if the byte before is a newline */
+	pos = offset - 1;
+	while (pos < filesize)
+	{
+		int			nread;
+
+		nread = pg_pread(festate->fd, buf, Min(sizeof(buf), filesize - pos),
+						 pos);
+		if (nread < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read file \"%s\": %m",
+							festate->filename)));
+		if (nread == 0)
+			break;
+
+		for (int i = 0; i < nread; i++)
+		{
+			off_t		lfpos = pos + i;
+			off_t		bspos;
+			char		c;
+
+			if (buf[i] != '\n')
+				continue;
+
+			/* count the backslashes before the newline */
+			for (bspos = lfpos - 1; bspos >= 0; bspos--)
+			{
+				if (bspos >= pos)
+					c = buf[bspos - pos];
+				else if (pg_pread(festate->fd, &c, 1, bspos) != 1)
+					ereport(ERROR,
+							(errcode_for_file_access(),
+							 errmsg("could not read file \"%s\": %m",
+									festate->filename)));
+				if (c != '\\')
+					break;
+			}
+			if ((lfpos - 1 - bspos) % 2 == 0)
+				return lfpos + 1;
+		}
+
+		pos += nread;
+	}
+
+	return filesize;
+}
+
 /*
  * check_selective_binary_conversion
  *
@@ -433,6 +433,9 @@ void
 autoprewarm_database_main(Datum main_arg)
 {
 	int			pos;
+#ifdef USE_PREFETCH
+	int			prefetch_pos = 0;
+#endif
 	BlockInfoRecord *block_info;
 	Relation	rel = NULL;
 	BlockNumber nblocks = 0;
@@ -536,6 +539,34 @@ autoprewarm_database_main(Datum main_arg)
 			continue;
 		}
 
+#ifdef USE_PREFETCH
+
+		/*
+		 * The records are sorted by relation, fork and block number, so the
+		 * next few records usually belong to the fork we're reading.  Issue
+		 * prefetch requests for up to maintenance_io_concurrency of them, so
+		 * that the kernel can be reading those blocks while we wait for this
+		 * one.  Stop at the first record for a different fork; its blocks
+		 * will be prefetched once we get there.
+		 */
+		if (prefetch_pos < pos)
+			prefetch_pos = pos;
+		while (prefetch_pos < apw_state->prewarm_stop_idx &&
+			   prefetch_pos < pos + maintenance_io_concurrency)
+		{
+			BlockInfoRecord *pblk = &block_info[prefetch_pos];
+
+			if (pblk->database != blk->database ||
+				pblk->tablespace != blk->tablespace ||
+				pblk->filenode != blk->filenode ||
+				pblk->forknum != blk->forknum)
+				break;
+			if (pblk->blocknum < nblocks)
+				(void) PrefetchBuffer(rel, blk->forknum, pblk->blocknum);
+			prefetch_pos++;
+		}
+#endif
+
 		/* Prewarm buffer. */
 		buf = ReadBufferExtended(rel, blk->forknum, blk->blocknum, RBM_NORMAL,
 								 NULL);
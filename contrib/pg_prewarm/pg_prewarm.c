@@ -18,6 +18,7 @@
 #include "access/relation.h"
 #include "fmgr.h"
 #include "miscadmin.h"
+#include "port/pg_iovec.h"
 #include "storage/bufmgr.h"
 #include "storage/smgr.h"
 #include "utils/acl.h"
@@ -175,11 +176,23 @@ pg_prewarm(PG_FUNCTION_ARGS)
 		 * buffers.  This is more portable than prefetch mode (it works
 		 * everywhere) and is synchronous.
 		 */
-		for (block = first_block; block <= last_block; ++block)
+		char	   *blocks[PG_IOV_MAX];
+
+		/*
+		 * Since the data is thrown away, all the iovecs can point at the same
+		 * buffer; we only care that the kernel reads the blocks.
+		 */
+		for (int i = 0; i < PG_IOV_MAX; i++)
+			blocks[i] = blockbuffer.data;
+
+		for (block = first_block; block <= last_block;)
 		{
+			BlockNumber nblocks = Min(last_block - block + 1, PG_IOV_MAX);
+
 			CHECK_FOR_INTERRUPTS();
-			smgrread(rel->rd_smgr, forkNumber, block, blockbuffer.data);
-			++blocks_done;
+			smgrreadv(rel->rd_smgr, forkNumber, block, blocks, nblocks);
+			block += nblocks;
+			blocks_done += nblocks;
 		}
 	}
 	else if (ptype == PREWARM_BUFFER)
@@ -0,0 +1,60 @@
+/* contrib/pg_stat_sampler/pg_stat_sampler--1.0.sql */
+
+-- complain if script is sourced in psql, rather than via CREATE EXTENSION
+\echo Use "CREATE EXTENSION pg_stat_sampler" to load this file. \quit
+
+-- Register functions.
+CREATE FUNCTION pg_stat_sampler_reset()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C PARALLEL SAFE;
+
+CREATE FUNCTION pg_stat_sampler_history(
+    OUT sample_time timestamp with time zone,
+    OUT pid int4,
+    OUT userid oid,
+    OUT dbid oid,
+    OUT queryid bigint,
+    OUT wait_event_type text,
+    OUT wait_event text
+)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE PARALLEL SAFE;
+
+CREATE FUNCTION pg_stat_sampler_profile(
+    OUT userid oid,
+    OUT dbid oid,
+    OUT queryid bigint,
+    OUT wait_event_type text,
+    OUT wait_event text,
+    OUT samples int8
+)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE PARALLEL SAFE;
+
+CREATE FUNCTION pg_stat_sampler_info(
+    OUT dropped bigint,
+    OUT stats_reset timestamp with time zone
+)
+RETURNS record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE PARALLEL SAFE;
+
+-- Register views on the functions for ease of use.
+CREATE VIEW pg_stat_sampler_history AS
+  SELECT * FROM pg_stat_sampler_history();
+
+CREATE VIEW pg_stat_sampler_profile AS
+  SELECT * FROM pg_stat_sampler_profile();
+
+CREATE VIEW pg_stat_sampler_info AS
+  SELECT * FROM pg_stat_sampler_info();
+
+GRANT SELECT ON pg_stat_sampler_history TO PUBLIC;
+GRANT SELECT ON pg_stat_sampler_profile TO PUBLIC;
+GRANT SELECT ON pg_stat_sampler_info TO PUBLIC;
+
+-- Don't want this to be available to non-superusers.
+REVOKE ALL ON FUNCTION pg_stat_sampler_reset() FROM PUBLIC;
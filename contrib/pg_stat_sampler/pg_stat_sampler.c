@@ -0,0 +1,695 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_stat_sampler.c
+ *		Periodically sample what the active backends are doing.
+ *
+ * A background worker wakes up every pg_stat_sampler.interval milliseconds
+ * and records, for each backend that is running a command, its query ID and
+ * the wait event it is blocked on (if any; a sample with no wait event means
+ * the backend was on CPU).  The samples are kept in a ring buffer of recent
+ * history, and are also counted in a hash table keyed by user, database,
+ * query ID and wait event.  The counts give a statistical profile of where
+ * active backends spend their time, which can be joined with
+ * pg_stat_statements on the query ID.
+ *
+ * The sampler only reads the few fields it needs from each backend's PGPROC
+ * and backend status entry, without taking any lock the backends themselves
+ * would contend on, so sampling costs the backends nothing.
+ *
+ * Locking: pss->lock protects the history buffer and the profile hash table.
+ * The sampler takes it exclusively once per sampling round, to add that
+ * round's samples; readers take it shared.
+ *
+ *
+ * Copyright (c) 2008-2021, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  contrib/pg_stat_sampler/pg_stat_sampler.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "catalog/pg_authid.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/interrupt.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "utils/acl.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/hsearch.h"
+#include "utils/timestamp.h"
+#include "utils/tuplestore.h"
+
+PG_MODULE_MAGIC;
+
+/*
+ * One sample of one backend.
+ */
+typedef struct pssSample
+{
+	TimestampTz sample_time;	/* when the sampling round started */
+	int			pid;			/* backend's PID */
+	Oid			userid;			/* user OID */
+	Oid			dbid;			/* database OID */
+	uint32		wait_event_info;	/* wait event, or 0 if on CPU */
+	uint64		queryid;		/* query identifier, or 0 if unknown */
+} pssSample;
+
+/*
+ * Hashtable key that identifies a profile entry.
+ *
+ * Note: this includes padding, so it must be zeroed before use.
+ */
+typedef struct pssProfileKey
+{
+	Oid			userid;			/* user OID */
+	Oid			dbid;			/* database OID */
+	uint64		queryid;		/* query identifier */
+	uint32		wait_event_info;	/* wait event, or 0 if on CPU */
+} pssProfileKey;
+
+/*
+ * Profile entry: number of samples taken with a given key.
+ */
+typedef struct pssProfileEntry
+{
+	pssProfileKey key;			/* hash key of entry - MUST BE FIRST */
+	int64		samples;		/* number of samples */
+} pssProfileEntry;
+
+/*
+ * Global shared state
+ */
+typedef struct pssSharedState
+{
+	LWLock	   *lock;			/* protects all of the below */
+	uint64		history_next;	/* total samples ever added to history */
+	int64		dropped;		/* samples not counted, profile was full */
+	TimestampTz stats_reset;	/* timestamp with all samples reset */
+	pssSample	history[FLEXIBLE_ARRAY_MEMBER];	/* ring buffer */
+} pssSharedState;
+
+/*---- Local variables ----*/
+
+/* Saved hook values in case of unload */
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+/* Links to shared memory state */
+static pssSharedState *pss = NULL;
+static HTAB *pss_hash = NULL;
+
+/*---- GUC variables ----*/
+
+static int	pss_interval;		/* sampling interval, in ms */
+static int	pss_history_size;	/* number of samples kept in history */
+static int	pss_max;			/* max # profile entries to keep */
+
+/*---- Function declarations ----*/
+
+void		_PG_init(void);
+void		_PG_fini(void);
+
+PGDLLEXPORT void pg_stat_sampler_main(Datum main_arg);
+
+PG_FUNCTION_INFO_V1(pg_stat_sampler_reset);
+PG_FUNCTION_INFO_V1(pg_stat_sampler_history);
+PG_FUNCTION_INFO_V1(pg_stat_sampler_profile);
+PG_FUNCTION_INFO_V1(pg_stat_sampler_info);
+
+static void pss_shmem_startup(void);
+static Size pss_memsize(void);
+static int	pss_collect_samples(pssSample *samples, int maxsamples);
+static void pss_store_samples(pssSample *samples, int nsamples);
+static Tuplestorestate *pss_begin_srf(FunctionCallInfo fcinfo,
+									  TupleDesc *tupdesc);
+
+
+/*
+ * Module load callback
+ */
+void
+_PG_init(void)
+{
+	BackgroundWorker worker;
+
+	/*
+	 * In order to create our shared memory area and start the sampler, we
+	 * have to be loaded via shared_preload_libraries.  If not, fall out
+	 * without doing anything; the SQL functions protect themselves against
+	 * being called then.
+	 */
+	if (!process_shared_preload_libraries_in_progress)
+		return;
+
+	/*
+	 * Define (or redefine) custom GUC variables.
+	 */
+	DefineCustomIntVariable("pg_stat_sampler.interval",
+							"Sets the interval between samples of the active backends.",
+							NULL,
+							&pss_interval,
+							10,
+							1,
+							60 * 1000,
+							PGC_SIGHUP,
+							GUC_UNIT_MS,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("pg_stat_sampler.history_size",
+							"Sets the number of recent samples kept by pg_stat_sampler.",
+							NULL,
+							&pss_history_size,
+							5000,
+							0,
+							INT_MAX / 2,
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable("pg_stat_sampler.max",
+							"Sets the maximum number of profile entries tracked by pg_stat_sampler.",
+							NULL,
+							&pss_max,
+							5000,
+							100,
+							INT_MAX,
+							PGC_POSTMASTER,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
+	EmitWarningsOnPlaceholders("pg_stat_sampler");
+
+	/*
+	 * Request additional shared resources.  (These are no-ops if we're not in
+	 * the postmaster process.)  We'll allocate or attach to the shared
+	 * resources in pss_shmem_startup().
+	 */
+	RequestAddinShmemSpace(pss_memsize());
+	RequestNamedLWLockTranche("pg_stat_sampler", 1);
+
+	/*
+	 * Install hooks.
+	 */
+	prev_shmem_startup_hook = shmem_startup_hook;
+	shmem_startup_hook = pss_shmem_startup;
+
+	/*
+	 * Register the sampler.
+	 */
+	MemSet(&worker, 0, sizeof(BackgroundWorker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_ConsistentState;
+	worker.bgw_restart_time = 10;
+	strcpy(worker.bgw_library_name, "pg_stat_sampler");
+	strcpy(worker.bgw_function_name, "pg_stat_sampler_main");
+	strcpy(worker.bgw_name, "pg_stat_sampler");
+	strcpy(worker.bgw_type, "pg_stat_sampler");
+	RegisterBackgroundWorker(&worker);
+}
+
+/*
+ * Module unload callback
+ */
+void
+_PG_fini(void)
+{
+	/* Uninstall hooks. */
+	shmem_startup_hook = prev_shmem_startup_hook;
+}
+
+/*
+ * shmem_startup hook: allocate or attach to shared memory.
+ */
+static void
+pss_shmem_startup(void)
+{
+	bool		found;
+	HASHCTL		info;
+
+	if (prev_shmem_startup_hook)
+		prev_shmem_startup_hook();
+
+	/* reset in case this is a restart within the postmaster */
+	pss = NULL;
+	pss_hash = NULL;
+
+	/*
+	 * Create or attach to the shared memory state, including hash table
+	 */
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+
+	pss = ShmemInitStruct("pg_stat_sampler",
+						  add_size(offsetof(pssSharedState, history),
+								   mul_size(pss_history_size,
+											sizeof(pssSample))),
+						  &found);
+
+	if (!found)
+	{
+		/* First time through ... */
+		pss->lock = &(GetNamedLWLockTranche("pg_stat_sampler"))->lock;
+		pss->history_next = 0;
+		pss->dropped = 0;
+		pss->stats_reset = GetCurrentTimestamp();
+	}
+
+	info.keysize = sizeof(pssProfileKey);
+	info.entrysize = sizeof(pssProfileEntry);
+	pss_hash = ShmemInitHash("pg_stat_sampler hash",
+							 pss_max, pss_max,
+							 &info,
+							 HASH_ELEM | HASH_BLOBS);
+
+	LWLockRelease(AddinShmemInitLock);
+}
+
+/*
+ * Estimate shared memory space needed.
+ */
+static Size
+pss_memsize(void)
+{
+	Size		size;
+
+	size = MAXALIGN(offsetof(pssSharedState, history));
+	size = add_size(size, mul_size(pss_history_size, sizeof(pssSample)));
+	size = add_size(size, hash_estimate_size(pss_max, sizeof(pssProfileEntry)));
+
+	return size;
+}
+
+/*
+ * Main entry point of the sampler background worker.
+ */
+void
+pg_stat_sampler_main(Datum main_arg)
+{
+	pssSample  *samples;
+	int			maxsamples;
+
+	/* Establish signal handlers; once that's done, unblock signals. */
+	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	BackgroundWorkerUnblockSignals();
+
+	/* Space for one round of samples; the set of PGPROCs is fixed */
+	maxsamples = ProcGlobal->allProcCount;
+	samples = palloc(maxsamples * sizeof(pssSample));
+
+	while (!ShutdownRequestPending)
+	{
+		int			nsamples;
+
+		/* In case of a SIGHUP, just reload the configuration. */
+		if (ConfigReloadPending)
+		{
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		nsamples = pss_collect_samples(samples, maxsamples);
+		if (nsamples > 0)
+			pss_store_samples(samples, nsamples);
+
+		(void) WaitLatch(MyLatch,
+						 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						 pss_interval,
+						 PG_WAIT_EXTENSION);
+		ResetLatch(MyLatch);
+	}
+
+	proc_exit(0);
+}
+
+/*
+ * Take one sample of every backend that is running a command.
+ *
+ * No lock is taken: the PGPROC fields read here are each read atomically, as
+ * pg_stat_activity does, and the backend status entry is read with its
+ * changecount protocol.  A backend that exits or starts a new command while
+ * we look at it may be sampled with slightly inconsistent fields, which does
+ * no harm to a statistical profile.
+ */
+static int
+pss_collect_samples(pssSample *samples, int maxsamples)
+{
+	TimestampTz now = GetCurrentTimestamp();
+	int			nsamples = 0;
+	int			i;
+
+	for (i = 0; i < ProcGlobal->allProcCount && nsamples < maxsamples; i++)
+	{
+		volatile PGPROC *proc = &ProcGlobal->allProcs[i];
+		pssSample  *sample = &samples[nsamples];
+		BackendState state;
+		uint64		queryid;
+		int			pid;
+		int			backendId;
+
+		pid = proc->pid;
+		backendId = proc->backendId;
+
+		/* Skip unused slots, prepared transactions and auxiliary processes */
+		if (pid == 0 || backendId == InvalidBackendId)
+			continue;
+
+		if (!pgstat_get_backend_sample(backendId, pid, &state, &queryid))
+			continue;
+
+		/* Only backends running a command are of interest */
+		if (state != STATE_RUNNING)
+			continue;
+
+		sample->sample_time = now;
+		sample->pid = pid;
+		sample->userid = proc->roleId;
+		sample->dbid = proc->databaseId;
+		sample->wait_event_info = proc->wait_event_info;
+		sample->queryid = queryid;
+		nsamples++;
+	}
+
+	return nsamples;
+}
+
+/*
+ * Add one round of samples to the history and the profile.
+ */
+static void
+pss_store_samples(pssSample *samples, int nsamples)
+{
+	int			i;
+
+	LWLockAcquire(pss->lock, LW_EXCLUSIVE);
+
+	for (i = 0; i < nsamples; i++)
+	{
+		pssSample  *sample = &samples[i];
+		pssProfileKey key;
+		pssProfileEntry *entry;
+
+		if (pss_history_size > 0)
+		{
+			pss->history[pss->history_next % pss_history_size] = *sample;
+			pss->history_next++;
+		}
+
+		/* Set up key for hashtable search; it has padding, so zero it */
+		memset(&key, 0, sizeof(pssProfileKey));
+
+		key.userid = sample->userid;
+		key.dbid = sample->dbid;
+		key.queryid = sample->queryid;
+		key.wait_event_info = sample->wait_event_info;
+
+		entry = (pssProfileEntry *) hash_search(pss_hash, &key, HASH_FIND,
+												NULL);
+		if (!entry)
+		{
+			/* Keep the profile's existing entries rather than evicting */
+			if (hash_get_num_entries(pss_hash) >= pss_max)
+			{
+				pss->dropped++;
+				continue;
+			}
+
+			entry = (pssProfileEntry *) hash_search(pss_hash, &key,
+													HASH_ENTER, NULL);
+			entry->samples = 0;
+		}
+
+		entry->samples++;
+	}
+
+	LWLockRelease(pss->lock);
+}
+
+/*
+ * Reset all samples.
+ */
+Datum
+pg_stat_sampler_reset(PG_FUNCTION_ARGS)
+{
+	HASH_SEQ_STATUS hash_seq;
+	pssProfileEntry *entry;
+
+	if (!pss || !pss_hash)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("pg_stat_sampler must be loaded via shared_preload_libraries")));
+
+	LWLockAcquire(pss->lock, LW_EXCLUSIVE);
+
+	hash_seq_init(&hash_seq, pss_hash);
+	while ((entry = hash_seq_search(&hash_seq)) != NULL)
+		hash_search(pss_hash, &entry->key, HASH_REMOVE, NULL);
+
+	pss->history_next = 0;
+	pss->dropped = 0;
+	pss->stats_reset = GetCurrentTimestamp();
+
+	LWLockRelease(pss->lock);
+
+	PG_RETURN_VOID();
+}
+
+/* Number of output arguments (columns) of the set-returning functions */
+#define PG_STAT_SAMPLER_HISTORY_COLS	7
+#define PG_STAT_SAMPLER_PROFILE_COLS	6
+#define PG_STAT_SAMPLER_INFO_COLS		2
+
+/*
+ * Set up a materialized result set for one of our set-returning functions.
+ */
+static Tuplestorestate *
+pss_begin_srf(FunctionCallInfo fcinfo, TupleDesc *tupdesc)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+
+	/* shared state must exist already */
+	if (!pss || !pss_hash)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("pg_stat_sampler must be loaded via shared_preload_libraries")));
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Switch into long-lived context to construct returned data structures */
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = *tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	return tupstore;
+}
+
+/*
+ * Retrieve the recent samples, oldest first.
+ *
+ * As for pg_stat_statements, query IDs of other users are only shown to
+ * superusers and members of pg_read_all_stats.
+ */
+Datum
+pg_stat_sampler_history(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	Oid			userid = GetUserId();
+	bool		is_allowed_role;
+	uint64		first;
+	uint64		n;
+
+	tupstore = pss_begin_srf(fcinfo, &tupdesc);
+
+	if (tupdesc->natts != PG_STAT_SAMPLER_HISTORY_COLS)
+		elog(ERROR, "incorrect number of output arguments");
+
+	/* Superusers or members of pg_read_all_stats members are allowed */
+	is_allowed_role = is_member_of_role(userid, ROLE_PG_READ_ALL_STATS);
+
+	LWLockAcquire(pss->lock, LW_SHARED);
+
+	if (pss->history_next > (uint64) pss_history_size)
+		first = pss->history_next - pss_history_size;
+	else
+		first = 0;
+
+	for (n = first; n < pss->history_next; n++)
+	{
+		pssSample  *sample = &pss->history[n % pss_history_size];
+		Datum		values[PG_STAT_SAMPLER_HISTORY_COLS];
+		bool		nulls[PG_STAT_SAMPLER_HISTORY_COLS];
+		const char *wait_event_type;
+		const char *wait_event;
+		int			i = 0;
+
+		memset(values, 0, sizeof(values));
+		memset(nulls, 0, sizeof(nulls));
+
+		values[i++] = TimestampTzGetDatum(sample->sample_time);
+		values[i++] = Int32GetDatum(sample->pid);
+		values[i++] = ObjectIdGetDatum(sample->userid);
+		values[i++] = ObjectIdGetDatum(sample->dbid);
+		if ((is_allowed_role || sample->userid == userid) &&
+			sample->queryid != UINT64CONST(0))
+			values[i++] = Int64GetDatumFast((int64) sample->queryid);
+		else
+			nulls[i++] = true;
+
+		wait_event_type = pgstat_get_wait_event_type(sample->wait_event_info);
+		wait_event = pgstat_get_wait_event(sample->wait_event_info);
+		if (wait_event_type)
+			values[i++] = CStringGetTextDatum(wait_event_type);
+		else
+			nulls[i++] = true;
+		if (wait_event)
+			values[i++] = CStringGetTextDatum(wait_event);
+		else
+			nulls[i++] = true;
+
+		Assert(i == PG_STAT_SAMPLER_HISTORY_COLS);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	LWLockRelease(pss->lock);
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
+
+/*
+ * Retrieve the aggregated profile.
+ */
+Datum
+pg_stat_sampler_profile(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	Oid			userid = GetUserId();
+	bool		is_allowed_role;
+	HASH_SEQ_STATUS hash_seq;
+	pssProfileEntry *entry;
+
+	tupstore = pss_begin_srf(fcinfo, &tupdesc);
+
+	if (tupdesc->natts != PG_STAT_SAMPLER_PROFILE_COLS)
+		elog(ERROR, "incorrect number of output arguments");
+
+	/* Superusers or members of pg_read_all_stats members are allowed */
+	is_allowed_role = is_member_of_role(userid, ROLE_PG_READ_ALL_STATS);
+
+	LWLockAcquire(pss->lock, LW_SHARED);
+
+	hash_seq_init(&hash_seq, pss_hash);
+	while ((entry = hash_seq_search(&hash_seq)) != NULL)
+	{
+		Datum		values[PG_STAT_SAMPLER_PROFILE_COLS];
+		bool		nulls[PG_STAT_SAMPLER_PROFILE_COLS];
+		const char *wait_event_type;
+		const char *wait_event;
+		int			i = 0;
+
+		memset(values, 0, sizeof(values));
+		memset(nulls, 0, sizeof(nulls));
+
+		values[i++] = ObjectIdGetDatum(entry->key.userid);
+		values[i++] = ObjectIdGetDatum(entry->key.dbid);
+		if ((is_allowed_role || entry->key.userid == userid) &&
+			entry->key.queryid != UINT64CONST(0))
+			values[i++] = Int64GetDatumFast((int64) entry->key.queryid);
+		else
+			nulls[i++] = true;
+
+		wait_event_type = pgstat_get_wait_event_type(entry->key.wait_event_info);
+		wait_event = pgstat_get_wait_event(entry->key.wait_event_info);
+		if (wait_event_type)
+			values[i++] = CStringGetTextDatum(wait_event_type);
+		else
+			nulls[i++] = true;
+		if (wait_event)
+			values[i++] = CStringGetTextDatum(wait_event);
+		else
+			nulls[i++] = true;
+
+		values[i++] = Int64GetDatumFast(entry->samples);
+
+		Assert(i == PG_STAT_SAMPLER_PROFILE_COLS);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	LWLockRelease(pss->lock);
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
+
+/*
+ * Return statistics of pg_stat_sampler.
+ */
+Datum
+pg_stat_sampler_info(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[PG_STAT_SAMPLER_INFO_COLS];
+	bool		nulls[PG_STAT_SAMPLER_INFO_COLS];
+
+	if (!pss || !pss_hash)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("pg_stat_sampler must be loaded via shared_preload_libraries")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	MemSet(values, 0, sizeof(values));
+	MemSet(nulls, 0, sizeof(nulls));
+
+	LWLockAcquire(pss->lock, LW_SHARED);
+	values[0] = Int64GetDatum(pss->dropped);
+	values[1] = TimestampTzGetDatum(pss->stats_reset);
+	LWLockRelease(pss->lock);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
@@ -0,0 +1,26 @@
+CREATE EXTENSION pg_stat_sampler;
+
+SELECT pg_stat_sampler_reset();
+
+SELECT dropped FROM pg_stat_sampler_info;
+
+-- Give the sampler time to see this backend many times
+SELECT pg_sleep(0.5);
+
+-- The history has filled up, and saw us sleeping
+SELECT count(*) AS samples,
+       bool_or(pid = pg_backend_pid() AND wait_event_type = 'Timeout' AND
+               wait_event = 'PgSleep') AS saw_sleep
+FROM pg_stat_sampler_history;
+
+-- The profile isn't limited by history_size, and knows the query
+SELECT samples > 20 AS many_samples, queryid <> 0 AS has_queryid
+FROM pg_stat_sampler_profile
+WHERE dbid = (SELECT oid FROM pg_database WHERE datname = current_database())
+  AND wait_event = 'PgSleep';
+
+-- Resetting forgets everything seen before
+SELECT pg_stat_sampler_reset();
+SELECT count(*) FROM pg_stat_sampler_profile WHERE wait_event = 'PgSleep';
+
+DROP EXTENSION pg_stat_sampler;
@@ -59,7 +59,12 @@ CREATE FUNCTION pg_stat_statements(IN showtext boolean,
     OUT blk_write_time float8,
     OUT wal_records int8,
     OUT wal_fpi int8,
-    OUT wal_bytes numeric
+    OUT wal_bytes numeric,
+    OUT wait_lwlock_time float8,
+    OUT wait_lock_time float8,
+    OUT wait_io_time float8,
+    OUT wait_client_time float8,
+    OUT wait_other_time float8
 )
 RETURNS SETOF record
 AS 'MODULE_PATHNAME', 'pg_stat_statements_1_9'
@@ -19,12 +19,18 @@
  * these strings in a temporary external query-texts file.  Offsets into this
  * file are kept in shared memory.
  *
- * Note about locking issues: to create or delete an entry in the shared
- * hashtable, one must hold pgss->lock exclusively.  Modifying any field
- * in an entry except the counters requires the same.  To look up an entry,
- * one must hold the lock shared.  To read or update the counters within
- * an entry, one must hold the lock shared or exclusive (so the entry doesn't
- * disappear!) and also take the entry's mutex spinlock.
+ * Note about locking issues: the shared hashtable is partitioned, and each
+ * partition has its own lock in addition to the global pgss->lock.  To look
+ * up an entry, one must hold pgss->lock shared and the entry's partition lock
+ * shared.  To create an entry, one must hold pgss->lock shared and the
+ * partition lock exclusively, having first reserved room for it in
+ * pgss->nentries; or hold pgss->lock exclusively, which is also needed to
+ * make room by deleting entries.  Deleting an entry, or modifying any field
+ * in an entry except the counters, requires holding pgss->lock exclusively.
+ * Scanning the whole hashtable requires pgss->lock held shared plus all the
+ * partition locks, or pgss->lock held exclusively.  To read or update the
+ * counters within an entry, one must hold pgss->lock shared or exclusive (so
+ * the entry doesn't disappear!) and also take the entry's mutex spinlock.
  * The shared state variable pgss->extent (the next free spot in the external
  * query-text file) should be accessed only while holding either the
  * pgss->mutex spinlock, or exclusive lock on pgss->lock.  We use the mutex to
@@ -87,8 +93,14 @@ PG_MODULE_MAGIC;
  */
 #define PGSS_TEXT_FILE	PG_STAT_TMP_DIR "/pgss_query_texts.stat"
 
+/* Number of partitions of the shared hashtable; must be a power of 2 */
+#define PGSS_NUM_PARTITIONS		16
+
+#define PGSS_PARTITION_LOCK(hashcode) \
+	(&pgss->partlocks[(hashcode) % PGSS_NUM_PARTITIONS].lock)
+
 /* Magic number identifying the stats file format */
-static const uint32 PGSS_FILE_HEADER = 0x20201227;
+static const uint32 PGSS_FILE_HEADER = 0x20210505;
 
 /* PostgreSQL major version number, changes in which invalidate all entries */
 static const uint32 PGSS_PG_MAJOR_VERSION = PG_VERSION_NUM / 100;
@@ -189,6 +201,9 @@ typedef struct Counters
 	int64		wal_records;	/* # of WAL records generated */
 	int64		wal_fpi;		/* # of WAL full page images generated */
 	uint64		wal_bytes;		/* total amount of WAL generated in bytes */
+	double		wait_time[NUM_WAIT_USAGE_CLASSES];	/* time spent waiting, per
+													 * wait event class, in
+													 * msec */
 } Counters;
 
 /*
@@ -223,6 +238,9 @@ typedef struct pgssEntry
 typedef struct pgssSharedState
 {
 	LWLock	   *lock;			/* protects hashtable search/modification */
+	LWLockPadded *partlocks;	/* protect the hashtable partitions */
+	pg_atomic_uint32 nentries;	/* # of hashtable entries, plus reserved
+								 * ones */
 	double		cur_median_usage;	/* current median usage in hashtable */
 	Size		mean_query_len; /* current mean entry text length */
 	slock_t		mutex;			/* protects following fields only: */
@@ -329,13 +347,15 @@ static void pgss_store(const char *query, uint64 queryId,
 					   double total_time, uint64 rows,
 					   const BufferUsage *bufusage,
 					   const WalUsage *walusage,
+					   const WaitUsage *waitusage,
 					   JumbleState *jstate);
 static void pg_stat_statements_internal(FunctionCallInfo fcinfo,
 										pgssVersion api_version,
 										bool showtext);
 static Size pgss_memsize(void);
-static pgssEntry *entry_alloc(pgssHashKey *key, Size query_offset, int query_len,
-							  int encoding, bool sticky);
+static pgssEntry *entry_alloc(pgssHashKey *key, uint32 hashcode,
+							  Size query_offset, int query_len,
+							  int encoding, bool sticky, bool reserved);
 static void entry_dealloc(void);
 static bool qtext_store(const char *query, int query_len,
 						Size *query_offset, int *gc_count);
@@ -438,7 +458,7 @@ _PG_init(void)
 	 * resources in pgss_shmem_startup().
 	 */
 	RequestAddinShmemSpace(pgss_memsize());
-	RequestNamedLWLockTranche("pg_stat_statements", 1);
+	RequestNamedLWLockTranche("pg_stat_statements", 1 + PGSS_NUM_PARTITIONS);
 
 	/*
 	 * Install hooks.
@@ -517,7 +537,11 @@ pgss_shmem_startup(void)
 	if (!found)
 	{
 		/* First time through ... */
-		pgss->lock = &(GetNamedLWLockTranche("pg_stat_statements"))->lock;
+		LWLockPadded *locks = GetNamedLWLockTranche("pg_stat_statements");
+
+		pgss->lock = &locks[0].lock;
+		pgss->partlocks = &locks[1];
+		pg_atomic_init_u32(&pgss->nentries, 0);
 		pgss->cur_median_usage = ASSUMED_MEDIAN_INIT;
 		pgss->mean_query_len = ASSUMED_LENGTH_INIT;
 		SpinLockInit(&pgss->mutex);
@@ -530,10 +554,11 @@ pgss_shmem_startup(void)
 
 	info.keysize = sizeof(pgssHashKey);
 	info.entrysize = sizeof(pgssEntry);
+	info.num_partitions = PGSS_NUM_PARTITIONS;
 	pgss_hash = ShmemInitHash("pg_stat_statements hash",
 							  pgss_max, pgss_max,
 							  &info,
-							  HASH_ELEM | HASH_BLOBS);
+							  HASH_ELEM | HASH_BLOBS | HASH_PARTITION);
 
 	LWLockRelease(AddinShmemInitLock);
 
@@ -636,9 +661,10 @@ pgss_shmem_startup(void)
 		pgss->extent += temp.query_len + 1;
 
 		/* make the hashtable entry (discards old entries if too many) */
-		entry = entry_alloc(&temp.key, query_offset, temp.query_len,
+		entry = entry_alloc(&temp.key, get_hash_value(pgss_hash, &temp.key),
+							query_offset, temp.query_len,
 							temp.encoding,
-							false);
+							false, false);
 
 		/* copy in the actual stats */
 		entry->counters = temp.counters;
@@ -847,6 +873,7 @@ pgss_post_parse_analyze(ParseState *pstate, Query *query, JumbleState *jstate)
 				   0,
 				   NULL,
 				   NULL,
+				   NULL,
 				   jstate);
 }
 
@@ -884,6 +911,8 @@ pgss_planner(Query *parse,
 					bufusage;
 		WalUsage	walusage_start,
 					walusage;
+		WaitUsage	waitusage_start,
+					waitusage;
 
 		/* We need to track buffer usage as the planner can access them. */
 		bufusage_start = pgBufferUsage;
@@ -893,6 +922,7 @@ pgss_planner(Query *parse,
 		 * (e.g. setting a hint bit with those being WAL-logged)
 		 */
 		walusage_start = pgWalUsage;
+		waitusage_start = pgWaitUsage;
 		INSTR_TIME_SET_CURRENT(start);
 
 		plan_nested_level++;
@@ -922,6 +952,10 @@ pgss_planner(Query *parse,
 		memset(&walusage, 0, sizeof(WalUsage));
 		WalUsageAccumDiff(&walusage, &pgWalUsage, &walusage_start);
 
+		/* calc differences of wait counters. */
+		memset(&waitusage, 0, sizeof(WaitUsage));
+		WaitUsageAccumDiff(&waitusage, &pgWaitUsage, &waitusage_start);
+
 		pgss_store(query_string,
 				   parse->queryId,
 				   parse->stmt_location,
@@ -931,6 +965,7 @@ pgss_planner(Query *parse,
 				   0,
 				   &bufusage,
 				   &walusage,
+				   &waitusage,
 				   NULL);
 	}
 	else
@@ -1049,6 +1084,7 @@ pgss_ExecutorEnd(QueryDesc *queryDesc)
 				   queryDesc->estate->es_processed,
 				   &queryDesc->totaltime->bufusage,
 				   &queryDesc->totaltime->walusage,
+				   &queryDesc->totaltime->waitusage,
 				   NULL);
 	}
 
@@ -1110,9 +1146,12 @@ pgss_ProcessUtility(PlannedStmt *pstmt, const char *queryString,
 					bufusage;
 		WalUsage	walusage_start,
 					walusage;
+		WaitUsage	waitusage_start,
+					waitusage;
 
 		bufusage_start = pgBufferUsage;
 		walusage_start = pgWalUsage;
+		waitusage_start = pgWaitUsage;
 		INSTR_TIME_SET_CURRENT(start);
 
 		exec_nested_level++;
@@ -1155,6 +1194,10 @@ pgss_ProcessUtility(PlannedStmt *pstmt, const char *queryString,
 		memset(&walusage, 0, sizeof(WalUsage));
 		WalUsageAccumDiff(&walusage, &pgWalUsage, &walusage_start);
 
+		/* calc differences of wait counters. */
+		memset(&waitusage, 0, sizeof(WaitUsage));
+		WaitUsageAccumDiff(&waitusage, &pgWaitUsage, &waitusage_start);
+
 		pgss_store(queryString,
 				   saved_queryId,
 				   pstmt->stmt_location,
@@ -1164,6 +1207,7 @@ pgss_ProcessUtility(PlannedStmt *pstmt, const char *queryString,
 				   rows,
 				   &bufusage,
 				   &walusage,
+				   &waitusage,
 				   NULL);
 	}
 	else
@@ -1201,12 +1245,15 @@ pgss_store(const char *query, uint64 queryId,
 		   double total_time, uint64 rows,
 		   const BufferUsage *bufusage,
 		   const WalUsage *walusage,
+		   const WaitUsage *waitusage,
 		   JumbleState *jstate)
 {
 	pgssHashKey key;
 	pgssEntry  *entry;
 	char	   *norm_query = NULL;
 	int			encoding = GetDatabaseEncoding();
+	uint32		hashcode;
+	LWLock	   *partlock;
 
 	Assert(query != NULL);
 
@@ -1238,10 +1285,19 @@ pgss_store(const char *query, uint64 queryId,
 	key.queryid = queryId;
 	key.toplevel = (exec_nested_level == 0);
 
-	/* Lookup the hash table entry with shared lock. */
+	hashcode = get_hash_value(pgss_hash, &key);
+	partlock = PGSS_PARTITION_LOCK(hashcode);
+
+	/* Lookup the hash table entry with shared locks. */
 	LWLockAcquire(pgss->lock, LW_SHARED);
+	LWLockAcquire(partlock, LW_SHARED);
 
-	entry = (pgssEntry *) hash_search(pgss_hash, &key, HASH_FIND, NULL);
+	entry = (pgssEntry *) hash_search_with_hash_value(pgss_hash, &key,
+													  hashcode, HASH_FIND,
+													  NULL);
+
+	/* The entry can't go away while we hold pgss->lock */
+	LWLockRelease(partlock);
 
 	/* Create new entry, if not present */
 	if (!entry)
@@ -1278,32 +1334,64 @@ pgss_store(const char *query, uint64 queryId,
 		 */
 		do_gc = need_gc_qtexts();
 
-		/* Need exclusive lock to make a new hashtable entry - promote */
-		LWLockRelease(pgss->lock);
-		LWLockAcquire(pgss->lock, LW_EXCLUSIVE);
-
 		/*
-		 * A garbage collection may have occurred while we weren't holding the
-		 * lock.  In the unlikely event that this happens, the query text we
-		 * stored above will have been garbage collected, so write it again.
-		 * This should be infrequent enough that doing it while holding
-		 * exclusive lock isn't a performance problem.
+		 * If no garbage collection is due and the hashtable has room, add the
+		 * entry under just its partition lock, keeping pgss->lock shared so
+		 * that backends adding different entries don't serialize.  The room
+		 * is reserved first, so that concurrent additions can't overrun
+		 * pgss_max between them.
 		 */
-		if (!stored || pgss->gc_count != gc_count)
-			stored = qtext_store(norm_query ? norm_query : query, query_len,
-								 &query_offset, NULL);
+		if (!do_gc &&
+			pg_atomic_fetch_add_u32(&pgss->nentries, 1) < pgss_max)
+		{
+			/*
+			 * We've held the shared lock since storing the query text, so it
+			 * can't have been garbage collected.
+			 */
+			if (!stored)
+			{
+				pg_atomic_fetch_sub_u32(&pgss->nentries, 1);
+				goto done;
+			}
+
+			LWLockAcquire(partlock, LW_EXCLUSIVE);
+			entry = entry_alloc(&key, hashcode, query_offset, query_len,
+								encoding, jstate != NULL, true);
+			LWLockRelease(partlock);
+		}
+		else
+		{
+			/* Give back the room we failed to reserve, if we tried */
+			if (!do_gc)
+				pg_atomic_fetch_sub_u32(&pgss->nentries, 1);
+
+			/* Need exclusive lock to make room or collect garbage - promote */
+			LWLockRelease(pgss->lock);
+			LWLockAcquire(pgss->lock, LW_EXCLUSIVE);
 
-		/* If we failed to write to the text file, give up */
-		if (!stored)
-			goto done;
+			/*
+			 * A garbage collection may have occurred while we weren't holding
+			 * the lock.  In the unlikely event that this happens, the query
+			 * text we stored above will have been garbage collected, so write
+			 * it again.  This should be infrequent enough that doing it while
+			 * holding exclusive lock isn't a performance problem.
+			 */
+			if (!stored || pgss->gc_count != gc_count)
+				stored = qtext_store(norm_query ? norm_query : query, query_len,
+									 &query_offset, NULL);
 
-		/* OK to create a new hashtable entry */
-		entry = entry_alloc(&key, query_offset, query_len, encoding,
-							jstate != NULL);
+			/* If we failed to write to the text file, give up */
+			if (!stored)
+				goto done;
 
-		/* If needed, perform garbage collection while exclusive lock held */
-		if (do_gc)
-			gc_qtexts();
+			/* OK to create a new hashtable entry */
+			entry = entry_alloc(&key, hashcode, query_offset, query_len,
+								encoding, jstate != NULL, false);
+
+			/* If needed, perform garbage collection while exclusive lock held */
+			if (do_gc)
+				gc_qtexts();
+		}
 	}
 
 	/* Increment the counts, except when jstate is not NULL */
@@ -1314,6 +1402,7 @@ pgss_store(const char *query, uint64 queryId,
 		 * locking rules at the head of the file)
 		 */
 		volatile pgssEntry *e = (volatile pgssEntry *) entry;
+		int			i;
 
 		Assert(kind == PGSS_PLAN || kind == PGSS_EXEC);
 
@@ -1368,6 +1457,9 @@ pgss_store(const char *query, uint64 queryId,
 		e->counters.wal_records += walusage->wal_records;
 		e->counters.wal_fpi += walusage->wal_fpi;
 		e->counters.wal_bytes += walusage->wal_bytes;
+		for (i = 0; i < NUM_WAIT_USAGE_CLASSES; i++)
+			e->counters.wait_time[i] +=
+				INSTR_TIME_GET_MILLISEC(waitusage->wait_time[i]);
 
 		SpinLockRelease(&e->mutex);
 	}
@@ -1416,8 +1508,8 @@ pg_stat_statements_reset(PG_FUNCTION_ARGS)
 #define PG_STAT_STATEMENTS_COLS_V1_2	19
 #define PG_STAT_STATEMENTS_COLS_V1_3	23
 #define PG_STAT_STATEMENTS_COLS_V1_8	32
-#define PG_STAT_STATEMENTS_COLS_V1_9	33
-#define PG_STAT_STATEMENTS_COLS			33	/* maximum of above */
+#define PG_STAT_STATEMENTS_COLS_V1_9	38
+#define PG_STAT_STATEMENTS_COLS			38	/* maximum of above */
 
 /*
  * Retrieve statement statistics.
@@ -1499,6 +1591,7 @@ pg_stat_statements_internal(FunctionCallInfo fcinfo,
 	Size		qbuffer_size = 0;
 	Size		extent = 0;
 	int			gc_count = 0;
+	int			lockno;
 	HASH_SEQ_STATUS hash_seq;
 	pgssEntry  *entry;
 
@@ -1607,14 +1700,14 @@ pg_stat_statements_internal(FunctionCallInfo fcinfo,
 	 * Get shared lock, load or reload the query text file if we must, and
 	 * iterate over the hashtable entries.
 	 *
-	 * With a large hash table, we might be holding the lock rather longer
+	 * With a large hash table, we might be holding the locks rather longer
 	 * than one could wish.  However, this only blocks creation of new hash
 	 * table entries, and the larger the hash table the less likely that is to
-	 * be needed.  So we can hope this is okay.  Perhaps someday we'll decide
-	 * we need to partition the hash table to limit the time spent holding any
-	 * one lock.
+	 * be needed.  So we can hope this is okay.
 	 */
 	LWLockAcquire(pgss->lock, LW_SHARED);
+	for (lockno = 0; lockno < PGSS_NUM_PARTITIONS; lockno++)
+		LWLockAcquire(&pgss->partlocks[lockno].lock, LW_SHARED);
 
 	if (showtext)
 	{
@@ -1786,6 +1879,14 @@ pg_stat_statements_internal(FunctionCallInfo fcinfo,
 											Int32GetDatum(-1));
 			values[i++] = wal_bytes;
 		}
+		if (api_version >= PGSS_V1_9)
+		{
+			values[i++] = Float8GetDatumFast(tmp.wait_time[WAIT_USAGE_LWLOCK]);
+			values[i++] = Float8GetDatumFast(tmp.wait_time[WAIT_USAGE_LOCK]);
+			values[i++] = Float8GetDatumFast(tmp.wait_time[WAIT_USAGE_IO]);
+			values[i++] = Float8GetDatumFast(tmp.wait_time[WAIT_USAGE_CLIENT]);
+			values[i++] = Float8GetDatumFast(tmp.wait_time[WAIT_USAGE_OTHER]);
+		}
 
 		Assert(i == (api_version == PGSS_V1_0 ? PG_STAT_STATEMENTS_COLS_V1_0 :
 					 api_version == PGSS_V1_1 ? PG_STAT_STATEMENTS_COLS_V1_1 :
@@ -1799,6 +1900,8 @@ pg_stat_statements_internal(FunctionCallInfo fcinfo,
 	}
 
 	/* clean up and return the tuplestore */
+	for (lockno = PGSS_NUM_PARTITIONS; --lockno >= 0;)
+		LWLockRelease(&pgss->partlocks[lockno].lock);
 	LWLockRelease(pgss->lock);
 
 	if (qbuffer)
@@ -1864,7 +1967,10 @@ pgss_memsize(void)
 
 /*
  * Allocate a new hashtable entry.
- * caller must hold an exclusive lock on pgss->lock
+ *
+ * Caller must hold an exclusive lock on pgss->lock, or else have reserved
+ * room for the entry in pgss->nentries ("reserved") and hold pgss->lock
+ * shared plus the entry's partition lock exclusively.
  *
  * "query" need not be null-terminated; we rely on query_len instead
  *
@@ -1880,18 +1986,24 @@ pgss_memsize(void)
  * have made the entry while we waited to get exclusive lock.
  */
 static pgssEntry *
-entry_alloc(pgssHashKey *key, Size query_offset, int query_len, int encoding,
-			bool sticky)
+entry_alloc(pgssHashKey *key, uint32 hashcode,
+			Size query_offset, int query_len, int encoding,
+			bool sticky, bool reserved)
 {
 	pgssEntry  *entry;
 	bool		found;
 
 	/* Make space if needed */
-	while (hash_get_num_entries(pgss_hash) >= pgss_max)
-		entry_dealloc();
+	if (!reserved)
+	{
+		while (pg_atomic_read_u32(&pgss->nentries) >= pgss_max)
+			entry_dealloc();
+	}
 
 	/* Find or create an entry with desired hash code */
-	entry = (pgssEntry *) hash_search(pgss_hash, key, HASH_ENTER, &found);
+	entry = (pgssEntry *) hash_search_with_hash_value(pgss_hash, key,
+													  hashcode, HASH_ENTER,
+													  &found);
 
 	if (!found)
 	{
@@ -1908,6 +2020,14 @@ entry_alloc(pgssHashKey *key, Size query_offset, int query_len, int encoding,
 		entry->query_offset = query_offset;
 		entry->query_len = query_len;
 		entry->encoding = encoding;
+
+		if (!reserved)
+			pg_atomic_fetch_add_u32(&pgss->nentries, 1);
+	}
+	else if (reserved)
+	{
+		/* someone else made the entry; we don't need the room after all */
+		pg_atomic_fetch_sub_u32(&pgss->nentries, 1);
 	}
 
 	return entry;
@@ -2001,6 +2121,7 @@ entry_dealloc(void)
 	{
 		hash_search(pgss_hash, &entries[i]->key, HASH_REMOVE, NULL);
 	}
+	pg_atomic_fetch_sub_u32(&pgss->nentries, nvictims);
 
 	pfree(entries);
 
@@ -2510,6 +2631,8 @@ entry_reset(Oid userid, Oid dbid, uint64 queryid)
 		}
 	}
 
+	pg_atomic_fetch_sub_u32(&pgss->nentries, num_remove);
+
 	/* All entries are removed? */
 	if (num_entries != num_remove)
 		goto release_lock;
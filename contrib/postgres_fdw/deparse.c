@@ -117,6 +117,7 @@ typedef struct deparse_expr_cxt
 static bool foreign_expr_walker(Node *node,
 								foreign_glob_cxt *glob_cxt,
 								foreign_loc_cxt *outer_cxt);
+static bool partial_agg_ok(Aggref *agg);
 static char *deparse_type_name(Oid type_oid, int32 typemod);
 
 /*
@@ -705,8 +706,12 @@ foreign_expr_walker(Node *node,
 				if (!IS_UPPER_REL(glob_cxt->foreignrel))
 					return false;
 
-				/* Only non-split aggregates are pushable. */
-				if (agg->aggsplit != AGGSPLIT_SIMPLE)
+				/*
+				 * Only non-split aggregates are pushable, except for the
+				 * partial aggregates that the remote server can compute as
+				 * ordinary ones.
+				 */
+				if (agg->aggsplit != AGGSPLIT_SIMPLE && !partial_agg_ok(agg))
 					return false;
 
 				/* As usual, it must be shippable. */
@@ -910,6 +915,45 @@ is_foreign_param(PlannerInfo *root,
 	return false;
 }
 
+/*
+ * Returns true if the given partial aggregate computes the same value as the
+ * ordinary aggregate would, so that the remote server can compute it for us
+ * and the local Finalize Aggregate can combine the results.
+ *
+ * That is the case when the aggregate has no final function and its
+ * transition state is an ordinary SQL value, not "internal": then the
+ * aggregate's result is just the transition state, as in count(), min(),
+ * max() and sum() of integers.
+ */
+static bool
+partial_agg_ok(Aggref *agg)
+{
+	HeapTuple	aggtup;
+	Form_pg_aggregate aggform;
+	bool		result;
+
+	/* We don't deal with serialization, nor with finalization. */
+	if (agg->aggsplit != AGGSPLIT_INITIAL_SERIAL)
+		return false;
+
+	if (agg->aggkind != AGGKIND_NORMAL ||
+		agg->aggtranstype == INTERNALOID ||
+		agg->aggtype != agg->aggtranstype)
+		return false;
+
+	aggtup = SearchSysCache1(AGGFNOID, ObjectIdGetDatum(agg->aggfnoid));
+	if (!HeapTupleIsValid(aggtup))
+		elog(ERROR, "cache lookup failed for aggregate %u", agg->aggfnoid);
+	aggform = (Form_pg_aggregate) GETSTRUCT(aggtup);
+
+	result = !OidIsValid(aggform->aggfinalfn) &&
+		OidIsValid(aggform->aggcombinefn);
+
+	ReleaseSysCache(aggtup);
+
+	return result;
+}
+
 /*
  * Convert type OID + typmod info into a type name we can ship to the remote
  * server.  Someplace else had better have verified that this type name is
@@ -3041,8 +3085,12 @@ deparseAggref(Aggref *node, deparse_expr_cxt *context)
 	StringInfo	buf = context->buf;
 	bool		use_variadic;
 
-	/* Only basic, non-split aggregation accepted. */
-	Assert(node->aggsplit == AGGSPLIT_SIMPLE);
+	/*
+	 * Only basic, non-split aggregation accepted, or partial aggregation
+	 * that partial_agg_ok() found to be the same thing.
+	 */
+	Assert(node->aggsplit == AGGSPLIT_SIMPLE ||
+		   node->aggsplit == AGGSPLIT_INITIAL_SERIAL);
 
 	/* Check if need to print VARIADIC (cf. ruleutils.c) */
 	use_variadic = node->aggvariadic;
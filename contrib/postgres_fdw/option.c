@@ -145,6 +145,17 @@ postgres_fdw_validator(PG_FUNCTION_ARGS)
 						 errmsg("%s requires a non-negative integer value",
 								def->defname)));
 		}
+		else if (strcmp(def->defname, "fetch_bytes") == 0)
+		{
+			int			fetch_bytes;
+
+			fetch_bytes = strtol(defGetString(def), NULL, 10);
+			if (fetch_bytes < 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("%s requires a non-negative integer value",
+								def->defname)));
+		}
 		else if (strcmp(def->defname, "batch_size") == 0)
 		{
 			int			batch_size;
@@ -220,6 +231,9 @@ InitPgFdwOptions(void)
 		/* fetch_size is available on both server and table */
 		{"fetch_size", ForeignServerRelationId, false},
 		{"fetch_size", ForeignTableRelationId, false},
+		/* fetch_bytes is available on both server and table */
+		{"fetch_bytes", ForeignServerRelationId, false},
+		{"fetch_bytes", ForeignTableRelationId, false},
 		/* batch_size is available on both server and table */
 		{"batch_size", ForeignServerRelationId, false},
 		{"batch_size", ForeignTableRelationId, false},
@@ -75,6 +75,8 @@ enum FdwScanPrivateIndex
 	FdwScanPrivateRetrievedAttrs,
 	/* Integer representing the desired fetch_size */
 	FdwScanPrivateFetchSize,
+	/* Integer representing the desired fetch_bytes, 0 if not set */
+	FdwScanPrivateFetchBytes,
 
 	/*
 	 * String describing join i.e. names of relations being joined and types
@@ -171,6 +173,8 @@ typedef struct PgFdwScanState
 	MemoryContext temp_cxt;		/* context for per-tuple temporary data */
 
 	int			fetch_size;		/* number of tuples per fetch */
+	int			min_fetch_size;	/* fetch_size option, if fetch_bytes is set */
+	int			fetch_bytes;	/* target bytes per fetch, or 0 */
 } PgFdwScanState;
 
 /*
@@ -454,6 +458,7 @@ static bool ec_member_matches_foreign(PlannerInfo *root, RelOptInfo *rel,
 									  void *arg);
 static void create_cursor(ForeignScanState *node);
 static void fetch_more_data(ForeignScanState *node);
+static void adjust_fetch_size(PgFdwScanState *fsstate, PGresult *res);
 static void close_cursor(PGconn *conn, unsigned int cursor_number,
 						 PgFdwConnState *conn_state);
 static PgFdwModifyState *create_foreign_modify(EState *estate,
@@ -655,6 +660,7 @@ postgresGetForeignRelSize(PlannerInfo *root,
 	fpinfo->fdw_tuple_cost = DEFAULT_FDW_TUPLE_COST;
 	fpinfo->shippable_extensions = NIL;
 	fpinfo->fetch_size = 100;
+	fpinfo->fetch_bytes = 0;
 	fpinfo->async_capable = false;
 
 	apply_server_options(fpinfo);
@@ -1415,9 +1421,10 @@ postgresGetForeignPlan(PlannerInfo *root,
 	 * Build the fdw_private list that will be available to the executor.
 	 * Items in the list must match order in enum FdwScanPrivateIndex.
 	 */
-	fdw_private = list_make3(makeString(sql.data),
+	fdw_private = list_make4(makeString(sql.data),
 							 retrieved_attrs,
-							 makeInteger(fpinfo->fetch_size));
+							 makeInteger(fpinfo->fetch_size),
+							 makeInteger(fpinfo->fetch_bytes));
 	if (IS_JOIN_REL(foreignrel) || IS_UPPER_REL(foreignrel))
 		fdw_private = lappend(fdw_private,
 							  makeString(fpinfo->relation_name));
@@ -1502,6 +1509,9 @@ postgresBeginForeignScan(ForeignScanState *node, int eflags)
 												 FdwScanPrivateRetrievedAttrs);
 	fsstate->fetch_size = intVal(list_nth(fsplan->fdw_private,
 										  FdwScanPrivateFetchSize));
+	fsstate->min_fetch_size = fsstate->fetch_size;
+	fsstate->fetch_bytes = intVal(list_nth(fsplan->fdw_private,
+										   FdwScanPrivateFetchBytes));
 
 	/* Create contexts for batches of tuples and per-tuple temp workspace. */
 	fsstate->batch_cxt = AllocSetContextCreate(estate->es_query_cxt,
@@ -3771,6 +3781,10 @@ fetch_more_data(ForeignScanState *node)
 
 		/* Must be EOF if we didn't get as many tuples as we asked for. */
 		fsstate->eof_reached = (numrows < fsstate->fetch_size);
+
+		/* Size the next fetch by the width of the rows we just got */
+		if (fsstate->fetch_bytes > 0 && !fsstate->eof_reached)
+			adjust_fetch_size(fsstate, res);
 	}
 	PG_FINALLY();
 	{
@@ -3782,6 +3796,41 @@ fetch_more_data(ForeignScanState *node)
 	MemoryContextSwitchTo(oldcontext);
 }
 
+/*
+ * Choose the number of rows to ask for in the next FETCH so that a batch
+ * holds about fetch_bytes of data, judging by the rows in 'res'.  This keeps
+ * the number of round trips low for narrow rows without letting a batch of
+ * wide rows take up too much memory.  We never go below the fetch_size
+ * option, nor above the number of tuples the batch array can hold.
+ */
+static void
+adjust_fetch_size(PgFdwScanState *fsstate, PGresult *res)
+{
+	int			numrows = PQntuples(res);
+	int			nfields = PQnfields(res);
+	double		totalbytes = 0;
+	double		rowbytes;
+	double		newsize;
+
+	if (numrows == 0)
+		return;
+
+	for (int i = 0; i < numrows; i++)
+	{
+		for (int j = 0; j < nfields; j++)
+			totalbytes += PQgetlength(res, i, j);
+	}
+
+	/* count some overhead per row, so that empty rows don't divide by 0 */
+	rowbytes = totalbytes / numrows + nfields + 1;
+
+	newsize = fsstate->fetch_bytes / rowbytes;
+	newsize = Max(newsize, fsstate->min_fetch_size);
+	newsize = Min(newsize, MaxAllocSize / sizeof(HeapTuple));
+
+	fsstate->fetch_size = (int) newsize;
+}
+
 /*
  * Force assorted GUC parameters to settings that ensure that we'll output
  * data values in a form that is unambiguous to the remote server.
@@ -5749,6 +5798,8 @@ apply_server_options(PgFdwRelationInfo *fpinfo)
 				ExtractExtensionList(defGetString(def), false);
 		else if (strcmp(def->defname, "fetch_size") == 0)
 			fpinfo->fetch_size = strtol(defGetString(def), NULL, 10);
+		else if (strcmp(def->defname, "fetch_bytes") == 0)
+			fpinfo->fetch_bytes = strtol(defGetString(def), NULL, 10);
 		else if (strcmp(def->defname, "async_capable") == 0)
 			fpinfo->async_capable = defGetBoolean(def);
 	}
@@ -5772,6 +5823,8 @@ apply_table_options(PgFdwRelationInfo *fpinfo)
 			fpinfo->use_remote_estimate = defGetBoolean(def);
 		else if (strcmp(def->defname, "fetch_size") == 0)
 			fpinfo->fetch_size = strtol(defGetString(def), NULL, 10);
+		else if (strcmp(def->defname, "fetch_bytes") == 0)
+			fpinfo->fetch_bytes = strtol(defGetString(def), NULL, 10);
 		else if (strcmp(def->defname, "async_capable") == 0)
 			fpinfo->async_capable = defGetBoolean(def);
 	}
@@ -5808,6 +5861,7 @@ merge_fdw_options(PgFdwRelationInfo *fpinfo,
 	fpinfo->shippable_extensions = fpinfo_o->shippable_extensions;
 	fpinfo->use_remote_estimate = fpinfo_o->use_remote_estimate;
 	fpinfo->fetch_size = fpinfo_o->fetch_size;
+	fpinfo->fetch_bytes = fpinfo_o->fetch_bytes;
 	fpinfo->async_capable = fpinfo_o->async_capable;
 
 	/* Merge the table level options from either side of the join. */
@@ -5830,6 +5884,7 @@ merge_fdw_options(PgFdwRelationInfo *fpinfo,
 		 * relation sizes.
 		 */
 		fpinfo->fetch_size = Max(fpinfo_o->fetch_size, fpinfo_i->fetch_size);
+		fpinfo->fetch_bytes = Max(fpinfo_o->fetch_bytes, fpinfo_i->fetch_bytes);
 
 		/*
 		 * We'll prefer to consider this join async-capable if any table from
@@ -6241,6 +6296,7 @@ postgresGetForeignUpperPaths(PlannerInfo *root, UpperRelationKind stage,
 
 	/* Ignore stages we don't support; and skip any duplicate calls. */
 	if ((stage != UPPERREL_GROUP_AGG &&
+		 stage != UPPERREL_PARTIAL_GROUP_AGG &&
 		 stage != UPPERREL_ORDERED &&
 		 stage != UPPERREL_FINAL) ||
 		output_rel->fdw_private)
@@ -6254,6 +6310,7 @@ postgresGetForeignUpperPaths(PlannerInfo *root, UpperRelationKind stage,
 	switch (stage)
 	{
 		case UPPERREL_GROUP_AGG:
+		case UPPERREL_PARTIAL_GROUP_AGG:
 			add_foreign_grouping_paths(root, input_rel, output_rel,
 									   (GroupPathExtraData *) extra);
 			break;
@@ -6297,7 +6354,8 @@ add_foreign_grouping_paths(PlannerInfo *root, RelOptInfo *input_rel,
 		return;
 
 	Assert(extra->patype == PARTITIONWISE_AGGREGATE_NONE ||
-		   extra->patype == PARTITIONWISE_AGGREGATE_FULL);
+		   extra->patype == PARTITIONWISE_AGGREGATE_FULL ||
+		   fpinfo->stage == UPPERREL_PARTIAL_GROUP_AGG);
 
 	/* save the input_rel as outerrel in fpinfo */
 	fpinfo->outerrel = input_rel;
@@ -6315,9 +6373,12 @@ add_foreign_grouping_paths(PlannerInfo *root, RelOptInfo *input_rel,
 	 * Assess if it is safe to push down aggregation and grouping.
 	 *
 	 * Use HAVING qual from extra. In case of child partition, it will have
-	 * translated Vars.
+	 * translated Vars.  When only partially aggregating, the HAVING qual is
+	 * applied after the final aggregation, above us.
 	 */
-	if (!foreign_grouping_ok(root, grouped_rel, extra->havingQual))
+	if (!foreign_grouping_ok(root, grouped_rel,
+							 fpinfo->stage == UPPERREL_PARTIAL_GROUP_AGG ?
+							 NULL : extra->havingQual))
 		return;
 
 	/*
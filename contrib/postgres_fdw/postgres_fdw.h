@@ -87,6 +87,7 @@ typedef struct PgFdwRelationInfo
 	UserMapping *user;			/* only set in use_remote_estimate mode */
 
 	int			fetch_size;		/* fetch size for this remote table */
+	int			fetch_bytes;	/* target bytes per fetch, or 0 */
 
 	/*
 	 * Name of the relation, for use while EXPLAINing ForeignScan.  It is used
@@ -2564,6 +2564,17 @@ AND ftoptions @> array['fetch_size=60000'];
 
 ROLLBACK;
 
+-- fetch_bytes grows the fetch size as far as the row width allows
+CREATE TABLE fetch_bytes_tab (a int, b text);
+INSERT INTO fetch_bytes_tab SELECT g, repeat('x', g % 100) FROM generate_series(1, 1000) g;
+CREATE FOREIGN TABLE fetch_bytes_ft (a int, b text) SERVER loopback
+  OPTIONS (table_name 'fetch_bytes_tab', fetch_size '10', fetch_bytes '2000');
+ALTER FOREIGN TABLE fetch_bytes_ft OPTIONS (SET fetch_bytes '-1');  -- ERROR
+SELECT count(*), sum(a), sum(length(b))
+FROM (SELECT a, b FROM fetch_bytes_ft OFFSET 0) ss;
+DROP FOREIGN TABLE fetch_bytes_ft;
+DROP TABLE fetch_bytes_tab;
+
 -- ===================================================================
 -- test partitionwise joins
 -- ===================================================================
@@ -2679,6 +2690,12 @@ SELECT a, count(t1) FROM pagg_tab t1 GROUP BY a HAVING avg(b) < 22 ORDER BY 1;
 EXPLAIN (COSTS OFF)
 SELECT b, avg(a), max(a), count(*) FROM pagg_tab GROUP BY b HAVING sum(a) < 700 ORDER BY 1;
 
+-- Partial aggregates whose transition state is their result can be
+-- computed remotely, and combined locally.
+EXPLAIN (COSTS OFF)
+SELECT b, sum(a), min(a), max(a), count(*) FROM pagg_tab GROUP BY b HAVING sum(a) < 700 ORDER BY 1;
+SELECT b, sum(a), min(a), max(a), count(*) FROM pagg_tab GROUP BY b HAVING sum(a) < 700 ORDER BY 1;
+
 -- ===================================================================
 -- access rights and superuser
 -- ===================================================================
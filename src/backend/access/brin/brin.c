@@ -33,6 +33,7 @@
 #include "postmaster/autovacuum.h"
 #include "storage/bufmgr.h"
 #include "storage/freespace.h"
+#include "storage/lmgr.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
 #include "utils/datum.h"
@@ -72,6 +73,10 @@ typedef struct BrinOpaque
 static BrinBuildState *initialize_brin_buildstate(Relation idxRel,
 												  BrinRevmap *revmap, BlockNumber pagesPerRange);
 static void terminate_brin_buildstate(BrinBuildState *state);
+static bool brin_summarize_new_range(Relation idxRel, Relation heapRel,
+									 BrinRevmap *revmap,
+									 BlockNumber pagesPerRange,
+									 BlockNumber heapBlk);
 static void brinsummarize(Relation index, Relation heapRel, BlockNumber pageRange,
 						  bool include_partial, double *numSummarized, double *numExisting);
 static void form_and_insert_tuple(BrinBuildState *state);
@@ -145,7 +150,10 @@ brinhandler(PG_FUNCTION_ARGS)
  * the summary tuple, we need to update the index tuple.
  *
  * If autosummarization is enabled, check if we need to summarize the previous
- * page range.
+ * page range.  Also, if this is the first tuple of a new page range, we
+ * summarize that range right away: it contains next to nothing yet, so this
+ * is cheap, and it keeps the newest range (usually the most queried one)
+ * summarized while it fills up.
  *
  * If the range is not currently summarized (i.e. the revmap returns NULL for
  * it), there's nothing to do for this tuple.
@@ -222,9 +230,24 @@ brininsert(Relation idxRel, Datum *values, bool *nulls,
 		brtup = brinGetTupleForHeapBlock(revmap, heapBlk, &buf, &off,
 										 NULL, BUFFER_LOCK_SHARE, NULL);
 
-		/* if range is unsummarized, there's nothing to do */
+		/*
+		 * If range is unsummarized, there's nothing to do, unless we are the
+		 * first tuple in it and can summarize it ourselves.
+		 */
 		if (!brtup)
+		{
+			if (autosummarize &&
+				heapBlk == origHeapBlk &&
+				ItemPointerGetOffsetNumber(heaptid) == FirstOffsetNumber &&
+				brin_summarize_new_range(idxRel, heapRel, revmap,
+										 pagesPerRange, heapBlk))
+			{
+				/* don't try again if someone desummarizes it meanwhile */
+				autosummarize = false;
+				continue;
+			}
 			break;
+		}
 
 		/* First time through in this statement? */
 		if (bdesc == NULL)
@@ -1430,6 +1453,50 @@ summarize_range(IndexInfo *indexInfo, BrinBuildState *state, Relation heapRel,
 	ReleaseBuffer(phbuf);
 }
 
+/*
+ * Summarize a just-started page range from brininsert.
+ *
+ * Other summarizers (VACUUM, brin_summarize_range and friends) hold
+ * ShareUpdateExclusiveLock on the table, and summarize_range relies on that
+ * for not running concurrently with itself on the same range.  Inserters
+ * hold only RowExclusiveLock, so take the stronger lock conditionally for
+ * the duration of the summarization and give up if anyone else has it;
+ * autosummarization of the previous range, or the next vacuum, will catch up
+ * with this range later.
+ *
+ * Returns true if the range was summarized.
+ */
+static bool
+brin_summarize_new_range(Relation idxRel, Relation heapRel, BrinRevmap *revmap,
+						 BlockNumber pagesPerRange, BlockNumber heapBlk)
+{
+	MemoryContext sumcxt;
+	MemoryContext oldcxt;
+	IndexInfo  *indexInfo;
+	BrinBuildState *state;
+
+	if (!ConditionalLockRelation(heapRel, ShareUpdateExclusiveLock))
+		return false;
+
+	sumcxt = AllocSetContextCreate(CurrentMemoryContext,
+								   "brin summarize cxt",
+								   ALLOCSET_DEFAULT_SIZES);
+	oldcxt = MemoryContextSwitchTo(sumcxt);
+
+	indexInfo = BuildIndexInfo(idxRel);
+	state = initialize_brin_buildstate(idxRel, revmap, pagesPerRange);
+	summarize_range(indexInfo, state, heapRel, heapBlk,
+					RelationGetNumberOfBlocks(heapRel));
+	terminate_brin_buildstate(state);
+
+	MemoryContextSwitchTo(oldcxt);
+	MemoryContextDelete(sumcxt);
+
+	UnlockRelation(heapRel, ShareUpdateExclusiveLock);
+
+	return true;
+}
+
 /*
  * Summarize page ranges that are not already summarized.  If pageRange is
  * BRIN_ALL_BLOCKRANGES then the whole table is scanned; otherwise, only the
@@ -28,6 +28,12 @@ static struct varlena *toast_fetch_datum_slice(struct varlena *attr,
 											   int32 slicelength);
 static struct varlena *toast_decompress_datum(struct varlena *attr);
 static struct varlena *toast_decompress_datum_slice(struct varlena *attr, int32 slicelength);
+static struct varlena *toast_fetch_blocks_slice(struct varlena *attr,
+												int32 sliceoffset,
+												int32 slicelength);
+static struct varlena *toast_decompress_blocks(struct varlena *attr,
+											   int32 sliceoffset,
+											   int32 slicelength);
 
 /* ----------
  * detoast_external_attr -
@@ -233,6 +239,11 @@ detoast_attr_slice(struct varlena *attr,
 		if (!VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
 			return toast_fetch_datum_slice(attr, sliceoffset, slicelength);
 
+		/* values compressed in blocks need only the blocks of the slice */
+		if (VARATT_EXTERNAL_GET_COMPRESS_METHOD(toast_pointer) ==
+			TOAST_BLOCKS_COMPRESSION_ID)
+			return toast_fetch_blocks_slice(attr, sliceoffset, slicelength);
+
 		/*
 		 * For compressed values, we need to fetch enough slices to decompress
 		 * at least the requested part (when a prefix is requested).
@@ -286,6 +297,17 @@ detoast_attr_slice(struct varlena *attr,
 
 	Assert(!VARATT_IS_EXTERNAL(preslice));
 
+	if (VARATT_IS_COMPRESSED(preslice) &&
+		TOAST_COMPRESS_METHOD(preslice) == TOAST_BLOCKS_COMPRESSION_ID)
+	{
+		result = toast_decompress_blocks(preslice, sliceoffset, slicelength);
+
+		if (preslice != attr)
+			pfree(preslice);
+
+		return result;
+	}
+
 	if (VARATT_IS_COMPRESSED(preslice))
 	{
 		struct varlena *tmp = preslice;
@@ -462,6 +484,139 @@ toast_fetch_datum_slice(struct varlena *attr, int32 sliceoffset,
 	return result;
 }
 
+/* ----------
+ * toast_fetch_blocks_slice -
+ *
+ *	Fetch a segment of an external datum compressed in blocks, reading and
+ *	decompressing only the blocks that cover it.
+ * ----------
+ */
+static struct varlena *
+toast_fetch_blocks_slice(struct varlena *attr, int32 sliceoffset,
+						 int32 slicelength)
+{
+	Relation	toastrel;
+	struct varlena *hdrbuf;
+	struct varlena *data;
+	struct varlena *result;
+	struct varatt_external toast_pointer;
+	toast_compress_blocks *hdr;
+	int32		attrsize;
+	int32		rawsize;
+	int32		nblocks;
+	int32		start;
+	int32		last;
+	int32		begin;
+	int32		datalength;
+
+	/* Must copy to access aligned fields */
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+
+	attrsize = VARATT_EXTERNAL_GET_EXTSIZE(toast_pointer);
+	rawsize = toast_pointer.va_rawsize - VARHDRSZ;
+
+	if (sliceoffset >= rawsize || slicelength == 0)
+	{
+		result = (struct varlena *) palloc(VARHDRSZ);
+		SET_VARSIZE(result, VARHDRSZ);
+		return result;
+	}
+	if (slicelength < 0 || slicelength > rawsize - sliceoffset)
+		slicelength = rawsize - sliceoffset;
+
+	/* read the fixed part of the header, and then the block ends */
+	hdrbuf = toast_fetch_compressed_prefix(attr, sizeof(toast_compress_blocks));
+	hdr = (toast_compress_blocks *) ((char *) hdrbuf + VARHDRSZ_COMPRESSED);
+	if (hdr->blocksize <= 0 || hdr->blocksize > TOAST_COMPRESS_BLOCK_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed data is corrupt")));
+	nblocks = TOAST_COMPRESS_BLOCKS_NBLOCKS(rawsize, hdr->blocksize);
+	pfree(hdrbuf);
+
+	hdrbuf = toast_fetch_compressed_prefix(attr,
+										   TOAST_COMPRESS_BLOCKS_HDRSZ(nblocks));
+	hdr = (toast_compress_blocks *) ((char *) hdrbuf + VARHDRSZ_COMPRESSED);
+
+	start = sliceoffset / hdr->blocksize;
+	last = (sliceoffset + slicelength - 1) / hdr->blocksize;
+	begin = (start > 0) ? hdr->ends[start - 1] : 0;
+	datalength = (int32) hdr->ends[last] - begin;
+
+	/* the stored data starts with va_tcinfo, then the header */
+	begin += sizeof(int32) + TOAST_COMPRESS_BLOCKS_HDRSZ(nblocks);
+	if (datalength < 0 || begin + datalength > attrsize)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed data is corrupt")));
+
+	data = (struct varlena *) palloc(datalength + VARHDRSZ);
+	SET_VARSIZE(data, datalength + VARHDRSZ);
+
+	toastrel = table_open(toast_pointer.va_toastrelid, AccessShareLock);
+	table_relation_fetch_toast_slice(toastrel, toast_pointer.va_valueid,
+									 attrsize, begin, datalength, data);
+	table_close(toastrel, AccessShareLock);
+
+	result = blocks_decompress(hdr, rawsize, VARDATA(data), datalength,
+							   start, sliceoffset, slicelength);
+
+	pfree(data);
+	pfree(hdrbuf);
+
+	return result;
+}
+
+/* ----------
+ * toast_fetch_compressed_prefix -
+ *
+ *	Fetch the first 'length' bytes of the compressed data of a compressed
+ *	external datum, after its va_tcinfo.
+ * ----------
+ */
+struct varlena *
+toast_fetch_compressed_prefix(struct varlena *attr, int32 length)
+{
+	struct varlena *result;
+
+	result = toast_fetch_datum_slice(attr, 0, length);
+	if (VARSIZE(result) < VARHDRSZ_COMPRESSED + length)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed data is corrupt")));
+
+	return result;
+}
+
+/* ----------
+ * toast_decompress_blocks -
+ *
+ *	Decompress a segment of an in-memory datum compressed in blocks
+ * ----------
+ */
+static struct varlena *
+toast_decompress_blocks(struct varlena *attr, int32 sliceoffset,
+						int32 slicelength)
+{
+	toast_compress_blocks *hdr;
+	int32		rawsize = TOAST_COMPRESS_EXTSIZE(attr);
+	int32		nblocks;
+	int32		datalen;
+
+	hdr = (toast_compress_blocks *) ((char *) attr + VARHDRSZ_COMPRESSED);
+	if (hdr->blocksize <= 0 || hdr->blocksize > TOAST_COMPRESS_BLOCK_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed data is corrupt")));
+	nblocks = TOAST_COMPRESS_BLOCKS_NBLOCKS(rawsize, hdr->blocksize);
+	datalen = VARSIZE(attr) - VARHDRSZ_COMPRESSED -
+		TOAST_COMPRESS_BLOCKS_HDRSZ(nblocks);
+
+	return blocks_decompress(hdr, rawsize,
+							 (char *) hdr + TOAST_COMPRESS_BLOCKS_HDRSZ(nblocks),
+							 datalen, 0, sliceoffset, slicelength);
+}
+
 /* ----------
  * toast_decompress_datum -
  *
@@ -485,6 +640,8 @@ toast_decompress_datum(struct varlena *attr)
 			return pglz_decompress_datum(attr);
 		case TOAST_LZ4_COMPRESSION_ID:
 			return lz4_decompress_datum(attr);
+		case TOAST_BLOCKS_COMPRESSION_ID:
+			return toast_decompress_blocks(attr, 0, -1);
 		default:
 			elog(ERROR, "invalid compression method id %d", cmid);
 			return NULL;		/* keep compiler quiet */
@@ -528,6 +685,8 @@ toast_decompress_datum_slice(struct varlena *attr, int32 slicelength)
 			return pglz_decompress_datum_slice(attr, slicelength);
 		case TOAST_LZ4_COMPRESSION_ID:
 			return lz4_decompress_datum_slice(attr, slicelength);
+		case TOAST_BLOCKS_COMPRESSION_ID:
+			return toast_decompress_blocks(attr, 0, slicelength);
 		default:
 			elog(ERROR, "invalid compression method id %d", cmid);
 			return NULL;		/* keep compiler quiet */
@@ -22,6 +22,7 @@
 #include "common/pg_lzcompress.h"
 #include "fmgr.h"
 #include "utils/builtins.h"
+#include "utils/memutils.h"
 
 /* GUC */
 int	   default_toast_compression = TOAST_PGLZ_COMPRESSION;
@@ -247,10 +248,237 @@ lz4_decompress_datum_slice(const struct varlena *value, int32 slicelength)
 #endif
 }
 
+/*
+ * Compress one block of a value compressed in blocks.
+ *
+ * Returns the number of bytes stored at dest, which is the raw size of the
+ * block if it had to be stored without compression.  dest must have room for
+ * the worst case output of the compression method, destlen bytes.
+ */
+static int32
+blocks_compress_block(ToastCompressionId cmid, const char *source,
+					  int32 rawlen, char *dest, int32 destlen)
+{
+	int32		len = -1;
+
+	switch (cmid)
+	{
+		case TOAST_PGLZ_COMPRESSION_ID:
+			len = pglz_compress(source, rawlen, dest, NULL);
+			break;
+		case TOAST_LZ4_COMPRESSION_ID:
+#ifndef USE_LZ4
+			NO_LZ4_SUPPORT();
+#else
+			len = LZ4_compress_default(source, dest, rawlen, destlen);
+			if (len <= 0)
+				elog(ERROR, "lz4 compression failed");
+#endif
+			break;
+		default:
+			elog(ERROR, "invalid compression method id %d", cmid);
+	}
+
+	if (len < 0 || len >= rawlen)
+	{
+		memcpy(dest, source, rawlen);
+		len = rawlen;
+	}
+
+	return len;
+}
+
+/*
+ * Compress a varlena in blocks of TOAST_COMPRESS_BLOCK_SIZE bytes, using the
+ * given compression method for each block.
+ *
+ * Returns the compressed varlena, or NULL if compression fails.
+ */
+struct varlena *
+blocks_compress_datum(const struct varlena *value, char cmethod)
+{
+	int32		valsize = VARSIZE_ANY_EXHDR(value);
+	const char *source = VARDATA_ANY(value);
+	int32		blocksize = TOAST_COMPRESS_BLOCK_SIZE;
+	int32		nblocks = TOAST_COMPRESS_BLOCKS_NBLOCKS(valsize, blocksize);
+	int32		hdrsize = VARHDRSZ_COMPRESSED +
+		TOAST_COMPRESS_BLOCKS_HDRSZ(nblocks);
+	int32		max_block_output;
+	ToastCompressionId cmid;
+	toast_compress_blocks *hdr;
+	struct varlena *tmp;
+	char	   *scratch;
+	Size		maxlen;
+	Size		alloclen;
+	int32		len = 0;
+	int32		i;
+
+	switch (cmethod)
+	{
+		case TOAST_PGLZ_COMPRESSION:
+			cmid = TOAST_PGLZ_COMPRESSION_ID;
+			max_block_output = PGLZ_MAX_OUTPUT(blocksize);
+			break;
+		case TOAST_LZ4_COMPRESSION:
+#ifndef USE_LZ4
+			NO_LZ4_SUPPORT();
+#endif
+			cmid = TOAST_LZ4_COMPRESSION_ID;
+#ifdef USE_LZ4
+			max_block_output = Max(LZ4_compressBound(blocksize), blocksize);
+#endif
+			break;
+		default:
+			elog(ERROR, "invalid compression method %c", cmethod);
+			return NULL;		/* keep compiler quiet */
+	}
+
+	/*
+	 * Compress each block into a scratch buffer with room for the worst case
+	 * output, and append just what it produced to the result, which grows as
+	 * needed.  We give up as soon as the output is no smaller than the input
+	 * (the caller checks whether we saved enough), so the result never takes
+	 * more than hdrsize + valsize bytes, however large the worst case output
+	 * of all the blocks together would be.
+	 */
+	maxlen = Min((Size) hdrsize + valsize - 1, MaxAllocSize);
+	alloclen = Min((Size) hdrsize + blocksize, maxlen);
+	scratch = (char *) palloc(max_block_output);
+	tmp = (struct varlena *) palloc(alloclen);
+	hdr = (toast_compress_blocks *) ((char *) tmp + VARHDRSZ_COMPRESSED);
+	hdr->method = cmid;
+	hdr->blocksize = blocksize;
+
+	for (i = 0; i < nblocks; i++)
+	{
+		int32		rawlen = Min(blocksize, valsize - i * blocksize);
+		int32		blocklen;
+		Size		needed;
+
+		blocklen = blocks_compress_block(cmid, source + i * blocksize, rawlen,
+										 scratch, max_block_output);
+		needed = (Size) hdrsize + len + blocklen;
+		if (needed > maxlen)
+		{
+			pfree(scratch);
+			pfree(tmp);
+			return NULL;
+		}
+		if (needed > alloclen)
+		{
+			alloclen = Min(Max(alloclen * 2, needed), maxlen);
+			tmp = (struct varlena *) repalloc(tmp, alloclen);
+			hdr = (toast_compress_blocks *) ((char *) tmp + VARHDRSZ_COMPRESSED);
+		}
+		memcpy((char *) tmp + hdrsize + len, scratch, blocklen);
+		len += blocklen;
+		hdr->ends[i] = len;
+	}
+
+	pfree(scratch);
+
+	SET_VARSIZE_COMPRESSED(tmp, hdrsize + len);
+
+	return tmp;
+}
+
+/*
+ * Decompress the blocks of a value compressed in blocks that cover the slice
+ * of 'slicelength' bytes at 'sliceoffset', or up to the end if slicelength is
+ * negative, of its 'rawsize' bytes of raw data.
+ *
+ * 'data' points to the 'datalen' bytes of compressed data that start with
+ * block 'firstblock', which must be at or before the first block of the
+ * slice, and go at least up to the last block of the slice.  This lets the
+ * caller fetch only the blocks it needs.
+ */
+struct varlena *
+blocks_decompress(const toast_compress_blocks *hdr, int32 rawsize,
+				  const char *data, int32 datalen, int32 firstblock,
+				  int32 sliceoffset, int32 slicelength)
+{
+	int32		blocksize = hdr->blocksize;
+	int32		start;
+	int32		last;
+	int32		base;
+	char	   *dest;
+	struct varlena *result;
+	int32		i;
+
+	if (sliceoffset >= rawsize || slicelength == 0)
+	{
+		result = (struct varlena *) palloc(VARHDRSZ);
+		SET_VARSIZE(result, VARHDRSZ);
+		return result;
+	}
+	if (slicelength < 0 || slicelength > rawsize - sliceoffset)
+		slicelength = rawsize - sliceoffset;
+
+	if (blocksize <= 0 || firstblock > sliceoffset / blocksize)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg_internal("compressed data is corrupt")));
+
+	start = sliceoffset / blocksize;
+	last = (sliceoffset + slicelength - 1) / blocksize;
+	base = (firstblock > 0) ? hdr->ends[firstblock - 1] : 0;
+
+	/* decompress whole blocks, then move the slice to the front */
+	result = (struct varlena *) palloc(VARHDRSZ +
+									   Min(rawsize - start * blocksize,
+										   (last - start + 1) * blocksize));
+	dest = VARDATA(result);
+
+	for (i = start; i <= last; i++)
+	{
+		int32		rawlen = Min(blocksize, rawsize - i * blocksize);
+		int32		begin = (i > 0) ? hdr->ends[i - 1] : 0;
+		int32		len = (int32) hdr->ends[i] - begin;
+		const char *source = data + begin - base;
+		int32		declen = -1;
+
+		if (begin < base || len < 0 || len > rawlen ||
+			len > datalen - (begin - base))
+			declen = -1;
+		else if (len == rawlen)
+		{
+			memcpy(dest, source, rawlen);
+			declen = rawlen;
+		}
+		else if (hdr->method == TOAST_PGLZ_COMPRESSION_ID)
+			declen = pglz_decompress(source, len, dest, rawlen, true);
+		else if (hdr->method == TOAST_LZ4_COMPRESSION_ID)
+		{
+#ifndef USE_LZ4
+			NO_LZ4_SUPPORT();
+#else
+			declen = LZ4_decompress_safe(source, dest, len, rawlen);
+#endif
+		}
+
+		if (declen != rawlen)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg_internal("compressed data is corrupt")));
+
+		dest += rawlen;
+	}
+
+	if (sliceoffset > start * blocksize)
+		memmove(VARDATA(result),
+				VARDATA(result) + (sliceoffset - start * blocksize),
+				slicelength);
+	SET_VARSIZE(result, slicelength + VARHDRSZ);
+
+	return result;
+}
+
 /*
  * Extract compression ID from a varlena.
  *
  * Returns TOAST_INVALID_COMPRESSION_ID if the varlena is not compressed.
+ * For values compressed in blocks, this is the compression method of the
+ * blocks.
  */
 ToastCompressionId
 toast_get_compression_id(struct varlena *attr)
@@ -270,10 +498,27 @@ toast_get_compression_id(struct varlena *attr)
 
 		if (VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
 			cmid = VARATT_EXTERNAL_GET_COMPRESS_METHOD(toast_pointer);
+
+		if (cmid == TOAST_BLOCKS_COMPRESSION_ID)
+		{
+			struct varlena *prefix;
+
+			prefix = toast_fetch_compressed_prefix(attr,
+												   sizeof(toast_compress_blocks));
+			cmid = ((toast_compress_blocks *)
+					((char *) prefix + VARHDRSZ_COMPRESSED))->method;
+			pfree(prefix);
+		}
 	}
 	else if (VARATT_IS_COMPRESSED(attr))
+	{
 		cmid = VARDATA_COMPRESSED_GET_COMPRESS_METHOD(attr);
 
+		if (cmid == TOAST_BLOCKS_COMPRESSION_ID)
+			cmid = ((toast_compress_blocks *)
+					((char *) attr + VARHDRSZ_COMPRESSED))->method;
+	}
+
 	return cmid;
 }
 
@@ -58,20 +58,31 @@ toast_compress_datum(Datum value, char cmethod)
 	valsize = VARSIZE_ANY_EXHDR(DatumGetPointer(value));
 
 	/*
-	 * Call appropriate compression routine for the compression method.
+	 * Values larger than a block are compressed in blocks, so that slices of
+	 * them can be decompressed without decompressing everything before them.
+	 * Otherwise call appropriate compression routine for the compression
+	 * method.
 	 */
-	switch (cmethod)
+	if (valsize > TOAST_COMPRESS_BLOCK_SIZE)
 	{
-		case TOAST_PGLZ_COMPRESSION:
-			tmp = pglz_compress_datum((const struct varlena *) value);
-			cmid = TOAST_PGLZ_COMPRESSION_ID;
-			break;
-		case TOAST_LZ4_COMPRESSION:
-			tmp = lz4_compress_datum((const struct varlena *) value);
-			cmid = TOAST_LZ4_COMPRESSION_ID;
-			break;
-		default:
-			elog(ERROR, "invalid compression method %c", cmethod);
+		tmp = blocks_compress_datum((const struct varlena *) value, cmethod);
+		cmid = TOAST_BLOCKS_COMPRESSION_ID;
+	}
+	else
+	{
+		switch (cmethod)
+		{
+			case TOAST_PGLZ_COMPRESSION:
+				tmp = pglz_compress_datum((const struct varlena *) value);
+				cmid = TOAST_PGLZ_COMPRESSION_ID;
+				break;
+			case TOAST_LZ4_COMPRESSION:
+				tmp = lz4_compress_datum((const struct varlena *) value);
+				cmid = TOAST_LZ4_COMPRESSION_ID;
+				break;
+			default:
+				elog(ERROR, "invalid compression method %c", cmethod);
+		}
 	}
 
 	if (tmp == NULL)
@@ -227,6 +227,8 @@ ginHeapTupleFastInsert(GinState *ginstate, GinTupleCollector *collector)
 	ginxlogUpdateMeta data;
 	bool		separateList = false;
 	bool		needCleanup = false;
+	bool		requestCleanup = false;
+	BlockNumber prevPendingPages = 0;
 	int			cleanupSize;
 	bool		needWal;
 
@@ -293,6 +295,7 @@ ginHeapTupleFastInsert(GinState *ginstate, GinTupleCollector *collector)
 		 */
 		LockBuffer(metabuffer, GIN_EXCLUSIVE);
 		metadata = GinPageGetMeta(metapage);
+		prevPendingPages = metadata->nPendingPages;
 
 		if (metadata->head == InvalidBlockNumber)
 		{
@@ -448,12 +451,33 @@ ginHeapTupleFastInsert(GinState *ginstate, GinTupleCollector *collector)
 	 */
 	cleanupSize = GinGetPendingListCleanupSize(index);
 	if (metadata->nPendingPages * GIN_PAGE_FREESIZE > cleanupSize * 1024L)
-		needCleanup = true;
+	{
+		/*
+		 * Rather than making this insertion pay for the cleanup, ask
+		 * autovacuum to do it, once, from the insertion that pushed the list
+		 * past the limit.  We still clean up here if autovacuum can't help
+		 * us (it is disabled, or cannot see our local buffers), or if the
+		 * list has grown to twice the limit anyway, meaning the request was
+		 * lost or autovacuum isn't keeping up.
+		 */
+		if (!AutoVacuumingActive() || RelationUsesLocalBuffers(index) ||
+			metadata->nPendingPages * GIN_PAGE_FREESIZE > 2 * cleanupSize * 1024L)
+			needCleanup = true;
+		else if (separateList &&
+				 prevPendingPages * GIN_PAGE_FREESIZE <= cleanupSize * 1024L)
+			requestCleanup = true;
+	}
 
 	UnlockReleaseBuffer(metabuffer);
 
 	END_CRIT_SECTION();
 
+	if (requestCleanup &&
+		!AutoVacuumRequestWork(AVW_GINCleanupPendingList,
+							   RelationGetRelid(index),
+							   InvalidBlockNumber))
+		needCleanup = true;
+
 	/*
 	 * Since it could contend with concurrent cleanup process we cleanup
 	 * pending list not forcibly.
@@ -37,6 +37,9 @@ static uint64 part_bits32_by2(uint32 x);
 static uint32 ieee_float32_to_uint32(float f);
 static int gist_bbox_zorder_cmp(Datum a, Datum b, SortSupport ssup);
 static Datum gist_bbox_zorder_abbrev_convert(Datum original, SortSupport ssup);
+static uint64 box_center_zorder_internal(BOX *box);
+static int gist_bbox_center_zorder_cmp(Datum a, Datum b, SortSupport ssup);
+static Datum gist_bbox_center_zorder_abbrev_convert(Datum original, SortSupport ssup);
 static int gist_bbox_zorder_cmp_abbrev(Datum z1, Datum z2, SortSupport ssup);
 static bool gist_bbox_zorder_abbrev_abort(int memtupcount, SortSupport ssup);
 
@@ -1741,6 +1744,60 @@ gist_bbox_zorder_cmp_abbrev(Datum z1, Datum z2, SortSupport ssup)
 		return 0;
 }
 
+/*
+ * Compute Z-value of the center of a bounding box
+ *
+ * Used for opclasses whose keys are boxes of nonzero size (box, polygon and
+ * circle), where sorting by the lower-left corner alone would scatter large
+ * boxes away from their neighbours.  Each coordinate is halved before adding
+ * so that huge finite values can't overflow to infinity.
+ */
+static uint64
+box_center_zorder_internal(BOX *box)
+{
+	return point_zorder_internal(box->low.x / 2 + box->high.x / 2,
+								 box->low.y / 2 + box->high.y / 2);
+}
+
+/*
+ * Compare the Z-order of bounding box centers
+ */
+static int
+gist_bbox_center_zorder_cmp(Datum a, Datum b, SortSupport ssup)
+{
+	BOX		   *b1 = DatumGetBoxP(a);
+	BOX		   *b2 = DatumGetBoxP(b);
+	uint64		z1;
+	uint64		z2;
+
+	z1 = box_center_zorder_internal(b1);
+	z2 = box_center_zorder_internal(b2);
+	if (z1 > z2)
+		return 1;
+	else if (z1 < z2)
+		return -1;
+	else
+		return 0;
+}
+
+/*
+ * Abbreviated version of bounding box center Z-order comparison; the
+ * abbreviated format is the same as for points.
+ */
+static Datum
+gist_bbox_center_zorder_abbrev_convert(Datum original, SortSupport ssup)
+{
+	uint64		z;
+
+	z = box_center_zorder_internal(DatumGetBoxP(original));
+
+#if SIZEOF_DATUM == 8
+	return (Datum) z;
+#else
+	return (Datum) (z >> 32);
+#endif
+}
+
 /*
  * We never consider aborting the abbreviation.
  *
@@ -1775,3 +1832,26 @@ gist_point_sortsupport(PG_FUNCTION_ARGS)
 	}
 	PG_RETURN_VOID();
 }
+
+/*
+ * Sort support routine for fast GiST index build by sorting, for opclasses
+ * whose keys are bounding boxes (box_ops, poly_ops and circle_ops).
+ */
+Datum
+gist_box_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+
+	if (ssup->abbreviate)
+	{
+		ssup->comparator = gist_bbox_zorder_cmp_abbrev;
+		ssup->abbrev_converter = gist_bbox_center_zorder_abbrev_convert;
+		ssup->abbrev_abort = gist_bbox_zorder_abbrev_abort;
+		ssup->abbrev_full_comparator = gist_bbox_center_zorder_cmp;
+	}
+	else
+	{
+		ssup->comparator = gist_bbox_center_zorder_cmp;
+	}
+	PG_RETURN_VOID();
+}
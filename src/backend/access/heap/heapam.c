@@ -314,6 +314,26 @@ initscan(HeapScanDesc scan, ScanKey key, bool keep_startblock)
 		scan->rs_startblock = 0;
 	}
 
+	/*
+	 * Serial forward scans of large tables read ahead of the current page,
+	 * so that the kernel can have several reads in flight while we process
+	 * the current page.  We use the same size threshold as for the bulk-read
+	 * strategy: smaller tables are likely to be cached in shared buffers
+	 * anyway, in which case prefetching would only add buffer mapping
+	 * lookups.  Parallel scans hand out blocks in chunks, so we leave them
+	 * to the kernel's own read-ahead.
+	 */
+	scan->rs_prefetch_target = 0;
+#ifdef USE_PREFETCH
+	if (allow_strat && scan->rs_base.rs_parallel == NULL &&
+		(scan->rs_base.rs_flags & SO_TYPE_SEQSCAN) != 0)
+		scan->rs_prefetch_target =
+			get_tablespace_io_concurrency(scan->rs_base.rs_rd->rd_rel->reltablespace);
+#endif
+	scan->rs_prefetch_pages = 0;
+	scan->rs_prefetch_block = InvalidBlockNumber;
+	scan->rs_prefetch_left = 0;
+
 	scan->rs_numblocks = InvalidBlockNumber;
 	scan->rs_inited = false;
 	scan->rs_ctup.t_data = NULL;
@@ -360,6 +380,47 @@ heap_setscanlimits(TableScanDesc sscan, BlockNumber startBlk, BlockNumber numBlk
 	scan->rs_numblocks = numBlks;
 }
 
+/*
+ * heapgettup_prefetch - issue read-ahead for a serial forward heap scan
+ *
+ * "page" is the page the scan is about to read; "start" is true if it is the
+ * first page of the scan.  We try to keep rs_prefetch_target pages beyond
+ * the current one prefetched, following the same (possibly wrapped-around)
+ * block order that heapgettup() and heapgettup_pagemode() will visit.
+ */
+static inline void
+heapgettup_prefetch(HeapScanDesc scan, BlockNumber page, bool start)
+{
+#ifdef USE_PREFETCH
+	if (scan->rs_prefetch_target <= 0)
+		return;
+
+	if (start)
+	{
+		BlockNumber nblocks;
+
+		nblocks = (scan->rs_numblocks != InvalidBlockNumber) ?
+			scan->rs_numblocks : scan->rs_nblocks;
+		scan->rs_prefetch_pages = 0;
+		scan->rs_prefetch_left = nblocks - 1;
+		scan->rs_prefetch_block = page;
+	}
+	else if (scan->rs_prefetch_pages > 0)
+		scan->rs_prefetch_pages--;
+
+	while (scan->rs_prefetch_pages < scan->rs_prefetch_target &&
+		   scan->rs_prefetch_left > 0)
+	{
+		if (++scan->rs_prefetch_block >= scan->rs_nblocks)
+			scan->rs_prefetch_block = 0;
+		PrefetchBuffer(scan->rs_base.rs_rd, MAIN_FORKNUM,
+					   scan->rs_prefetch_block);
+		scan->rs_prefetch_pages++;
+		scan->rs_prefetch_left--;
+	}
+#endif							/* USE_PREFETCH */
+}
+
 /*
  * heapgetpage - subroutine for heapgettup()
  *
@@ -557,7 +618,10 @@ heapgettup(HeapScanDesc scan,
 				}
 			}
 			else
+			{
 				page = scan->rs_startblock; /* first page */
+				heapgettup_prefetch(scan, page, true);
+			}
 			heapgetpage((TableScanDesc) scan, page);
 			lineoff = FirstOffsetNumber;	/* first offnum */
 			scan->rs_inited = true;
@@ -790,6 +854,9 @@ heapgettup(HeapScanDesc scan,
 			 */
 			if (scan->rs_base.rs_flags & SO_ALLOW_SYNC)
 				ss_report_location(scan->rs_base.rs_rd, page);
+
+			if (!finished)
+				heapgettup_prefetch(scan, page, false);
 		}
 
 		/*
@@ -895,7 +962,10 @@ heapgettup_pagemode(HeapScanDesc scan,
 				}
 			}
 			else
+			{
 				page = scan->rs_startblock; /* first page */
+				heapgettup_prefetch(scan, page, true);
+			}
 			heapgetpage((TableScanDesc) scan, page);
 			lineindex = 0;
 			scan->rs_inited = true;
@@ -1099,6 +1169,9 @@ heapgettup_pagemode(HeapScanDesc scan,
 			 */
 			if (scan->rs_base.rs_flags & SO_ALLOW_SYNC)
 				ss_report_location(scan->rs_base.rs_rd, page);
+
+			if (!finished)
+				heapgettup_prefetch(scan, page, false);
 		}
 
 		/*
@@ -30,7 +30,9 @@
 #include "access/heaptoast.h"
 #include "access/toast_helper.h"
 #include "access/toast_internals.h"
+#include "storage/bufmgr.h"
 #include "utils/fmgroids.h"
+#include "utils/spccache.h"
 
 
 /* ----------
@@ -640,6 +642,11 @@ heap_fetch_toast_slice(Relation toastrel, Oid valueid, int32 attrsize,
 	int			num_indexes;
 	int			validIndex;
 	SnapshotData SnapshotToast;
+#ifdef USE_PREFETCH
+	int			prefetch_target = 0;
+	BlockNumber prefetch_nblocks = InvalidBlockNumber;
+	BlockNumber prefetch_next = InvalidBlockNumber;
+#endif
 
 	/* Look for the valid index of toast relation */
 	validIndex = toast_open_indexes(toastrel,
@@ -689,6 +696,23 @@ heap_fetch_toast_slice(Relation toastrel, Oid valueid, int32 attrsize,
 	toastscan = systable_beginscan_ordered(toastrel, toastidxs[validIndex],
 										   &SnapshotToast, nscankeys, toastkey);
 
+#ifdef USE_PREFETCH
+
+	/*
+	 * The chunks of a value are usually stored on consecutive pages, so when
+	 * there are more of them than fit on a few pages, prefetch the pages
+	 * following the one of the current chunk, rather than waiting for each
+	 * page to be read on its own.
+	 */
+	if (endchunk - startchunk + 1 > 2 * EXTERN_TUPLES_PER_PAGE)
+	{
+		prefetch_target =
+			get_tablespace_io_concurrency(toastrel->rd_rel->reltablespace);
+		if (prefetch_target > 0)
+			prefetch_nblocks = RelationGetNumberOfBlocks(toastrel);
+	}
+#endif
+
 	/*
 	 * Read the chunks by index
 	 *
@@ -711,6 +735,29 @@ heap_fetch_toast_slice(Relation toastrel, Oid valueid, int32 attrsize,
 		 */
 		curchunk = DatumGetInt32(fastgetattr(ttup, 2, toasttupDesc, &isnull));
 		Assert(!isnull);
+
+#ifdef USE_PREFETCH
+		if (prefetch_target > 0 && curchunk < endchunk)
+		{
+			BlockNumber blkno = ItemPointerGetBlockNumber(&ttup->t_self);
+			BlockNumber lastblock;
+
+			/* the pages the remaining chunks would take, if consecutive */
+			lastblock = blkno + (endchunk - curchunk + EXTERN_TUPLES_PER_PAGE - 1) /
+				EXTERN_TUPLES_PER_PAGE;
+			lastblock = Min(lastblock, blkno + prefetch_target);
+			lastblock = Min(lastblock, prefetch_nblocks - 1);
+
+			/* start over if the chunks weren't stored where we guessed */
+			if (prefetch_next == InvalidBlockNumber || prefetch_next <= blkno ||
+				prefetch_next > lastblock + 1)
+				prefetch_next = blkno + 1;
+
+			while (prefetch_next <= lastblock)
+				PrefetchBuffer(toastrel, MAIN_FORKNUM, prefetch_next++);
+		}
+#endif
+
 		chunk = DatumGetPointer(fastgetattr(ttup, 3, toasttupDesc, &isnull));
 		Assert(!isnull);
 		if (!VARATT_IS_EXTENDED(chunk))
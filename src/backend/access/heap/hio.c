@@ -192,12 +192,13 @@ GetVisibilityMapPins(Relation relation, Buffer buffer1, Buffer buffer2,
  * the result to some sane overall value.
  */
 static void
-RelationAddExtraBlocks(Relation relation, BulkInsertState bistate)
+RelationAddExtraBlocks(Relation relation)
 {
 	BlockNumber blockNum,
-				firstBlock = InvalidBlockNumber;
-	int			extraBlocks;
+				firstBlock;
+	BlockNumber extraBlocks;
 	int			lockWaiters;
+	Size		freespace;
 
 	/* Use the length of the lock wait queue to judge how much to extend. */
 	lockWaiters = RelationExtensionLockWaiterCount(relation);
@@ -212,53 +213,34 @@ RelationAddExtraBlocks(Relation relation, BulkInsertState bistate)
 	 */
 	extraBlocks = Min(512, lockWaiters * 20);
 
-	do
-	{
-		Buffer		buffer;
-		Page		page;
-		Size		freespace;
-
-		/*
-		 * Extend by one page.  This should generally match the main-line
-		 * extension code in RelationGetBufferForTuple, except that we hold
-		 * the relation extension lock throughout, and we don't immediately
-		 * initialize the page (see below).
-		 */
-		buffer = ReadBufferBI(relation, P_NEW, RBM_ZERO_AND_LOCK, bistate);
-		page = BufferGetPage(buffer);
-
-		if (!PageIsNew(page))
-			elog(ERROR, "page %u of relation \"%s\" should be empty but is not",
-				 BufferGetBlockNumber(buffer),
-				 RelationGetRelationName(relation));
-
-		/*
-		 * Add the page to the FSM without initializing. If we were to
-		 * initialize here, the page would potentially get flushed out to disk
-		 * before we add any useful content. There's no guarantee that that'd
-		 * happen before a potential crash, so we need to deal with
-		 * uninitialized pages anyway, thus avoid the potential for
-		 * unnecessary writes.
-		 */
-
-		/* we'll need this info below */
-		blockNum = BufferGetBlockNumber(buffer);
-		freespace = BufferGetPageSize(buffer) - SizeOfPageHeaderData;
-
-		UnlockReleaseBuffer(buffer);
-
-		/* Remember first block number thus added. */
-		if (firstBlock == InvalidBlockNumber)
-			firstBlock = blockNum;
+	/*
+	 * Write all the new pages to the file in one go, bypassing shared
+	 * buffers.  They are all-zeroes, which is exactly what extending through
+	 * the buffer manager with RBM_ZERO_AND_LOCK would have produced, and
+	 * since we hold the relation extension lock nobody else can have a buffer
+	 * for them yet.  Doing it this way costs a handful of vectored writes
+	 * instead of a buffer allocation, a buffer-mapping insertion and a write
+	 * system call per page, all while other backends wait on our lock.
+	 *
+	 * We don't initialize the pages.  If we were to initialize them here,
+	 * they would potentially get flushed out to disk before we add any useful
+	 * content.  There's no guarantee that that'd happen before a potential
+	 * crash, so we need to deal with uninitialized pages anyway, thus avoid
+	 * the potential for unnecessary writes.
+	 */
+	firstBlock = RelationGetNumberOfBlocks(relation);
+	RelationOpenSmgr(relation);
+	smgrzeroextend(relation->rd_smgr, MAIN_FORKNUM, firstBlock, extraBlocks,
+				   false);
 
-		/*
-		 * Immediately update the bottom level of the FSM.  This has a good
-		 * chance of making this page visible to other concurrently inserting
-		 * backends, and we want that to happen without delay.
-		 */
+	/*
+	 * Immediately update the bottom level of the FSM.  This has a good chance
+	 * of making these pages visible to other concurrently inserting backends,
+	 * and we want that to happen without delay.
+	 */
+	freespace = BLCKSZ - SizeOfPageHeaderData;
+	for (blockNum = firstBlock; blockNum < firstBlock + extraBlocks; blockNum++)
 		RecordPageWithFreeSpace(relation, blockNum, freespace);
-	}
-	while (--extraBlocks > 0);
 
 	/*
 	 * Updating the upper levels of the free space map is too expensive to do
@@ -266,7 +248,7 @@ RelationAddExtraBlocks(Relation relation, BulkInsertState bistate)
 	 * subsequent insertion activity sees all of those nifty free pages we
 	 * just inserted.
 	 */
-	FreeSpaceMapVacuumRange(relation, firstBlock, blockNum + 1);
+	FreeSpaceMapVacuumRange(relation, firstBlock, firstBlock + extraBlocks);
 }
 
 /*
@@ -608,7 +590,7 @@ loop:
 			}
 
 			/* Time to bulk-extend. */
-			RelationAddExtraBlocks(relation, bistate);
+			RelationAddExtraBlocks(relation);
 		}
 	}
 
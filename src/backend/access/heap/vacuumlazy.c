@@ -11,11 +11,14 @@
  *
  * We are willing to use at most maintenance_work_mem (or perhaps
  * autovacuum_work_mem) memory space to keep track of dead tuples.  We
- * initially allocate an array of TIDs of that size, with an upper limit that
+ * initially allocate a TID store of that size, with an upper limit that
  * depends on table size (this limit ensures we don't allocate a huge area
- * uselessly for vacuuming small tables).  If the array threatens to overflow,
- * we suspend the heap scan phase and perform a pass of index cleanup and page
- * compaction, then resume the heap scan with an empty TID array.
+ * uselessly for vacuuming small tables).  The store keeps the block number of
+ * each page with dead tuples only once, followed by just the offset numbers of
+ * its dead tuples, so a page with many dead tuples costs little more than two
+ * bytes per TID.  If the store threatens to overflow, we suspend the heap scan
+ * phase and perform a pass of index cleanup and page compaction, then resume
+ * the heap scan with an empty TID store.
  *
  * If we're processing a table with no indexes, we can just vacuum each page
  * as we go; there's no need to save up multiple tuples to minimize the number
@@ -79,6 +82,7 @@
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/pg_rusage.h"
+#include "utils/spccache.h"
 #include "utils/timestamp.h"
 
 
@@ -176,23 +180,55 @@ typedef enum
  * LVDeadTuples stores the dead tuple TIDs collected during the heap scan.
  * This is allocated in the DSM segment in parallel mode and in local memory
  * in non-parallel mode.
+ *
+ * The space is an array of max_tuples OffsetNumber-sized slots.  The offset
+ * numbers of the dead tuples fill it from the front, while an LVDeadBlock
+ * entry for each heap page with dead tuples is allocated from the back, so
+ * the block array's entry i is located at DeadTuplesBlock(dead_tuples, i).
+ * Both are ordered by TID address, and a block's offset numbers run from its
+ * first entry up to the next block's first (or num_tuples for the last
+ * block).
  */
+typedef struct LVDeadBlock
+{
+	BlockNumber blkno;			/* heap page with dead tuples */
+	int			first;			/* index of its first entry in offsets[] */
+} LVDeadBlock;
+
 typedef struct LVDeadTuples
 {
 	int			max_tuples;		/* # slots allocated in array */
-	int			num_tuples;		/* current # of entries */
-	/* List of TIDs of tuples we intend to delete */
-	/* NB: this list is ordered by TID address */
-	ItemPointerData itemptrs[FLEXIBLE_ARRAY_MEMBER];	/* array of
-														 * ItemPointerData */
+	int			num_tuples;		/* current # of TIDs */
+	int			num_blocks;		/* current # of LVDeadBlock entries */
+	int			pad;			/* keep offsets[] MAXALIGN'd */
+	OffsetNumber offsets[FLEXIBLE_ARRAY_MEMBER];
 } LVDeadTuples;
 
-/* The dead tuple space consists of LVDeadTuples and dead tuple TIDs */
+/* # of slots taken up by each LVDeadBlock */
+#define DEADBLOCK_SLOTS		(sizeof(LVDeadBlock) / sizeof(OffsetNumber))
+
+#define DeadTuplesBlock(dt, i) \
+	((LVDeadBlock *) ((dt)->offsets + (dt)->max_tuples) - ((i) + 1))
+#define DeadTuplesBlockCount(dt, i) \
+	(((i) + 1 < (dt)->num_blocks ? \
+	  DeadTuplesBlock(dt, (i) + 1)->first : (dt)->num_tuples) - \
+	 DeadTuplesBlock(dt, i)->first)
+#define DeadTuplesFreeSlots(dt) \
+	((dt)->max_tuples - (dt)->num_tuples - \
+	 (dt)->num_blocks * (int) DEADBLOCK_SLOTS)
+#define DeadTuplesReset(dt) \
+	((dt)->num_tuples = 0, (dt)->num_blocks = 0)
+
+/* The dead tuple space consists of LVDeadTuples and the slot array */
 #define SizeOfDeadTuples(cnt) \
-	add_size(offsetof(LVDeadTuples, itemptrs), \
-			 mul_size(sizeof(ItemPointerData), cnt))
+	add_size(offsetof(LVDeadTuples, offsets), \
+			 mul_size(sizeof(OffsetNumber), cnt))
 #define MAXDEADTUPLES(max_size) \
-		(((max_size) - offsetof(LVDeadTuples, itemptrs)) / sizeof(ItemPointerData))
+		((((max_size) - offsetof(LVDeadTuples, offsets)) / sizeof(OffsetNumber)) & \
+		 ~(DEADBLOCK_SLOTS - 1))
+
+/* # of slots needed to be sure that one more heap page's TIDs will fit */
+#define DEADTUPLES_PAGE_SLOTS	(MaxHeapTuplesPerPage + DEADBLOCK_SLOTS)
 
 /*
  * Shared information among parallel workers.  So this is allocated in the DSM
@@ -411,7 +447,7 @@ static void lazy_vacuum(LVRelState *vacrel, bool onecall);
 static bool lazy_vacuum_all_indexes(LVRelState *vacrel);
 static void lazy_vacuum_heap_rel(LVRelState *vacrel);
 static int	lazy_vacuum_heap_page(LVRelState *vacrel, BlockNumber blkno,
-								  Buffer buffer, int tupindex, Buffer *vmbuffer);
+								  Buffer buffer, int blkindex, Buffer *vmbuffer);
 static bool lazy_check_needs_freeze(Buffer buf, bool *hastup,
 									LVRelState *vacrel);
 static bool lazy_check_wraparound_failsafe(LVRelState *vacrel);
@@ -446,7 +482,6 @@ static void lazy_space_alloc(LVRelState *vacrel, int nworkers,
 							 BlockNumber relblocks);
 static void lazy_space_free(LVRelState *vacrel);
 static bool lazy_tid_reaped(ItemPointer itemptr, void *state);
-static int	vac_cmp_itemptr(const void *left, const void *right);
 static bool heap_page_is_all_visible(LVRelState *vacrel, Buffer buf,
 									 TransactionId *visibility_cutoff_xid, bool *all_frozen);
 static int	compute_parallel_vacuum_workers(LVRelState *vacrel,
@@ -1133,7 +1168,7 @@ lazy_scan_heap(LVRelState *vacrel, VacuumParams *params, bool aggressive)
 		 * dead-tuple TIDs, pause and do a cycle of vacuuming before we tackle
 		 * this page.
 		 */
-		if ((dead_tuples->max_tuples - dead_tuples->num_tuples) < MaxHeapTuplesPerPage &&
+		if (DeadTuplesFreeSlots(dead_tuples) < (int) DEADTUPLES_PAGE_SLOTS &&
 			dead_tuples->num_tuples > 0)
 		{
 			/*
@@ -1366,7 +1401,7 @@ lazy_scan_heap(LVRelState *vacrel, VacuumParams *params, bool aggressive)
 				lazy_vacuum_heap_page(vacrel, blkno, buf, 0, &vmbuffer);
 
 				/* Forget the now-vacuumed tuples */
-				dead_tuples->num_tuples = 0;
+				DeadTuplesReset(dead_tuples);
 
 				/*
 				 * Periodically perform FSM vacuuming to make newly-freed
@@ -1683,6 +1718,7 @@ lazy_scan_prune(LVRelState *vacrel,
 				num_tuples,
 				live_tuples;
 	int			nfrozen;
+	TransactionId freeze_limit;
 	OffsetNumber deadoffsets[MaxHeapTuplesPerPage];
 	xl_heap_freeze_tuple frozen[MaxHeapTuplesPerPage];
 
@@ -1922,6 +1958,49 @@ retry:
 	 */
 	vacrel->offnum = InvalidOffsetNumber;
 
+	/*
+	 * If the page is going to be dirtied and WAL-logged anyway, either
+	 * because pruning removed something or because some of its tuples have
+	 * reached FreezeLimit, and all of its remaining tuples are visible to
+	 * everyone, freeze the whole page now.  Doing so costs little more than
+	 * the write we're already doing, and lets us mark the page all-frozen in
+	 * the visibility map, so that a later aggressive (anti-wraparound) VACUUM
+	 * can skip it instead of reading and rewriting it again.  Since all the
+	 * tuples' xmins precede OldestXmin, it's a safe freeze cutoff, just as it
+	 * is when vacuum_freeze_min_age is 0.
+	 */
+	freeze_limit = vacrel->FreezeLimit;
+	if (prunestate->all_visible && !prunestate->all_frozen &&
+		(nfrozen > 0 || tuples_deleted > 0))
+	{
+		freeze_limit = vacrel->OldestXmin;
+		nfrozen = 0;
+		prunestate->all_frozen = true;
+
+		for (offnum = FirstOffsetNumber;
+			 offnum <= maxoff;
+			 offnum = OffsetNumberNext(offnum))
+		{
+			bool		tuple_totally_frozen;
+
+			itemid = PageGetItemId(page, offnum);
+			if (!ItemIdIsNormal(itemid))
+				continue;
+
+			if (heap_prepare_freeze_tuple((HeapTupleHeader) PageGetItem(page, itemid),
+										  vacrel->relfrozenxid,
+										  vacrel->relminmxid,
+										  freeze_limit,
+										  vacrel->MultiXactCutoff,
+										  &frozen[nfrozen],
+										  &tuple_totally_frozen))
+				frozen[nfrozen++].offset = offnum;
+
+			if (!tuple_totally_frozen)
+				prunestate->all_frozen = false;
+		}
+	}
+
 	/*
 	 * Consider the need to freeze any items with tuple storage from the page
 	 * first (arbitrary)
@@ -1958,7 +2037,7 @@ retry:
 		{
 			XLogRecPtr	recptr;
 
-			recptr = log_heap_freeze(vacrel->rel, buf, vacrel->FreezeLimit,
+			recptr = log_heap_freeze(vacrel->rel, buf, freeze_limit,
 									 frozen, nfrozen);
 			PageSetLSN(page, recptr);
 		}
@@ -2010,22 +2089,25 @@ retry:
 	if (lpdead_items > 0)
 	{
 		LVDeadTuples *dead_tuples = vacrel->dead_tuples;
-		ItemPointerData tmp;
+		LVDeadBlock *dblk;
 
 		Assert(!prunestate->all_visible);
 		Assert(prunestate->has_lpdead_items);
+		Assert(DeadTuplesFreeSlots(dead_tuples) >=
+			   lpdead_items + (int) DEADBLOCK_SLOTS);
 
 		vacrel->lpdead_item_pages++;
 
-		ItemPointerSetBlockNumber(&tmp, blkno);
+		dblk = DeadTuplesBlock(dead_tuples, dead_tuples->num_blocks);
+		dblk->blkno = blkno;
+		dblk->first = dead_tuples->num_tuples;
+		dead_tuples->num_blocks++;
 
-		for (int i = 0; i < lpdead_items; i++)
-		{
-			ItemPointerSetOffsetNumber(&tmp, deadoffsets[i]);
-			dead_tuples->itemptrs[dead_tuples->num_tuples++] = tmp;
-		}
+		/* deadoffsets[] was filled in ascending offset number order */
+		memcpy(dead_tuples->offsets + dead_tuples->num_tuples, deadoffsets,
+			   lpdead_items * sizeof(OffsetNumber));
+		dead_tuples->num_tuples += lpdead_items;
 
-		Assert(dead_tuples->num_tuples <= dead_tuples->max_tuples);
 		pgstat_progress_update_param(PROGRESS_VACUUM_NUM_DEAD_TUPLES,
 									 dead_tuples->num_tuples);
 	}
@@ -2064,7 +2146,7 @@ lazy_vacuum(LVRelState *vacrel, bool onecall)
 	if (!vacrel->do_index_vacuuming)
 	{
 		Assert(!vacrel->do_index_cleanup);
-		vacrel->dead_tuples->num_tuples = 0;
+		DeadTuplesReset(vacrel->dead_tuples);
 		return;
 	}
 
@@ -2122,7 +2204,8 @@ lazy_vacuum(LVRelState *vacrel, bool onecall)
 		threshold = (double) vacrel->rel_pages * BYPASS_THRESHOLD_PAGES;
 		do_bypass_optimization =
 			(vacrel->lpdead_item_pages < threshold &&
-			 vacrel->lpdead_items < MAXDEADTUPLES(32L * 1024L * 1024L));
+			 vacrel->lpdead_items <
+			 (32L * 1024L * 1024L) / sizeof(ItemPointerData));
 	}
 
 	if (do_bypass_optimization)
@@ -2172,7 +2255,7 @@ lazy_vacuum(LVRelState *vacrel, bool onecall)
 	 * Forget the LP_DEAD items that we just vacuumed (or just decided to not
 	 * vacuum)
 	 */
-	vacrel->dead_tuples->num_tuples = 0;
+	DeadTuplesReset(vacrel->dead_tuples);
 }
 
 /*
@@ -2283,11 +2366,16 @@ lazy_vacuum_all_indexes(LVRelState *vacrel)
 static void
 lazy_vacuum_heap_rel(LVRelState *vacrel)
 {
-	int			tupindex;
+	LVDeadTuples *dead_tuples = vacrel->dead_tuples;
+	int			blkindex;
 	BlockNumber	vacuumed_pages;
 	PGRUsage	ru0;
 	Buffer		vmbuffer = InvalidBuffer;
 	LVSavedErrInfo saved_err_info;
+#ifdef USE_PREFETCH
+	int			prefetch_blkindex = 0;
+	int			prefetch_target;
+#endif
 
 	Assert(vacrel->do_index_vacuuming);
 	Assert(vacrel->do_index_cleanup);
@@ -2305,8 +2393,13 @@ lazy_vacuum_heap_rel(LVRelState *vacrel)
 	pg_rusage_init(&ru0);
 	vacuumed_pages = 0;
 
-	tupindex = 0;
-	while (tupindex < vacrel->dead_tuples->num_tuples)
+#ifdef USE_PREFETCH
+	prefetch_target =
+		get_tablespace_maintenance_io_concurrency(vacrel->rel->rd_rel->reltablespace);
+#endif
+
+	blkindex = 0;
+	while (blkindex < dead_tuples->num_blocks)
 	{
 		BlockNumber tblk;
 		Buffer		buf;
@@ -2315,12 +2408,28 @@ lazy_vacuum_heap_rel(LVRelState *vacrel)
 
 		vacuum_delay_point();
 
-		tblk = ItemPointerGetBlockNumber(&vacrel->dead_tuples->itemptrs[tupindex]);
+#ifdef USE_PREFETCH
+
+		/*
+		 * The pages we visit here are scattered over the heap, so issue
+		 * prefetch requests for the next several of them ahead of reading
+		 * them.
+		 */
+		while (prefetch_blkindex < dead_tuples->num_blocks &&
+			   prefetch_blkindex < blkindex + prefetch_target)
+		{
+			PrefetchBuffer(vacrel->rel, MAIN_FORKNUM,
+						   DeadTuplesBlock(dead_tuples, prefetch_blkindex)->blkno);
+			prefetch_blkindex++;
+		}
+#endif							/* USE_PREFETCH */
+
+		tblk = DeadTuplesBlock(dead_tuples, blkindex)->blkno;
 		vacrel->blkno = tblk;
 		buf = ReadBufferExtended(vacrel->rel, MAIN_FORKNUM, tblk, RBM_NORMAL,
 								 vacrel->bstrategy);
 		LockBuffer(buf, BUFFER_LOCK_EXCLUSIVE);
-		tupindex = lazy_vacuum_heap_page(vacrel, tblk, buf, tupindex,
+		blkindex = lazy_vacuum_heap_page(vacrel, tblk, buf, blkindex,
 										 &vmbuffer);
 
 		/* Now that we've vacuumed the page, record its available space */
@@ -2346,12 +2455,12 @@ lazy_vacuum_heap_rel(LVRelState *vacrel)
 	 * the second heap pass.  No more, no less.
 	 */
 	Assert(vacrel->num_index_scans > 1 ||
-		   (tupindex == vacrel->lpdead_items &&
+		   (dead_tuples->num_tuples == vacrel->lpdead_items &&
 			vacuumed_pages == vacrel->lpdead_item_pages));
 
 	ereport(elevel,
 			(errmsg("\"%s\": removed %d dead item identifiers in %u pages",
-					vacrel->relname, tupindex, vacuumed_pages),
+					vacrel->relname, dead_tuples->num_tuples, vacuumed_pages),
 			 errdetail_internal("%s", pg_rusage_show(&ru0))));
 
 	/* Revert to the previous phase information for error traceback */
@@ -2365,9 +2474,8 @@ lazy_vacuum_heap_rel(LVRelState *vacrel)
  * Caller must have an exclusive buffer lock on the buffer (though a
  * super-exclusive lock is also acceptable).
  *
- * tupindex is the index in vacrel->dead_tuples of the first dead tuple for
- * this page.  We assume the rest follow sequentially.  The return value is
- * the first tupindex after the tuples of this page.
+ * blkindex is the index of this page's entry in vacrel->dead_tuples.  The
+ * return value is the index of the next page's entry.
  *
  * Prior to PostgreSQL 14 there were rare cases where this routine had to set
  * tuples with storage to unused.  These days it is strictly responsible for
@@ -2378,9 +2486,11 @@ lazy_vacuum_heap_rel(LVRelState *vacrel)
  */
 static int
 lazy_vacuum_heap_page(LVRelState *vacrel, BlockNumber blkno, Buffer buffer,
-					  int tupindex, Buffer *vmbuffer)
+					  int blkindex, Buffer *vmbuffer)
 {
 	LVDeadTuples *dead_tuples = vacrel->dead_tuples;
+	LVDeadBlock *dblk = DeadTuplesBlock(dead_tuples, blkindex);
+	int			ndead = DeadTuplesBlockCount(dead_tuples, blkindex);
 	Page		page = BufferGetPage(buffer);
 	OffsetNumber unused[MaxHeapTuplesPerPage];
 	int			uncnt = 0;
@@ -2397,18 +2507,16 @@ lazy_vacuum_heap_page(LVRelState *vacrel, BlockNumber blkno, Buffer buffer,
 							 VACUUM_ERRCB_PHASE_VACUUM_HEAP, blkno,
 							 InvalidOffsetNumber);
 
+	Assert(dblk->blkno == blkno);
+
 	START_CRIT_SECTION();
 
-	for (; tupindex < dead_tuples->num_tuples; tupindex++)
+	for (int i = 0; i < ndead; i++)
 	{
-		BlockNumber tblk;
 		OffsetNumber toff;
 		ItemId		itemid;
 
-		tblk = ItemPointerGetBlockNumber(&dead_tuples->itemptrs[tupindex]);
-		if (tblk != blkno)
-			break;				/* past end of tuples for this block */
-		toff = ItemPointerGetOffsetNumber(&dead_tuples->itemptrs[tupindex]);
+		toff = dead_tuples->offsets[dblk->first + i];
 		itemid = PageGetItemId(page, toff);
 
 		Assert(ItemIdIsDead(itemid) && !ItemIdHasStorage(itemid));
@@ -2488,7 +2596,7 @@ lazy_vacuum_heap_page(LVRelState *vacrel, BlockNumber blkno, Buffer buffer,
 
 	/* Revert to the previous phase information for error traceback */
 	restore_vacuum_error_info(vacrel, &saved_err_info);
-	return tupindex;
+	return blkindex + 1;
 }
 
 /*
@@ -3429,7 +3537,7 @@ count_nondeletable_pages(LVRelState *vacrel)
 }
 
 /*
- * Return the maximum number of dead tuples we can record.
+ * Return the number of slots to allocate for recording dead tuples.
  */
 static long
 compute_max_dead_tuples(BlockNumber relblocks, bool hasindex)
@@ -3446,14 +3554,17 @@ compute_max_dead_tuples(BlockNumber relblocks, bool hasindex)
 		maxtuples = Min(maxtuples, MAXDEADTUPLES(MaxAllocSize));
 
 		/* curious coding here to ensure the multiplication can't overflow */
-		if ((BlockNumber) (maxtuples / LAZY_ALLOC_TUPLES) > relblocks)
-			maxtuples = relblocks * LAZY_ALLOC_TUPLES;
+		if ((BlockNumber) (maxtuples / (LAZY_ALLOC_TUPLES + DEADBLOCK_SLOTS)) > relblocks)
+			maxtuples = relblocks * (LAZY_ALLOC_TUPLES + DEADBLOCK_SLOTS);
 
 		/* stay sane if small maintenance_work_mem */
-		maxtuples = Max(maxtuples, MaxHeapTuplesPerPage);
+		maxtuples = Max(maxtuples, DEADTUPLES_PAGE_SLOTS);
 	}
 	else
-		maxtuples = MaxHeapTuplesPerPage;
+		maxtuples = DEADTUPLES_PAGE_SLOTS;
+
+	/* LVDeadBlock entries are allocated from the end of the slot array */
+	maxtuples = TYPEALIGN(DEADBLOCK_SLOTS, maxtuples);
 
 	return maxtuples;
 }
@@ -3502,8 +3613,8 @@ lazy_space_alloc(LVRelState *vacrel, int nworkers, BlockNumber nblocks)
 	maxtuples = compute_max_dead_tuples(nblocks, vacrel->nindexes > 0);
 
 	dead_tuples = (LVDeadTuples *) palloc(SizeOfDeadTuples(maxtuples));
-	dead_tuples->num_tuples = 0;
 	dead_tuples->max_tuples = (int) maxtuples;
+	DeadTuplesReset(dead_tuples);
 
 	vacrel->dead_tuples = dead_tuples;
 }
@@ -3535,61 +3646,63 @@ static bool
 lazy_tid_reaped(ItemPointer itemptr, void *state)
 {
 	LVDeadTuples *dead_tuples = (LVDeadTuples *) state;
-	int64		litem,
-				ritem,
-				item;
-	ItemPointer res;
+	BlockNumber blkno = ItemPointerGetBlockNumber(itemptr);
+	OffsetNumber offnum = ItemPointerGetOffsetNumber(itemptr);
+	LVDeadBlock *dblk;
+	int			lo,
+				hi;
 
-	litem = itemptr_encode(&dead_tuples->itemptrs[0]);
-	ritem = itemptr_encode(&dead_tuples->itemptrs[dead_tuples->num_tuples - 1]);
-	item = itemptr_encode(itemptr);
+	if (dead_tuples->num_blocks == 0)
+		return false;
 
 	/*
-	 * Doing a simple bound check before bsearch() is useful to avoid the
-	 * extra cost of bsearch(), especially if dead tuples on the heap are
-	 * concentrated in a certain range.  Since this function is called for
-	 * every index tuple, it pays to be really fast.
+	 * Doing a simple bound check before the binary search is useful to avoid
+	 * its extra cost, especially if dead tuples on the heap are concentrated
+	 * in a certain range.  Since this function is called for every index
+	 * tuple, it pays to be really fast.
 	 */
-	if (item < litem || item > ritem)
+	if (blkno < DeadTuplesBlock(dead_tuples, 0)->blkno ||
+		blkno > DeadTuplesBlock(dead_tuples, dead_tuples->num_blocks - 1)->blkno)
 		return false;
 
-	res = (ItemPointer) bsearch((void *) itemptr,
-								(void *) dead_tuples->itemptrs,
-								dead_tuples->num_tuples,
-								sizeof(ItemPointerData),
-								vac_cmp_itemptr);
-
-	return (res != NULL);
-}
-
-/*
- * Comparator routines for use with qsort() and bsearch().
- */
-static int
-vac_cmp_itemptr(const void *left, const void *right)
-{
-	BlockNumber lblk,
-				rblk;
-	OffsetNumber loff,
-				roff;
-
-	lblk = ItemPointerGetBlockNumber((ItemPointer) left);
-	rblk = ItemPointerGetBlockNumber((ItemPointer) right);
+	/* Find the heap page's entry, if any */
+	lo = 0;
+	hi = dead_tuples->num_blocks - 1;
+	for (;;)
+	{
+		int			mid;
 
-	if (lblk < rblk)
-		return -1;
-	if (lblk > rblk)
-		return 1;
+		if (lo > hi)
+			return false;
+		mid = lo + (hi - lo) / 2;
+		dblk = DeadTuplesBlock(dead_tuples, mid);
+		if (dblk->blkno == blkno)
+		{
+			lo = dblk->first;
+			hi = lo + DeadTuplesBlockCount(dead_tuples, mid) - 1;
+			break;
+		}
+		if (dblk->blkno < blkno)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
 
-	loff = ItemPointerGetOffsetNumber((ItemPointer) left);
-	roff = ItemPointerGetOffsetNumber((ItemPointer) right);
+	/* Then look for the offset number among that page's dead tuples */
+	while (lo <= hi)
+	{
+		int			mid = lo + (hi - lo) / 2;
+		OffsetNumber moff = dead_tuples->offsets[mid];
 
-	if (loff < roff)
-		return -1;
-	if (loff > roff)
-		return 1;
+		if (moff == offnum)
+			return true;
+		if (moff < offnum)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
 
-	return 0;
+	return false;
 }
 
 /*
@@ -3975,8 +4088,8 @@ begin_parallel_vacuum(LVRelState *vacrel, BlockNumber nblocks,
 	/* Prepare the dead tuple space */
 	dead_tuples = (LVDeadTuples *) shm_toc_allocate(pcxt->toc, est_deadtuples);
 	dead_tuples->max_tuples = maxtuples;
-	dead_tuples->num_tuples = 0;
-	MemSet(dead_tuples->itemptrs, 0, sizeof(ItemPointerData) * maxtuples);
+	DeadTuplesReset(dead_tuples);
+	MemSet(dead_tuples->offsets, 0, sizeof(OffsetNumber) * maxtuples);
 	shm_toc_insert(pcxt->toc, PARALLEL_VACUUM_KEY_DEAD_TUPLES, dead_tuples);
 	vacrel->dead_tuples = dead_tuples;
 
@@ -36,6 +36,7 @@
 #include "utils/builtins.h"
 #include "utils/index_selfuncs.h"
 #include "utils/memutils.h"
+#include "utils/spccache.h"
 
 
 /*
@@ -77,6 +78,7 @@ typedef struct BTParallelScanDescData
 typedef struct BTParallelScanDescData *BTParallelScanDesc;
 
 
+static void _bt_prefetch_heap(IndexScanDesc scan, ScanDirection dir);
 static void btvacuumscan(IndexVacuumInfo *info, IndexBulkDeleteResult *stats,
 						 IndexBulkDeleteCallback callback, void *callback_state,
 						 BTCycleId cycleid);
@@ -203,6 +205,71 @@ btinsert(Relation rel, Datum *values, bool *isnull,
 	return result;
 }
 
+/*
+ * _bt_prefetch_heap() -- Prefetch heap blocks of upcoming currPos items.
+ *
+ * Called after btgettuple has positioned the scan on a matching item.  The
+ * heap blocks of the next prefetchTarget items on the current index page,
+ * in scan direction, are handed to PrefetchBuffer so that the heap fetches
+ * the caller will make for them don't each wait for a synchronous read.
+ * The item just returned is not prefetched, since the caller is about to
+ * read it anyway; this also keeps single-match lookups free of overhead.
+ * Adjacent items pointing at the same heap block are prefetched once.
+ */
+static void
+_bt_prefetch_heap(IndexScanDesc scan, ScanDirection dir)
+{
+#ifdef USE_PREFETCH
+	BTScanOpaque so = (BTScanOpaque) scan->opaque;
+	BTScanPos	pos = &so->currPos;
+
+	if (pos->currPage != so->prefetchPage || dir != so->prefetchDir)
+	{
+		so->prefetchPage = pos->currPage;
+		so->prefetchDir = dir;
+		so->prefetchIndex = pos->itemIndex;
+		so->prefetchBlock = InvalidBlockNumber;
+	}
+
+	if (ScanDirectionIsForward(dir))
+	{
+		int			limit = Min(pos->itemIndex + so->prefetchTarget,
+								pos->lastItem);
+
+		so->prefetchIndex = Max(so->prefetchIndex, pos->itemIndex + 1);
+		for (; so->prefetchIndex <= limit; so->prefetchIndex++)
+		{
+			BlockNumber blkno;
+
+			blkno = ItemPointerGetBlockNumber(&pos->items[so->prefetchIndex].heapTid);
+			if (blkno != so->prefetchBlock)
+			{
+				PrefetchBuffer(scan->heapRelation, MAIN_FORKNUM, blkno);
+				so->prefetchBlock = blkno;
+			}
+		}
+	}
+	else
+	{
+		int			limit = Max(pos->itemIndex - so->prefetchTarget,
+								pos->firstItem);
+
+		so->prefetchIndex = Min(so->prefetchIndex, pos->itemIndex - 1);
+		for (; so->prefetchIndex >= limit; so->prefetchIndex--)
+		{
+			BlockNumber blkno;
+
+			blkno = ItemPointerGetBlockNumber(&pos->items[so->prefetchIndex].heapTid);
+			if (blkno != so->prefetchBlock)
+			{
+				PrefetchBuffer(scan->heapRelation, MAIN_FORKNUM, blkno);
+				so->prefetchBlock = blkno;
+			}
+		}
+	}
+#endif							/* USE_PREFETCH */
+}
+
 /*
  *	btgettuple() -- Get the next tuple in the scan.
  */
@@ -270,7 +337,11 @@ btgettuple(IndexScanDesc scan, ScanDirection dir)
 
 		/* If we have a tuple, return it ... */
 		if (res)
+		{
+			if (so->prefetchTarget > 0)
+				_bt_prefetch_heap(scan, dir);
 			break;
+		}
 		/* ... otherwise see if we have more array keys to deal with */
 	} while (so->numArrayKeys && _bt_advance_array_keys(scan, dir));
 
@@ -354,6 +425,8 @@ btbeginscan(Relation rel, int nkeys, int norderbys)
 	so = (BTScanOpaque) palloc(sizeof(BTScanOpaqueData));
 	BTScanPosInvalidate(so->currPos);
 	BTScanPosInvalidate(so->markPos);
+	so->prefetchTarget = 0;
+	so->prefetchPage = InvalidBlockNumber;
 	if (scan->numberOfKeys > 0)
 		so->keyData = (ScanKey) palloc(scan->numberOfKeys * sizeof(ScanKeyData));
 	else
@@ -405,6 +478,19 @@ btrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 	BTScanPosUnpinIfPinned(so->markPos);
 	BTScanPosInvalidate(so->markPos);
 
+	/*
+	 * Prefetch heap blocks only for plain index scans; an index-only scan
+	 * usually never visits the heap at all.  The caller has set
+	 * heapRelation and xs_want_itup by now.
+	 */
+	so->prefetchTarget = 0;
+#ifdef USE_PREFETCH
+	if (scan->heapRelation != NULL && !scan->xs_want_itup)
+		so->prefetchTarget =
+			get_tablespace_io_concurrency(scan->heapRelation->rd_rel->reltablespace);
+#endif
+	so->prefetchPage = InvalidBlockNumber;
+
 	/*
 	 * Allocate tuple workspace arrays, if needed for an index-only scan and
 	 * not already done in a previous rescan call.  To save on palloc
@@ -20,8 +20,10 @@
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/predicate.h"
+#include "utils/fmgrprotos.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
+#include "utils/uuid.h"
 
 
 static void _bt_drop_lock_and_maybe_pin(IndexScanDesc scan, BTScanPos sp);
@@ -613,6 +615,43 @@ _bt_binsrch_posting(BTScanInsert key, Page page, OffsetNumber offnum)
 	return low;
 }
 
+/*
+ * _bt_compare_datum() -- call a scankey's ORDER proc on an index datum.
+ *
+ * _bt_compare() runs for every probe of a binary search, so for the most
+ * common key types we inline the comparison rather than going through the
+ * fmgr.  The results are exactly what the support function would return.
+ */
+static inline int32
+_bt_compare_datum(ScanKey scankey, Datum datum)
+{
+	PGFunction	cmpfn = scankey->sk_func.fn_addr;
+
+	if (cmpfn == btint4cmp)
+	{
+		int32		a = DatumGetInt32(datum);
+		int32		b = DatumGetInt32(scankey->sk_argument);
+
+		return (a > b) ? 1 : ((a == b) ? 0 : -1);
+	}
+	if (cmpfn == btint8cmp)
+	{
+		int64		a = DatumGetInt64(datum);
+		int64		b = DatumGetInt64(scankey->sk_argument);
+
+		return (a > b) ? 1 : ((a == b) ? 0 : -1);
+	}
+	if (cmpfn == uuid_cmp)
+		return memcmp(DatumGetUUIDP(datum)->data,
+					  DatumGetUUIDP(scankey->sk_argument)->data,
+					  UUID_LEN);
+
+	return DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
+										   scankey->sk_collation,
+										   datum,
+										   scankey->sk_argument));
+}
+
 /*----------
  *	_bt_compare() -- Compare insertion-type scankey to tuple on a page.
  *
@@ -718,10 +757,7 @@ _bt_compare(Relation rel,
 			 * to flip the sign of the comparison result.  (Unless it's a DESC
 			 * column, in which case we *don't* flip the sign.)
 			 */
-			result = DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
-													 scankey->sk_collation,
-													 datum,
-													 scankey->sk_argument));
+			result = _bt_compare_datum(scankey, datum);
 
 			if (!(scankey->sk_flags & SK_BT_DESC))
 				INVERT_COMPARE_RESULT(result);
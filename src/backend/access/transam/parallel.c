@@ -34,6 +34,7 @@
 #include "pgstat.h"
 #include "storage/ipc.h"
 #include "storage/predicate.h"
+#include "storage/shmem.h"
 #include "storage/sinval.h"
 #include "storage/spin.h"
 #include "tcop/tcopprot.h"
@@ -43,6 +44,7 @@
 #include "utils/memutils.h"
 #include "utils/relmapper.h"
 #include "utils/snapmgr.h"
+#include "utils/timestamp.h"
 #include "utils/typcache.h"
 
 /*
@@ -57,6 +59,13 @@
 /* Magic number for parallel context TOC. */
 #define PARALLEL_MAGIC						0x50477c7c
 
+/*
+ * How often (in ms) to check whether a worker we got from the pool has
+ * exited.  The postmaster only tells the backend that registered a worker
+ * about that.
+ */
+#define PARALLEL_POOL_POLL_INTERVAL			10
+
 /*
  * Magic numbers for per-context parallel state sharing.  Higher-level code
  * should use smaller values, leaving these very large ones for use by this
@@ -76,6 +85,7 @@
 #define PARALLEL_KEY_REINDEX_STATE			UINT64CONST(0xFFFFFFFFFFFF000C)
 #define PARALLEL_KEY_RELMAPPER_STATE		UINT64CONST(0xFFFFFFFFFFFF000D)
 #define PARALLEL_KEY_UNCOMMITTEDENUMS		UINT64CONST(0xFFFFFFFFFFFF000E)
+#define PARALLEL_KEY_POOL_STATE				UINT64CONST(0xFFFFFFFFFFFF000F)
 
 /* Fixed-size parallel state. */
 typedef struct FixedParallelState
@@ -103,6 +113,67 @@ typedef struct FixedParallelState
 	XLogRecPtr	last_xlog_end;
 } FixedParallelState;
 
+/*
+ * Whether each worker has gone back to the worker pool.  An array of these,
+ * one per worker, lives under PARALLEL_KEY_POOL_STATE; it is protected by
+ * the mutex in FixedParallelState.
+ */
+typedef enum ParallelWorkerPoolState
+{
+	PARALLEL_WORKER_RUNNING,	/* not finished yet, or exiting */
+	PARALLEL_WORKER_RELEASED,	/* done with us, and back in the pool */
+	PARALLEL_WORKER_TERMINATED	/* killed by the leader, mustn't be pooled */
+} ParallelWorkerPoolState;
+
+/*
+ * Parallel workers that have run a parallel query can stay around for
+ * parallel_worker_idle_timeout afterwards, in case another leader connected
+ * to the same database as the same user needs workers.  Handing the work to
+ * such a worker saves forking a new process and connecting it to the
+ * database.  A pooled worker has a slot here from the time it first goes
+ * idle until it exits.  Slots are protected by ParallelWorkerPoolLock.
+ *
+ * Idle workers still count against max_worker_processes and
+ * max_parallel_workers, so a leader that can't register new workers asks
+ * idle workers it can't use to leave early, rather than leaving other
+ * databases short of workers until parallel_worker_idle_timeout runs out.
+ *
+ * Libraries can't be unloaded, and may have installed hooks, so an idle
+ * worker only serves a leader that has loaded exactly the same libraries.
+ * It advertises its own list in the slot, in the format produced by
+ * SerializeLibraryState(); a worker whose list doesn't fit exits instead.
+ */
+#define PARALLEL_POOL_LIBRARY_SPACE		(2 * MAXPGPATH)
+
+typedef struct ParallelWorkerPoolSlot
+{
+	pid_t		pid;			/* 0 if the slot is free */
+	PGPROC	   *proc;
+	Oid			database_id;
+	Oid			authenticated_user_id;
+	bool		idle;			/* waiting for a leader? */
+	bool		evict;			/* if idle, should we exit instead? */
+	PGPROC	   *leader;			/* if not idle, the leader we serve, */
+	dsm_handle	seg_handle;		/* its segment, */
+	int			worker_number;	/* and our worker number */
+	/* if idle, the libraries we have loaded */
+	char		libraries[PARALLEL_POOL_LIBRARY_SPACE];
+} ParallelWorkerPoolSlot;
+
+typedef struct ParallelWorkerPoolData
+{
+	int			nslots;
+	ParallelWorkerPoolSlot slots[FLEXIBLE_ARRAY_MEMBER];
+} ParallelWorkerPoolData;
+
+static ParallelWorkerPoolData *ParallelWorkerPool = NULL;
+
+/* Our slot in the pool, if we are a pooled parallel worker. */
+static ParallelWorkerPoolSlot *MyPoolSlot = NULL;
+
+/* GUC variable */
+int			parallel_worker_idle_timeout = 0;
+
 /*
  * Our parallel worker number.  We initialize this to -1, meaning that we are
  * not a parallel worker.  In parallel workers, it will be set to a value >= 0
@@ -151,8 +222,18 @@ static const struct
 /* Private functions. */
 static void HandleParallelMessage(ParallelContext *pcxt, int i, StringInfo msg);
 static void WaitForParallelWorkersToExit(ParallelContext *pcxt);
+static BgwHandleStatus WaitForParallelWorkerShutdown(ParallelContext *pcxt, int i);
+static ParallelWorkerPoolState GetParallelWorkerPoolState(ParallelContext *pcxt,
+														  int i, bool terminate);
+static bool ParallelWorkerPoolAssign(ParallelContext *pcxt, int i);
+static void ParallelWorkerPoolEvict(int nworkers);
+static bool ParallelWorkerServe(dsm_handle handle, int worker_number);
+static bool ParallelWorkerRelease(dsm_segment *seg, shm_toc *toc,
+								  MemoryContext task_context);
+static bool ParallelWorkerPoolWait(dsm_handle *handle, int *worker_number);
 static parallel_worker_main_type LookupParallelWorkerFunction(const char *libraryname, const char *funcname);
 static void ParallelWorkerShutdown(int code, Datum arg);
+static void ParallelWorkerPoolExit(int code, Datum arg);
 
 
 /*
@@ -269,8 +350,11 @@ InitializeParallelDSM(ParallelContext *pcxt)
 		shm_toc_estimate_chunk(&pcxt->estimator, relmapperlen);
 		uncommittedenumslen = EstimateUncommittedEnumsSpace();
 		shm_toc_estimate_chunk(&pcxt->estimator, uncommittedenumslen);
+		shm_toc_estimate_chunk(&pcxt->estimator,
+							   mul_size(sizeof(ParallelWorkerPoolState),
+										pcxt->nworkers));
 		/* If you add more chunks here, you probably need to add keys. */
-		shm_toc_estimate_keys(&pcxt->estimator, 11);
+		shm_toc_estimate_keys(&pcxt->estimator, 12);
 
 		/* Estimate space need for error queues. */
 		StaticAssertStmt(BUFFERALIGN(PARALLEL_ERROR_QUEUE_SIZE) ==
@@ -349,6 +433,7 @@ InitializeParallelDSM(ParallelContext *pcxt)
 		char	   *session_dsm_handle_space;
 		char	   *entrypointstate;
 		char	   *uncommittedenumsspace;
+		ParallelWorkerPoolState *poolstate;
 		Size		lnamelen;
 
 		/* Serialize shared libraries we have loaded. */
@@ -411,6 +496,14 @@ InitializeParallelDSM(ParallelContext *pcxt)
 		shm_toc_insert(pcxt->toc, PARALLEL_KEY_UNCOMMITTEDENUMS,
 					   uncommittedenumsspace);
 
+		/* No worker has gone back to the pool yet. */
+		poolstate = shm_toc_allocate(pcxt->toc,
+									 mul_size(sizeof(ParallelWorkerPoolState),
+											  pcxt->nworkers));
+		for (i = 0; i < pcxt->nworkers; ++i)
+			poolstate[i] = PARALLEL_WORKER_RUNNING;
+		shm_toc_insert(pcxt->toc, PARALLEL_KEY_POOL_STATE, poolstate);
+
 		/* Allocate space for worker information. */
 		pcxt->worker = palloc0(sizeof(ParallelWorkerInfo) * pcxt->nworkers);
 
@@ -483,14 +576,16 @@ ReinitializeParallelDSM(ParallelContext *pcxt)
 	fps = shm_toc_lookup(pcxt->toc, PARALLEL_KEY_FIXED, false);
 	fps->last_xlog_end = 0;
 
-	/* Recreate error queues (if they exist). */
+	/* Recreate error queues and pool state (if they exist). */
 	if (pcxt->nworkers > 0)
 	{
 		char	   *error_queue_space;
+		ParallelWorkerPoolState *poolstate;
 		int			i;
 
 		error_queue_space =
 			shm_toc_lookup(pcxt->toc, PARALLEL_KEY_ERROR_QUEUE, false);
+		poolstate = shm_toc_lookup(pcxt->toc, PARALLEL_KEY_POOL_STATE, false);
 		for (i = 0; i < pcxt->nworkers; ++i)
 		{
 			char	   *start;
@@ -500,6 +595,7 @@ ReinitializeParallelDSM(ParallelContext *pcxt)
 			mq = shm_mq_create(start, PARALLEL_ERROR_QUEUE_SIZE);
 			shm_mq_set_receiver(mq, MyProc);
 			pcxt->worker[i].error_mqh = shm_mq_attach(mq, pcxt->seg, NULL);
+			poolstate[i] = PARALLEL_WORKER_RUNNING;
 		}
 	}
 }
@@ -561,7 +657,7 @@ LaunchParallelWorkers(ParallelContext *pcxt)
 	worker.bgw_notify_pid = MyProcPid;
 
 	/*
-	 * Start workers.
+	 * Start workers, preferring idle ones from the pool to new ones.
 	 *
 	 * The caller must be able to tolerate ending up with fewer workers than
 	 * expected, so there is no need to throw an error here if registration
@@ -571,9 +667,11 @@ LaunchParallelWorkers(ParallelContext *pcxt)
 	for (i = 0; i < pcxt->nworkers_to_launch; ++i)
 	{
 		memcpy(worker.bgw_extra, &i, sizeof(int));
-		if (!any_registrations_failed &&
-			RegisterDynamicBackgroundWorker(&worker,
-											&pcxt->worker[i].bgwhandle))
+		pcxt->worker[i].from_pool = false;
+		if (ParallelWorkerPoolAssign(pcxt, i) ||
+			(!any_registrations_failed &&
+			 RegisterDynamicBackgroundWorker(&worker,
+											 &pcxt->worker[i].bgwhandle)))
 		{
 			shm_mq_set_handle(pcxt->worker[i].error_mqh,
 							  pcxt->worker[i].bgwhandle);
@@ -590,6 +688,8 @@ LaunchParallelWorkers(ParallelContext *pcxt)
 			 * for those workers.  Otherwise, we'll wait for them to start,
 			 * but they never will.
 			 */
+			if (!any_registrations_failed)
+				ParallelWorkerPoolEvict(pcxt->nworkers_to_launch - i);
 			any_registrations_failed = true;
 			pcxt->worker[i].bgwhandle = NULL;
 			shm_mq_detach(pcxt->worker[i].error_mqh);
@@ -753,6 +853,7 @@ WaitForParallelWorkersToFinish(ParallelContext *pcxt)
 	for (;;)
 	{
 		bool		anyone_alive = false;
+		bool		poll = false;
 		int			nfinished = 0;
 		int			i;
 
@@ -800,16 +901,24 @@ WaitForParallelWorkersToFinish(ParallelContext *pcxt)
 				pid_t		pid;
 				shm_mq	   *mq;
 
+				if (pcxt->worker[i].error_mqh == NULL ||
+					pcxt->worker[i].bgwhandle == NULL)
+					continue;
+
 				/*
 				 * If the worker is BGWH_NOT_YET_STARTED or BGWH_STARTED, we
-				 * should just keep waiting.  If it is BGWH_STOPPED, then
-				 * further investigation is needed.
+				 * should just keep waiting; but we won't be notified if a
+				 * worker from the pool exits, so we have to poll for that.
+				 * If it is BGWH_STOPPED, then further investigation is
+				 * needed.
 				 */
-				if (pcxt->worker[i].error_mqh == NULL ||
-					pcxt->worker[i].bgwhandle == NULL ||
-					GetBackgroundWorkerPid(pcxt->worker[i].bgwhandle,
+				if (GetBackgroundWorkerPid(pcxt->worker[i].bgwhandle,
 										   &pid) != BGWH_STOPPED)
+				{
+					if (pcxt->worker[i].from_pool)
+						poll = true;
 					continue;
+				}
 
 				/*
 				 * Check whether the worker ended up stopped without ever
@@ -838,7 +947,10 @@ WaitForParallelWorkersToFinish(ParallelContext *pcxt)
 			}
 		}
 
-		(void) WaitLatch(MyLatch, WL_LATCH_SET | WL_EXIT_ON_PM_DEATH, -1,
+		(void) WaitLatch(MyLatch,
+						 WL_LATCH_SET | WL_EXIT_ON_PM_DEATH |
+						 (poll ? WL_TIMEOUT : 0),
+						 PARALLEL_POOL_POLL_INTERVAL,
 						 WAIT_EVENT_PARALLEL_FINISH);
 		ResetLatch(MyLatch);
 	}
@@ -854,12 +966,19 @@ WaitForParallelWorkersToFinish(ParallelContext *pcxt)
 }
 
 /*
- * Wait for all workers to exit.
+ * Wait for all workers to exit, or go back to the pool.
+ *
+ * This function ensures that workers have been completely shutdown, or are
+ * at least done with everything they did for us, including being members of
+ * our lock group.  The difference between WaitForParallelWorkersToFinish and
+ * this function is that the former just ensures that last message sent by a
+ * worker backend is received by the leader backend whereas this ensures the
+ * complete shutdown.
  *
- * This function ensures that workers have been completely shutdown.  The
- * difference between WaitForParallelWorkersToFinish and this function is
- * that the former just ensures that last message sent by a worker backend is
- * received by the leader backend whereas this ensures the complete shutdown.
+ * We can only tell that a worker went back to the pool while still attached
+ * to the DSM segment.  Workers we have killed can't go back to the pool, and
+ * they might need us to detach first, so while attached we skip them; they
+ * must be waited for again after detaching.
  */
 static void
 WaitForParallelWorkersToExit(ParallelContext *pcxt)
@@ -874,7 +993,11 @@ WaitForParallelWorkersToExit(ParallelContext *pcxt)
 		if (pcxt->worker == NULL || pcxt->worker[i].bgwhandle == NULL)
 			continue;
 
-		status = WaitForBackgroundWorkerShutdown(pcxt->worker[i].bgwhandle);
+		if (pcxt->seg != NULL &&
+			GetParallelWorkerPoolState(pcxt, i, false) == PARALLEL_WORKER_TERMINATED)
+			continue;
+
+		status = WaitForParallelWorkerShutdown(pcxt, i);
 
 		/*
 		 * If the postmaster kicked the bucket, we have no chance of cleaning
@@ -893,6 +1016,227 @@ WaitForParallelWorkersToExit(ParallelContext *pcxt)
 	}
 }
 
+/*
+ * Wait for worker i to exit or, while we're attached to the DSM segment, to
+ * go back to the pool.
+ */
+static BgwHandleStatus
+WaitForParallelWorkerShutdown(ParallelContext *pcxt, int i)
+{
+	BgwHandleStatus status;
+
+	/* For workers we registered, the postmaster tells us when they exit. */
+	if (pcxt->seg == NULL && !pcxt->worker[i].from_pool)
+		return WaitForBackgroundWorkerShutdown(pcxt->worker[i].bgwhandle);
+
+	for (;;)
+	{
+		pid_t		pid;
+		int			rc;
+
+		status = GetBackgroundWorkerPid(pcxt->worker[i].bgwhandle, &pid);
+		if (status == BGWH_STOPPED)
+			break;
+
+		if (pcxt->seg != NULL &&
+			GetParallelWorkerPoolState(pcxt, i, false) == PARALLEL_WORKER_RELEASED)
+		{
+			status = BGWH_STOPPED;
+			break;
+		}
+
+		rc = WaitLatch(MyLatch,
+					   WL_LATCH_SET | WL_POSTMASTER_DEATH |
+					   (pcxt->worker[i].from_pool ? WL_TIMEOUT : 0),
+					   PARALLEL_POOL_POLL_INTERVAL,
+					   WAIT_EVENT_BGWORKER_SHUTDOWN);
+
+		if (rc & WL_POSTMASTER_DEATH)
+		{
+			status = BGWH_POSTMASTER_DIED;
+			break;
+		}
+
+		ResetLatch(MyLatch);
+	}
+
+	return status;
+}
+
+/*
+ * Check whether worker i has gone back to the pool.  If 'terminate' is true
+ * and it hasn't, make sure it won't, because we're about to kill it.
+ */
+static ParallelWorkerPoolState
+GetParallelWorkerPoolState(ParallelContext *pcxt, int i, bool terminate)
+{
+	FixedParallelState *fps;
+	ParallelWorkerPoolState *poolstate;
+	ParallelWorkerPoolState result;
+
+	fps = shm_toc_lookup(pcxt->toc, PARALLEL_KEY_FIXED, false);
+	poolstate = shm_toc_lookup(pcxt->toc, PARALLEL_KEY_POOL_STATE, false);
+
+	SpinLockAcquire(&fps->mutex);
+	if (terminate && poolstate[i] == PARALLEL_WORKER_RUNNING)
+		poolstate[i] = PARALLEL_WORKER_TERMINATED;
+	result = poolstate[i];
+	SpinLockRelease(&fps->mutex);
+
+	return result;
+}
+
+/*
+ * Hand worker number i of a parallel context to an idle worker from the
+ * pool, if there is one for our database and user.  Returns true if we
+ * found one.
+ */
+static bool
+ParallelWorkerPoolAssign(ParallelContext *pcxt, int i)
+{
+	Oid			userid = GetAuthenticatedUserId();
+	bool		found = false;
+	char	   *libraryspace;
+	Size		library_len;
+	int			slotno;
+
+	if (parallel_worker_idle_timeout <= 0)
+		return false;
+
+	/* No pooled worker can have a library list that doesn't fit its slot. */
+	library_len = EstimateLibraryStateSpace();
+	if (library_len > PARALLEL_POOL_LIBRARY_SPACE)
+		return false;
+	libraryspace = shm_toc_lookup(pcxt->toc, PARALLEL_KEY_LIBRARY, false);
+
+	LWLockAcquire(ParallelWorkerPoolLock, LW_EXCLUSIVE);
+
+	for (slotno = 0; slotno < ParallelWorkerPool->nslots; slotno++)
+	{
+		ParallelWorkerPoolSlot *slot = &ParallelWorkerPool->slots[slotno];
+		BackgroundWorkerHandle *handle;
+
+		if (slot->pid == 0 || !slot->idle || slot->evict ||
+			slot->database_id != MyDatabaseId ||
+			slot->authenticated_user_id != userid ||
+			memcmp(slot->libraries, libraryspace, library_len) != 0)
+			continue;
+
+		/* Skip workers that are about to be terminated. */
+		handle = GetBackgroundWorkerHandleByPid(slot->pid);
+		if (handle == NULL)
+			continue;
+
+		slot->idle = false;
+		slot->leader = MyProc;
+		slot->seg_handle = dsm_segment_handle(pcxt->seg);
+		slot->worker_number = i;
+		SetLatch(&slot->proc->procLatch);
+
+		pcxt->worker[i].bgwhandle = handle;
+		pcxt->worker[i].from_pool = true;
+		found = true;
+		break;
+	}
+
+	LWLockRelease(ParallelWorkerPoolLock);
+
+	return found;
+}
+
+/*
+ * Ask up to nworkers idle workers in the pool to exit, to free up their
+ * background worker slots.  We only get here after ParallelWorkerPoolAssign
+ * found nothing suitable, so the idle workers are all for some other
+ * database or user, or have loaded other libraries.  This doesn't help our caller, who must make do with
+ * the workers it has, but the next leader will find the slots free.
+ */
+static void
+ParallelWorkerPoolEvict(int nworkers)
+{
+	int			slotno;
+
+	if (parallel_worker_idle_timeout <= 0)
+		return;
+
+	LWLockAcquire(ParallelWorkerPoolLock, LW_EXCLUSIVE);
+
+	for (slotno = 0; slotno < ParallelWorkerPool->nslots && nworkers > 0;
+		 slotno++)
+	{
+		ParallelWorkerPoolSlot *slot = &ParallelWorkerPool->slots[slotno];
+
+		if (slot->pid == 0 || !slot->idle || slot->evict)
+			continue;
+
+		slot->evict = true;
+		SetLatch(&slot->proc->procLatch);
+		nworkers--;
+	}
+
+	LWLockRelease(ParallelWorkerPoolLock);
+}
+
+/*
+ * Report shared memory space needed by the parallel worker pool.
+ */
+Size
+ParallelWorkerPoolShmemSize(void)
+{
+	return add_size(offsetof(ParallelWorkerPoolData, slots),
+					mul_size(max_worker_processes,
+							 sizeof(ParallelWorkerPoolSlot)));
+}
+
+/*
+ * Allocate and initialize the parallel worker pool.
+ */
+void
+ParallelWorkerPoolShmemInit(void)
+{
+	bool		found;
+
+	ParallelWorkerPool = (ParallelWorkerPoolData *)
+		ShmemInitStruct("Parallel Worker Pool", ParallelWorkerPoolShmemSize(),
+						&found);
+
+	if (!found)
+	{
+		memset(ParallelWorkerPool, 0, ParallelWorkerPoolShmemSize());
+		ParallelWorkerPool->nslots = max_worker_processes;
+	}
+}
+
+/*
+ * Ask idle pooled workers connected to the given database to exit, so that
+ * they don't get in the way of DROP DATABASE and the like.
+ */
+void
+TerminatePooledParallelWorkers(Oid databaseId)
+{
+	pid_t	   *pids;
+	int			npids = 0;
+	int			slotno;
+
+	pids = palloc(sizeof(pid_t) * ParallelWorkerPool->nslots);
+
+	LWLockAcquire(ParallelWorkerPoolLock, LW_SHARED);
+	for (slotno = 0; slotno < ParallelWorkerPool->nslots; slotno++)
+	{
+		ParallelWorkerPoolSlot *slot = &ParallelWorkerPool->slots[slotno];
+
+		if (slot->pid != 0 && slot->idle && slot->database_id == databaseId)
+			pids[npids++] = slot->pid;
+	}
+	LWLockRelease(ParallelWorkerPoolLock);
+
+	/* Don't hold the lock while issuing kill(), as in CountOtherDBBackends */
+	for (slotno = 0; slotno < npids; slotno++)
+		(void) kill(pids[slotno], SIGTERM); /* ignore any error */
+
+	pfree(pids);
+}
+
 /*
  * Destroy a parallel context.
  *
@@ -914,19 +1258,34 @@ DestroyParallelContext(ParallelContext *pcxt)
 	 */
 	dlist_delete(&pcxt->node);
 
-	/* Kill each worker in turn, and forget their error queues. */
+	/*
+	 * Kill each worker in turn, and forget their error queues.  Workers that
+	 * are already back in the pool must be left alone, though; they might be
+	 * serving someone else by now.
+	 */
 	if (pcxt->worker != NULL)
 	{
 		for (i = 0; i < pcxt->nworkers_launched; ++i)
 		{
 			if (pcxt->worker[i].error_mqh != NULL)
 			{
-				TerminateBackgroundWorker(pcxt->worker[i].bgwhandle);
+				if (GetParallelWorkerPoolState(pcxt, i, true) !=
+					PARALLEL_WORKER_RELEASED)
+					TerminateBackgroundWorker(pcxt->worker[i].bgwhandle);
 
 				shm_mq_detach(pcxt->worker[i].error_mqh);
 				pcxt->worker[i].error_mqh = NULL;
 			}
 		}
+
+		/*
+		 * Wait for the workers we didn't kill to exit or go back to the pool.
+		 * This must happen before we detach from the segment, since that's
+		 * where they tell us about the latter.
+		 */
+		HOLD_INTERRUPTS();
+		WaitForParallelWorkersToExit(pcxt);
+		RESUME_INTERRUPTS();
 	}
 
 	/*
@@ -1238,6 +1597,39 @@ AtEOXact_Parallel(bool isCommit)
  */
 void
 ParallelWorkerMain(Datum main_arg)
+{
+	dsm_handle	handle = DatumGetUInt32(main_arg);
+	int			worker_number;
+
+	/* Establish signal handlers. */
+	pqsignal(SIGTERM, die);
+	BackgroundWorkerUnblockSignals();
+
+	/* Determine the parallel worker number for our first leader. */
+	memcpy(&worker_number, MyBgworkerEntry->bgw_extra, sizeof(int));
+
+	/* Arrange to signal the leader if we exit. */
+	on_shmem_exit(ParallelWorkerShutdown, (Datum) 0);
+
+	/*
+	 * Serve the leader that launched us; then, if the worker pool is enabled,
+	 * any others that come along before we've been idle for too long.
+	 */
+	while (ParallelWorkerServe(handle, worker_number))
+	{
+		if (!ParallelWorkerPoolWait(&handle, &worker_number))
+			break;
+	}
+}
+
+/*
+ * Do the work for one leader, given the handle of its DSM segment.
+ *
+ * Returns true if we have cleaned up and can serve another leader, false if
+ * we should just exit.
+ */
+static bool
+ParallelWorkerServe(dsm_handle handle, int worker_number)
 {
 	dsm_segment *seg;
 	shm_toc    *toc;
@@ -1261,22 +1653,20 @@ ParallelWorkerMain(Datum main_arg)
 	char	   *uncommittedenumsspace;
 	StringInfoData msgbuf;
 	char	   *session_dsm_handle_space;
+	MemoryContext task_context;
 
 	/* Set flag to indicate that we're initializing a parallel worker. */
 	InitializingParallelWorker = true;
 
-	/* Establish signal handlers. */
-	pqsignal(SIGTERM, die);
-	BackgroundWorkerUnblockSignals();
-
-	/* Determine and set our parallel worker number. */
+	/* Set our parallel worker number. */
 	Assert(ParallelWorkerNumber == -1);
-	memcpy(&ParallelWorkerNumber, MyBgworkerEntry->bgw_extra, sizeof(int));
+	ParallelWorkerNumber = worker_number;
 
 	/* Set up a memory context to work in, just for cleanliness. */
-	CurrentMemoryContext = AllocSetContextCreate(TopMemoryContext,
-												 "Parallel worker",
-												 ALLOCSET_DEFAULT_SIZES);
+	task_context = AllocSetContextCreate(TopMemoryContext,
+										 "Parallel worker",
+										 ALLOCSET_DEFAULT_SIZES);
+	MemoryContextSwitchTo(task_context);
 
 	/*
 	 * Attach to the dynamic shared memory segment for the parallel query, and
@@ -1284,10 +1674,11 @@ ParallelWorkerMain(Datum main_arg)
 	 *
 	 * Note: at this point, we have not created any ResourceOwner in this
 	 * process.  This will result in our DSM mapping surviving until process
-	 * exit, which is fine.  If there were a ResourceOwner, it would acquire
-	 * ownership of the mapping, but we have no need for that.
+	 * exit, or until we detach it ourselves to serve another leader, which is
+	 * fine.  If there were a ResourceOwner, it would acquire ownership of the
+	 * mapping, but we have no need for that.
 	 */
-	seg = dsm_attach(DatumGetUInt32(main_arg));
+	seg = dsm_attach(handle);
 	if (seg == NULL)
 		ereport(ERROR,
 				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
@@ -1302,10 +1693,9 @@ ParallelWorkerMain(Datum main_arg)
 	fps = shm_toc_lookup(toc, PARALLEL_KEY_FIXED, false);
 	MyFixedParallelState = fps;
 
-	/* Arrange to signal the leader if we exit. */
+	/* Remember whom to signal if we exit. */
 	ParallelLeaderPid = fps->parallel_leader_pid;
 	ParallelLeaderBackendId = fps->parallel_leader_backend_id;
-	on_shmem_exit(ParallelWorkerShutdown, (Datum) 0);
 
 	/*
 	 * Now we can find and attach to the error queue provided for us.  That's
@@ -1350,7 +1740,7 @@ ParallelWorkerMain(Datum main_arg)
 	 */
 	if (!BecomeLockGroupMember(fps->parallel_leader_pgproc,
 							   fps->parallel_leader_pid))
-		return;
+		return false;
 
 	/*
 	 * Restore transaction and statement start-time timestamps.  This must
@@ -1370,10 +1760,20 @@ ParallelWorkerMain(Datum main_arg)
 
 	entrypt = LookupParallelWorkerFunction(library_name, function_name);
 
-	/* Restore database connection. */
-	BackgroundWorkerInitializeConnectionByOid(fps->database_id,
-											  fps->authenticated_user_id,
-											  0);
+	/*
+	 * Restore database connection, unless we served an earlier leader; the
+	 * pool only gives us leaders with the same database and user.  What gets
+	 * allocated here must outlive task_context.
+	 */
+	if (!OidIsValid(MyDatabaseId))
+	{
+		MemoryContextSwitchTo(TopMemoryContext);
+		BackgroundWorkerInitializeConnectionByOid(fps->database_id,
+												  fps->authenticated_user_id,
+												  0);
+		MemoryContextSwitchTo(task_context);
+	}
+	Assert(MyDatabaseId == fps->database_id);
 
 	/*
 	 * Set the client encoding to the database encoding, since that is what
@@ -1484,6 +1884,166 @@ ParallelWorkerMain(Datum main_arg)
 
 	/* Report success. */
 	pq_putmessage('X', NULL, 0);
+
+	/*
+	 * If the worker pool is enabled, try to stay around.  We only do that
+	 * after running a parallel query, because other entry points might leave
+	 * state behind that we don't know how to clean up.
+	 */
+	if (parallel_worker_idle_timeout <= 0 || entrypt != ParallelQueryMain)
+		return false;
+
+	return ParallelWorkerRelease(seg, toc, task_context);
+}
+
+/*
+ * Clean up after serving a leader, and tell it that we did.  Returns false
+ * if the leader has decided to kill us in the meantime.
+ */
+static bool
+ParallelWorkerRelease(dsm_segment *seg, shm_toc *toc,
+					  MemoryContext task_context)
+{
+	FixedParallelState *fps = MyFixedParallelState;
+	ParallelWorkerPoolState *poolstate;
+	bool		released;
+
+	/*
+	 * Our record typmods came from the leader's session, which we've already
+	 * detached from.  If we can't forget them, we can't serve another leader.
+	 */
+	if (!SharedRecordTypmodRegistryForget())
+		return false;
+
+	/* Our transaction has released all our locks, so leave the lock group. */
+	LeaveLockGroup();
+
+	/* Forget about state that survives the end of the transaction. */
+	ResetReindexState(0);
+	XactLastRecEnd = 0;
+	debug_query_string = NULL;
+
+	poolstate = shm_toc_lookup(toc, PARALLEL_KEY_POOL_STATE, false);
+	SpinLockAcquire(&fps->mutex);
+	released = (poolstate[ParallelWorkerNumber] == PARALLEL_WORKER_RUNNING);
+	if (released)
+		poolstate[ParallelWorkerNumber] = PARALLEL_WORKER_RELEASED;
+	SpinLockRelease(&fps->mutex);
+
+	if (!released)
+		return false;
+
+	/* The leader might be waiting for us; after this, we're on our own. */
+	SetLatch(&fps->parallel_leader_pgproc->procLatch);
+
+	ParallelWorkerNumber = -1;
+	MyFixedParallelState = NULL;
+	ParallelLeaderPid = 0;
+	ParallelLeaderBackendId = InvalidBackendId;
+	dsm_detach(seg);
+
+	MemoryContextSwitchTo(TopMemoryContext);
+	MemoryContextDelete(task_context);
+
+	/* Send our statistics, as we would when exiting. */
+	pgstat_report_stat(true);
+
+	return true;
+}
+
+/*
+ * Wait in the pool until a leader hands us some work.
+ *
+ * Returns false if nobody did within parallel_worker_idle_timeout, or if
+ * there was no room in the pool.
+ */
+static bool
+ParallelWorkerPoolWait(dsm_handle *handle, int *worker_number)
+{
+	TimestampTz idle_start;
+
+	/* Don't offer our services if we've been asked to exit. */
+	CHECK_FOR_INTERRUPTS();
+
+	/* We can't wait for a leader if we can't tell them what we've loaded. */
+	if (EstimateLibraryStateSpace() > PARALLEL_POOL_LIBRARY_SPACE)
+		return false;
+
+	if (MyPoolSlot == NULL)
+	{
+		int			slotno;
+
+		LWLockAcquire(ParallelWorkerPoolLock, LW_EXCLUSIVE);
+		for (slotno = 0; slotno < ParallelWorkerPool->nslots; slotno++)
+		{
+			ParallelWorkerPoolSlot *slot = &ParallelWorkerPool->slots[slotno];
+
+			if (slot->pid == 0)
+			{
+				slot->pid = MyProcPid;
+				slot->proc = MyProc;
+				slot->database_id = MyDatabaseId;
+				slot->authenticated_user_id = GetAuthenticatedUserId();
+				slot->idle = false;
+				slot->evict = false;
+				slot->leader = NULL;
+				MyPoolSlot = slot;
+				break;
+			}
+		}
+		LWLockRelease(ParallelWorkerPoolLock);
+
+		if (MyPoolSlot == NULL)
+			return false;
+		on_shmem_exit(ParallelWorkerPoolExit, (Datum) 0);
+	}
+
+	LWLockAcquire(ParallelWorkerPoolLock, LW_EXCLUSIVE);
+	SerializeLibraryState(PARALLEL_POOL_LIBRARY_SPACE, MyPoolSlot->libraries);
+	MyPoolSlot->idle = true;
+	MyPoolSlot->leader = NULL;
+	MyPoolSlot->seg_handle = DSM_HANDLE_INVALID;
+	LWLockRelease(ParallelWorkerPoolLock);
+
+	pgstat_report_activity(STATE_IDLE, NULL);
+
+	idle_start = GetCurrentTimestamp();
+	for (;;)
+	{
+		long		timeout;
+
+		CHECK_FOR_INTERRUPTS();
+
+		/* Keep up with catalog changes, so as not to hold back others. */
+		if (catchupInterruptPending)
+			ProcessCatchupInterrupt();
+
+		timeout = parallel_worker_idle_timeout -
+			TimestampDifferenceMilliseconds(idle_start, GetCurrentTimestamp());
+
+		LWLockAcquire(ParallelWorkerPoolLock, LW_EXCLUSIVE);
+		if (!MyPoolSlot->idle)
+		{
+			*handle = MyPoolSlot->seg_handle;
+			*worker_number = MyPoolSlot->worker_number;
+			LWLockRelease(ParallelWorkerPoolLock);
+			return true;
+		}
+		if (timeout <= 0 || MyPoolSlot->evict)
+		{
+			/* Leave the pool, so that nobody hands us any more work. */
+			MyPoolSlot->pid = 0;
+			MyPoolSlot = NULL;
+			LWLockRelease(ParallelWorkerPoolLock);
+			return false;
+		}
+		LWLockRelease(ParallelWorkerPoolLock);
+
+		(void) WaitLatch(MyLatch,
+						 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						 timeout, WAIT_EVENT_PARALLEL_WORKER_IDLE);
+		ResetLatch(MyLatch);
+	}
 }
 
 /*
@@ -1511,11 +2071,34 @@ ParallelWorkerReportLastRecEnd(XLogRecPtr last_xlog_end)
 static void
 ParallelWorkerShutdown(int code, Datum arg)
 {
+	/* Nothing to do if we're between leaders. */
+	if (ParallelLeaderPid == 0)
+		return;
+
 	SendProcSignal(ParallelLeaderPid,
 				   PROCSIG_PARALLEL_MESSAGE,
 				   ParallelLeaderBackendId);
 }
 
+/*
+ * Give up our slot in the worker pool.  If a leader has just picked us, we
+ * won't be serving it after all; make sure it finds out.
+ */
+static void
+ParallelWorkerPoolExit(int code, Datum arg)
+{
+	if (MyPoolSlot == NULL)
+		return;
+
+	LWLockAcquire(ParallelWorkerPoolLock, LW_EXCLUSIVE);
+	if (!MyPoolSlot->idle && MyPoolSlot->leader != NULL)
+		SetLatch(&MyPoolSlot->leader->procLatch);
+	MyPoolSlot->pid = 0;
+	LWLockRelease(ParallelWorkerPoolLock);
+
+	MyPoolSlot = NULL;
+}
+
 /*
  * Look up (and possibly load) a parallel worker entry point function.
  *
@@ -9,9 +9,14 @@
  * page, soon after a page transition).  Read traffic will probably touch
  * a larger span of pages, but in any case a fairly small number of page
  * buffers should be sufficient.  So, we just search the buffers using plain
- * linear search; there's no need for a hashtable or anything fancy.
- * The management algorithm is straight LRU except that we will never swap
- * out the latest page (since we know it's going to be hit again eventually).
+ * linear search; there's no need for a hashtable or anything fancy.  Some
+ * SLRUs can be configured with much larger pools, though, so the slots are
+ * divided into banks of SLRU_BANK_SIZE slots, and each page is mapped to a
+ * single bank by its page number: the linear search, and the choice of a
+ * victim, only ever scans that one bank.
+ * The management algorithm is straight LRU (within a bank) except that we
+ * will never swap out the latest page (since we know it's going to be hit
+ * again eventually).
  *
  * We use a control LWLock to protect the shared data structures, plus
  * per-buffer LWLocks that synchronize I/O for each buffer.  The control lock
@@ -119,6 +124,20 @@ typedef struct SlruWriteAllData *SlruWriteAll;
 		} \
 	} while (0)
 
+/*
+ * Compute the range of slots [*first, *last) that make up the bank in which
+ * the given page is stored.  With fewer than 2 * SLRU_BANK_SIZE slots there
+ * is only a single bank, covering all slots.
+ */
+static inline void
+SlruPageBank(SlruShared shared, int pageno, int *first, int *last)
+{
+	int			bankno = (uint32) pageno % shared->num_banks;
+
+	*first = bankno * shared->num_slots / shared->num_banks;
+	*last = (bankno + 1) * shared->num_slots / shared->num_banks;
+}
+
 /* Saved info for SlruReportIOError */
 typedef enum
 {
@@ -208,6 +227,7 @@ SimpleLruInit(SlruCtl ctl, const char *name, int nslots, int nlsns,
 		shared->ControlLock = ctllock;
 
 		shared->num_slots = nslots;
+		shared->num_banks = Max(nslots / SLRU_BANK_SIZE, 1);
 		shared->lsn_groups_per_page = nlsns;
 
 		shared->cur_lru_count = 0;
@@ -495,12 +515,15 @@ SimpleLruReadPage_ReadOnly(SlruCtl ctl, int pageno, TransactionId xid)
 {
 	SlruShared	shared = ctl->shared;
 	int			slotno;
+	int			bankstart;
+	int			bankend;
 
 	/* Try to find the page while holding only shared lock */
 	LWLockAcquire(shared->ControlLock, LW_SHARED);
 
 	/* See if page is already in a buffer */
-	for (slotno = 0; slotno < shared->num_slots; slotno++)
+	SlruPageBank(shared, pageno, &bankstart, &bankend);
+	for (slotno = bankstart; slotno < bankend; slotno++)
 	{
 		if (shared->page_number[slotno] == pageno &&
 			shared->page_status[slotno] != SLRU_PAGE_EMPTY &&
@@ -1027,9 +1050,15 @@ SlruSelectLRUPage(SlruCtl ctl, int pageno)
 		int			bestinvalidslot = 0;	/* keep compiler quiet */
 		int			best_invalid_delta = -1;
 		int			best_invalid_page_number = 0;	/* keep compiler quiet */
+		int			bankstart;
+		int			bankend;
 
-		/* See if page already has a buffer assigned */
-		for (slotno = 0; slotno < shared->num_slots; slotno++)
+		/*
+		 * See if page already has a buffer assigned.  It can only be in its
+		 * own bank, and that is also where we must pick a victim from.
+		 */
+		SlruPageBank(shared, pageno, &bankstart, &bankend);
+		for (slotno = bankstart; slotno < bankend; slotno++)
 		{
 			if (shared->page_number[slotno] == pageno &&
 				shared->page_status[slotno] != SLRU_PAGE_EMPTY)
@@ -1064,7 +1093,7 @@ SlruSelectLRUPage(SlruCtl ctl, int pageno)
 		 * multiple pages with the same lru_count.
 		 */
 		cur_count = (shared->cur_lru_count)++;
-		for (slotno = 0; slotno < shared->num_slots; slotno++)
+		for (slotno = bankstart; slotno < bankend; slotno++)
 		{
 			int			this_delta;
 			int			this_page_number;
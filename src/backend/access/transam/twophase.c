@@ -103,6 +103,7 @@
 #include "storage/proc.h"
 #include "storage/procarray.h"
 #include "storage/sinvaladt.h"
+#include "storage/shmem.h"
 #include "storage/smgr.h"
 #include "utils/builtins.h"
 #include "utils/memutils.h"
@@ -190,6 +191,32 @@ typedef struct TwoPhaseStateData
 
 static TwoPhaseStateData *TwoPhaseState;
 
+/*
+ * Map from GID to the entry in TwoPhaseState->prepXacts that uses it, so
+ * that PREPARE TRANSACTION and COMMIT/ROLLBACK PREPARED don't need to scan
+ * all prepared transactions.  Protected by TwoPhaseStateLock, like
+ * TwoPhaseState.
+ */
+typedef struct TwoPhaseGidEntry
+{
+	char		gid[GIDSIZE];	/* hash key, must be first */
+	GlobalTransaction gxact;
+} TwoPhaseGidEntry;
+
+static HTAB *TwoPhaseGidHash;
+
+/*
+ * Copy of the state data of the transaction we prepared last, so that we
+ * needn't read it back from WAL if we are also the one to finish it, as
+ * transaction managers commonly do.  Kept in TopMemoryContext.
+ */
+static char *LastPreparedState = NULL;
+static TransactionId LastPreparedXid = InvalidTransactionId;
+static XLogRecPtr LastPreparedLSN = InvalidXLogRecPtr;
+
+/* Don't bother keeping a copy of state data larger than this */
+#define LAST_PREPARED_STATE_MAX_SIZE	(64 * 1024)
+
 /*
  * Global transaction entry currently locked by us, if any.  Note that any
  * access to the entry pointed to by this variable must be protected by
@@ -217,6 +244,7 @@ static void RecordTransactionAbortPrepared(TransactionId xid,
 										   const char *gid);
 static void ProcessRecords(char *bufptr, TransactionId xid,
 						   const TwoPhaseCallback callbacks[]);
+static void AddGXactGid(GlobalTransaction gxact);
 static void RemoveGXact(GlobalTransaction gxact);
 
 static void XlogReadTwoPhaseData(XLogRecPtr lsn, char **buf, int *len);
@@ -245,6 +273,10 @@ TwoPhaseShmemSize(void)
 	size = add_size(size, mul_size(max_prepared_xacts,
 								   sizeof(GlobalTransactionData)));
 
+	/* And the GID lookup table */
+	size = add_size(size, hash_estimate_size(max_prepared_xacts,
+											 sizeof(TwoPhaseGidEntry)));
+
 	return size;
 }
 
@@ -298,6 +330,19 @@ TwoPhaseShmemInit(void)
 	}
 	else
 		Assert(found);
+
+	if (max_prepared_xacts > 0)
+	{
+		HASHCTL		info;
+
+		info.keysize = GIDSIZE;
+		info.entrysize = sizeof(TwoPhaseGidEntry);
+		TwoPhaseGidHash = ShmemInitHash("Prepared Transaction GIDs",
+										max_prepared_xacts,
+										max_prepared_xacts,
+										&info,
+										HASH_ELEM | HASH_STRINGS);
+	}
 }
 
 /*
@@ -373,7 +418,6 @@ MarkAsPreparing(TransactionId xid, const char *gid,
 				TimestampTz prepared_at, Oid owner, Oid databaseid)
 {
 	GlobalTransaction gxact;
-	int			i;
 
 	if (strlen(gid) >= GIDSIZE)
 		ereport(ERROR,
@@ -398,17 +442,11 @@ MarkAsPreparing(TransactionId xid, const char *gid,
 	LWLockAcquire(TwoPhaseStateLock, LW_EXCLUSIVE);
 
 	/* Check for conflicting GID */
-	for (i = 0; i < TwoPhaseState->numPrepXacts; i++)
-	{
-		gxact = TwoPhaseState->prepXacts[i];
-		if (strcmp(gxact->gid, gid) == 0)
-		{
-			ereport(ERROR,
-					(errcode(ERRCODE_DUPLICATE_OBJECT),
-					 errmsg("transaction identifier \"%s\" is already in use",
-							gid)));
-		}
-	}
+	if (hash_search(TwoPhaseGidHash, gid, HASH_FIND, NULL) != NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_DUPLICATE_OBJECT),
+				 errmsg("transaction identifier \"%s\" is already in use",
+						gid)));
 
 	/* Get a free gxact from the freelist */
 	if (TwoPhaseState->freeGXacts == NULL)
@@ -427,6 +465,7 @@ MarkAsPreparing(TransactionId xid, const char *gid,
 	/* And insert it into the active array */
 	Assert(TwoPhaseState->numPrepXacts < max_prepared_xacts);
 	TwoPhaseState->prepXacts[TwoPhaseState->numPrepXacts++] = gxact;
+	AddGXactGid(gxact);
 
 	LWLockRelease(TwoPhaseStateLock);
 
@@ -447,6 +486,9 @@ MarkAsPreparingGuts(GlobalTransaction gxact, TransactionId xid, const char *gid,
 					TimestampTz prepared_at, Oid owner, Oid databaseid)
 {
 	PGPROC	   *proc;
+	TransactionId *subxids;
+	uint64	   *fpLockBits;
+	Oid		   *fpRelId;
 	int			i;
 
 	Assert(LWLockHeldByMeInMode(TwoPhaseStateLock, LW_EXCLUSIVE));
@@ -454,8 +496,17 @@ MarkAsPreparingGuts(GlobalTransaction gxact, TransactionId xid, const char *gid,
 	Assert(gxact != NULL);
 	proc = &ProcGlobal->allProcs[gxact->pgprocno];
 
-	/* Initialize the PGPROC entry */
+	/*
+	 * Initialize the PGPROC entry, preserving the pointers to its arrays in
+	 * shared memory.
+	 */
+	subxids = proc->subxids.xids;
+	fpLockBits = proc->fpLockBits;
+	fpRelId = proc->fpRelId;
 	MemSet(proc, 0, sizeof(PGPROC));
+	proc->subxids.xids = subxids;
+	proc->fpLockBits = fpLockBits;
+	proc->fpRelId = fpRelId;
 	proc->pgprocno = gxact->pgprocno;
 	SHMQueueElemInit(&(proc->links));
 	proc->waitStatus = PROC_WAIT_STATUS_OK;
@@ -511,10 +562,10 @@ GXactLoadSubxactData(GlobalTransaction gxact, int nsubxacts,
 	PGPROC	   *proc = &ProcGlobal->allProcs[gxact->pgprocno];
 
 	/* We need no extra lock since the GXACT isn't valid yet */
-	if (nsubxacts > PGPROC_MAX_CACHED_SUBXIDS)
+	if (nsubxacts > max_cached_subxids)
 	{
 		proc->subxidStatus.overflowed = true;
-		nsubxacts = PGPROC_MAX_CACHED_SUBXIDS;
+		nsubxacts = max_cached_subxids;
 	}
 	if (nsubxacts > 0)
 	{
@@ -555,7 +606,7 @@ MarkAsPrepared(GlobalTransaction gxact, bool lock_held)
 static GlobalTransaction
 LockGXact(const char *gid, Oid user)
 {
-	int			i;
+	TwoPhaseGidEntry *entry = NULL;
 
 	/* on first call, register the exit hook */
 	if (!twophaseExitRegistered)
@@ -566,17 +617,16 @@ LockGXact(const char *gid, Oid user)
 
 	LWLockAcquire(TwoPhaseStateLock, LW_EXCLUSIVE);
 
-	for (i = 0; i < TwoPhaseState->numPrepXacts; i++)
+	if (max_prepared_xacts > 0 && strlen(gid) < GIDSIZE)
+		entry = (TwoPhaseGidEntry *) hash_search(TwoPhaseGidHash, gid,
+												 HASH_FIND, NULL);
+
+	/* Ignore not-yet-valid GIDs */
+	if (entry != NULL && entry->gxact->valid)
 	{
-		GlobalTransaction gxact = TwoPhaseState->prepXacts[i];
+		GlobalTransaction gxact = entry->gxact;
 		PGPROC	   *proc = &ProcGlobal->allProcs[gxact->pgprocno];
 
-		/* Ignore not-yet-valid GIDs */
-		if (!gxact->valid)
-			continue;
-		if (strcmp(gxact->gid, gid) != 0)
-			continue;
-
 		/* Found it, but has someone else got it locked? */
 		if (gxact->locking_backend != InvalidBackendId)
 			ereport(ERROR,
@@ -622,6 +672,22 @@ LockGXact(const char *gid, Oid user)
 	return NULL;
 }
 
+/*
+ * AddGXactGid
+ *		Make the prepared transaction findable by its GID.
+ */
+static void
+AddGXactGid(GlobalTransaction gxact)
+{
+	TwoPhaseGidEntry *entry;
+
+	Assert(LWLockHeldByMeInMode(TwoPhaseStateLock, LW_EXCLUSIVE));
+
+	entry = (TwoPhaseGidEntry *) hash_search(TwoPhaseGidHash, gxact->gid,
+											 HASH_ENTER, NULL);
+	entry->gxact = gxact;
+}
+
 /*
  * RemoveGXact
  *		Remove the prepared transaction from the shared memory array.
@@ -631,10 +697,16 @@ LockGXact(const char *gid, Oid user)
 static void
 RemoveGXact(GlobalTransaction gxact)
 {
+	TwoPhaseGidEntry *entry;
 	int			i;
 
 	Assert(LWLockHeldByMeInMode(TwoPhaseStateLock, LW_EXCLUSIVE));
 
+	entry = (TwoPhaseGidEntry *) hash_search(TwoPhaseGidHash, gxact->gid,
+											 HASH_FIND, NULL);
+	if (entry != NULL && entry->gxact == gxact)
+		hash_search(TwoPhaseGidHash, gxact->gid, HASH_REMOVE, NULL);
+
 	for (i = 0; i < TwoPhaseState->numPrepXacts; i++)
 	{
 		if (gxact == TwoPhaseState->prepXacts[i])
@@ -1092,6 +1164,30 @@ EndPrepare(GlobalTransaction gxact)
 				(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
 				 errmsg("two-phase state file maximum length exceeded")));
 
+	/*
+	 * Keep a copy of the state data, in case we finish the transaction
+	 * ourselves.  This has to happen before the critical section.
+	 */
+	if (LastPreparedState != NULL)
+	{
+		pfree(LastPreparedState);
+		LastPreparedState = NULL;
+		LastPreparedXid = InvalidTransactionId;
+		LastPreparedLSN = InvalidXLogRecPtr;
+	}
+	if (records.total_len <= LAST_PREPARED_STATE_MAX_SIZE)
+	{
+		char	   *ptr;
+
+		ptr = LastPreparedState = MemoryContextAlloc(TopMemoryContext,
+													 records.total_len);
+		for (record = records.head; record != NULL; record = record->next)
+		{
+			memcpy(ptr, record->data, record->len);
+			ptr += record->len;
+		}
+	}
+
 	/*
 	 * Now writing 2PC state data to WAL. We let the WAL's CRC protection
 	 * cover us, so no need to calculate a separate CRC.
@@ -1133,6 +1229,12 @@ EndPrepare(GlobalTransaction gxact)
 	/* Store record's start location to read that later on Commit */
 	gxact->prepare_start_lsn = ProcLastRecPtr;
 
+	if (LastPreparedState != NULL)
+	{
+		LastPreparedXid = gxact->xid;
+		LastPreparedLSN = gxact->prepare_start_lsn;
+	}
+
 	/*
 	 * Mark the prepared transaction as valid.  As soon as xact.c marks
 	 * MyProc as not running our XID (which it will do immediately after
@@ -1437,7 +1539,17 @@ FinishPreparedTransaction(const char *gid, bool isCommit)
 	 * in WAL files if the LSN is after the last checkpoint record, or moved
 	 * to disk if for some reason they have lived for a long time.
 	 */
-	if (gxact->ondisk)
+	if (LastPreparedState != NULL &&
+		TransactionIdEquals(LastPreparedXid, xid) &&
+		LastPreparedLSN == gxact->prepare_start_lsn)
+	{
+		/* We prepared it ourselves, and still have the data at hand */
+		buf = LastPreparedState;
+		LastPreparedState = NULL;
+		LastPreparedXid = InvalidTransactionId;
+		LastPreparedLSN = InvalidXLogRecPtr;
+	}
+	else if (gxact->ondisk)
 		buf = ReadTwoPhaseFile(xid, false);
 	else
 		XlogReadTwoPhaseData(gxact->prepare_start_lsn, &buf, NULL);
@@ -2404,6 +2516,7 @@ PrepareRedoAdd(char *buf, XLogRecPtr start_lsn,
 	/* And insert it into the active array */
 	Assert(TwoPhaseState->numPrepXacts < max_prepared_xacts);
 	TwoPhaseState->prepXacts[TwoPhaseState->numPrepXacts++] = gxact;
+	AddGXactGid(gxact);
 
 	if (origin_id != InvalidRepOriginId)
 	{
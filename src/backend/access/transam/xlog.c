@@ -99,15 +99,16 @@ char	   *XLogArchiveCommand = NULL;
 bool		EnableHotStandby = false;
 bool		fullPageWrites = true;
 bool		wal_log_hints = false;
-bool		wal_compression = false;
+int			wal_compression = WAL_COMPRESSION_NONE;
 char	   *wal_consistency_checking_string = NULL;
 bool	   *wal_consistency_checking = NULL;
 bool		wal_init_zero = true;
 bool		wal_recycle = true;
+int			wal_preallocate_segments = 2;
 bool		log_checkpoints = false;
 int			sync_method = DEFAULT_SYNC_METHOD;
 int			wal_level = WAL_LEVEL_MINIMAL;
-int			CommitDelay = 0;	/* precommit delay in microseconds */
+int			CommitDelay = 0;	/* precommit delay in microseconds, -1 = auto */
 int			CommitSiblings = 5; /* # concurrent xacts needed to sleep */
 int			wal_retrieve_retry_interval = 5000;
 int			max_slot_wal_keep_size_mb = -1;
@@ -121,11 +122,14 @@ bool		XLOG_DEBUG = false;
 int			wal_segment_size = DEFAULT_XLOG_SEG_SIZE;
 
 /*
- * Number of WAL insertion locks to use. A higher value allows more insertions
- * to happen concurrently, but adds some CPU overhead to flushing the WAL,
- * which needs to iterate all the locks.
+ * Number of WAL insertion locks to use (wal_insert_locks GUC). A higher value
+ * allows more insertions to happen concurrently, but adds some CPU overhead
+ * to flushing the WAL, which needs to iterate all the locks.
  */
-#define NUM_XLOGINSERT_LOCKS  8
+int			NumXLogInsertLocks = 8;
+
+/* Upper limit of commit_delay, also applied to the automatic delay */
+#define MAX_COMMIT_DELAY	100000
 
 /*
  * Max distance from last checkpoint, before triggering a new xlog-based
@@ -616,6 +620,13 @@ typedef struct XLogCtlData
 	pg_time_t	lastSegSwitchTime;
 	XLogRecPtr	lastSegSwitchLSN;
 
+	/*
+	 * Moving average of the time XLogFlush() spends writing and flushing WAL,
+	 * in microseconds, used to size the delay when commit_delay = -1.  Only
+	 * maintained in that case.  Protected by WALWriteLock.
+	 */
+	uint64		avgFlushTime;
+
 	/*
 	 * Protected by info_lck and WALWriteLock (you must hold either lock to
 	 * read it, but both to update)
@@ -1042,8 +1053,8 @@ XLogInsertRecord(XLogRecData *rdata,
 	 * To keep track of which insertions are still in-progress, each concurrent
 	 * inserter acquires an insertion lock. In addition to just indicating that
 	 * an insertion is in progress, the lock tells others how far the inserter
-	 * has progressed. There is a small fixed number of insertion locks,
-	 * determined by NUM_XLOGINSERT_LOCKS. When an inserter crosses a page
+	 * has progressed. There is a small number of insertion locks, determined
+	 * by wal_insert_locks at server start. When an inserter crosses a page
 	 * boundary, it updates the value stored in the lock to the how far it has
 	 * inserted, to allow the previous buffer to be flushed.
 	 *
@@ -1685,7 +1696,7 @@ WALInsertLockAcquire(void)
 	static int	lockToTry = -1;
 
 	if (lockToTry == -1)
-		lockToTry = MyProc->pgprocno % NUM_XLOGINSERT_LOCKS;
+		lockToTry = MyProc->pgprocno % NumXLogInsertLocks;
 	MyLockNo = lockToTry;
 
 	/*
@@ -1703,7 +1714,7 @@ WALInsertLockAcquire(void)
 		 * than locks, it still helps to distribute the inserters evenly
 		 * across the locks.
 		 */
-		lockToTry = (lockToTry + 1) % NUM_XLOGINSERT_LOCKS;
+		lockToTry = (lockToTry + 1) % NumXLogInsertLocks;
 	}
 }
 
@@ -1721,7 +1732,7 @@ WALInsertLockAcquireExclusive(void)
 	 * indicator is set to 0xFFFFFFFFFFFFFFFF, which is higher than any real
 	 * XLogRecPtr value, to make sure that no-one blocks waiting on those.
 	 */
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS - 1; i++)
+	for (i = 0; i < NumXLogInsertLocks - 1; i++)
 	{
 		LWLockAcquire(&WALInsertLocks[i].l.lock, LW_EXCLUSIVE);
 		LWLockUpdateVar(&WALInsertLocks[i].l.lock,
@@ -1747,7 +1758,7 @@ WALInsertLockRelease(void)
 	{
 		int			i;
 
-		for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+		for (i = 0; i < NumXLogInsertLocks; i++)
 			LWLockReleaseClearVar(&WALInsertLocks[i].l.lock,
 								  &WALInsertLocks[i].l.insertingAt,
 								  0);
@@ -1775,8 +1786,8 @@ WALInsertLockUpdateInsertingAt(XLogRecPtr insertingAt)
 		 * We use the last lock to mark our actual position, see comments in
 		 * WALInsertLockAcquireExclusive.
 		 */
-		LWLockUpdateVar(&WALInsertLocks[NUM_XLOGINSERT_LOCKS - 1].l.lock,
-						&WALInsertLocks[NUM_XLOGINSERT_LOCKS - 1].l.insertingAt,
+		LWLockUpdateVar(&WALInsertLocks[NumXLogInsertLocks - 1].l.lock,
+						&WALInsertLocks[NumXLogInsertLocks - 1].l.insertingAt,
 						insertingAt);
 	}
 	else
@@ -1843,7 +1854,7 @@ WaitXLogInsertionsToFinish(XLogRecPtr upto)
 	 * out for any insertion that's still in progress.
 	 */
 	finishedUpto = reservedUpto;
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < NumXLogInsertLocks; i++)
 	{
 		XLogRecPtr	insertingat = InvalidXLogRecPtr;
 
@@ -2232,6 +2243,14 @@ AdvanceXLInsertBuffer(XLogRecPtr upto, bool opportunistic)
 
 		NewPage = (XLogPageHeader) (XLogCtl->pages + nextidx * (Size) XLOG_BLCKSZ);
 
+		/*
+		 * Mark the buffer as not holding any page while we reinitialize it,
+		 * so that XLogReadFromBuffers() doesn't mistake the zeroed contents
+		 * for the old page.
+		 */
+		*((volatile XLogRecPtr *) &XLogCtl->xlblocks[nextidx]) = InvalidXLogRecPtr;
+		pg_write_barrier();
+
 		/*
 		 * Be sure to re-zero the buffer so that bytes beyond what we've
 		 * written will look like zeroes and not valid XLOG records...
@@ -2882,6 +2901,7 @@ XLogFlush(XLogRecPtr record)
 {
 	XLogRecPtr	WriteRqstPtr;
 	XLogwrtRqst WriteRqst;
+	int			delay;
 
 	/*
 	 * During REDO, we are reading not writing WAL.  Therefore, instead of
@@ -2977,13 +2997,21 @@ XLogFlush(XLogRecPtr record)
 		 * followers; this can significantly improve transaction throughput,
 		 * at the risk of increasing transaction latency.
 		 *
+		 * With commit_delay = -1, we wait for half of the recent average
+		 * flush time: transactions committing in that window would otherwise
+		 * have to wait for the whole next flush anyway.
+		 *
 		 * We do not sleep if enableFsync is not turned on, nor if there are
 		 * fewer than CommitSiblings other backends with active transactions.
 		 */
-		if (CommitDelay > 0 && enableFsync &&
+		delay = CommitDelay;
+		if (delay < 0)
+			delay = (int) Min(XLogCtl->avgFlushTime / 2, MAX_COMMIT_DELAY);
+
+		if (delay > 0 && enableFsync &&
 			MinimumActiveBackends(CommitSiblings))
 		{
-			pg_usleep(CommitDelay);
+			pg_usleep(delay);
 
 			/*
 			 * Re-check how far we can now flush the WAL. It's generally not
@@ -3002,7 +3030,21 @@ XLogFlush(XLogRecPtr record)
 		WriteRqst.Write = insertpos;
 		WriteRqst.Flush = insertpos;
 
-		XLogWrite(WriteRqst, false);
+		if (CommitDelay < 0 && enableFsync)
+		{
+			instr_time	start;
+			instr_time	duration;
+
+			INSTR_TIME_SET_CURRENT(start);
+			XLogWrite(WriteRqst, false);
+			INSTR_TIME_SET_CURRENT(duration);
+			INSTR_TIME_SUBTRACT(duration, start);
+
+			XLogCtl->avgFlushTime = (XLogCtl->avgFlushTime * 7 +
+									 INSTR_TIME_GET_MICROSEC(duration)) / 8;
+		}
+		else
+			XLogWrite(WriteRqst, false);
 
 		LWLockRelease(WALWriteLock);
 		/* done */
@@ -3938,6 +3980,7 @@ XLogFileClose(void)
  * High-volume systems will be OK once they've built up a sufficient set of
  * recycled log segments, but the startup transient is likely to include
  * a lot of segment creations by foreground processes, which is not so good.
+ * XLogPreallocateSegments(), run by the WAL writer, takes care of that case.
  */
 static void
 PreallocXlogFiles(XLogRecPtr endptr)
@@ -3960,6 +4003,48 @@ PreallocXlogFiles(XLogRecPtr endptr)
 	}
 }
 
+/*
+ * Make sure that the next wal_preallocate_segments WAL segments beyond the
+ * current insert position exist, so that backends crossing a segment
+ * boundary in XLogWrite() don't have to create and zero-fill the new
+ * segment themselves while holding WALWriteLock.  This is called
+ * periodically by the WAL writer.
+ *
+ * Returns true if any new segment was created.
+ */
+bool
+XLogPreallocateSegments(void)
+{
+	static XLogSegNo lastPreallocSegNo = 0;
+	XLogSegNo	insertSegNo;
+	XLogSegNo	targetSegNo;
+	bool		added = false;
+
+	/* also makes sure ThisTimeLineID is initialized */
+	if (wal_preallocate_segments <= 0 || RecoveryInProgress())
+		return false;
+
+	XLByteToSeg(GetXLogInsertRecPtr(), insertSegNo, wal_segment_size);
+	targetSegNo = insertSegNo + wal_preallocate_segments;
+
+	if (lastPreallocSegNo < insertSegNo)
+		lastPreallocSegNo = insertSegNo;
+
+	while (lastPreallocSegNo < targetSegNo)
+	{
+		bool		use_existent = true;
+		int			lf;
+
+		lf = XLogFileInit(lastPreallocSegNo + 1, &use_existent, true);
+		close(lf);
+		if (!use_existent)
+			added = true;
+		lastPreallocSegNo++;
+	}
+
+	return added;
+}
+
 /*
  * Throws an error if the given log segment has already been removed or
  * recycled. The caller should only pass a segment that it knows to have
@@ -5116,7 +5201,7 @@ XLOGShmemSize(void)
 	size = sizeof(XLogCtlData);
 
 	/* WAL insertion locks, plus alignment */
-	size = add_size(size, mul_size(sizeof(WALInsertLockPadded), NUM_XLOGINSERT_LOCKS + 1));
+	size = add_size(size, mul_size(sizeof(WALInsertLockPadded), NumXLogInsertLocks + 1));
 	/* xlblocks array */
 	size = add_size(size, mul_size(sizeof(XLogRecPtr), XLOGbuffers));
 	/* extra alignment padding for XLOG I/O buffers */
@@ -5206,9 +5291,9 @@ XLOGShmemInit(void)
 		((uintptr_t) allocptr) % sizeof(WALInsertLockPadded);
 	WALInsertLocks = XLogCtl->Insert.WALInsertLocks =
 		(WALInsertLockPadded *) allocptr;
-	allocptr += sizeof(WALInsertLockPadded) * NUM_XLOGINSERT_LOCKS;
+	allocptr += sizeof(WALInsertLockPadded) * NumXLogInsertLocks;
 
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < NumXLogInsertLocks; i++)
 	{
 		LWLockInitialize(&WALInsertLocks[i].l.lock, LWTRANCHE_WAL_INSERT);
 		WALInsertLocks[i].l.insertingAt = InvalidXLogRecPtr;
@@ -8595,6 +8680,60 @@ GetFlushRecPtr(void)
 	return LogwrtResult.Flush;
 }
 
+/*
+ * XLogReadFromBuffers -- Copy already-written WAL from the WAL buffers.
+ *
+ * Copies up to 'count' bytes starting at 'startptr' into 'buf', stopping at
+ * the first page that isn't in the buffers anymore.  Returns the number of
+ * bytes copied, possibly zero; the caller reads the rest from the WAL files.
+ * Only WAL of the current timeline up to the flush position can be requested,
+ * so that no insertion can still be in progress on the copied pages.
+ *
+ * No lock is taken.  Instead, each page's xlblocks entry is checked before
+ * and after copying it, which requires that 64-bit reads can't be torn.
+ */
+Size
+XLogReadFromBuffers(char *buf, XLogRecPtr startptr, Size count,
+					TimeLineID tli)
+{
+#ifdef PG_HAVE_8BYTE_SINGLE_COPY_ATOMICITY
+	XLogRecPtr	ptr = startptr;
+	Size		nbytes = count;
+	char	   *dst = buf;
+
+	if (RecoveryInProgress() || tli != XLogCtl->ThisTimeLineID)
+		return 0;
+
+	while (nbytes > 0)
+	{
+		int			idx = XLogRecPtrToBufIdx(ptr);
+		uint32		offset = ptr % XLOG_BLCKSZ;
+		Size		npagebytes = Min(nbytes, XLOG_BLCKSZ - offset);
+		XLogRecPtr	expectedEndPtr = ptr - offset + XLOG_BLCKSZ;
+		const char *page = XLogCtl->pages + idx * (Size) XLOG_BLCKSZ;
+
+		if (*((volatile XLogRecPtr *) &XLogCtl->xlblocks[idx]) != expectedEndPtr)
+			break;
+		pg_read_barrier();
+
+		memcpy(dst, page + offset, npagebytes);
+
+		/* The page must not have been replaced while we copied it */
+		pg_read_barrier();
+		if (*((volatile XLogRecPtr *) &XLogCtl->xlblocks[idx]) != expectedEndPtr)
+			break;
+
+		dst += npagebytes;
+		ptr += npagebytes;
+		nbytes -= npagebytes;
+	}
+
+	return count - nbytes;
+#else
+	return 0;
+#endif
+}
+
 /*
  * GetLastImportantRecPtr -- Returns the LSN of the last important record
  * inserted. All records not explicitly marked as unimportant are considered
@@ -8609,7 +8748,7 @@ GetLastImportantRecPtr(void)
 	XLogRecPtr	res = InvalidXLogRecPtr;
 	int			i;
 
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < NumXLogInsertLocks; i++)
 	{
 		XLogRecPtr	last_important;
 
@@ -25,7 +25,8 @@
  * didn't try to prefetch "new" blocks).
  *
  * Blocks found in the buffer pool already are counted as "skip_hit".
- * Repeated access to the same buffer is detected and skipped, and this is
+ * Repeated access to the same buffer, or to the block following the last one
+ * referenced in the same relation, is detected and skipped, and this is
  * counted with "skip_seq".  Blocks that were logged with FPWs are skipped if
  * recovery_prefetch_fpw is off, since on most systems there will be no I/O
  * stall; this is counted with "skip_fpw".
@@ -622,10 +623,6 @@ XLogPrefetcherScanBlocks(XLogPrefetcher *prefetcher)
 		{
 			/*
 			 * If this is a repeat access to the same block, then skip it.
-			 *
-			 * XXX We could also check for last_blkno + 1 too, and also update
-			 * last_blkno; it's not clear if the kernel would do a better job
-			 * of sequential prefetching.
 			 */
 			if (block->blkno == prefetcher->last_blkno)
 			{
@@ -633,6 +630,20 @@ XLogPrefetcherScanBlocks(XLogPrefetcher *prefetcher)
 				continue;
 			}
 
+			/*
+			 * If it's the block following the last one referenced, recovery
+			 * will be reading the relation sequentially, which the kernel's
+			 * own readahead detects.  Don't spend one of our limited I/O
+			 * queue slots on it; they are better used on random accesses,
+			 * where the kernel can't predict what we'll need.
+			 */
+			if (block->blkno == prefetcher->last_blkno + 1)
+			{
+				prefetcher->last_blkno = block->blkno;
+				XLogPrefetchIncrement(&SharedStats->skip_seq);
+				continue;
+			}
+
 			/* We can avoid calling smgropen(). */
 			reln = prefetcher->last_reln;
 		}
@@ -28,6 +28,7 @@
 #include "catalog/storage.h"
 #include "catalog/storage_xlog.h"
 #include "miscadmin.h"
+#include "port/pg_iovec.h"
 #include "storage/freespace.h"
 #include "storage/smgr.h"
 #include "utils/hsearch.h"
@@ -290,6 +291,7 @@ RelationTruncate(Relation rel, BlockNumber nblocks)
 	 * Make sure smgr_targblock etc aren't pointing somewhere past new end
 	 */
 	rel->rd_smgr->smgr_targblock = InvalidBlockNumber;
+	rel->rd_smgr->smgr_fsm_leaf = InvalidBlockNumber;
 	for (int i = 0; i <= MAX_FORKNUM; ++i)
 		rel->rd_smgr->smgr_cached_nblocks[i] = InvalidBlockNumber;
 
@@ -408,14 +410,20 @@ void
 RelationCopyStorage(SMgrRelation src, SMgrRelation dst,
 					ForkNumber forkNum, char relpersistence)
 {
-	PGAlignedBlock buf;
-	Page		page;
+	char	   *buf;
+	char	   *pages[PG_IOV_MAX];
 	bool		use_wal;
 	bool		copying_initfork;
 	BlockNumber nblocks;
 	BlockNumber blkno;
 
-	page = (Page) buf.data;
+	/*
+	 * Source pages are read PG_IOV_MAX at a time, so that each batch needs
+	 * only one system call per segment.
+	 */
+	buf = palloc(PG_IOV_MAX * BLCKSZ);
+	for (int i = 0; i < PG_IOV_MAX; i++)
+		pages[i] = buf + i * BLCKSZ;
 
 	/*
 	 * The init fork for an unlogged relation in many respects has to be
@@ -436,41 +444,50 @@ RelationCopyStorage(SMgrRelation src, SMgrRelation dst,
 
 	nblocks = smgrnblocks(src, forkNum);
 
-	for (blkno = 0; blkno < nblocks; blkno++)
+	for (blkno = 0; blkno < nblocks;)
 	{
+		BlockNumber nread = Min(nblocks - blkno, PG_IOV_MAX);
+
 		/* If we got a cancel signal during the copy of the data, quit */
 		CHECK_FOR_INTERRUPTS();
 
-		smgrread(src, forkNum, blkno, buf.data);
-
-		if (!PageIsVerifiedExtended(page, blkno,
-									PIV_LOG_WARNING | PIV_REPORT_STAT))
-			ereport(ERROR,
-					(errcode(ERRCODE_DATA_CORRUPTED),
-					 errmsg("invalid page in block %u of relation %s",
-							blkno,
-							relpathbackend(src->smgr_rnode.node,
-										   src->smgr_rnode.backend,
-										   forkNum))));
-
-		/*
-		 * WAL-log the copied page. Unfortunately we don't know what kind of a
-		 * page this is, so we have to log the full page including any unused
-		 * space.
-		 */
-		if (use_wal)
-			log_newpage(&dst->smgr_rnode.node, forkNum, blkno, page, false);
+		smgrreadv(src, forkNum, blkno, pages, nread);
 
-		PageSetChecksumInplace(page, blkno);
-
-		/*
-		 * Now write the page.  We say skipFsync = true because there's no
-		 * need for smgr to schedule an fsync for this write; we'll do it
-		 * ourselves below.
-		 */
-		smgrextend(dst, forkNum, blkno, buf.data, true);
+		for (int i = 0; i < nread; i++, blkno++)
+		{
+			Page		page = (Page) pages[i];
+
+			if (!PageIsVerifiedExtended(page, blkno,
+										PIV_LOG_WARNING | PIV_REPORT_STAT))
+				ereport(ERROR,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("invalid page in block %u of relation %s",
+								blkno,
+								relpathbackend(src->smgr_rnode.node,
+											   src->smgr_rnode.backend,
+											   forkNum))));
+
+			/*
+			 * WAL-log the copied page. Unfortunately we don't know what kind
+			 * of a page this is, so we have to log the full page including
+			 * any unused space.
+			 */
+			if (use_wal)
+				log_newpage(&dst->smgr_rnode.node, forkNum, blkno, page, false);
+
+			PageSetChecksumInplace(page, blkno);
+
+			/*
+			 * Now write the page.  We say skipFsync = true because there's no
+			 * need for smgr to schedule an fsync for this write; we'll do it
+			 * ourselves below.
+			 */
+			smgrextend(dst, forkNum, blkno, (char *) page, true);
+		}
 	}
 
+	pfree(buf);
+
 	/*
 	 * When we WAL-logged rel pages, we must nonetheless fsync them.  The
 	 * reason is that since we're copying outside shared buffers, a CHECKPOINT
@@ -628,6 +628,7 @@ CREATE VIEW pg_backend_memory_contexts AS
 
 REVOKE ALL ON pg_backend_memory_contexts FROM PUBLIC;
 REVOKE EXECUTE ON FUNCTION pg_get_backend_memory_contexts() FROM PUBLIC;
+REVOKE EXECUTE ON FUNCTION pg_get_process_memory_contexts(integer) FROM PUBLIC;
 
 -- Statistics views
 
@@ -835,7 +836,8 @@ CREATE VIEW pg_stat_activity AS
             s.backend_xmin,
             S.query_id,
             S.query,
-            S.backend_type
+            S.backend_type,
+            S.allocated_bytes
     FROM pg_stat_get_activity(NULL) AS S
         LEFT JOIN pg_database AS D ON (S.datid = D.oid)
         LEFT JOIN pg_authid AS U ON (S.usesysid = U.oid);
@@ -879,6 +881,29 @@ CREATE VIEW pg_stat_slru AS
             s.stats_reset
     FROM pg_stat_get_slru() s;
 
+CREATE VIEW pg_stat_io AS
+    SELECT
+            s.backend_type,
+            s.io_object,
+            s.io_context,
+            s.reads,
+            s.read_time,
+            s.writes,
+            s.write_time,
+            s.extends,
+            s.fsyncs,
+            s.stats_reset
+    FROM pg_stat_get_io() s;
+
+CREATE VIEW pg_stat_lwlock AS
+    SELECT
+            s.tranche,
+            s.waits,
+            s.wait_time,
+            s.wait_time_histogram,
+            s.stats_reset
+    FROM pg_stat_get_lwlock() s;
+
 CREATE VIEW pg_stat_wal_receiver AS
     SELECT
             s.pid,
@@ -1236,6 +1261,24 @@ CREATE VIEW pg_stat_progress_copy AS
     FROM pg_stat_get_progress_info('COPY') AS S
         LEFT JOIN pg_database D ON S.datid = D.oid;
 
+CREATE VIEW pg_stat_progress_query AS
+    SELECT
+        S.pid AS pid, S.datid AS datid, D.datname AS datname,
+        S.param1 AS rows_processed,
+        S.param2 AS rows_scanned,
+        CASE S.param3 WHEN 1 THEN 'loading tuples'
+                      WHEN 2 THEN 'writing sorted runs'
+                      WHEN 3 THEN 'sorting'
+                      WHEN 4 THEN 'merging sorted runs'
+                      WHEN 5 THEN 'returning tuples'
+                      END AS sort_phase,
+        S.param4 AS sort_tuples,
+        S.param5 AS hash_batch,
+        S.param6 AS hash_batches,
+        S.param7 AS temp_bytes_written
+    FROM pg_stat_get_progress_info('QUERY') AS S
+        LEFT JOIN pg_database D ON S.datid = D.oid;
+
 CREATE VIEW pg_user_mappings AS
     SELECT
         U.oid       AS umid,
@@ -73,11 +73,13 @@
  *	  Finally, after we are out of the transaction altogether, we check if
  *	  we need to signal listening backends.  In SignalBackends() we scan the
  *	  list of listening backends and send a PROCSIG_NOTIFY_INTERRUPT signal
- *	  to every listening backend (we don't know which backend is listening on
- *	  which channel so we must signal them all). We can exclude backends that
- *	  are already up to date, though, and we can also exclude backends that
- *	  are in other databases (unless they are way behind and should be kicked
- *	  to make them advance their pointers).  We don't bother with a
+ *	  to every listening backend that might be listening on one of the
+ *	  channels we notified.  Each listener advertises a small bitmap of hashes
+ *	  of its channel names for this purpose; false positives just cost an
+ *	  unnecessary wakeup.  We can exclude backends that are already up to
+ *	  date, and we can also exclude backends that are in other databases or
+ *	  not interested in our channels (unless they are way behind and should
+ *	  be kicked to make them advance their pointers).  We don't bother with a
  *	  self-signal either, but just process the queue directly.
  *
  * 5. Upon receipt of a PROCSIG_NOTIFY_INTERRUPT signal, the signal handler
@@ -232,6 +234,10 @@ typedef struct QueuePosition
 
 /*
  * Struct describing a listening backend's status
+ *
+ * channels has the bit CHANNEL_MASK_BIT(name) set for every channel the
+ * backend is listening on, or is about to listen on in a transaction that is
+ * committing.  It may have additional bits set, but must never lack one.
  */
 typedef struct QueueBackendStatus
 {
@@ -239,8 +245,14 @@ typedef struct QueueBackendStatus
 	Oid			dboid;			/* backend's database OID, or InvalidOid */
 	BackendId	nextListener;	/* id of next listener, or InvalidBackendId */
 	QueuePosition pos;			/* backend has read queue up to here */
+	uint64		channels;		/* bitmap of hashed channel names */
 } QueueBackendStatus;
 
+/* Map a channel name to its bit in QueueBackendStatus.channels */
+#define CHANNEL_MASK_BIT(channel) \
+	(UINT64CONST(1) << (hash_bytes((const unsigned char *) (channel), \
+								   strlen(channel)) % 64))
+
 /*
  * Shared memory state for LISTEN/NOTIFY (excluding its SLRU stuff)
  *
@@ -294,6 +306,7 @@ static AsyncQueueControl *asyncQueueControl;
 #define QUEUE_BACKEND_DBOID(i)		(asyncQueueControl->backend[i].dboid)
 #define QUEUE_NEXT_LISTENER(i)		(asyncQueueControl->backend[i].nextListener)
 #define QUEUE_BACKEND_POS(i)		(asyncQueueControl->backend[i].pos)
+#define QUEUE_BACKEND_CHANNELS(i)	(asyncQueueControl->backend[i].channels)
 
 /*
  * The SLRU buffer area through which we access the notification queue
@@ -429,6 +442,9 @@ static bool amRegisteredListener = false;
 /* has this backend sent notifications in the current transaction? */
 static bool backendHasSentNotifications = false;
 
+/* CHANNEL_MASK_BIT of every channel we have sent notifications on */
+static uint64 backendSentChannels = 0;
+
 /* have we advanced to a page that's a multiple of QUEUE_CLEANUP_DELAY? */
 static bool backendTryAdvanceTail = false;
 
@@ -555,6 +571,7 @@ AsyncShmemInit(void)
 			QUEUE_BACKEND_DBOID(i) = InvalidOid;
 			QUEUE_NEXT_LISTENER(i) = InvalidBackendId;
 			SET_QUEUE_POS(QUEUE_BACKEND_POS(i), 0, 0);
+			QUEUE_BACKEND_CHANNELS(i) = 0;
 		}
 	}
 
@@ -888,6 +905,7 @@ void
 PreCommit_Notify(void)
 {
 	ListCell   *p;
+	uint64		listenChannelBits = 0;
 
 	if (!pendingActions && !pendingNotifies)
 		return;					/* no relevant statements in this xact */
@@ -906,6 +924,7 @@ PreCommit_Notify(void)
 			{
 				case LISTEN_LISTEN:
 					Exec_ListenPreCommit();
+					listenChannelBits |= CHANNEL_MASK_BIT(actrec->channel);
 					break;
 				case LISTEN_UNLISTEN:
 					/* there is no Exec_UnlistenPreCommit() */
@@ -915,6 +934,17 @@ PreCommit_Notify(void)
 					break;
 			}
 		}
+
+		/*
+		 * Advertise the new channels before we commit, so that anyone who
+		 * commits a NOTIFY on them after us is sure to signal us.
+		 */
+		if (listenChannelBits != 0)
+		{
+			LWLockAcquire(NotifyQueueLock, LW_EXCLUSIVE);
+			QUEUE_BACKEND_CHANNELS(MyBackendId) |= listenChannelBits;
+			LWLockRelease(NotifyQueueLock);
+		}
 	}
 
 	/* Queue any pending notifies (must happen after the above) */
@@ -952,6 +982,13 @@ PreCommit_Notify(void)
 		/* Now push the notifications into the queue */
 		backendHasSentNotifications = true;
 
+		foreach(p, pendingNotifies->events)
+		{
+			Notification *n = (Notification *) lfirst(p);
+
+			backendSentChannels |= CHANNEL_MASK_BIT(n->data);
+		}
+
 		nextNotify = list_head(pendingNotifies->events);
 		while (nextNotify != NULL)
 		{
@@ -1026,6 +1063,18 @@ AtCommit_Notify(void)
 	/* If no longer listening to anything, get out of listener array */
 	if (amRegisteredListener && listenChannels == NIL)
 		asyncQueueUnregister();
+	else if (amRegisteredListener && pendingActions != NULL)
+	{
+		uint64		channelBits = 0;
+
+		/* Stop advertising channels we have unlistened */
+		foreach(p, listenChannels)
+			channelBits |= CHANNEL_MASK_BIT((char *) lfirst(p));
+
+		LWLockAcquire(NotifyQueueLock, LW_EXCLUSIVE);
+		QUEUE_BACKEND_CHANNELS(MyBackendId) = channelBits;
+		LWLockRelease(NotifyQueueLock);
+	}
 
 	/* And clean up */
 	ClearPendingActionsAndNotifies();
@@ -1098,6 +1147,7 @@ Exec_ListenPreCommit(void)
 	QUEUE_BACKEND_POS(MyBackendId) = max;
 	QUEUE_BACKEND_PID(MyBackendId) = MyProcPid;
 	QUEUE_BACKEND_DBOID(MyBackendId) = MyDatabaseId;
+	QUEUE_BACKEND_CHANNELS(MyBackendId) = 0;
 	/* Insert backend into list of listeners at correct position */
 	if (prevListener > 0)
 	{
@@ -1320,6 +1370,7 @@ asyncQueueUnregister(void)
 	/* Mark our entry as invalid */
 	QUEUE_BACKEND_PID(MyBackendId) = InvalidPid;
 	QUEUE_BACKEND_DBOID(MyBackendId) = InvalidOid;
+	QUEUE_BACKEND_CHANNELS(MyBackendId) = 0;
 	/* and remove it from the list */
 	if (QUEUE_FIRST_LISTENER == MyBackendId)
 		QUEUE_FIRST_LISTENER = QUEUE_NEXT_LISTENER(MyBackendId);
@@ -1660,12 +1711,13 @@ asyncQueueFillWarning(void)
  *
  * We never signal our own process; that should be handled by our caller.
  *
- * Normally we signal only backends in our own database, since only those
- * backends could be interested in notifies we send.  However, if there's
- * notify traffic in our database but no traffic in another database that
- * does have listener(s), those listeners will fall further and further
- * behind.  Waken them anyway if they're far enough behind, so that they'll
- * advance their queue position pointers, allowing the global tail to advance.
+ * Normally we signal only backends in our own database whose channel bitmap
+ * overlaps the channels we sent notifies on, since only those backends could
+ * be interested in them.  However, if there's notify traffic in our database
+ * but no traffic of interest to some other listener(s), those listeners will
+ * fall further and further behind.  Waken them anyway if they're far enough
+ * behind, so that they'll advance their queue position pointers, allowing the
+ * global tail to advance.
  *
  * Since we know the BackendId and the Pid the signaling is quite cheap.
  */
@@ -1675,6 +1727,7 @@ SignalBackends(void)
 	int32	   *pids;
 	BackendId  *ids;
 	int			count;
+	uint64		channels = backendSentChannels;
 
 	/*
 	 * Identify backends that we need to signal.  We don't want to send
@@ -1688,6 +1741,7 @@ SignalBackends(void)
 	pids = (int32 *) palloc(MaxBackends * sizeof(int32));
 	ids = (BackendId *) palloc(MaxBackends * sizeof(BackendId));
 	count = 0;
+	backendSentChannels = 0;
 
 	LWLockAcquire(NotifyQueueLock, LW_EXCLUSIVE);
 	for (BackendId i = QUEUE_FIRST_LISTENER; i > 0; i = QUEUE_NEXT_LISTENER(i))
@@ -1699,11 +1753,13 @@ SignalBackends(void)
 		if (pid == MyProcPid)
 			continue;			/* never signal self */
 		pos = QUEUE_BACKEND_POS(i);
-		if (QUEUE_BACKEND_DBOID(i) == MyDatabaseId)
+		if (QUEUE_BACKEND_DBOID(i) == MyDatabaseId &&
+			(QUEUE_BACKEND_CHANNELS(i) & channels) != 0)
 		{
 			/*
-			 * Always signal listeners in our own database, unless they're
-			 * already caught up (unlikely, but possible).
+			 * Always signal listeners in our own database that may be
+			 * listening on one of our channels, unless they're already caught
+			 * up (unlikely, but possible).
 			 */
 			if (QUEUE_POS_EQUAL(pos, QUEUE_HEAD))
 				continue;
@@ -1711,8 +1767,8 @@ SignalBackends(void)
 		else
 		{
 			/*
-			 * Listeners in other databases should be signaled only if they
-			 * are far behind.
+			 * Listeners in other databases, or not interested in what we
+			 * sent, should be signaled only if they are far behind.
 			 */
 			if (asyncQueuePageDiff(QUEUE_POS_PAGE(QUEUE_HEAD),
 								   QUEUE_POS_PAGE(pos)) < QUEUE_CLEANUP_DELAY)
@@ -41,6 +41,76 @@
 #include "utils/rel.h"
 #include "utils/rls.h"
 
+/*
+ * COPY formats registered by extensions, see RegisterCopyFormat().
+ */
+static List *copy_formats = NIL;
+
+static const CopyFormatRoutine *GetCopyFormat(const char *name);
+
+/*
+ * Register a COPY format.  This is meant to be called from an extension's
+ * _PG_init function; the routine struct must stay valid for the life of the
+ * process.
+ */
+void
+RegisterCopyFormat(const CopyFormatRoutine *routine)
+{
+	MemoryContext oldcontext;
+
+	if (strcmp(routine->name, "text") == 0 ||
+		strcmp(routine->name, "csv") == 0 ||
+		strcmp(routine->name, "binary") == 0 ||
+		GetCopyFormat(routine->name) != NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_DUPLICATE_OBJECT),
+				 errmsg("COPY format \"%s\" already exists", routine->name)));
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	copy_formats = lappend(copy_formats, (void *) routine);
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * Look up a registered COPY format by name; returns NULL if there is none.
+ */
+static const CopyFormatRoutine *
+GetCopyFormat(const char *name)
+{
+	ListCell   *lc;
+
+	foreach(lc, copy_formats)
+	{
+		const CopyFormatRoutine *routine = lfirst(lc);
+
+		if (strcmp(routine->name, name) == 0)
+			return routine;
+	}
+
+	return NULL;
+}
+
+/*
+ * Does the option list of a COPY statement ask for PARALLEL?  DoCopy needs
+ * to know before ProcessCopyOptions() gets to look at the options, which
+ * will complain about any problems with them.
+ */
+static bool
+CopyParallelRequested(List *options)
+{
+	ListCell   *option;
+
+	foreach(option, options)
+	{
+		DefElem    *defel = lfirst_node(DefElem, option);
+
+		if (strcmp(defel->defname, "parallel") == 0)
+			return defGetBoolean(defel);
+	}
+
+	return false;
+}
+
 /*
  *	 DoCopy executes the SQL COPY statement
  *
@@ -113,6 +183,7 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 		TupleDesc	tupDesc;
 		List	   *attnums;
 		ListCell   *cur;
+		bool		rls_enabled;
 
 		Assert(!stmt->query);
 
@@ -121,6 +192,18 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 
 		relid = RelationGetRelid(rel);
 
+		/*
+		 * PARALLEL turns the COPY into a query, below, which would bypass the
+		 * checks COPY TO makes on the other kinds of relations.
+		 */
+		if (!is_from && rel->rd_rel->relkind != RELKIND_RELATION &&
+			CopyParallelRequested(stmt->options))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("cannot use COPY PARALLEL with relation \"%s\"",
+							RelationGetRelationName(rel)),
+					 errdetail("COPY PARALLEL is only supported for plain tables.")));
+
 		nsitem = addRangeTableEntryForRelation(pstate, rel, lockmode,
 											   NULL, false, false);
 		rte = nsitem->p_rte;
@@ -171,16 +254,24 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 		 * then perform a "query" copy and allow the normal query processing
 		 * to handle the policies.
 		 *
-		 * If RLS is not enabled for this, then just fall through to the
-		 * normal non-filtering relation handling.
+		 * We do the same for a COPY TO of a plain table with the PARALLEL
+		 * option, so that the planner can choose a parallel scan.  The rows
+		 * then come out in no particular order.
+		 *
+		 * Otherwise just fall through to the normal non-filtering relation
+		 * handling.
 		 */
-		if (check_enable_rls(rte->relid, InvalidOid, false) == RLS_ENABLED)
+		rls_enabled = (check_enable_rls(rte->relid, InvalidOid, false) == RLS_ENABLED);
+		if (rls_enabled ||
+			(!is_from && rel->rd_rel->relkind == RELKIND_RELATION &&
+			 CopyParallelRequested(stmt->options)))
 		{
 			SelectStmt *select;
 			ColumnRef  *cr;
 			ResTarget  *target;
 			RangeVar   *from;
 			List	   *targetList = NIL;
+			List	   *colnames = stmt->attlist;
 
 			if (is_from)
 				ereport(ERROR,
@@ -199,8 +290,23 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 			 * In the case that columns are specified in the attribute list,
 			 * create a ColumnRef and ResTarget for each column and add them
 			 * to the target list for the resulting SELECT statement.
+			 *
+			 * For PARALLEL, we rather list the columns that the plain COPY TO
+			 * would have copied, since '*' includes generated columns.
 			 */
-			if (!stmt->attlist)
+			if (!rls_enabled && colnames == NIL)
+			{
+				foreach(cur, attnums)
+				{
+					Form_pg_attribute att = TupleDescAttr(tupDesc,
+														  lfirst_int(cur) - 1);
+
+					colnames = lappend(colnames,
+									   makeString(pstrdup(NameStr(att->attname))));
+				}
+			}
+
+			if (colnames == NIL)
 			{
 				cr = makeNode(ColumnRef);
 				cr->fields = list_make1(makeNode(A_Star));
@@ -218,7 +324,7 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 			{
 				ListCell   *lc;
 
-				foreach(lc, stmt->attlist)
+				foreach(lc, colnames)
 				{
 					/*
 					 * Build the ColumnRef for each column.  The ColumnRef
@@ -250,6 +356,9 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 								pstrdup(RelationGetRelationName(rel)),
 								-1);
 
+			/* Like COPY TO of the relation itself, don't scan its children */
+			from->inh = false;
+
 			/* Build query */
 			select = makeNode(SelectStmt);
 			select->targetList = targetList;
@@ -339,6 +448,7 @@ ProcessCopyOptions(ParseState *pstate,
 	bool		format_specified = false;
 	bool		freeze_specified = false;
 	bool		header_specified = false;
+	bool		parallel_specified = false;
 	ListCell   *option;
 
 	/* Support external use for option sanity checking */
@@ -368,6 +478,10 @@ ProcessCopyOptions(ParseState *pstate,
 				opts_out->csv_mode = true;
 			else if (strcmp(fmt, "binary") == 0)
 				opts_out->binary = true;
+			else if ((opts_out->routine = GetCopyFormat(fmt)) != NULL)
+			{
+				/* format provided by an extension */
+			}
 			else
 				ereport(ERROR,
 						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -384,6 +498,16 @@ ProcessCopyOptions(ParseState *pstate,
 			freeze_specified = true;
 			opts_out->freeze = defGetBoolean(defel);
 		}
+		else if (strcmp(defel->defname, "parallel") == 0)
+		{
+			if (parallel_specified)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("conflicting or redundant options"),
+						 parser_errposition(pstate, defel->location)));
+			parallel_specified = true;
+			opts_out->parallel = defGetBoolean(defel);
+		}
 		else if (strcmp(defel->defname, "delimiter") == 0)
 		{
 			if (opts_out->delim)
@@ -538,6 +662,27 @@ ProcessCopyOptions(ParseState *pstate,
 				(errcode(ERRCODE_SYNTAX_ERROR),
 				 errmsg("cannot specify NULL in BINARY mode")));
 
+	if (opts_out->routine)
+	{
+		if (opts_out->delim)
+			ereport(ERROR,
+					(errcode(ERRCODE_SYNTAX_ERROR),
+					 errmsg("cannot specify DELIMITER in COPY format \"%s\"",
+							opts_out->routine->name)));
+		if (opts_out->null_print)
+			ereport(ERROR,
+					(errcode(ERRCODE_SYNTAX_ERROR),
+					 errmsg("cannot specify NULL in COPY format \"%s\"",
+							opts_out->routine->name)));
+		if (is_from ? opts_out->routine->copy_from_start == NULL :
+			opts_out->routine->copy_to_start == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("COPY format \"%s\" cannot be used with COPY %s",
+							opts_out->routine->name,
+							is_from ? "FROM" : "TO")));
+	}
+
 	/* Set defaults for omitted options */
 	if (!opts_out->delim)
 		opts_out->delim = opts_out->csv_mode ? "," : "\t";
@@ -654,6 +799,12 @@ ProcessCopyOptions(ParseState *pstate,
 				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
 				 errmsg("COPY force null only available using COPY FROM")));
 
+	/* Check parallel */
+	if (opts_out->parallel && is_from)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("COPY parallel only available using COPY TO")));
+
 	/* Don't allow the delimiter to appear in the null string. */
 	if (strchr(opts_out->null_print, opts_out->delim[0]) != NULL)
 		ereport(ERROR,
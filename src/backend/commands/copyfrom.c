@@ -120,7 +120,7 @@ CopyFromErrorCallback(void *arg)
 	snprintf(curlineno_str, sizeof(curlineno_str), UINT64_FORMAT,
 			 cstate->cur_lineno);
 
-	if (cstate->opts.binary)
+	if (cstate->opts.binary || cstate->opts.routine)
 	{
 		/* can't usefully display the data */
 		if (cstate->cur_attname)
@@ -1361,7 +1361,7 @@ BeginCopyFrom(ParseState *pstate,
 	cstate->raw_buf_index = cstate->raw_buf_len = 0;
 	cstate->raw_reached_eof = false;
 
-	if (!cstate->opts.binary)
+	if (!cstate->opts.binary && !cstate->opts.routine)
 	{
 		/*
 		 * If encoding conversion is needed, we need another buffer to hold
@@ -1543,8 +1543,14 @@ BeginCopyFrom(ParseState *pstate,
 		ReceiveCopyBinaryHeader(cstate);
 	}
 
+	/* Let an extension-provided format read its header, if it has one */
+	if (cstate->opts.routine)
+		cstate->format_state =
+			cstate->opts.routine->copy_from_start(cstate, tupDesc,
+												  cstate->attnumlist);
+
 	/* create workspace for CopyReadAttributes results */
-	if (!cstate->opts.binary)
+	if (!cstate->opts.binary && !cstate->opts.routine)
 	{
 		AttrNumber	attr_count = list_length(cstate->attnumlist);
 
@@ -1563,6 +1569,9 @@ BeginCopyFrom(ParseState *pstate,
 void
 EndCopyFrom(CopyFromState cstate)
 {
+	if (cstate->opts.routine && cstate->opts.routine->copy_from_end)
+		cstate->opts.routine->copy_from_end(cstate, cstate->format_state);
+
 	/* No COPY FROM related resources except memory. */
 	if (cstate->is_program)
 	{
@@ -72,6 +72,7 @@
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "port/pg_bswap.h"
+#include "port/simd.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 
@@ -170,7 +171,7 @@ ReceiveCopyBegin(CopyFromState cstate)
 {
 	StringInfoData buf;
 	int			natts = list_length(cstate->attnumlist);
-	int16		format = (cstate->opts.binary ? 1 : 0);
+	int16		format = ((cstate->opts.binary || cstate->opts.routine) ? 1 : 0);
 	int			i;
 
 	pq_beginmessage(&buf, 'G');
@@ -738,6 +739,18 @@ CopyReadBinaryData(CopyFromState cstate, char *dest, int nbytes)
 	return copied_bytes;
 }
 
+/*
+ * CopyFromReadData
+ *
+ * Reads input for a COPY FROM that uses a format provided by an extension,
+ * like CopyReadBinaryData.
+ */
+int
+CopyFromReadData(CopyFromState cstate, void *dest, int nbytes)
+{
+	return CopyReadBinaryData(cstate, (char *) dest, nbytes);
+}
+
 /*
  * Read raw fields in the next line for COPY FROM in text or csv mode.
  * Return false if no more lines.
@@ -822,7 +835,17 @@ NextCopyFrom(CopyFromState cstate, ExprContext *econtext,
 	MemSet(values, 0, num_phys_attrs * sizeof(Datum));
 	MemSet(nulls, true, num_phys_attrs * sizeof(bool));
 
-	if (!cstate->opts.binary)
+	if (cstate->opts.routine)
+	{
+		/* format provided by an extension */
+		cstate->cur_lineno++;
+
+		if (!cstate->opts.routine->copy_from_one_row(cstate,
+													 cstate->format_state,
+													 values, nulls))
+			return false;
+	}
+	else if (!cstate->opts.binary)
 	{
 		char	  **field_strings;
 		ListCell   *cur;
@@ -1121,6 +1144,7 @@ CopyReadLineText(CopyFromState cstate)
 	for (;;)
 	{
 		int			prev_raw_ptr;
+		int			skip_start;
 		char		c;
 
 		/*
@@ -1155,6 +1179,46 @@ CopyReadLineText(CopyFromState cstate)
 			need_data = false;
 		}
 
+		/*
+		 * Most bytes of a line need no attention at all.  Skip quickly over
+		 * anything but newlines, backslashes and the CSV quote and escape
+		 * characters; they can neither end the line nor change the CSV
+		 * state, except that nothing after them is first in the line or
+		 * follows an escape.  Whole vectors of such bytes are skipped at
+		 * once, the rest a byte at a time.
+		 */
+		skip_start = input_buf_ptr;
+		while (input_buf_ptr + (int) sizeof(Vector8) <= copy_buf_len)
+		{
+			Vector8		chunk;
+
+			vector8_load(&chunk, (const uint8 *) &copy_input_buf[input_buf_ptr]);
+			if (vector8_has(chunk, '\n') || vector8_has(chunk, '\r') ||
+				vector8_has(chunk, '\\') || vector8_has(chunk, quotec) ||
+				vector8_has(chunk, escapec))
+				break;
+			input_buf_ptr += sizeof(Vector8);
+		}
+		while (input_buf_ptr < copy_buf_len)
+		{
+			c = copy_input_buf[input_buf_ptr];
+
+			if (c == '\n' || c == '\r' || c == '\\' ||
+				c == quotec || c == escapec)
+				break;
+			input_buf_ptr++;
+		}
+
+		if (input_buf_ptr > skip_start)
+		{
+			first_char_in_line = false;
+			last_was_esc = false;
+
+			/* go back to loop top to load more data, if we used it all */
+			if (input_buf_ptr >= copy_buf_len)
+				continue;
+		}
+
 		/* OK to fetch a character */
 		prev_raw_ptr = input_buf_ptr;
 		c = copy_input_buf[input_buf_ptr++];
@@ -1506,6 +1570,19 @@ CopyReadAttributesText(CopyFromState cstate)
 		{
 			char		c;
 
+			/* copy vectors free of delimiters and backslashes in bulk */
+			while (cur_ptr + sizeof(Vector8) <= line_end_ptr)
+			{
+				Vector8		chunk;
+
+				vector8_load(&chunk, (const uint8 *) cur_ptr);
+				if (vector8_has(chunk, delimc) || vector8_has(chunk, '\\'))
+					break;
+				memcpy(output_ptr, cur_ptr, sizeof(Vector8));
+				output_ptr += sizeof(Vector8);
+				cur_ptr += sizeof(Vector8);
+			}
+
 			end_ptr = cur_ptr;
 			if (cur_ptr >= line_end_ptr)
 				break;
@@ -1735,6 +1812,19 @@ CopyReadAttributesCSV(CopyFromState cstate)
 			/* Not in quote */
 			for (;;)
 			{
+				/* copy vectors free of delimiters and quotes in bulk */
+				while (cur_ptr + sizeof(Vector8) <= line_end_ptr)
+				{
+					Vector8		chunk;
+
+					vector8_load(&chunk, (const uint8 *) cur_ptr);
+					if (vector8_has(chunk, delimc) || vector8_has(chunk, quotec))
+						break;
+					memcpy(output_ptr, cur_ptr, sizeof(Vector8));
+					output_ptr += sizeof(Vector8);
+					cur_ptr += sizeof(Vector8);
+				}
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					goto endfield;
@@ -1758,6 +1848,19 @@ CopyReadAttributesCSV(CopyFromState cstate)
 			/* In quote */
 			for (;;)
 			{
+				/* copy vectors free of escapes and quotes in bulk */
+				while (cur_ptr + sizeof(Vector8) <= line_end_ptr)
+				{
+					Vector8		chunk;
+
+					vector8_load(&chunk, (const uint8 *) cur_ptr);
+					if (vector8_has(chunk, escapec) || vector8_has(chunk, quotec))
+						break;
+					memcpy(output_ptr, cur_ptr, sizeof(Vector8));
+					output_ptr += sizeof(Vector8);
+					cur_ptr += sizeof(Vector8);
+				}
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					ereport(ERROR,
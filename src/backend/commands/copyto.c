@@ -97,6 +97,7 @@ typedef struct CopyToStateData
 	FmgrInfo   *out_functions;	/* lookup info for output functions */
 	MemoryContext rowcontext;	/* per-row evaluation context */
 	uint64		bytes_processed;	/* number of bytes processed so far */
+	void	   *format_state;	/* private state of opts.routine, if any */
 
 } CopyToStateData;
 
@@ -140,7 +141,7 @@ SendCopyBegin(CopyToState cstate)
 {
 	StringInfoData buf;
 	int			natts = list_length(cstate->attnumlist);
-	int16		format = (cstate->opts.binary ? 1 : 0);
+	int16		format = ((cstate->opts.binary || cstate->opts.routine) ? 1 : 0);
 	int			i;
 
 	pq_beginmessage(&buf, 'H');
@@ -197,7 +198,7 @@ CopySendEndOfRow(CopyToState cstate)
 	switch (cstate->copy_dest)
 	{
 		case COPY_FILE:
-			if (!cstate->opts.binary)
+			if (!cstate->opts.binary && !cstate->opts.routine)
 			{
 				/* Default line termination depends on platform */
 #ifndef WIN32
@@ -242,7 +243,7 @@ CopySendEndOfRow(CopyToState cstate)
 			break;
 		case COPY_FRONTEND:
 			/* The FE/BE protocol uses \n as newline for all platforms */
-			if (!cstate->opts.binary)
+			if (!cstate->opts.binary && !cstate->opts.routine)
 				CopySendChar(cstate, '\n');
 
 			/* Dump the accumulated row as one CopyData message */
@@ -261,6 +262,17 @@ CopySendEndOfRow(CopyToState cstate)
  * These functions do apply some data conversion
  */
 
+/*
+ * CopyToSendData appends data to the output of a COPY TO that uses a format
+ * provided by an extension.  The data is sent, or written to the file, once
+ * the format's callback returns.
+ */
+void
+CopyToSendData(CopyToState cstate, const void *databuf, int datasize)
+{
+	CopySendData(cstate, databuf, datasize);
+}
+
 /*
  * CopySendInt32 sends an int32 in network byte order
  */
@@ -828,7 +840,16 @@ DoCopyTo(CopyToState cstate)
 											   "COPY TO",
 											   ALLOCSET_DEFAULT_SIZES);
 
-	if (cstate->opts.binary)
+	if (cstate->opts.routine)
+	{
+		/* Let the format write its header, if it has one */
+		cstate->format_state =
+			cstate->opts.routine->copy_to_start(cstate, tupDesc,
+												cstate->attnumlist);
+		if (cstate->fe_msgbuf->len > 0)
+			CopySendEndOfRow(cstate);
+	}
+	else if (cstate->opts.binary)
 	{
 		/* Generate header for a binary copy */
 		int32		tmp;
@@ -914,7 +935,15 @@ DoCopyTo(CopyToState cstate)
 		processed = ((DR_copy *) cstate->queryDesc->dest)->processed;
 	}
 
-	if (cstate->opts.binary)
+	if (cstate->opts.routine)
+	{
+		/* Let the format write out what it has kept back, and a trailer */
+		if (cstate->opts.routine->copy_to_end)
+			cstate->opts.routine->copy_to_end(cstate, cstate->format_state);
+		if (cstate->fe_msgbuf->len > 0)
+			CopySendEndOfRow(cstate);
+	}
+	else if (cstate->opts.binary)
 	{
 		/* Generate trailer for a binary copy */
 		CopySendInt16(cstate, -1);
@@ -945,6 +974,19 @@ CopyOneRowTo(CopyToState cstate, TupleTableSlot *slot)
 	MemoryContextReset(cstate->rowcontext);
 	oldcontext = MemoryContextSwitchTo(cstate->rowcontext);
 
+	if (cstate->opts.routine)
+	{
+		/* The format may keep the row back, so only flush what it wrote */
+		slot_getallattrs(slot);
+		cstate->opts.routine->copy_to_one_row(cstate, cstate->format_state,
+											  slot);
+		if (cstate->fe_msgbuf->len > 0)
+			CopySendEndOfRow(cstate);
+
+		MemoryContextSwitchTo(oldcontext);
+		return;
+	}
+
 	if (cstate->opts.binary)
 	{
 		/* Binary per-tuple header */
@@ -52,8 +52,9 @@
  * We don't want to log each fetching of a value from a sequence,
  * so we pre-log a few fetches in advance. In the event of
  * crash we can lose (skip over) as many values as we pre-logged.
+ * How many is set by the sequence_log_values GUC.
  */
-#define SEQ_LOG_VALS	32
+int			sequence_log_values = 32;
 
 /*
  * The "special area" of a sequence's buffer page looks like this.
@@ -659,8 +660,8 @@ nextval_internal(Oid relid, bool check_permissions)
 
 	/*
 	 * Decide whether we should emit a WAL log record.  If so, force up the
-	 * fetch count to grab SEQ_LOG_VALS more values than we actually need to
-	 * cache.  (These will then be usable without logging.)
+	 * fetch count to grab sequence_log_values more values than we actually
+	 * need to cache.  (These will then be usable without logging.)
 	 *
 	 * If this is the first nextval after a checkpoint, we must force a new
 	 * WAL record to be written anyway, else replay starting from the
@@ -670,7 +671,7 @@ nextval_internal(Oid relid, bool check_permissions)
 	if (log < fetch || !seq->is_called)
 	{
 		/* forced log to satisfy local demand for values */
-		fetch = log = fetch + SEQ_LOG_VALS;
+		fetch = log = fetch + sequence_log_values;
 		logit = true;
 	}
 	else
@@ -680,7 +681,7 @@ nextval_internal(Oid relid, bool check_permissions)
 		if (PageGetLSN(page) <= redoptr)
 		{
 			/* last update of seq was before checkpoint */
-			fetch = log = fetch + SEQ_LOG_VALS;
+			fetch = log = fetch + sequence_log_values;
 			logit = true;
 		}
 	}
@@ -17,6 +17,7 @@
 #include "access/parallel.h"
 #include "common/hashfn.h"
 #include "executor/executor.h"
+#include "executor/hashdatum.h"
 #include "miscadmin.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
@@ -466,9 +467,8 @@ TupleHashTableHash_internal(struct tuplehash_hash *tb,
 		{
 			uint32		hkey;
 
-			hkey = DatumGetUInt32(FunctionCall1Coll(&hashfunctions[i],
-													hashtable->tab_collations[i],
-													attr));
+			hkey = ExecHashDatum(&hashfunctions[i],
+								 hashtable->tab_collations[i], attr);
 			hashkey ^= hkey;
 		}
 	}
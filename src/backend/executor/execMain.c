@@ -354,10 +354,15 @@ standard_ExecutorRun(QueryDesc *queryDesc,
 	 */
 	if (!ScanDirectionIsNoMovement(direction))
 	{
+		bool		report_progress;
+
 		if (execute_once && queryDesc->already_executed)
 			elog(ERROR, "can't re-execute query flagged for single execution");
 		queryDesc->already_executed = true;
 
+		/* Report progress in pg_stat_progress_query, if enabled */
+		report_progress = pgstat_progress_start_query(&estate->es_processed);
+
 		ExecutePlan(estate,
 					queryDesc->planstate,
 					queryDesc->plannedstmt->parallelModeNeeded,
@@ -367,6 +372,9 @@ standard_ExecutorRun(QueryDesc *queryDesc,
 					direction,
 					dest,
 					execute_once);
+
+		if (report_progress)
+			pgstat_progress_end_query();
 	}
 
 	/*
@@ -24,11 +24,13 @@
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
+#include "nodes/nodeFuncs.h"
 #include "partitioning/partbounds.h"
 #include "partitioning/partdesc.h"
 #include "partitioning/partprune.h"
 #include "rewrite/rewriteManip.h"
 #include "utils/acl.h"
+#include "utils/datum.h"
 #include "utils/lsyscache.h"
 #include "utils/partcache.h"
 #include "utils/rls.h"
@@ -140,6 +142,11 @@ struct PartitionTupleRouting
  *		the index corresponds to the PartitionDispatch for it in its
  *		partition_dispatch_info array.  -1 indicates we've not yet allocated
  *		anything in PartitionTupleRouting for the partition.
+ *
+ * last_bound_offset, last_bound_count
+ *		The bound offset that get_partition_for_tuple() found for the last
+ *		tuple of a list or range partitioned table, and how many consecutive
+ *		tuples it has found it for.  See PARTITION_CACHED_FIND_THRESHOLD.
  *-----------------------
  */
 typedef struct PartitionDispatchData
@@ -150,9 +157,43 @@ typedef struct PartitionDispatchData
 	PartitionDesc partdesc;
 	TupleTableSlot *tupslot;
 	AttrMap    *tupmap;
+	int			last_bound_offset;
+	int			last_bound_count;
 	int			indexes[FLEXIBLE_ARRAY_MEMBER];
 }			PartitionDispatchData;
 
+/*
+ * PartitionPruneResultCache
+ *
+ * When a plan node is rescanned, as the inner side of a nested loop is, its
+ * run-time pruning must be redone whenever any of its Params is assigned,
+ * although often with the same values as before, e.g. when the outer side
+ * is sorted on the join key.  This remembers the values the last pruning was
+ * done for, and its result, to save pruning again for the same values.
+ */
+typedef struct PartitionPruneResultCache
+{
+	MemoryContext mcxt;			/* where to keep the values and result */
+	ParamExecData *params;		/* the executor's PARAM_EXEC values */
+	int			nparams;		/* number of Params pruning depends on */
+	int		   *paramids;		/* their IDs */
+	int16	   *typlen;			/* their types' properties */
+	bool	   *typbyval;
+	Datum	   *values;			/* their values for the cached result */
+	bool	   *isnull;
+	bool		valid;			/* is the cached result valid? */
+	Bitmapset  *result;			/* result of ExecFindMatchingSubPlans */
+} PartitionPruneResultCache;
+
+/*
+ * Once this many consecutive tuples have been routed through the same bound,
+ * as happens when loading data in the order of the partition key,
+ * get_partition_for_tuple() checks that bound before falling back to a
+ * binary search.  Waiting for a run of hits keeps the extra comparisons from
+ * slowing down the routing of tuples that arrive in random order.
+ */
+#define PARTITION_CACHED_FIND_THRESHOLD	16
+
 
 static ResultRelInfo *ExecInitPartitionInfo(ModifyTableState *mtstate,
 											EState *estate, PartitionTupleRouting *proute,
@@ -182,6 +223,13 @@ static char *ExecBuildSlotPartitionKeyDescription(Relation rel,
 												  bool *isnull,
 												  int maxfieldlen);
 static List *adjust_partition_tlist(List *tlist, TupleConversionMap *map);
+static bool collect_exec_params_walker(Node *node, List **params);
+static PartitionPruneResultCache *ExecInitPruneResultCache(PartitionPruneState *prunestate,
+														   List *params,
+														   EState *estate);
+static bool ExecPruneResultCacheMatches(PartitionPruneResultCache *cache);
+static void ExecPruneResultCacheStore(PartitionPruneResultCache *cache,
+									  Bitmapset *result);
 static void ExecInitPruningContext(PartitionPruneContext *context,
 								   List *pruning_steps,
 								   PartitionDesc partdesc,
@@ -1021,6 +1069,8 @@ ExecInitPartitionDispatchInfo(EState *estate,
 	pd->key = RelationGetPartitionKey(rel);
 	pd->keystate = NIL;
 	pd->partdesc = partdesc;
+	pd->last_bound_offset = -1;
+	pd->last_bound_count = 0;
 	if (parent_pd != NULL)
 	{
 		TupleDesc	tupdesc = RelationGetDescr(rel);
@@ -1226,6 +1276,26 @@ FormPartitionKeyDatum(PartitionDispatch pd,
 		elog(ERROR, "wrong number of partition key expressions");
 }
 
+/*
+ * remember_bound_offset
+ *		Count consecutive tuples routed through the same bound, for
+ *		get_partition_for_tuple()
+ */
+static inline void
+remember_bound_offset(PartitionDispatch pd, int bound_offset)
+{
+	if (bound_offset == pd->last_bound_offset)
+	{
+		if (pd->last_bound_count < PARTITION_CACHED_FIND_THRESHOLD)
+			pd->last_bound_count++;
+	}
+	else
+	{
+		pd->last_bound_offset = bound_offset;
+		pd->last_bound_count = 1;
+	}
+}
+
 /*
  * get_partition_for_tuple
  *		Finds partition of relation which accepts the partition key specified
@@ -1269,12 +1339,31 @@ get_partition_for_tuple(PartitionDispatch pd, Datum *values, bool *isnull)
 			{
 				bool		equal = false;
 
+				/* Try the bound the last tuples matched, if warranted */
+				if (pd->last_bound_count >= PARTITION_CACHED_FIND_THRESHOLD)
+				{
+					bound_offset = pd->last_bound_offset;
+					if (DatumGetInt32(FunctionCall2Coll(&key->partsupfunc[0],
+														key->partcollation[0],
+														boundinfo->datums[bound_offset][0],
+														values[0])) == 0)
+					{
+						part_index = boundinfo->indexes[bound_offset];
+						break;
+					}
+				}
+
 				bound_offset = partition_list_bsearch(key->partsupfunc,
 													  key->partcollation,
 													  boundinfo,
 													  values[0], &equal);
 				if (bound_offset >= 0 && equal)
+				{
 					part_index = boundinfo->indexes[bound_offset];
+					remember_bound_offset(pd, bound_offset);
+				}
+				else
+					pd->last_bound_count = 0;
 			}
 			break;
 
@@ -1299,6 +1388,30 @@ get_partition_for_tuple(PartitionDispatch pd, Datum *values, bool *isnull)
 
 				if (!range_partkey_has_null)
 				{
+					/* Try the range the last tuples fell in, if warranted */
+					if (pd->last_bound_count >= PARTITION_CACHED_FIND_THRESHOLD)
+					{
+						bound_offset = pd->last_bound_offset;
+						if ((bound_offset < 0 ||
+							 partition_rbound_datum_cmp(key->partsupfunc,
+														key->partcollation,
+														boundinfo->datums[bound_offset],
+														boundinfo->kind[bound_offset],
+														values,
+														key->partnatts) <= 0) &&
+							(bound_offset + 1 >= boundinfo->ndatums ||
+							 partition_rbound_datum_cmp(key->partsupfunc,
+														key->partcollation,
+														boundinfo->datums[bound_offset + 1],
+														boundinfo->kind[bound_offset + 1],
+														values,
+														key->partnatts) > 0))
+						{
+							part_index = boundinfo->indexes[bound_offset + 1];
+							break;
+						}
+					}
+
 					bound_offset = partition_range_datum_bsearch(key->partsupfunc,
 																 key->partcollation,
 																 boundinfo,
@@ -1313,6 +1426,7 @@ get_partition_for_tuple(PartitionDispatch pd, Datum *values, bool *isnull)
 					 * actually exists one.
 					 */
 					part_index = boundinfo->indexes[bound_offset + 1];
+					remember_bound_offset(pd, bound_offset);
 				}
 			}
 			break;
@@ -1567,6 +1681,7 @@ ExecCreatePartitionPruneState(PlanState *planstate,
 	int			n_part_hierarchies;
 	ListCell   *lc;
 	int			i;
+	List	   *exec_params = NIL;
 
 	/* For data reading, executor always omits detached partitions */
 	if (estate->es_partition_directory == NULL)
@@ -1588,6 +1703,7 @@ ExecCreatePartitionPruneState(PlanState *planstate,
 	prunestate->other_subplans = bms_copy(partitionpruneinfo->other_subplans);
 	prunestate->do_initial_prune = false;	/* may be set below */
 	prunestate->do_exec_prune = false;	/* may be set below */
+	prunestate->result_cache = NULL;	/* may be set below */
 	prunestate->num_partprunedata = n_part_hierarchies;
 
 	/*
@@ -1747,11 +1863,23 @@ ExecCreatePartitionPruneState(PlanState *planstate,
 			pprune->exec_pruning_steps = pinfo->exec_pruning_steps;
 			if (pinfo->exec_pruning_steps)
 			{
+				ListCell   *lc3;
+
 				ExecInitPruningContext(&pprune->exec_context,
 									   pinfo->exec_pruning_steps,
 									   partdesc, partkey, planstate);
 				/* Record whether exec pruning is needed at any level */
 				prunestate->do_exec_prune = true;
+
+				/* Collect the Params, to learn their types */
+				foreach(lc3, pinfo->exec_pruning_steps)
+				{
+					PartitionPruneStepOp *step = lfirst(lc3);
+
+					if (IsA(step, PartitionPruneStepOp))
+						(void) collect_exec_params_walker((Node *) step->exprs,
+														  &exec_params);
+				}
 			}
 
 			/*
@@ -1766,9 +1894,162 @@ ExecCreatePartitionPruneState(PlanState *planstate,
 		i++;
 	}
 
+	if (prunestate->do_exec_prune && !bms_is_empty(prunestate->execparamids))
+		prunestate->result_cache = ExecInitPruneResultCache(prunestate,
+															exec_params,
+															estate);
+	list_free(exec_params);
+
 	return prunestate;
 }
 
+/*
+ * collect_exec_params_walker
+ *		Add the PARAM_EXEC Params found in an expression tree to *params
+ */
+static bool
+collect_exec_params_walker(Node *node, List **params)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Param) && ((Param *) node)->paramkind == PARAM_EXEC)
+	{
+		*params = lappend(*params, node);
+		return false;
+	}
+	return expression_tree_walker(node, collect_exec_params_walker,
+								  (void *) params);
+}
+
+/*
+ * ExecInitPruneResultCache
+ *		Set up the cache of the result of execution-time pruning, given the
+ *		PARAM_EXEC Params found in the pruning steps
+ *
+ * Returns NULL if we can't tell the types of all of prunestate's
+ * execparamids; then pruning is just done each time.
+ */
+static PartitionPruneResultCache *
+ExecInitPruneResultCache(PartitionPruneState *prunestate, List *params,
+						 EState *estate)
+{
+	PartitionPruneResultCache *cache;
+	int			nparams = bms_num_members(prunestate->execparamids);
+	int			paramid = -1;
+	int			i = 0;
+
+	cache = palloc(sizeof(PartitionPruneResultCache));
+	cache->mcxt = CurrentMemoryContext;
+	cache->params = estate->es_param_exec_vals;
+	cache->nparams = nparams;
+	cache->paramids = palloc(sizeof(int) * nparams);
+	cache->typlen = palloc(sizeof(int16) * nparams);
+	cache->typbyval = palloc(sizeof(bool) * nparams);
+	cache->values = palloc0(sizeof(Datum) * nparams);
+	cache->isnull = palloc0(sizeof(bool) * nparams);
+	cache->valid = false;
+	cache->result = NULL;
+
+	while ((paramid = bms_next_member(prunestate->execparamids, paramid)) >= 0)
+	{
+		Param	   *param = NULL;
+		ListCell   *lc;
+
+		foreach(lc, params)
+		{
+			if (((Param *) lfirst(lc))->paramid == paramid)
+			{
+				param = lfirst(lc);
+				break;
+			}
+		}
+		if (param == NULL)
+			return NULL;
+
+		cache->paramids[i] = paramid;
+		get_typlenbyval(param->paramtype, &cache->typlen[i],
+						&cache->typbyval[i]);
+		i++;
+	}
+
+	return cache;
+}
+
+/*
+ * ExecPruneResultCacheMatches
+ *		Do the Params currently have the values of the cached result?
+ */
+static bool
+ExecPruneResultCacheMatches(PartitionPruneResultCache *cache)
+{
+	int			i;
+
+	if (!cache->valid)
+		return false;
+
+	for (i = 0; i < cache->nparams; i++)
+	{
+		ParamExecData *prm = &cache->params[cache->paramids[i]];
+
+		/* a Param whose value is yet to be computed could have any value */
+		if (prm->execPlan != NULL)
+			return false;
+
+		if (prm->isnull != cache->isnull[i])
+			return false;
+		if (!prm->isnull &&
+			!datumIsEqual(prm->value, cache->values[i],
+						  cache->typbyval[i], cache->typlen[i]))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * ExecPruneResultCacheStore
+ *		Remember the result of pruning for the current values of the Params
+ */
+static void
+ExecPruneResultCacheStore(PartitionPruneResultCache *cache, Bitmapset *result)
+{
+	MemoryContext oldcontext;
+	int			i;
+
+	/* forget the old values before anything can fail */
+	cache->valid = false;
+	for (i = 0; i < cache->nparams; i++)
+	{
+		if (!cache->typbyval[i] && !cache->isnull[i])
+			pfree(DatumGetPointer(cache->values[i]));
+		cache->isnull[i] = true;
+	}
+	bms_free(cache->result);
+	cache->result = NULL;
+
+	oldcontext = MemoryContextSwitchTo(cache->mcxt);
+
+	for (i = 0; i < cache->nparams; i++)
+	{
+		ParamExecData *prm = &cache->params[cache->paramids[i]];
+
+		if (prm->execPlan != NULL)
+		{
+			MemoryContextSwitchTo(oldcontext);
+			return;
+		}
+
+		if (!prm->isnull)
+			cache->values[i] = datumCopy(prm->value, cache->typbyval[i],
+										 cache->typlen[i]);
+		cache->isnull[i] = prm->isnull;
+	}
+	cache->result = bms_copy(result);
+	cache->valid = true;
+
+	MemoryContextSwitchTo(oldcontext);
+}
+
 /*
  * Initialize a PartitionPruneContext for the given list of pruning steps.
  */
@@ -2031,6 +2312,11 @@ ExecFindMatchingSubPlans(PartitionPruneState *prunestate)
 	 */
 	Assert(prunestate->do_exec_prune);
 
+	/* Nothing to do if the Params have the same values as the last time */
+	if (prunestate->result_cache &&
+		ExecPruneResultCacheMatches(prunestate->result_cache))
+		return bms_copy(prunestate->result_cache->result);
+
 	/*
 	 * Switch to a temp context to avoid leaking memory in the executor's
 	 * query-lifespan memory context.
@@ -2066,6 +2352,9 @@ ExecFindMatchingSubPlans(PartitionPruneState *prunestate)
 
 	MemoryContextReset(prunestate->prune_context);
 
+	if (prunestate->result_cache)
+		ExecPruneResultCacheStore(prunestate->result_cache, result);
+
 	return result;
 }
 
@@ -71,6 +71,7 @@
 
 static TupleDesc ExecTypeFromTLInternal(List *targetList,
 										bool skipjunk);
+static void slot_build_deformattrs(TupleTableSlot *slot);
 static pg_attribute_always_inline void slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 															  int natts);
 static inline void tts_buffer_heap_store_tuple(TupleTableSlot *slot,
@@ -907,6 +908,60 @@ tts_buffer_heap_store_tuple(TupleTableSlot *slot, HeapTuple tuple,
 	}
 }
 
+/*
+ * slot_build_deformattrs
+ *		Set up slot->tts_deformattrs from the slot's tuple descriptor.
+ *
+ * The fixed offsets are computed up front, rather than being remembered as
+ * we deform tuples, for the leading attributes that are fixed-width (plus
+ * the first variable-width one, if its offset is suitably aligned so that
+ * there would be no pad bytes in any case: then the offset will be valid
+ * for either an aligned or unaligned value).
+ */
+static void
+slot_build_deformattrs(TupleTableSlot *slot)
+{
+	TupleDesc	tupleDesc = slot->tts_tupleDescriptor;
+	TupleDeformAttr *deformattrs;
+	uint32		off = 0;
+	bool		slow = false;
+
+	deformattrs = (TupleDeformAttr *)
+		MemoryContextAlloc(slot->tts_mcxt,
+						   Max(tupleDesc->natts, 1) * sizeof(TupleDeformAttr));
+
+	for (int attnum = 0; attnum < tupleDesc->natts; attnum++)
+	{
+		Form_pg_attribute att = TupleDescAttr(tupleDesc, attnum);
+		TupleDeformAttr *thisatt = &deformattrs[attnum];
+
+		thisatt->attlen = att->attlen;
+		thisatt->attbyval = att->attbyval;
+		thisatt->attalign = att->attalign;
+		thisatt->attcacheoff = -1;
+
+		if (slow)
+			continue;
+
+		if (att->attlen == -1)
+		{
+			if (off == att_align_nominal(off, att->attalign))
+				thisatt->attcacheoff = off;
+		}
+		else
+		{
+			off = att_align_nominal(off, att->attalign);
+			thisatt->attcacheoff = off;
+			off += att->attlen;
+		}
+
+		if (att->attlen <= 0)
+			slow = true;
+	}
+
+	slot->tts_deformattrs = deformattrs;
+}
+
 /*
  * slot_deform_heap_tuple
  *		Given a TupleTableSlot, extract data from the slot's physical tuple
@@ -925,7 +980,7 @@ static pg_attribute_always_inline void
 slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 					   int natts)
 {
-	TupleDesc	tupleDesc = slot->tts_tupleDescriptor;
+	TupleDeformAttr *deformattrs;
 	Datum	   *values = slot->tts_values;
 	bool	   *isnull = slot->tts_isnull;
 	HeapTupleHeader tup = tuple->t_data;
@@ -959,9 +1014,13 @@ slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 
 	tp = (char *) tup + tup->t_hoff;
 
+	if (unlikely(slot->tts_deformattrs == NULL))
+		slot_build_deformattrs(slot);
+	deformattrs = slot->tts_deformattrs;
+
 	for (; attnum < natts; attnum++)
 	{
-		Form_pg_attribute thisatt = TupleDescAttr(tupleDesc, attnum);
+		TupleDeformAttr *thisatt = &deformattrs[attnum];
 
 		if (hasnulls && att_isnull(attnum, bp))
 		{
@@ -977,32 +1036,18 @@ slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 			off = thisatt->attcacheoff;
 		else if (thisatt->attlen == -1)
 		{
-			/*
-			 * We can only cache the offset for a varlena attribute if the
-			 * offset is already suitably aligned, so that there would be no
-			 * pad bytes in any case: then the offset will be valid for either
-			 * an aligned or unaligned value.
-			 */
-			if (!slow &&
-				off == att_align_nominal(off, thisatt->attalign))
-				thisatt->attcacheoff = off;
-			else
-			{
-				off = att_align_pointer(off, thisatt->attalign, -1,
-										tp + off);
-				slow = true;
-			}
+			off = att_align_pointer(off, thisatt->attalign, -1,
+									tp + off);
+			slow = true;
 		}
 		else
 		{
 			/* not varlena, so safe to use att_align_nominal */
 			off = att_align_nominal(off, thisatt->attalign);
-
-			if (!slow)
-				thisatt->attcacheoff = off;
 		}
 
-		values[attnum] = fetchatt(thisatt, tp + off);
+		values[attnum] = fetch_att(tp + off, thisatt->attbyval,
+								   thisatt->attlen);
 
 		off = att_addlength_pointer(off, thisatt->attlen, tp + off);
 
@@ -1216,6 +1261,8 @@ ExecResetTupleTable(List *tupleTable,	/* tuple table */
 				if (slot->tts_isnull)
 					pfree(slot->tts_isnull);
 			}
+			if (slot->tts_deformattrs)
+				pfree(slot->tts_deformattrs);
 			pfree(slot);
 		}
 	}
@@ -1266,6 +1313,8 @@ ExecDropSingleTupleTableSlot(TupleTableSlot *slot)
 		if (slot->tts_isnull)
 			pfree(slot->tts_isnull);
 	}
+	if (slot->tts_deformattrs)
+		pfree(slot->tts_deformattrs);
 	pfree(slot);
 }
 
@@ -1305,6 +1354,9 @@ ExecSetSlotDescriptor(TupleTableSlot *slot, /* slot to change */
 		pfree(slot->tts_values);
 	if (slot->tts_isnull)
 		pfree(slot->tts_isnull);
+	if (slot->tts_deformattrs)
+		pfree(slot->tts_deformattrs);
+	slot->tts_deformattrs = NULL;
 
 	/*
 	 * Install the new descriptor; if it's refcounted, bump its refcount.
@@ -224,12 +224,14 @@ FreeExecutorState(EState *estate)
 }
 
 /*
- * Internal implementation for CreateExprContext() and CreateWorkExprContext()
- * that allows control over the AllocSet parameters.
+ * Internal implementation for CreateExprContext(), CreateWorkExprContext()
+ * and ExecAssignExprContext() that allows control over the memory context
+ * parameters.  If 'bump' is true the per-tuple memory is a bump context;
+ * otherwise it is an AllocSet.
  */
 static ExprContext *
 CreateExprContextInternal(EState *estate, Size minContextSize,
-						  Size initBlockSize, Size maxBlockSize)
+						  Size initBlockSize, Size maxBlockSize, bool bump)
 {
 	ExprContext *econtext;
 	MemoryContext oldcontext;
@@ -249,12 +251,20 @@ CreateExprContextInternal(EState *estate, Size minContextSize,
 	/*
 	 * Create working memory for expression evaluation in this context.
 	 */
-	econtext->ecxt_per_tuple_memory =
-		AllocSetContextCreate(estate->es_query_cxt,
+	if (bump)
+		econtext->ecxt_per_tuple_memory =
+			BumpContextCreate(estate->es_query_cxt,
 							  "ExprContext",
 							  minContextSize,
 							  initBlockSize,
 							  maxBlockSize);
+	else
+		econtext->ecxt_per_tuple_memory =
+			AllocSetContextCreate(estate->es_query_cxt,
+								  "ExprContext",
+								  minContextSize,
+								  initBlockSize,
+								  maxBlockSize);
 
 	econtext->ecxt_param_exec_vals = estate->es_param_exec_vals;
 	econtext->ecxt_param_list_info = estate->es_param_list_info;
@@ -300,7 +310,7 @@ CreateExprContextInternal(EState *estate, Size minContextSize,
 ExprContext *
 CreateExprContext(EState *estate)
 {
-	return CreateExprContextInternal(estate, ALLOCSET_DEFAULT_SIZES);
+	return CreateExprContextInternal(estate, ALLOCSET_DEFAULT_SIZES, false);
 }
 
 
@@ -327,7 +337,7 @@ CreateWorkExprContext(EState *estate)
 		maxBlockSize = ALLOCSET_DEFAULT_INITSIZE;
 
 	return CreateExprContextInternal(estate, minContextSize,
-									 initBlockSize, maxBlockSize);
+									 initBlockSize, maxBlockSize, false);
 }
 
 /* ----------------
@@ -474,12 +484,20 @@ MakePerTupleExprContext(EState *estate)
  *		to do this for nodes which use ExecQual or ExecProject
  *		because those routines require an econtext. Other nodes that
  *		don't have to evaluate expressions don't need to do this.
+ *
+ *		Unlike CreateExprContext(), the per-tuple memory is a bump context
+ *		(see bump.c), which makes palloc cheaper but never reuses space freed
+ *		by pfree() before the next reset.  That suits the node's per-tuple
+ *		work, which is thrown away every tuple.  A node that keeps data with
+ *		a longer lifetime in an ExprContext, like Agg does with transition
+ *		values, should use CreateExprContext() instead.
  * ----------------
  */
 void
 ExecAssignExprContext(EState *estate, PlanState *planstate)
 {
-	planstate->ps_ExprContext = CreateExprContext(estate);
+	planstate->ps_ExprContext =
+		CreateExprContextInternal(estate, ALLOCSET_DEFAULT_SIZES, true);
 }
 
 /* ----------------
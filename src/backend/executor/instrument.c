@@ -21,9 +21,11 @@ BufferUsage pgBufferUsage;
 static BufferUsage save_pgBufferUsage;
 WalUsage	pgWalUsage;
 static WalUsage save_pgWalUsage;
+WaitUsage	pgWaitUsage;
 
 static void BufferUsageAdd(BufferUsage *dst, const BufferUsage *add);
 static void WalUsageAdd(WalUsage *dst, WalUsage *add);
+static void WaitUsageAdd(WaitUsage *dst, const WaitUsage *add);
 
 
 /* Allocate new instrumentation structure(s) */
@@ -34,18 +36,26 @@ InstrAlloc(int n, int instrument_options)
 
 	/* initialize all fields to zeroes, then modify as needed */
 	instr = palloc0(n * sizeof(Instrumentation));
-	if (instrument_options & (INSTRUMENT_BUFFERS | INSTRUMENT_TIMER | INSTRUMENT_WAL))
+	if (instrument_options & (INSTRUMENT_BUFFERS | INSTRUMENT_TIMER |
+							  INSTRUMENT_TIMER_SAMPLED |
+							  INSTRUMENT_WAL | INSTRUMENT_WAITS))
 	{
 		bool		need_buffers = (instrument_options & INSTRUMENT_BUFFERS) != 0;
 		bool		need_wal = (instrument_options & INSTRUMENT_WAL) != 0;
-		bool		need_timer = (instrument_options & INSTRUMENT_TIMER) != 0;
+		bool		need_waits = (instrument_options & INSTRUMENT_WAITS) != 0;
+		int			timer = instrument_options & (INSTRUMENT_TIMER |
+												  INSTRUMENT_TIMER_SAMPLED);
+		bool		need_timer = timer != 0;
+		bool		sample_timer = timer == INSTRUMENT_TIMER_SAMPLED;
 		int			i;
 
 		for (i = 0; i < n; i++)
 		{
 			instr[i].need_bufusage = need_buffers;
 			instr[i].need_walusage = need_wal;
+			instr[i].need_waitusage = need_waits;
 			instr[i].need_timer = need_timer;
+			instr[i].sample_timer = sample_timer;
 		}
 	}
 
@@ -56,19 +66,37 @@ InstrAlloc(int n, int instrument_options)
 void
 InstrInit(Instrumentation *instr, int instrument_options)
 {
+	int			timer = instrument_options & (INSTRUMENT_TIMER |
+											  INSTRUMENT_TIMER_SAMPLED);
+
 	memset(instr, 0, sizeof(Instrumentation));
 	instr->need_bufusage = (instrument_options & INSTRUMENT_BUFFERS) != 0;
 	instr->need_walusage = (instrument_options & INSTRUMENT_WAL) != 0;
-	instr->need_timer = (instrument_options & INSTRUMENT_TIMER) != 0;
+	instr->need_waitusage = (instrument_options & INSTRUMENT_WAITS) != 0;
+	instr->need_timer = timer != 0;
+	instr->sample_timer = timer == INSTRUMENT_TIMER_SAMPLED;
 }
 
 /* Entry to a plan node */
 void
 InstrStartNode(Instrumentation *instr)
 {
-	if (instr->need_timer &&
-		!INSTR_TIME_SET_CURRENT_LAZY(instr->starttime))
-		elog(ERROR, "InstrStartNode called twice in a row");
+	if (instr->need_timer)
+	{
+		if (!instr->sample_timer)
+		{
+			if (!INSTR_TIME_SET_CURRENT_LAZY(instr->starttime))
+				elog(ERROR, "InstrStartNode called twice in a row");
+		}
+		else
+		{
+			/* time the first few calls, then a sample of the rest */
+			instr->ncalls++;
+			if (instr->ncalls <= INSTR_TIMER_SAMPLE_RATE ||
+				instr->ncalls % INSTR_TIMER_SAMPLE_RATE == 1)
+				INSTR_TIME_SET_CURRENT(instr->starttime);
+		}
+	}
 
 	/* save buffer usage totals at node entry, if needed */
 	if (instr->need_bufusage)
@@ -76,6 +104,9 @@ InstrStartNode(Instrumentation *instr)
 
 	if (instr->need_walusage)
 		instr->walusage_start = pgWalUsage;
+
+	if (instr->need_waitusage)
+		instr->waitusage_start = pgWaitUsage;
 }
 
 /* Exit from a plan node */
@@ -90,13 +121,27 @@ InstrStopNode(Instrumentation *instr, double nTuples)
 	/* let's update the time only if the timer was requested */
 	if (instr->need_timer)
 	{
-		if (INSTR_TIME_IS_ZERO(instr->starttime))
-			elog(ERROR, "InstrStopNode called without start");
+		if (!instr->sample_timer)
+		{
+			if (INSTR_TIME_IS_ZERO(instr->starttime))
+				elog(ERROR, "InstrStopNode called without start");
 
-		INSTR_TIME_SET_CURRENT(endtime);
-		INSTR_TIME_ACCUM_DIFF(instr->counter, endtime, instr->starttime);
+			INSTR_TIME_SET_CURRENT(endtime);
+			INSTR_TIME_ACCUM_DIFF(instr->counter, endtime, instr->starttime);
 
-		INSTR_TIME_SET_ZERO(instr->starttime);
+			INSTR_TIME_SET_ZERO(instr->starttime);
+		}
+		else if (!INSTR_TIME_IS_ZERO(instr->starttime))
+		{
+			/* this call was timed; the first few go into the exact counter */
+			INSTR_TIME_SET_CURRENT(endtime);
+			if (instr->ncalls <= INSTR_TIMER_SAMPLE_RATE)
+				INSTR_TIME_ACCUM_DIFF(instr->counter, endtime, instr->starttime);
+			else
+				INSTR_TIME_ACCUM_DIFF(instr->sampled, endtime, instr->starttime);
+
+			INSTR_TIME_SET_ZERO(instr->starttime);
+		}
 	}
 
 	/* Add delta of buffer usage since entry to node's totals */
@@ -108,6 +153,10 @@ InstrStopNode(Instrumentation *instr, double nTuples)
 		WalUsageAccumDiff(&instr->walusage,
 						  &pgWalUsage, &instr->walusage_start);
 
+	if (instr->need_waitusage)
+		WaitUsageAccumDiff(&instr->waitusage,
+						   &pgWaitUsage, &instr->waitusage_start);
+
 	/* Is this the first tuple of this cycle? */
 	if (!instr->running)
 	{
@@ -132,6 +181,18 @@ InstrEndLoop(Instrumentation *instr)
 	/* Accumulate per-cycle statistics into totals */
 	totaltime = INSTR_TIME_GET_DOUBLE(instr->counter);
 
+	/*
+	 * If we timed only a sample of the calls after the first few, scale up
+	 * the sampled time to all of those calls.
+	 */
+	if (instr->ncalls > INSTR_TIMER_SAMPLE_RATE)
+	{
+		uint64		nsampled = (instr->ncalls - 1) / INSTR_TIMER_SAMPLE_RATE;
+
+		totaltime += INSTR_TIME_GET_DOUBLE(instr->sampled) *
+			(instr->ncalls - INSTR_TIMER_SAMPLE_RATE) / nsampled;
+	}
+
 	instr->startup += instr->firsttuple;
 	instr->total += totaltime;
 	instr->ntuples += instr->tuplecount;
@@ -141,6 +202,8 @@ InstrEndLoop(Instrumentation *instr)
 	instr->running = false;
 	INSTR_TIME_SET_ZERO(instr->starttime);
 	INSTR_TIME_SET_ZERO(instr->counter);
+	instr->ncalls = 0;
+	INSTR_TIME_SET_ZERO(instr->sampled);
 	instr->firsttuple = 0;
 	instr->tuplecount = 0;
 }
@@ -174,6 +237,9 @@ InstrAggNode(Instrumentation *dst, Instrumentation *add)
 
 	if (dst->need_walusage)
 		WalUsageAdd(&dst->walusage, &add->walusage);
+
+	if (dst->need_waitusage)
+		WaitUsageAdd(&dst->waitusage, &add->waitusage);
 }
 
 /* note current values during parallel executor startup */
@@ -258,3 +324,23 @@ WalUsageAccumDiff(WalUsage *dst, const WalUsage *add, const WalUsage *sub)
 	dst->wal_records += add->wal_records - sub->wal_records;
 	dst->wal_fpi += add->wal_fpi - sub->wal_fpi;
 }
+
+/* helper functions for wait usage accumulation */
+static void
+WaitUsageAdd(WaitUsage *dst, const WaitUsage *add)
+{
+	int			i;
+
+	for (i = 0; i < NUM_WAIT_USAGE_CLASSES; i++)
+		INSTR_TIME_ADD(dst->wait_time[i], add->wait_time[i]);
+}
+
+void
+WaitUsageAccumDiff(WaitUsage *dst, const WaitUsage *add, const WaitUsage *sub)
+{
+	int			i;
+
+	for (i = 0; i < NUM_WAIT_USAGE_CLASSES; i++)
+		INSTR_TIME_ACCUM_DIFF(dst->wait_time[i],
+							  add->wait_time[i], sub->wait_time[i]);
+}
@@ -438,6 +438,8 @@ static TupleTableSlot *agg_retrieve_hash_table(AggState *aggstate);
 static TupleTableSlot *agg_retrieve_hash_table_in_memory(AggState *aggstate);
 static void hash_agg_check_limits(AggState *aggstate);
 static void hash_agg_enter_spill_mode(AggState *aggstate);
+static double hash_agg_spill_groups(AggState *aggstate,
+								   AggStatePerHash perhash);
 static void hash_agg_update_metrics(AggState *aggstate, bool from_tape,
 									int npartitions);
 static void hashagg_finish_initial_spills(AggState *aggstate);
@@ -1900,12 +1902,43 @@ hash_agg_enter_spill_mode(AggState *aggstate)
 			HashAggSpill *spill = &aggstate->hash_spills[setno];
 
 			hashagg_spill_init(spill, aggstate->hash_tapeinfo, 0,
-							   perhash->aggnode->numGroups,
+							   hash_agg_spill_groups(aggstate, perhash),
 							   aggstate->hashentrysize);
 		}
 	}
 }
 
+/*
+ * Estimate the number of groups in the input, for choosing the number of
+ * partitions when we first spill.
+ *
+ * The planner's estimate is all we have to start with, but by the time the
+ * table is full we can also extrapolate from what we've seen so far: the
+ * number of distinct groups per input tuple, applied to the rest of the
+ * input the planner expects.  Taking the larger of the two guards against a
+ * badly underestimated numGroups, which would otherwise leave us with too
+ * few partitions and another round of spilling for each of them.  Later
+ * batches use the HyperLogLog estimate of their own partition instead.
+ */
+static double
+hash_agg_spill_groups(AggState *aggstate, AggStatePerHash perhash)
+{
+	double		input_groups = perhash->aggnode->numGroups;
+	double		ntuples = aggstate->hash_tuples_read;
+
+	if (ntuples > 0)
+	{
+		double		ngroups = perhash->hashtable->hashtab->members;
+		double		outer_rows = outerPlanState(aggstate)->plan->plan_rows;
+		double		remaining = Max(outer_rows - ntuples, 0.0);
+
+		input_groups = Max(input_groups,
+						   ngroups + (ngroups / ntuples) * remaining);
+	}
+
+	return input_groups;
+}
+
 /*
  * Update metrics after filling the hash table.
  *
@@ -2093,6 +2126,8 @@ lookup_hash_entries(AggState *aggstate)
 	TupleTableSlot *outerslot = aggstate->tmpcontext->ecxt_outertuple;
 	int			setno;
 
+	aggstate->hash_tuples_read++;
+
 	for (setno = 0; setno < aggstate->num_hashes; setno++)
 	{
 		AggStatePerHash perhash = &aggstate->perhash[setno];
@@ -2127,7 +2162,7 @@ lookup_hash_entries(AggState *aggstate)
 
 			if (spill->partitions == NULL)
 				hashagg_spill_init(spill, aggstate->hash_tapeinfo, 0,
-								   perhash->aggnode->numGroups,
+								   hash_agg_spill_groups(aggstate, perhash),
 								   aggstate->hashentrysize);
 
 			hashagg_spill_tuple(aggstate, spill, slot, hash);
@@ -3344,7 +3379,9 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 	 * memory context of the per-grouping-set ExprContexts (aggcontexts)
 	 * replaces the standalone memory context formerly used to hold transition
 	 * values.  We cheat a little by using ExecAssignExprContext() to build
-	 * all of them.
+	 * all of them, except for the aggcontexts: transition values are pfree'd
+	 * and replaced as input tuples arrive, so they need an ExprContext whose
+	 * per-tuple memory reuses freed space (see ExecAssignExprContext()).
 	 *
 	 * NOTE: the details of what is stored in aggcontexts and what is stored
 	 * in the regular per-query memory context are driven by a simple
@@ -3355,10 +3392,7 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 	aggstate->tmpcontext = aggstate->ss.ps.ps_ExprContext;
 
 	for (i = 0; i < numGroupingSets; ++i)
-	{
-		ExecAssignExprContext(estate, &aggstate->ss.ps);
-		aggstate->aggcontexts[i] = aggstate->ss.ps.ps_ExprContext;
-	}
+		aggstate->aggcontexts[i] = CreateExprContext(estate);
 
 	if (use_hashing)
 		aggstate->hashcontext = CreateWorkExprContext(estate);
@@ -4528,6 +4562,7 @@ ExecReScanAgg(AggState *node)
 		node->hash_ever_spilled = false;
 		node->hash_spill_mode = false;
 		node->hash_ngroups_current = 0;
+		node->hash_tuples_read = 0;
 
 		ReScanExprContext(node->hashcontext);
 		/* Rebuild an empty hash table */
@@ -29,11 +29,14 @@
 #include "access/htup_details.h"
 #include "access/parallel.h"
 #include "catalog/pg_statistic.h"
+#include "commands/progress.h"
 #include "commands/tablespace.h"
 #include "executor/execdebug.h"
+#include "executor/hashdatum.h"
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#include "lib/bloomfilter.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "port/atomics.h"
@@ -45,6 +48,7 @@
 #include "utils/syscache.h"
 
 static void ExecHashIncreaseNumBatches(HashJoinTable hashtable);
+static Size ExecHashSkewedValueSpace(HashJoinTable hashtable, uint32 hashvalue);
 static void ExecHashIncreaseNumBuckets(HashJoinTable hashtable);
 static void ExecParallelHashIncreaseNumBatches(HashJoinTable hashtable);
 static void ExecParallelHashIncreaseNumBuckets(HashJoinTable hashtable);
@@ -174,6 +178,11 @@ MultiExecPrivateHash(HashState *node)
 		{
 			int			bucketNumber;
 
+			if (hashtable->bloom != NULL)
+				bloom_add_element(hashtable->bloom,
+								  (unsigned char *) &hashvalue,
+								  sizeof(hashvalue));
+
 			bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
 			if (bucketNumber != INVALID_SKEW_BUCKET_NO)
 			{
@@ -502,6 +511,8 @@ ExecHashTableCreate(HashState *state, List *hashOperators, List *hashCollations,
 	hashtable->skewTuples = 0;
 	hashtable->innerBatchFile = NULL;
 	hashtable->outerBatchFile = NULL;
+	hashtable->bloom = NULL;
+	hashtable->spaceBloom = 0;
 	hashtable->spaceUsed = 0;
 	hashtable->spacePeak = 0;
 	hashtable->spaceAllowed = space_allowed;
@@ -610,6 +621,14 @@ ExecHashTableCreate(HashState *state, List *hashOperators, List *hashCollations,
 			pstate->space_allowed = space_allowed;
 			pstate->growth = PHJ_GROWTH_OK;
 
+			/*
+			 * If we may use a lot of memory, have the area grow in bigger
+			 * steps, so that loading the hash table doesn't stop for a new
+			 * DSM segment every megabyte or two.  Starting at a sixteenth of
+			 * the limit, a handful of segments covers it.
+			 */
+			dsa_set_min_segment_size(hashtable->area, space_allowed / 16);
+
 			/* Set up the shared state for coordinating batches. */
 			ExecParallelHashJoinSetUpBatches(hashtable, nbatch);
 
@@ -653,6 +672,42 @@ ExecHashTableCreate(HashState *state, List *hashOperators, List *hashCollations,
 	return hashtable;
 }
 
+/*
+ * Build an empty Bloom filter for the hash values of about ntuples inner
+ * tuples, if it fits in the hash table's memory budget.
+ *
+ * The filter takes at most a quarter of spaceAllowed, which is reduced
+ * accordingly, so that the join as a whole still keeps within hash_mem.  A
+ * filter with less than a byte per element would rule out too few outer
+ * tuples to be worth its memory, so we don't build one then.
+ */
+void
+ExecHashTableCreateBloomFilter(HashJoinTable hashtable, double ntuples)
+{
+	Size		budget = hashtable->spaceAllowed / 4;
+	Size		filter_bytes;
+	MemoryContext oldcxt;
+
+	/* bloom_create() won't go below 1MB */
+	if (budget < 1024 * 1024 || ntuples > (double) budget)
+		return;
+
+	/* Work out how much bloom_create() will allocate, as it does */
+	filter_bytes = Min(budget, (Size) ntuples * 2);
+	filter_bytes = Max(1024 * 1024, filter_bytes);
+	filter_bytes = ((Size) 1) << pg_leftmost_one_pos64(filter_bytes);
+
+	oldcxt = MemoryContextSwitchTo(hashtable->hashCxt);
+	hashtable->bloom = bloom_create(Max((int64) ntuples, 1),
+									(int) (budget / 1024), 0);
+	MemoryContextSwitchTo(oldcxt);
+
+	hashtable->spaceBloom = filter_bytes;
+	hashtable->spaceAllowed -= filter_bytes;
+	hashtable->spaceAllowedSkew =
+		hashtable->spaceAllowed * SKEW_HASH_MEM_PERCENT / 100;
+}
+
 
 /*
  * Compute appropriate size for hashtable given the estimated size of the
@@ -893,6 +948,8 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 	long		ninmemory;
 	long		nfreed;
 	HashMemoryChunk oldchunks;
+	uint32		skewhash = 0;
+	long		skewvotes = 0;
 
 	/* do nothing if we've decided to shut off growth */
 	if (!hashtable->growEnabled)
@@ -1001,6 +1058,17 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 				/* and add it back to the appropriate bucket */
 				copyTuple->next.unshared = hashtable->buckets.unshared[bucketno];
 				hashtable->buckets.unshared[bucketno] = copyTuple;
+
+				/* track the majority hash value of the remaining tuples */
+				if (skewvotes == 0)
+				{
+					skewhash = hashTuple->hashvalue;
+					skewvotes = 1;
+				}
+				else if (hashTuple->hashvalue == skewhash)
+					skewvotes++;
+				else
+					skewvotes--;
 			}
 			else
 			{
@@ -1047,6 +1115,52 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 			   hashtable);
 #endif
 	}
+	else if (skewvotes > 0 &&
+			 ExecHashSkewedValueSpace(hashtable, skewhash) >
+			 Max(hashtable->spaceAllowed, hashtable->spaceUsed / 2))
+	{
+		/*
+		 * A single hash value makes up most of what remains in memory, and
+		 * needs more than spaceAllowed all by itself.  Further splits can't
+		 * bring this batch under the limit, and each one only doubles the
+		 * number of batch files while shaving off the few other tuples, so
+		 * stop now rather than keep going until a split frees nothing.
+		 */
+		hashtable->growEnabled = false;
+#ifdef HJDEBUG
+		printf("Hashjoin %p: hash value %u dominates, disabling further increase of nbatch\n",
+			   hashtable, skewhash);
+#endif
+	}
+}
+
+/*
+ * ExecHashSkewedValueSpace
+ *		Return the space used by in-memory tuples having the given hash value
+ *
+ * This is used to check a candidate heavy hitter found while rebatching; it
+ * walks the bucket chain for that hash value only.
+ */
+static Size
+ExecHashSkewedValueSpace(HashJoinTable hashtable, uint32 hashvalue)
+{
+	HashJoinTuple hashTuple;
+	int			bucketno;
+	int			batchno;
+	Size		space = 0;
+
+	ExecHashGetBucketAndBatch(hashtable, hashvalue, &bucketno, &batchno);
+	Assert(batchno == hashtable->curbatch);
+
+	for (hashTuple = hashtable->buckets.unshared[bucketno];
+		 hashTuple != NULL;
+		 hashTuple = hashTuple->next.unshared)
+	{
+		if (hashTuple->hashvalue == hashvalue)
+			space += HJTUPLE_OVERHEAD + HJTUPLE_MINTUPLE(hashTuple)->t_len;
+	}
+
+	return space;
 }
 
 /*
@@ -1858,7 +1972,8 @@ ExecHashGetHashValue(HashJoinTable hashtable,
 			/* Compute the hash function */
 			uint32		hkey;
 
-			hkey = DatumGetUInt32(FunctionCall1Coll(&hashfunctions[i], hashtable->collations[i], keyval));
+			hkey = ExecHashDatum(&hashfunctions[i], hashtable->collations[i],
+								 keyval);
 			hashkey ^= hkey;
 		}
 
@@ -1955,6 +2070,14 @@ ExecScanHashBucket(HashJoinState *hjstate,
 
 	while (hashTuple != NULL)
 	{
+		/*
+		 * Start fetching the next tuple in the chain while we examine this
+		 * one; the tuples of a bucket are scattered across the dense-alloc
+		 * chunks, so each hop is likely to be a cache miss.
+		 */
+		if (hashTuple->next.unshared != NULL)
+			pg_prefetch_mem(hashTuple->next.unshared);
+
 		if (hashTuple->hashvalue == hashvalue)
 		{
 			TupleTableSlot *inntuple;
@@ -2700,7 +2823,7 @@ ExecHashAccumInstrumentation(HashInstrumentation *instrument,
 	instrument->nbatch_original = Max(instrument->nbatch_original,
 									  hashtable->nbatch_original);
 	instrument->space_peak = Max(instrument->space_peak,
-								 hashtable->spacePeak);
+								 hashtable->spacePeak + hashtable->spaceBloom);
 }
 
 /*
@@ -3263,6 +3386,9 @@ ExecParallelHashTableSetCurrentBatch(HashJoinTable hashtable, int batchno)
 	Assert(hashtable->batches[batchno].shared->buckets != InvalidDsaPointer);
 
 	hashtable->curbatch = batchno;
+	pgstat_progress_query_set(PROGRESS_QUERY_HASH_BATCH, batchno + 1);
+	pgstat_progress_query_set(PROGRESS_QUERY_HASH_BATCHES, hashtable->nbatch);
+
 	hashtable->buckets.shared = (dsa_pointer_atomic *)
 		dsa_get_address(hashtable->area,
 						hashtable->batches[batchno].shared->buckets);
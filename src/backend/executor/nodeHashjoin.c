@@ -108,10 +108,12 @@
 
 #include "access/htup_details.h"
 #include "access/parallel.h"
+#include "commands/progress.h"
 #include "executor/executor.h"
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#include "lib/bloomfilter.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "utils/memutils.h"
@@ -282,6 +284,19 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 												HJ_FILL_INNER(node));
 				node->hj_HashTable = hashtable;
 
+				/*
+				 * If we expect to need several batches, and an outer tuple
+				 * without a match can simply be discarded, have the Hash node
+				 * build a Bloom filter of the inner hash values.  Outer
+				 * tuples that it rules out then needn't be written to, and
+				 * read back from, the outer batch files.  The filter is not
+				 * shared, so Parallel Hash doesn't use it.
+				 */
+				if (!parallel && hashtable->nbatch > 1 &&
+					!HJ_FILL_OUTER(node) && node->js.jointype != JOIN_ANTI)
+					ExecHashTableCreateBloomFilter(hashtable,
+												   hashNode->ps.plan->plan_rows);
+
 				/*
 				 * Execute the Hash node, to build the hash table.  If using
 				 * Parallel Hash, then we'll try to help hashing unless we
@@ -304,6 +319,10 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 				 */
 				hashtable->nbatch_outstart = hashtable->nbatch;
 
+				pgstat_progress_query_set(PROGRESS_QUERY_HASH_BATCH, 1);
+				pgstat_progress_query_set(PROGRESS_QUERY_HASH_BATCHES,
+										  hashtable->nbatch);
+
 				/*
 				 * Reset OuterNotEmpty for scan.  (It's OK if we fetched a
 				 * tuple above, because ExecHashJoinOuterGetTuple will
@@ -379,6 +398,15 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 				node->hj_CurHashValue = hashvalue;
 				ExecHashGetBucketAndBatch(hashtable, hashvalue,
 										  &node->hj_CurBucketNo, &batchno);
+
+				/*
+				 * Get the bucket header on its way into cache while we do
+				 * the skew and batch checks below.
+				 */
+				if (!parallel && batchno == hashtable->curbatch)
+					pg_prefetch_mem(hashtable->buckets.unshared +
+									node->hj_CurBucketNo);
+
 				node->hj_CurSkewBucketNo = ExecHashGetSkewBucket(hashtable,
 																 hashvalue);
 				node->hj_CurTuple = NULL;
@@ -391,8 +419,21 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 					node->hj_CurSkewBucketNo == INVALID_SKEW_BUCKET_NO)
 				{
 					bool		shouldFree;
-					MinimalTuple mintuple = ExecFetchSlotMinimalTuple(outerTupleSlot,
-																	  &shouldFree);
+					MinimalTuple mintuple;
+
+					/*
+					 * If no inner tuple has this hash value, the outer tuple
+					 * can't have a match, and we were told it's OK to discard
+					 * it.
+					 */
+					if (hashtable->bloom != NULL &&
+						bloom_lacks_element(hashtable->bloom,
+											(unsigned char *) &hashvalue,
+											sizeof(hashvalue)))
+						continue;
+
+					mintuple = ExecFetchSlotMinimalTuple(outerTupleSlot,
+														 &shouldFree);
 
 					/*
 					 * Need to postpone this outer tuple to a later batch.
@@ -1031,6 +1072,9 @@ ExecHashJoinNewBatch(HashJoinState *hjstate)
 
 	hashtable->curbatch = curbatch;
 
+	pgstat_progress_query_set(PROGRESS_QUERY_HASH_BATCH, curbatch + 1);
+	pgstat_progress_query_set(PROGRESS_QUERY_HASH_BATCHES, nbatch);
+
 	/*
 	 * Reload the hash table with the new inner batch (which could be empty)
 	 */
@@ -68,6 +68,7 @@
 
 #include "common/hashfn.h"
 #include "executor/executor.h"
+#include "executor/hashdatum.h"
 #include "executor/nodeResultCache.h"
 #include "lib/ilist.h"
 #include "miscadmin.h"
@@ -172,8 +173,8 @@ ResultCacheHash_hash(struct resultcache_hash *tb, const ResultCacheKey *key)
 		{
 			uint32		hkey;
 
-			hkey = DatumGetUInt32(FunctionCall1Coll(&hashfunctions[i],
-													collations[i], pslot->tts_values[i]));
+			hkey = ExecHashDatum(&hashfunctions[i], collations[i],
+								 pslot->tts_values[i]);
 			hashkey ^= hkey;
 		}
 	}
@@ -48,6 +48,7 @@
 #include "utils/builtins.h"
 #include "utils/datum.h"
 #include "utils/expandeddatum.h"
+#include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/regproc.h"
@@ -154,6 +155,28 @@ typedef struct WindowStatePerAggData
 
 	int64		transValueCount;	/* number of currently-aggregated rows */
 
+	/*
+	 * Sliding aggregation state, used for aggregates that have no inverse
+	 * transition function but do have a combine function (e.g. min/max).
+	 * The rows between slideBase and slideUpto are kept in a ring buffer of
+	 * slideSize entries, split into a "front" stack (slideBase to slideFront,
+	 * with suffix-combined values) and a "back" stack (slideFront to
+	 * slideUpto, whose combined value is slideBack).  See
+	 * advance_sliding_aggregate() and friends.
+	 */
+	bool		sliding;		/* use sliding aggregation? */
+	FmgrInfo	combinefn;		/* valid only if sliding */
+	Datum	   *slideValues;
+	bool	   *slideNulls;
+	Datum	   *slideSuffix;
+	bool	   *slideSuffixNulls;
+	int64		slideSize;
+	int64		slideBase;
+	int64		slideFront;
+	int64		slideUpto;
+	Datum		slideBack;
+	bool		slideBackNull;
+
 	/* Data local to eval_windowaggregates() */
 	bool		restart;		/* need to restart this agg in this cycle? */
 } WindowStatePerAggData;
@@ -171,6 +194,17 @@ static void finalize_windowaggregate(WindowAggState *winstate,
 									 WindowStatePerFunc perfuncstate,
 									 WindowStatePerAgg peraggstate,
 									 Datum *result, bool *isnull);
+static void advance_sliding_aggregate(WindowAggState *winstate,
+									  WindowStatePerFunc perfuncstate,
+									  WindowStatePerAgg peraggstate);
+static void advance_sliding_aggregate_base(WindowAggState *winstate,
+										   WindowStatePerFunc perfuncstate,
+										   WindowStatePerAgg peraggstate,
+										   int64 newbase);
+static void sliding_aggregate_value(WindowAggState *winstate,
+									WindowStatePerFunc perfuncstate,
+									WindowStatePerAgg peraggstate);
+static bool sliding_combinefn_is_exact(Oid combinefn_oid);
 
 static void eval_windowaggregates(WindowAggState *winstate);
 static void eval_windowfunction(WindowAggState *winstate,
@@ -231,6 +265,21 @@ initialize_windowaggregate(WindowAggState *winstate,
 	peraggstate->transValueCount = 0;
 	peraggstate->resultValue = (Datum) 0;
 	peraggstate->resultValueIsNull = true;
+
+	/* The ring buffer, if any, went away with the private aggcontext */
+	if (peraggstate->sliding)
+	{
+		peraggstate->slideValues = NULL;
+		peraggstate->slideNulls = NULL;
+		peraggstate->slideSuffix = NULL;
+		peraggstate->slideSuffixNulls = NULL;
+		peraggstate->slideSize = 0;
+		peraggstate->slideBase = winstate->frameheadpos;
+		peraggstate->slideFront = winstate->frameheadpos;
+		peraggstate->slideUpto = winstate->frameheadpos;
+		peraggstate->slideBack = (Datum) 0;
+		peraggstate->slideBackNull = true;
+	}
 }
 
 /*
@@ -647,6 +696,304 @@ finalize_windowaggregate(WindowAggState *winstate,
 	MemoryContextSwitchTo(oldContext);
 }
 
+/*
+ * sliding_combinefn_is_exact
+ * can values be combined with this function in any grouping?
+ *
+ * Sliding aggregation combines the rows of the frame in a different grouping
+ * than the left-to-right order in which the transfn would see them.  That
+ * only gives the same result if the combine function is exactly associative,
+ * which is not true of floating-point addition, say, nor of integer addition
+ * where intermediate results can overflow.  Since we can't tell that from the
+ * catalogs, we only allow the built-in functions that pick one of their
+ * inputs or do bitwise logic, as used by min, max, bit_and, bit_or,
+ * bit_xor, bool_and and bool_or.
+ */
+static bool
+sliding_combinefn_is_exact(Oid combinefn_oid)
+{
+	switch (combinefn_oid)
+	{
+		case F_INT2LARGER:
+		case F_INT2SMALLER:
+		case F_INT4LARGER:
+		case F_INT4SMALLER:
+		case F_INT8LARGER:
+		case F_INT8SMALLER:
+		case F_FLOAT4LARGER:
+		case F_FLOAT4SMALLER:
+		case F_FLOAT8LARGER:
+		case F_FLOAT8SMALLER:
+		case F_OIDLARGER:
+		case F_OIDSMALLER:
+		case F_CASHLARGER:
+		case F_CASHSMALLER:
+		case F_DATE_LARGER:
+		case F_DATE_SMALLER:
+		case F_TIME_LARGER:
+		case F_TIME_SMALLER:
+		case F_TIMESTAMP_LARGER:
+		case F_TIMESTAMP_SMALLER:
+		case F_TIMESTAMPTZ_LARGER:
+		case F_TIMESTAMPTZ_SMALLER:
+		case F_ENUM_LARGER:
+		case F_ENUM_SMALLER:
+		case F_INT2AND:
+		case F_INT2OR:
+		case F_INT2XOR:
+		case F_INT4AND:
+		case F_INT4OR:
+		case F_INT4XOR:
+		case F_INT8AND:
+		case F_INT8OR:
+		case F_INT8XOR:
+		case F_BOOLAND_STATEFUNC:
+		case F_BOOLOR_STATEFUNC:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * sliding_combine
+ * combine two partial transition values of a sliding aggregate
+ *
+ * The combine function is known to be strict, so a NULL on either side just
+ * means "no rows yet", and we return the other value.
+ */
+static Datum
+sliding_combine(WindowAggState *winstate,
+				WindowStatePerFunc perfuncstate,
+				WindowStatePerAgg peraggstate,
+				Datum value1, bool isnull1,
+				Datum value2, bool isnull2,
+				bool *isnull)
+{
+	LOCAL_FCINFO(fcinfo, 2);
+	Datum		result;
+
+	if (isnull1)
+	{
+		*isnull = isnull2;
+		return value2;
+	}
+	if (isnull2)
+	{
+		*isnull = false;
+		return value1;
+	}
+
+	InitFunctionCallInfoData(*fcinfo, &(peraggstate->combinefn), 2,
+							 perfuncstate->winCollation,
+							 (void *) winstate, NULL);
+	fcinfo->args[0].value = value1;
+	fcinfo->args[0].isnull = false;
+	fcinfo->args[1].value = value2;
+	fcinfo->args[1].isnull = false;
+	winstate->curaggcontext = peraggstate->aggcontext;
+	result = FunctionCallInvoke(fcinfo);
+	winstate->curaggcontext = NULL;
+	*isnull = fcinfo->isnull;
+
+	return result;
+}
+
+/*
+ * sliding_aggregate_enlarge
+ * double the size of a sliding aggregate's ring buffer
+ */
+static void
+sliding_aggregate_enlarge(WindowStatePerAgg peraggstate)
+{
+	int64		oldsize = peraggstate->slideSize;
+	int64		newsize = (oldsize > 0) ? oldsize * 2 : 64;
+	Datum	   *values;
+	bool	   *nulls;
+	Datum	   *suffix;
+	bool	   *suffixnulls;
+	int64		pos;
+
+	values = (Datum *) MemoryContextAllocHuge(peraggstate->aggcontext,
+											  newsize * sizeof(Datum));
+	nulls = (bool *) MemoryContextAllocHuge(peraggstate->aggcontext,
+											newsize * sizeof(bool));
+	suffix = (Datum *) MemoryContextAllocHuge(peraggstate->aggcontext,
+											  newsize * sizeof(Datum));
+	suffixnulls = (bool *) MemoryContextAllocHuge(peraggstate->aggcontext,
+												  newsize * sizeof(bool));
+
+	for (pos = peraggstate->slideBase; pos < peraggstate->slideUpto; pos++)
+	{
+		int64		oldidx = pos & (oldsize - 1);
+		int64		newidx = pos & (newsize - 1);
+
+		values[newidx] = peraggstate->slideValues[oldidx];
+		nulls[newidx] = peraggstate->slideNulls[oldidx];
+		if (pos < peraggstate->slideFront)
+		{
+			suffix[newidx] = peraggstate->slideSuffix[oldidx];
+			suffixnulls[newidx] = peraggstate->slideSuffixNulls[oldidx];
+		}
+	}
+
+	if (oldsize > 0)
+	{
+		pfree(peraggstate->slideValues);
+		pfree(peraggstate->slideNulls);
+		pfree(peraggstate->slideSuffix);
+		pfree(peraggstate->slideSuffixNulls);
+	}
+	peraggstate->slideValues = values;
+	peraggstate->slideNulls = nulls;
+	peraggstate->slideSuffix = suffix;
+	peraggstate->slideSuffixNulls = suffixnulls;
+	peraggstate->slideSize = newsize;
+}
+
+/*
+ * advance_sliding_aggregate
+ * add the current input row to a sliding aggregate
+ *
+ * Instead of running the transition function, we remember the row's input
+ * value (which, since the transfn is strict with a NULL initial value, is
+ * also the transition value of a one-row aggregation) and fold it into the
+ * back stack's combined value.  Rows that are FILTERed out or have a NULL
+ * input are remembered as NULLs, which the combine step ignores.
+ */
+static void
+advance_sliding_aggregate(WindowAggState *winstate,
+						  WindowStatePerFunc perfuncstate,
+						  WindowStatePerAgg peraggstate)
+{
+	WindowFuncExprState *wfuncstate = perfuncstate->wfuncstate;
+	ExprContext *econtext = winstate->tmpcontext;
+	ExprState  *filter = wfuncstate->aggfilter;
+	MemoryContext oldContext;
+	Datum		value = (Datum) 0;
+	bool		isnull = true;
+	int64		idx;
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	if (filter)
+	{
+		Datum		res = ExecEvalExpr(filter, econtext, &isnull);
+
+		if (isnull || !DatumGetBool(res))
+			isnull = true;
+		else
+			value = ExecEvalExpr((ExprState *) linitial(wfuncstate->args),
+								 econtext, &isnull);
+	}
+	else
+		value = ExecEvalExpr((ExprState *) linitial(wfuncstate->args),
+							 econtext, &isnull);
+
+	if (peraggstate->slideUpto - peraggstate->slideBase >=
+		peraggstate->slideSize)
+		sliding_aggregate_enlarge(peraggstate);
+
+	idx = peraggstate->slideUpto & (peraggstate->slideSize - 1);
+	peraggstate->slideValues[idx] = value;
+	peraggstate->slideNulls[idx] = isnull;
+	peraggstate->slideUpto++;
+
+	peraggstate->slideBack = sliding_combine(winstate, perfuncstate,
+											 peraggstate,
+											 peraggstate->slideBack,
+											 peraggstate->slideBackNull,
+											 value, isnull,
+											 &peraggstate->slideBackNull);
+
+	MemoryContextSwitchTo(oldContext);
+}
+
+/*
+ * advance_sliding_aggregate_base
+ * remove the rows before newbase from a sliding aggregate
+ *
+ * Rows are popped off the front stack.  When that runs empty, all rows of the
+ * back stack are moved over to it, computing the combined value of each
+ * suffix as we go.  Every row is thus combined a constant number of times,
+ * no matter how far the frame slides.
+ */
+static void
+advance_sliding_aggregate_base(WindowAggState *winstate,
+							   WindowStatePerFunc perfuncstate,
+							   WindowStatePerAgg peraggstate,
+							   int64 newbase)
+{
+	MemoryContext oldContext;
+
+	Assert(newbase <= peraggstate->slideUpto);
+
+	oldContext = MemoryContextSwitchTo(winstate->tmpcontext->ecxt_per_tuple_memory);
+
+	while (peraggstate->slideBase < newbase)
+	{
+		if (peraggstate->slideBase == peraggstate->slideFront)
+		{
+			int64		mask = peraggstate->slideSize - 1;
+			Datum		value = (Datum) 0;
+			bool		isnull = true;
+			int64		pos;
+
+			for (pos = peraggstate->slideUpto - 1;
+				 pos >= peraggstate->slideBase;
+				 pos--)
+			{
+				value = sliding_combine(winstate, perfuncstate, peraggstate,
+										peraggstate->slideValues[pos & mask],
+										peraggstate->slideNulls[pos & mask],
+										value, isnull,
+										&isnull);
+				peraggstate->slideSuffix[pos & mask] = value;
+				peraggstate->slideSuffixNulls[pos & mask] = isnull;
+			}
+			peraggstate->slideFront = peraggstate->slideUpto;
+			peraggstate->slideBack = (Datum) 0;
+			peraggstate->slideBackNull = true;
+		}
+		peraggstate->slideBase++;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+	ResetExprContext(winstate->tmpcontext);
+}
+
+/*
+ * sliding_aggregate_value
+ * set the transition value of a sliding aggregate from its two stacks,
+ * ready for finalize_windowaggregate()
+ */
+static void
+sliding_aggregate_value(WindowAggState *winstate,
+						WindowStatePerFunc perfuncstate,
+						WindowStatePerAgg peraggstate)
+{
+	MemoryContext oldContext;
+	int64		idx;
+
+	if (peraggstate->slideBase == peraggstate->slideFront)
+	{
+		peraggstate->transValue = peraggstate->slideBack;
+		peraggstate->transValueIsNull = peraggstate->slideBackNull;
+		return;
+	}
+
+	oldContext = MemoryContextSwitchTo(winstate->tmpcontext->ecxt_per_tuple_memory);
+	idx = peraggstate->slideBase & (peraggstate->slideSize - 1);
+	peraggstate->transValue =
+		sliding_combine(winstate, perfuncstate, peraggstate,
+						peraggstate->slideSuffix[idx],
+						peraggstate->slideSuffixNulls[idx],
+						peraggstate->slideBack,
+						peraggstate->slideBackNull,
+						&peraggstate->transValueIsNull);
+	MemoryContextSwitchTo(oldContext);
+}
+
 /*
  * eval_windowaggregates
  * evaluate plain aggregates being used as window functions
@@ -665,6 +1012,7 @@ eval_windowaggregates(WindowAggState *winstate)
 	int			wfuncno,
 				numaggs,
 				numaggs_restart,
+				numaggs_moving,
 				i;
 	int64		aggregatedupto_nonrestarted;
 	MemoryContext oldContext;
@@ -709,6 +1057,13 @@ eval_windowaggregates(WindowAggState *winstate)
 	 * must perform the aggregation all over again for all tuples within the
 	 * new frame boundaries.
 	 *
+	 * Aggregates without an inverse transition function, but with a strict
+	 * transfn whose first non-NULL input is its initial state and a combine
+	 * function (min and max being the prime examples), are instead handled
+	 * as "sliding" aggregates: we keep each frame row's input value in a
+	 * ring buffer organized as two stacks, so that rows can be dropped off
+	 * the frame head at amortized constant cost, without a restart.
+	 *
 	 * If there's any exclusion clause, then we may have to aggregate over a
 	 * non-contiguous set of rows, so we punt and recalculate for every row.
 	 * (For some frame end choices, it might be that the frame is always
@@ -785,7 +1140,8 @@ eval_windowaggregates(WindowAggState *winstate)
 		peraggstate = &winstate->peragg[i];
 		if (winstate->currentpos == 0 ||
 			(winstate->aggregatedbase != winstate->frameheadpos &&
-			 !OidIsValid(peraggstate->invtransfn_oid)) ||
+			 !OidIsValid(peraggstate->invtransfn_oid) &&
+			 !peraggstate->sliding) ||
 			(winstate->frameOptions & FRAMEOPTION_EXCLUSION) ||
 			winstate->aggregatedupto <= winstate->frameheadpos)
 		{
@@ -796,6 +1152,28 @@ eval_windowaggregates(WindowAggState *winstate)
 			peraggstate->restart = false;
 	}
 
+	/*
+	 * Sliding aggregates that are not restarting just drop the rows that
+	 * fell off the top of the frame; they don't need to re-read them.
+	 */
+	numaggs_moving = 0;
+	for (i = 0; i < numaggs; i++)
+	{
+		peraggstate = &winstate->peragg[i];
+		if (peraggstate->restart)
+			continue;
+		if (peraggstate->sliding)
+		{
+			wfuncno = peraggstate->wfuncno;
+			advance_sliding_aggregate_base(winstate,
+										   &winstate->perfunc[wfuncno],
+										   peraggstate,
+										   winstate->frameheadpos);
+		}
+		else
+			numaggs_moving++;
+	}
+
 	/*
 	 * If we have any possibly-moving aggregates, attempt to advance
 	 * aggregatedbase to match the frame's head by removing input rows that
@@ -803,7 +1181,7 @@ eval_windowaggregates(WindowAggState *winstate)
 	 * i.e. advance_windowaggregate_base() can return false, in which case
 	 * we'll restart that aggregate below.
 	 */
-	while (numaggs_restart < numaggs &&
+	while (numaggs_moving > 0 &&
 		   winstate->aggregatedbase < winstate->frameheadpos)
 	{
 		/*
@@ -826,7 +1204,7 @@ eval_windowaggregates(WindowAggState *winstate)
 			bool		ok;
 
 			peraggstate = &winstate->peragg[i];
-			if (peraggstate->restart)
+			if (peraggstate->restart || peraggstate->sliding)
 				continue;
 
 			wfuncno = peraggstate->wfuncno;
@@ -838,6 +1216,7 @@ eval_windowaggregates(WindowAggState *winstate)
 				/* Inverse transition function has failed, must restart */
 				peraggstate->restart = true;
 				numaggs_restart++;
+				numaggs_moving--;
 			}
 		}
 
@@ -961,9 +1340,14 @@ eval_windowaggregates(WindowAggState *winstate)
 				continue;
 
 			wfuncno = peraggstate->wfuncno;
-			advance_windowaggregate(winstate,
-									&winstate->perfunc[wfuncno],
-									peraggstate);
+			if (peraggstate->sliding)
+				advance_sliding_aggregate(winstate,
+										  &winstate->perfunc[wfuncno],
+										  peraggstate);
+			else
+				advance_windowaggregate(winstate,
+										&winstate->perfunc[wfuncno],
+										peraggstate);
 		}
 
 next_tuple:
@@ -990,6 +1374,10 @@ next_tuple:
 		wfuncno = peraggstate->wfuncno;
 		result = &econtext->ecxt_aggvalues[wfuncno];
 		isnull = &econtext->ecxt_aggnulls[wfuncno];
+		if (peraggstate->sliding)
+			sliding_aggregate_value(winstate,
+									&winstate->perfunc[wfuncno],
+									peraggstate);
 		finalize_windowaggregate(winstate,
 								 &winstate->perfunc[wfuncno],
 								 peraggstate,
@@ -2852,7 +3240,58 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 				 errmsg("strictness of aggregate's forward and inverse transition functions must match")));
 
 	/*
-	 * Moving aggregates use their own aggcontext.
+	 * If the frame head can move and we have no inverse transition function,
+	 * see whether we can run this as a sliding aggregate instead of
+	 * restarting it for every row.  That requires a strict transfn with NULL
+	 * initial value, so that each input value is its own one-row transition
+	 * value, a strict combine function that may merge such values in any
+	 * grouping (see sliding_combinefn_is_exact), and a pass-by-value
+	 * transtype, so that we can keep the per-row values without copying.  As
+	 * for moving aggregates, we avoid this if the arguments contain volatile
+	 * functions, since we'd evaluate them only once per row.
+	 */
+	peraggstate->sliding = false;
+	if (!OidIsValid(invtransfn_oid) &&
+		!(winstate->frameOptions & (FRAMEOPTION_START_UNBOUNDED_PRECEDING |
+									FRAMEOPTION_EXCLUSION)) &&
+		sliding_combinefn_is_exact(aggform->aggcombinefn) &&
+		numArguments == 1 &&
+		peraggstate->transfn.fn_strict &&
+		peraggstate->initValueIsNull &&
+		peraggstate->transtypeByVal &&
+		!contain_volatile_functions((Node *) wfunc))
+	{
+		Oid			combinefn_oid = aggform->aggcombinefn;
+		Oid			aggOwner;
+		HeapTuple	procTuple;
+		Expr	   *combinefnexpr;
+
+		procTuple = SearchSysCache1(PROCOID,
+									ObjectIdGetDatum(wfunc->winfnoid));
+		if (!HeapTupleIsValid(procTuple))
+			elog(ERROR, "cache lookup failed for function %u",
+				 wfunc->winfnoid);
+		aggOwner = ((Form_pg_proc) GETSTRUCT(procTuple))->proowner;
+		ReleaseSysCache(procTuple);
+
+		/* Quietly fall back to restarting if we can't call the combinefn */
+		if (pg_proc_aclcheck(combinefn_oid, aggOwner,
+							 ACL_EXECUTE) == ACLCHECK_OK)
+		{
+			InvokeFunctionExecuteHook(combinefn_oid);
+			build_aggregate_combinefn_expr(aggtranstype,
+										   wfunc->inputcollid,
+										   combinefn_oid,
+										   &combinefnexpr);
+			fmgr_info(combinefn_oid, &peraggstate->combinefn);
+			fmgr_info_set_expr((Node *) combinefnexpr,
+							   &peraggstate->combinefn);
+			peraggstate->sliding = peraggstate->combinefn.fn_strict;
+		}
+	}
+
+	/*
+	 * Moving and sliding aggregates use their own aggcontext.
 	 *
 	 * This is necessary because they might restart at different times, so we
 	 * might never be able to reset the shared context otherwise.  We can't
@@ -2863,9 +3302,10 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 	 * since we'd miss any indirectly referenced data.  We could, in theory,
 	 * make the memory allocation rules for moving aggregates different than
 	 * they have historically been for plain aggregates, but that seems grotty
-	 * and likely to lead to memory leaks.
+	 * and likely to lead to memory leaks.  Sliding aggregates keep their ring
+	 * buffer there, which must survive other aggregates' restarts.
 	 */
-	if (OidIsValid(invtransfn_oid))
+	if (OidIsValid(invtransfn_oid) || peraggstate->sliding)
 		peraggstate->aggcontext =
 			AllocSetContextCreate(CurrentMemoryContext,
 								  "WindowAgg Per Aggregate",
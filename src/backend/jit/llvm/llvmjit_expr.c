@@ -49,6 +49,13 @@ typedef struct CompiledExprState
 {
 	LLVMJitContext *context;
 	const char *funcname;
+
+	/*
+	 * Until the expression has been evaluated jit_warmup_calls times, it is
+	 * run by the interpreter function that ExecReadyInterpretedExpr() chose.
+	 */
+	int			calls;
+	ExprStateEvalFunc interp_func;
 } CompiledExprState;
 
 
@@ -534,12 +541,16 @@ llvm_compile_expr(ExprState *state)
 
 			case EEOP_FUNCEXPR:
 			case EEOP_FUNCEXPR_STRICT:
+			case EEOP_FUNCEXPR_STRICT_1:
+			case EEOP_FUNCEXPR_STRICT_2:
 				{
 					FunctionCallInfo fcinfo = op->d.func.fcinfo_data;
 					LLVMValueRef v_fcinfo_isnull;
 					LLVMValueRef v_retval;
 
-					if (opcode == EEOP_FUNCEXPR_STRICT)
+					if (opcode == EEOP_FUNCEXPR_STRICT ||
+						opcode == EEOP_FUNCEXPR_STRICT_1 ||
+						opcode == EEOP_FUNCEXPR_STRICT_2)
 					{
 						LLVMBasicBlockRef b_nonull;
 						LLVMBasicBlockRef *b_checkargnulls;
@@ -2385,10 +2396,12 @@ llvm_compile_expr(ExprState *state)
 /*
  * Run compiled expression.
  *
- * This will only be called the first time a JITed expression is called. We
- * first make sure the expression is still up2date, and then get a pointer to
- * the emitted function. The latter can be the first thing that triggers
- * optimizing and emitting all the generated functions.
+ * This will only be called for the first jit_warmup_calls + 1 evaluations of
+ * a JITed expression.  We first make sure the expression is still up2date.
+ * During warmup, we then evaluate it with the interpreter, so that queries
+ * that finish quickly don't pay for code generation.  After that we get a
+ * pointer to the emitted function.  The latter can be the first thing that
+ * triggers optimizing and emitting all the generated functions.
  */
 static Datum
 ExecRunCompiledExpr(ExprState *state, ExprContext *econtext, bool *isNull)
@@ -2396,7 +2409,27 @@ ExecRunCompiledExpr(ExprState *state, ExprContext *econtext, bool *isNull)
 	CompiledExprState *cstate = state->evalfunc_private;
 	ExprStateEvalFunc func;
 
-	CheckExprStillValid(state, econtext);
+	if (cstate->calls == 0)
+		CheckExprStillValid(state, econtext);
+
+	if (cstate->calls < jit_warmup_calls)
+	{
+		if (cstate->interp_func == NULL)
+		{
+			/*
+			 * Set up the interpreter, then put ourselves back in place.  We
+			 * have already done the check ExecInterpExprStillValid would do,
+			 * so call the function it would have installed directly.
+			 */
+			ExecReadyInterpretedExpr(state);
+			cstate->interp_func = (ExprStateEvalFunc) state->evalfunc_private;
+			state->evalfunc = ExecRunCompiledExpr;
+			state->evalfunc_private = cstate;
+		}
+
+		cstate->calls++;
+		return cstate->interp_func(state, econtext, isNull);
+	}
 
 	llvm_enter_fatal_on_oom();
 	func = (ExprStateEvalFunc) llvm_get_function(cstate->context,
@@ -53,10 +53,12 @@ struct dshash_table_item
 };
 
 /*
- * The number of partitions for locking purposes.  This is set to match
- * NUM_BUFFER_PARTITIONS for now, on the basis that whatever's good enough for
- * the buffer pool must be good enough for any other purpose.  This could
- * become a runtime parameter in future.
+ * The number of partitions for locking purposes.  This was originally set to
+ * match NUM_BUFFER_PARTITIONS, on the basis that whatever's good enough for
+ * the buffer pool must be good enough for any other purpose; dshash tables
+ * are much less heavily used than the buffer mapping table, so we haven't
+ * followed later increases of that.  This could become a runtime parameter
+ * in future.
  */
 #define DSHASH_NUM_PARTITIONS_LOG2 7
 #define DSHASH_NUM_PARTITIONS (1 << DSHASH_NUM_PARTITIONS_LOG2)
@@ -148,6 +148,7 @@ static int	socket_putmessage(char msgtype, const char *s, size_t len);
 static void socket_putmessage_noblock(char msgtype, const char *s, size_t len);
 static int	internal_putbytes(const char *s, size_t len);
 static int	internal_flush(void);
+static int	internal_flush_buffer(const char *buf, int *start, int *end);
 
 #ifdef HAVE_UNIX_SOCKETS
 static int	Lock_AF_UNIX(const char *unixSocketDir, const char *unixSocketPath);
@@ -1298,6 +1299,30 @@ internal_putbytes(const char *s, size_t len)
 			if (internal_flush())
 				return EOF;
 		}
+
+		/*
+		 * If the buffer is empty and the remaining data wouldn't fit in it
+		 * anyway, send it straight from the caller's memory instead of
+		 * copying it through the buffer piecewise.  This matters for large
+		 * DataRow and CopyData messages.
+		 */
+		if (PqSendStart == PqSendPointer && len >= (size_t) PqSendBufferSize)
+		{
+			int			start = 0;
+			int			end;
+
+			amount = Min(len, (size_t) PG_INT32_MAX);
+			end = (int) amount;
+
+			/* in blocking mode, success means everything was sent */
+			socket_set_nonblocking(false);
+			if (internal_flush_buffer(s, &start, &end))
+				return EOF;
+			s += amount;
+			len -= amount;
+			continue;
+		}
+
 		amount = PqSendBufferSize - PqSendPointer;
 		if (amount > len)
 			amount = len;
@@ -1339,17 +1364,31 @@ socket_flush(void)
  */
 static int
 internal_flush(void)
+{
+	return internal_flush_buffer(PqSendBuffer, &PqSendStart, &PqSendPointer);
+}
+
+/* --------------------------------
+ *		internal_flush_buffer - flush the given buffer content
+ *
+ * Sends buf[*start .. *end), advancing *start past whatever was sent.
+ * Returns 0 if OK (meaning everything was sent, or operation would block
+ * and the socket is in non-blocking mode), or EOF if trouble.
+ * --------------------------------
+ */
+static int
+internal_flush_buffer(const char *buf, int *start, int *end)
 {
 	static int	last_reported_send_errno = 0;
 
-	char	   *bufptr = PqSendBuffer + PqSendStart;
-	char	   *bufend = PqSendBuffer + PqSendPointer;
+	const char *bufptr = buf + *start;
+	const char *bufend = buf + *end;
 
 	while (bufptr < bufend)
 	{
 		int			r;
 
-		r = secure_write(MyProcPort, bufptr, bufend - bufptr);
+		r = secure_write(MyProcPort, unconstify(char *, bufptr), bufend - bufptr);
 
 		if (r <= 0)
 		{
@@ -1389,7 +1428,7 @@ internal_flush(void)
 			 * flag that'll cause the next CHECK_FOR_INTERRUPTS to terminate
 			 * the connection.
 			 */
-			PqSendStart = PqSendPointer = 0;
+			*start = *end = 0;
 			ClientConnectionLost = 1;
 			InterruptPending = 1;
 			return EOF;
@@ -1397,10 +1436,10 @@ internal_flush(void)
 
 		last_reported_send_errno = 0;	/* reset after any successful send */
 		bufptr += r;
-		PqSendStart += r;
+		*start += r;
 	}
 
-	PqSendStart = PqSendPointer = 0;
+	*start = *end = 0;
 	return 0;
 }
 
@@ -0,0 +1,254 @@
+/*------------------------------------------------------------------------
+ *
+ * geqo_greedy.c
+ *	  Deterministic greedy join search, used instead of the genetic
+ *	  algorithm when geqo_greedy is set
+ *
+ * This is "greedy operator ordering": starting from the initial relations,
+ * repeatedly join the pair of relations (or already-formed joins) whose join
+ * is estimated to be cheapest, until a single relation remains.  Unlike the
+ * genetic algorithm this always produces the same plan for the same input,
+ * and it can produce bushy plans.  Pairs connected by a join clause or a
+ * join order restriction are preferred; cartesian products are considered
+ * only when no such pair is left.
+ *
+ * Join order restrictions can still lead the search into a dead end, where
+ * the candidates left can't be joined in any way, say because an earlier
+ * merge clumped together relations that mustn't be joined yet due to
+ * LATERAL references.  There's no provision for un-merging, so we then give
+ * up and let geqo() fall back on the genetic algorithm, which tries many
+ * different join orders.
+ *
+ * The cost of joining any two candidates doesn't depend on the rest of the
+ * search, so it is computed once and remembered; after each merge only the
+ * pairs involving the new join have to be evaluated, making the search
+ * quadratic in the number of relations rather than cubic.
+ *
+ * Portions Copyright (c) 1996-2021, PostgreSQL Global Development Group
+ *
+ * src/backend/optimizer/geqo/geqo_greedy.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include <float.h>
+
+#include "optimizer/geqo.h"
+#include "optimizer/joininfo.h"
+#include "optimizer/pathnode.h"
+#include "optimizer/paths.h"
+#include "utils/memutils.h"
+
+
+/* cost matrix marker for a pair that hasn't been evaluated yet */
+#define GREEDY_COST_UNKNOWN		(-1.0)
+
+static Cost greedy_join_cost(PlannerInfo *root,
+							 RelOptInfo *outer_rel, RelOptInfo *inner_rel);
+static RelOptInfo *greedy_make_join(PlannerInfo *root,
+									RelOptInfo *outer_rel, RelOptInfo *inner_rel,
+									bool final);
+
+
+/*
+ * geqo_greedy_search
+ *	  Find a join order for the given relations by greedy merging.
+ *
+ * Returns NULL, having forgotten all the joins it built, if no legal join
+ * is left before all the relations have been joined.
+ */
+RelOptInfo *
+geqo_greedy_search(PlannerInfo *root, int number_of_rels, List *initial_rels)
+{
+	RelOptInfo **rels;
+	Cost	   *costs;
+	int			nrels = list_length(initial_rels);
+	int			remaining = nrels;
+	int			i;
+	ListCell   *lc;
+	int			savelength;
+	struct HTAB *savehash;
+
+	Assert(nrels == number_of_rels);
+
+	/*
+	 * Keep the joins we build out of any existing join_rel_hash, so that we
+	 * can forget them again if we fail; see geqo_eval().
+	 */
+	savelength = list_length(root->join_rel_list);
+	savehash = root->join_rel_hash;
+	root->join_rel_hash = NULL;
+
+	/* rels[i] is NULL once the i'th candidate has been merged away */
+	rels = (RelOptInfo **) palloc(nrels * sizeof(RelOptInfo *));
+	i = 0;
+	foreach(lc, initial_rels)
+		rels[i++] = (RelOptInfo *) lfirst(lc);
+
+	/* costs[i * nrels + j], for i < j, caches the cost of joining i and j */
+	costs = (Cost *) palloc((Size) nrels * nrels * sizeof(Cost));
+	for (i = 0; i < nrels * nrels; i++)
+		costs[i] = GREEDY_COST_UNKNOWN;
+
+	while (remaining > 1)
+	{
+		int			best_i = -1;
+		int			best_j = -1;
+		Cost		best_cost = DBL_MAX;
+		bool		force;
+
+		/*
+		 * First look only at pairs we'd want to join anyway; if there are
+		 * none, accept any legal join, even a cartesian product.
+		 */
+		for (force = false;; force = true)
+		{
+			for (i = 0; i < nrels; i++)
+			{
+				int			j;
+
+				if (rels[i] == NULL)
+					continue;
+
+				for (j = i + 1; j < nrels; j++)
+				{
+					Cost	   *cost = &costs[i * nrels + j];
+
+					if (rels[j] == NULL)
+						continue;
+
+					if (!force &&
+						!have_relevant_joinclause(root, rels[i], rels[j]) &&
+						!have_join_order_restriction(root, rels[i], rels[j]))
+						continue;
+
+					if (*cost == GREEDY_COST_UNKNOWN)
+						*cost = greedy_join_cost(root, rels[i], rels[j]);
+
+					if (*cost < best_cost)
+					{
+						best_cost = *cost;
+						best_i = i;
+						best_j = j;
+					}
+				}
+			}
+
+			if (best_i >= 0 || force)
+				break;
+		}
+
+		if (best_i < 0)
+		{
+			root->join_rel_list = list_truncate(root->join_rel_list,
+												savelength);
+			root->join_rel_hash = savehash;
+			pfree(rels);
+			pfree(costs);
+			return NULL;
+		}
+
+		/* Build the chosen join for real, replacing its first input */
+		rels[best_i] = greedy_make_join(root, rels[best_i], rels[best_j],
+										remaining == 2);
+		if (rels[best_i] == NULL)
+			elog(ERROR, "failed to build chosen join");
+		rels[best_j] = NULL;
+		remaining--;
+
+		/* Pairs involving the new join have to be re-evaluated */
+		for (i = 0; i < nrels; i++)
+		{
+			if (i < best_i)
+				costs[i * nrels + best_i] = GREEDY_COST_UNKNOWN;
+			else if (i > best_i)
+				costs[best_i * nrels + i] = GREEDY_COST_UNKNOWN;
+		}
+	}
+
+	for (i = 0; i < nrels; i++)
+	{
+		if (rels[i] != NULL)
+			return rels[i];
+	}
+
+	elog(ERROR, "failed to join all relations together");
+	return NULL;				/* keep compiler quiet */
+}
+
+/*
+ * greedy_join_cost
+ *	  Estimate the cost of joining two candidates, or DBL_MAX if the join
+ *	  is not legal.
+ *
+ * The trial join is built in a temporary memory context and then forgotten,
+ * the same way geqo_eval() does it.
+ */
+static Cost
+greedy_join_cost(PlannerInfo *root,
+				 RelOptInfo *outer_rel, RelOptInfo *inner_rel)
+{
+	MemoryContext mycontext;
+	MemoryContext oldcxt;
+	RelOptInfo *joinrel;
+	Cost		cost;
+	int			savelength;
+	struct HTAB *savehash;
+
+	mycontext = AllocSetContextCreate(CurrentMemoryContext,
+									  "GEQO greedy",
+									  ALLOCSET_DEFAULT_SIZES);
+	oldcxt = MemoryContextSwitchTo(mycontext);
+
+	/* See geqo_eval() for why this is needed */
+	savelength = list_length(root->join_rel_list);
+	savehash = root->join_rel_hash;
+	Assert(root->join_rel_level == NULL);
+
+	root->join_rel_hash = NULL;
+
+	joinrel = greedy_make_join(root, outer_rel, inner_rel, false);
+	cost = joinrel ? joinrel->cheapest_total_path->total_cost : DBL_MAX;
+
+	root->join_rel_list = list_truncate(root->join_rel_list, savelength);
+	root->join_rel_hash = savehash;
+
+	MemoryContextSwitchTo(oldcxt);
+	MemoryContextDelete(mycontext);
+
+	return cost;
+}
+
+/*
+ * greedy_make_join
+ *	  Build the join of two candidates and its paths, or return NULL if the
+ *	  join is not legal.  'final' says whether this is the topmost join.
+ */
+static RelOptInfo *
+greedy_make_join(PlannerInfo *root,
+				 RelOptInfo *outer_rel, RelOptInfo *inner_rel, bool final)
+{
+	RelOptInfo *joinrel;
+
+	joinrel = make_join_rel(root, outer_rel, inner_rel);
+	if (joinrel == NULL)
+		return NULL;
+
+	/* Create paths for partitionwise joins. */
+	generate_partitionwise_join_paths(root, joinrel);
+
+	/*
+	 * Except for the topmost scan/join rel, consider gathering partial
+	 * paths.  We'll do the same for the topmost scan/join rel once we know
+	 * the final targetlist (see grouping_planner).
+	 */
+	if (!final)
+		generate_useful_gather_paths(root, joinrel, false);
+
+	/* Find and save the cheapest paths for this joinrel */
+	set_cheapest(joinrel);
+
+	return joinrel;
+}
@@ -41,6 +41,7 @@ int			Geqo_pool_size;
 int			Geqo_generations;
 double		Geqo_selection_bias;
 double		Geqo_seed;
+bool		Geqo_greedy;
 
 
 static int	gimme_pool_size(int nr_rel);
@@ -93,6 +94,14 @@ geqo(PlannerInfo *root, int number_of_rels, List *initial_rels)
 	int			mutations = 0;
 #endif
 
+/* the greedy search needs none of the genetic machinery, unless it fails */
+	if (Geqo_greedy)
+	{
+		best_rel = geqo_greedy_search(root, number_of_rels, initial_rels);
+		if (best_rel != NULL)
+			return best_rel;
+	}
+
 /* set up private information */
 	root->join_search_private = (void *) &private;
 	private.initial_rels = initial_rels;
@@ -141,6 +141,7 @@ bool		enable_hashagg = true;
 bool		enable_nestloop = true;
 bool		enable_material = true;
 bool		enable_resultcache = true;
+bool		enable_subplan_resultcache = false;
 bool		enable_mergejoin = true;
 bool		enable_hashjoin = true;
 bool		enable_gathermerge = true;
@@ -3310,15 +3311,41 @@ initial_cost_mergejoin(PlannerInfo *root, JoinCostWorkspace *workspace,
 
 	if (outersortkeys)			/* do we need to sort outer? */
 	{
-		cost_sort(&sort_path,
-				  root,
-				  outersortkeys,
-				  outer_path->total_cost,
-				  outer_path_rows,
-				  outer_path->pathtarget->width,
-				  0.0,
-				  work_mem,
-				  -1.0);
+		int			presorted_keys = 0;
+
+		/*
+		 * If the outer input is already sorted on a prefix of the keys, we
+		 * sort it incrementally; create_mergejoin_plan() makes the same
+		 * choice.  The inner input needs mark/restore support, which
+		 * incremental sort lacks, so it always gets a full sort.
+		 */
+		if (enable_incremental_sort)
+			(void) pathkeys_count_contained_in(outersortkeys,
+											   outer_path->pathkeys,
+											   &presorted_keys);
+
+		if (presorted_keys > 0)
+			cost_incremental_sort(&sort_path,
+								  root,
+								  outersortkeys,
+								  presorted_keys,
+								  outer_path->startup_cost,
+								  outer_path->total_cost,
+								  outer_path_rows,
+								  outer_path->pathtarget->width,
+								  0.0,
+								  work_mem,
+								  -1.0);
+		else
+			cost_sort(&sort_path,
+					  root,
+					  outersortkeys,
+					  outer_path->total_cost,
+					  outer_path_rows,
+					  outer_path->pathtarget->width,
+					  0.0,
+					  work_mem,
+					  -1.0);
 		startup_cost += sort_path.startup_cost;
 		startup_cost += (sort_path.total_cost - sort_path.startup_cost)
 			* outerstartsel;
@@ -178,6 +178,10 @@ static void copy_generic_path_info(Plan *dest, Path *src);
 static void copy_plan_costsize(Plan *dest, Plan *src);
 static void label_sort_with_costsize(PlannerInfo *root, Sort *plan,
 									 double limit_tuples);
+static void label_incrementalsort_with_costsize(PlannerInfo *root,
+												IncrementalSort *plan,
+												List *pathkeys,
+												double limit_tuples);
 static SeqScan *make_seqscan(List *qptlist, List *qpqual, Index scanrelid);
 static SampleScan *make_samplescan(List *qptlist, List *qpqual, Index scanrelid,
 								   TableSampleClause *tsc);
@@ -4382,12 +4386,39 @@ create_mergejoin_plan(PlannerInfo *root,
 	if (best_path->outersortkeys)
 	{
 		Relids		outer_relids = outer_path->parent->relids;
-		Sort	   *sort = make_sort_from_pathkeys(outer_plan,
-												   best_path->outersortkeys,
-												   outer_relids);
+		int			presorted_keys = 0;
 
-		label_sort_with_costsize(root, sort, -1.0);
-		outer_plan = (Plan *) sort;
+		/*
+		 * Use an incremental sort if the outer input is already sorted on a
+		 * prefix of the keys; this must match initial_cost_mergejoin().
+		 */
+		if (enable_incremental_sort)
+			(void) pathkeys_count_contained_in(best_path->outersortkeys,
+											   outer_path->pathkeys,
+											   &presorted_keys);
+
+		if (presorted_keys > 0)
+		{
+			IncrementalSort *sort;
+
+			sort = make_incrementalsort_from_pathkeys(outer_plan,
+													  best_path->outersortkeys,
+													  outer_relids,
+													  presorted_keys);
+			label_incrementalsort_with_costsize(root, sort,
+												best_path->outersortkeys,
+												-1.0);
+			outer_plan = (Plan *) sort;
+		}
+		else
+		{
+			Sort	   *sort = make_sort_from_pathkeys(outer_plan,
+													   best_path->outersortkeys,
+													   outer_relids);
+
+			label_sort_with_costsize(root, sort, -1.0);
+			outer_plan = (Plan *) sort;
+		}
 		outerpathkeys = best_path->outersortkeys;
 	}
 	else
@@ -5308,10 +5339,7 @@ label_sort_with_costsize(PlannerInfo *root, Sort *plan, double limit_tuples)
 	Plan	   *lefttree = plan->plan.lefttree;
 	Path		sort_path;		/* dummy for result of cost_sort */
 
-	/*
-	 * This function shouldn't have to deal with IncrementalSort plans because
-	 * they are only created from corresponding Path nodes.
-	 */
+	/* IncrementalSort plans use label_incrementalsort_with_costsize() */
 	Assert(IsA(plan, Sort));
 
 	cost_sort(&sort_path, root, NIL,
@@ -5329,6 +5357,41 @@ label_sort_with_costsize(PlannerInfo *root, Sort *plan, double limit_tuples)
 	plan->plan.parallel_safe = lefttree->parallel_safe;
 }
 
+/*
+ * label_incrementalsort_with_costsize
+ *	  Set the cost estimates for an IncrementalSort plan node
+ *
+ * As with label_sort_with_costsize(), this is only for the case of an
+ * IncrementalSort made without a Path, currently the outer input of a
+ * MergeJoin.  'pathkeys' are the sort keys, which cost_incremental_sort()
+ * needs to estimate the number of presorted groups.
+ */
+static void
+label_incrementalsort_with_costsize(PlannerInfo *root, IncrementalSort *plan,
+									List *pathkeys, double limit_tuples)
+{
+	Plan	   *lefttree = plan->sort.plan.lefttree;
+	Path		sort_path;		/* dummy for result of cost_incremental_sort */
+
+	Assert(IsA(plan, IncrementalSort));
+
+	cost_incremental_sort(&sort_path, root, pathkeys,
+						  plan->nPresortedCols,
+						  lefttree->startup_cost,
+						  lefttree->total_cost,
+						  lefttree->plan_rows,
+						  lefttree->plan_width,
+						  0.0,
+						  work_mem,
+						  limit_tuples);
+	plan->sort.plan.startup_cost = sort_path.startup_cost;
+	plan->sort.plan.total_cost = sort_path.total_cost;
+	plan->sort.plan.plan_rows = lefttree->plan_rows;
+	plan->sort.plan.plan_width = lefttree->plan_width;
+	plan->sort.plan.parallel_aware = false;
+	plan->sort.plan.parallel_safe = lefttree->parallel_safe;
+}
+
 /*
  * bitmap_subplan_mark_shared
  *	 Set isshared flag in bitmap subplan so that it will be created in
@@ -6415,6 +6478,60 @@ materialize_finished_plan(Plan *subplan)
 	return matplan;
 }
 
+/*
+ * resultcache_finished_plan: stick a ResultCache node atop a completed plan
+ *
+ * This is used for correlated SubPlans, whose output is cached by the values
+ * of the Params in 'param_exprs'.  As with materialize_finished_plan(), there
+ * is no Path representation for this.  'hash_operators' gives the hashable
+ * equality operator for each of the Params.
+ */
+Plan *
+resultcache_finished_plan(Plan *subplan, List *param_exprs,
+						  List *hash_operators, bool singlerow)
+{
+	Plan	   *rcplan;
+	Oid		   *operators;
+	Oid		   *collations;
+	int			nkeys = list_length(param_exprs);
+	ListCell   *lc;
+	ListCell   *lc2;
+	int			i;
+
+	Assert(nkeys > 0);
+	operators = palloc(nkeys * sizeof(Oid));
+	collations = palloc(nkeys * sizeof(Oid));
+
+	i = 0;
+	forboth(lc, param_exprs, lc2, hash_operators)
+	{
+		operators[i] = lfirst_oid(lc2);
+		collations[i] = exprCollation((Node *) lfirst(lc));
+		i++;
+	}
+
+	/* we have no estimate of the number of distinct parameter values */
+	rcplan = (Plan *) make_resultcache(subplan, operators, collations,
+									   param_exprs, singlerow, 0);
+
+	/* see materialize_finished_plan() */
+	rcplan->initPlan = subplan->initPlan;
+	subplan->initPlan = NIL;
+
+	/*
+	 * Without a guess at the cache hit ratio, charge the same as the subplan
+	 * itself; this leaves cost_subplan()'s estimate unchanged.
+	 */
+	rcplan->startup_cost = subplan->startup_cost;
+	rcplan->total_cost = subplan->total_cost;
+	rcplan->plan_rows = subplan->plan_rows;
+	rcplan->plan_width = subplan->plan_width;
+	rcplan->parallel_aware = false;
+	rcplan->parallel_safe = subplan->parallel_safe;
+
+	return rcplan;
+}
+
 static ResultCache *
 make_resultcache(Plan *lefttree, Oid *hashoperators, Oid *collations,
 				 List *param_exprs, bool singlerow, uint32 est_entries)
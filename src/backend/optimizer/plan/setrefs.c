@@ -756,6 +756,13 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
 			{
 				ResultCache *rcplan = (ResultCache *) plan;
 
+				/*
+				 * Like Material, ResultCache doesn't project, so its tlist
+				 * just references its input.  This matters when it's atop a
+				 * SubPlan's plan, whose tlist may contain e.g. Aggrefs.
+				 */
+				set_dummy_tlist_references(plan, rtoffset);
+
 				rcplan->param_exprs = fix_scan_list(root, rcplan->param_exprs,
 													rtoffset,
 													NUM_EXEC_TLIST(plan));
@@ -1679,8 +1686,11 @@ fix_expr_common(PlannerInfo *root, Node *node)
 		set_sa_opfuncid(saop);
 		record_plan_function_dependency(root, saop->opfuncid);
 
-		if (!OidIsValid(saop->hashfuncid))
+		if (OidIsValid(saop->hashfuncid))
 			record_plan_function_dependency(root, saop->hashfuncid);
+
+		if (OidIsValid(saop->negfuncid))
+			record_plan_function_dependency(root, saop->negfuncid);
 	}
 	else if (IsA(node, Const))
 	{
@@ -17,8 +17,11 @@
 #include "postgres.h"
 
 #include "access/htup_details.h"
+#include "access/nbtree.h"
+#include "catalog/pg_am.h"
 #include "catalog/pg_operator.h"
 #include "catalog/pg_type.h"
+#include "commands/defrem.h"
 #include "executor/executor.h"
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
@@ -37,6 +40,7 @@
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
+#include "utils/typcache.h"
 
 
 typedef struct convert_testexpr_context
@@ -81,6 +85,10 @@ static Node *convert_testexpr(PlannerInfo *root,
 static Node *convert_testexpr_mutator(Node *node,
 									  convert_testexpr_context *context);
 static bool subplan_is_hashable(Plan *plan);
+static Plan *subplan_add_result_cache(PlannerInfo *root, PlannerInfo *subroot,
+									  Plan *plan, List *plan_params,
+									  SubLinkType subLinkType);
+static bool param_is_cacheable(Node *item, Oid *eqop);
 static bool subpath_is_hashable(Path *path);
 static bool testexpr_is_hashable(Node *testexpr, List *param_ids);
 static bool test_opexpr_is_hashable(OpExpr *testexpr, List *param_ids);
@@ -533,6 +541,17 @@ build_subplan(PlannerInfo *root, Plan *plan, PlannerInfo *subroot,
 				 !ExecMaterializesOutput(nodeTag(plan)))
 			plan = materialize_finished_plan(plan);
 
+		/*
+		 * A direct-correlated EXISTS or EXPR subplan can instead be topped
+		 * with a Result Cache, so that repeated parameter values are served
+		 * from the cache rather than by re-executing the subplan.
+		 */
+		else if (splan->parParam != NIL && enable_subplan_resultcache &&
+				 (subLinkType == EXISTS_SUBLINK ||
+				  subLinkType == EXPR_SUBLINK))
+			plan = subplan_add_result_cache(root, subroot, plan,
+											plan_params, subLinkType);
+
 		result = (Node *) splan;
 		isInitPlan = false;
 	}
@@ -740,6 +759,118 @@ subplan_is_hashable(Plan *plan)
 	return true;
 }
 
+/*
+ * subplan_add_result_cache: try to put a Result Cache atop a correlated subplan
+ *
+ * The cache is keyed by the Params that the current query level passes down
+ * to the subplan, so we may only do this if the subplan's output depends on
+ * nothing else, and if equal parameter values can't produce different
+ * output.  If either isn't certain, return the plan unchanged.
+ */
+static Plan *
+subplan_add_result_cache(PlannerInfo *root, PlannerInfo *subroot, Plan *plan,
+						 List *plan_params, SubLinkType subLinkType)
+{
+	Query	   *subquery = subroot->parse;
+	PlannerInfo *proot;
+	List	   *param_exprs = NIL;
+	List	   *hash_operators = NIL;
+	ListCell   *lc;
+
+	/*
+	 * Don't try to reason about nested sublinks, row locks or data-modifying
+	 * CTEs, and of course the results mustn't be volatile.
+	 */
+	if (subquery->hasSubLinks || subquery->hasModifyingCTE ||
+		subquery->rowMarks != NIL ||
+		contain_volatile_functions((Node *) subquery))
+		return plan;
+
+	/*
+	 * If any outer query level supplies parameters of its own, or is a
+	 * recursive query's worktable, the subplan might depend on values that
+	 * aren't part of the cache key.
+	 */
+	if (root->wt_param_id >= 0)
+		return plan;
+	for (proot = root->parent_root; proot != NULL; proot = proot->parent_root)
+	{
+		if (proot->plan_params != NIL || proot->init_plans != NIL ||
+			proot->wt_param_id >= 0)
+			return plan;
+	}
+
+	foreach(lc, plan_params)
+	{
+		PlannerParamItem *pitem = (PlannerParamItem *) lfirst(lc);
+		Param	   *prm;
+		Oid			eqop;
+
+		if (!param_is_cacheable(pitem->item, &eqop))
+			return plan;
+
+		prm = makeNode(Param);
+		prm->paramkind = PARAM_EXEC;
+		prm->paramid = pitem->paramId;
+		prm->paramtype = exprType(pitem->item);
+		prm->paramtypmod = exprTypmod(pitem->item);
+		prm->paramcollid = exprCollation(pitem->item);
+		prm->location = -1;
+
+		param_exprs = lappend(param_exprs, prm);
+		hash_operators = lappend_oid(hash_operators, eqop);
+	}
+
+	/*
+	 * An EXISTS subplan is only ever read up to its first row, so the cache
+	 * entry is complete at that point.  An EXPR subplan is read to the end
+	 * so that we can complain about multiple rows.
+	 */
+	return resultcache_finished_plan(plan, param_exprs, hash_operators,
+									 subLinkType == EXISTS_SUBLINK);
+}
+
+/*
+ * param_is_cacheable: can the value of this Param be used as a cache key?
+ *
+ * It must be hashable, and equality must imply that the values are
+ * interchangeable, since the subplan could use them in ways that tell equal
+ * values apart (compare numeric 1.0 and 1.00).  We use the default btree
+ * opclass's "equalimage" support function to check the latter, just as
+ * btree deduplication does.  On success, *eqop is set to the hashable
+ * equality operator.
+ */
+static bool
+param_is_cacheable(Node *item, Oid *eqop)
+{
+	Oid			type = exprType(item);
+	TypeCacheEntry *typentry;
+	Oid			opclass;
+	Oid			opcintype;
+	Oid			equalimageproc;
+
+	typentry = lookup_type_cache(type,
+								 TYPECACHE_HASH_PROC | TYPECACHE_EQ_OPR);
+	if (!OidIsValid(typentry->hash_proc) || !OidIsValid(typentry->eq_opr))
+		return false;
+
+	opclass = GetDefaultOpClass(type, BTREE_AM_OID);
+	if (!OidIsValid(opclass))
+		return false;
+	opcintype = get_opclass_input_type(opclass);
+	equalimageproc = get_opfamily_proc(get_opclass_family(opclass),
+									   opcintype, opcintype,
+									   BTEQUALIMAGE_PROC);
+	if (!OidIsValid(equalimageproc) ||
+		!DatumGetBool(OidFunctionCall1Coll(equalimageproc,
+										   exprCollation(item),
+										   ObjectIdGetDatum(opcintype))))
+		return false;
+
+	*eqop = typentry->eq_opr;
+	return true;
+}
+
 /*
  * subpath_is_hashable: can we implement an ANY subplan by hashing?
  *
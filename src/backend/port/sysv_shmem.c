@@ -24,15 +24,21 @@
 #include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #ifdef HAVE_SYS_IPC_H
 #include <sys/ipc.h>
 #endif
 #ifdef HAVE_SYS_SHM_H
 #include <sys/shm.h>
 #endif
+#ifdef HAVE_LINUX_MEMPOLICY_H
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
 
 #include "miscadmin.h"
 #include "port/pg_bitutils.h"
+#include "postmaster/fork_process.h"
 #include "portability/mem.h"
 #include "storage/dsm.h"
 #include "storage/fd.h"
@@ -101,6 +107,7 @@ static Size AnonymousShmemSize;
 static void *AnonymousShmem = NULL;
 
 static void *InternalIpcMemoryCreate(IpcMemoryKey memKey, Size size);
+static void PrefaultSharedMemory(void *addr, Size size);
 static void IpcMemoryDetach(int status, Datum shmaddr);
 static void IpcMemoryDelete(int status, Datum shmId);
 static IpcMemoryState PGSharedMemoryAttach(IpcMemoryId shmId,
@@ -587,6 +594,13 @@ CreateAnonymousSegment(Size *size)
 	}
 #endif
 
+	/*
+	 * Report whether huge pages are in use.  If we fail to get the segment
+	 * at all below, it doesn't matter.
+	 */
+	SetConfigOption("huge_pages_status", (ptr == MAP_FAILED) ? "off" : "on",
+					PGC_INTERNAL, PGC_S_DYNAMIC_DEFAULT);
+
 	if (ptr == MAP_FAILED && huge_pages != HUGE_PAGES_ON)
 	{
 		/*
@@ -618,6 +632,108 @@ CreateAnonymousSegment(Size *size)
 	return ptr;
 }
 
+/*
+ * SetSharedMemoryNumaPolicy --- apply shared_memory_numa_policy to a block
+ *
+ * This must be called before any of the pages in the block have been touched,
+ * since the policy only affects pages allocated afterwards.  We call the
+ * kernel directly rather than depend on libnuma for one system call.
+ */
+static void
+SetSharedMemoryNumaPolicy(void *addr, Size size)
+{
+#ifdef HAVE_LINUX_MEMPOLICY_H
+/* enough for any kernel configuration we're likely to meet */
+#define SHMEM_NUMA_MAX_NODES 1024
+	unsigned long nodemask[SHMEM_NUMA_MAX_NODES / (8 * sizeof(unsigned long))];
+
+	if (shared_memory_numa_policy != SHMEM_NUMA_INTERLEAVE)
+		return;
+
+	/*
+	 * Interleave over all nodes we're allowed to allocate memory on.  Note
+	 * that mbind() expects maxnode to be one more than the number of bits in
+	 * the mask.
+	 */
+	if (syscall(SYS_get_mempolicy, NULL, nodemask, SHMEM_NUMA_MAX_NODES,
+				NULL, MPOL_F_MEMS_ALLOWED) != 0 ||
+		syscall(SYS_mbind, addr, size, MPOL_INTERLEAVE, nodemask,
+				SHMEM_NUMA_MAX_NODES + 1, 0) != 0)
+		ereport(WARNING,
+				(errmsg("could not interleave shared memory across NUMA nodes: %m")));
+#else
+	/* guc.c doesn't accept any other values on this platform */
+	Assert(shared_memory_numa_policy == SHMEM_NUMA_DEFAULT);
+#endif
+}
+
+/*
+ * PrefaultSharedMemory --- touch every page of a freshly created block
+ *
+ * Otherwise, each page is faulted in by whichever backend touches it first,
+ * and right after startup that adds a page fault to a large fraction of all
+ * buffer accesses.  The work is split between shared_memory_prefault_workers
+ * short-lived child processes, so that the kernel can zero pages on several
+ * CPUs at once.  This runs before any other child processes have been
+ * launched from this shared memory state, with signals blocked, so we can
+ * simply wait for the children we start.
+ */
+static void
+PrefaultSharedMemory(void *addr, Size size)
+{
+	Size		pagesize = (Size) sysconf(_SC_PAGESIZE);
+	Size		chunksize;
+	pid_t	   *pids;
+	int			nworkers = shared_memory_prefault_workers;
+	int			nstarted;
+	char	   *start = (char *) addr;
+	char	   *end = start + size;
+
+	if (nworkers <= 0)
+		return;
+
+	chunksize = TYPEALIGN(pagesize, (size + nworkers - 1) / nworkers);
+	pids = palloc(nworkers * sizeof(pid_t));
+
+	for (nstarted = 0; nstarted < nworkers; nstarted++)
+	{
+		char	   *chunk = start + nstarted * chunksize;
+		pid_t		pid;
+
+		if (chunk >= end)
+			break;
+
+		pid = fork_process();
+		if (pid == 0)
+		{
+			char	   *chunkend = Min(chunk + chunksize, end);
+
+			/* Read and write back a byte of every page */
+			for (; chunk < chunkend; chunk += pagesize)
+				*(volatile char *) chunk = *(volatile char *) chunk;
+
+			_exit(0);
+		}
+		if (pid < 0)
+		{
+			ereport(LOG,
+					(errmsg("could not fork process to pre-fault shared memory: %m")));
+			break;
+		}
+		pids[nstarted] = pid;
+	}
+
+	while (nstarted > 0)
+	{
+		int			status;
+
+		if (waitpid(pids[--nstarted], &status, 0) < 0 && errno == EINTR)
+			nstarted++;			/* retry */
+	}
+
+	pfree(pids);
+}
+
 /*
  * AnonymousShmemDetach --- detach from an anonymous mmap'd block
  * (called as an on_shmem_exit callback, hence funny argument list)
@@ -684,6 +800,8 @@ PGSharedMemoryCreate(Size size,
 		AnonymousShmem = CreateAnonymousSegment(&size);
 		AnonymousShmemSize = size;
 
+		SetSharedMemoryNumaPolicy(AnonymousShmem, size);
+
 		/* Register on-exit routine to unmap the anonymous segment */
 		on_shmem_exit(AnonymousShmemDetach, (Datum) 0);
 
@@ -691,8 +809,14 @@ PGSharedMemoryCreate(Size size,
 		sysvsize = sizeof(PGShmemHeader);
 	}
 	else
+	{
 		sysvsize = size;
 
+		/* huge pages are only available with mmap */
+		SetConfigOption("huge_pages_status", "off",
+						PGC_INTERNAL, PGC_S_DYNAMIC_DEFAULT);
+	}
+
 	/*
 	 * Loop till we find a free IPC key.  Trust CreateDataDirLockFile() to
 	 * ensure no more than one postmaster per data directory can enter this
@@ -778,6 +902,10 @@ PGSharedMemoryCreate(Size size,
 			elog(LOG, "shmdt(%p) failed: %m", oldhdr);
 	}
 
+	/* If the SysV block is the main shared memory area, place it first */
+	if (AnonymousShmem == NULL)
+		SetSharedMemoryNumaPolicy(memAddress, size);
+
 	/* Initialize new segment. */
 	hdr = (PGShmemHeader *) memAddress;
 	hdr->creatorPID = getpid();
@@ -799,6 +927,9 @@ PGSharedMemoryCreate(Size size,
 	UsedShmemSegAddr = memAddress;
 	UsedShmemSegID = (unsigned long) NextShmemSegID;
 
+	/* Fault in the main shared memory area now, if requested */
+	PrefaultSharedMemory(AnonymousShmem ? AnonymousShmem : memAddress, size);
+
 	/*
 	 * If AnonymousShmem is NULL here, then we're not using anonymous shared
 	 * memory, and should return a pointer to the System V shared memory
@@ -16,6 +16,7 @@
 #include "storage/dsm.h"
 #include "storage/ipc.h"
 #include "storage/pg_shmem.h"
+#include "utils/guc.h"
 
 /*
  * Early in a process's life, Windows asynchronously creates threads for the
@@ -334,6 +335,11 @@ retry:
 
 	free(szShareMem);
 
+	/* Report whether we ended up with huge pages */
+	SetConfigOption("huge_pages_status",
+					(flProtect & SEC_LARGE_PAGES) != 0 ? "on" : "off",
+					PGC_INTERNAL, PGC_S_DYNAMIC_DEFAULT);
+
 	/*
 	 * Make the handle inheritable
 	 */
@@ -186,6 +186,13 @@ typedef struct av_relation
 								 * reloptions, or NULL if none */
 } av_relation;
 
+/* struct to keep track of tables found to need work, before sorting them */
+typedef struct av_candidate
+{
+	Oid			ac_relid;
+	double		ac_priority;	/* see relation_needs_vacanalyze */
+} av_candidate;
+
 /* struct to keep track of tables to vacuum and/or analyze, after rechecking */
 typedef struct autovac_table
 {
@@ -337,7 +344,11 @@ static void relation_needs_vacanalyze(Oid relid, AutoVacOpts *relopts,
 									  Form_pg_class classForm,
 									  PgStat_StatTabEntry *tabentry,
 									  int effective_multixact_freeze_max_age,
-									  bool *dovacuum, bool *doanalyze, bool *wraparound);
+									  bool *dovacuum, bool *doanalyze, bool *wraparound,
+									  double *priority);
+static void add_autovac_candidate(List **candidates, Oid relid,
+								  double priority);
+static int	av_candidate_cmp(const ListCell *a, const ListCell *b);
 
 static void autovacuum_do_vac_analyze(autovac_table *tab,
 									  BufferAccessStrategy bstrategy);
@@ -1958,6 +1969,7 @@ do_autovacuum(void)
 	TableScanDesc relScan;
 	Form_pg_database dbForm;
 	List	   *table_oids = NIL;
+	List	   *candidates = NIL;
 	List	   *orphan_oids = NIL;
 	HASHCTL		ctl;
 	HTAB	   *table_toast_map;
@@ -2126,6 +2138,7 @@ do_autovacuum(void)
 		bool		dovacuum;
 		bool		doanalyze;
 		bool		wraparound;
+		double		priority;
 
 		if (classForm->relkind != RELKIND_RELATION &&
 			classForm->relkind != RELKIND_MATVIEW &&
@@ -2167,11 +2180,12 @@ do_autovacuum(void)
 		/* Check if it needs vacuum or analyze */
 		relation_needs_vacanalyze(relid, relopts, classForm, tabentry,
 								  effective_multixact_freeze_max_age,
-								  &dovacuum, &doanalyze, &wraparound);
+								  &dovacuum, &doanalyze, &wraparound,
+								  &priority);
 
-		/* Relations that need work are added to table_oids */
+		/* Relations that need work are added to the candidates */
 		if (dovacuum || doanalyze)
-			table_oids = lappend_oid(table_oids, relid);
+			add_autovac_candidate(&candidates, relid, priority);
 
 		/*
 		 * Remember TOAST associations for the second pass.  Note: we must do
@@ -2220,6 +2234,7 @@ do_autovacuum(void)
 		bool		dovacuum;
 		bool		doanalyze;
 		bool		wraparound;
+		double		priority;
 
 		/*
 		 * We cannot safely process other backends' temp tables, so skip 'em.
@@ -2250,16 +2265,32 @@ do_autovacuum(void)
 
 		relation_needs_vacanalyze(relid, relopts, classForm, tabentry,
 								  effective_multixact_freeze_max_age,
-								  &dovacuum, &doanalyze, &wraparound);
+								  &dovacuum, &doanalyze, &wraparound,
+								  &priority);
 
 		/* ignore analyze for toast tables */
 		if (dovacuum)
-			table_oids = lappend_oid(table_oids, relid);
+			add_autovac_candidate(&candidates, relid, priority);
 	}
 
 	table_endscan(relScan);
 	table_close(classRel, AccessShareLock);
 
+	/*
+	 * Process the tables that are most urgently in need of work first, rather
+	 * than in pg_class order, so that a heavily bloated table or one close to
+	 * wraparound doesn't have to wait for many others that barely crossed
+	 * their thresholds.
+	 */
+	list_sort(candidates, av_candidate_cmp);
+	foreach(cell, candidates)
+	{
+		av_candidate *cand = (av_candidate *) lfirst(cell);
+
+		table_oids = lappend_oid(table_oids, cand->ac_relid);
+	}
+	list_free_deep(candidates);
+
 	/*
 	 * Recheck orphan temporary tables, and if they still seem orphaned, drop
 	 * them.  We'll eat a transaction per dropped table, which might seem
@@ -2727,6 +2758,10 @@ perform_work_item(AutoVacuumWorkItem *workitem)
 									ObjectIdGetDatum(workitem->avw_relation),
 									Int64GetDatum((int64) workitem->avw_blockNumber));
 				break;
+			case AVW_GINCleanupPendingList:
+				DirectFunctionCall1(gin_clean_pending_list,
+									ObjectIdGetDatum(workitem->avw_relation));
+				break;
 			default:
 				elog(WARNING, "unrecognized work item found: type %d",
 					 workitem->avw_type);
@@ -3052,7 +3087,7 @@ recheck_relation_needs_vacanalyze(Oid relid,
 
 	relation_needs_vacanalyze(relid, avopts, classForm, tabentry,
 							  effective_multixact_freeze_max_age,
-							  dovacuum, doanalyze, wraparound);
+							  dovacuum, doanalyze, wraparound, NULL);
 
 	/* ignore ANALYZE for toast tables */
 	if (classForm->relkind == RELKIND_TOASTVALUE)
@@ -3095,6 +3130,12 @@ recheck_relation_needs_vacanalyze(Oid relid,
  * autovacuum_vacuum_threshold GUC variable.  Similarly, a vac_scale_factor
  * value < 0 is substituted with the value of
  * autovacuum_vacuum_scale_factor GUC variable.  Ditto for analyze.
+ *
+ * If priority isn't NULL, we also return there how urgently the table needs
+ * work, for do_autovacuum to decide the processing order.  Tables forced for
+ * wraparound get the highest priorities, ordered by how far past their freeze
+ * age they are.  The others are ranked by how far their dead, inserted or
+ * changed tuple counts exceed the corresponding thresholds.
  */
 static void
 relation_needs_vacanalyze(Oid relid,
@@ -3105,7 +3146,8 @@ relation_needs_vacanalyze(Oid relid,
  /* output params below */
 						  bool *dovacuum,
 						  bool *doanalyze,
-						  bool *wraparound)
+						  bool *wraparound,
+						  double *priority)
 {
 	bool		force_vacuum;
 	bool		av_enabled;
@@ -3197,6 +3239,26 @@ relation_needs_vacanalyze(Oid relid,
 	}
 	*wraparound = force_vacuum;
 
+	if (priority)
+	{
+		*priority = 0;
+		if (force_vacuum)
+		{
+			double		xid_age = 0;
+			double		mxid_age = 0;
+
+			if (TransactionIdIsNormal(classForm->relfrozenxid))
+				xid_age = (double) (int32) (recentXid - classForm->relfrozenxid) /
+					Max(freeze_max_age, 1);
+			if (MultiXactIdIsValid(classForm->relminmxid))
+				mxid_age = (double) (int32) (recentMulti - classForm->relminmxid) /
+					Max(multixact_freeze_max_age, 1);
+
+			/* Above anything that isn't being forced */
+			*priority = 1.0e10 + Max(xid_age, mxid_age);
+		}
+	}
+
 	/* User disabled it in pg_class.reloptions?  (But ignore if at risk) */
 	if (!av_enabled && !force_vacuum)
 	{
@@ -3245,6 +3307,14 @@ relation_needs_vacanalyze(Oid relid,
 		*dovacuum = force_vacuum || (vactuples > vacthresh) ||
 			(vac_ins_base_thresh >= 0 && instuples > vacinsthresh);
 		*doanalyze = (anltuples > anlthresh);
+
+		if (priority && !force_vacuum)
+		{
+			*priority = vactuples / Max(vacthresh, 1);
+			if (vac_ins_base_thresh >= 0)
+				*priority = Max(*priority, instuples / Max(vacinsthresh, 1));
+			*priority = Max(*priority, anltuples / Max(anlthresh, 1));
+		}
 	}
 	else
 	{
@@ -3262,6 +3332,36 @@ relation_needs_vacanalyze(Oid relid,
 		*doanalyze = false;
 }
 
+/*
+ * add_autovac_candidate
+ *		Remember a table found by do_autovacuum to need work
+ */
+static void
+add_autovac_candidate(List **candidates, Oid relid, double priority)
+{
+	av_candidate *cand = palloc(sizeof(av_candidate));
+
+	cand->ac_relid = relid;
+	cand->ac_priority = priority;
+	*candidates = lappend(*candidates, cand);
+}
+
+/*
+ * list_sort comparator sorting av_candidates by descending priority
+ */
+static int
+av_candidate_cmp(const ListCell *a, const ListCell *b)
+{
+	av_candidate *ca = (av_candidate *) lfirst(a);
+	av_candidate *cb = (av_candidate *) lfirst(b);
+
+	if (ca->ac_priority > cb->ac_priority)
+		return -1;
+	if (ca->ac_priority < cb->ac_priority)
+		return 1;
+	return 0;
+}
+
 /*
  * autovacuum_do_vac_analyze
  *		Vacuum and/or analyze the specified table
@@ -3344,6 +3444,10 @@ autovac_report_workitem(AutoVacuumWorkItem *workitem,
 			snprintf(activity, MAX_AUTOVAC_ACTIV_LEN,
 					 "autovacuum: BRIN summarize");
 			break;
+		case AVW_GINCleanupPendingList:
+			snprintf(activity, MAX_AUTOVAC_ACTIV_LEN,
+					 "autovacuum: GIN pending list cleanup");
+			break;
 	}
 
 	/*
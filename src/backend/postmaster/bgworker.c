@@ -1312,3 +1312,40 @@ GetBackgroundWorkerTypeByPid(pid_t pid)
 
 	return result;
 }
+
+/*
+ * Given a PID, get a handle for the dynamic background worker running in that
+ * process, so that a backend other than the one that registered it can
+ * monitor or terminate it.  Returns NULL if there is no such worker, or if it
+ * has been asked to terminate.
+ *
+ * The handle is allocated in the current memory context.
+ */
+BackgroundWorkerHandle *
+GetBackgroundWorkerHandleByPid(pid_t pid)
+{
+	int			slotno;
+	BackgroundWorkerHandle *handle = NULL;
+
+	LWLockAcquire(BackgroundWorkerLock, LW_SHARED);
+
+	for (slotno = 0; slotno < BackgroundWorkerData->total_slots; slotno++)
+	{
+		BackgroundWorkerSlot *slot = &BackgroundWorkerData->slot[slotno];
+
+		if (slot->in_use && slot->pid > 0 && slot->pid == pid)
+		{
+			if (!slot->terminate)
+			{
+				handle = palloc(sizeof(BackgroundWorkerHandle));
+				handle->slot = slotno;
+				handle->generation = slot->generation;
+			}
+			break;
+		}
+	}
+
+	LWLockRelease(BackgroundWorkerLock);
+
+	return handle;
+}
@@ -503,6 +503,8 @@ CheckpointerMain(void)
 		 * stats message types.)
 		 */
 		pgstat_send_bgwriter();
+		pgstat_send_io();
+		pgstat_send_lwlock();
 
 		/* Send WAL statistics to the stats collector. */
 		pgstat_report_wal();
@@ -583,6 +585,8 @@ HandleCheckpointerInterrupts(void)
 		BgWriterStats.m_requested_checkpoints++;
 		ShutdownXLOG(0, 0);
 		pgstat_send_bgwriter();
+		pgstat_send_io();
+		pgstat_send_lwlock();
 		pgstat_report_wal();
 
 		/* Normal exit from the checkpointer is here */
@@ -725,6 +729,8 @@ CheckpointWriteDelay(int flags, double progress)
 		 * Report interim activity statistics to the stats collector.
 		 */
 		pgstat_send_bgwriter();
+		pgstat_send_io();
+		pgstat_send_lwlock();
 
 		/*
 		 * This sleep used to be connected to bgwriter_delay, typically 200ms.
@@ -49,6 +49,7 @@
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "pgstat.h"
+#include "port/pg_bitutils.h"
 #include "postmaster/autovacuum.h"
 #include "postmaster/fork_process.h"
 #include "postmaster/interrupt.h"
@@ -166,6 +167,19 @@ static const char *const slru_names[] = {
  */
 static PgStat_MsgSLRU SLRUStats[SLRU_NUM_ELEMENTS];
 
+/*
+ * I/O statistics counts waiting to be sent to the collector, likewise kept
+ * in message format.  We assume this variable inits to zeroes.
+ */
+static PgStat_MsgIO IOStats;
+
+/*
+ * LWLock wait counts waiting to be sent to the collector, one entry per
+ * PGSTAT_NUM_LWLOCK_TRANCHES slot.  We assume this variable inits to zeroes.
+ */
+static PgStat_LWLockCounters LWLockStats[PGSTAT_NUM_LWLOCK_TRANCHES];
+static bool have_lwlock_stats = false;
+
 /* ----------
  * Local data
  * ----------
@@ -279,6 +293,8 @@ static PgStat_ArchiverStats archiverStats;
 static PgStat_GlobalStats globalStats;
 static PgStat_WalStats walStats;
 static PgStat_SLRUStats slruStats[SLRU_NUM_ELEMENTS];
+static PgStat_IOStats ioStats;
+static PgStat_LWLockStats lwlockStats;
 static HTAB *replSlotStatHash = NULL;
 static PgStat_RecoveryPrefetchStats recoveryPrefetchStats;
 
@@ -352,6 +368,8 @@ static void pgstat_recv_archiver(PgStat_MsgArchiver *msg, int len);
 static void pgstat_recv_bgwriter(PgStat_MsgBgWriter *msg, int len);
 static void pgstat_recv_wal(PgStat_MsgWal *msg, int len);
 static void pgstat_recv_slru(PgStat_MsgSLRU *msg, int len);
+static void pgstat_recv_io(PgStat_MsgIO *msg, int len);
+static void pgstat_recv_lwlock(PgStat_MsgLWLock *msg, int len);
 static void pgstat_recv_recoveryprefetch(PgStat_MsgRecoveryPrefetch *msg, int len);
 static void pgstat_recv_funcstat(PgStat_MsgFuncstat *msg, int len);
 static void pgstat_recv_funcpurge(PgStat_MsgFuncpurge *msg, int len);
@@ -953,8 +971,14 @@ pgstat_report_stat(bool disconnect)
 	/* Send WAL statistics */
 	pgstat_report_wal();
 
-	/* Finally send SLRU statistics */
+	/* Send SLRU statistics */
 	pgstat_send_slru();
+
+	/* Send I/O statistics */
+	pgstat_send_io();
+
+	/* Finally send LWLock wait statistics */
+	pgstat_send_lwlock();
 }
 
 /*
@@ -1446,6 +1470,10 @@ pgstat_reset_shared_counters(const char *target)
 		msg.m_resettarget = RESET_BGWRITER;
 	else if (strcmp(target, "wal") == 0)
 		msg.m_resettarget = RESET_WAL;
+	else if (strcmp(target, "io") == 0)
+		msg.m_resettarget = RESET_IO;
+	else if (strcmp(target, "lwlock") == 0)
+		msg.m_resettarget = RESET_LWLOCK;
 	else if (strcmp(target, "prefetch_recovery") == 0)
 	{
 		/*
@@ -1459,7 +1487,7 @@ pgstat_reset_shared_counters(const char *target)
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 				 errmsg("unrecognized reset target: \"%s\"", target),
-				 errhint("Target must be \"archiver\", \"bgwriter\", \"wal\" or \"prefetch_recovery\".")));
+				 errhint("Target must be \"archiver\", \"bgwriter\", \"wal\", \"io\", \"lwlock\" or \"prefetch_recovery\".")));
 
 	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETSHAREDCOUNTER);
 	pgstat_send(&msg, sizeof(msg));
@@ -2881,6 +2909,38 @@ pgstat_fetch_slru(void)
 	return slruStats;
 }
 
+/*
+ * ---------
+ * pgstat_fetch_stat_io() -
+ *
+ *	Support function for the SQL-callable pgstat* functions. Returns
+ *	a pointer to the I/O statistics struct.
+ * ---------
+ */
+PgStat_IOStats *
+pgstat_fetch_stat_io(void)
+{
+	backend_read_statsfile();
+
+	return &ioStats;
+}
+
+/*
+ * ---------
+ * pgstat_fetch_stat_lwlock() -
+ *
+ *	Support function for the SQL-callable pgstat* functions. Returns
+ *	a pointer to the LWLock wait statistics struct.
+ * ---------
+ */
+PgStat_LWLockStats *
+pgstat_fetch_stat_lwlock(void)
+{
+	backend_read_statsfile();
+
+	return &lwlockStats;
+}
+
 /*
  * ---------
  * pgstat_fetch_replslot() -
@@ -3187,6 +3247,95 @@ pgstat_send_slru(void)
 	}
 }
 
+/* ----------
+ * pgstat_send_io() -
+ *
+ *		Send I/O statistics to the collector
+ *
+ * Processes that don't call pgstat_report_stat(), like the checkpointer and
+ * the background writer, call this themselves.
+ * ----------
+ */
+void
+pgstat_send_io(void)
+{
+	/* We assume this initializes to zeroes */
+	static const PgStat_MsgIO all_zeroes;
+
+	/*
+	 * This function can be called even if nothing at all has happened. In
+	 * this case, avoid sending a completely empty message to the stats
+	 * collector.
+	 */
+	if (memcmp(&IOStats, &all_zeroes, sizeof(PgStat_MsgIO)) == 0)
+		return;
+
+	/*
+	 * Prepare and send the message
+	 */
+	IOStats.m_backend_type = MyBackendType;
+	pgstat_setheader(&IOStats.m_hdr, PGSTAT_MTYPE_IO);
+	pgstat_send(&IOStats, sizeof(PgStat_MsgIO));
+
+	/*
+	 * Clear out the statistics buffer, so it can be re-used.
+	 */
+	MemSet(&IOStats, 0, sizeof(PgStat_MsgIO));
+}
+
+/* ----------
+ * pgstat_send_lwlock() -
+ *
+ *		Send LWLock wait statistics to the collector
+ *
+ * Only tranches that were waited on since the last call are sent.  Like
+ * pgstat_send_io(), this is called by processes that don't call
+ * pgstat_report_stat() themselves.
+ * ----------
+ */
+void
+pgstat_send_lwlock(void)
+{
+	PgStat_MsgLWLock msg;
+	int			i;
+
+	if (!have_lwlock_stats)
+		return;
+
+	pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_LWLOCK);
+	msg.m_nentries = 0;
+
+	for (i = 0; i < PGSTAT_NUM_LWLOCK_TRANCHES; i++)
+	{
+		PgStat_LWLockEntry *m_ent;
+
+		if (LWLockStats[i].waits == 0)
+			continue;
+
+		m_ent = &msg.m_entry[msg.m_nentries];
+		m_ent->l_tranche = i;
+		memcpy(&m_ent->l_counters, &LWLockStats[i],
+			   sizeof(PgStat_LWLockCounters));
+
+		if (++msg.m_nentries >= PGSTAT_NUM_LWLOCKENTRIES)
+		{
+			pgstat_send(&msg, offsetof(PgStat_MsgLWLock, m_entry[0]) +
+						msg.m_nentries * sizeof(PgStat_LWLockEntry));
+			msg.m_nentries = 0;
+		}
+	}
+
+	if (msg.m_nentries > 0)
+		pgstat_send(&msg, offsetof(PgStat_MsgLWLock, m_entry[0]) +
+					msg.m_nentries * sizeof(PgStat_LWLockEntry));
+
+	/*
+	 * Clear out the statistics buffer, so it can be re-used.
+	 */
+	MemSet(LWLockStats, 0, sizeof(LWLockStats));
+	have_lwlock_stats = false;
+}
+
 
 /* ----------
  * pgstat_send_recoveryprefetch() -
@@ -3422,6 +3571,14 @@ PgstatCollectorMain(int argc, char *argv[])
 					pgstat_recv_slru(&msg.msg_slru, len);
 					break;
 
+				case PGSTAT_MTYPE_IO:
+					pgstat_recv_io(&msg.msg_io, len);
+					break;
+
+				case PGSTAT_MTYPE_LWLOCK:
+					pgstat_recv_lwlock(&msg.msg_lwlock, len);
+					break;
+
 				case PGSTAT_MTYPE_RECOVERYPREFETCH:
 					pgstat_recv_recoveryprefetch(&msg.msg_recoveryprefetch, len);
 					break;
@@ -3718,6 +3875,18 @@ pgstat_write_statsfiles(bool permanent, bool allDbs)
 	rc = fwrite(slruStats, sizeof(slruStats), 1, fpout);
 	(void) rc;					/* we'll check for error with ferror */
 
+	/*
+	 * Write I/O stats struct
+	 */
+	rc = fwrite(&ioStats, sizeof(ioStats), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+
+	/*
+	 * Write LWLock stats struct
+	 */
+	rc = fwrite(&lwlockStats, sizeof(lwlockStats), 1, fpout);
+	(void) rc;					/* we'll check for error with ferror */
+
 	/*
 	 * Write recovery prefetch stats struct
 	 */
@@ -3993,13 +4162,15 @@ pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
 						 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
 
 	/*
-	 * Clear out global, archiver, WAL and SLRU statistics so they start from
-	 * zero in case we can't load an existing statsfile.
+	 * Clear out global, archiver, WAL, SLRU, I/O and LWLock statistics so
+	 * they start from zero in case we can't load an existing statsfile.
 	 */
 	memset(&globalStats, 0, sizeof(globalStats));
 	memset(&archiverStats, 0, sizeof(archiverStats));
 	memset(&walStats, 0, sizeof(walStats));
 	memset(&slruStats, 0, sizeof(slruStats));
+	memset(&ioStats, 0, sizeof(ioStats));
+	memset(&lwlockStats, 0, sizeof(lwlockStats));
 	memset(&recoveryPrefetchStats, 0, sizeof(recoveryPrefetchStats));
 
 	/*
@@ -4009,6 +4180,8 @@ pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
 	globalStats.stat_reset_timestamp = GetCurrentTimestamp();
 	archiverStats.stat_reset_timestamp = globalStats.stat_reset_timestamp;
 	walStats.stat_reset_timestamp = globalStats.stat_reset_timestamp;
+	ioStats.stat_reset_timestamp = globalStats.stat_reset_timestamp;
+	lwlockStats.stat_reset_timestamp = globalStats.stat_reset_timestamp;
 
 	/*
 	 * Set the same reset timestamp for all SLRU items too.
@@ -4100,6 +4273,28 @@ pgstat_read_statsfiles(Oid onlydb, bool permanent, bool deep)
 		goto done;
 	}
 
+	/*
+	 * Read I/O stats struct
+	 */
+	if (fread(&ioStats, 1, sizeof(ioStats), fpin) != sizeof(ioStats))
+	{
+		ereport(pgStatRunningInCollector ? LOG : WARNING,
+				(errmsg("corrupted statistics file \"%s\"", statfile)));
+		memset(&ioStats, 0, sizeof(ioStats));
+		goto done;
+	}
+
+	/*
+	 * Read LWLock stats struct
+	 */
+	if (fread(&lwlockStats, 1, sizeof(lwlockStats), fpin) != sizeof(lwlockStats))
+	{
+		ereport(pgStatRunningInCollector ? LOG : WARNING,
+				(errmsg("corrupted statistics file \"%s\"", statfile)));
+		memset(&lwlockStats, 0, sizeof(lwlockStats));
+		goto done;
+	}
+
 	/*
 	 * Read recoveryPrefetchStats struct
 	 */
@@ -4451,6 +4646,8 @@ pgstat_read_db_statsfile_timestamp(Oid databaseid, bool permanent,
 	PgStat_ArchiverStats myArchiverStats;
 	PgStat_WalStats myWalStats;
 	PgStat_SLRUStats mySLRUStats[SLRU_NUM_ELEMENTS];
+	PgStat_IOStats myIOStats;
+	PgStat_LWLockStats myLWLockStats;
 	PgStat_StatReplSlotEntry myReplSlotStats;
 	PgStat_RecoveryPrefetchStats myRecoveryPrefetchStats;
 	FILE	   *fpin;
@@ -4529,6 +4726,28 @@ pgstat_read_db_statsfile_timestamp(Oid databaseid, bool permanent,
 		return false;
 	}
 
+	/*
+	 * Read I/O stats struct
+	 */
+	if (fread(&myIOStats, 1, sizeof(myIOStats), fpin) != sizeof(myIOStats))
+	{
+		ereport(pgStatRunningInCollector ? LOG : WARNING,
+				(errmsg("corrupted statistics file \"%s\"", statfile)));
+		FreeFile(fpin);
+		return false;
+	}
+
+	/*
+	 * Read LWLock stats struct
+	 */
+	if (fread(&myLWLockStats, 1, sizeof(myLWLockStats), fpin) != sizeof(myLWLockStats))
+	{
+		ereport(pgStatRunningInCollector ? LOG : WARNING,
+				(errmsg("corrupted statistics file \"%s\"", statfile)));
+		FreeFile(fpin);
+		return false;
+	}
+
 	/*
 	 * Read recovery prefetch stats struct
 	 */
@@ -5147,6 +5366,18 @@ pgstat_recv_resetsharedcounter(PgStat_MsgResetsharedcounter *msg, int len)
 		memset(&walStats, 0, sizeof(walStats));
 		walStats.stat_reset_timestamp = GetCurrentTimestamp();
 	}
+	else if (msg->m_resettarget == RESET_IO)
+	{
+		/* Reset the I/O statistics for the cluster. */
+		memset(&ioStats, 0, sizeof(ioStats));
+		ioStats.stat_reset_timestamp = GetCurrentTimestamp();
+	}
+	else if (msg->m_resettarget == RESET_LWLOCK)
+	{
+		/* Reset the LWLock wait statistics for the cluster. */
+		memset(&lwlockStats, 0, sizeof(lwlockStats));
+		lwlockStats.stat_reset_timestamp = GetCurrentTimestamp();
+	}
 
 	/*
 	 * Presumably the sender of this message validated the target, don't
@@ -5470,6 +5701,58 @@ pgstat_recv_slru(PgStat_MsgSLRU *msg, int len)
 	slruStats[msg->m_index].truncate += msg->m_truncate;
 }
 
+/* ----------
+ * pgstat_recv_io() -
+ *
+ *	Process an I/O message.
+ * ----------
+ */
+static void
+pgstat_recv_io(PgStat_MsgIO *msg, int len)
+{
+	for (int obj = 0; obj < IOOBJECT_NUM_TYPES; obj++)
+	{
+		for (int ctx = 0; ctx < IOCONTEXT_NUM_TYPES; ctx++)
+		{
+			PgStat_IOCounters *counters =
+			&ioStats.counters[msg->m_backend_type][obj][ctx];
+			PgStat_IOCounters *add = &msg->m_counters[obj][ctx];
+
+			for (int op = 0; op < IOOP_NUM_TYPES; op++)
+			{
+				counters->ops[op] += add->ops[op];
+				counters->times[op] += add->times[op];
+			}
+		}
+	}
+}
+
+/* ----------
+ * pgstat_recv_lwlock() -
+ *
+ *	Process an LWLock wait statistics message.
+ * ----------
+ */
+static void
+pgstat_recv_lwlock(PgStat_MsgLWLock *msg, int len)
+{
+	for (int i = 0; i < msg->m_nentries; i++)
+	{
+		PgStat_LWLockEntry *entry = &msg->m_entry[i];
+		PgStat_LWLockCounters *counters;
+
+		if (entry->l_tranche < 0 ||
+			entry->l_tranche >= PGSTAT_NUM_LWLOCK_TRANCHES)
+			continue;
+
+		counters = &lwlockStats.tranches[entry->l_tranche];
+		counters->waits += entry->l_counters.waits;
+		counters->wait_time += entry->l_counters.wait_time;
+		for (int bucket = 0; bucket < PGSTAT_LWLOCK_HIST_BUCKETS; bucket++)
+			counters->hist[bucket] += entry->l_counters.hist[bucket];
+	}
+}
+
 /* ----------
  * pgstat_recv_recoveryprefetch() -
  *
@@ -5959,3 +6242,99 @@ pgstat_count_slru_truncate(int slru_idx)
 {
 	slru_entry(slru_idx)->m_truncate += 1;
 }
+
+/*
+ * I/O statistics count accumulation functions --- called from bufmgr.c,
+ * localbuf.c and md.c
+ */
+
+void
+pgstat_count_io_ops(IOObject io_object, IOContext io_context, IOOp io_op,
+					int nops)
+{
+	/* see slru_entry() */
+	Assert(IsUnderPostmaster || !IsPostmasterEnvironment);
+
+	IOStats.m_counters[io_object][io_context].ops[io_op] += nops;
+}
+
+void
+pgstat_count_io_time(IOObject io_object, IOContext io_context, IOOp io_op,
+					 instr_time io_time)
+{
+	IOStats.m_counters[io_object][io_context].times[io_op] +=
+		INSTR_TIME_GET_MICROSEC(io_time);
+}
+
+/*
+ * pgstat_io_object_name
+ *
+ * Returns the name shown in pg_stat_io for an I/O object.
+ */
+const char *
+pgstat_io_object_name(IOObject io_object)
+{
+	switch (io_object)
+	{
+		case IOOBJECT_RELATION:
+			return "relation";
+		case IOOBJECT_TEMP_RELATION:
+			return "temp relation";
+	}
+
+	elog(ERROR, "unrecognized IOObject value: %d", io_object);
+	return NULL;				/* keep compiler quiet */
+}
+
+/*
+ * pgstat_io_context_name
+ *
+ * Returns the name shown in pg_stat_io for an I/O context.
+ */
+const char *
+pgstat_io_context_name(IOContext io_context)
+{
+	switch (io_context)
+	{
+		case IOCONTEXT_NORMAL:
+			return "normal";
+		case IOCONTEXT_BULKREAD:
+			return "bulkread";
+		case IOCONTEXT_BULKWRITE:
+			return "bulkwrite";
+		case IOCONTEXT_VACUUM:
+			return "vacuum";
+	}
+
+	elog(ERROR, "unrecognized IOContext value: %d", io_context);
+	return NULL;				/* keep compiler quiet */
+}
+
+/*
+ * pgstat_count_lwlock_wait
+ *
+ * Count a wait for an LWLock of the given tranche; called from lwlock.c
+ * once the lock has been granted, or the wait otherwise ended.  This only
+ * happens when the process actually had to sleep, so acquiring an
+ * uncontended lock costs nothing extra.
+ */
+void
+pgstat_count_lwlock_wait(int tranche_id, instr_time wait_time)
+{
+	PgStat_LWLockCounters *counters;
+	uint64		usecs = INSTR_TIME_GET_MICROSEC(wait_time);
+	int			bucket;
+
+	counters = &LWLockStats[Min(tranche_id, LWTRANCHE_FIRST_USER_DEFINED)];
+
+	if (usecs == 0)
+		bucket = 0;
+	else
+		bucket = Min(pg_leftmost_one_pos64(usecs) + 1,
+					 PGSTAT_LWLOCK_HIST_BUCKETS - 1);
+
+	counters->waits++;
+	counters->wait_time += usecs;
+	counters->hist[bucket]++;
+	have_lwlock_stats = true;
+}
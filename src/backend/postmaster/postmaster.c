@@ -219,6 +219,12 @@ int			ReservedBackends;
 #define MAXLISTEN	64
 static pgsocket ListenSocket[MAXLISTEN];
 
+/*
+ * Max number of connections we accept from one listen socket before going
+ * back to the top of ServerLoop, where signals get serviced.
+ */
+#define MAX_ACCEPTS_PER_WAKEUP	16
+
 /*
  * These globals control the behavior of the postmaster in case some
  * backend dumps core.  Normally, it kills all peers of the dead backend
@@ -419,6 +425,7 @@ static int	ProcessStartupPacket(Port *port, bool ssl_done, bool gss_done);
 static void SendNegotiateProtocolVersion(List *unrecognized_protocol_options);
 static void processCancelRequest(Port *port, void *pkt);
 static int	initMasks(fd_set *rmask);
+static bool ListenSocketReady(pgsocket sock);
 static void report_fork_failure_to_client(Port *port, int errnum);
 static CAC_state canAcceptConnections(int backend_type);
 static bool RandomCancelKey(int32 *cancel_key);
@@ -523,6 +530,7 @@ typedef struct
 	bool		IsBinaryUpgrade;
 	int			max_safe_fds;
 	int			MaxBackends;
+	int			FastPathLockGroupsPerBackend;
 #ifdef WIN32
 	HANDLE		PostmasterHandle;
 	HANDLE		initial_signal_pipe;
@@ -1016,6 +1024,12 @@ PostmasterMain(int argc, char *argv[])
 	 */
 	InitializeMaxBackends();
 
+	/*
+	 * Also calculate the size of the fast-path lock arrays, which depends on
+	 * max_locks_per_transaction.
+	 */
+	InitializeFastPathLocks();
+
 	/*
 	 * Set up shared memory and semaphores.
 	 */
@@ -1734,11 +1748,22 @@ ServerLoop(void)
 					break;
 				if (FD_ISSET(ListenSocket[i], &rmask))
 				{
-					Port	   *port;
-
-					port = ConnCreate(ListenSocket[i]);
-					if (port)
+					/*
+					 * During a connection storm, take as many of the queued
+					 * connections as we can now, rather than a single one
+					 * per trip around the loop.
+					 */
+					for (int n = 0; n < MAX_ACCEPTS_PER_WAKEUP; n++)
 					{
+						Port	   *port;
+
+						if (n > 0 && !ListenSocketReady(ListenSocket[i]))
+							break;
+
+						port = ConnCreate(ListenSocket[i]);
+						if (port == NULL)
+							break;
+
 						BackendStartup(port);
 
 						/*
@@ -1919,6 +1944,24 @@ initMasks(fd_set *rmask)
 	return maxsock + 1;
 }
 
+/*
+ * Check, without waiting, whether another connection is queued on the given
+ * listen socket, so that accepting it won't block.
+ */
+static bool
+ListenSocketReady(pgsocket sock)
+{
+	fd_set		rmask;
+	struct timeval timeout;
+
+	FD_ZERO(&rmask);
+	FD_SET(sock, &rmask);
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 0;
+
+	return select(sock + 1, &rmask, NULL, NULL, &timeout) > 0;
+}
+
 
 /*
  * Read a client's startup packet and do something according to it.
@@ -6170,6 +6213,7 @@ save_backend_variables(BackendParameters *param, Port *port,
 	param->max_safe_fds = max_safe_fds;
 
 	param->MaxBackends = MaxBackends;
+	param->FastPathLockGroupsPerBackend = FastPathLockGroupsPerBackend;
 
 #ifdef WIN32
 	param->PostmasterHandle = PostmasterHandle;
@@ -6403,6 +6447,7 @@ restore_backend_variables(BackendParameters *param, Port *port)
 	max_safe_fds = param->max_safe_fds;
 
 	MaxBackends = param->MaxBackends;
+	FastPathLockGroupsPerBackend = param->FastPathLockGroupsPerBackend;
 
 #ifdef WIN32
 	PostmasterHandle = param->PostmasterHandle;
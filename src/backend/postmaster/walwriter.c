@@ -257,6 +257,13 @@ WalWriterMain(void)
 		else if (left_till_hibernate > 0)
 			left_till_hibernate--;
 
+		/*
+		 * Also create upcoming WAL segments ahead of the insert position, so
+		 * that backends don't have to when they cross a segment boundary.
+		 */
+		if (XLogPreallocateSegments())
+			left_till_hibernate = LOOPS_UNTIL_HIBERNATE;
+
 		/* Send WAL statistics to the stats collector */
 		pgstat_send_wal(false);
 
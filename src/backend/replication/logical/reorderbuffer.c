@@ -208,6 +208,12 @@ typedef struct ReorderBufferDiskChange
 int			logical_decoding_work_mem;
 static const Size max_changes_in_memory = 4096; /* XXX for restore only */
 
+/*
+ * Serialized changes are collected in a buffer of this size and written to
+ * the spill file in one go, rather than issuing a write() for every change.
+ */
+#define REORDER_BUFFER_SPILL_BUFSIZE	(64 * 1024)
+
 /* ---------------------------------------
  * primary reorderbuffer support routines
  * ---------------------------------------
@@ -246,6 +252,10 @@ static void ReorderBufferCheckMemoryLimit(ReorderBuffer *rb);
 static void ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn);
 static void ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 										 int fd, ReorderBufferChange *change);
+static void ReorderBufferSerializeFlush(ReorderBuffer *rb, ReorderBufferTXN *txn,
+										int fd);
+static void ReorderBufferSerializeWrite(ReorderBuffer *rb, ReorderBufferTXN *txn,
+										int fd, char *data, Size len);
 static Size ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 										TXNEntryFile *file, XLogSegNo *segno);
 static void ReorderBufferRestoreChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
@@ -342,6 +352,8 @@ ReorderBufferAllocate(void)
 
 	buffer->outbuf = NULL;
 	buffer->outbufsize = 0;
+	buffer->spillbuf = NULL;
+	buffer->spillbufused = 0;
 	buffer->size = 0;
 
 	buffer->spillTxns = 0;
@@ -3497,6 +3509,10 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 	elog(DEBUG2, "spill %u changes in XID %u to disk",
 		 (uint32) txn->nentries_mem, txn->xid);
 
+	if (rb->spillbuf == NULL)
+		rb->spillbuf = MemoryContextAlloc(rb->context,
+										  REORDER_BUFFER_SPILL_BUFSIZE);
+
 	/* do the same to all child TXs */
 	dlist_foreach(subtxn_i, &txn->subtxns)
 	{
@@ -3523,7 +3539,10 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 			char		path[MAXPGPATH];
 
 			if (fd != -1)
+			{
+				ReorderBufferSerializeFlush(rb, txn, fd);
 				CloseTransientFile(fd);
+			}
 
 			XLByteToSeg(change->lsn, curOpenSegNo, wal_segment_size);
 
@@ -3570,7 +3589,10 @@ ReorderBufferSerializeTXN(ReorderBuffer *rb, ReorderBufferTXN *txn)
 	txn->txn_flags |= RBTXN_IS_SERIALIZED;
 
 	if (fd != -1)
+	{
+		ReorderBufferSerializeFlush(rb, txn, fd);
 		CloseTransientFile(fd);
+	}
 }
 
 /*
@@ -3758,22 +3780,20 @@ ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 
 	ondisk->size = sz;
 
-	errno = 0;
-	pgstat_report_wait_start(WAIT_EVENT_REORDER_BUFFER_WRITE);
-	if (write(fd, rb->outbuf, ondisk->size) != ondisk->size)
-	{
-		int			save_errno = errno;
-
-		CloseTransientFile(fd);
+	/*
+	 * Add the change to the spill buffer, making room first if needed.
+	 * Changes that don't fit in the buffer at all are written directly.
+	 */
+	if (rb->spillbufused + sz > REORDER_BUFFER_SPILL_BUFSIZE)
+		ReorderBufferSerializeFlush(rb, txn, fd);
 
-		/* if write didn't set errno, assume problem is no disk space */
-		errno = save_errno ? save_errno : ENOSPC;
-		ereport(ERROR,
-				(errcode_for_file_access(),
-				 errmsg("could not write to data file for XID %u: %m",
-						txn->xid)));
+	if (sz > REORDER_BUFFER_SPILL_BUFSIZE)
+		ReorderBufferSerializeWrite(rb, txn, fd, rb->outbuf, sz);
+	else
+	{
+		memcpy(rb->spillbuf + rb->spillbufused, rb->outbuf, sz);
+		rb->spillbufused += sz;
 	}
-	pgstat_report_wait_end();
 
 	/*
 	 * Keep the transaction's final_lsn up to date with each change we send to
@@ -3789,6 +3809,47 @@ ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 	Assert(ondisk->change.action == change->action);
 }
 
+/*
+ * Write out the changes collected in the spill buffer.
+ */
+static void
+ReorderBufferSerializeFlush(ReorderBuffer *rb, ReorderBufferTXN *txn, int fd)
+{
+	if (rb->spillbufused == 0)
+		return;
+
+	ReorderBufferSerializeWrite(rb, txn, fd, rb->spillbuf, rb->spillbufused);
+	rb->spillbufused = 0;
+}
+
+/*
+ * Write serialized changes to a spill file.
+ */
+static void
+ReorderBufferSerializeWrite(ReorderBuffer *rb, ReorderBufferTXN *txn,
+							int fd, char *data, Size len)
+{
+	errno = 0;
+	pgstat_report_wait_start(WAIT_EVENT_REORDER_BUFFER_WRITE);
+	if (write(fd, data, len) != len)
+	{
+		int			save_errno = errno;
+
+		/* the buffered changes are lost along with the file */
+		rb->spillbufused = 0;
+
+		CloseTransientFile(fd);
+
+		/* if write didn't set errno, assume problem is no disk space */
+		errno = save_errno ? save_errno : ENOSPC;
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not write to data file for XID %u: %m",
+						txn->xid)));
+	}
+	pgstat_report_wait_end();
+}
+
 /* Returns true, if the output plugin supports streaming, false, otherwise. */
 static inline bool
 ReorderBufferCanStream(ReorderBuffer *rb)
@@ -466,6 +466,30 @@ SyncRepReleaseWaiters(void)
 		return;
 	}
 
+	/*
+	 * If none of this standby's positions is ahead of what has already been
+	 * released, it can't be what allows more waiters to be released: the
+	 * synced positions never exceed those of the standbys they are computed
+	 * from, and any other standby that has advanced will release waiters
+	 * when its own walsender processes its reply.  Check that under a shared
+	 * lock, so that the many replies that don't advance anything don't queue
+	 * up behind each other for the exclusive lock.  We don't take this
+	 * shortcut while we might still have to announce a takeover.
+	 */
+	if (!announce_next_takeover)
+	{
+		bool		advanced;
+
+		LWLockAcquire(SyncRepLock, LW_SHARED);
+		advanced = (MyWalSnd->write > walsndctl->lsn[SYNC_REP_WAIT_WRITE] ||
+					MyWalSnd->flush > walsndctl->lsn[SYNC_REP_WAIT_FLUSH] ||
+					MyWalSnd->apply > walsndctl->lsn[SYNC_REP_WAIT_APPLY]);
+		LWLockRelease(SyncRepLock);
+
+		if (!advanced)
+			return;
+	}
+
 	/*
 	 * We're a potential sync standby. Release waiters if there are enough
 	 * sync standbys and we are considered as sync.
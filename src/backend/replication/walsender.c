@@ -2545,6 +2545,7 @@ XLogSendPhysical(void)
 	XLogRecPtr	startptr;
 	XLogRecPtr	endptr;
 	Size		nbytes;
+	Size		nbuffered;
 	XLogSegNo	segno;
 	WALReadError errinfo;
 
@@ -2762,11 +2763,19 @@ XLogSendPhysical(void)
 	 */
 	enlargeStringInfo(&output_message, nbytes);
 
+	/*
+	 * Recently flushed WAL is usually still in the WAL buffers, so copy as
+	 * much as we can from there and read only the rest from the file.
+	 */
+	nbuffered = XLogReadFromBuffers(&output_message.data[output_message.len],
+									startptr, nbytes, sendTimeLine);
+
 retry:
-	if (!WALRead(xlogreader, WalSndSegmentOpen, wal_segment_close,
-				 &output_message.data[output_message.len],
-				 startptr,
-				 nbytes,
+	if (nbuffered < nbytes &&
+		!WALRead(xlogreader, WalSndSegmentOpen, wal_segment_close,
+				 &output_message.data[output_message.len + nbuffered],
+				 startptr + nbuffered,
+				 nbytes - nbuffered,
 				 xlogreader->seg.ws_tli,	/* Pass the current TLI because
 											 * only WalSndSegmentOpen controls
 											 * whether new TLI is needed. */
@@ -42,6 +42,7 @@
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "pgstat.h"
+#include "port/pg_iovec.h"
 #include "postmaster/bgwriter.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
@@ -132,6 +133,7 @@ typedef struct SMgrSortArray
 bool		zero_damaged_pages = false;
 int			bgwriter_lru_maxpages = 100;
 double		bgwriter_lru_multiplier = 2.0;
+int			bgwriter_freelist_target = 0;
 bool		track_io_timing = false;
 
 /*
@@ -157,8 +159,16 @@ int			checkpoint_flush_after = 0;
 int			bgwriter_flush_after = 0;
 int			backend_flush_after = 0;
 
-/* local state for StartBufferIO and related functions */
-static BufferDesc *InProgressBuf = NULL;
+/*
+ * local state for StartBufferIO and related functions
+ *
+ * Normally a backend has at most one buffer I/O in progress, but the
+ * checkpointer writes runs of up to PG_IOV_MAX neighboring buffers at once
+ * (see CheckpointWriteRun).  All of the I/Os in progress must be of the
+ * same kind.
+ */
+static BufferDesc *InProgressBufs[PG_IOV_MAX];
+static int	NumInProgressBufs = 0;
 static bool IsForInput;
 
 /* local state for LockBufferForCleanup */
@@ -466,6 +476,7 @@ static void PinBuffer_Locked(BufferDesc *buf);
 static void UnpinBuffer(BufferDesc *buf, bool fixOwner);
 static void BufferSync(int flags);
 static uint32 WaitBufHdrUnlocked(BufferDesc *buf);
+static bool ReclaimCleanBuffer(BufferDesc *buf);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
 static void WaitIO(BufferDesc *buf);
@@ -480,7 +491,10 @@ static BufferDesc *BufferAlloc(SMgrRelation smgr,
 							   BlockNumber blockNum,
 							   BufferAccessStrategy strategy,
 							   bool *foundPtr);
-static void FlushBuffer(BufferDesc *buf, SMgrRelation reln);
+static void FlushBuffer(BufferDesc *buf, SMgrRelation reln,
+						IOContext io_context);
+static int	CheckpointWriteRun(int first, int max_items, char *bounce,
+							   WritebackContext *wb_context, bool *written);
 static void FindAndDropRelFileNodeBuffers(RelFileNode rnode,
 										  ForkNumber forkNum,
 										  BlockNumber nForkBlock,
@@ -813,6 +827,8 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	bool		found;
 	bool		isExtend;
 	bool		isLocalBuf = SmgrIsTemp(smgr);
+	IOObject	io_object;
+	IOContext	io_context;
 
 	*hit = false;
 
@@ -967,12 +983,24 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 
 	bufBlock = isLocalBuf ? LocalBufHdrGetBlock(bufHdr) : BufHdrGetBlock(bufHdr);
 
+	if (isLocalBuf)
+	{
+		io_object = IOOBJECT_TEMP_RELATION;
+		io_context = IOCONTEXT_NORMAL;
+	}
+	else
+	{
+		io_object = IOOBJECT_RELATION;
+		io_context = IOContextForStrategy(strategy);
+	}
+
 	if (isExtend)
 	{
 		/* new buffers are zero-filled */
 		MemSet((char *) bufBlock, 0, BLCKSZ);
 		/* don't set checksum for all-zero page */
 		smgrextend(smgr, forkNum, blockNum, (char *) bufBlock, false);
+		pgstat_count_io_op(io_object, io_context, IOOP_EXTEND);
 
 		/*
 		 * NB: we're *not* doing a ScheduleBufferTagForWriteback here;
@@ -998,6 +1026,7 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 				INSTR_TIME_SET_CURRENT(io_start);
 
 			smgrread(smgr, forkNum, blockNum, (char *) bufBlock);
+			pgstat_count_io_op(io_object, io_context, IOOP_READ);
 
 			if (track_io_timing)
 			{
@@ -1005,6 +1034,7 @@ ReadBuffer_common(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 				INSTR_TIME_SUBTRACT(io_time, io_start);
 				pgstat_count_buffer_read_time(INSTR_TIME_GET_MICROSEC(io_time));
 				INSTR_TIME_ADD(pgBufferUsage.blk_read_time, io_time);
+				pgstat_count_io_time(io_object, io_context, IOOP_READ, io_time);
 			}
 
 			/* check for garbage data */
@@ -1111,6 +1141,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 	BufferDesc *buf;
 	bool		valid;
 	uint32		buf_state;
+	bool		from_ring;
 
 	/* create a tag so we can lookup the buffer */
 	INIT_BUFFERTAG(newTag, smgr->smgr_rnode.node, forkNum, blockNum);
@@ -1179,7 +1210,7 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 		 * Select a victim buffer.  The buffer is returned with its header
 		 * spinlock still held!
 		 */
-		buf = StrategyGetBuffer(strategy, &buf_state);
+		buf = StrategyGetBuffer(strategy, &buf_state, &from_ring);
 
 		Assert(BUF_STATE_GET_REFCOUNT(buf_state) == 0);
 
@@ -1248,7 +1279,9 @@ BufferAlloc(SMgrRelation smgr, char relpersistence, ForkNumber forkNum,
 														  smgr->smgr_rnode.node.dbNode,
 														  smgr->smgr_rnode.node.relNode);
 
-				FlushBuffer(buf, NULL);
+				FlushBuffer(buf, NULL,
+							from_ring ? IOContextForStrategy(strategy) :
+							IOCONTEXT_NORMAL);
 				LWLockRelease(BufferDescriptorGetContentLock(buf));
 
 				ScheduleBufferTagForWriteback(&BackendWritebackContext,
@@ -1941,8 +1974,9 @@ BufferSync(int flags)
 	int			i;
 	int			mask = BM_DIRTY;
 	WritebackContext wb_context;
+	char	   *bounce;
 
-	/* Make sure we can handle the pin inside SyncOneBuffer */
+	/* Make sure we can handle the pin inside CheckpointWriteRun */
 	ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
 
 	/*
@@ -2007,6 +2041,9 @@ BufferSync(int flags)
 
 	WritebackContextInit(&wb_context, &checkpoint_flush_after);
 
+	/* private copies of pages in a write run, for checksumming */
+	bounce = palloc(PG_IOV_MAX * BLCKSZ);
+
 	TRACE_POSTGRESQL_BUFFER_SYNC_START(NBuffers, num_to_scan);
 
 	/*
@@ -2110,6 +2147,10 @@ BufferSync(int flags)
 	 * marked with BM_CHECKPOINT_NEEDED. The writes are balanced between
 	 * tablespaces; otherwise the sorting would lead to only one tablespace
 	 * receiving writes at a time, making inefficient use of the hardware.
+	 *
+	 * Since the buffers of each tablespace are sorted by file and block
+	 * number, runs of neighboring blocks are handed to CheckpointWriteRun to
+	 * be written with a single vectored write.
 	 */
 	num_processed = 0;
 	num_written = 0;
@@ -2118,43 +2159,51 @@ BufferSync(int flags)
 		BufferDesc *bufHdr = NULL;
 		CkptTsStatus *ts_stat = (CkptTsStatus *)
 		DatumGetPointer(binaryheap_first(ts_heap));
+		int			nitems = 1;
 
 		buf_id = CkptBufferIds[ts_stat->index].buf_id;
 		Assert(buf_id != -1);
 
 		bufHdr = GetBufferDescriptor(buf_id);
 
-		num_processed++;
-
 		/*
 		 * We don't need to acquire the lock here, because we're only looking
 		 * at a single bit. It's possible that someone else writes the buffer
 		 * and clears the flag right after we check, but that doesn't matter
-		 * since SyncOneBuffer will then do nothing.  However, there is a
+		 * since CheckpointWriteRun will then do nothing.  However, there is a
 		 * further race condition: it's conceivable that between the time we
-		 * examine the bit here and the time SyncOneBuffer acquires the lock,
-		 * someone else not only wrote the buffer but replaced it with another
-		 * page and dirtied it.  In that improbable case, SyncOneBuffer will
-		 * write the buffer though we didn't need to.  It doesn't seem worth
-		 * guarding against this, though.
+		 * examine the bit here and the time CheckpointWriteRun acquires the
+		 * lock, someone else not only wrote the buffer but replaced it with
+		 * another page and dirtied it.  In that improbable case,
+		 * CheckpointWriteRun will write the buffer though we didn't need to.
+		 * It doesn't seem worth guarding against this, though.
 		 */
 		if (pg_atomic_read_u32(&bufHdr->state) & BM_CHECKPOINT_NEEDED)
 		{
-			if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
+			bool		written;
+
+			nitems = CheckpointWriteRun(ts_stat->index,
+										Min(ts_stat->num_to_scan - ts_stat->num_scanned,
+											PG_IOV_MAX),
+										bounce, &wb_context, &written);
+			if (written)
 			{
-				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(buf_id);
-				BgWriterStats.m_buf_written_checkpoints++;
-				num_written++;
+				for (i = 0; i < nitems; i++)
+					TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(CkptBufferIds[ts_stat->index + i].buf_id);
+				BgWriterStats.m_buf_written_checkpoints += nitems;
+				num_written += nitems;
 			}
 		}
 
+		num_processed += nitems;
+
 		/*
 		 * Measure progress independent of actually having to flush the buffer
 		 * - otherwise writing become unbalanced.
 		 */
-		ts_stat->progress += ts_stat->progress_slice;
-		ts_stat->num_scanned++;
-		ts_stat->index++;
+		ts_stat->progress += ts_stat->progress_slice * nitems;
+		ts_stat->num_scanned += nitems;
+		ts_stat->index += nitems;
 
 		/* Have all the buffers from the tablespace been processed? */
 		if (ts_stat->num_scanned == ts_stat->num_to_scan)
@@ -2178,6 +2227,7 @@ BufferSync(int flags)
 	/* issue all pending flushes */
 	IssuePendingWritebacks(&wb_context);
 
+	pfree(bounce);
 	pfree(per_ts_stat);
 	per_ts_stat = NULL;
 	binaryheap_free(ts_heap);
@@ -2191,6 +2241,206 @@ BufferSync(int flags)
 	TRACE_POSTGRESQL_BUFFER_SYNC_DONE(NBuffers, num_written, num_to_scan);
 }
 
+/*
+ * CheckpointWriteRun -- write out a run of checkpoint buffers
+ *
+ * Starting at CkptBufferIds[first], collect up to max_items buffers that
+ * still need to be written for the checkpoint and that hold consecutive
+ * blocks of the same relation fork, and write them with one smgrwritev()
+ * call.  bounce must point to PG_IOV_MAX * BLCKSZ bytes of private memory,
+ * used for checksummed copies of the pages.
+ *
+ * Returns the number of CkptBufferIds entries consumed, which is always at
+ * least one, and sets *written to indicate whether they were written (as
+ * opposed to found clean already).
+ *
+ * The first buffer is locked unconditionally, exactly as SyncOneBuffer
+ * would do.  Since we hold its content lock while acquiring the locks of
+ * the following buffers, we only use conditional lock acquisition for
+ * those, to be sure we can't deadlock against a process that locks several
+ * pages in a different order; the run just ends at the first buffer we
+ * can't lock immediately.
+ *
+ * Note: caller must have done ResourceOwnerEnlargeBuffers.
+ */
+static int
+CheckpointWriteRun(int first, int max_items, char *bounce,
+				   WritebackContext *wb_context, bool *written)
+{
+	BufferDesc *bufs[PG_IOV_MAX];
+	char	   *pages[PG_IOV_MAX];
+	BufferTag	tag;
+	SMgrRelation reln;
+	XLogRecPtr	max_lsn = InvalidXLogRecPtr;
+	ErrorContextCallback errcallback;
+	instr_time	io_start,
+				io_time;
+	int			nbufs;
+
+	Assert(max_items >= 1 && max_items <= PG_IOV_MAX);
+
+	*written = false;
+	CLEAR_BUFFERTAG(tag);
+
+	for (nbufs = 0; nbufs < max_items; nbufs++)
+	{
+		CkptSortItem *item = &CkptBufferIds[first + nbufs];
+		BufferDesc *bufHdr = GetBufferDescriptor(item->buf_id);
+		uint32		buf_state;
+		uint32		needed;
+
+		/* cheap check against the sort key before touching the buffer */
+		if (nbufs > 0 &&
+			(item->relNode != tag.rnode.relNode ||
+			 item->forkNum != tag.forkNum ||
+			 item->blockNum != tag.blockNum + nbufs))
+			break;
+
+		if (nbufs > 0)
+			ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
+		ReservePrivateRefCountEntry();
+
+		/*
+		 * As in SyncOneBuffer, the header spinlock is enough to check whether
+		 * the buffer needs writing.  Buffers after the first must also still
+		 * hold the block we expect, and must not be in the middle of an I/O.
+		 */
+		needed = BM_VALID | BM_DIRTY;
+		if (nbufs > 0)
+			needed |= BM_CHECKPOINT_NEEDED;
+		buf_state = LockBufHdr(bufHdr);
+		if ((buf_state & needed) != needed ||
+			(nbufs > 0 &&
+			 ((buf_state & BM_IO_IN_PROGRESS) ||
+			  !RelFileNodeEquals(bufHdr->tag.rnode, tag.rnode) ||
+			  bufHdr->tag.forkNum != tag.forkNum ||
+			  bufHdr->tag.blockNum != tag.blockNum + nbufs)))
+		{
+			UnlockBufHdr(bufHdr, buf_state);
+			break;
+		}
+		if (nbufs == 0)
+			tag = bufHdr->tag;
+
+		PinBuffer_Locked(bufHdr);
+
+		if (nbufs == 0)
+			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
+		else if (!LWLockConditionalAcquire(BufferDescriptorGetContentLock(bufHdr),
+										   LW_SHARED))
+		{
+			UnpinBuffer(bufHdr, true);
+			break;
+		}
+
+		/* someone else might have flushed it meanwhile */
+		if (!StartBufferIO(bufHdr, false))
+		{
+			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
+			UnpinBuffer(bufHdr, true);
+			break;
+		}
+
+		bufs[nbufs] = bufHdr;
+	}
+
+	/* Nothing to do if the first buffer turned out to be clean */
+	if (nbufs == 0)
+		return 1;
+
+	/* Setup error traceback support for ereport() */
+	errcallback.callback = shared_buffer_write_error_callback;
+	errcallback.arg = (void *) bufs[0];
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(tag.rnode, InvalidBackendId);
+
+	/*
+	 * Collect the page LSNs, and prepare the data to write, as FlushBuffer
+	 * does for a single buffer.
+	 */
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *buf = bufs[i];
+		uint32		buf_state;
+		Page		page;
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_START(tag.forkNum,
+											tag.blockNum + i,
+											reln->smgr_rnode.node.spcNode,
+											reln->smgr_rnode.node.dbNode,
+											reln->smgr_rnode.node.relNode);
+
+		buf_state = LockBufHdr(buf);
+		if ((buf_state & BM_PERMANENT) && BufferGetLSN(buf) > max_lsn)
+			max_lsn = BufferGetLSN(buf);
+		buf_state &= ~BM_JUST_DIRTIED;
+		UnlockBufHdr(buf, buf_state);
+
+		/*
+		 * PageSetChecksumCopy has only one copy buffer, so do the copying
+		 * ourselves.
+		 */
+		page = (Page) BufHdrGetBlock(buf);
+		if (PageIsNew(page) || !DataChecksumsEnabled())
+			pages[i] = (char *) page;
+		else
+		{
+			pages[i] = bounce + i * BLCKSZ;
+			memcpy(pages[i], page, BLCKSZ);
+			PageSetChecksumInplace((Page) pages[i], tag.blockNum + i);
+		}
+	}
+
+	/* WAL must be flushed before any of the data pages are written */
+	if (!XLogRecPtrIsInvalid(max_lsn))
+		XLogFlush(max_lsn);
+
+	if (track_io_timing)
+		INSTR_TIME_SET_CURRENT(io_start);
+
+	smgrwritev(reln, tag.forkNum, tag.blockNum, pages, nbufs, false);
+	pgstat_count_io_ops(IOOBJECT_RELATION, IOCONTEXT_NORMAL, IOOP_WRITE, nbufs);
+
+	if (track_io_timing)
+	{
+		INSTR_TIME_SET_CURRENT(io_time);
+		INSTR_TIME_SUBTRACT(io_time, io_start);
+		pgstat_count_buffer_write_time(INSTR_TIME_GET_MICROSEC(io_time));
+		INSTR_TIME_ADD(pgBufferUsage.blk_write_time, io_time);
+		pgstat_count_io_time(IOOBJECT_RELATION, IOCONTEXT_NORMAL, IOOP_WRITE,
+							 io_time);
+	}
+
+	pgBufferUsage.shared_blks_written += nbufs;
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *buf = bufs[i];
+		BufferTag	buftag = buf->tag;
+
+		TerminateBufferIO(buf, true, 0);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_DONE(tag.forkNum,
+										   tag.blockNum + i,
+										   reln->smgr_rnode.node.spcNode,
+										   reln->smgr_rnode.node.dbNode,
+										   reln->smgr_rnode.node.relNode);
+
+		LWLockRelease(BufferDescriptorGetContentLock(buf));
+		UnpinBuffer(buf, true);
+
+		ScheduleBufferTagForWriteback(wb_context, &buftag);
+	}
+
+	*written = true;
+	return nbufs;
+}
+
 /*
  * BgBufferSync -- Write out some dirty buffers in the pool.
  *
@@ -2241,6 +2491,8 @@ BgBufferSync(WritebackContext *wb_context)
 	int			num_to_scan;
 	int			num_written;
 	int			reusable_buffers;
+	int			num_to_reclaim;
+	int			num_reclaimed;
 
 	/* Variables for final smoothed_density update */
 	long		new_strategy_delta;
@@ -2425,12 +2677,25 @@ BgBufferSync(WritebackContext *wb_context)
 	num_written = 0;
 	reusable_buffers = reusable_buffers_est;
 
+	/*
+	 * If asked to, also move clean reusable buffers that we pass over onto
+	 * the freelist, until it holds bgwriter_freelist_target buffers.  These
+	 * are the buffers the clock sweep would evict next anyway, but handing
+	 * them out from the freelist saves backends the sweep.
+	 */
+	num_to_reclaim = bgwriter_freelist_target - StrategyFreeListLength();
+	num_reclaimed = 0;
+
 	/* Execute the LRU scan */
 	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est)
 	{
 		int			sync_state = SyncOneBuffer(next_to_clean, true,
 											   wb_context);
 
+		if ((sync_state & BUF_REUSABLE) && num_reclaimed < num_to_reclaim &&
+			ReclaimCleanBuffer(GetBufferDescriptor(next_to_clean)))
+			num_reclaimed++;
+
 		if (++next_to_clean >= NBuffers)
 		{
 			next_to_clean = 0;
@@ -2454,12 +2719,13 @@ BgBufferSync(WritebackContext *wb_context)
 	BgWriterStats.m_buf_written_clean += num_written;
 
 #ifdef BGW_DEBUG
-	elog(DEBUG1, "bgwriter: recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote=%d reusable=%d",
+	elog(DEBUG1, "bgwriter: recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote=%d reusable=%d reclaimed=%d",
 		 recent_alloc, smoothed_alloc, strategy_delta, bufs_ahead,
 		 smoothed_density, reusable_buffers_est, upcoming_alloc_est,
 		 bufs_to_lap - num_to_scan,
 		 num_written,
-		 reusable_buffers - reusable_buffers_est);
+		 reusable_buffers - reusable_buffers_est,
+		 num_reclaimed);
 #endif
 
 	/*
@@ -2489,6 +2755,70 @@ BgBufferSync(WritebackContext *wb_context)
 	return (bufs_to_lap == 0 && recent_alloc == 0);
 }
 
+/*
+ * ReclaimCleanBuffer -- evict a clean, unused buffer onto the freelist.
+ *
+ * This is like InvalidateBuffer(), except that the buffer may well be of
+ * interest to other backends, so we give up rather than wait if it is in
+ * use, dirty or busy being read or written.  We also don't wait for the
+ * mapping partition lock; the bgwriter shouldn't queue up behind backends
+ * that are looking up buffers.
+ *
+ * Returns true if the buffer was put on the freelist.
+ */
+static bool
+ReclaimCleanBuffer(BufferDesc *buf)
+{
+	BufferTag	tag;
+	uint32		hash;
+	LWLock	   *partitionLock;
+	uint32		buf_state;
+
+	buf_state = LockBufHdr(buf);
+	if (!(buf_state & BM_VALID))
+	{
+		UnlockBufHdr(buf, buf_state);
+		return false;
+	}
+	tag = buf->tag;
+	UnlockBufHdr(buf, buf_state);
+
+	hash = BufTableHashCode(&tag);
+	partitionLock = BufMappingPartitionLock(hash);
+
+	if (!LWLockConditionalAcquire(partitionLock, LW_EXCLUSIVE))
+		return false;
+
+	/*
+	 * Recheck everything now that nobody can look the buffer up.  Anybody
+	 * who pins it from here on must be a clock sweep that is about to
+	 * recycle it, and we hold the header lock while deciding.
+	 */
+	buf_state = LockBufHdr(buf);
+	if (!BUFFERTAGS_EQUAL(buf->tag, tag) ||
+		BUF_STATE_GET_REFCOUNT(buf_state) != 0 ||
+		BUF_STATE_GET_USAGECOUNT(buf_state) != 0 ||
+		(buf_state & (BM_DIRTY | BM_JUST_DIRTIED | BM_IO_IN_PROGRESS)) ||
+		!(buf_state & BM_VALID))
+	{
+		UnlockBufHdr(buf, buf_state);
+		LWLockRelease(partitionLock);
+		return false;
+	}
+
+	CLEAR_BUFFERTAG(buf->tag);
+	buf_state &= ~(BUF_FLAG_MASK | BUF_USAGECOUNT_MASK);
+	UnlockBufHdr(buf, buf_state);
+
+	BufTableDelete(&tag, hash);
+
+	LWLockRelease(partitionLock);
+
+	StrategyFreeBuffer(buf);
+
+	return true;
+}
+
 /*
  * SyncOneBuffer -- process a single buffer during syncing.
  *
@@ -2552,7 +2882,7 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	PinBuffer_Locked(bufHdr);
 	LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
 
-	FlushBuffer(bufHdr, NULL);
+	FlushBuffer(bufHdr, NULL, IOCONTEXT_NORMAL);
 
 	LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 
@@ -2812,10 +3142,11 @@ BufferGetTag(Buffer buffer, RelFileNode *rnode, ForkNumber *forknum,
  * written.)
  *
  * If the caller has an smgr reference for the buffer's relation, pass it
- * as the second parameter.  If not, pass NULL.
+ * as the second parameter.  If not, pass NULL.  io_context is the I/O
+ * statistics context to count the write in.
  */
 static void
-FlushBuffer(BufferDesc *buf, SMgrRelation reln)
+FlushBuffer(BufferDesc *buf, SMgrRelation reln, IOContext io_context)
 {
 	XLogRecPtr	recptr;
 	ErrorContextCallback errcallback;
@@ -2906,6 +3237,7 @@ FlushBuffer(BufferDesc *buf, SMgrRelation reln)
 			  buf->tag.blockNum,
 			  bufToWrite,
 			  false);
+	pgstat_count_io_op(IOOBJECT_RELATION, io_context, IOOP_WRITE);
 
 	if (track_io_timing)
 	{
@@ -2913,6 +3245,8 @@ FlushBuffer(BufferDesc *buf, SMgrRelation reln)
 		INSTR_TIME_SUBTRACT(io_time, io_start);
 		pgstat_count_buffer_write_time(INSTR_TIME_GET_MICROSEC(io_time));
 		INSTR_TIME_ADD(pgBufferUsage.blk_write_time, io_time);
+		pgstat_count_io_time(IOOBJECT_RELATION, io_context, IOOP_WRITE,
+							 io_time);
 	}
 
 	pgBufferUsage.shared_blks_written++;
@@ -3081,7 +3415,7 @@ DropRelFileNodeBuffers(SMgrRelation smgr_reln, ForkNumber *forkNum,
 		if (rnode.backend == MyBackendId)
 		{
 			for (j = 0; j < nforks; j++)
-				DropRelFileNodeLocalBuffers(rnode.node, forkNum[j],
+				DropRelFileNodeLocalBuffers(smgr_reln, forkNum[j],
 											firstDelBlock[j]);
 		}
 		return;
@@ -3211,7 +3545,7 @@ DropRelFileNodesAllBuffers(SMgrRelation *smgr_reln, int nnodes)
 		if (RelFileNodeBackendIsTemp(smgr_reln[i]->smgr_rnode))
 		{
 			if (smgr_reln[i]->smgr_rnode.backend == MyBackendId)
-				DropRelFileNodeAllLocalBuffers(smgr_reln[i]->smgr_rnode.node);
+				DropRelFileNodeAllLocalBuffers(smgr_reln[i]);
 		}
 		else
 			rels[n++] = smgr_reln[i];
@@ -3559,6 +3893,8 @@ FlushRelationBuffers(Relation rel)
 						  bufHdr->tag.blockNum,
 						  localpage,
 						  false);
+				pgstat_count_io_op(IOOBJECT_TEMP_RELATION, IOCONTEXT_NORMAL,
+								   IOOP_WRITE);
 
 				buf_state &= ~(BM_DIRTY | BM_JUST_DIRTIED);
 				pg_atomic_unlocked_write_u32(&bufHdr->state, buf_state);
@@ -3595,7 +3931,7 @@ FlushRelationBuffers(Relation rel)
 		{
 			PinBuffer_Locked(bufHdr);
 			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
-			FlushBuffer(bufHdr, rel->rd_smgr);
+			FlushBuffer(bufHdr, rel->rd_smgr, IOCONTEXT_NORMAL);
 			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 			UnpinBuffer(bufHdr, true);
 		}
@@ -3691,7 +4027,7 @@ FlushRelationsAllBuffers(SMgrRelation *smgrs, int nrels)
 		{
 			PinBuffer_Locked(bufHdr);
 			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
-			FlushBuffer(bufHdr, srelent->srel);
+			FlushBuffer(bufHdr, srelent->srel, IOCONTEXT_NORMAL);
 			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 			UnpinBuffer(bufHdr, true);
 		}
@@ -3747,7 +4083,7 @@ FlushDatabaseBuffers(Oid dbid)
 		{
 			PinBuffer_Locked(bufHdr);
 			LWLockAcquire(BufferDescriptorGetContentLock(bufHdr), LW_SHARED);
-			FlushBuffer(bufHdr, NULL);
+			FlushBuffer(bufHdr, NULL, IOCONTEXT_NORMAL);
 			LWLockRelease(BufferDescriptorGetContentLock(bufHdr));
 			UnpinBuffer(bufHdr, true);
 		}
@@ -3774,7 +4110,7 @@ FlushOneBuffer(Buffer buffer)
 
 	Assert(LWLockHeldByMe(BufferDescriptorGetContentLock(bufHdr)));
 
-	FlushBuffer(bufHdr, NULL);
+	FlushBuffer(bufHdr, NULL, IOCONTEXT_NORMAL);
 }
 
 /*
@@ -4391,7 +4727,7 @@ WaitIO(BufferDesc *buf)
 /*
  * StartBufferIO: begin I/O on this buffer
  *	(Assumptions)
- *	My process is executing no IO
+ *	My process is executing no IO, or only other output operations
  *	The buffer is Pinned
  *
  * In some scenarios there are race conditions in which multiple backends
@@ -4411,7 +4747,9 @@ StartBufferIO(BufferDesc *buf, bool forInput)
 {
 	uint32		buf_state;
 
-	Assert(!InProgressBuf);
+	Assert(NumInProgressBufs == 0 ||
+		   (!forInput && !IsForInput &&
+			NumInProgressBufs < lengthof(InProgressBufs)));
 
 	for (;;)
 	{
@@ -4435,7 +4773,7 @@ StartBufferIO(BufferDesc *buf, bool forInput)
 	buf_state |= BM_IO_IN_PROGRESS;
 	UnlockBufHdr(buf, buf_state);
 
-	InProgressBuf = buf;
+	InProgressBufs[NumInProgressBufs++] = buf;
 	IsForInput = forInput;
 
 	return true;
@@ -4461,8 +4799,14 @@ static void
 TerminateBufferIO(BufferDesc *buf, bool clear_dirty, uint32 set_flag_bits)
 {
 	uint32		buf_state;
+	int			i;
 
-	Assert(buf == InProgressBuf);
+	for (i = NumInProgressBufs - 1; i >= 0; i--)
+	{
+		if (InProgressBufs[i] == buf)
+			break;
+	}
+	Assert(i >= 0);
 
 	buf_state = LockBufHdr(buf);
 
@@ -4475,7 +4819,7 @@ TerminateBufferIO(BufferDesc *buf, bool clear_dirty, uint32 set_flag_bits)
 	buf_state |= set_flag_bits;
 	UnlockBufHdr(buf, buf_state);
 
-	InProgressBuf = NULL;
+	InProgressBufs[i] = InProgressBufs[--NumInProgressBufs];
 
 	ConditionVariableBroadcast(BufferDescriptorGetIOCV(buf));
 }
@@ -4492,10 +4836,9 @@ TerminateBufferIO(BufferDesc *buf, bool clear_dirty, uint32 set_flag_bits)
 void
 AbortBufferIO(void)
 {
-	BufferDesc *buf = InProgressBuf;
-
-	if (buf)
+	while (NumInProgressBufs > 0)
 	{
+		BufferDesc *buf = InProgressBufs[NumInProgressBufs - 1];
 		uint32		buf_state;
 
 		buf_state = LockBufHdr(buf);
@@ -22,6 +22,21 @@
 
 #define INT_ACCESS_ONCE(var)	((int)(*((volatile int *)&(var))))
 
+/*
+ * GUC variables: initial ring sizes for the bulk access strategies, in kB.
+ * See buffer/README for the rationale behind the defaults.
+ */
+int			bulk_read_ring_size = 256;
+int			bulk_write_ring_size = 16 * 1024;
+int			vacuum_ring_size = 256;
+
+/*
+ * A bulk-read ring that keeps coming back to buffers it can't reuse without
+ * flushing WAL is grown, up to this many times its initial size (and never to
+ * more than 1/8th of shared_buffers).
+ */
+#define RING_MAX_GROWTH		16
+
 
 /*
  * The shared freelist control information.
@@ -40,6 +55,7 @@ typedef struct
 
 	int			firstFreeBuffer;	/* Head of list of unused buffers */
 	int			lastFreeBuffer; /* Tail of list of unused buffers */
+	int			numFreeBuffers; /* Number of buffers on the list */
 
 	/*
 	 * NOTE: lastFreeBuffer is undefined when firstFreeBuffer is -1 (that is,
@@ -63,6 +79,18 @@ typedef struct
 /* Pointers to shared state */
 static BufferStrategyControl *StrategyControl = NULL;
 
+/*
+ * To reduce contention on nextVictimBuffer, each backend advances the shared
+ * clock hand by CLOCK_SWEEP_BATCH buffers at a time, and then visits the
+ * claimed buffers privately.  ClockSweepNext is the next one of those still
+ * to be visited and ClockSweepEnd is one past the last; both are positions
+ * in the same (unwrapped) numbering as nextVictimBuffer.
+ */
+#define CLOCK_SWEEP_BATCH	16
+
+static uint32 ClockSweepNext = 0;
+static uint32 ClockSweepEnd = 0;
+
 /*
  * Private (non-shared) state for managing a ring of shared buffers to re-use.
  * This is currently the only kind of BufferAccessStrategy object, but someday
@@ -74,6 +102,8 @@ typedef struct BufferAccessStrategyData
 	BufferAccessStrategyType btype;
 	/* Number of elements in buffers[] array */
 	int			ring_size;
+	/* Size the ring may grow to; see StrategyRejectBuffer */
+	int			max_ring_size;
 
 	/*
 	 * Index of the "current" slot in the ring, ie, the one most recently
@@ -87,13 +117,21 @@ typedef struct BufferAccessStrategyData
 	 */
 	bool		current_was_in_ring;
 
+	/*
+	 * True if StrategyRejectBuffer rejected the buffer most recently returned
+	 * by StrategyGetBuffer, so that the next call is a retry of the same
+	 * allocation.  ring_grown is true if the ring has already been enlarged
+	 * during the current allocation.
+	 */
+	bool		last_rejected;
+	bool		ring_grown;
+
 	/*
 	 * Array of buffer numbers.  InvalidBuffer (that is, zero) indicates we
-	 * have not yet selected a buffer for this ring slot.  For allocation
-	 * simplicity this is palloc'd together with the fixed fields of the
-	 * struct.
+	 * have not yet selected a buffer for this ring slot.  This is allocated
+	 * separately from the struct, so that the ring can be enlarged.
 	 */
-	Buffer		buffers[FLEXIBLE_ARRAY_MEMBER];
+	Buffer	   *buffers;
 }			BufferAccessStrategyData;
 
 
@@ -108,64 +146,75 @@ static void AddBufferToRing(BufferAccessStrategy strategy,
  *
  * Move the clock hand one buffer ahead of its current position and return the
  * id of the buffer now under the hand.
+ *
+ * The shared hand is only advanced once every CLOCK_SWEEP_BATCH calls; in
+ * between we hand out the buffers of the batch we claimed last time.
  */
 static inline uint32
 ClockSweepTick(void)
 {
-	uint32		victim;
+	uint32		batch;
+	uint32		start;
+	uint32		end;
+	uint32		wrap;
+
+	if (ClockSweepNext != ClockSweepEnd)
+		return ClockSweepNext++ % NBuffers;
 
 	/*
-	 * Atomically move hand ahead one buffer - if there's several processes
-	 * doing this, this can lead to buffers being returned slightly out of
-	 * apparent order.
+	 * Atomically move hand ahead one batch of buffers - if there's several
+	 * processes doing this, this can lead to buffers being returned slightly
+	 * out of apparent order.
 	 */
-	victim =
-		pg_atomic_fetch_add_u32(&StrategyControl->nextVictimBuffer, 1);
+	batch = Min(CLOCK_SWEEP_BATCH, NBuffers);
+	start = pg_atomic_fetch_add_u32(&StrategyControl->nextVictimBuffer, batch);
+	end = start + batch;
 
-	if (victim >= NBuffers)
+	/*
+	 * If our batch contains a nonzero multiple of NBuffers, we're the one
+	 * that just caused a wraparound.  Since batch <= NBuffers, the batch can
+	 * contain at most one such position; compute the first one at or after
+	 * start.
+	 */
+	wrap = start + (NBuffers - start % NBuffers) % NBuffers;
+	if (wrap >= NBuffers && wrap < end)
 	{
-		uint32		originalVictim = victim;
+		uint32		expected;
+		uint32		wrapped;
+		bool		success = false;
 
-		/* always wrap what we look up in BufferDescriptors */
-		victim = victim % NBuffers;
+		expected = end;
 
-		/*
-		 * If we're the one that just caused a wraparound, force
-		 * completePasses to be incremented while holding the spinlock. We
-		 * need the spinlock so StrategySyncStart() can return a consistent
-		 * value consisting of nextVictimBuffer and completePasses.
-		 */
-		if (victim == 0)
+		while (!success)
 		{
-			uint32		expected;
-			uint32		wrapped;
-			bool		success = false;
+			/*
+			 * Acquire the spinlock while increasing completePasses. That
+			 * allows other readers to read nextVictimBuffer and
+			 * completePasses in a consistent manner which is required for
+			 * StrategySyncStart().  In theory delaying the increment could
+			 * lead to an overflow of nextVictimBuffers, but that's highly
+			 * unlikely and wouldn't be particularly harmful.
+			 */
+			SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
 
-			expected = originalVictim + 1;
+			wrapped = expected % NBuffers;
 
-			while (!success)
-			{
-				/*
-				 * Acquire the spinlock while increasing completePasses. That
-				 * allows other readers to read nextVictimBuffer and
-				 * completePasses in a consistent manner which is required for
-				 * StrategySyncStart().  In theory delaying the increment
-				 * could lead to an overflow of nextVictimBuffers, but that's
-				 * highly unlikely and wouldn't be particularly harmful.
-				 */
-				SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
-
-				wrapped = expected % NBuffers;
-
-				success = pg_atomic_compare_exchange_u32(&StrategyControl->nextVictimBuffer,
-														 &expected, wrapped);
-				if (success)
-					StrategyControl->completePasses++;
-				SpinLockRelease(&StrategyControl->buffer_strategy_lock);
-			}
+			success = pg_atomic_compare_exchange_u32(&StrategyControl->nextVictimBuffer,
+													 &expected, wrapped);
+			if (success)
+				StrategyControl->completePasses++;
+			SpinLockRelease(&StrategyControl->buffer_strategy_lock);
 		}
 	}
-	return victim;
+
+	/*
+	 * Remember the rest of the batch.  We keep the unwrapped positions; only
+	 * their value modulo NBuffers matters.
+	 */
+	ClockSweepNext = start + 1;
+	ClockSweepEnd = end;
+
+	return start % NBuffers;
 }
 
 /*
@@ -193,12 +242,14 @@ have_free_buffer(void)
  *	the selected buffer must not currently be pinned by anyone.
  *
  *	strategy is a BufferAccessStrategy object, or NULL for default strategy.
+ *	*from_ring is set to true if the buffer came from the strategy's ring.
  *
  *	To ensure that no one else can pin the buffer before we do, we must
  *	return the buffer with the buffer header spinlock still held.
  */
 BufferDesc *
-StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
+StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state,
+				  bool *from_ring)
 {
 	BufferDesc *buf;
 	int			bgwprocno;
@@ -211,10 +262,19 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 	 */
 	if (strategy != NULL)
 	{
+		/* Allow the ring to grow once per allocation, not once per retry */
+		if (!strategy->last_rejected)
+			strategy->ring_grown = false;
+		strategy->last_rejected = false;
+
 		buf = GetBufferFromRing(strategy, buf_state);
 		if (buf != NULL)
+		{
+			*from_ring = true;
 			return buf;
+		}
 	}
+	*from_ring = false;
 
 	/*
 	 * If asked, we need to waken the bgwriter. Since we don't want to rely on
@@ -283,6 +343,7 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_state)
 
 			/* Unconditionally remove buffer from freelist */
 			StrategyControl->firstFreeBuffer = buf->freeNext;
+			StrategyControl->numFreeBuffers--;
 			buf->freeNext = FREENEXT_NOT_IN_LIST;
 
 			/*
@@ -375,6 +436,7 @@ StrategyFreeBuffer(BufferDesc *buf)
 		if (buf->freeNext < 0)
 			StrategyControl->lastFreeBuffer = buf->buf_id;
 		StrategyControl->firstFreeBuffer = buf->buf_id;
+		StrategyControl->numFreeBuffers++;
 	}
 
 	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
@@ -441,6 +503,19 @@ StrategyNotifyBgWriter(int bgwprocno)
 	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
 }
 
+/*
+ * StrategyFreeListLength -- report the number of buffers on the freelist
+ *
+ * The result is read without the spinlock, so it may be slightly out of date
+ * by the time the caller looks at it.  The bgwriter only uses it to decide
+ * how many buffers to reclaim.
+ */
+int
+StrategyFreeListLength(void)
+{
+	return StrategyControl->numFreeBuffers;
+}
+
 
 /*
  * StrategyShmemSize
@@ -511,6 +586,7 @@ StrategyInitialize(bool init)
 		 */
 		StrategyControl->firstFreeBuffer = 0;
 		StrategyControl->lastFreeBuffer = NBuffers - 1;
+		StrategyControl->numFreeBuffers = NBuffers;
 
 		/* Initialize the clock sweep pointer */
 		pg_atomic_init_u32(&StrategyControl->nextVictimBuffer, 0);
@@ -557,13 +633,13 @@ GetAccessStrategy(BufferAccessStrategyType btype)
 			return NULL;
 
 		case BAS_BULKREAD:
-			ring_size = 256 * 1024 / BLCKSZ;
+			ring_size = bulk_read_ring_size / (BLCKSZ / 1024);
 			break;
 		case BAS_BULKWRITE:
-			ring_size = 16 * 1024 * 1024 / BLCKSZ;
+			ring_size = bulk_write_ring_size / (BLCKSZ / 1024);
 			break;
 		case BAS_VACUUM:
-			ring_size = 256 * 1024 / BLCKSZ;
+			ring_size = vacuum_ring_size / (BLCKSZ / 1024);
 			break;
 
 		default:
@@ -573,16 +649,18 @@ GetAccessStrategy(BufferAccessStrategyType btype)
 	}
 
 	/* Make sure ring isn't an undue fraction of shared buffers */
-	ring_size = Min(NBuffers / 8, ring_size);
+	ring_size = Max(Min(NBuffers / 8, ring_size), 1);
 
 	/* Allocate the object and initialize all elements to zeroes */
-	strategy = (BufferAccessStrategy)
-		palloc0(offsetof(BufferAccessStrategyData, buffers) +
-				ring_size * sizeof(Buffer));
+	strategy = (BufferAccessStrategy) palloc0(sizeof(BufferAccessStrategyData));
+	strategy->buffers = (Buffer *) palloc0(ring_size * sizeof(Buffer));
 
 	/* Set fields that don't start out zero */
 	strategy->btype = btype;
 	strategy->ring_size = ring_size;
+	strategy->max_ring_size = Max(Min(NBuffers / 8,
+									  ring_size * RING_MAX_GROWTH),
+								  ring_size);
 
 	return strategy;
 }
@@ -598,7 +676,34 @@ FreeAccessStrategy(BufferAccessStrategy strategy)
 {
 	/* don't crash if called on a "default" strategy */
 	if (strategy != NULL)
+	{
+		pfree(strategy->buffers);
 		pfree(strategy);
+	}
+}
+
+/*
+ * IOContextForStrategy -- the I/O statistics context for a strategy
+ */
+IOContext
+IOContextForStrategy(BufferAccessStrategy strategy)
+{
+	if (strategy == NULL)
+		return IOCONTEXT_NORMAL;
+
+	switch (strategy->btype)
+	{
+		case BAS_NORMAL:
+			break;
+		case BAS_BULKREAD:
+			return IOCONTEXT_BULKREAD;
+		case BAS_BULKWRITE:
+			return IOCONTEXT_BULKWRITE;
+		case BAS_VACUUM:
+			return IOCONTEXT_VACUUM;
+	}
+
+	return IOCONTEXT_NORMAL;
 }
 
 /*
@@ -679,6 +784,13 @@ AddBufferToRing(BufferAccessStrategy strategy, BufferDesc *buf)
  * be written out and doing so would require flushing WAL too.  This gives us
  * a chance to choose a different victim.
  *
+ * Only bulk reads reject the buffer; VACUUM and bulk writes flush WAL and
+ * reuse it, as they'd only end up handing the dirty buffer to the normal
+ * strategy otherwise.  A rejection also suggests that the ring has been
+ * wrapping around faster than WAL gets flushed, so we enlarge the ring if it
+ * is still allowed to grow.  That happens at most once per allocation, since
+ * a single allocation may reject several ring members in a row.
+ *
  * Returns true if buffer manager should ask for a new victim, and false
  * if this buffer should be written and re-used.
  */
@@ -694,11 +806,31 @@ StrategyRejectBuffer(BufferAccessStrategy strategy, BufferDesc *buf)
 		strategy->buffers[strategy->current] != BufferDescriptorGetBuffer(buf))
 		return false;
 
+	if (!strategy->ring_grown &&
+		strategy->ring_size < strategy->max_ring_size)
+	{
+		int			new_size = Min(strategy->ring_size * 2,
+								   strategy->max_ring_size);
+
+		/*
+		 * The new slots go at the end of the array, so they're visited, and
+		 * filled by the normal allocation strategy, when the ring next wraps
+		 * around.  Existing buffers keep their relative order.
+		 */
+		strategy->buffers = (Buffer *) repalloc(strategy->buffers,
+												new_size * sizeof(Buffer));
+		memset(&strategy->buffers[strategy->ring_size], 0,
+			   (new_size - strategy->ring_size) * sizeof(Buffer));
+		strategy->ring_size = new_size;
+		strategy->ring_grown = true;
+	}
+
 	/*
 	 * Remove the dirty buffer from the ring; necessary to prevent infinite
 	 * loop if all ring members are dirty.
 	 */
 	strategy->buffers[strategy->current] = InvalidBuffer;
+	strategy->last_rejected = true;
 
 	return true;
 }
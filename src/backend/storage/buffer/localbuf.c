@@ -34,6 +34,17 @@ typedef struct
 	int			id;				/* Associated local buffer's index */
 } LocalBufferLookupEnt;
 
+/*
+ * When dropping the buffers of a relation with fewer blocks than this, look
+ * them up one by one rather than scanning the whole pool.  Same idea as
+ * BUF_DROP_FULL_SCAN_THRESHOLD in bufmgr.c.  But we need to ask the kernel
+ * for the size of the relation, which costs about as much as scanning a few
+ * thousand buffers, so don't bother with a pool smaller than
+ * LOCALBUF_DROP_MIN_POOL_SIZE.
+ */
+#define LOCALBUF_DROP_FULL_SCAN_THRESHOLD	(uint64) (NLocBuffer / 32)
+#define LOCALBUF_DROP_MIN_POOL_SIZE			16384
+
 /* Note: this macro only works on local buffers, not shared ones! */
 #define LocalBufHdrGetBlock(bufHdr) \
 	LocalBufferBlockPointers[-((bufHdr)->buf_id + 2)]
@@ -51,6 +62,7 @@ static HTAB *LocalBufHash = NULL;
 
 static void InitLocalBuffers(void);
 static Block GetLocalBufferStorage(void);
+static void DropLocalBuffer(int b, BufferDesc *bufHdr, uint32 buf_state);
 
 
 /*
@@ -225,6 +237,8 @@ LocalBufferAlloc(SMgrRelation smgr, ForkNumber forkNum, BlockNumber blockNum,
 				  bufHdr->tag.blockNum,
 				  localpage,
 				  false);
+		pgstat_count_io_op(IOOBJECT_TEMP_RELATION, IOCONTEXT_NORMAL,
+						   IOOP_WRITE);
 
 		/* Mark not-dirty now in case we error out below */
 		buf_state &= ~BM_DIRTY;
@@ -311,6 +325,61 @@ MarkLocalBufferDirty(Buffer buffer)
 	pg_atomic_unlocked_write_u32(&bufHdr->state, buf_state);
 }
 
+/*
+ * DropLocalBuffer
+ *		Remove one valid local buffer from the pool, without writing it out.
+ */
+static void
+DropLocalBuffer(int b, BufferDesc *bufHdr, uint32 buf_state)
+{
+	LocalBufferLookupEnt *hresult;
+
+	if (LocalRefCount[b] != 0)
+		elog(ERROR, "block %u of %s is still referenced (local %u)",
+			 bufHdr->tag.blockNum,
+			 relpathbackend(bufHdr->tag.rnode, MyBackendId,
+							bufHdr->tag.forkNum),
+			 LocalRefCount[b]);
+	/* Remove entry from hashtable */
+	hresult = (LocalBufferLookupEnt *)
+		hash_search(LocalBufHash, (void *) &bufHdr->tag,
+					HASH_REMOVE, NULL);
+	if (!hresult)				/* shouldn't happen */
+		elog(ERROR, "local buffer hash table corrupted");
+	/* Mark buffer invalid */
+	CLEAR_BUFFERTAG(bufHdr->tag);
+	buf_state &= ~BUF_FLAG_MASK;
+	buf_state &= ~BUF_USAGECOUNT_MASK;
+	pg_atomic_unlocked_write_u32(&bufHdr->state, buf_state);
+}
+
+/*
+ * FindAndDropLocalBuffers
+ *		Remove the pages of a relation fork in [firstDelBlock, nForkBlock)
+ *		from the pool, by looking each of them up in the hash table.
+ */
+static void
+FindAndDropLocalBuffers(RelFileNode rnode, ForkNumber forkNum,
+						BlockNumber nForkBlock, BlockNumber firstDelBlock)
+{
+	for (BlockNumber curBlock = firstDelBlock; curBlock < nForkBlock; curBlock++)
+	{
+		BufferTag	tag;
+		LocalBufferLookupEnt *hresult;
+		BufferDesc *bufHdr;
+
+		INIT_BUFFERTAG(tag, rnode, forkNum, curBlock);
+		hresult = (LocalBufferLookupEnt *)
+			hash_search(LocalBufHash, (void *) &tag, HASH_FIND, NULL);
+		if (!hresult)
+			continue;
+
+		bufHdr = GetLocalBufferDescriptor(hresult->id);
+		DropLocalBuffer(hresult->id, bufHdr,
+						pg_atomic_read_u32(&bufHdr->state));
+	}
+}
+
 /*
  * DropRelFileNodeLocalBuffers
  *		This function removes from the buffer pool all the pages of the
@@ -320,18 +389,42 @@ MarkLocalBufferDirty(Buffer buffer)
  *		out first.  Therefore, this is NOT rollback-able, and so should be
  *		used only with extreme caution!
  *
+ *		If the relation is small compared to the pool, we look up its pages
+ *		in the hash table rather than scanning all the buffers.  As in
+ *		DropRelFileNodeBuffers, this relies on the size of the file covering
+ *		all buffered pages, which holds since pages are extended on disk
+ *		before they're buffered.  Only this backend extends the relation, so
+ *		the size is reliable.
+ *
  *		See DropRelFileNodeBuffers in bufmgr.c for more notes.
  */
 void
-DropRelFileNodeLocalBuffers(RelFileNode rnode, ForkNumber forkNum,
+DropRelFileNodeLocalBuffers(SMgrRelation smgr, ForkNumber forkNum,
 							BlockNumber firstDelBlock)
 {
+	RelFileNode rnode = smgr->smgr_rnode.node;
+	BlockNumber nForkBlock;
 	int			i;
 
+	/* Nothing to do if no local buffers were ever used */
+	if (LocalBufHash == NULL)
+		return;
+
+	if (NLocBuffer >= LOCALBUF_DROP_MIN_POOL_SIZE)
+	{
+		nForkBlock = smgrnblocks(smgr, forkNum);
+		if (nForkBlock <= firstDelBlock)
+			return;
+		if (nForkBlock - firstDelBlock < LOCALBUF_DROP_FULL_SCAN_THRESHOLD)
+		{
+			FindAndDropLocalBuffers(rnode, forkNum, nForkBlock, firstDelBlock);
+			return;
+		}
+	}
+
 	for (i = 0; i < NLocBuffer; i++)
 	{
 		BufferDesc *bufHdr = GetLocalBufferDescriptor(i);
-		LocalBufferLookupEnt *hresult;
 		uint32		buf_state;
 
 		buf_state = pg_atomic_read_u32(&bufHdr->state);
@@ -340,25 +433,7 @@ DropRelFileNodeLocalBuffers(RelFileNode rnode, ForkNumber forkNum,
 			RelFileNodeEquals(bufHdr->tag.rnode, rnode) &&
 			bufHdr->tag.forkNum == forkNum &&
 			bufHdr->tag.blockNum >= firstDelBlock)
-		{
-			if (LocalRefCount[i] != 0)
-				elog(ERROR, "block %u of %s is still referenced (local %u)",
-					 bufHdr->tag.blockNum,
-					 relpathbackend(bufHdr->tag.rnode, MyBackendId,
-									bufHdr->tag.forkNum),
-					 LocalRefCount[i]);
-			/* Remove entry from hashtable */
-			hresult = (LocalBufferLookupEnt *)
-				hash_search(LocalBufHash, (void *) &bufHdr->tag,
-							HASH_REMOVE, NULL);
-			if (!hresult)		/* shouldn't happen */
-				elog(ERROR, "local buffer hash table corrupted");
-			/* Mark buffer invalid */
-			CLEAR_BUFFERTAG(bufHdr->tag);
-			buf_state &= ~BUF_FLAG_MASK;
-			buf_state &= ~BUF_USAGECOUNT_MASK;
-			pg_atomic_unlocked_write_u32(&bufHdr->state, buf_state);
-		}
+			DropLocalBuffer(i, bufHdr, buf_state);
 	}
 }
 
@@ -367,42 +442,53 @@ DropRelFileNodeLocalBuffers(RelFileNode rnode, ForkNumber forkNum,
  *		This function removes from the buffer pool all pages of all forks
  *		of the specified relation.
  *
+ *		As in DropRelFileNodeLocalBuffers, small relations are dealt with
+ *		by hash table lookups.
+ *
  *		See DropRelFileNodesAllBuffers in bufmgr.c for more notes.
  */
 void
-DropRelFileNodeAllLocalBuffers(RelFileNode rnode)
+DropRelFileNodeAllLocalBuffers(SMgrRelation smgr)
 {
+	RelFileNode rnode = smgr->smgr_rnode.node;
+	BlockNumber nForkBlock[MAX_FORKNUM + 1];
+	uint64		nBlocksToInvalidate = 0;
+	ForkNumber	forkNum;
 	int			i;
 
+	/* Nothing to do if no local buffers were ever used */
+	if (LocalBufHash == NULL)
+		return;
+
+	if (NLocBuffer >= LOCALBUF_DROP_MIN_POOL_SIZE)
+	{
+		for (forkNum = 0; forkNum <= MAX_FORKNUM; forkNum++)
+		{
+			if (smgrexists(smgr, forkNum))
+				nForkBlock[forkNum] = smgrnblocks(smgr, forkNum);
+			else
+				nForkBlock[forkNum] = 0;
+			nBlocksToInvalidate += nForkBlock[forkNum];
+		}
+
+		if (nBlocksToInvalidate < LOCALBUF_DROP_FULL_SCAN_THRESHOLD)
+		{
+			for (forkNum = 0; forkNum <= MAX_FORKNUM; forkNum++)
+				FindAndDropLocalBuffers(rnode, forkNum, nForkBlock[forkNum], 0);
+			return;
+		}
+	}
+
 	for (i = 0; i < NLocBuffer; i++)
 	{
 		BufferDesc *bufHdr = GetLocalBufferDescriptor(i);
-		LocalBufferLookupEnt *hresult;
 		uint32		buf_state;
 
 		buf_state = pg_atomic_read_u32(&bufHdr->state);
 
 		if ((buf_state & BM_TAG_VALID) &&
 			RelFileNodeEquals(bufHdr->tag.rnode, rnode))
-		{
-			if (LocalRefCount[i] != 0)
-				elog(ERROR, "block %u of %s is still referenced (local %u)",
-					 bufHdr->tag.blockNum,
-					 relpathbackend(bufHdr->tag.rnode, MyBackendId,
-									bufHdr->tag.forkNum),
-					 LocalRefCount[i]);
-			/* Remove entry from hashtable */
-			hresult = (LocalBufferLookupEnt *)
-				hash_search(LocalBufHash, (void *) &bufHdr->tag,
-							HASH_REMOVE, NULL);
-			if (!hresult)		/* shouldn't happen */
-				elog(ERROR, "local buffer hash table corrupted");
-			/* Mark buffer invalid */
-			CLEAR_BUFFERTAG(bufHdr->tag);
-			buf_state &= ~BUF_FLAG_MASK;
-			buf_state &= ~BUF_USAGECOUNT_MASK;
-			pg_atomic_unlocked_write_u32(&bufHdr->state, buf_state);
-		}
+			DropLocalBuffer(i, bufHdr, buf_state);
 	}
 }
 
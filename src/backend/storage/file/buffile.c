@@ -62,6 +62,15 @@
 #define MAX_PHYSICAL_FILESIZE	0x40000000
 #define BUFFILE_SEG_SIZE		(MAX_PHYSICAL_FILESIZE / BLCKSZ)
 
+/*
+ * When a BufFile is read sequentially, we ask the kernel to read ahead this
+ * many bytes beyond the current position, topping the window up whenever
+ * half of it has been consumed.  Hash join batches, sort runs and
+ * tuplestores are mostly read back this way, and on storage with high
+ * latency the kernel's own read-ahead may not keep up.
+ */
+#define BUFFILE_READAHEAD_SIZE	(32 * BLCKSZ)
+
 /*
  * This data structure represents a buffered file that consists of one or
  * more physical files (each accessed through a virtual file descriptor
@@ -95,6 +104,15 @@ struct BufFile
 	off_t		curOffset;		/* offset part of current pos */
 	int			pos;			/* next read/write position in buffer */
 	int			nbytes;			/* total # of valid bytes in buffer */
+
+	/*
+	 * Sequential read-ahead state: where the last buffer load ended, and how
+	 * far read-ahead has been requested, within component file raFile.
+	 */
+	int			raFile;
+	off_t		raNext;
+	off_t		raHorizon;
+
 	PGAlignedBlock buffer;
 };
 
@@ -122,6 +140,9 @@ makeBufFileCommon(int nfiles)
 	file->curOffset = 0L;
 	file->pos = 0;
 	file->nbytes = 0;
+	file->raFile = -1;
+	file->raNext = 0;
+	file->raHorizon = 0;
 
 	return file;
 }
@@ -428,10 +449,38 @@ BufFileLoadBuffer(BufFile *file)
 		file->curOffset = 0L;
 	}
 
+	thisfile = file->files[file->curFile];
+
+#ifdef USE_PREFETCH
+	/*
+	 * If this load continues where the previous one ended, keep a window of
+	 * read-ahead in front of us.  Random access only resets the state.
+	 */
+	if (file->raFile == file->curFile && file->raNext == file->curOffset)
+	{
+		off_t		target = Min(file->curOffset + BUFFILE_READAHEAD_SIZE,
+								 MAX_PHYSICAL_FILESIZE);
+
+		if (file->raHorizon < file->curOffset + BLCKSZ)
+			file->raHorizon = file->curOffset + BLCKSZ;
+		if (target - file->raHorizon >= BUFFILE_READAHEAD_SIZE / 2)
+		{
+			(void) FilePrefetch(thisfile, file->raHorizon,
+								target - file->raHorizon,
+								WAIT_EVENT_BUFFILE_READ);
+			file->raHorizon = target;
+		}
+	}
+	else
+	{
+		file->raFile = file->curFile;
+		file->raHorizon = 0;
+	}
+#endif							/* USE_PREFETCH */
+
 	/*
 	 * Read whatever we can get, up to a full bufferload.
 	 */
-	thisfile = file->files[file->curFile];
 	file->nbytes = FileRead(thisfile,
 							file->buffer.data,
 							sizeof(file->buffer),
@@ -447,6 +496,7 @@ BufFileLoadBuffer(BufFile *file)
 	}
 
 	/* we choose not to advance curOffset here */
+	file->raNext = file->curOffset + file->nbytes;
 
 	if (file->nbytes > 0)
 		pgBufferUsage.temp_blks_read++;
@@ -766,6 +816,29 @@ BufFileSeekBlock(BufFile *file, long blknum)
 					   SEEK_SET);
 }
 
+/*
+ * BufFilePrefetchBlock --- hint that a block will be read soon
+ *
+ * This lets the kernel start reading the block in the background, so that a
+ * later BufFileSeekBlock() and read of it is less likely to have to wait.
+ * Blocks past the end of the file are ignored.
+ */
+void
+BufFilePrefetchBlock(BufFile *file, long blknum)
+{
+#ifdef USE_PREFETCH
+	int			fileno = (int) (blknum / BUFFILE_SEG_SIZE);
+
+	if (fileno < 0 || fileno >= file->numFiles)
+		return;
+
+	(void) FilePrefetch(file->files[fileno],
+						(off_t) (blknum % BUFFILE_SEG_SIZE) * BLCKSZ,
+						BLCKSZ,
+						WAIT_EVENT_BUFFILE_READ);
+#endif							/* USE_PREFETCH */
+}
+
 #ifdef NOT_USED
 /*
  * BufFileTellBlock --- block-oriented tell
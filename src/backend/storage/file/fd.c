@@ -90,6 +90,7 @@
 #include "access/xact.h"
 #include "access/xlog.h"
 #include "catalog/pg_tablespace.h"
+#include "commands/progress.h"
 #include "common/file_perm.h"
 #include "common/file_utils.h"
 #include "miscadmin.h"
@@ -2023,16 +2024,36 @@ FileWriteback(File file, off_t offset, off_t nbytes, uint32 wait_event_info)
 int
 FileRead(File file, char *buffer, int amount, off_t offset,
 		 uint32 wait_event_info)
+{
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len = amount;
+
+	return FileReadV(file, &iov, 1, offset, wait_event_info);
+}
+
+/*
+ * FileReadV - read into several buffers with a single system call
+ *
+ * The buffers are filled in order from consecutive file positions starting
+ * at "offset".  Returns the total number of bytes read, which may be less
+ * than requested at EOF, or -1 with errno set on failure.
+ */
+int
+FileReadV(File file, const struct iovec *iov, int iovcnt, off_t offset,
+		  uint32 wait_event_info)
 {
 	int			returnCode;
 	Vfd		   *vfdP;
 
 	Assert(FileIsValid(file));
+	Assert(iovcnt > 0 && iovcnt <= PG_IOV_MAX);
 
-	DO_DB(elog(LOG, "FileRead: %d (%s) " INT64_FORMAT " %d %p",
+	DO_DB(elog(LOG, "FileReadV: %d (%s) " INT64_FORMAT " %d %p",
 			   file, VfdCache[file].fileName,
 			   (int64) offset,
-			   amount, buffer));
+			   iovcnt, iov[0].iov_base));
 
 	returnCode = FileAccess(file);
 	if (returnCode < 0)
@@ -2042,7 +2063,11 @@ FileRead(File file, char *buffer, int amount, off_t offset,
 
 retry:
 	pgstat_report_wait_start(wait_event_info);
-	returnCode = pg_pread(vfdP->fd, buffer, amount, offset);
+	if (iovcnt == 1)
+		returnCode = pg_pread(vfdP->fd, iov[0].iov_base, iov[0].iov_len,
+							  offset);
+	else
+		returnCode = pg_preadv(vfdP->fd, iov, iovcnt, offset);
 	pgstat_report_wait_end();
 
 	if (returnCode < 0)
@@ -2079,16 +2104,41 @@ retry:
 int
 FileWrite(File file, char *buffer, int amount, off_t offset,
 		  uint32 wait_event_info)
+{
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len = amount;
+
+	return FileWriteV(file, &iov, 1, offset, wait_event_info);
+}
+
+/*
+ * FileWriteV - write out several buffers with a single system call
+ *
+ * The buffers are written in order to consecutive file positions starting
+ * at "offset".  Returns the total number of bytes written, or -1 with errno
+ * set on failure.  As for FileWrite(), a short write sets errno to ENOSPC
+ * if the kernel didn't report anything more specific.
+ */
+int
+FileWriteV(File file, const struct iovec *iov, int iovcnt, off_t offset,
+		   uint32 wait_event_info)
 {
 	int			returnCode;
 	Vfd		   *vfdP;
+	int			amount = 0;
 
 	Assert(FileIsValid(file));
+	Assert(iovcnt > 0 && iovcnt <= PG_IOV_MAX);
 
-	DO_DB(elog(LOG, "FileWrite: %d (%s) " INT64_FORMAT " %d %p",
+	for (int i = 0; i < iovcnt; i++)
+		amount += iov[i].iov_len;
+
+	DO_DB(elog(LOG, "FileWriteV: %d (%s) " INT64_FORMAT " %d %d %p",
 			   file, VfdCache[file].fileName,
 			   (int64) offset,
-			   amount, buffer));
+			   amount, iovcnt, iov[0].iov_base));
 
 	returnCode = FileAccess(file);
 	if (returnCode < 0)
@@ -2124,7 +2174,11 @@ FileWrite(File file, char *buffer, int amount, off_t offset,
 retry:
 	errno = 0;
 	pgstat_report_wait_start(wait_event_info);
-	returnCode = pg_pwrite(VfdCache[file].fd, buffer, amount, offset);
+	if (iovcnt == 1)
+		returnCode = pg_pwrite(VfdCache[file].fd, iov[0].iov_base,
+							   iov[0].iov_len, offset);
+	else
+		returnCode = pg_pwritev(VfdCache[file].fd, iov, iovcnt, offset);
 	pgstat_report_wait_end();
 
 	/* if write didn't set errno, assume problem is no disk space */
@@ -2143,6 +2197,8 @@ retry:
 			if (past_write > vfdP->fileSize)
 			{
 				temporary_files_size += past_write - vfdP->fileSize;
+				pgstat_progress_query_incr(PROGRESS_QUERY_TEMP_BYTES_WRITTEN,
+										   past_write - vfdP->fileSize);
 				vfdP->fileSize = past_write;
 			}
 		}
@@ -165,7 +165,11 @@ RecordAndGetPageWithFreeSpace(Relation rel, BlockNumber oldPage,
 	 * Otherwise, search as usual.
 	 */
 	if (search_slot != -1)
+	{
+		RelationOpenSmgr(rel);
+		rel->rd_smgr->smgr_fsm_leaf = (BlockNumber) addr.logpageno;
 		return fsm_get_heap_blk(addr, search_slot);
+	}
 	else
 		return fsm_search(rel, search_cat);
 }
@@ -693,6 +697,41 @@ fsm_search(Relation rel, uint8 min_cat)
 	int			restarts = 0;
 	FSMAddress	addr = FSM_ROOT_ADDRESS;
 
+	/*
+	 * Before descending from the root, try the bottom-level page on which
+	 * the previous search in this backend found space.  The bottom level is
+	 * authoritative, and a single bottom page covers a few thousand heap
+	 * pages, so with a steady stream of inserts this usually succeeds and
+	 * saves locking the upper-level pages on every call.  The hint lives in
+	 * the SMgrRelation, so it goes away on any smgr-level invalidation, such
+	 * as a truncation.
+	 */
+	RelationOpenSmgr(rel);
+	if (rel->rd_smgr->smgr_fsm_leaf != InvalidBlockNumber)
+	{
+		FSMAddress	leaf;
+		Buffer		buf;
+		int			slot = -1;
+
+		leaf.level = FSM_BOTTOM_LEVEL;
+		leaf.logpageno = (int) rel->rd_smgr->smgr_fsm_leaf;
+
+		buf = fsm_readbuf(rel, leaf, false);
+		if (BufferIsValid(buf))
+		{
+			LockBuffer(buf, BUFFER_LOCK_SHARE);
+			slot = fsm_search_avail(buf, min_cat, true, false);
+			UnlockReleaseBuffer(buf);
+		}
+
+		if (slot != -1)
+			return fsm_get_heap_blk(leaf, slot);
+
+		/* Not useful anymore; forget it and search from the root. */
+		RelationOpenSmgr(rel);
+		rel->rd_smgr->smgr_fsm_leaf = InvalidBlockNumber;
+	}
+
 	for (;;)
 	{
 		int			slot;
@@ -723,7 +762,11 @@ fsm_search(Relation rel, uint8 min_cat)
 			 * bottom.
 			 */
 			if (addr.level == FSM_BOTTOM_LEVEL)
+			{
+				RelationOpenSmgr(rel);
+				rel->rd_smgr->smgr_fsm_leaf = (BlockNumber) addr.logpageno;
 				return fsm_get_heap_blk(addr, slot);
+			}
 
 			addr = fsm_get_child(addr, slot);
 		}
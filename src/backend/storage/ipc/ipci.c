@@ -19,6 +19,7 @@
 #include "access/heapam.h"
 #include "access/multixact.h"
 #include "access/nbtree.h"
+#include "access/parallel.h"
 #include "access/subtrans.h"
 #include "access/syncscan.h"
 #include "access/twophase.h"
@@ -46,6 +47,7 @@
 #include "storage/procsignal.h"
 #include "storage/sinvaladt.h"
 #include "storage/spin.h"
+#include "utils/memutils.h"
 #include "utils/snapmgr.h"
 
 /* GUCs */
@@ -133,6 +135,7 @@ CreateSharedMemoryAndSemaphores(void)
 		size = add_size(size, SUBTRANSShmemSize());
 		size = add_size(size, TwoPhaseShmemSize());
 		size = add_size(size, BackgroundWorkerShmemSize());
+		size = add_size(size, ParallelWorkerPoolShmemSize());
 		size = add_size(size, MultiXactShmemSize());
 		size = add_size(size, LWLockShmemSize());
 		size = add_size(size, ProcArrayShmemSize());
@@ -140,6 +143,7 @@ CreateSharedMemoryAndSemaphores(void)
 		size = add_size(size, SInvalShmemSize());
 		size = add_size(size, PMSignalShmemSize());
 		size = add_size(size, ProcSignalShmemSize());
+		size = add_size(size, MemoryContextDumpShmemSize());
 		size = add_size(size, CheckpointerShmemSize());
 		size = add_size(size, AutoVacuumShmemSize());
 		size = add_size(size, ReplicationSlotsShmemSize());
@@ -245,6 +249,7 @@ CreateSharedMemoryAndSemaphores(void)
 	CreateSharedBackendStatus();
 	TwoPhaseShmemInit();
 	BackgroundWorkerShmemInit();
+	ParallelWorkerPoolShmemInit();
 
 	/*
 	 * Set up shared-inval messaging
@@ -256,6 +261,7 @@ CreateSharedMemoryAndSemaphores(void)
 	 */
 	PMSignalShmemInit();
 	ProcSignalShmemInit();
+	MemoryContextDumpShmemInit();
 	CheckpointerShmemInit();
 	AutoVacuumShmemInit();
 	ReplicationSlotsShmemInit();
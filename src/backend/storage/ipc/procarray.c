@@ -48,6 +48,7 @@
 #include <signal.h>
 
 #include "access/clog.h"
+#include "access/parallel.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
 #include "access/twophase.h"
@@ -2013,7 +2014,12 @@ GetMaxSnapshotXidCount(void)
 int
 GetMaxSnapshotSubxidCount(void)
 {
-	return TOTAL_MAX_CACHED_SUBXIDS;
+	/*
+	 * On a primary the subxip array is filled from the PGPROC caches, in hot
+	 * standby from KnownAssignedXids; it must be able to hold either.
+	 */
+	return Max(TOTAL_MAX_CACHED_SUBXIDS,
+			   max_cached_subxids * PROCARRAY_MAXPROCS);
 }
 
 /*
@@ -2720,7 +2726,13 @@ GetRunningTransactionData(void)
 		if (TransactionIdPrecedes(xid, oldestRunningXid))
 			oldestRunningXid = xid;
 
-		if (ProcGlobal->subxidStates[index].overflowed)
+		/*
+		 * A standby can only track PGPROC_MAX_CACHED_SUBXIDS subxids per
+		 * transaction in KnownAssignedXids, so a larger cache has to be
+		 * reported as overflowed too.
+		 */
+		if (ProcGlobal->subxidStates[index].overflowed ||
+			ProcGlobal->subxidStates[index].count > PGPROC_MAX_CACHED_SUBXIDS)
 			suboverflowed = true;
 
 		/*
@@ -3593,8 +3605,9 @@ CountUserBackends(Oid roleid)
  * CountOtherDBBackends -- check for other backends running in the given DB
  *
  * If there are other backends in the DB, we will wait a maximum of 5 seconds
- * for them to exit.  Autovacuum backends are encouraged to exit early by
- * sending them SIGTERM, but normal user backends are just waited for.
+ * for them to exit.  Autovacuum backends and idle pooled parallel workers are
+ * encouraged to exit early by sending them SIGTERM, but normal user backends
+ * are just waited for.
  *
  * The current backend is always ignored; it is caller's responsibility to
  * check whether the current backend uses the given DB, if it's important.
@@ -3671,6 +3684,7 @@ CountOtherDBBackends(Oid databaseId, int *nbackends, int *nprepared)
 		 */
 		for (index = 0; index < nautovacs; index++)
 			(void) kill(autovac_pids[index], SIGTERM);	/* ignore any error */
+		TerminatePooledParallelWorkers(databaseId);
 
 		/* sleep, then try again */
 		pg_usleep(100 * 1000L); /* 100ms */
@@ -19,6 +19,7 @@
 
 #include "access/transam.h"
 #include "miscadmin.h"
+#include "port/pg_bitutils.h"
 #include "storage/backendid.h"
 #include "storage/ipc.h"
 #include "storage/proc.h"
@@ -43,9 +44,9 @@
  * SICleanupQueue is called, and we try not to do that often.)
  *
  * In reality, the messages are stored in a circular buffer of MAXNUMMESSAGES
- * entries.  We translate MsgNum values into circular-buffer indexes by
- * computing MsgNum % MAXNUMMESSAGES (this should be fast as long as
- * MAXNUMMESSAGES is a constant and a power of 2).  As long as maxMsgNum
+ * entries, set by the sinval_queue_size GUC.  We translate MsgNum values into
+ * circular-buffer indexes by computing MsgNum & (MAXNUMMESSAGES - 1), since
+ * MAXNUMMESSAGES is always a power of 2.  As long as maxMsgNum
  * doesn't exceed minMsgNum by more than MAXNUMMESSAGES, we have enough space
  * in the buffer.  If the buffer does overflow, we recover by setting the
  * "reset" flag for each backend that has fallen too far behind.  A backend
@@ -107,10 +108,12 @@
  * Configurable parameters.
  *
  * MAXNUMMESSAGES: max number of shared-inval messages we can buffer.
- * Must be a power of 2 for speed.
+ * It's sinval_queue_size rounded up to a power of 2, at most
+ * MAX_SINVAL_QUEUE_SIZE.
  *
  * MSGNUMWRAPAROUND: how often to reduce MsgNum variables to avoid overflow.
- * Must be a multiple of MAXNUMMESSAGES.  Should be large.
+ * Must be a multiple of MAXNUMMESSAGES.  Should be large, but leave room
+ * for MAXNUMMESSAGES more messages below INT_MAX.
  *
  * CLEANUP_MIN: the minimum number of messages that must be in the buffer
  * before we bother to call SICleanupQueue.
@@ -127,8 +130,9 @@
  * per iteration.
  */
 
-#define MAXNUMMESSAGES 4096
-#define MSGNUMWRAPAROUND (MAXNUMMESSAGES * 262144)
+#define MAXNUMMESSAGES (shmInvalBuffer->maxNumMessages)
+#define MSGNUMWRAPAROUND (1 << 30)
+#define MsgNumToIndex(msgnum) ((msgnum) & (MAXNUMMESSAGES - 1))
 #define CLEANUP_MIN (MAXNUMMESSAGES / 2)
 #define CLEANUP_QUANTUM (MAXNUMMESSAGES / 16)
 #define SIG_THRESHOLD (MAXNUMMESSAGES / 2)
@@ -174,13 +178,15 @@ typedef struct SISeg
 	int			nextThreshold;	/* # of messages to call SICleanupQueue */
 	int			lastBackend;	/* index of last active procState entry, +1 */
 	int			maxBackends;	/* size of procState array */
+	int			maxNumMessages; /* size of buffer array */
 
 	slock_t		msgnumLock;		/* spinlock protecting maxMsgNum */
 
 	/*
-	 * Circular buffer holding shared-inval messages
+	 * Circular buffer holding shared-inval messages, located after
+	 * procState[] (has maxNumMessages entries).
 	 */
-	SharedInvalidationMessage buffer[MAXNUMMESSAGES];
+	SharedInvalidationMessage *buffer;
 
 	/*
 	 * Per-backend invalidation state info (has MaxBackends entries).
@@ -190,9 +196,13 @@ typedef struct SISeg
 
 static SISeg *shmInvalBuffer;	/* pointer to the shared inval buffer */
 
+/* GUC variable */
+int			sinval_queue_size = 4096;
+
 
 static LocalTransactionId nextLocalTransactionId;
 
+static int	SInvalQueueSize(void);
 static void CleanupInvalidationState(int status, Datum arg);
 
 
@@ -206,10 +216,21 @@ SInvalShmemSize(void)
 
 	size = offsetof(SISeg, procState);
 	size = add_size(size, mul_size(sizeof(ProcState), MaxBackends));
+	size = add_size(size, mul_size(sizeof(SharedInvalidationMessage),
+								   SInvalQueueSize()));
 
 	return size;
 }
 
+/*
+ * SInvalQueueSize --- number of messages the queue holds
+ */
+static int
+SInvalQueueSize(void)
+{
+	return (int) pg_nextpower2_32(Min(sinval_queue_size, MAX_SINVAL_QUEUE_SIZE));
+}
+
 /*
  * CreateSharedInvalidationState
  *		Create and initialize the SI message buffer
@@ -226,6 +247,14 @@ CreateSharedInvalidationState(void)
 	if (found)
 		return;
 
+	/*
+	 * Save the queue size and find the buffer first, since CLEANUP_MIN
+	 * depends on the former.
+	 */
+	shmInvalBuffer->maxNumMessages = SInvalQueueSize();
+	shmInvalBuffer->buffer = (SharedInvalidationMessage *)
+		&shmInvalBuffer->procState[MaxBackends];
+
 	/* Clear message counters, save size of procState array, init spinlock */
 	shmInvalBuffer->minMsgNum = 0;
 	shmInvalBuffer->maxMsgNum = 0;
@@ -477,7 +506,7 @@ SIInsertDataEntries(const SharedInvalidationMessage *data, int n)
 		max = segP->maxMsgNum;
 		while (nthistime-- > 0)
 		{
-			segP->buffer[max % MAXNUMMESSAGES] = *data++;
+			segP->buffer[MsgNumToIndex(max)] = *data++;
 			max++;
 		}
 
@@ -600,7 +629,7 @@ SIGetDataEntries(SharedInvalidationMessage *data, int datasize)
 	n = 0;
 	while (n < datasize && stateP->nextMsgNum < max)
 	{
-		data[n++] = segP->buffer[stateP->nextMsgNum % MAXNUMMESSAGES];
+		data[n++] = segP->buffer[MsgNumToIndex(stateP->nextMsgNum)];
 		stateP->nextMsgNum++;
 	}
 
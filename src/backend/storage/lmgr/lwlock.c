@@ -238,9 +238,12 @@ NamedLWLockTranche *NamedLWLockTrancheArray = NULL;
 
 static bool lock_named_request_allowed = true;
 
+/* start time of the current LWLock wait, for the wait statistics */
+static instr_time lwlock_wait_start;
+
 static void InitializeLWLocks(void);
 static inline void LWLockReportWaitStart(LWLock *lock);
-static inline void LWLockReportWaitEnd(void);
+static inline void LWLockReportWaitEnd(LWLock *lock);
 static const char *GetLWTrancheName(uint16 trancheId);
 
 #define T_NAME(lock) \
@@ -757,16 +760,24 @@ LWLockInitialize(LWLock *lock, int tranche_id)
 static inline void
 LWLockReportWaitStart(LWLock *lock)
 {
+	INSTR_TIME_SET_CURRENT(lwlock_wait_start);
 	pgstat_report_wait_start(PG_WAIT_LWLOCK | lock->tranche);
 }
 
 /*
- * Report end of wait event for light-weight locks.
+ * Report end of wait event for light-weight locks, and count the wait in
+ * the LWLock wait statistics.
  */
 static inline void
-LWLockReportWaitEnd(void)
+LWLockReportWaitEnd(LWLock *lock)
 {
+	instr_time	wait_time;
+
 	pgstat_report_wait_end();
+
+	INSTR_TIME_SET_CURRENT(wait_time);
+	INSTR_TIME_SUBTRACT(wait_time, lwlock_wait_start);
+	pgstat_count_lwlock_wait(lock->tranche, wait_time);
 }
 
 /*
@@ -1343,7 +1354,7 @@ LWLockAcquire(LWLock *lock, LWLockMode mode)
 
 		if (TRACE_POSTGRESQL_LWLOCK_WAIT_DONE_ENABLED())
 			TRACE_POSTGRESQL_LWLOCK_WAIT_DONE(T_NAME(lock), mode);
-		LWLockReportWaitEnd();
+		LWLockReportWaitEnd(lock);
 
 		LOG_LWDEBUG("LWLockAcquire", lock, "awakened");
 
@@ -1505,7 +1516,7 @@ LWLockAcquireOrWait(LWLock *lock, LWLockMode mode)
 #endif
 			if (TRACE_POSTGRESQL_LWLOCK_WAIT_DONE_ENABLED())
 				TRACE_POSTGRESQL_LWLOCK_WAIT_DONE(T_NAME(lock), mode);
-			LWLockReportWaitEnd();
+			LWLockReportWaitEnd(lock);
 
 			LOG_LWDEBUG("LWLockAcquireOrWait", lock, "awakened");
 		}
@@ -1726,7 +1737,7 @@ LWLockWaitForVar(LWLock *lock, uint64 *valptr, uint64 oldval, uint64 *newval)
 
 		if (TRACE_POSTGRESQL_LWLOCK_WAIT_DONE_ENABLED())
 			TRACE_POSTGRESQL_LWLOCK_WAIT_DONE(T_NAME(lock), LW_EXCLUSIVE);
-		LWLockReportWaitEnd();
+		LWLockReportWaitEnd(lock);
 
 		LOG_LWDEBUG("LWLockWaitForVar", lock, "awakened");
 
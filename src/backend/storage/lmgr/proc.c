@@ -62,6 +62,7 @@ int			StatementTimeout = 0;
 int			LockTimeout = 0;
 int			IdleInTransactionSessionTimeout = 0;
 int			IdleSessionTimeout = 0;
+int			max_cached_subxids = PGPROC_MAX_CACHED_SUBXIDS;
 bool		log_lock_waits = false;
 
 /* Pointer to this process's PGPROC struct, if any */
@@ -94,6 +95,11 @@ static void ProcKill(int code, Datum arg);
 static void AuxiliaryProcKill(int code, Datum arg);
 static void CheckDeadLock(void);
 
+/* Per-PGPROC shared memory needed for the fast-path lock arrays */
+#define FastPathLockShmemSize() \
+	(MAXALIGN(FastPathLockGroupsPerBackend * sizeof(uint64)) + \
+	 MAXALIGN(FastPathLockSlotsPerBackend() * sizeof(Oid)))
+
 
 /*
  * Report shared-memory space needed by InitProcGlobal.
@@ -114,6 +120,12 @@ ProcGlobalShmemSize(void)
 	size = add_size(size, mul_size(TotalProcs, sizeof(*ProcGlobal->subxidStates)));
 	size = add_size(size, mul_size(TotalProcs, sizeof(*ProcGlobal->statusFlags)));
 
+	/* fast-path lock arrays */
+	size = add_size(size, mul_size(TotalProcs, FastPathLockShmemSize()));
+	size = add_size(size, mul_size(TotalProcs,
+								   mul_size(max_cached_subxids,
+											sizeof(TransactionId))));
+
 	return size;
 }
 
@@ -163,6 +175,8 @@ InitProcGlobal(void)
 				j;
 	bool		found;
 	uint32		TotalProcs = MaxBackends + NUM_AUXILIARY_PROCS + max_prepared_xacts;
+	char	   *fpPtr;
+	TransactionId *subxidPtr;
 
 	/* Create the ProcGlobal shared structure */
 	ProcGlobal = (PROC_HDR *)
@@ -214,6 +228,17 @@ InitProcGlobal(void)
 	ProcGlobal->statusFlags = (uint8 *) ShmemAlloc(TotalProcs * sizeof(*ProcGlobal->statusFlags));
 	MemSet(ProcGlobal->statusFlags, 0, TotalProcs * sizeof(*ProcGlobal->statusFlags));
 
+	/*
+	 * Allocate the fast-path lock arrays, whose size depends on
+	 * max_locks_per_transaction, as one chunk carved up between the PGPROCs.
+	 */
+	fpPtr = ShmemAlloc(TotalProcs * FastPathLockShmemSize());
+	MemSet(fpPtr, 0, TotalProcs * FastPathLockShmemSize());
+
+	/* Likewise for the subtransaction XID caches */
+	subxidPtr = (TransactionId *)
+		ShmemAlloc(TotalProcs * max_cached_subxids * sizeof(TransactionId));
+
 	for (i = 0; i < TotalProcs; i++)
 	{
 		/* Common initialization for all PGPROCs, regardless of type. */
@@ -231,6 +256,13 @@ InitProcGlobal(void)
 		}
 		procs[i].pgprocno = i;
 
+		procs[i].fpLockBits = (uint64 *) fpPtr;
+		procs[i].fpRelId = (Oid *) (fpPtr + MAXALIGN(FastPathLockGroupsPerBackend * sizeof(uint64)));
+		fpPtr += FastPathLockShmemSize();
+
+		procs[i].subxids.xids = subxidPtr;
+		subxidPtr += max_cached_subxids;
+
 		/*
 		 * Newly created PGPROCs for normal backends, autovacuum and bgworkers
 		 * must be queued up on the appropriate free list.  Because there can
@@ -854,38 +886,8 @@ ProcKill(int code, Datum arg)
 	/* Also cleanup all the temporary slots. */
 	ReplicationSlotCleanup();
 
-	/*
-	 * Detach from any lock group of which we are a member.  If the leader
-	 * exist before all other group members, its PGPROC will remain allocated
-	 * until the last group process exits; that process must return the
-	 * leader's PGPROC to the appropriate list.
-	 */
-	if (MyProc->lockGroupLeader != NULL)
-	{
-		PGPROC	   *leader = MyProc->lockGroupLeader;
-		LWLock	   *leader_lwlock = LockHashPartitionLockByProc(leader);
-
-		LWLockAcquire(leader_lwlock, LW_EXCLUSIVE);
-		Assert(!dlist_is_empty(&leader->lockGroupMembers));
-		dlist_delete(&MyProc->lockGroupLink);
-		if (dlist_is_empty(&leader->lockGroupMembers))
-		{
-			leader->lockGroupLeader = NULL;
-			if (leader != MyProc)
-			{
-				procgloballist = leader->procgloballist;
-
-				/* Leader exited first; return its PGPROC. */
-				SpinLockAcquire(ProcStructLock);
-				leader->links.next = (SHM_QUEUE *) *procgloballist;
-				*procgloballist = leader;
-				SpinLockRelease(ProcStructLock);
-			}
-		}
-		else if (leader != MyProc)
-			MyProc->lockGroupLeader = NULL;
-		LWLockRelease(leader_lwlock);
-	}
+	/* Detach from any lock group of which we are a member. */
+	LeaveLockGroup();
 
 	/*
 	 * Reset MyLatch to the process local one.  This is so that signal
@@ -2009,3 +2011,45 @@ BecomeLockGroupMember(PGPROC *leader, int pid)
 
 	return ok;
 }
+
+/*
+ * LeaveLockGroup - detach process from its lock group, if any
+ *
+ * This is called at process exit, and by parallel workers that stay around
+ * to serve another leader.  If the leader exited before all other group
+ * members, its PGPROC will remain allocated until the last group process
+ * leaves; that process must return the leader's PGPROC to the appropriate
+ * list.  A leader that leaves while other members remain stays marked as
+ * the group leader, so that ProcKill knows not to free its PGPROC.
+ */
+void
+LeaveLockGroup(void)
+{
+	PGPROC	   *leader = MyProc->lockGroupLeader;
+	LWLock	   *leader_lwlock;
+
+	if (leader == NULL)
+		return;
+
+	leader_lwlock = LockHashPartitionLockByProc(leader);
+	LWLockAcquire(leader_lwlock, LW_EXCLUSIVE);
+	Assert(!dlist_is_empty(&leader->lockGroupMembers));
+	dlist_delete(&MyProc->lockGroupLink);
+	if (dlist_is_empty(&leader->lockGroupMembers))
+	{
+		leader->lockGroupLeader = NULL;
+		if (leader != MyProc)
+		{
+			PGPROC	   *volatile *procgloballist = leader->procgloballist;
+
+			/* Leader exited first; return its PGPROC. */
+			SpinLockAcquire(ProcStructLock);
+			leader->links.next = (SHM_QUEUE *) *procgloballist;
+			*procgloballist = leader;
+			SpinLockRelease(ProcStructLock);
+		}
+	}
+	else if (leader != MyProc)
+		MyProc->lockGroupLeader = NULL;
+	LWLockRelease(leader_lwlock);
+}
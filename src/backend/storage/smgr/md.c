@@ -31,6 +31,7 @@
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "pgstat.h"
+#include "port/pg_iovec.h"
 #include "postmaster/bgwriter.h"
 #include "storage/bufmgr.h"
 #include "storage/fd.h"
@@ -464,6 +465,91 @@ mdextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 	Assert(_mdnblocks(reln, forknum, v) <= ((BlockNumber) RELSEG_SIZE));
 }
 
+/*
+ *	mdzeroextend() -- Add a run of zero-filled blocks to the specified
+ *					  relation.
+ *
+ *		This is like calling mdextend() once per block with an all-zeroes
+ *		buffer, but blocks that fall into the same segment are written with
+ *		a single vectored write of up to PG_IOV_MAX blocks.
+ */
+void
+mdzeroextend(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+			 BlockNumber nblocks, bool skipFsync)
+{
+	static PGAlignedBlock zerobuf;	/* all zeroes */
+
+	/* This assert is too expensive to have on normally ... */
+#ifdef CHECK_WRITE_VS_EXTEND
+	Assert(blocknum >= mdnblocks(reln, forknum));
+#endif
+
+	/*
+	 * Refuse to create a block whose number is InvalidBlockNumber; see
+	 * mdextend().
+	 */
+	if ((uint64) blocknum + nblocks > (uint64) InvalidBlockNumber)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+				 errmsg("cannot extend file \"%s\" beyond %u blocks",
+						relpath(reln->smgr_rnode, forknum),
+						InvalidBlockNumber)));
+
+	while (nblocks > 0)
+	{
+		struct iovec iov[PG_IOV_MAX];
+		int			iovcnt;
+		off_t		seekpos;
+		int			nbytes;
+		MdfdVec    *v;
+
+		v = _mdfd_getseg(reln, forknum, blocknum, skipFsync, EXTENSION_CREATE);
+
+		seekpos = (off_t) BLCKSZ * (blocknum % ((BlockNumber) RELSEG_SIZE));
+
+		Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
+
+		/* don't cross a segment boundary */
+		iovcnt = Min(nblocks, PG_IOV_MAX);
+		iovcnt = Min(iovcnt,
+					 RELSEG_SIZE - (blocknum % ((BlockNumber) RELSEG_SIZE)));
+
+		for (int i = 0; i < iovcnt; i++)
+		{
+			iov[i].iov_base = zerobuf.data;
+			iov[i].iov_len = BLCKSZ;
+		}
+
+		nbytes = FileWriteV(v->mdfd_vfd, iov, iovcnt, seekpos,
+							WAIT_EVENT_DATA_FILE_EXTEND);
+
+		if (nbytes != iovcnt * BLCKSZ)
+		{
+			if (nbytes < 0)
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not extend file \"%s\": %m",
+								FilePathName(v->mdfd_vfd)),
+						 errhint("Check free disk space.")));
+			/* short write: complain appropriately */
+			ereport(ERROR,
+					(errcode(ERRCODE_DISK_FULL),
+					 errmsg("could not extend file \"%s\": wrote only %d of %d bytes at block %u",
+							FilePathName(v->mdfd_vfd),
+							nbytes, iovcnt * BLCKSZ, blocknum),
+					 errhint("Check free disk space.")));
+		}
+
+		if (!skipFsync && !SmgrIsTemp(reln))
+			register_dirty_segment(reln, forknum, v);
+
+		Assert(_mdnblocks(reln, forknum, v) <= ((BlockNumber) RELSEG_SIZE));
+
+		blocknum += iovcnt;
+		nblocks -= iovcnt;
+	}
+}
+
 /*
  *	mdopenfork() -- Open one fork of the specified relation.
  *
@@ -750,6 +836,144 @@ mdwrite(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
 		register_dirty_segment(reln, forknum, v);
 }
 
+/*
+ *	mdreadv() -- Read the specified run of consecutive blocks from a
+ *				 relation.
+ *
+ *		The blocks are read with as few system calls as possible: we issue
+ *		one vectored read per segment, of up to PG_IOV_MAX blocks each.
+ *		Short reads are handed to mdread() one block at a time, so that EOF
+ *		conditions are reported (or tolerated) exactly as for single-block
+ *		reads.
+ */
+void
+mdreadv(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+		char **buffers, BlockNumber nblocks)
+{
+	while (nblocks > 0)
+	{
+		struct iovec iov[PG_IOV_MAX];
+		int			iovcnt;
+		off_t		seekpos;
+		int			nbytes;
+		int			nread;
+		MdfdVec    *v;
+
+		v = _mdfd_getseg(reln, forknum, blocknum, false,
+						 EXTENSION_FAIL | EXTENSION_CREATE_RECOVERY);
+
+		seekpos = (off_t) BLCKSZ * (blocknum % ((BlockNumber) RELSEG_SIZE));
+
+		Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
+
+		/* don't cross a segment boundary */
+		iovcnt = Min(nblocks, PG_IOV_MAX);
+		iovcnt = Min(iovcnt,
+					 RELSEG_SIZE - (blocknum % ((BlockNumber) RELSEG_SIZE)));
+
+		for (int i = 0; i < iovcnt; i++)
+		{
+			iov[i].iov_base = buffers[i];
+			iov[i].iov_len = BLCKSZ;
+		}
+
+		nbytes = FileReadV(v->mdfd_vfd, iov, iovcnt, seekpos,
+						   WAIT_EVENT_DATA_FILE_READ);
+
+		if (nbytes < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read blocks %u..%u in file \"%s\": %m",
+							blocknum, blocknum + iovcnt - 1,
+							FilePathName(v->mdfd_vfd))));
+
+		nread = nbytes / BLCKSZ;
+		if (nread < iovcnt)
+		{
+			/* Short read; let mdread() deal with the first missing block */
+			mdread(reln, forknum, blocknum + nread, buffers[nread]);
+			nread++;
+		}
+
+		blocknum += nread;
+		buffers += nread;
+		nblocks -= nread;
+	}
+}
+
+/*
+ *	mdwritev() -- Write the supplied run of consecutive blocks at the
+ *				  appropriate location.
+ *
+ *		Like mdwrite(), this is to be used only for updating already-existing
+ *		blocks of a relation.  Blocks that fall into the same segment are
+ *		written with a single vectored write of up to PG_IOV_MAX blocks.
+ */
+void
+mdwritev(SMgrRelation reln, ForkNumber forknum, BlockNumber blocknum,
+		 char **buffers, BlockNumber nblocks, bool skipFsync)
+{
+	/* This assert is too expensive to have on normally ... */
+#ifdef CHECK_WRITE_VS_EXTEND
+	Assert(blocknum + nblocks <= mdnblocks(reln, forknum));
+#endif
+
+	while (nblocks > 0)
+	{
+		struct iovec iov[PG_IOV_MAX];
+		int			iovcnt;
+		off_t		seekpos;
+		int			nbytes;
+		MdfdVec    *v;
+
+		v = _mdfd_getseg(reln, forknum, blocknum, skipFsync,
+						 EXTENSION_FAIL | EXTENSION_CREATE_RECOVERY);
+
+		seekpos = (off_t) BLCKSZ * (blocknum % ((BlockNumber) RELSEG_SIZE));
+
+		Assert(seekpos < (off_t) BLCKSZ * RELSEG_SIZE);
+
+		/* don't cross a segment boundary */
+		iovcnt = Min(nblocks, PG_IOV_MAX);
+		iovcnt = Min(iovcnt,
+					 RELSEG_SIZE - (blocknum % ((BlockNumber) RELSEG_SIZE)));
+
+		for (int i = 0; i < iovcnt; i++)
+		{
+			iov[i].iov_base = buffers[i];
+			iov[i].iov_len = BLCKSZ;
+		}
+
+		nbytes = FileWriteV(v->mdfd_vfd, iov, iovcnt, seekpos,
+							WAIT_EVENT_DATA_FILE_WRITE);
+
+		if (nbytes != iovcnt * BLCKSZ)
+		{
+			if (nbytes < 0)
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not write blocks %u..%u in file \"%s\": %m",
+								blocknum, blocknum + iovcnt - 1,
+								FilePathName(v->mdfd_vfd))));
+			/* short write: complain appropriately */
+			ereport(ERROR,
+					(errcode(ERRCODE_DISK_FULL),
+					 errmsg("could not write blocks %u..%u in file \"%s\": wrote only %d of %d bytes",
+							blocknum, blocknum + iovcnt - 1,
+							FilePathName(v->mdfd_vfd),
+							nbytes, iovcnt * BLCKSZ),
+					 errhint("Check free disk space.")));
+		}
+
+		if (!skipFsync && !SmgrIsTemp(reln))
+			register_dirty_segment(reln, forknum, v);
+
+		blocknum += iovcnt;
+		buffers += iovcnt;
+		nblocks -= iovcnt;
+	}
+}
+
 /*
  *	mdnblocks() -- Get the number of blocks stored in a relation.
  *
@@ -949,6 +1173,9 @@ mdimmedsync(SMgrRelation reln, ForkNumber forknum)
 					(errcode_for_file_access(),
 					 errmsg("could not fsync file \"%s\": %m",
 							FilePathName(v->mdfd_vfd))));
+		pgstat_count_io_op(SmgrIsTemp(reln) ? IOOBJECT_TEMP_RELATION :
+						   IOOBJECT_RELATION,
+						   IOCONTEXT_NORMAL, IOOP_FSYNC);
 
 		/* Close inactive segments immediately */
 		if (segno > min_inactive_seg)
@@ -990,6 +1217,7 @@ register_dirty_segment(SMgrRelation reln, ForkNumber forknum, MdfdVec *seg)
 					(errcode_for_file_access(),
 					 errmsg("could not fsync file \"%s\": %m",
 							FilePathName(seg->mdfd_vfd))));
+		pgstat_count_io_op(IOOBJECT_RELATION, IOCONTEXT_NORMAL, IOOP_FSYNC);
 	}
 }
 
@@ -1362,6 +1590,7 @@ mdsyncfiletag(const FileTag *ftag, char *path)
 	/* Sync the file. */
 	result = FileSync(file, WAIT_EVENT_DATA_FILE_SYNC);
 	save_errno = errno;
+	pgstat_count_io_op(IOOBJECT_RELATION, IOCONTEXT_NORMAL, IOOP_FSYNC);
 
 	if (need_to_close)
 		FileClose(file);
@@ -23,6 +23,7 @@
 #include "access/multixact.h"
 #include "access/xlog.h"
 #include "access/xlogutils.h"
+#include "catalog/pg_tablespace_d.h"
 #include "commands/tablespace.h"
 #include "miscadmin.h"
 #include "pgstat.h"
@@ -30,6 +31,7 @@
 #include "postmaster/bgwriter.h"
 #include "storage/bufmgr.h"
 #include "storage/ipc.h"
+#include "storage/fd.h"
 #include "storage/md.h"
 #include "utils/hsearch.h"
 #include "utils/inval.h"
@@ -78,6 +80,13 @@ static MemoryContext pendingOpsCxt; /* context for the above  */
 static CycleCtr sync_cycle_ctr = 0;
 static CycleCtr checkpoint_cycle_ctr = 0;
 
+/* GUC parameter */
+int			checkpoint_sync_method = CHECKPOINT_SYNC_METHOD_FSYNC;
+
+#ifdef HAVE_SYNCFS
+static void ProcessSyncRequestsSyncfs(void);
+#endif
+
 /* Intervals for calling AbsorbSyncRequests */
 #define FSYNCS_PER_ABSORB		10
 #define UNLINKS_PER_ABSORB		10
@@ -329,6 +338,15 @@ ProcessSyncRequests(void)
 	/* Set flag to detect failure if we don't reach the end of the loop */
 	sync_in_progress = true;
 
+#ifdef HAVE_SYNCFS
+	if (enableFsync && checkpoint_sync_method == CHECKPOINT_SYNC_METHOD_SYNCFS)
+	{
+		ProcessSyncRequestsSyncfs();
+		sync_in_progress = false;
+		return;
+	}
+#endif
+
 	/* Now scan the hashtable for fsync requests to process */
 	absorb_counter = FSYNCS_PER_ABSORB;
 	hash_seq_init(&hstat, pendingOps);
@@ -445,6 +463,162 @@ ProcessSyncRequests(void)
 	sync_in_progress = false;
 }
 
+#ifdef HAVE_SYNCFS
+/*
+ * syncfs() the file system containing the given file or directory.
+ */
+static void
+SyncFileSystem(const char *path)
+{
+	int			fd;
+
+	fd = OpenTransientFile(path, O_RDONLY);
+	if (fd < 0)
+	{
+		/* a tablespace could have been dropped since we looked at it */
+		if (!FILE_POSSIBLY_DELETED(errno))
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not open file \"%s\": %m", path)));
+		return;
+	}
+	if (syncfs(fd) < 0)
+		ereport(data_sync_elevel(ERROR),
+				(errcode_for_file_access(),
+				 errmsg("could not synchronize file system for file \"%s\": %m",
+						path)));
+	CloseTransientFile(fd);
+}
+
+/*
+ * The tablespace whose file system holds the file of a pending request, or
+ * InvalidOid for the data directory.
+ */
+static Oid
+SyncRequestTablespace(PendingFsyncEntry *entry)
+{
+	if (entry->tag.handler == SYNC_HANDLER_MD &&
+		entry->tag.rnode.spcNode != DEFAULTTABLESPACE_OID &&
+		entry->tag.rnode.spcNode != GLOBALTABLESPACE_OID)
+		return entry->tag.rnode.spcNode;
+	return InvalidOid;
+}
+
+/*
+ * ProcessSyncRequestsSyncfs() -- ProcessSyncRequests() for
+ * checkpoint_sync_method = syncfs
+ *
+ * Rather than fsync'ing every file that has a pending request, syncfs() each
+ * file system holding one of them, once.  Only the data directory and
+ * tablespaces are candidates, since those are the only places where we
+ * tolerate file system boundaries.  All the requests of the ending cycle
+ * were entered before we got here, so a single pass covers them; requests
+ * entered meanwhile are left for the next checkpoint as usual.
+ *
+ * We absorb requests between file systems, and a new request for a file
+ * that already has an entry is merged into that entry without changing its
+ * cycle counter.  So we must forget a file system's entries right after
+ * syncing it, before absorbing: anything merged into an entry later, after
+ * its file system was synced, has to survive until the next checkpoint.
+ */
+static void
+ProcessSyncRequestsSyncfs(void)
+{
+	HASH_SEQ_STATUS hstat;
+	PendingFsyncEntry *entry;
+	List	   *tablespaces = NIL;
+	bool		sync_datadir = false;
+	ListCell   *lc;
+	int			processed = 0;
+	instr_time	sync_start,
+				sync_end,
+				sync_diff;
+	uint64		elapsed;
+	uint64		longest = 0;
+	uint64		total_elapsed = 0;
+
+	/* Find the file systems we need to sync */
+	hash_seq_init(&hstat, pendingOps);
+	while ((entry = (PendingFsyncEntry *) hash_seq_search(&hstat)) != NULL)
+	{
+		if (entry->cycle_ctr == sync_cycle_ctr || entry->canceled)
+			continue;
+
+		if (OidIsValid(SyncRequestTablespace(entry)))
+			tablespaces = list_append_unique_oid(tablespaces,
+												 SyncRequestTablespace(entry));
+		else
+			sync_datadir = true;
+		processed++;
+	}
+
+	if (sync_datadir)
+		tablespaces = lcons_oid(InvalidOid, tablespaces);
+
+	foreach(lc, tablespaces)
+	{
+		Oid			spcoid = lfirst_oid(lc);
+		char		path[MAXPGPATH];
+
+		if (OidIsValid(spcoid))
+			snprintf(path, sizeof(path), "pg_tblspc/%u", spcoid);
+		else
+			strlcpy(path, ".", sizeof(path));
+
+		INSTR_TIME_SET_CURRENT(sync_start);
+		SyncFileSystem(path);
+		INSTR_TIME_SET_CURRENT(sync_end);
+		sync_diff = sync_end;
+		INSTR_TIME_SUBTRACT(sync_diff, sync_start);
+		elapsed = INSTR_TIME_GET_MICROSEC(sync_diff);
+		if (elapsed > longest)
+			longest = elapsed;
+		total_elapsed += elapsed;
+
+		if (log_checkpoints)
+			elog(DEBUG1, "checkpoint sync: file system of \"%s\" time=%.3f ms",
+				 path, (double) elapsed / 1000);
+
+		/* This file system's requests from the ending cycle are now durable */
+		hash_seq_init(&hstat, pendingOps);
+		while ((entry = (PendingFsyncEntry *) hash_seq_search(&hstat)) != NULL)
+		{
+			if (entry->cycle_ctr == sync_cycle_ctr ||
+				SyncRequestTablespace(entry) != spcoid)
+				continue;
+
+			if (hash_search(pendingOps, &entry->tag, HASH_REMOVE, NULL) == NULL)
+				elog(ERROR, "pendingOps corrupted");
+		}
+
+		/* Keep the request queue from filling up meanwhile */
+		AbsorbSyncRequests();
+	}
+
+	list_free(tablespaces);
+
+	/*
+	 * Any entries left over from the ending cycle were canceled before we
+	 * started, and not entered again since, so just forget them.
+	 */
+	hash_seq_init(&hstat, pendingOps);
+	while ((entry = (PendingFsyncEntry *) hash_seq_search(&hstat)) != NULL)
+	{
+		if (entry->cycle_ctr == sync_cycle_ctr)
+			continue;
+
+		Assert(entry->canceled);
+		if (hash_search(pendingOps, &entry->tag, HASH_REMOVE, NULL) == NULL)
+			elog(ERROR, "pendingOps corrupted");
+	}
+
+	/* Return sync performance metrics for report at checkpoint end */
+	CheckpointStats.ckpt_sync_rels = processed;
+	CheckpointStats.ckpt_longest_sync = longest;
+	CheckpointStats.ckpt_agg_sync_time = total_elapsed;
+}
+#endif							/* HAVE_SYNCFS */
+
 /*
  * RememberSyncRequest() -- callback from checkpointer side of sync request
  *
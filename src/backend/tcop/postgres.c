@@ -3356,6 +3356,15 @@ ProcessInterrupts(void)
 
 	if (LogMemoryContextPending)
 		ProcessLogMemoryContextInterrupt();
+
+	if (DumpMemoryContextPending)
+		ProcessDumpMemoryContextInterrupt();
+
+	if (QueryProgressPending)
+	{
+		QueryProgressPending = false;
+		pgstat_progress_flush_query();
+	}
 }
 
 
@@ -4040,6 +4049,7 @@ PostgresMain(int argc, char *argv[],
 
 		/* Initialize MaxBackends (if under postmaster, was done already) */
 		InitializeMaxBackends();
+		InitializeFastPathLocks();
 	}
 
 	/* Early initialization */
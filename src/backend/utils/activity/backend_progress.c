@@ -10,9 +10,24 @@
  */
 #include "postgres.h"
 
+#include "commands/progress.h"
 #include "port/atomics.h" /* for memory barriers */
 #include "utils/backend_progress.h"
 #include "utils/backend_status.h"
+#include "utils/timeout.h"
+
+
+/* How often the progress of a running query is published, in milliseconds */
+#define QUERY_PROGRESS_INTERVAL_MS	1000
+
+/* GUC parameter */
+bool		pgstat_track_query_progress = false;
+
+/* Local counters for PROGRESS_COMMAND_QUERY */
+int64		pgstat_query_progress[PGSTAT_NUM_PROGRESS_PARAM];
+
+/* The query's own count of rows processed, while one is being tracked */
+static const uint64 *query_progress_rows_processed = NULL;
 
 
 /*-----------
@@ -110,3 +125,86 @@ pgstat_progress_end_command(void)
 	beentry->st_progress_command_target = InvalidOid;
 	PGSTAT_END_WRITE_ACTIVITY(beentry);
 }
+
+/*-----------
+ * pgstat_progress_start_query() -
+ *
+ * Start reporting the progress of a query as PROGRESS_COMMAND_QUERY, if
+ * track_query_progress is on and no other command is being reported.
+ * Returns true if so, in which case the caller must call
+ * pgstat_progress_end_query() when the query is done, unless it errors out.
+ *
+ * rows_processed must stay valid until then; it is read whenever the
+ * progress is published.
+ *-----------
+ */
+bool
+pgstat_progress_start_query(const uint64 *rows_processed)
+{
+	volatile PgBackendStatus *beentry = MyBEEntry;
+
+	if (!beentry || !pgstat_track_activities || !pgstat_track_query_progress)
+		return false;
+
+	/* Nested queries, and queries run by other commands, aren't reported */
+	if (beentry->st_progress_command != PROGRESS_COMMAND_INVALID)
+		return false;
+
+	MemSet(pgstat_query_progress, 0, sizeof(pgstat_query_progress));
+	query_progress_rows_processed = rows_processed;
+
+	pgstat_progress_start_command(PROGRESS_COMMAND_QUERY, InvalidOid);
+	enable_timeout_after(QUERY_PROGRESS_TIMEOUT, QUERY_PROGRESS_INTERVAL_MS);
+
+	return true;
+}
+
+/*-----------
+ * pgstat_progress_flush_query() -
+ *
+ * Copy the local query progress counters to our backend entry, and arrange
+ * to do it again later.  Called from ProcessInterrupts() when
+ * QUERY_PROGRESS_TIMEOUT has fired.
+ *
+ * If the query has gone away in the meantime, because it errored out,
+ * just let the timeout lapse.
+ *-----------
+ */
+void
+pgstat_progress_flush_query(void)
+{
+	volatile PgBackendStatus *beentry = MyBEEntry;
+	int			i;
+
+	if (!beentry || beentry->st_progress_command != PROGRESS_COMMAND_QUERY ||
+		query_progress_rows_processed == NULL)
+		return;
+
+	pgstat_query_progress[PROGRESS_QUERY_ROWS_PROCESSED] =
+		(int64) *query_progress_rows_processed;
+
+	PGSTAT_BEGIN_WRITE_ACTIVITY(beentry);
+	for (i = 0; i < PGSTAT_NUM_PROGRESS_PARAM; i++)
+		beentry->st_progress_param[i] = pgstat_query_progress[i];
+	PGSTAT_END_WRITE_ACTIVITY(beentry);
+
+	enable_timeout_after(QUERY_PROGRESS_TIMEOUT, QUERY_PROGRESS_INTERVAL_MS);
+}
+
+/*-----------
+ * pgstat_progress_end_query() -
+ *
+ * Stop reporting the progress of the query started by
+ * pgstat_progress_start_query().
+ *-----------
+ */
+void
+pgstat_progress_end_query(void)
+{
+	disable_timeout(QUERY_PROGRESS_TIMEOUT, false);
+	query_progress_rows_processed = NULL;
+
+	/* A nested command might have taken over the entry in the meantime */
+	if (MyBEEntry && MyBEEntry->st_progress_command == PROGRESS_COMMAND_QUERY)
+		pgstat_progress_end_command();
+}
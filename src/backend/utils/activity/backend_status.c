@@ -399,6 +399,7 @@ pgstat_bestart(void)
 	lbeentry.st_progress_command = PROGRESS_COMMAND_INVALID;
 	lbeentry.st_progress_command_target = InvalidOid;
 	lbeentry.st_query_id = UINT64CONST(0);
+	lbeentry.st_allocated_bytes = 0;
 
 	/*
 	 * we don't zero st_progress_param here to save cycles; nobody should
@@ -421,6 +422,9 @@ pgstat_bestart(void)
 		   &lbeentry,
 		   sizeof(PgBackendStatus));
 
+	/* From now on, count memory context allocations in the shared entry */
+	MemoryContextSetAllocatedBytesTarget(&MyBEEntry->st_allocated_bytes);
+
 	/*
 	 * We can write the out-of-line strings and structs using the pointers
 	 * that are in lbeentry; this saves some de-volatilizing messiness.
@@ -466,6 +470,9 @@ pgstat_beshutdown_hook(int code, Datum arg)
 	 */
 	PGSTAT_BEGIN_WRITE_ACTIVITY(beentry);
 
+	/* Stop counting allocations in the entry before giving it up */
+	MemoryContextSetAllocatedBytesTarget(NULL);
+
 	beentry->st_procpid = 0;	/* mark invalid */
 
 	PGSTAT_END_WRITE_ACTIVITY(beentry);
@@ -1041,6 +1048,54 @@ pgstat_get_my_query_id(void)
 	return MyBEEntry->st_query_id;
 }
 
+/* ----------
+ * pgstat_get_backend_sample() -
+ *
+ *	Fetch the state and query identifier of the backend with the given
+ *	backend ID, if its entry still belongs to the given PID.  This looks
+ *	directly at the BackendStatusArray and copies nothing else, so it is
+ *	cheap enough to be called at a high rate by sampling profilers.
+ *
+ *	Returns false if the entry is not in use by that PID.
+ * ----------
+ */
+bool
+pgstat_get_backend_sample(int beid, int pid,
+						  BackendState *state, uint64 *query_id)
+{
+	volatile PgBackendStatus *vbeentry;
+	bool		found;
+
+	if (beid < 1 || beid > MaxBackends)
+		return false;
+
+	vbeentry = &BackendStatusArray[beid - 1];
+
+	/* Follow the changecount protocol, see pgstat_read_current_status() */
+	for (;;)
+	{
+		int			before_changecount;
+		int			after_changecount;
+
+		pgstat_begin_read_activity(vbeentry, before_changecount);
+
+		found = (vbeentry->st_procpid == pid);
+		*state = vbeentry->st_state;
+		*query_id = vbeentry->st_query_id;
+
+		pgstat_end_read_activity(vbeentry, after_changecount);
+
+		if (pgstat_read_activity_complete(before_changecount,
+										  after_changecount))
+			break;
+
+		/* Make sure we can break out of loop if stuck... */
+		CHECK_FOR_INTERRUPTS();
+	}
+
+	return found;
+}
+
 
 /* ----------
  * pgstat_fetch_stat_beentry() -
@@ -22,6 +22,7 @@
  */
 #include "postgres.h"
 
+#include "executor/instrument.h"
 #include "storage/lmgr.h" /* for GetLockNameFromTagType */
 #include "storage/lwlock.h" /* for GetLWLockIdentifier */
 #include "utils/wait_event.h"
@@ -37,6 +38,13 @@ static const char *pgstat_get_wait_io(WaitEventIO w);
 static uint32 local_my_wait_event_info;
 uint32	   *my_wait_event_info = &local_my_wait_event_info;
 
+/* GUC parameter */
+bool		track_wait_timing = false;
+
+/* start time and WaitUsage class of the wait being timed, if any */
+static instr_time wait_timing_start;
+static int	wait_timing_class = -1;
+
 
 /*
  * Configure wait event reporting to report wait events to *wait_event_info.
@@ -64,6 +72,57 @@ pgstat_reset_wait_event_storage(void)
 	my_wait_event_info = &local_my_wait_event_info;
 }
 
+/*
+ * Start timing a wait, for track_wait_timing.
+ *
+ * Waits of the Activity class are background processes' main loops waiting
+ * for work, so they aren't counted.
+ */
+void
+pgstat_report_wait_timing_start(uint32 wait_event_info)
+{
+	switch (wait_event_info & 0xFF000000)
+	{
+		case PG_WAIT_LWLOCK:
+			wait_timing_class = WAIT_USAGE_LWLOCK;
+			break;
+		case PG_WAIT_LOCK:
+			wait_timing_class = WAIT_USAGE_LOCK;
+			break;
+		case PG_WAIT_IO:
+			wait_timing_class = WAIT_USAGE_IO;
+			break;
+		case PG_WAIT_CLIENT:
+			wait_timing_class = WAIT_USAGE_CLIENT;
+			break;
+		case PG_WAIT_ACTIVITY:
+			wait_timing_class = -1;
+			return;
+		default:
+			wait_timing_class = WAIT_USAGE_OTHER;
+			break;
+	}
+
+	INSTR_TIME_SET_CURRENT(wait_timing_start);
+}
+
+/*
+ * Stop timing the current wait, if any, and add its duration to pgWaitUsage.
+ */
+void
+pgstat_report_wait_timing_end(void)
+{
+	instr_time	now;
+
+	if (wait_timing_class < 0)
+		return;
+
+	INSTR_TIME_SET_CURRENT(now);
+	INSTR_TIME_ACCUM_DIFF(pgWaitUsage.wait_time[wait_timing_class],
+						  now, wait_timing_start);
+	wait_timing_class = -1;
+}
+
 /* ----------
  * pgstat_get_wait_event_type() -
  *
@@ -230,6 +289,9 @@ pgstat_get_wait_activity(WaitEventActivity w)
 		case WAIT_EVENT_LOGICAL_LAUNCHER_MAIN:
 			event_name = "LogicalLauncherMain";
 			break;
+		case WAIT_EVENT_PARALLEL_WORKER_IDLE:
+			event_name = "ParallelWorkerIdle";
+			break;
 		case WAIT_EVENT_PGSTAT_MAIN:
 			event_name = "PgStatMain";
 			break;
@@ -391,6 +453,9 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 		case WAIT_EVENT_LOGICAL_SYNC_STATE_CHANGE:
 			event_name = "LogicalSyncStateChange";
 			break;
+		case WAIT_EVENT_MEMORY_CONTEXT_DUMP:
+			event_name = "MemoryContextDump";
+			break;
 		case WAIT_EVENT_MQ_INTERNAL:
 			event_name = "MessageQueueInternal";
 			break;
@@ -403,6 +468,9 @@ pgstat_get_wait_ipc(WaitEventIPC w)
 		case WAIT_EVENT_MQ_SEND:
 			event_name = "MessageQueueSend";
 			break;
+		case WAIT_EVENT_MULTIXACT_CREATION:
+			event_name = "MultixactCreation";
+			break;
 		case WAIT_EVENT_PARALLEL_BITMAP_SCAN:
 			event_name = "ParallelBitmapScan";
 			break;
@@ -16,6 +16,7 @@
 
 #include <limits.h>
 
+#include "access/detoast.h"
 #include "access/htup_details.h"
 #include "catalog/pg_type.h"
 #include "common/jsonapi.h"
@@ -333,6 +334,33 @@ typedef struct JsObject
 			hash_destroy((jso)->val.json_hash); \
 	} while (0)
 
+/*
+ * Cache of jsonb documents fetched from toast pointers.
+ *
+ * A query that extracts several fields from the same jsonb column calls the
+ * extraction functions several times with the same toast pointer, and each
+ * call would fetch and decompress the whole document again.  To avoid that,
+ * the extraction functions remember the last few documents they fetched,
+ * keyed by their toast pointers.  The cache lives in a child of the callers'
+ * fn_mcxt, which for expressions is the executor's per-query context; within
+ * a query, a toast pointer always refers to the same value.  A caller with a
+ * different fn_mcxt starts a new cache.
+ */
+#define JSONB_DETOAST_CACHE_SIZE	4
+
+typedef struct JsonbDetoastCache
+{
+	MemoryContext cxt;			/* context holding the cache, or NULL */
+	int			next;			/* entry to replace next */
+	struct varatt_external pointers[JSONB_DETOAST_CACHE_SIZE];
+	Jsonb	   *values[JSONB_DETOAST_CACHE_SIZE];
+} JsonbDetoastCache;
+
+static JsonbDetoastCache jsonb_detoast_cache;
+
+static Jsonb *jsonb_detoast_cached(FunctionCallInfo fcinfo, int argno);
+static void jsonb_detoast_cache_reset(void *arg);
+
 static int	report_json_context(JsonLexContext *lex);
 
 /* semantic action functions for json_object_keys */
@@ -813,10 +841,82 @@ json_object_field(PG_FUNCTION_ARGS)
 		PG_RETURN_NULL();
 }
 
+/*
+ * Fetch jsonb argument 'argno', using the cache of documents fetched from
+ * toast pointers.  The result must not be modified or freed by the caller,
+ * nor be part of the function's result.
+ */
+static Jsonb *
+jsonb_detoast_cached(FunctionCallInfo fcinfo, int argno)
+{
+	Datum		d = PG_GETARG_DATUM(argno);
+	struct varlena *attr = (struct varlena *) DatumGetPointer(d);
+	JsonbDetoastCache *cache = &jsonb_detoast_cache;
+	struct varatt_external toast_pointer;
+	MemoryContext oldcxt;
+	Jsonb	   *result;
+	int			i;
+
+	if (!VARATT_IS_EXTERNAL_ONDISK(attr) || fcinfo->flinfo == NULL)
+		return DatumGetJsonbP(d);
+
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+
+	if (cache->cxt != NULL &&
+		MemoryContextGetParent(cache->cxt) == fcinfo->flinfo->fn_mcxt)
+	{
+		for (i = 0; i < JSONB_DETOAST_CACHE_SIZE; i++)
+		{
+			if (cache->values[i] != NULL &&
+				memcmp(&cache->pointers[i], &toast_pointer,
+					   sizeof(toast_pointer)) == 0)
+				return cache->values[i];
+		}
+	}
+	else
+	{
+		MemoryContextCallback *cb;
+
+		/* this resets the cache, through jsonb_detoast_cache_reset() */
+		if (cache->cxt != NULL)
+			MemoryContextDelete(cache->cxt);
+
+		cache->cxt = AllocSetContextCreate(fcinfo->flinfo->fn_mcxt,
+										   "jsonb detoast cache",
+										   ALLOCSET_DEFAULT_SIZES);
+		cb = MemoryContextAlloc(cache->cxt, sizeof(MemoryContextCallback));
+		cb->func = jsonb_detoast_cache_reset;
+		cb->arg = NULL;
+		MemoryContextRegisterResetCallback(cache->cxt, cb);
+	}
+
+	oldcxt = MemoryContextSwitchTo(cache->cxt);
+	result = DatumGetJsonbP(d);
+	MemoryContextSwitchTo(oldcxt);
+
+	i = cache->next;
+	if (cache->values[i] != NULL)
+		pfree(cache->values[i]);
+	cache->pointers[i] = toast_pointer;
+	cache->values[i] = result;
+	cache->next = (i + 1) % JSONB_DETOAST_CACHE_SIZE;
+
+	return result;
+}
+
+/*
+ * Memory context callback forgetting the cache when its context goes away.
+ */
+static void
+jsonb_detoast_cache_reset(void *arg)
+{
+	memset(&jsonb_detoast_cache, 0, sizeof(jsonb_detoast_cache));
+}
+
 Datum
 jsonb_object_field(PG_FUNCTION_ARGS)
 {
-	Jsonb	   *jb = PG_GETARG_JSONB_P(0);
+	Jsonb	   *jb = jsonb_detoast_cached(fcinfo, 0);
 	text	   *key = PG_GETARG_TEXT_PP(1);
 	JsonbValue *v;
 	JsonbValue	vbuf;
@@ -854,7 +954,7 @@ json_object_field_text(PG_FUNCTION_ARGS)
 Datum
 jsonb_object_field_text(PG_FUNCTION_ARGS)
 {
-	Jsonb	   *jb = PG_GETARG_JSONB_P(0);
+	Jsonb	   *jb = jsonb_detoast_cached(fcinfo, 0);
 	text	   *key = PG_GETARG_TEXT_PP(1);
 	JsonbValue *v;
 	JsonbValue	vbuf;
@@ -891,7 +991,7 @@ json_array_element(PG_FUNCTION_ARGS)
 Datum
 jsonb_array_element(PG_FUNCTION_ARGS)
 {
-	Jsonb	   *jb = PG_GETARG_JSONB_P(0);
+	Jsonb	   *jb = jsonb_detoast_cached(fcinfo, 0);
 	int			element = PG_GETARG_INT32(1);
 	JsonbValue *v;
 
@@ -934,7 +1034,7 @@ json_array_element_text(PG_FUNCTION_ARGS)
 Datum
 jsonb_array_element_text(PG_FUNCTION_ARGS)
 {
-	Jsonb	   *jb = PG_GETARG_JSONB_P(0);
+	Jsonb	   *jb = jsonb_detoast_cached(fcinfo, 0);
 	int			element = PG_GETARG_INT32(1);
 	JsonbValue *v;
 
@@ -1436,7 +1536,7 @@ jsonb_extract_path_text(PG_FUNCTION_ARGS)
 static Datum
 get_jsonb_path_all(FunctionCallInfo fcinfo, bool as_text)
 {
-	Jsonb	   *jb = PG_GETARG_JSONB_P(0);
+	Jsonb	   *jb = jsonb_detoast_cached(fcinfo, 0);
 	ArrayType  *path = PG_GETARG_ARRAYTYPE_P(1);
 	Datum	   *pathtext;
 	bool	   *pathnulls;
@@ -1461,8 +1561,12 @@ get_jsonb_path_all(FunctionCallInfo fcinfo, bool as_text)
 
 	if (isnull)
 		PG_RETURN_NULL();
-	else
-		PG_RETURN_DATUM(res);
+
+	/* with an empty path, we get back the cached document itself */
+	if (DatumGetPointer(res) == (Pointer) jb)
+		res = PointerGetDatum(PG_DETOAST_DATUM_COPY(res));
+
+	PG_RETURN_DATUM(res);
 }
 
 Datum
@@ -15,6 +15,9 @@
  * MatchText - to name of function wanted
  * do_like_escape - name of function if wanted - needs CHAREQ and CopyAdvChar
  * MATCH_LOWER - define for case (4) to specify case folding for 1-byte chars
+ * BYTE_SEARCH - define if a byte of the text that equals the first byte of a
+ *		character is always the start of a character, so that we can use
+ *		memchr() to look for the next candidate match
  *
  * Copyright (c) 1996-2021, PostgreSQL Global Development Group
  *
@@ -171,6 +174,24 @@ MatchText(const char *t, int tlen, const char *p, int plen,
 			else
 				firstpat = GETCHAR(*p);
 
+#ifdef BYTE_SEARCH
+			while (tlen > 0)
+			{
+				const char *next = memchr(t, firstpat, tlen);
+				int			matched;
+
+				if (next == NULL)
+					break;
+				tlen -= next - t;
+				t = next;
+
+				matched = MatchText(t, tlen, p, plen, locale, locale_is_c);
+				if (matched != LIKE_FALSE)
+					return matched; /* TRUE or ABORT */
+
+				NextByte(t, tlen);
+			}
+#else
 			while (tlen > 0)
 			{
 				if (GETCHAR(*t) == firstpat)
@@ -184,6 +205,7 @@ MatchText(const char *t, int tlen, const char *p, int plen,
 
 				NextChar(t, tlen);
 			}
+#endif
 
 			/*
 			 * End of text with no match, so no point in trying later places
@@ -354,6 +376,10 @@ do_like_escape(text *pat, text *esc)
 
 #undef GETCHAR
 
+#ifdef BYTE_SEARCH
+#undef BYTE_SEARCH
+#endif
+
 #ifdef MATCH_LOWER
 #undef MATCH_LOWER
 
@@ -18,9 +18,17 @@
 #include "funcapi.h"
 #include "miscadmin.h"
 #include "mb/pg_wchar.h"
+#include "pgstat.h"
+#include "storage/condition_variable.h"
+#include "storage/dsm.h"
+#include "storage/ipc.h"
 #include "storage/proc.h"
 #include "storage/procarray.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
 #include "utils/builtins.h"
+#include "utils/memutils.h"
+#include "utils/timestamp.h"
 
 /* ----------
  * The max bytes for showing identifiers of MemoryContext.
@@ -28,6 +36,99 @@
  */
 #define MEMORY_CONTEXT_IDENT_DISPLAY_SIZE	1024
 
+/* ----------
+ * How long to wait for another process to report its memory contexts,
+ * in milliseconds.
+ * ----------
+ */
+#define MEMORY_CONTEXT_DUMP_TIMEOUT_MS	10000
+
+/*
+ * Every backend has one of these, indexed by pgprocno, through which another
+ * backend can ask for its memory contexts.  The requestor claims the slot by
+ * setting requestor_pid and signals the target.  The target writes its
+ * contexts into a new DSM segment, pins it, publishes the handle, sets done
+ * and broadcasts cv.  Whoever clears requestor_pid afterwards must unpin the
+ * segment.
+ */
+typedef struct MemoryContextDumpSlot
+{
+	slock_t		mutex;			/* protects the fields below */
+	int			requestor_pid;	/* 0 if no request is pending */
+	bool		done;			/* has the target responded? */
+	dsm_handle	handle;			/* result, or DSM_HANDLE_INVALID on failure */
+	ConditionVariable cv;		/* broadcast when done is set */
+} MemoryContextDumpSlot;
+
+/*
+ * The DSM segment holds a header, the entries in depth-first order, and
+ * then the NUL-terminated strings the entries refer to.
+ */
+typedef struct MemoryContextDumpEntry
+{
+	int			name_off;		/* offsets into string area, or -1 if NULL */
+	int			ident_off;
+	int			parent_off;
+	int			level;
+	MemoryContextCounters stat;
+} MemoryContextDumpEntry;
+
+typedef struct MemoryContextDumpHeader
+{
+	int			nentries;
+	Size		strings_size;
+	MemoryContextDumpEntry entries[FLEXIBLE_ARRAY_MEMBER];
+} MemoryContextDumpHeader;
+
+/* Working state while filling in a MemoryContextDumpHeader */
+typedef struct MemoryContextDumpState
+{
+	MemoryContextDumpHeader *header;
+	int			max_entries;
+	char	   *strings;
+	Size		strings_used;
+} MemoryContextDumpState;
+
+static MemoryContextDumpSlot *MemoryContextDumpSlots = NULL;
+
+/*
+ * GetMemoryContextLabels
+ *		Determine the name and identifier to show for a context.
+ *
+ * *identlen is set to the number of bytes of the identifier to show.
+ */
+static void
+GetMemoryContextLabels(MemoryContext context, const char **name,
+					   const char **ident, int *identlen)
+{
+	*name = context->name;
+	*ident = context->ident;
+	*identlen = 0;
+
+	/*
+	 * To be consistent with logging output, we label dynahash contexts
+	 * with just the hash table name as with MemoryContextStatsPrint().
+	 */
+	if (*ident && strcmp(*name, "dynahash") == 0)
+	{
+		*name = *ident;
+		*ident = NULL;
+	}
+
+	if (*ident)
+	{
+		*identlen = strlen(*ident);
+
+		/*
+		 * Some identifiers such as SQL query string can be very long,
+		 * truncate oversize identifiers.
+		 */
+		if (*identlen >= MEMORY_CONTEXT_IDENT_DISPLAY_SIZE)
+			*identlen = pg_mbcliplen(*ident, *identlen,
+									 MEMORY_CONTEXT_IDENT_DISPLAY_SIZE - 1);
+	}
+}
+
 /*
  * PutMemoryContextsStatsTupleStore
  *		One recursion level for pg_get_backend_memory_contexts.
@@ -45,21 +146,11 @@ PutMemoryContextsStatsTupleStore(Tuplestorestate *tupstore,
 	MemoryContext child;
 	const char *name;
 	const char *ident;
+	int			idlen;
 
 	AssertArg(MemoryContextIsValid(context));
 
-	name = context->name;
-	ident = context->ident;
-
-	/*
-	 * To be consistent with logging output, we label dynahash contexts
-	 * with just the hash table name as with MemoryContextStatsPrint().
-	 */
-	if (ident && strcmp(name, "dynahash") == 0)
-	{
-		name = ident;
-		ident = NULL;
-	}
+	GetMemoryContextLabels(context, &name, &ident, &idlen);
 
 	/* Examine the context itself */
 	memset(&stat, 0, sizeof(stat));
@@ -75,16 +166,8 @@ PutMemoryContextsStatsTupleStore(Tuplestorestate *tupstore,
 
 	if (ident)
 	{
-		int		idlen = strlen(ident);
 		char		clipped_ident[MEMORY_CONTEXT_IDENT_DISPLAY_SIZE];
 
-		/*
-		 * Some identifiers such as SQL query string can be very long,
-		 * truncate oversize identifiers.
-		 */
-		if (idlen >= MEMORY_CONTEXT_IDENT_DISPLAY_SIZE)
-			idlen = pg_mbcliplen(ident, idlen, MEMORY_CONTEXT_IDENT_DISPLAY_SIZE - 1);
-
 		memcpy(clipped_ident, ident, idlen);
 		clipped_ident[idlen] = '\0';
 		values[1] = CStringGetTextDatum(clipped_ident);
@@ -213,3 +296,449 @@ pg_log_backend_memory_contexts(PG_FUNCTION_ARGS)
 
 	PG_RETURN_BOOL(true);
 }
+
+/*
+ * MemoryContextDumpShmemSize
+ *		Compute space needed for the memory context dump slots.
+ */
+Size
+MemoryContextDumpShmemSize(void)
+{
+	return mul_size(MaxBackends, sizeof(MemoryContextDumpSlot));
+}
+
+/*
+ * MemoryContextDumpShmemInit
+ *		Allocate and initialize the memory context dump slots.
+ */
+void
+MemoryContextDumpShmemInit(void)
+{
+	bool		found;
+
+	MemoryContextDumpSlots = (MemoryContextDumpSlot *)
+		ShmemInitStruct("Memory Context Dump Slots",
+						MemoryContextDumpShmemSize(),
+						&found);
+
+	if (!found)
+	{
+		int			i;
+
+		for (i = 0; i < MaxBackends; i++)
+		{
+			MemoryContextDumpSlot *slot = &MemoryContextDumpSlots[i];
+
+			SpinLockInit(&slot->mutex);
+			slot->requestor_pid = 0;
+			slot->done = false;
+			slot->handle = DSM_HANDLE_INVALID;
+			ConditionVariableInit(&slot->cv);
+		}
+	}
+}
+
+/*
+ * DumpMemoryContextsSize
+ *		Count the contexts and string space DumpMemoryContextsFill will need.
+ */
+static void
+DumpMemoryContextsSize(MemoryContext context, int *nentries,
+					   Size *strings_size)
+{
+	MemoryContext child;
+	const char *name;
+	const char *ident;
+	int			identlen;
+
+	GetMemoryContextLabels(context, &name, &ident, &identlen);
+
+	(*nentries)++;
+	if (name)
+		*strings_size += strlen(name) + 1;
+	if (ident)
+		*strings_size += identlen + 1;
+
+	for (child = context->firstchild; child != NULL; child = child->nextchild)
+		DumpMemoryContextsSize(child, nentries, strings_size);
+}
+
+/*
+ * DumpMemoryContextString
+ *		Copy len bytes of str into the string area and return its offset,
+ *		or -1 if str is NULL or there is no room left.
+ */
+static int
+DumpMemoryContextString(MemoryContextDumpState *state, const char *str,
+						int len)
+{
+	int			off;
+
+	if (str == NULL ||
+		state->strings_used + len + 1 > state->header->strings_size)
+		return -1;
+
+	off = (int) state->strings_used;
+	memcpy(state->strings + off, str, len);
+	state->strings[off + len] = '\0';
+	state->strings_used += len + 1;
+
+	return off;
+}
+
+/*
+ * DumpMemoryContextsFill
+ *		One recursion level for filling in a memory context dump.
+ *
+ * The tree can't really have grown since DumpMemoryContextsSize looked at
+ * it, but stop quietly if it has rather than overrunning the segment.
+ */
+static void
+DumpMemoryContextsFill(MemoryContextDumpState *state, MemoryContext context,
+					   int parent_off, int level)
+{
+	MemoryContextDumpEntry *entry;
+	MemoryContext child;
+	const char *name;
+	const char *ident;
+	int			identlen;
+
+	if (state->header->nentries >= state->max_entries)
+		return;
+
+	GetMemoryContextLabels(context, &name, &ident, &identlen);
+
+	entry = &state->header->entries[state->header->nentries++];
+	entry->name_off = DumpMemoryContextString(state, name,
+											  name ? strlen(name) : 0);
+	entry->ident_off = DumpMemoryContextString(state, ident, identlen);
+	entry->parent_off = parent_off;
+	entry->level = level;
+
+	memset(&entry->stat, 0, sizeof(entry->stat));
+	(*context->methods->stats) (context, NULL, NULL, &entry->stat, true);
+
+	for (child = context->firstchild; child != NULL; child = child->nextchild)
+		DumpMemoryContextsFill(state, child, entry->name_off, level + 1);
+}
+
+/*
+ * HandleDumpMemoryContextInterrupt
+ *		Handle receipt of an interrupt asking us to report our memory
+ *		contexts to another backend.
+ *
+ * All the actual work is deferred to ProcessDumpMemoryContextInterrupt().
+ */
+void
+HandleDumpMemoryContextInterrupt(void)
+{
+	InterruptPending = true;
+	DumpMemoryContextPending = true;
+	/* latch will be set by procsignal_sigusr1_handler */
+}
+
+/*
+ * ProcessDumpMemoryContextInterrupt
+ *		Write this backend's memory contexts into a DSM segment for the
+ *		backend that asked for them.
+ *
+ * Like ProcessLogMemoryContextInterrupt(), this is called from
+ * CHECK_FOR_INTERRUPTS() when DumpMemoryContextPending is set.
+ */
+void
+ProcessDumpMemoryContextInterrupt(void)
+{
+	MemoryContextDumpSlot *slot;
+	int			nentries = 0;
+	Size		strings_size = 0;
+	Size		size;
+	dsm_segment *seg;
+	dsm_handle	handle = DSM_HANDLE_INVALID;
+	bool		wanted;
+
+	DumpMemoryContextPending = false;
+
+	if (MyProc == NULL || MyProc->pgprocno >= MaxBackends)
+		return;
+	slot = &MemoryContextDumpSlots[MyProc->pgprocno];
+
+	/* Ignore the signal if the request has been withdrawn or answered */
+	SpinLockAcquire(&slot->mutex);
+	wanted = (slot->requestor_pid != 0 && !slot->done);
+	SpinLockRelease(&slot->mutex);
+	if (!wanted)
+		return;
+
+	DumpMemoryContextsSize(TopMemoryContext, &nentries, &strings_size);
+	size = add_size(offsetof(MemoryContextDumpHeader, entries),
+					mul_size(nentries, sizeof(MemoryContextDumpEntry)));
+	size = add_size(size, strings_size);
+
+	/*
+	 * If we're out of DSM slots, report the failure rather than erroring out
+	 * of whatever this backend happens to be doing.
+	 */
+	seg = dsm_create(size, DSM_CREATE_NULL_IF_MAXSEGMENTS);
+	if (seg != NULL)
+	{
+		MemoryContextDumpState state;
+
+		state.header = (MemoryContextDumpHeader *) dsm_segment_address(seg);
+		state.header->nentries = 0;
+		state.header->strings_size = strings_size;
+		state.max_entries = nentries;
+		state.strings = (char *) &state.header->entries[nentries];
+		state.strings_used = 0;
+
+		DumpMemoryContextsFill(&state, TopMemoryContext, -1, 0);
+
+		/* Keep the segment around after we detach; the requestor unpins it */
+		dsm_pin_segment(seg);
+		handle = dsm_segment_handle(seg);
+	}
+
+	SpinLockAcquire(&slot->mutex);
+	wanted = (slot->requestor_pid != 0 && !slot->done);
+	if (wanted)
+	{
+		slot->done = true;
+		slot->handle = handle;
+	}
+	SpinLockRelease(&slot->mutex);
+
+	if (seg != NULL)
+	{
+		/* If nobody is waiting for the result any more, throw it away */
+		if (!wanted)
+			dsm_unpin_segment(handle);
+		dsm_detach(seg);
+	}
+
+	if (wanted)
+		ConditionVariableBroadcast(&slot->cv);
+}
+
+/*
+ * Withdraw our request from a memory context dump slot, and release the
+ * result segment, if any.  Used both normally and as an error cleanup
+ * callback.
+ */
+static void
+memory_context_dump_cleanup(int code, Datum arg)
+{
+	MemoryContextDumpSlot *slot = (MemoryContextDumpSlot *) DatumGetPointer(arg);
+	dsm_handle	handle = DSM_HANDLE_INVALID;
+
+	SpinLockAcquire(&slot->mutex);
+	if (slot->requestor_pid == MyProcPid)
+	{
+		if (slot->done)
+			handle = slot->handle;
+		slot->requestor_pid = 0;
+		slot->done = false;
+		slot->handle = DSM_HANDLE_INVALID;
+	}
+	SpinLockRelease(&slot->mutex);
+
+	if (handle != DSM_HANDLE_INVALID)
+		dsm_unpin_segment(handle);
+}
+
+/*
+ * Wait for the target of a memory context dump request to respond.
+ * Returns the handle of the result segment, or DSM_HANDLE_INVALID after
+ * emitting a warning.
+ */
+static dsm_handle
+wait_for_memory_context_dump(MemoryContextDumpSlot *slot, int pid)
+{
+	TimestampTz start = GetCurrentTimestamp();
+	dsm_handle	handle = DSM_HANDLE_INVALID;
+
+	ConditionVariablePrepareToSleep(&slot->cv);
+	for (;;)
+	{
+		bool		done;
+
+		SpinLockAcquire(&slot->mutex);
+		done = slot->done;
+		handle = slot->handle;
+		SpinLockRelease(&slot->mutex);
+
+		if (done)
+		{
+			if (handle == DSM_HANDLE_INVALID)
+				ereport(WARNING,
+						(errmsg("process %d could not report its memory contexts",
+								pid)));
+			break;
+		}
+
+		if (BackendPidGetProc(pid) == NULL)
+		{
+			ereport(WARNING,
+					(errmsg("process %d exited before reporting its memory contexts",
+							pid)));
+			break;
+		}
+
+		if (TimestampDifferenceExceeds(start, GetCurrentTimestamp(),
+									   MEMORY_CONTEXT_DUMP_TIMEOUT_MS))
+		{
+			ereport(WARNING,
+					(errmsg("timed out waiting for process %d to report its memory contexts",
+							pid)));
+			break;
+		}
+
+		(void) ConditionVariableTimedSleep(&slot->cv, 1000L,
+										   WAIT_EVENT_MEMORY_CONTEXT_DUMP);
+	}
+	ConditionVariableCancelSleep();
+
+	return handle;
+}
+
+/*
+ * pg_get_process_memory_contexts
+ *		SQL SRF showing the memory contexts of the specified backend.
+ *
+ * The target backend is signaled and builds the result the next time it
+ * runs CHECK_FOR_INTERRUPTS(), so a backend that is stuck somewhere
+ * without checking for interrupts can't answer.  We give up after
+ * MEMORY_CONTEXT_DUMP_TIMEOUT_MS and return an empty set, with a warning,
+ * as we do if the process doesn't exist.
+ */
+Datum
+pg_get_process_memory_contexts(PG_FUNCTION_ARGS)
+{
+	int			pid = PG_GETARG_INT32(0);
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	PGPROC	   *proc;
+	MemoryContextDumpSlot *slot;
+	bool		busy;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	/* See pg_log_backend_memory_contexts() about races here */
+	proc = BackendPidGetProc(pid);
+	if (proc == NULL)
+	{
+		ereport(WARNING,
+				(errmsg("PID %d is not a PostgreSQL server process", pid)));
+		return (Datum) 0;
+	}
+	Assert(proc->pgprocno < MaxBackends);
+	slot = &MemoryContextDumpSlots[proc->pgprocno];
+
+	SpinLockAcquire(&slot->mutex);
+	busy = (slot->requestor_pid != 0);
+	if (!busy)
+	{
+		slot->requestor_pid = MyProcPid;
+		slot->done = false;
+		slot->handle = DSM_HANDLE_INVALID;
+	}
+	SpinLockRelease(&slot->mutex);
+
+	if (busy)
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_IN_USE),
+				 errmsg("memory contexts of process %d are already being requested by another process",
+						pid)));
+
+	PG_ENSURE_ERROR_CLEANUP(memory_context_dump_cleanup,
+							PointerGetDatum(slot));
+	{
+		dsm_handle	handle = DSM_HANDLE_INVALID;
+
+		if (SendProcSignal(pid, PROCSIG_DUMP_MEMORY_CONTEXT,
+						   proc->backendId) < 0)
+			ereport(WARNING,
+					(errmsg("could not send signal to process %d: %m", pid)));
+		else
+			handle = wait_for_memory_context_dump(slot, pid);
+
+		if (handle != DSM_HANDLE_INVALID)
+		{
+			dsm_segment *seg = dsm_attach(handle);
+			MemoryContextDumpHeader *header;
+			char	   *strings;
+			int			i;
+
+			if (seg == NULL)
+				elog(ERROR, "could not attach to memory context dump segment");
+
+			header = (MemoryContextDumpHeader *) dsm_segment_address(seg);
+			strings = (char *) &header->entries[header->nentries];
+
+			for (i = 0; i < header->nentries; i++)
+			{
+				MemoryContextDumpEntry *entry = &header->entries[i];
+				Datum		values[PG_GET_BACKEND_MEMORY_CONTEXTS_COLS];
+				bool		nulls[PG_GET_BACKEND_MEMORY_CONTEXTS_COLS];
+
+				memset(values, 0, sizeof(values));
+				memset(nulls, 0, sizeof(nulls));
+
+				if (entry->name_off >= 0)
+					values[0] = CStringGetTextDatum(strings + entry->name_off);
+				else
+					nulls[0] = true;
+				if (entry->ident_off >= 0)
+					values[1] = CStringGetTextDatum(strings + entry->ident_off);
+				else
+					nulls[1] = true;
+				if (entry->parent_off >= 0)
+					values[2] = CStringGetTextDatum(strings + entry->parent_off);
+				else
+					nulls[2] = true;
+
+				values[3] = Int32GetDatum(entry->level);
+				values[4] = Int64GetDatum(entry->stat.totalspace);
+				values[5] = Int64GetDatum(entry->stat.nblocks);
+				values[6] = Int64GetDatum(entry->stat.freespace);
+				values[7] = Int64GetDatum(entry->stat.freechunks);
+				values[8] = Int64GetDatum(entry->stat.totalspace -
+										  entry->stat.freespace);
+				tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+			}
+
+			dsm_detach(seg);
+		}
+	}
+	PG_END_ENSURE_ERROR_CLEANUP(memory_context_dump_cleanup,
+								PointerGetDatum(slot));
+	memory_context_dump_cleanup(0, PointerGetDatum(slot));
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
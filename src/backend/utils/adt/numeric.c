@@ -78,6 +78,7 @@
 #define HALF_NBASE	5
 #define DEC_DIGITS	1			/* decimal digits per NBASE digit */
 #define MUL_GUARD_DIGITS	4	/* these are measured in NBASE digits */
+#define MUL_SHORT_DIGITS	12
 #define DIV_GUARD_DIGITS	8
 
 typedef signed char NumericDigit;
@@ -88,6 +89,7 @@ typedef signed char NumericDigit;
 #define HALF_NBASE	50
 #define DEC_DIGITS	2			/* decimal digits per NBASE digit */
 #define MUL_GUARD_DIGITS	3	/* these are measured in NBASE digits */
+#define MUL_SHORT_DIGITS	6
 #define DIV_GUARD_DIGITS	6
 
 typedef signed char NumericDigit;
@@ -98,6 +100,7 @@ typedef signed char NumericDigit;
 #define HALF_NBASE	5000
 #define DEC_DIGITS	4			/* decimal digits per NBASE digit */
 #define MUL_GUARD_DIGITS	2	/* these are measured in NBASE digits */
+#define MUL_SHORT_DIGITS	3
 #define DIV_GUARD_DIGITS	4
 
 typedef int16 NumericDigit;
@@ -529,6 +532,9 @@ static bool numericvar_to_uint64(const NumericVar *var, uint64 *result);
 #ifdef HAVE_INT128
 static bool numericvar_to_int128(const NumericVar *var, int128 *result);
 static void int128_to_numericvar(int128 val, NumericVar *var);
+static bool numericvar_to_scaled_int64(const NumericVar *var, int64 *result);
+static void scaled_int128_to_numericvar(int128 val, int scale,
+										NumericVar *var);
 #endif
 static double numericvar_to_double_no_overflow(const NumericVar *var);
 
@@ -4525,6 +4531,11 @@ numeric_pg_lsn(PG_FUNCTION_ARGS)
  *
  * On platforms which support 128-bit integers some aggregates instead use a
  * 128-bit integer based transition datatype to speed up calculations.
+ * There, SUM() and AVG() of numeric inputs also keep the sum of inputs that
+ * fit in a 64-bit integer once scaled by 10^dscale in 'isumX', as long as
+ * they all have the same dscale (typically, they come from a column with a
+ * typmod); other inputs go to 'sumX' as usual.  'isumX' is folded into
+ * 'sumX' by numeric_agg_flush() before the sum is needed.
  *
  * ----------------------------------------------------------------------
  */
@@ -4542,6 +4553,11 @@ typedef struct NumericAggState
 	int64		NaNcount;		/* count of NaN values */
 	int64		pInfcount;		/* count of +Inf values */
 	int64		nInfcount;		/* count of -Inf values */
+#ifdef HAVE_INT128
+	bool		have_isumX;		/* is isumX in use? */
+	int			iscale;			/* dscale of the inputs summed in isumX */
+	int128		isumX;			/* sum of inputs times 10^iscale */
+#endif
 } NumericAggState;
 
 #define NA_TOTAL_COUNT(na) \
@@ -4588,6 +4604,33 @@ makeNumericAggStateCurrentContext(bool calcSumX2)
 	return state;
 }
 
+/*
+ * Fold the inputs accumulated in isumX into sumX.
+ */
+static void
+numeric_agg_flush(NumericAggState *state)
+{
+#ifdef HAVE_INT128
+	NumericVar	X;
+	MemoryContext old_context;
+
+	if (!state->have_isumX)
+		return;
+
+	init_var(&X);
+	scaled_int128_to_numericvar(state->isumX, state->iscale, &X);
+
+	old_context = MemoryContextSwitchTo(state->agg_context);
+	accum_sum_add(&(state->sumX), &X);
+	MemoryContextSwitchTo(old_context);
+
+	free_var(&X);
+
+	state->have_isumX = false;
+	state->isumX = 0;
+#endif
+}
+
 /*
  * Accumulate a new input value for numeric aggregate functions.
  */
@@ -4625,6 +4668,24 @@ do_numeric_accum(NumericAggState *state, Numeric newval)
 	else if (X.dscale == state->maxScale)
 		state->maxScaleCount++;
 
+#ifdef HAVE_INT128
+	/* add it to isumX if we can, see NumericAggState */
+	if (!state->calcSumX2 &&
+		(!state->have_isumX || X.dscale == state->iscale))
+	{
+		int64		val;
+
+		if (numericvar_to_scaled_int64(&X, &val))
+		{
+			state->N++;
+			state->isumX += val;
+			state->iscale = X.dscale;
+			state->have_isumX = true;
+			return;
+		}
+	}
+#endif
+
 	/* if we need X^2, calculate that in short-lived context */
 	if (state->calcSumX2)
 	{
@@ -4713,6 +4774,21 @@ do_numeric_discard(NumericAggState *state, Numeric newval)
 		}
 	}
 
+#ifdef HAVE_INT128
+	/* subtract it from isumX if we can, see do_numeric_accum */
+	if (state->N > 1 && state->have_isumX && X.dscale == state->iscale)
+	{
+		int64		val;
+
+		if (numericvar_to_scaled_int64(&X, &val))
+		{
+			state->N--;
+			state->isumX -= val;
+			return true;
+		}
+	}
+#endif
+
 	/* if we need X^2, calculate that in short-lived context */
 	if (state->calcSumX2)
 	{
@@ -4744,6 +4820,10 @@ do_numeric_discard(NumericAggState *state, Numeric newval)
 		accum_sum_reset(&state->sumX);
 		if (state->calcSumX2)
 			accum_sum_reset(&state->sumX2);
+#ifdef HAVE_INT128
+		state->have_isumX = false;
+		state->isumX = 0;
+#endif
 	}
 
 	MemoryContextSwitchTo(old_context);
@@ -4883,6 +4963,8 @@ numeric_avg_combine(PG_FUNCTION_ARGS)
 	if (state2 == NULL)
 		PG_RETURN_POINTER(state1);
 
+	numeric_agg_flush(state2);
+
 	/* manually copy all fields from state2 to state1 */
 	if (state1 == NULL)
 	{
@@ -4926,6 +5008,7 @@ numeric_avg_combine(PG_FUNCTION_ARGS)
 		old_context = MemoryContextSwitchTo(agg_context);
 
 		/* Accumulate sums */
+		numeric_agg_flush(state1);
 		accum_sum_combine(&state1->sumX, &state2->sumX);
 
 		MemoryContextSwitchTo(old_context);
@@ -4960,6 +5043,8 @@ numeric_avg_serialize(PG_FUNCTION_ARGS)
 	 * splitting the tasks in numeric_send into separate functions to stop
 	 * this? Doing so would also remove the fmgr call overhead.
 	 */
+	numeric_agg_flush(state);
+
 	init_var(&tmp_var);
 	accum_sum_final(&state->sumX, &tmp_var);
 
@@ -5963,6 +6048,8 @@ numeric_avg(PG_FUNCTION_ARGS)
 
 	N_datum = NumericGetDatum(int64_to_numeric(state->N));
 
+	numeric_agg_flush(state);
+
 	init_var(&sumX_var);
 	accum_sum_final(&state->sumX, &sumX_var);
 	sumX_datum = NumericGetDatum(make_result(&sumX_var));
@@ -5995,6 +6082,8 @@ numeric_sum(PG_FUNCTION_ARGS)
 	if (state->nInfcount > 0)
 		PG_RETURN_NUMERIC(make_result(&const_ninf));
 
+	numeric_agg_flush(state);
+
 	init_var(&sumX_var);
 	accum_sum_final(&state->sumX, &sumX_var);
 	result = make_result(&sumX_var);
@@ -7854,6 +7943,114 @@ int128_to_numericvar(int128 val, NumericVar *var)
 	var->ndigits = ndigits;
 	var->weight = ndigits - 1;
 }
+
+/*
+ * Convert numeric to int8, scaled by 10^dscale, so that no digits are lost.
+ *
+ * If the result doesn't fit, return false (no error is raised).  Return true
+ * if okay.
+ */
+static bool
+numericvar_to_scaled_int64(const NumericVar *var, int64 *result)
+{
+	int			fdigits = (var->dscale + DEC_DIGITS - 1) / DEC_DIGITS;
+	int			last = var->weight + fdigits;
+	int64		val = 0;
+	int			i;
+
+	if (var->ndigits == 0)
+	{
+		*result = 0;
+		return true;
+	}
+
+	/* int64 has room for less than 5 NBASE digits */
+	if (last >= 5 || var->ndigits > last + 1)
+		return false;
+
+	for (i = 0; i <= last; i++)
+	{
+		if (unlikely(pg_mul_s64_overflow(val, NBASE, &val)))
+			return false;
+		if (i < var->ndigits &&
+			unlikely(pg_add_s64_overflow(val, var->digits[i], &val)))
+			return false;
+	}
+
+	/* drop the digits of the last NBASE digit that are beyond dscale */
+	for (i = fdigits * DEC_DIGITS - var->dscale; i > 0; i--)
+	{
+		if (val % 10 != 0)
+			return false;
+		val /= 10;
+	}
+
+	*result = (var->sign == NUMERIC_NEG) ? -val : val;
+	return true;
+}
+
+/*
+ * Convert 128 bit integer, scaled by 10^scale, to numeric with that dscale.
+ */
+static void
+scaled_int128_to_numericvar(int128 val, int scale, NumericVar *var)
+{
+	int			partial = scale % DEC_DIGITS;
+	uint128		uval,
+				newuval;
+	NumericDigit *ptr;
+	int			ndigits;
+
+	/* int128 can require at most 39 decimal digits, plus the padding */
+	alloc_var(var, 44 / DEC_DIGITS);
+	if (val < 0)
+	{
+		var->sign = NUMERIC_NEG;
+		uval = -val;
+	}
+	else
+	{
+		var->sign = NUMERIC_POS;
+		uval = val;
+	}
+	var->dscale = scale;
+	if (val == 0)
+	{
+		var->ndigits = 0;
+		var->weight = 0;
+		return;
+	}
+	ptr = var->digits + var->ndigits;
+	ndigits = 0;
+
+	/* the last NBASE digit holds only 'partial' decimal digits of val */
+	if (partial != 0)
+	{
+		int			pow10 = 1;
+		int			i;
+
+		for (i = partial; i < DEC_DIGITS; i++)
+			pow10 *= 10;
+
+		ptr--;
+		ndigits++;
+		newuval = uval / (NBASE / pow10);
+		*ptr = (uval - newuval * (NBASE / pow10)) * pow10;
+		uval = newuval;
+	}
+	while (uval)
+	{
+		ptr--;
+		ndigits++;
+		newuval = uval / NBASE;
+		*ptr = uval - newuval * NBASE;
+		uval = newuval;
+	}
+	var->digits = ptr;
+	var->ndigits = ndigits;
+	var->weight = ndigits - 1 - (scale + DEC_DIGITS - 1) / DEC_DIGITS;
+	strip_var(var);
+}
 #endif
 
 /*
@@ -8244,6 +8441,57 @@ mul_var(const NumericVar *var1, const NumericVar *var2, NumericVar *result,
 		res_sign = NUMERIC_NEG;
 	res_weight = var1->weight + var2->weight + 2;
 
+	/*
+	 * If var1 has no more than MUL_SHORT_DIGITS digits, its value fits in a
+	 * uint64 with enough headroom to multiply it by one NBASE digit and add
+	 * a carry.  Then we can compute the exact product in a single pass over
+	 * var2, propagating carries as we go, which is a lot cheaper than the
+	 * general algorithm below for the common case of multiplying by a small
+	 * number, such as a price by a quantity.  The result is built in a new
+	 * buffer, since result may be the same variable as var1 or var2.
+	 */
+	if (var1ndigits <= MUL_SHORT_DIGITS)
+	{
+		NumericDigit *res_buf;
+		uint64		var1val = 0;
+		uint64		carry64 = 0;
+
+		for (i1 = 0; i1 < var1ndigits; i1++)
+			var1val = var1val * NBASE + var1digits[i1];
+
+		res_ndigits = var1ndigits + var2ndigits + 1;
+		res_buf = digitbuf_alloc(res_ndigits + 1);
+		res_buf[0] = 0;			/* spare digit for rounding */
+		res_digits = res_buf + 1;
+
+		for (i2 = var2ndigits - 1; i2 >= 0; i2--)
+		{
+			carry64 += var1val * var2digits[i2];
+			res_digits[i2 + var1ndigits + 1] = (NumericDigit) (carry64 % NBASE);
+			carry64 /= NBASE;
+		}
+		for (i = var1ndigits; i >= 0; i--)
+		{
+			res_digits[i] = (NumericDigit) (carry64 % NBASE);
+			carry64 /= NBASE;
+		}
+		Assert(carry64 == 0);
+
+		digitbuf_free(result->buf);
+		result->buf = res_buf;
+		result->digits = res_digits;
+		result->ndigits = res_ndigits;
+		result->weight = res_weight;
+		result->sign = res_sign;
+
+		/* Round to target rscale (and set result->dscale) */
+		round_var(result, rscale);
+
+		/* Strip leading and trailing zeroes */
+		strip_var(result);
+		return;
+	}
+
 	/*
 	 * Determine the number of result digits to compute.  If the exact result
 	 * would have more than rscale fractional digits, truncate the computation
@@ -116,6 +116,12 @@ typedef struct
 
 static HTAB *collation_cache = NULL;
 
+/*
+ * The entry last looked up.  Comparisons ask about the same collation over
+ * and over, and entries are never removed, so this saves a hash lookup.
+ */
+static collation_cache_entry *last_collation_cache_entry = NULL;
+
 
 #if defined(WIN32) && defined(LC_MESSAGES)
 static char *IsoLocaleName(const char *);	/* MSVC specific */
@@ -1262,6 +1268,11 @@ lookup_collation_cache(Oid collation, bool set_flags)
 	Assert(OidIsValid(collation));
 	Assert(collation != DEFAULT_COLLATION_OID);
 
+	if (last_collation_cache_entry != NULL &&
+		last_collation_cache_entry->collid == collation &&
+		(!set_flags || last_collation_cache_entry->flags_valid))
+		return last_collation_cache_entry;
+
 	if (collation_cache == NULL)
 	{
 		/* First time through, initialize the hash table */
@@ -1310,6 +1321,8 @@ lookup_collation_cache(Oid collation, bool set_flags)
 		ReleaseSysCache(tp);
 	}
 
+	last_collation_cache_entry = cache_entry;
+
 	return cache_entry;
 }
 
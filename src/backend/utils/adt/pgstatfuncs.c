@@ -28,6 +28,7 @@
 #include "storage/proc.h"
 #include "storage/procarray.h"
 #include "utils/acl.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/inet.h"
 #include "utils/timestamp.h"
@@ -497,6 +498,8 @@ pg_stat_get_progress_info(PG_FUNCTION_ARGS)
 		cmdtype = PROGRESS_COMMAND_BASEBACKUP;
 	else if (pg_strcasecmp(cmd, "COPY") == 0)
 		cmdtype = PROGRESS_COMMAND_COPY;
+	else if (pg_strcasecmp(cmd, "QUERY") == 0)
+		cmdtype = PROGRESS_COMMAND_QUERY;
 	else
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -570,7 +573,7 @@ pg_stat_get_progress_info(PG_FUNCTION_ARGS)
 Datum
 pg_stat_get_activity(PG_FUNCTION_ARGS)
 {
-#define PG_STAT_GET_ACTIVITY_COLS	30
+#define PG_STAT_GET_ACTIVITY_COLS	31
 	int			num_backends = pgstat_fetch_stat_numbackends();
 	int			curr_backend;
 	int			pid = PG_ARGISNULL(0) ? -1 : PG_GETARG_INT32(0);
@@ -919,6 +922,7 @@ pg_stat_get_activity(PG_FUNCTION_ARGS)
 				nulls[29] = true;
 			else
 				values[29] = UInt64GetDatum(beentry->st_query_id);
+			values[30] = Int64GetDatum(beentry->st_allocated_bytes);
 		}
 		else
 		{
@@ -947,6 +951,7 @@ pg_stat_get_activity(PG_FUNCTION_ARGS)
 			nulls[27] = true;
 			nulls[28] = true;
 			nulls[29] = true;
+			nulls[30] = true;
 		}
 
 		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
@@ -1942,6 +1947,187 @@ pg_stat_get_slru(PG_FUNCTION_ARGS)
 	return (Datum) 0;
 }
 
+/*
+ * Returns I/O statistics, one row per backend type, I/O object and I/O
+ * context.
+ */
+Datum
+pg_stat_get_io(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_IO_COLS	10
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			bktype;
+	PgStat_IOStats *stats;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	/* request I/O stats from the stat collector */
+	stats = pgstat_fetch_stat_io();
+
+	for (bktype = 0; bktype < BACKEND_NUM_TYPES; bktype++)
+	{
+		int			io_object;
+
+		if (bktype == B_INVALID)
+			continue;
+
+		for (io_object = 0; io_object < IOOBJECT_NUM_TYPES; io_object++)
+		{
+			int			io_context;
+
+			for (io_context = 0; io_context < IOCONTEXT_NUM_TYPES; io_context++)
+			{
+				/* for each row */
+				Datum		values[PG_STAT_GET_IO_COLS];
+				bool		nulls[PG_STAT_GET_IO_COLS];
+				PgStat_IOCounters *counters;
+
+				counters = &stats->counters[bktype][io_object][io_context];
+
+				MemSet(values, 0, sizeof(values));
+				MemSet(nulls, 0, sizeof(nulls));
+
+				values[0] = CStringGetTextDatum(GetBackendTypeDesc(bktype));
+				values[1] = CStringGetTextDatum(pgstat_io_object_name(io_object));
+				values[2] = CStringGetTextDatum(pgstat_io_context_name(io_context));
+				values[3] = Int64GetDatum(counters->ops[IOOP_READ]);
+				/* convert microseconds to milliseconds */
+				values[4] = Float8GetDatum(((double) counters->times[IOOP_READ]) / 1000.0);
+				values[5] = Int64GetDatum(counters->ops[IOOP_WRITE]);
+				values[6] = Float8GetDatum(((double) counters->times[IOOP_WRITE]) / 1000.0);
+				values[7] = Int64GetDatum(counters->ops[IOOP_EXTEND]);
+				values[8] = Int64GetDatum(counters->ops[IOOP_FSYNC]);
+				values[9] = TimestampTzGetDatum(stats->stat_reset_timestamp);
+
+				tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+			}
+		}
+	}
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
+
+/*
+ * Returns LWLock wait statistics, one row per tranche.
+ */
+Datum
+pg_stat_get_lwlock(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_LWLOCK_COLS	5
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	int			i;
+	PgStat_LWLockStats *stats;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	/* request LWLock stats from the stat collector */
+	stats = pgstat_fetch_stat_lwlock();
+
+	for (i = 0; i < PGSTAT_NUM_LWLOCK_TRANCHES; i++)
+	{
+		/* for each row */
+		Datum		values[PG_STAT_GET_LWLOCK_COLS];
+		bool		nulls[PG_STAT_GET_LWLOCK_COLS];
+		Datum		buckets[PGSTAT_LWLOCK_HIST_BUCKETS];
+		PgStat_LWLockCounters *counters = &stats->tranches[i];
+		const char *name;
+		int			bucket;
+
+		/*
+		 * The last slot collects all extension tranches.  Don't ask lwlock.c
+		 * for its name, it would return whichever extension happens to have
+		 * registered that tranche ID in this backend.
+		 */
+		if (i == LWTRANCHE_FIRST_USER_DEFINED)
+			name = "extension";
+		else
+			name = GetLWLockIdentifier(PG_WAIT_LWLOCK, i);
+
+		/* skip the numbers in lwlocknames.txt that are no longer used */
+		if (strncmp(name, "<unassigned", 11) == 0)
+			continue;
+
+		MemSet(values, 0, sizeof(values));
+		MemSet(nulls, 0, sizeof(nulls));
+
+		for (bucket = 0; bucket < PGSTAT_LWLOCK_HIST_BUCKETS; bucket++)
+			buckets[bucket] = Int64GetDatum(counters->hist[bucket]);
+
+		values[0] = CStringGetTextDatum(name);
+		values[1] = Int64GetDatum(counters->waits);
+		/* convert microseconds to milliseconds */
+		values[2] = Float8GetDatum(((double) counters->wait_time) / 1000.0);
+		values[3] = PointerGetDatum(construct_array(buckets,
+													PGSTAT_LWLOCK_HIST_BUCKETS,
+													INT8OID, sizeof(int64),
+													FLOAT8PASSBYVAL,
+													TYPALIGN_DOUBLE));
+		values[4] = TimestampTzGetDatum(stats->stat_reset_timestamp);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
+
 Datum
 pg_stat_get_xact_numscans(PG_FUNCTION_ARGS)
 {
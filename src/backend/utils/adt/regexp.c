@@ -31,6 +31,7 @@
 
 #include "catalog/pg_type.h"
 #include "funcapi.h"
+#include "mb/pg_wchar.h"
 #include "miscadmin.h"
 #include "regex/regex.h"
 #include "utils/array.h"
@@ -103,6 +104,7 @@ typedef struct cached_re_str
 	int			cre_pat_len;	/* length of original RE, in bytes */
 	int			cre_flags;		/* compile flags: extended,icase etc */
 	Oid			cre_collation;	/* collation to use */
+	int			cre_literal_len;	/* length of literal prefix of RE */
 	regex_t		cre_re;			/* the compiled regular expression */
 } cached_re_str;
 
@@ -121,6 +123,65 @@ static ArrayType *build_regexp_match_result(regexp_matches_ctx *matchctx);
 static Datum build_regexp_split_result(regexp_matches_ctx *splitctx);
 
 
+/*
+ * RE_literal_prefix_len - length of literal text any match has to contain
+ *
+ * Returns the length of the longest prefix of the pattern that is plain
+ * text, not counting a last character a quantifier applies to, or 0 if the
+ * pattern contains an alternation, or its flags make the text match other
+ * than literally.  We're conservative in what we treat as plain text, since
+ * this is only used to quickly rule out strings.
+ */
+static int
+RE_literal_prefix_len(const char *pat, int pat_len, int cflags)
+{
+	int			len = 0;
+	int			lastlen = 0;
+
+	if (cflags & (REG_ICASE | REG_EXPANDED))
+		return 0;
+	if (cflags & REG_QUOTE)
+		return pat_len;
+	if (memchr(pat, '|', pat_len) != NULL)
+		return 0;
+
+	while (len < pat_len && strchr("\\^$.[](){}*+?", pat[len]) == NULL)
+	{
+		lastlen = len;
+		len += pg_mblen(pat + len);
+	}
+
+	/* a quantifier makes the last character optional or repeatable */
+	if (len < pat_len && strchr("{*+?", pat[len]) != NULL)
+		len = lastlen;
+
+	return Min(len, pat_len);
+}
+
+/*
+ * RE_contains_literal - does the string contain the given literal text?
+ */
+static bool
+RE_contains_literal(const char *dat, int dat_len, const char *lit, int lit_len)
+{
+	const char *last = dat + dat_len - lit_len;
+
+	if (dat_len < lit_len)
+		return false;
+
+	while (dat <= last)
+	{
+		dat = memchr(dat, lit[0], last - dat + 1);
+		if (dat == NULL)
+			return false;
+		if (memcmp(dat + 1, lit + 1, lit_len - 1) == 0)
+			return true;
+		dat++;
+	}
+
+	return false;
+}
+
 /*
  * RE_compile_and_cache - compile a RE, caching if possible
  *
@@ -226,6 +287,8 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	re_temp.cre_pat_len = text_re_len;
 	re_temp.cre_flags = cflags;
 	re_temp.cre_collation = collation;
+	re_temp.cre_literal_len = RE_literal_prefix_len(text_re_val, text_re_len,
+													cflags);
 
 	/*
 	 * Okay, we have a valid new item in re_temp; insert it into the storage
@@ -349,6 +412,17 @@ RE_compile_and_execute(text *text_re, char *dat, int dat_len,
 	/* Compile RE */
 	re = RE_compile_and_cache(text_re, cflags, collation);
 
+	/*
+	 * RE_compile_and_cache leaves the RE at the front of the cache.  If it
+	 * starts with literal text, a string that doesn't contain that text can't
+	 * match, which is much cheaper to find out than by running the RE.
+	 */
+	Assert(re == &re_array[0].cre_re);
+	if (re_array[0].cre_literal_len > 0 &&
+		!RE_contains_literal(dat, dat_len, re_array[0].cre_pat,
+							 re_array[0].cre_literal_len))
+		return false;
+
 	return RE_execute(re, dat, dat_len, nmatch, pmatch);
 }
 
@@ -40,6 +40,7 @@
 #include "parser/parse_coerce.h"
 #include "parser/parse_relation.h"
 #include "storage/bufmgr.h"
+#include "storage/proc.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
 #include "utils/datum.h"
@@ -63,6 +64,8 @@
 #define RI_INIT_CONSTRAINTHASHSIZE		64
 #define RI_INIT_QUERYHASHSIZE			(RI_INIT_CONSTRAINTHASHSIZE * 4)
 
+#define RI_CHECK_CACHE_SIZE				8
+
 #define RI_KEYS_ALL_NULL				0
 #define RI_KEYS_SOME_NULL				1
 #define RI_KEYS_NONE_NULL				2
@@ -120,6 +123,27 @@ typedef struct RI_ConstraintInfo
 	dlist_node	valid_link;		/* Link in list of valid entries */
 } RI_ConstraintInfo;
 
+/*
+ * RI_CheckCacheEntry
+ *
+ * A foreign key that RI_FKey_check() recently found in the PK table, and
+ * locked.  While the row lock is held, and the batch of trigger events
+ * we're firing continues, the key can't disappear without the PK side's
+ * own RI triggers seeing the rows that reference it; so other rows with
+ * the same key in the same batch needn't be checked again.  See
+ * ri_CheckCacheLookup().
+ */
+typedef struct RI_CheckCacheEntry
+{
+	Oid			constraint_id;	/* FK constraint, or InvalidOid if unused */
+	LocalTransactionId lxid;	/* transaction that locked the PK row */
+	SubTransactionId subxid;	/* ... and its subtransaction */
+	CommandId	firing_id;		/* batch of trigger events */
+	Datum		values[RI_MAX_NUMKEYS]; /* FK values; by-ref ones point into
+										 * buf */
+	char	   *buf;			/* palloc'd in ri_check_cache_cxt, or NULL */
+} RI_CheckCacheEntry;
+
 /*
  * RI_QueryKey
  *
@@ -171,6 +195,9 @@ static HTAB *ri_query_cache = NULL;
 static HTAB *ri_compare_cache = NULL;
 static dlist_head ri_constraint_cache_valid_list;
 static int	ri_constraint_cache_valid_count = 0;
+static RI_CheckCacheEntry ri_check_cache[RI_CHECK_CACHE_SIZE];
+static int	ri_check_cache_next = 0;
+static MemoryContext ri_check_cache_cxt = NULL;
 
 
 /*
@@ -196,6 +223,10 @@ static void ri_BuildQueryKey(RI_QueryKey *key,
 							 int32 constr_queryno);
 static bool ri_KeysEqual(Relation rel, TupleTableSlot *oldslot, TupleTableSlot *newslot,
 						 const RI_ConstraintInfo *riinfo, bool rel_is_pk);
+static bool ri_CheckCacheLookup(const RI_ConstraintInfo *riinfo, Relation fk_rel,
+								TupleTableSlot *newslot, CommandId firing_id);
+static void ri_CheckCacheRemember(const RI_ConstraintInfo *riinfo, Relation fk_rel,
+								  TupleTableSlot *newslot, CommandId firing_id);
 static bool ri_AttributesEqual(Oid eq_opr, Oid typeid,
 							   Datum oldvalue, Datum newvalue);
 
@@ -337,6 +368,16 @@ RI_FKey_check(TriggerData *trigdata)
 			break;
 	}
 
+	/*
+	 * If we found and locked the same key for another row in this batch of
+	 * trigger events, there's no need to look it up again.
+	 */
+	if (ri_CheckCacheLookup(riinfo, fk_rel, newslot, trigdata->tg_firing_id))
+	{
+		table_close(pk_rel, RowShareLock);
+		return PointerGetDatum(NULL);
+	}
+
 	if (SPI_connect() != SPI_OK_CONNECT)
 		elog(ERROR, "SPI_connect failed");
 
@@ -406,6 +447,9 @@ RI_FKey_check(TriggerData *trigdata)
 	if (SPI_finish() != SPI_OK_FINISH)
 		elog(ERROR, "SPI_finish failed");
 
+	/* The key exists (else we'd have errored out), remember that */
+	ri_CheckCacheRemember(riinfo, fk_rel, newslot, trigdata->tg_firing_id);
+
 	table_close(pk_rel, RowShareLock);
 
 	return PointerGetDatum(NULL);
@@ -2783,6 +2827,146 @@ ri_KeysEqual(Relation rel, TupleTableSlot *oldslot, TupleTableSlot *newslot,
 	return true;
 }
 
+/*
+ * ri_CheckCacheLookup -
+ *
+ * Check whether RI_FKey_check() already found the FK key of newslot, which
+ * must have no nulls, in the PK table during the current batch of trigger
+ * events.
+ *
+ * Having found the PK row, we hold a FOR KEY SHARE lock on it, so nobody
+ * else can delete it or change its key.  We might do that ourselves in a
+ * trigger fired in between, but then the PK table's RI triggers will see
+ * the rows we're checking (they were all inserted or updated before this
+ * batch of events started firing) and act on them.  That doesn't hold
+ * across batches, as a later statement could delete the referencing rows
+ * first, nor after the subtransaction holding the lock has been left.
+ *
+ * Keys are compared by image, which is conservative.
+ */
+static bool
+ri_CheckCacheLookup(const RI_ConstraintInfo *riinfo, Relation fk_rel,
+					TupleTableSlot *newslot, CommandId firing_id)
+{
+	TupleDesc	tupdesc = RelationGetDescr(fk_rel);
+
+	/* only AFTER triggers have a firing ID */
+	if (firing_id == 0)
+		return false;
+
+	for (int i = 0; i < RI_CHECK_CACHE_SIZE; i++)
+	{
+		RI_CheckCacheEntry *entry = &ri_check_cache[i];
+		bool		match = true;
+
+		if (entry->constraint_id != riinfo->constraint_id ||
+			entry->firing_id != firing_id ||
+			entry->lxid != MyProc->lxid ||
+			entry->subxid != GetCurrentSubTransactionId())
+			continue;
+
+		for (int k = 0; k < riinfo->nkeys; k++)
+		{
+			Form_pg_attribute att = TupleDescAttr(tupdesc,
+												  riinfo->fk_attnums[k] - 1);
+			Datum		value;
+			bool		isnull;
+
+			value = slot_getattr(newslot, riinfo->fk_attnums[k], &isnull);
+			Assert(!isnull);
+
+			if (!datum_image_eq(entry->values[k], value,
+								att->attbyval, att->attlen))
+			{
+				match = false;
+				break;
+			}
+		}
+
+		if (match)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * ri_CheckCacheRemember -
+ *
+ * Remember that RI_FKey_check() found the FK key of newslot in the PK table,
+ * replacing the oldest entry of the cache.
+ */
+static void
+ri_CheckCacheRemember(const RI_ConstraintInfo *riinfo, Relation fk_rel,
+					  TupleTableSlot *newslot, CommandId firing_id)
+{
+	TupleDesc	tupdesc = RelationGetDescr(fk_rel);
+	RI_CheckCacheEntry *entry;
+	Datum		values[RI_MAX_NUMKEYS];
+	Size		len = 0;
+	char	   *ptr;
+
+	if (firing_id == 0)
+		return;
+
+	for (int k = 0; k < riinfo->nkeys; k++)
+	{
+		Form_pg_attribute att = TupleDescAttr(tupdesc,
+											  riinfo->fk_attnums[k] - 1);
+		bool		isnull;
+
+		values[k] = slot_getattr(newslot, riinfo->fk_attnums[k], &isnull);
+		Assert(!isnull);
+
+		if (att->attbyval)
+			continue;
+
+		/* don't bother with toasted keys, they're not worth keeping */
+		if (att->attlen == -1 &&
+			VARATT_IS_EXTERNAL(DatumGetPointer(values[k])))
+			return;
+
+		len += MAXALIGN(datumGetSize(values[k], false, att->attlen));
+	}
+
+	if (ri_check_cache_cxt == NULL)
+		ri_check_cache_cxt = AllocSetContextCreate(TopMemoryContext,
+												   "RI check cache",
+												   ALLOCSET_SMALL_SIZES);
+
+	entry = &ri_check_cache[ri_check_cache_next];
+	ri_check_cache_next = (ri_check_cache_next + 1) % RI_CHECK_CACHE_SIZE;
+
+	if (entry->buf)
+		pfree(entry->buf);
+	entry->buf = NULL;
+	if (len > 0)
+		entry->buf = MemoryContextAlloc(ri_check_cache_cxt, len);
+
+	ptr = entry->buf;
+	for (int k = 0; k < riinfo->nkeys; k++)
+	{
+		Form_pg_attribute att = TupleDescAttr(tupdesc,
+											  riinfo->fk_attnums[k] - 1);
+
+		if (att->attbyval)
+			entry->values[k] = values[k];
+		else
+		{
+			Size		size = datumGetSize(values[k], false, att->attlen);
+
+			memcpy(ptr, DatumGetPointer(values[k]), size);
+			entry->values[k] = PointerGetDatum(ptr);
+			ptr += MAXALIGN(size);
+		}
+	}
+
+	entry->constraint_id = riinfo->constraint_id;
+	entry->lxid = MyProc->lxid;
+	entry->subxid = GetCurrentSubTransactionId();
+	entry->firing_id = firing_id;
+}
+
 
 /*
  * ri_AttributesEqual -
@@ -537,20 +537,20 @@ compareDocR(const void *va, const void *vb)
 	return (WEP_GETPOS(a->pos) > WEP_GETPOS(b->pos)) ? 1 : -1;
 }
 
-#define MAXQROPOS	MAXENTRYPOS
 typedef struct
 {
 	bool		operandexists;
 	bool		reverseinsert;	/* indicates insert order, true means
 								 * descending order */
 	uint32		npos;
-	WordEntryPos pos[MAXQROPOS];
+	WordEntryPos *pos;			/* array of maxpos positions */
 } QueryRepresentationOperand;
 
 typedef struct
 {
 	TSQuery		query;
 	QueryRepresentationOperand *operandData;
+	uint32		maxpos;			/* size of the operands' pos arrays */
 } QueryRepresentation;
 
 #define QR_GET_OPERAND_DATA(q, v) \
@@ -574,7 +574,7 @@ checkcondition_QueryOperand(void *checkval, QueryOperand *val,
 		data->npos = opData->npos;
 		data->pos = opData->pos;
 		if (opData->reverseinsert)
-			data->pos += MAXQROPOS - opData->npos;
+			data->pos += qr->maxpos - opData->npos;
 	}
 
 	return TS_YES;
@@ -620,20 +620,20 @@ fillQueryRepresentationData(QueryRepresentation *qr, DocRepresentation *entry)
 
 		if (opData->npos == 0)
 		{
-			lastPos = (opData->reverseinsert) ? (MAXQROPOS - 1) : 0;
+			lastPos = (opData->reverseinsert) ? (qr->maxpos - 1) : 0;
 			opData->pos[lastPos] = entry->pos;
 			opData->npos++;
 			continue;
 		}
 
 		lastPos = opData->reverseinsert ?
-			(MAXQROPOS - opData->npos) :
+			(qr->maxpos - opData->npos) :
 			(opData->npos - 1);
 
 		if (WEP_GETPOS(opData->pos[lastPos]) != WEP_GETPOS(entry->pos))
 		{
 			lastPos = opData->reverseinsert ?
-				(MAXQROPOS - 1 - opData->npos) :
+				(qr->maxpos - 1 - opData->npos) :
 				(opData->npos);
 
 			opData->pos[lastPos] = entry->pos;
@@ -860,6 +860,7 @@ calc_rank_cd(const float4 *arrdata, TSVector txt, TSQuery query, int method)
 				PrevExtPos = 0.0;
 	int			NExtent = 0;
 	QueryRepresentation qr;
+	WordEntryPos *posdata;
 
 
 	for (i = 0; i < lengthof(weights); i++)
@@ -873,15 +874,23 @@ calc_rank_cd(const float4 *arrdata, TSVector txt, TSQuery query, int method)
 	}
 
 	qr.query = query;
-	qr.operandData = (QueryRepresentationOperand *)
-		palloc0(sizeof(QueryRepresentationOperand) * query->size);
 
 	doc = get_docrep(txt, &qr, &doclen);
 	if (!doc)
-	{
-		pfree(qr.operandData);
 		return 0.0;
-	}
+
+	/*
+	 * An operand gets at most one position from each entry of the document
+	 * representation, so that's all the room its positions need.  The
+	 * operand data is initialized by Cover().
+	 */
+	qr.maxpos = doclen;
+	qr.operandData = (QueryRepresentationOperand *)
+		palloc(sizeof(QueryRepresentationOperand) * query->size);
+	posdata = (WordEntryPos *)
+		palloc(sizeof(WordEntryPos) * doclen * query->size);
+	for (i = 0; i < query->size; i++)
+		qr.operandData[i].pos = posdata + i * doclen;
 
 	MemSet(&ext, 0, sizeof(CoverExt));
 	while (Cover(doc, doclen, &qr, &ext))
@@ -944,6 +953,7 @@ calc_rank_cd(const float4 *arrdata, TSVector txt, TSQuery query, int method)
 
 	pfree(doc);
 
+	pfree(posdata);
 	pfree(qr.operandData);
 
 	return (float4) Wdoc;
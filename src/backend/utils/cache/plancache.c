@@ -1060,7 +1060,18 @@ choose_custom_plan(CachedPlanSource *plansource, ParamListInfo boundParams)
 	 * the generic plan cost), we'll always prefer generic at this point.
 	 */
 	if (plansource->generic_cost < avg_custom_cost)
+	{
+		/*
+		 * Even so, build a custom plan every so often (arbitrarily, once per
+		 * 100 executions).  Otherwise avg_custom_cost would stay frozen at
+		 * whatever the first few parameter values produced, and a workload
+		 * whose later parameter values are ill-served by the generic plan
+		 * could never move back to custom plans.
+		 */
+		if ((plansource->num_custom_plans + plansource->num_generic_plans) % 100 == 0)
+			return true;
 		return false;
+	}
 
 	return true;
 }
@@ -2239,6 +2239,44 @@ SharedRecordTypmodRegistryAttach(SharedRecordTypmodRegistry *registry)
 	CurrentSession->shared_typmod_table = typmod_table;
 }
 
+/*
+ * Forget the record types we learned from a shared registry.
+ *
+ * A pooled parallel worker calls this after detaching from its leader's
+ * session, so that it can later attach to another leader's registry.  Our
+ * local cache then only points at tuple descriptors in the old session's
+ * DSA area, which is gone, so all of it must go.  Returns false if we have
+ * also assigned purely local typmods; those could clash with the next
+ * leader's, and since we can't be very sure that record-typmod-related
+ * state hasn't escaped to anywhere else in the process, the caller should
+ * exit rather than be reused.
+ */
+bool
+SharedRecordTypmodRegistryForget(void)
+{
+	Assert(CurrentSession == NULL ||
+		   CurrentSession->shared_typmod_registry == NULL);
+
+	if (NextRecordTypmod != 0)
+		return false;
+
+	if (RecordCacheArrayLen > 0)
+	{
+		memset(RecordCacheArray, 0, RecordCacheArrayLen * sizeof(TupleDesc));
+		memset(RecordIdentifierArray, 0,
+			   RecordCacheArrayLen * sizeof(uint64));
+	}
+
+	/* The hash table's entries point at the same shared descriptors. */
+	if (RecordCacheHash != NULL)
+	{
+		hash_destroy(RecordCacheHash);
+		RecordCacheHash = NULL;
+	}
+
+	return true;
+}
+
 /*
  * TypeCacheRelCallback
  *		Relcache inval callback function
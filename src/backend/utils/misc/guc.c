@@ -34,7 +34,11 @@
 
 #include "access/commit_ts.h"
 #include "access/gin.h"
+#include "access/multixact.h"
+#include "access/parallel.h"
 #include "access/rmgr.h"
+#include "access/slru.h"
+#include "access/subtrans.h"
 #include "access/tableam.h"
 #include "access/toast_compression.h"
 #include "access/transam.h"
@@ -47,6 +51,7 @@
 #include "catalog/storage.h"
 #include "commands/async.h"
 #include "commands/prepare.h"
+#include "commands/sequence.h"
 #include "commands/trigger.h"
 #include "commands/user.h"
 #include "commands/vacuum.h"
@@ -87,7 +92,9 @@
 #include "storage/pg_shmem.h"
 #include "storage/predicate.h"
 #include "storage/proc.h"
+#include "storage/sinvaladt.h"
 #include "storage/standby.h"
+#include "storage/sync.h"
 #include "tcop/tcopprot.h"
 #include "tsearch/ts_cache.h"
 #include "utils/acl.h"
@@ -457,6 +464,21 @@ static const struct config_enum_entry huge_pages_options[] = {
 	{NULL, 0, false}
 };
 
+static const struct config_enum_entry huge_pages_status_options[] = {
+	{"off", HUGE_PAGES_OFF, false},
+	{"on", HUGE_PAGES_ON, false},
+	{"unknown", HUGE_PAGES_UNKNOWN, false},
+	{NULL, 0, false}
+};
+
+static const struct config_enum_entry shared_memory_numa_policy_options[] = {
+	{"default", SHMEM_NUMA_DEFAULT, false},
+#ifdef HAVE_LINUX_MEMPOLICY_H
+	{"interleave", SHMEM_NUMA_INTERLEAVE, false},
+#endif
+	{NULL, 0, false}
+};
+
 static const struct config_enum_entry force_parallel_mode_options[] = {
 	{"off", FORCE_PARALLEL_OFF, false},
 	{"on", FORCE_PARALLEL_ON, false},
@@ -495,6 +517,14 @@ const struct config_enum_entry ssl_protocol_versions_info[] = {
 StaticAssertDecl(lengthof(ssl_protocol_versions_info) == (PG_TLS1_3_VERSION + 2),
 				 "array length mismatch");
 
+static struct config_enum_entry checkpoint_sync_method_options[] = {
+	{"fsync", CHECKPOINT_SYNC_METHOD_FSYNC, false},
+#ifdef HAVE_SYNCFS
+	{"syncfs", CHECKPOINT_SYNC_METHOD_SYNCFS, false},
+#endif
+	{NULL, 0, false}
+};
+
 static struct config_enum_entry recovery_init_sync_method_options[] = {
 	{"fsync", RECOVERY_INIT_SYNC_METHOD_FSYNC, false},
 #ifdef HAVE_SYNCFS
@@ -524,6 +554,27 @@ static struct config_enum_entry default_toast_compression_options[] = {
 	{NULL, 0, false}
 };
 
+/*
+ * Although only "pglz", "lz4" and "off" are documented, we accept all the
+ * likely variants of "on" and "off", for backwards compatibility with the
+ * time when wal_compression was a boolean.
+ */
+static const struct config_enum_entry wal_compression_options[] = {
+	{"pglz", WAL_COMPRESSION_PGLZ, false},
+#ifdef USE_LZ4
+	{"lz4", WAL_COMPRESSION_LZ4, false},
+#endif
+	{"on", WAL_COMPRESSION_PGLZ, false},
+	{"off", WAL_COMPRESSION_NONE, false},
+	{"true", WAL_COMPRESSION_PGLZ, true},
+	{"false", WAL_COMPRESSION_NONE, true},
+	{"yes", WAL_COMPRESSION_PGLZ, true},
+	{"no", WAL_COMPRESSION_NONE, true},
+	{"1", WAL_COMPRESSION_PGLZ, true},
+	{"0", WAL_COMPRESSION_NONE, true},
+	{NULL, 0, false}
+};
+
 /*
  * Options for enum values stored in other modules
  */
@@ -608,6 +659,9 @@ int			ssl_renegotiation_limit;
  */
 int			huge_pages;
 int			huge_page_size;
+int			huge_pages_status = HUGE_PAGES_UNKNOWN;
+int			shared_memory_numa_policy;
+int			shared_memory_prefault_workers;
 
 /*
  * These variables are all dummies that don't do anything, except in some
@@ -1054,6 +1108,16 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_subplan_resultcache", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables the planner's use of result caching for correlated subplans."),
+			NULL,
+			GUC_EXPLAIN
+		},
+		&enable_subplan_resultcache,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"enable_nestloop", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enables the planner's use of nested-loop join plans."),
@@ -1167,6 +1231,16 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"geqo_greedy", PGC_USERSET, QUERY_TUNING_GEQO,
+			gettext_noop("GEQO: use a deterministic greedy join search instead of the genetic algorithm."),
+			NULL,
+			GUC_EXPLAIN
+		},
+		&Geqo_greedy,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		/* Not for general use --- used by SET SESSION AUTHORIZATION */
 		{"is_superuser", PGC_INTERNAL, UNGROUPED,
@@ -1328,16 +1402,6 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
-	{
-		{"wal_compression", PGC_SUSET, WAL_SETTINGS,
-			gettext_noop("Compresses full-page writes written in WAL file."),
-			NULL
-		},
-		&wal_compression,
-		false,
-		NULL, NULL, NULL
-	},
-
 	{
 		{"wal_init_zero", PGC_SUSET, WAL_SETTINGS,
 			gettext_noop("Writes zeroes to new WAL files before first use."),
@@ -1551,6 +1615,17 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"track_query_progress", PGC_SUSET, STATS_COLLECTOR,
+			gettext_noop("Collects progress information about executing queries."),
+			gettext_noop("Enables reporting of rows processed, sort and hash join "
+						 "progress and temporary file usage of each running query "
+						 "in pg_stat_progress_query.")
+		},
+		&pgstat_track_query_progress,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"track_counts", PGC_SUSET, STATS_COLLECTOR,
 			gettext_noop("Collects statistics on database activity."),
@@ -1578,6 +1653,15 @@ static struct config_bool ConfigureNamesBool[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"track_wait_timing", PGC_SUSET, STATS_COLLECTOR,
+			gettext_noop("Collects timing statistics for wait events."),
+			NULL
+		},
+		&track_wait_timing,
+		false,
+		NULL, NULL, NULL
+	},
 
 	{
 		{"update_process_title", PGC_SUSET, PROCESS_TITLE,
@@ -2464,6 +2548,52 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"bulk_read_ring_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the initial size of the buffer ring used by large sequential scans."),
+			NULL,
+			GUC_UNIT_KB
+		},
+		&bulk_read_ring_size,
+		256, 128, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"bulk_write_ring_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the initial size of the buffer ring used by bulk writes."),
+			gettext_noop("This includes operations such as COPY FROM and CREATE TABLE AS."),
+			GUC_UNIT_KB
+		},
+		&bulk_write_ring_size,
+		16384, 128, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"vacuum_ring_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the initial size of the buffer ring used by VACUUM."),
+			NULL,
+			GUC_UNIT_KB
+		},
+		&vacuum_ring_size,
+		256, 128, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"memory_block_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum memory kept for reuse after memory contexts free large blocks."),
+			gettext_noop("This much memory can be held by each process "
+						 "between queries, to avoid returning it to the "
+						 "operating system and allocating it again."),
+			GUC_UNIT_KB
+		},
+		&memory_block_cache_size,
+		32768, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	/*
 	 * We use the hopefully-safely-small value of 100kB as the compiled-in
 	 * default for max_stack_depth.  InitializeGUCOptions will increase it if
@@ -2564,6 +2694,60 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"subtransaction_buffers", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of shared memory buffers used for the subtransaction cache."),
+			NULL,
+			GUC_UNIT_BLOCKS
+		},
+		&subtransaction_buffers,
+		32, 8, SLRU_MAX_ALLOWED_BUFFERS,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"multixact_offset_buffers", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of shared memory buffers used for the MultiXact offset cache."),
+			NULL,
+			GUC_UNIT_BLOCKS
+		},
+		&multixact_offset_buffers,
+		8, 8, SLRU_MAX_ALLOWED_BUFFERS,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"multixact_member_buffers", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of shared memory buffers used for the MultiXact member cache."),
+			NULL,
+			GUC_UNIT_BLOCKS
+		},
+		&multixact_member_buffers,
+		16, 8, SLRU_MAX_ALLOWED_BUFFERS,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"max_cached_subtransactions", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of subtransaction XIDs each backend advertises in shared memory."),
+			gettext_noop("Transactions with more subtransactions than this "
+						 "force other backends to consult pg_subtrans.")
+		},
+		&max_cached_subxids,
+		PGPROC_MAX_CACHED_SUBXIDS, PGPROC_MAX_CACHED_SUBXIDS, PGPROC_MAX_CACHED_SUBXIDS_LIMIT,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"sinval_queue_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of messages the shared cache invalidation queue can hold."),
+			gettext_noop("The value is rounded up to a power of 2.")
+		},
+		&sinval_queue_size,
+		4096, 1024, MAX_SINVAL_QUEUE_SIZE,
+		NULL, NULL, NULL
+	},
+
 #ifdef LOCK_DEBUG
 	{
 		{"trace_lock_oidmin", PGC_SUSET, DEVELOPER_OPTIONS,
@@ -2864,6 +3048,16 @@ static struct config_int ConfigureNamesInt[] =
 		check_wal_buffers, NULL, NULL
 	},
 
+	{
+		{"wal_insert_locks", PGC_POSTMASTER, WAL_SETTINGS,
+			gettext_noop("Sets the number of locks used for concurrent WAL insertion."),
+			NULL
+		},
+		&NumXLogInsertLocks,
+		8, 1, 128,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"wal_writer_delay", PGC_SIGHUP, WAL_SETTINGS,
 			gettext_noop("Time between WAL flushes performed in the WAL writer."),
@@ -2886,6 +3080,16 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"wal_preallocate_segments", PGC_SIGHUP, WAL_SETTINGS,
+			gettext_noop("Sets the number of WAL segments the WAL writer creates ahead of the insert position."),
+			NULL
+		},
+		&wal_preallocate_segments,
+		2, 0, 1024,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"wal_skip_threshold", PGC_USERSET, WAL_SETTINGS,
 			gettext_noop("Minimum size of new file to fsync instead of writing WAL."),
@@ -2897,6 +3101,16 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"sequence_log_values", PGC_USERSET, WAL_SETTINGS,
+			gettext_noop("Sets the number of sequence values to log in advance in each WAL record for a sequence."),
+			gettext_noop("Up to that many values can be skipped after a crash.")
+		},
+		&sequence_log_values,
+		32, 0, 100000,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"max_wal_senders", PGC_POSTMASTER, REPLICATION_SENDING,
 			gettext_noop("Sets the maximum number of simultaneously running WAL sender processes."),
@@ -2950,7 +3164,7 @@ static struct config_int ConfigureNamesInt[] =
 			/* we have no microseconds designation, so can't supply units here */
 		},
 		&CommitDelay,
-		0, 0, 100000,
+		0, -1, 100000,
 		NULL, NULL, NULL
 	},
 
@@ -3058,6 +3272,16 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"bgwriter_freelist_target", PGC_SIGHUP, RESOURCES_BGWRITER,
+			gettext_noop("Number of clean buffers the background writer tries to keep on the freelist."),
+			gettext_noop("0 means don't move buffers onto the freelist.")
+		},
+		&bgwriter_freelist_target,
+		0, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"bgwriter_flush_after", PGC_SIGHUP, RESOURCES_BGWRITER,
 			gettext_noop("Number of pages after which previously performed writes are flushed to disk."),
@@ -3370,6 +3594,19 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"parallel_worker_idle_timeout", PGC_SIGHUP, RESOURCES_ASYNCHRONOUS,
+			gettext_noop("Sets how long a parallel worker waits for another parallel query before exiting."),
+			gettext_noop("Idle parallel workers are reused by parallel queries of other "
+						 "sessions connected to the same database as the same user. "
+						 "0 makes workers exit as soon as they are done."),
+			GUC_UNIT_MS
+		},
+		&parallel_worker_idle_timeout,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"autovacuum_work_mem", PGC_SIGHUP, RESOURCES_MEM,
 			gettext_noop("Sets the maximum memory to be used by each autovacuum worker process."),
@@ -3460,6 +3697,17 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"jit_warmup_calls", PGC_USERSET, QUERY_TUNING_COST,
+			gettext_noop("Sets the number of times a JIT-compiled expression is interpreted before its code is generated."),
+			gettext_noop("0 generates the code before the first evaluation."),
+			GUC_EXPLAIN
+		},
+		&jit_warmup_calls,
+		1000, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"min_parallel_table_scan_size", PGC_USERSET, QUERY_TUNING_COST,
 			gettext_noop("Sets the minimum amount of table data for a parallel scan."),
@@ -3549,6 +3797,16 @@ static struct config_int ConfigureNamesInt[] =
 		check_huge_page_size, NULL, NULL
 	},
 
+	{
+		{"shared_memory_prefault_workers", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of processes used to pre-fault shared memory at server start."),
+			gettext_noop("Zero disables pre-faulting.")
+		},
+		&shared_memory_prefault_workers,
+		0, 0, 256,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"debug_invalidate_system_caches_always", PGC_SUSET, DEVELOPER_OPTIONS,
 			gettext_noop("Aggressively invalidate system caches for debugging purposes."),
@@ -4889,6 +5147,16 @@ static struct config_enum ConfigureNamesEnum[] =
 		NULL, assign_xlog_sync_method, NULL
 	},
 
+	{
+		{"wal_compression", PGC_SUSET, WAL_SETTINGS,
+			gettext_noop("Compresses full-page writes written in WAL file with specified method."),
+			NULL
+		},
+		&wal_compression,
+		WAL_COMPRESSION_NONE, wal_compression_options,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"xmlbinary", PGC_USERSET, CLIENT_CONN_STATEMENT,
 			gettext_noop("Sets how binary values are to be encoded in XML."),
@@ -4920,6 +5188,27 @@ static struct config_enum ConfigureNamesEnum[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"huge_pages_status", PGC_INTERNAL, PRESET_OPTIONS,
+			gettext_noop("Indicates the status of huge pages."),
+			NULL,
+			GUC_NOT_IN_SAMPLE | GUC_DISALLOW_IN_FILE
+		},
+		&huge_pages_status,
+		HUGE_PAGES_UNKNOWN, huge_pages_status_options,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"shared_memory_numa_policy", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Selects the NUMA memory placement policy for the main shared memory region."),
+			NULL
+		},
+		&shared_memory_numa_policy,
+		SHMEM_NUMA_DEFAULT, shared_memory_numa_policy_options,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"force_parallel_mode", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Forces use of parallel query facilities."),
@@ -4987,6 +5276,15 @@ static struct config_enum ConfigureNamesEnum[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"checkpoint_sync_method", PGC_SIGHUP, WAL_CHECKPOINTS,
+			gettext_noop("Sets the method for making files written since the last checkpoint durable."),
+		},
+		&checkpoint_sync_method,
+		CHECKPOINT_SYNC_METHOD_FSYNC, checkpoint_sync_method_options,
+		NULL, NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, 0, NULL, NULL, NULL, NULL
@@ -46,6 +46,10 @@
 
 #include "postgres.h"
 
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
 #include "port/pg_bitutils.h"
 #include "utils/memdebug.h"
 #include "utils/memutils.h"
@@ -260,6 +264,172 @@ static AllocSetFreeList context_freelists[2] =
 	}
 };
 
+/*
+ * Large blocks that are released by one context are kept in a per-process
+ * cache, so that the next context that asks for a block of the same size
+ * can have it without going through malloc().  Big malloc() requests are
+ * served by mmap() and handed back with munmap() when freed, which makes
+ * every query that builds a large hash table or sort fault its memory in
+ * again from scratch; a session that repeats such queries can reuse the
+ * blocks instead.
+ *
+ * Only blocks of at least ALLOC_BLOCK_CACHE_MIN_SIZE are cached, that's
+ * the size of the chunks nodeHash.c allocates tuples in.  Blocks are
+ * matched on their exact size: regular blocks double in size and large
+ * arrays tend to be grown by doubling as well, so the same few sizes come
+ * back over and over.  The cache holds at most ALLOC_BLOCK_CACHE_CLASSES
+ * distinct sizes and memory_block_cache_size kilobytes altogether; a block
+ * that doesn't fit is simply free()'d.  Cached blocks don't belong to any
+ * context, so they are not counted in MemoryContextAllocatedBytes.
+ *
+ * Blocks in a size class are chained via their "next" pointers.
+ */
+#define ALLOC_BLOCK_CACHE_MIN_SIZE	(32 * 1024)
+#define ALLOC_BLOCK_CACHE_CLASSES	8
+
+/* GUC variable */
+int			memory_block_cache_size = 32768;
+
+typedef struct AllocBlockCacheClass
+{
+	Size		blksize;		/* size of the blocks, or 0 if slot unused */
+	int			num_free;		/* current list length */
+	AllocBlock	first_free;		/* list header */
+} AllocBlockCacheClass;
+
+static AllocBlockCacheClass block_cache[ALLOC_BLOCK_CACHE_CLASSES];
+static Size block_cache_bytes = 0;
+
+static void AllocSetTrimBlockCache(Size limit);
+
+/*
+ * Blocks at least this big are marked as candidates for transparent huge
+ * pages, where the platform supports that.  Whether the kernel actually
+ * backs them with huge pages is up to its configuration.
+ */
+#define ALLOC_HUGE_PAGE_SIZE		(2 * 1024 * 1024)
+
+/*
+ * AllocSetMallocBlock
+ *		Get a block of exactly blksize bytes, from the block cache if it has
+ *		one, otherwise from malloc().  Returns NULL if out of memory.
+ */
+static AllocBlock
+AllocSetMallocBlock(Size blksize)
+{
+	AllocBlock	block;
+
+	if (blksize >= ALLOC_BLOCK_CACHE_MIN_SIZE)
+	{
+		for (int i = 0; i < ALLOC_BLOCK_CACHE_CLASSES; i++)
+		{
+			AllocBlockCacheClass *cls = &block_cache[i];
+
+			if (cls->blksize != blksize || cls->first_free == NULL)
+				continue;
+
+			block = cls->first_free;
+			VALGRIND_MAKE_MEM_DEFINED(block, sizeof(AllocBlockData));
+			cls->first_free = block->next;
+			if (--cls->num_free == 0)
+				cls->blksize = 0;
+			block_cache_bytes -= blksize;
+
+			VALGRIND_MAKE_MEM_UNDEFINED(block, blksize);
+			return block;
+		}
+	}
+
+	block = (AllocBlock) malloc(blksize);
+
+#ifdef MADV_HUGEPAGE
+	if (block != NULL && blksize >= 2 * ALLOC_HUGE_PAGE_SIZE)
+	{
+		/* only whole, aligned huge pages within the block qualify */
+		char	   *start = (char *) TYPEALIGN(ALLOC_HUGE_PAGE_SIZE, block);
+		char	   *end = (char *) TYPEALIGN_DOWN(ALLOC_HUGE_PAGE_SIZE,
+												  (char *) block + blksize);
+
+		if (end > start)
+			(void) madvise(start, end - start, MADV_HUGEPAGE);
+	}
+#endif
+
+	return block;
+}
+
+/*
+ * AllocSetFreeBlock
+ *		Give back a block of blksize bytes that a context no longer uses,
+ *		by putting it in the block cache or else returning it to free().
+ */
+static void
+AllocSetFreeBlock(AllocBlock block, Size blksize)
+{
+	Size		limit = (Size) memory_block_cache_size * 1024;
+
+	/* The limit might have been lowered since we filled the cache */
+	if (unlikely(block_cache_bytes > limit))
+		AllocSetTrimBlockCache(limit);
+
+	if (blksize >= ALLOC_BLOCK_CACHE_MIN_SIZE &&
+		block_cache_bytes + blksize <= limit)
+	{
+		AllocBlockCacheClass *cls = NULL;
+
+		for (int i = 0; i < ALLOC_BLOCK_CACHE_CLASSES; i++)
+		{
+			if (block_cache[i].blksize == blksize)
+			{
+				cls = &block_cache[i];
+				break;
+			}
+			if (block_cache[i].blksize == 0 && cls == NULL)
+				cls = &block_cache[i];
+		}
+
+		if (cls != NULL)
+		{
+			cls->blksize = blksize;
+			block->next = cls->first_free;
+			cls->first_free = block;
+			cls->num_free++;
+			block_cache_bytes += blksize;
+
+			VALGRIND_MAKE_MEM_NOACCESS(block, blksize);
+			return;
+		}
+	}
+
+	free(block);
+}
+
+/*
+ * AllocSetTrimBlockCache
+ *		free() cached blocks until the cache holds at most limit bytes.
+ */
+static void
+AllocSetTrimBlockCache(Size limit)
+{
+	for (int i = 0; i < ALLOC_BLOCK_CACHE_CLASSES && block_cache_bytes > limit;
+		 i++)
+	{
+		AllocBlockCacheClass *cls = &block_cache[i];
+
+		while (cls->first_free != NULL && block_cache_bytes > limit)
+		{
+			AllocBlock	block = cls->first_free;
+
+			VALGRIND_MAKE_MEM_DEFINED(block, sizeof(AllocBlockData));
+			cls->first_free = block->next;
+			block_cache_bytes -= cls->blksize;
+			if (--cls->num_free == 0)
+				cls->blksize = 0;
+			free(block);
+		}
+	}
+}
+
 /*
  * These functions implement the MemoryContext API for AllocSet contexts.
  */
@@ -447,6 +617,7 @@ AllocSetContextCreateInternal(MemoryContext parent,
 								parent,
 								name);
 
+			/* The keeper block is still counted in MemoryContextAllocatedBytes */
 			((MemoryContext) set)->mem_allocated =
 				set->keeper->endptr - ((char *) set);
 
@@ -539,6 +710,7 @@ AllocSetContextCreateInternal(MemoryContext parent,
 						name);
 
 	((MemoryContext) set)->mem_allocated = firstBlockSize;
+	MemoryContextCountAlloc(firstBlockSize);
 
 	return (MemoryContext) set;
 }
@@ -601,11 +773,12 @@ AllocSetReset(MemoryContext context)
 		{
 			/* Normal case, release the block */
 			context->mem_allocated -= block->endptr - ((char *) block);
+			MemoryContextCountFree(block->endptr - ((char *) block));
 
 #ifdef CLOBBER_FREED_MEMORY
 			wipe_mem(block, block->freeptr - ((char *) block));
 #endif
-			free(block);
+			AllocSetFreeBlock(block, block->endptr - ((char *) block));
 		}
 		block = next;
 	}
@@ -628,8 +801,7 @@ AllocSetDelete(MemoryContext context)
 {
 	AllocSet	set = (AllocSet) context;
 	AllocBlock	block = set->blocks;
-	Size		keepersize PG_USED_FOR_ASSERTS_ONLY
-	= set->keeper->endptr - ((char *) set);
+	Size		keepersize = set->keeper->endptr - ((char *) set);
 
 	AssertArg(AllocSetIsValid(set));
 
@@ -667,6 +839,7 @@ AllocSetDelete(MemoryContext context)
 				freelist->num_free--;
 
 				/* All that remains is to free the header/initial block */
+				MemoryContextCountFree(oldset->keeper->endptr - ((char *) oldset));
 				free(oldset);
 			}
 			Assert(freelist->num_free == 0);
@@ -686,14 +859,17 @@ AllocSetDelete(MemoryContext context)
 		AllocBlock	next = block->next;
 
 		if (block != set->keeper)
+		{
 			context->mem_allocated -= block->endptr - ((char *) block);
+			MemoryContextCountFree(block->endptr - ((char *) block));
+		}
 
 #ifdef CLOBBER_FREED_MEMORY
 		wipe_mem(block, block->freeptr - ((char *) block));
 #endif
 
 		if (block != set->keeper)
-			free(block);
+			AllocSetFreeBlock(block, block->endptr - ((char *) block));
 
 		block = next;
 	}
@@ -701,6 +877,7 @@ AllocSetDelete(MemoryContext context)
 	Assert(context->mem_allocated == keepersize);
 
 	/* Finally, free the context header, including the keeper block */
+	MemoryContextCountFree(keepersize);
 	free(set);
 }
 
@@ -737,11 +914,12 @@ AllocSetAlloc(MemoryContext context, Size size)
 	{
 		chunk_size = MAXALIGN(size);
 		blksize = chunk_size + ALLOC_BLOCKHDRSZ + ALLOC_CHUNKHDRSZ;
-		block = (AllocBlock) malloc(blksize);
+		block = AllocSetMallocBlock(blksize);
 		if (block == NULL)
 			return NULL;
 
 		context->mem_allocated += blksize;
+		MemoryContextCountAlloc(blksize);
 
 		block->aset = set;
 		block->freeptr = block->endptr = ((char *) block) + blksize;
@@ -917,7 +1095,7 @@ AllocSetAlloc(MemoryContext context, Size size)
 			blksize <<= 1;
 
 		/* Try to allocate it */
-		block = (AllocBlock) malloc(blksize);
+		block = AllocSetMallocBlock(blksize);
 
 		/*
 		 * We could be asking for pretty big blocks here, so cope if malloc
@@ -928,13 +1106,14 @@ AllocSetAlloc(MemoryContext context, Size size)
 			blksize >>= 1;
 			if (blksize < required_size)
 				break;
-			block = (AllocBlock) malloc(blksize);
+			block = AllocSetMallocBlock(blksize);
 		}
 
 		if (block == NULL)
 			return NULL;
 
 		context->mem_allocated += blksize;
+		MemoryContextCountAlloc(blksize);
 
 		block->aset = set;
 		block->freeptr = ((char *) block) + ALLOC_BLOCKHDRSZ;
@@ -1010,7 +1189,7 @@ AllocSetFree(MemoryContext context, void *pointer)
 	{
 		/*
 		 * Big chunks are certain to have been allocated as single-chunk
-		 * blocks.  Just unlink that block and return it to malloc().
+		 * blocks.  Just unlink that block and give it back.
 		 */
 		AllocBlock	block = (AllocBlock) (((char *) chunk) - ALLOC_BLOCKHDRSZ);
 
@@ -1034,11 +1213,12 @@ AllocSetFree(MemoryContext context, void *pointer)
 			block->next->prev = block->prev;
 
 		context->mem_allocated -= block->endptr - ((char *) block);
+		MemoryContextCountFree(block->endptr - ((char *) block));
 
 #ifdef CLOBBER_FREED_MEMORY
 		wipe_mem(block, block->freeptr - ((char *) block));
 #endif
-		free(block);
+		AllocSetFreeBlock(block, block->endptr - ((char *) block));
 	}
 	else
 	{
@@ -1138,6 +1318,8 @@ AllocSetRealloc(MemoryContext context, void *pointer, Size size)
 		/* updated separately, not to underflow when (oldblksize > blksize) */
 		context->mem_allocated -= oldblksize;
 		context->mem_allocated += blksize;
+		MemoryContextCountFree(oldblksize);
+		MemoryContextCountAlloc(blksize);
 
 		block->freeptr = block->endptr = ((char *) block) + blksize;
 
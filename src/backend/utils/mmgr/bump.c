@@ -0,0 +1,906 @@
+/*-------------------------------------------------------------------------
+ *
+ * bump.c
+ *	  Bump allocator definitions.
+ *
+ * Bump is a MemoryContext implementation for short-lived memory that is
+ * released all at once by resetting the context, such as the per-tuple
+ * memory of expression contexts.
+ *
+ * Portions Copyright (c) 2021, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/mmgr/bump.c
+ *
+ *
+ *	Chunks are carved one after another from the current block, with no
+ *	rounding of the requested size other than to MAXALIGN and without any
+ *	freelists, so allocation is just a pointer increment.  Freeing a chunk
+ *	normally does nothing: its space is reclaimed when the context is reset.
+ *	The exception is freeing (or resizing) the most recently allocated
+ *	chunk, whose space is given back to the block at once, which takes care
+ *	of the common palloc/pfree pairs in tight loops.
+ *
+ *	As in aset.c, the first block is allocated along with the context header
+ *	and kept across resets, so resetting a context that didn't outgrow its
+ *	first block never calls free() or malloc().  Chunks larger than
+ *	allocChunkLimit get a block of their own, which pfree() releases
+ *	immediately; that keeps big temporary values, like detoasted datums,
+ *	from piling up until the next reset.
+ *
+ *	This is a poor fit for memory that lives across many palloc/pfree
+ *	cycles without a reset, because small chunks are never reused: use
+ *	aset.c for that.
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "lib/ilist.h"
+#include "utils/memdebug.h"
+#include "utils/memutils.h"
+
+
+#define Bump_BLOCKHDRSZ		MAXALIGN(sizeof(BumpBlock))
+#define Bump_CHUNKHDRSZ		sizeof(BumpChunk)
+
+/* largest chunk carved from a regular block, before the maxBlockSize cap */
+#define BUMP_CHUNK_LIMIT	8192
+
+typedef struct BumpBlock BumpBlock; /* forward reference */
+typedef struct BumpChunk BumpChunk;
+
+typedef void *BumpPointer;
+
+/*
+ * BumpContext is a memory context that hands out chunks sequentially and
+ * reclaims their space only on reset.
+ */
+typedef struct BumpContext
+{
+	MemoryContextData header;	/* Standard memory-context fields */
+
+	/* Bump context parameters */
+	Size		initBlockSize;	/* initial block size */
+	Size		maxBlockSize;	/* maximum block size */
+	Size		nextBlockSize;	/* next block size to allocate */
+	Size		allocChunkLimit;	/* effective chunk size limit */
+
+	BumpBlock  *keeper;			/* keep this block over resets */
+	dlist_head	blocks;			/* list of blocks, current one first */
+} BumpContext;
+
+/*
+ * BumpBlock
+ *		The unit of memory obtained from malloc().  Regular blocks hold many
+ *		chunks; a chunk larger than allocChunkLimit gets a block of its own.
+ *
+ *		BumpBlock is the header data for a block --- the usable space within
+ *		the block begins at the next alignment boundary.
+ */
+struct BumpBlock
+{
+	dlist_node	node;			/* doubly-linked list of blocks */
+	char	   *freeptr;		/* start of free space in this block */
+	char	   *endptr;			/* end of space in this block */
+};
+
+/*
+ * BumpChunk
+ *		The prefix of each piece of memory in a BumpBlock
+ *
+ * Note: to meet the memory context APIs, the payload area of the chunk must
+ * be maxaligned, and the "context" link must be immediately adjacent to the
+ * payload area (cf. GetMemoryChunkContext).  As in generation.c, we ensure
+ * this by adding any required alignment padding before the pointer field.
+ */
+struct BumpChunk
+{
+	/* size is always the size of the usable space in the chunk */
+	Size		size;
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* when debugging memory usage, also store actual requested size */
+	/* this is zero in a free chunk */
+	Size		requested_size;
+
+#define BUMPCHUNK_RAWSIZE  (SIZEOF_SIZE_T * 2 + SIZEOF_VOID_P)
+#else
+#define BUMPCHUNK_RAWSIZE  (SIZEOF_SIZE_T + SIZEOF_VOID_P)
+#endif							/* MEMORY_CONTEXT_CHECKING */
+
+	/* ensure proper alignment by adding padding if needed */
+#if (BUMPCHUNK_RAWSIZE % MAXIMUM_ALIGNOF) != 0
+	char		padding[MAXIMUM_ALIGNOF - BUMPCHUNK_RAWSIZE % MAXIMUM_ALIGNOF];
+#endif
+
+	BumpContext *context;		/* owning context, or NULL if freed chunk */
+	/* there must not be any padding to reach a MAXALIGN boundary here! */
+};
+
+/*
+ * Only the "context" field should be accessed outside this module.
+ * We keep the rest of an allocated chunk's header marked NOACCESS when using
+ * valgrind.
+ */
+#define BUMPCHUNK_PRIVATE_LEN	offsetof(BumpChunk, context)
+
+/*
+ * BumpIsValid
+ *		True iff set is valid bump context.
+ */
+#define BumpIsValid(set) PointerIsValid(set)
+
+#define BumpPointerGetChunk(ptr) \
+	((BumpChunk *)(((char *)(ptr)) - Bump_CHUNKHDRSZ))
+#define BumpChunkGetPointer(chk) \
+	((BumpPointer *)(((char *)(chk)) + Bump_CHUNKHDRSZ))
+
+/* the block holding a chunk larger than allocChunkLimit */
+#define BumpLargeChunkGetBlock(chk) \
+	((BumpBlock *)(((char *)(chk)) - Bump_BLOCKHDRSZ))
+
+/*
+ * These functions implement the MemoryContext API for Bump contexts.
+ */
+static void *BumpAlloc(MemoryContext context, Size size);
+static void BumpFree(MemoryContext context, void *pointer);
+static void *BumpRealloc(MemoryContext context, void *pointer, Size size);
+static void BumpReset(MemoryContext context);
+static void BumpDelete(MemoryContext context);
+static Size BumpGetChunkSpace(MemoryContext context, void *pointer);
+static bool BumpIsEmpty(MemoryContext context);
+static void BumpStats(MemoryContext context,
+					  MemoryStatsPrintFunc printfunc, void *passthru,
+					  MemoryContextCounters *totals,
+					  bool print_to_stderr);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+static void BumpCheck(MemoryContext context);
+#endif
+
+/*
+ * This is the virtual function table for Bump contexts.
+ */
+static const MemoryContextMethods BumpMethods = {
+	BumpAlloc,
+	BumpFree,
+	BumpRealloc,
+	BumpReset,
+	BumpDelete,
+	BumpGetChunkSpace,
+	BumpIsEmpty,
+	BumpStats
+#ifdef MEMORY_CONTEXT_CHECKING
+	,BumpCheck
+#endif
+};
+
+
+/*
+ * Public routines
+ */
+
+
+/*
+ * BumpContextCreate
+ *		Create a new Bump context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (must be statically allocated)
+ * minContextSize: minimum context size
+ * initBlockSize: initial allocation block size
+ * maxBlockSize: maximum allocation block size
+ *
+ * The size parameters have the same meaning as for AllocSetContextCreate,
+ * so the ALLOCSET_*_SIZES macros can be used.
+ */
+MemoryContext
+BumpContextCreate(MemoryContext parent,
+				  const char *name,
+				  Size minContextSize,
+				  Size initBlockSize,
+				  Size maxBlockSize)
+{
+	Size		firstBlockSize;
+	BumpContext *set;
+	BumpBlock  *block;
+
+	/* Assert we padded BumpChunk properly */
+	StaticAssertStmt(Bump_CHUNKHDRSZ == MAXALIGN(Bump_CHUNKHDRSZ),
+					 "sizeof(BumpChunk) is not maxaligned");
+	StaticAssertStmt(offsetof(BumpChunk, context) + sizeof(MemoryContext) ==
+					 Bump_CHUNKHDRSZ,
+					 "padding calculation in BumpChunk is wrong");
+
+	/* See AllocSetContextCreateInternal() */
+	Assert(initBlockSize == MAXALIGN(initBlockSize) &&
+		   initBlockSize >= 1024);
+	Assert(maxBlockSize == MAXALIGN(maxBlockSize) &&
+		   maxBlockSize >= initBlockSize &&
+		   AllocHugeSizeIsValid(maxBlockSize)); /* must be safe to double */
+	Assert(minContextSize == 0 ||
+		   (minContextSize == MAXALIGN(minContextSize) &&
+			minContextSize >= 1024 &&
+			minContextSize <= maxBlockSize));
+
+	/* Determine size of initial block */
+	firstBlockSize = MAXALIGN(sizeof(BumpContext)) +
+		Bump_BLOCKHDRSZ + Bump_CHUNKHDRSZ;
+	if (minContextSize != 0)
+		firstBlockSize = Max(firstBlockSize, minContextSize);
+	else
+		firstBlockSize = Max(firstBlockSize, initBlockSize);
+
+	/*
+	 * Allocate the initial block.  Unlike other blocks, it starts with the
+	 * context header and its block header follows that.
+	 */
+	set = (BumpContext *) malloc(firstBlockSize);
+	if (set == NULL)
+	{
+		if (TopMemoryContext)
+			MemoryContextStats(TopMemoryContext);
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+				 errdetail("Failed while creating memory context \"%s\".",
+						   name)));
+	}
+
+	/*
+	 * Avoid writing code that can fail between here and MemoryContextCreate;
+	 * we'd leak the header/initial block if we ereport in this stretch.
+	 */
+
+	/* Fill in the initial block's block header */
+	block = (BumpBlock *) (((char *) set) + MAXALIGN(sizeof(BumpContext)));
+	block->freeptr = ((char *) block) + Bump_BLOCKHDRSZ;
+	block->endptr = ((char *) set) + firstBlockSize;
+
+	/* Mark unallocated space NOACCESS; leave the block header alone. */
+	VALGRIND_MAKE_MEM_NOACCESS(block->freeptr, block->endptr - block->freeptr);
+
+	dlist_init(&set->blocks);
+	dlist_push_head(&set->blocks, &block->node);
+	set->keeper = block;
+
+	set->initBlockSize = initBlockSize;
+	set->maxBlockSize = maxBlockSize;
+	set->nextBlockSize = initBlockSize;
+
+	/*
+	 * Chunks bigger than a fraction of the largest block get a block of their
+	 * own, so that we never waste more than that fraction of a block when
+	 * switching to a new one.
+	 */
+	set->allocChunkLimit = BUMP_CHUNK_LIMIT;
+	while ((Size) (set->allocChunkLimit + Bump_CHUNKHDRSZ) >
+		   (Size) ((maxBlockSize - Bump_BLOCKHDRSZ) / 8))
+		set->allocChunkLimit >>= 1;
+
+	/* Finally, do the type-independent part of context creation */
+	MemoryContextCreate((MemoryContext) set,
+						T_BumpContext,
+						&BumpMethods,
+						parent,
+						name);
+
+	((MemoryContext) set)->mem_allocated = firstBlockSize;
+	MemoryContextCountAlloc(firstBlockSize);
+
+	return (MemoryContext) set;
+}
+
+/*
+ * BumpReset
+ *		Frees all memory which is allocated in the given set.
+ *
+ * All blocks but the keeper are returned to malloc(), and the keeper is
+ * rewound to empty.
+ */
+static void
+BumpReset(MemoryContext context)
+{
+	BumpContext *set = (BumpContext *) context;
+	dlist_mutable_iter miter;
+	char	   *datastart;
+	Size		keepersize PG_USED_FOR_ASSERTS_ONLY
+	= set->keeper->endptr - ((char *) set);
+
+	AssertArg(BumpIsValid(set));
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Check for corruption and leaks before freeing */
+	BumpCheck(context);
+#endif
+
+	dlist_foreach_modify(miter, &set->blocks)
+	{
+		BumpBlock  *block = dlist_container(BumpBlock, node, miter.cur);
+
+		if (block == set->keeper)
+			continue;
+
+		dlist_delete(miter.cur);
+
+		context->mem_allocated -= block->endptr - ((char *) block);
+		MemoryContextCountFree(block->endptr - ((char *) block));
+
+#ifdef CLOBBER_FREED_MEMORY
+		wipe_mem(block, block->freeptr - ((char *) block));
+#endif
+
+		free(block);
+	}
+
+	/* Rewind the keeper block, which is now the only one */
+	datastart = ((char *) set->keeper) + Bump_BLOCKHDRSZ;
+#ifdef CLOBBER_FREED_MEMORY
+	wipe_mem(datastart, set->keeper->freeptr - datastart);
+#else
+	/* wipe_mem() would have done this */
+	VALGRIND_MAKE_MEM_NOACCESS(datastart, set->keeper->freeptr - datastart);
+#endif
+	set->keeper->freeptr = datastart;
+
+	Assert(context->mem_allocated == keepersize);
+
+	/* Reset block size allocation sequence, too */
+	set->nextBlockSize = set->initBlockSize;
+}
+
+/*
+ * BumpDelete
+ *		Free all memory which is allocated in the given context.
+ */
+static void
+BumpDelete(MemoryContext context)
+{
+	BumpContext *set = (BumpContext *) context;
+	Size		keepersize = set->keeper->endptr - ((char *) set);
+
+	/* Reset to release all the blocks but the keeper */
+	BumpReset(context);
+
+	/* And free the context header, including the keeper block */
+	MemoryContextCountFree(keepersize);
+	free(set);
+}
+
+/*
+ * BumpAlloc
+ *		Returns pointer to allocated memory of given size or NULL if
+ *		request could not be completed; memory is added to the set.
+ *
+ * No request may exceed:
+ *		MAXALIGN_DOWN(SIZE_MAX) - Bump_BLOCKHDRSZ - Bump_CHUNKHDRSZ
+ * All callers use a much-lower limit.
+ *
+ * Note: when using valgrind, it doesn't matter how the returned allocation
+ * is marked, as mcxt.c will set it to UNDEFINED.  In some paths we will
+ * return space that is marked NOACCESS - BumpRealloc has to beware!
+ */
+static void *
+BumpAlloc(MemoryContext context, Size size)
+{
+	BumpContext *set = (BumpContext *) context;
+	BumpBlock  *block;
+	BumpChunk  *chunk;
+	Size		chunk_size = MAXALIGN(size);
+
+	/*
+	 * If requested size exceeds maximum for chunks, allocate an entire block
+	 * for this request.
+	 */
+	if (chunk_size > set->allocChunkLimit)
+	{
+		Size		blksize = chunk_size + Bump_BLOCKHDRSZ + Bump_CHUNKHDRSZ;
+
+		block = (BumpBlock *) malloc(blksize);
+		if (block == NULL)
+			return NULL;
+
+		context->mem_allocated += blksize;
+		MemoryContextCountAlloc(blksize);
+
+		/* the block is completely full */
+		block->freeptr = block->endptr = ((char *) block) + blksize;
+
+		chunk = (BumpChunk *) (((char *) block) + Bump_BLOCKHDRSZ);
+		chunk->context = set;
+		chunk->size = chunk_size;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+		chunk->requested_size = size;
+		/* set mark to catch clobber of "unused" space */
+		if (size < chunk_size)
+			set_sentinel(BumpChunkGetPointer(chunk), size);
+#endif
+#ifdef RANDOMIZE_ALLOCATED_MEMORY
+		/* fill the allocated space with junk */
+		randomize_mem((char *) BumpChunkGetPointer(chunk), size);
+#endif
+
+		/*
+		 * Put it behind the current block, so that we don't stop using the
+		 * free space in that one.
+		 */
+		dlist_insert_after(dlist_head_node(&set->blocks), &block->node);
+
+		/* Ensure any padding bytes are marked NOACCESS. */
+		VALGRIND_MAKE_MEM_NOACCESS((char *) BumpChunkGetPointer(chunk) + size,
+								   chunk_size - size);
+
+		/* Disallow external access to private part of chunk header. */
+		VALGRIND_MAKE_MEM_NOACCESS(chunk, BUMPCHUNK_PRIVATE_LEN);
+
+		return BumpChunkGetPointer(chunk);
+	}
+
+	/*
+	 * Not an over-sized chunk.  Is there enough space in the current block?
+	 * If not, allocate a new regular block; whatever is left in the old one
+	 * is wasted, but that's at most 1/8th of it.
+	 */
+	block = dlist_head_element(BumpBlock, node, &set->blocks);
+
+	if ((Size) (block->endptr - block->freeptr) < Bump_CHUNKHDRSZ + chunk_size)
+	{
+		Size		blksize;
+		Size		required_size;
+
+		/*
+		 * The first such block has size initBlockSize, and we double the
+		 * space in each succeeding block, but not more than maxBlockSize.
+		 */
+		blksize = set->nextBlockSize;
+		set->nextBlockSize <<= 1;
+		if (set->nextBlockSize > set->maxBlockSize)
+			set->nextBlockSize = set->maxBlockSize;
+
+		/*
+		 * If initBlockSize is less than allocChunkLimit, we could need more
+		 * space than that for this chunk.
+		 */
+		required_size = chunk_size + Bump_BLOCKHDRSZ + Bump_CHUNKHDRSZ;
+		while (blksize < required_size)
+			blksize <<= 1;
+
+		block = (BumpBlock *) malloc(blksize);
+		if (block == NULL)
+			return NULL;
+
+		context->mem_allocated += blksize;
+		MemoryContextCountAlloc(blksize);
+
+		block->freeptr = ((char *) block) + Bump_BLOCKHDRSZ;
+		block->endptr = ((char *) block) + blksize;
+
+		/* Mark unallocated space NOACCESS. */
+		VALGRIND_MAKE_MEM_NOACCESS(block->freeptr,
+								   blksize - Bump_BLOCKHDRSZ);
+
+		/* it becomes the current block */
+		dlist_push_head(&set->blocks, &block->node);
+	}
+
+	chunk = (BumpChunk *) block->freeptr;
+
+	/* Prepare to initialize the chunk header. */
+	VALGRIND_MAKE_MEM_UNDEFINED(chunk, Bump_CHUNKHDRSZ);
+
+	block->freeptr += (Bump_CHUNKHDRSZ + chunk_size);
+	Assert(block->freeptr <= block->endptr);
+
+	chunk->context = set;
+	chunk->size = chunk_size;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	chunk->requested_size = size;
+	/* set mark to catch clobber of "unused" space */
+	if (size < chunk->size)
+		set_sentinel(BumpChunkGetPointer(chunk), size);
+#endif
+#ifdef RANDOMIZE_ALLOCATED_MEMORY
+	/* fill the allocated space with junk */
+	randomize_mem((char *) BumpChunkGetPointer(chunk), size);
+#endif
+
+	/* Ensure any padding bytes are marked NOACCESS. */
+	VALGRIND_MAKE_MEM_NOACCESS((char *) BumpChunkGetPointer(chunk) + size,
+							   chunk_size - size);
+
+	/* Disallow external access to private part of chunk header. */
+	VALGRIND_MAKE_MEM_NOACCESS(chunk, BUMPCHUNK_PRIVATE_LEN);
+
+	return BumpChunkGetPointer(chunk);
+}
+
+/*
+ * BumpChunkIsLast
+ *		Is the chunk the most recently allocated one in the current block?
+ */
+static inline bool
+BumpChunkIsLast(BumpContext *set, BumpChunk *chunk)
+{
+	BumpBlock  *block = dlist_head_element(BumpBlock, node, &set->blocks);
+
+	return (char *) BumpChunkGetPointer(chunk) + chunk->size == block->freeptr &&
+		(char *) chunk >= (char *) block + Bump_BLOCKHDRSZ;
+}
+
+/*
+ * BumpFree
+ *		Release a chunk's block if it has one of its own; give the space
+ *		back if it's the last chunk in the current block; otherwise leave
+ *		the space alone until the next reset.
+ */
+static void
+BumpFree(MemoryContext context, void *pointer)
+{
+	BumpContext *set = (BumpContext *) context;
+	BumpChunk  *chunk = BumpPointerGetChunk(pointer);
+
+	/* Allow access to private part of chunk header. */
+	VALGRIND_MAKE_MEM_DEFINED(chunk, BUMPCHUNK_PRIVATE_LEN);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Test for someone scribbling on unused space in chunk */
+	if (chunk->requested_size < chunk->size)
+		if (!sentinel_ok(pointer, chunk->requested_size))
+			elog(WARNING, "detected write past chunk end in %s %p",
+				 set->header.name, chunk);
+#endif
+
+	if (chunk->size > set->allocChunkLimit)
+	{
+		/* Big chunk, release its block */
+		BumpBlock  *block = BumpLargeChunkGetBlock(chunk);
+
+		dlist_delete(&block->node);
+
+		context->mem_allocated -= block->endptr - ((char *) block);
+		MemoryContextCountFree(block->endptr - ((char *) block));
+
+#ifdef CLOBBER_FREED_MEMORY
+		wipe_mem(block, block->freeptr - ((char *) block));
+#endif
+		free(block);
+		return;
+	}
+
+	if (BumpChunkIsLast(set, chunk))
+	{
+		/* Give the space back to the current block */
+		dlist_head_element(BumpBlock, node, &set->blocks)->freeptr =
+			(char *) chunk;
+
+#ifdef CLOBBER_FREED_MEMORY
+		wipe_mem(chunk, Bump_CHUNKHDRSZ + chunk->size);
+#else
+		VALGRIND_MAKE_MEM_NOACCESS(chunk, Bump_CHUNKHDRSZ + chunk->size);
+#endif
+		return;
+	}
+
+#ifdef CLOBBER_FREED_MEMORY
+	wipe_mem(pointer, chunk->size);
+#endif
+
+	/* Reset context to NULL in freed chunks */
+	chunk->context = NULL;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Reset requested_size to 0 in freed chunks */
+	chunk->requested_size = 0;
+#endif
+}
+
+/*
+ * BumpRealloc
+ *		When handling repalloc, we allocate a new chunk, copy the data and
+ *		discard the old one, unless the new size fits into the old chunk, or
+ *		the old chunk is the last one in the current block and that block
+ *		has room to grow it in place.
+ */
+static void *
+BumpRealloc(MemoryContext context, void *pointer, Size size)
+{
+	BumpContext *set = (BumpContext *) context;
+	BumpChunk  *chunk = BumpPointerGetChunk(pointer);
+	BumpPointer newPointer;
+	Size		oldsize;
+	Size		chunk_size = MAXALIGN(size);
+
+	/* Allow access to private part of chunk header. */
+	VALGRIND_MAKE_MEM_DEFINED(chunk, BUMPCHUNK_PRIVATE_LEN);
+
+	oldsize = chunk->size;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Test for someone scribbling on unused space in chunk */
+	if (chunk->requested_size < oldsize)
+		if (!sentinel_ok(pointer, chunk->requested_size))
+			elog(WARNING, "detected write past chunk end in %s %p",
+				 set->header.name, chunk);
+#endif
+
+	/*
+	 * A regular chunk at the end of the current block can grow (or shrink)
+	 * in place, as long as it remains a regular chunk.
+	 */
+	if (oldsize <= set->allocChunkLimit &&
+		chunk_size <= set->allocChunkLimit &&
+		BumpChunkIsLast(set, chunk))
+	{
+		BumpBlock  *block = dlist_head_element(BumpBlock, node, &set->blocks);
+
+		if ((Size) (block->endptr - (char *) pointer) >= chunk_size)
+		{
+			if (chunk_size < oldsize)
+				VALGRIND_MAKE_MEM_NOACCESS((char *) pointer + chunk_size,
+										   oldsize - chunk_size);
+			block->freeptr = (char *) pointer + chunk_size;
+			chunk->size = chunk_size;
+			oldsize = chunk_size;
+		}
+	}
+
+	/*
+	 * Maybe the allocated area already is >= the new size.  (In particular,
+	 * we always fall out here if the requested size is a decrease.)
+	 */
+	if (oldsize >= size)
+	{
+#ifdef MEMORY_CONTEXT_CHECKING
+		Size		oldrequest = chunk->requested_size;
+
+#ifdef RANDOMIZE_ALLOCATED_MEMORY
+		/* We can only fill the extra space if we know the prior request */
+		if (size > oldrequest)
+			randomize_mem((char *) pointer + oldrequest,
+						  size - oldrequest);
+#endif
+
+		chunk->requested_size = size;
+
+		/*
+		 * If this is an increase, mark any newly-available part UNDEFINED.
+		 * Otherwise, mark the obsolete part NOACCESS.
+		 */
+		if (size > oldrequest)
+			VALGRIND_MAKE_MEM_UNDEFINED((char *) pointer + oldrequest,
+										size - oldrequest);
+		else
+			VALGRIND_MAKE_MEM_NOACCESS((char *) pointer + size,
+									   oldsize - size);
+
+		/* set mark to catch clobber of "unused" space */
+		if (size < oldsize)
+			set_sentinel(pointer, size);
+#else							/* !MEMORY_CONTEXT_CHECKING */
+
+		/*
+		 * We don't have the information to determine whether we're growing
+		 * the old request or shrinking it, so we conservatively mark the
+		 * entire new allocation DEFINED.
+		 */
+		VALGRIND_MAKE_MEM_NOACCESS(pointer, oldsize);
+		VALGRIND_MAKE_MEM_DEFINED(pointer, size);
+#endif
+
+		/* Disallow external access to private part of chunk header. */
+		VALGRIND_MAKE_MEM_NOACCESS(chunk, BUMPCHUNK_PRIVATE_LEN);
+
+		return pointer;
+	}
+
+	/* allocate new chunk */
+	newPointer = BumpAlloc((MemoryContext) set, size);
+
+	/* leave immediately if request was not completed */
+	if (newPointer == NULL)
+	{
+		/* Disallow external access to private part of chunk header. */
+		VALGRIND_MAKE_MEM_NOACCESS(chunk, BUMPCHUNK_PRIVATE_LEN);
+		return NULL;
+	}
+
+	/*
+	 * BumpAlloc() may have returned a region that is still NOACCESS.  Change
+	 * it to UNDEFINED for the moment; memcpy() will then transfer definedness
+	 * from the old allocation to the new.  If we know the old allocation,
+	 * copy just that much.  Otherwise, make the entire old chunk defined to
+	 * avoid errors as we copy the currently-NOACCESS trailing bytes.
+	 */
+	VALGRIND_MAKE_MEM_UNDEFINED(newPointer, size);
+#ifdef MEMORY_CONTEXT_CHECKING
+	oldsize = chunk->requested_size;
+#else
+	VALGRIND_MAKE_MEM_DEFINED(pointer, oldsize);
+#endif
+
+	/* transfer existing data (certain to fit) */
+	memcpy(newPointer, pointer, oldsize);
+
+	/* free old chunk */
+	BumpFree((MemoryContext) set, pointer);
+
+	return newPointer;
+}
+
+/*
+ * BumpGetChunkSpace
+ *		Given a currently-allocated chunk, determine the total space
+ *		it occupies (including all memory-allocation overhead).
+ */
+static Size
+BumpGetChunkSpace(MemoryContext context, void *pointer)
+{
+	BumpChunk  *chunk = BumpPointerGetChunk(pointer);
+	Size		result;
+
+	VALGRIND_MAKE_MEM_DEFINED(chunk, BUMPCHUNK_PRIVATE_LEN);
+	result = chunk->size + Bump_CHUNKHDRSZ;
+	VALGRIND_MAKE_MEM_NOACCESS(chunk, BUMPCHUNK_PRIVATE_LEN);
+	return result;
+}
+
+/*
+ * BumpIsEmpty
+ *		Is a BumpContext empty of any allocated space?
+ */
+static bool
+BumpIsEmpty(MemoryContext context)
+{
+	BumpContext *set = (BumpContext *) context;
+
+	/*
+	 * For now, we say "empty" only if the context is new or just reset. We
+	 * could examine the blocks to determine if nothing's been allocated, but
+	 * it's not clear it's worth the trouble.
+	 */
+	if (context->isReset)
+		return true;
+
+	return dlist_head_node(&set->blocks) == &set->keeper->node &&
+		!dlist_has_next(&set->blocks, &set->keeper->node) &&
+		set->keeper->freeptr == ((char *) set->keeper) + Bump_BLOCKHDRSZ;
+}
+
+/*
+ * BumpStats
+ *		Compute stats about memory consumption of a Bump context.
+ *
+ * printfunc: if not NULL, pass a human-readable stats string to this.
+ * passthru: pass this pointer through to printfunc.
+ * totals: if not NULL, add stats about this context into *totals.
+ * print_to_stderr: print stats to stderr if true, elog otherwise.
+ *
+ * Free space only accounts for empty space at the end of the blocks, not
+ * the space of freed chunks, which is unknown.
+ */
+static void
+BumpStats(MemoryContext context,
+		  MemoryStatsPrintFunc printfunc, void *passthru,
+		  MemoryContextCounters *totals, bool print_to_stderr)
+{
+	BumpContext *set = (BumpContext *) context;
+	Size		nblocks = 0;
+	Size		totalspace;
+	Size		freespace = 0;
+	dlist_iter	iter;
+
+	/* Include context header in totalspace */
+	totalspace = MAXALIGN(sizeof(BumpContext));
+
+	dlist_foreach(iter, &set->blocks)
+	{
+		BumpBlock  *block = dlist_container(BumpBlock, node, iter.cur);
+
+		nblocks++;
+		totalspace += block->endptr - ((char *) block);
+		freespace += block->endptr - block->freeptr;
+	}
+
+	if (printfunc)
+	{
+		char		stats_string[200];
+
+		snprintf(stats_string, sizeof(stats_string),
+				 "%zu total in %zd blocks; %zu free; %zu used",
+				 totalspace, nblocks, freespace, totalspace - freespace);
+		printfunc(context, passthru, stats_string, print_to_stderr);
+	}
+
+	if (totals)
+	{
+		totals->nblocks += nblocks;
+		totals->totalspace += totalspace;
+		totals->freespace += freespace;
+	}
+}
+
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * BumpCheck
+ *		Walk through chunks and check consistency of memory.
+ *
+ * NOTE: report errors as WARNING, *not* ERROR or FATAL.  Otherwise you'll
+ * find yourself in an infinite loop when trouble occurs, because this
+ * routine will be entered again when elog cleanup tries to release memory!
+ */
+static void
+BumpCheck(MemoryContext context)
+{
+	BumpContext *set = (BumpContext *) context;
+	const char *name = context->name;
+	dlist_iter	iter;
+	Size		total_allocated = 0;
+
+	/* walk all blocks in this context */
+	dlist_foreach(iter, &set->blocks)
+	{
+		BumpBlock  *block = dlist_container(BumpBlock, node, iter.cur);
+		char	   *ptr;
+
+		if (block == set->keeper)
+			total_allocated += block->endptr - ((char *) set);
+		else
+			total_allocated += block->endptr - ((char *) block);
+
+		ptr = ((char *) block) + Bump_BLOCKHDRSZ;
+
+		while (ptr < block->freeptr)
+		{
+			BumpChunk  *chunk = (BumpChunk *) ptr;
+
+			/* Allow access to private part of chunk header. */
+			VALGRIND_MAKE_MEM_DEFINED(chunk, BUMPCHUNK_PRIVATE_LEN);
+
+			/* move to the next chunk */
+			ptr += (chunk->size + Bump_CHUNKHDRSZ);
+
+			if (ptr > block->freeptr)
+				elog(WARNING, "problem in Bump %s: bogus chunk size in block %p, chunk %p",
+					 name, block, chunk);
+
+			/*
+			 * Check for valid context pointer.  Note this is an incomplete
+			 * test, since palloc(0) produces an allocated chunk with
+			 * requested_size == 0.
+			 */
+			if ((chunk->requested_size > 0 && chunk->context != set) ||
+				(chunk->context != set && chunk->context != NULL))
+				elog(WARNING, "problem in Bump %s: bogus context link in block %p, chunk %p",
+					 name, block, chunk);
+
+			/* now make sure the chunk size is correct */
+			if (chunk->size < chunk->requested_size ||
+				chunk->size != MAXALIGN(chunk->size))
+				elog(WARNING, "problem in Bump %s: bogus chunk size in block %p, chunk %p",
+					 name, block, chunk);
+
+			/* check sentinel, but only in allocated chunks */
+			if (chunk->context != NULL &&
+				chunk->requested_size < chunk->size &&
+				!sentinel_ok(chunk, Bump_CHUNKHDRSZ + chunk->requested_size))
+				elog(WARNING, "problem in Bump %s: detected write past chunk end in block %p, chunk %p",
+					 name, block, chunk);
+
+			/*
+			 * If chunk is allocated, disallow external access to private part
+			 * of chunk header.
+			 */
+			if (chunk->context != NULL)
+				VALGRIND_MAKE_MEM_NOACCESS(chunk, BUMPCHUNK_PRIVATE_LEN);
+		}
+	}
+
+	Assert(total_allocated == context->mem_allocated);
+}
+
+#endif							/* MEMORY_CONTEXT_CHECKING */
@@ -63,7 +63,8 @@
  * The size of the initial DSM segment that backs a dsa_area created by
  * dsa_create.  After creating some number of segments of this size we'll
  * double this size, and so on.  Larger segments may be created if necessary
- * to satisfy large requests.
+ * to satisfy large requests, and the series can be made to start from a
+ * bigger size with dsa_set_min_segment_size().
  */
 #define DSA_INITIAL_SEGMENT_SIZE ((size_t) (1 * 1024 * 1024))
 
@@ -311,6 +312,8 @@ typedef struct
 	size_t		total_segment_size;
 	/* The maximum total size of backing storage we are allowed. */
 	size_t		max_total_segment_size;
+	/* The size that new segments grow geometrically from. */
+	size_t		init_segment_size;
 	/* Highest used segment index in the history of this area. */
 	dsa_segment_index high_segment_index;
 	/* The reference count for this area. */
@@ -1012,6 +1015,28 @@ dsa_set_size_limit(dsa_area *area, size_t limit)
 	LWLockRelease(DSA_AREA_LOCK(area));
 }
 
+/*
+ * Ask for the segments that this area creates from now on to be at least
+ * 'size' bytes, rounded down to a power of two.  The usual geometric growth
+ * continues from there, so a caller that expects the area to become large
+ * can have it reach that size with fewer, bigger segments instead of many
+ * dsm_create() calls.  This never makes segments smaller than they would
+ * otherwise have been.
+ */
+void
+dsa_set_min_segment_size(dsa_area *area, size_t size)
+{
+	size_t		segment_size = DSA_INITIAL_SEGMENT_SIZE;
+
+	while (segment_size < DSA_MAX_SEGMENT_SIZE && segment_size * 2 <= size)
+		segment_size *= 2;
+
+	LWLockAcquire(DSA_AREA_LOCK(area), LW_EXCLUSIVE);
+	if (segment_size > area->control->init_segment_size)
+		area->control->init_segment_size = segment_size;
+	LWLockRelease(DSA_AREA_LOCK(area));
+}
+
 /*
  * Aggressively free all spare memory in the hope of returning DSM segments to
  * the operating system.
@@ -1233,6 +1258,7 @@ create_internal(void *place, size_t size,
 	control->segment_header.size = DSA_INITIAL_SEGMENT_SIZE;
 	control->handle = control_handle;
 	control->max_total_segment_size = (size_t) -1;
+	control->init_segment_size = DSA_INITIAL_SEGMENT_SIZE;
 	control->total_segment_size = size;
 	control->segment_handles[0] = control_handle;
 	for (i = 0; i < DSA_NUM_SEGMENT_BINS; ++i)
@@ -2064,6 +2090,7 @@ make_new_segment(dsa_area *area, size_t requested_pages)
 	size_t		total_size;
 	size_t		total_pages;
 	size_t		usable_pages;
+	size_t		i;
 	dsa_segment_map *segment_map;
 	dsm_segment *segment;
 
@@ -2100,8 +2127,10 @@ make_new_segment(dsa_area *area, size_t requested_pages)
 	 * move to huge pages in the future.  Then we work back to the number of
 	 * pages we can fit.
 	 */
-	total_size = DSA_INITIAL_SEGMENT_SIZE *
-		((size_t) 1 << (new_index / DSA_NUM_SEGMENTS_AT_EACH_SIZE));
+	total_size = area->control->init_segment_size;
+	for (i = new_index / DSA_NUM_SEGMENTS_AT_EACH_SIZE;
+		 i > 0 && total_size < DSA_MAX_SEGMENT_SIZE; i--)
+		total_size *= 2;
 	total_size = Min(total_size, DSA_MAX_SEGMENT_SIZE);
 	total_size = Min(total_size,
 					 area->control->max_total_segment_size -
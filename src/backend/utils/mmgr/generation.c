@@ -283,6 +283,7 @@ GenerationReset(MemoryContext context)
 		dlist_delete(miter.cur);
 
 		context->mem_allocated -= block->blksize;
+		MemoryContextCountFree(block->blksize);
 
 #ifdef CLOBBER_FREED_MEMORY
 		wipe_mem(block, block->blksize);
@@ -340,6 +341,7 @@ GenerationAlloc(MemoryContext context, Size size)
 			return NULL;
 
 		context->mem_allocated += blksize;
+		MemoryContextCountAlloc(blksize);
 
 		/* block with a single (used) chunk */
 		block->blksize = blksize;
@@ -395,6 +397,7 @@ GenerationAlloc(MemoryContext context, Size size)
 			return NULL;
 
 		context->mem_allocated += blksize;
+		MemoryContextCountAlloc(blksize);
 
 		block->blksize = blksize;
 		block->nchunks = 0;
@@ -510,6 +513,7 @@ GenerationFree(MemoryContext context, void *pointer)
 		set->block = NULL;
 
 	context->mem_allocated -= block->blksize;
+	MemoryContextCountFree(block->blksize);
 	free(block);
 }
 
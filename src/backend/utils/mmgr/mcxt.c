@@ -56,6 +56,14 @@ MemoryContext CurTransactionContext = NULL;
 /* This is a transient link to the active portal's memory context: */
 MemoryContext PortalContext = NULL;
 
+/*
+ * Running total of block allocations made by the context implementations.
+ * It is kept in a local variable until the process has somewhere better to
+ * put it; see MemoryContextSetAllocatedBytesTarget().
+ */
+static int64 LocalAllocatedBytes = 0;
+int64	   *MemoryContextAllocatedBytes = &LocalAllocatedBytes;
+
 static void MemoryContextCallResetCallbacks(MemoryContext context);
 static void MemoryContextStatsInternal(MemoryContext context, int level,
 									   bool print, int max_children,
@@ -493,6 +501,25 @@ MemoryContextMemAllocated(MemoryContext context, bool recurse)
 	return total;
 }
 
+/*
+ * MemoryContextSetAllocatedBytesTarget
+ *		Keep the running total of allocated bytes in *target from now on,
+ *		or in process-local storage again if target is NULL.
+ *
+ * The current total is carried over, so the count stays exact across the
+ * switch.  This is not the place to worry about concurrent readers of
+ * *target; the caller must.
+ */
+void
+MemoryContextSetAllocatedBytesTarget(int64 *target)
+{
+	if (target == NULL)
+		target = &LocalAllocatedBytes;
+
+	*target = *MemoryContextAllocatedBytes;
+	MemoryContextAllocatedBytes = target;
+}
+
 /*
  * MemoryContextStats
  *		Print statistics about the named context and all its descendants.
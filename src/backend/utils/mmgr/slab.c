@@ -309,6 +309,7 @@ SlabReset(MemoryContext context)
 			free(block);
 			slab->nblocks--;
 			context->mem_allocated -= slab->blockSize;
+			MemoryContextCountFree(slab->blockSize);
 		}
 	}
 
@@ -394,6 +395,7 @@ SlabAlloc(MemoryContext context, Size size)
 		slab->minFreeChunks = slab->chunksPerBlock;
 		slab->nblocks += 1;
 		context->mem_allocated += slab->blockSize;
+		MemoryContextCountAlloc(slab->blockSize);
 	}
 
 	/* grab the block from the freelist (even the new block is there) */
@@ -561,6 +563,7 @@ SlabFree(MemoryContext context, void *pointer)
 		free(block);
 		slab->nblocks--;
 		context->mem_allocated -= slab->blockSize;
+		MemoryContextCountFree(slab->blockSize);
 	}
 	else
 		dlist_push_head(&slab->freelist[block->nfree], &block->node);
@@ -339,6 +339,16 @@ ltsReadFillBuffer(LogicalTapeSet *lts, LogicalTape *lt)
 		/* Advance to next block, if we have buffer space left */
 	} while (lt->buffer_size - lt->nbytes > BLCKSZ);
 
+	/*
+	 * Ask the kernel to start reading the block that will begin the next
+	 * refill, so that the I/O overlaps with the caller consuming this
+	 * bufferload.  Blocks of a tape tend to be scattered through the file,
+	 * so kernel read-ahead can't be relied on to do this for us.
+	 */
+	if (lt->nextBlockNumber != -1L)
+		BufFilePrefetchBlock(lts->pfile,
+							 lt->nextBlockNumber + lt->offsetBlockNumber);
+
 	return (lt->nbytes > 0);
 }
 
@@ -101,10 +101,12 @@
 #include "access/nbtree.h"
 #include "catalog/index.h"
 #include "catalog/pg_am.h"
+#include "commands/progress.h"
 #include "commands/tablespace.h"
 #include "executor/executor.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
+#include "utils/backend_progress.h"
 #include "utils/datum.h"
 #include "utils/logtape.h"
 #include "utils/lsyscache.h"
@@ -429,6 +431,13 @@ struct Tuplesortstate
 	TupleDesc	tupDesc;
 	SortSupport sortKeys;		/* array of length nKeys */
 
+	/*
+	 * Does SortTuple.datum1 hold the leading sort key?  This is not the case
+	 * for hash index sorts, nor for CLUSTER on an expression index.  The
+	 * specialized qsort routines below depend on it.
+	 */
+	bool		haveDatum1;
+
 	/*
 	 * This variable is shared by the single-key MinimalTuple case and the
 	 * Datum case (which both use qsort_ssup()).  Otherwise it's NULL.
@@ -669,14 +678,107 @@ static void free_sort_tuple(Tuplesortstate *state, SortTuple *stup);
 static void tuplesort_free(Tuplesortstate *state);
 static void tuplesort_updatemax(Tuplesortstate *state);
 
+/*
+ * Specialized comparators for the leading key of SortTuples whose sortsupport
+ * comparator is one of the ssup_datum_*_cmp() routines below.  These compare
+ * datum1 inline, falling back to the full comparetup routine only on ties,
+ * and only when there are further keys to look at.
+ */
+static pg_attribute_always_inline int
+qsort_tuple_unsigned_compare(SortTuple *a, SortTuple *b, Tuplesortstate *state)
+{
+	int			compare;
+
+	compare = ApplyUnsignedSortComparator(a->datum1, a->isnull1,
+										  b->datum1, b->isnull1,
+										  &state->sortKeys[0]);
+	if (compare != 0)
+		return compare;
+
+	/* no need to call the tiebreak function if there are no other keys */
+	if (state->onlyKey != NULL)
+		return 0;
+
+	return state->comparetup(a, b, state);
+}
+
+#if SIZEOF_DATUM >= 8
+static pg_attribute_always_inline int
+qsort_tuple_signed_compare(SortTuple *a, SortTuple *b, Tuplesortstate *state)
+{
+	int			compare;
+
+	compare = ApplySignedSortComparator(a->datum1, a->isnull1,
+										b->datum1, b->isnull1,
+										&state->sortKeys[0]);
+	if (compare != 0)
+		return compare;
+
+	/* no need to call the tiebreak function if there are no other keys */
+	if (state->onlyKey != NULL)
+		return 0;
+
+	return state->comparetup(a, b, state);
+}
+#endif
+
+static pg_attribute_always_inline int
+qsort_tuple_int32_compare(SortTuple *a, SortTuple *b, Tuplesortstate *state)
+{
+	int			compare;
+
+	compare = ApplyInt32SortComparator(a->datum1, a->isnull1,
+									   b->datum1, b->isnull1,
+									   &state->sortKeys[0]);
+	if (compare != 0)
+		return compare;
+
+	/* no need to call the tiebreak function if there are no other keys */
+	if (state->onlyKey != NULL)
+		return 0;
+
+	return state->comparetup(a, b, state);
+}
+
 /*
  * Special versions of qsort just for SortTuple objects.  qsort_tuple() sorts
  * any variant of SortTuples, using the appropriate comparetup function.
  * qsort_ssup() is specialized for the case where the comparetup function
  * reduces to ApplySortComparator(), that is single-key MinimalTuple sorts
- * and Datum sorts.
+ * and Datum sorts.  The qsort_tuple_unsigned/signed/int32 variants inline
+ * the leading-key comparison for the common integer-like comparators, see
+ * tuplesort_sort_memtuples().
  */
 
+#define ST_SORT qsort_tuple_unsigned
+#define ST_ELEMENT_TYPE SortTuple
+#define ST_COMPARE(a, b, state) qsort_tuple_unsigned_compare(a, b, state)
+#define ST_COMPARE_ARG_TYPE Tuplesortstate
+#define ST_CHECK_FOR_INTERRUPTS
+#define ST_SCOPE static
+#define ST_DEFINE
+#include "lib/sort_template.h"
+
+#if SIZEOF_DATUM >= 8
+#define ST_SORT qsort_tuple_signed
+#define ST_ELEMENT_TYPE SortTuple
+#define ST_COMPARE(a, b, state) qsort_tuple_signed_compare(a, b, state)
+#define ST_COMPARE_ARG_TYPE Tuplesortstate
+#define ST_CHECK_FOR_INTERRUPTS
+#define ST_SCOPE static
+#define ST_DEFINE
+#include "lib/sort_template.h"
+#endif
+
+#define ST_SORT qsort_tuple_int32
+#define ST_ELEMENT_TYPE SortTuple
+#define ST_COMPARE(a, b, state) qsort_tuple_int32_compare(a, b, state)
+#define ST_COMPARE_ARG_TYPE Tuplesortstate
+#define ST_CHECK_FOR_INTERRUPTS
+#define ST_SCOPE static
+#define ST_DEFINE
+#include "lib/sort_template.h"
+
 #define ST_SORT qsort_tuple
 #define ST_ELEMENT_TYPE SortTuple
 #define ST_COMPARE_RUNTIME_POINTER
@@ -853,6 +955,10 @@ tuplesort_begin_batch(Tuplesortstate *state)
 	state->bounded = false;
 	state->boundUsed = false;
 
+	pgstat_progress_query_set(PROGRESS_QUERY_SORT_PHASE,
+							  PROGRESS_QUERY_SORT_PHASE_LOADING);
+	pgstat_progress_query_set(PROGRESS_QUERY_SORT_TUPLES, 0);
+
 	state->availMem = state->allowedMem;
 
 	state->tapeset = NULL;
@@ -929,6 +1035,7 @@ tuplesort_begin_heap(TupleDesc tupDesc,
 	state->copytup = copytup_heap;
 	state->writetup = writetup_heap;
 	state->readtup = readtup_heap;
+	state->haveDatum1 = true;
 
 	state->tupDesc = tupDesc;	/* assume we need not copy tupDesc */
 	state->abbrevNext = 10;
@@ -1008,6 +1115,9 @@ tuplesort_begin_cluster(TupleDesc tupDesc,
 
 	state->indexInfo = BuildIndexInfo(indexRel);
 
+	/* datum1 is only set up if the leading key is a simple column */
+	state->haveDatum1 = (state->indexInfo->ii_IndexAttrNumbers[0] != 0);
+
 	state->tupDesc = tupDesc;	/* assume we need not copy tupDesc */
 
 	indexScanKey = _bt_mkscankey(indexRel, NULL);
@@ -1099,6 +1209,7 @@ tuplesort_begin_index_btree(Relation heapRel,
 	state->copytup = copytup_index;
 	state->writetup = writetup_index;
 	state->readtup = readtup_index;
+	state->haveDatum1 = true;
 	state->abbrevNext = 10;
 
 	state->heapRel = heapRel;
@@ -1213,6 +1324,7 @@ tuplesort_begin_index_gist(Relation heapRel,
 	state->copytup = copytup_index;
 	state->writetup = writetup_index;
 	state->readtup = readtup_index;
+	state->haveDatum1 = true;
 
 	state->heapRel = heapRel;
 	state->indexRel = indexRel;
@@ -1276,6 +1388,7 @@ tuplesort_begin_datum(Oid datumType, Oid sortOperator, Oid sortCollation,
 	state->copytup = copytup_datum;
 	state->writetup = writetup_datum;
 	state->readtup = readtup_datum;
+	state->haveDatum1 = true;
 	state->abbrevNext = 10;
 
 	state->datumType = datumType;
@@ -1888,6 +2001,8 @@ puttuple_common(Tuplesortstate *state, SortTuple *tuple)
 {
 	Assert(!LEADER(state));
 
+	pgstat_progress_query_incr(PROGRESS_QUERY_SORT_TUPLES, 1);
+
 	switch (state->status)
 	{
 		case TSS_INITIAL:
@@ -2047,6 +2162,9 @@ tuplesort_performsort(Tuplesortstate *state)
 			 state->worker, pg_rusage_show(&state->ru_start));
 #endif
 
+	pgstat_progress_query_set(PROGRESS_QUERY_SORT_PHASE,
+							  PROGRESS_QUERY_SORT_PHASE_SORTING);
+
 	switch (state->status)
 	{
 		case TSS_INITIAL:
@@ -2112,6 +2230,8 @@ tuplesort_performsort(Tuplesortstate *state)
 			 * Note that mergeruns sets the correct state->status.
 			 */
 			dumptuples(state, true);
+			pgstat_progress_query_set(PROGRESS_QUERY_SORT_PHASE,
+									  PROGRESS_QUERY_SORT_PHASE_MERGING);
 			mergeruns(state);
 			state->eof_reached = false;
 			state->markpos_block = 0L;
@@ -2137,6 +2257,9 @@ tuplesort_performsort(Tuplesortstate *state)
 	}
 #endif
 
+	pgstat_progress_query_set(PROGRESS_QUERY_SORT_PHASE,
+							  PROGRESS_QUERY_SORT_PHASE_RETURNING);
+
 	MemoryContextSwitchTo(oldcontext);
 }
 
@@ -2690,6 +2813,8 @@ inittapes(Tuplesortstate *state, bool mergeruns)
 	state->destTape = 0;
 
 	state->status = TSS_BUILDRUNS;
+	pgstat_progress_query_set(PROGRESS_QUERY_SORT_PHASE,
+							  PROGRESS_QUERY_SORT_PHASE_WRITING_RUNS);
 }
 
 /*
@@ -3558,6 +3683,37 @@ tuplesort_sort_memtuples(Tuplesortstate *state)
 
 	if (state->memtupcount > 1)
 	{
+		/*
+		 * Do we have the leading column's value or abbreviation in datum1,
+		 * and is there a specialization for its comparator?
+		 */
+		if (state->haveDatum1 && state->sortKeys)
+		{
+			if (state->sortKeys[0].comparator == ssup_datum_unsigned_cmp)
+			{
+				qsort_tuple_unsigned(state->memtuples,
+									 state->memtupcount,
+									 state);
+				return;
+			}
+#if SIZEOF_DATUM >= 8
+			else if (state->sortKeys[0].comparator == ssup_datum_signed_cmp)
+			{
+				qsort_tuple_signed(state->memtuples,
+								   state->memtupcount,
+								   state);
+				return;
+			}
+#endif
+			else if (state->sortKeys[0].comparator == ssup_datum_int32_cmp)
+			{
+				qsort_tuple_int32(state->memtuples,
+								  state->memtupcount,
+								  state);
+				return;
+			}
+		}
+
 		/* Can we use the single-key sort function? */
 		if (state->onlyKey != NULL)
 			qsort_ssup(state->memtuples, state->memtupcount,
@@ -4776,3 +4932,49 @@ free_sort_tuple(Tuplesortstate *state, SortTuple *stup)
 	FREEMEM(state, GetMemoryChunkSpace(stup->tuple));
 	pfree(stup->tuple);
 }
+
+/*
+ * Datum comparison functions that we have specialized sort routines for.
+ * Datatypes that install these as their comparator or abbreviated comparator
+ * are eligible for faster sorting.
+ */
+int
+ssup_datum_unsigned_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	if (x < y)
+		return -1;
+	else if (x > y)
+		return 1;
+	else
+		return 0;
+}
+
+#if SIZEOF_DATUM >= 8
+int
+ssup_datum_signed_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	int64		xx = DatumGetInt64(x);
+	int64		yy = DatumGetInt64(y);
+
+	if (xx < yy)
+		return -1;
+	else if (xx > yy)
+		return 1;
+	else
+		return 0;
+}
+#endif
+
+int
+ssup_datum_int32_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	int32		xx = DatumGetInt32(x);
+	int32		yy = DatumGetInt32(y);
+
+	if (xx < yy)
+		return -1;
+	else if (xx > yy)
+		return 1;
+	else
+		return 0;
+}
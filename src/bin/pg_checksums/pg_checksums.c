@@ -48,6 +48,9 @@ typedef enum
 	PG_MODE_ENABLE
 } PgChecksumMode;
 
+/* number of blocks scan_file() reads at a time */
+#define SCAN_CHUNK_BLOCKS	128
+
 /*
  * Filename components.
  *
@@ -190,10 +193,9 @@ skipfile(const char *fn)
 static void
 scan_file(const char *fn, BlockNumber segmentno)
 {
-	PGAlignedBlock buf;
-	PageHeader	header = (PageHeader) buf.data;
+	static char *chunk = NULL;
 	int			f;
-	BlockNumber blockno;
+	BlockNumber blockno = 0;
 	int			flags;
 
 	Assert(mode == PG_MODE_ENABLE ||
@@ -210,78 +212,90 @@ scan_file(const char *fn, BlockNumber segmentno)
 
 	files++;
 
-	for (blockno = 0;; blockno++)
+	/* malloc'd memory is aligned well enough for page headers */
+	if (chunk == NULL)
+		chunk = pg_malloc(SCAN_CHUNK_BLOCKS * BLCKSZ);
+
+	for (;;)
 	{
-		uint16		csum;
-		int			r = read(f, buf.data, BLCKSZ);
+		int			r = read(f, chunk, SCAN_CHUNK_BLOCKS * BLCKSZ);
+		int			nblocks;
 
 		if (r == 0)
 			break;
-		if (r != BLCKSZ)
+		if (r < 0)
 		{
-			if (r < 0)
-				pg_log_error("could not read block %u in file \"%s\": %m",
-							 blockno, fn);
-			else
-				pg_log_error("could not read block %u in file \"%s\": read %d of %d",
-							 blockno, fn, r, BLCKSZ);
+			pg_log_error("could not read block %u in file \"%s\": %m",
+						 blockno, fn);
 			exit(1);
 		}
-		blocks++;
-
-		/*
-		 * Since the file size is counted as total_size for progress status
-		 * information, the sizes of all pages including new ones in the file
-		 * should be counted as current_size. Otherwise the progress reporting
-		 * calculated using those counters may not reach 100%.
-		 */
-		current_size += r;
 
-		/* New pages have no checksum yet */
-		if (PageIsNew(header))
-			continue;
+		/* Process the complete blocks; a partial one is complained about below */
+		nblocks = r / BLCKSZ;
 
-		csum = pg_checksum_page(buf.data, blockno + segmentno * RELSEG_SIZE);
-		if (mode == PG_MODE_CHECK)
+		for (int i = 0; i < nblocks; i++, blockno++)
 		{
-			if (csum != header->pd_checksum)
-			{
-				if (ControlFile->data_checksum_version == PG_DATA_CHECKSUM_VERSION)
-					pg_log_error("checksum verification failed in file \"%s\", block %u: calculated checksum %X but block contains %X",
-								 fn, blockno, csum, header->pd_checksum);
-				badblocks++;
-			}
-		}
-		else if (mode == PG_MODE_ENABLE)
-		{
-			int			w;
+			char	   *page = chunk + i * BLCKSZ;
+			PageHeader	header = (PageHeader) page;
+			uint16		csum;
+
+			blocks++;
+
+			/*
+			 * Since the file size is counted as total_size for progress
+			 * status information, the sizes of all pages including new ones
+			 * in the file should be counted as current_size. Otherwise the
+			 * progress reporting calculated using those counters may not
+			 * reach 100%.
+			 */
+			current_size += BLCKSZ;
 
-			/* Set checksum in page header */
-			header->pd_checksum = csum;
+			/* New pages have no checksum yet */
+			if (PageIsNew(header))
+				continue;
 
-			/* Seek back to beginning of block */
-			if (lseek(f, -BLCKSZ, SEEK_CUR) < 0)
+			csum = pg_checksum_page(page, blockno + segmentno * RELSEG_SIZE);
+			if (mode == PG_MODE_CHECK)
 			{
-				pg_log_error("seek failed for block %u in file \"%s\": %m", blockno, fn);
-				exit(1);
+				if (csum != header->pd_checksum)
+				{
+					if (ControlFile->data_checksum_version == PG_DATA_CHECKSUM_VERSION)
+						pg_log_error("checksum verification failed in file \"%s\", block %u: calculated checksum %X but block contains %X",
+									 fn, blockno, csum, header->pd_checksum);
+					badblocks++;
+				}
 			}
-
-			/* Write block with checksum */
-			w = write(f, buf.data, BLCKSZ);
-			if (w != BLCKSZ)
+			else if (mode == PG_MODE_ENABLE)
 			{
-				if (w < 0)
-					pg_log_error("could not write block %u in file \"%s\": %m",
-								 blockno, fn);
-				else
-					pg_log_error("could not write block %u in file \"%s\": wrote %d of %d",
-								 blockno, fn, w, BLCKSZ);
-				exit(1);
+				int			w;
+
+				/* Set checksum in page header */
+				header->pd_checksum = csum;
+
+				/* Write block with checksum, in place */
+				w = pg_pwrite(f, page, BLCKSZ, (off_t) blockno * BLCKSZ);
+				if (w != BLCKSZ)
+				{
+					if (w < 0)
+						pg_log_error("could not write block %u in file \"%s\": %m",
+									 blockno, fn);
+					else
+						pg_log_error("could not write block %u in file \"%s\": wrote %d of %d",
+									 blockno, fn, w, BLCKSZ);
+					exit(1);
+				}
 			}
+
+			if (showprogress)
+				progress_report(false);
 		}
 
-		if (showprogress)
-			progress_report(false);
+		if (r % BLCKSZ != 0)
+		{
+			pg_log_error("could not read block %u in file \"%s\": read %d of %d",
+						 blockno, fn, r % BLCKSZ, BLCKSZ);
+			exit(1);
+		}
 	}
 
 	if (verbose)
@@ -149,6 +149,8 @@ typedef struct _dumpOptions
 	bool		aclsSkip;
 	const char *lockWaitTimeout;
 	int			dump_inserts;	/* 0 = COPY, otherwise rows per INSERT */
+	int			split_table_size;	/* split data of larger tables, in MB;
+									 * 0 = don't split */
 
 	/* flags for various command-line long options */
 	int			disable_dollar_quoting;
@@ -135,6 +135,7 @@ static void mark_restore_job_done(ArchiveHandle *AH,
 								  void *callback_data);
 static void fix_dependencies(ArchiveHandle *AH);
 static bool has_lock_conflicts(TocEntry *te1, TocEntry *te2);
+static bool is_sibling_index(TocEntry *te1, TocEntry *te2);
 static void repoint_table_dependencies(ArchiveHandle *AH);
 static void identify_locking_dependencies(ArchiveHandle *AH, TocEntry *te);
 static void reduce_dependencies(ArchiveHandle *AH, TocEntry *te,
@@ -1851,6 +1852,13 @@ buildTocEntryArrays(ArchiveHandle *AH)
 			if (tableId <= 0 || tableId > maxDumpId)
 				fatal("bad table dumpId for TABLE DATA item");
 
+			/*
+			 * If pg_dump split the table's data into several items, chain
+			 * them together; tableDataId points to the last one.
+			 */
+			if (AH->tableDataId[tableId] != 0)
+				te->nextTableData = AH->tocsByDumpId[AH->tableDataId[tableId]];
+
 			AH->tableDataId[tableId] = te->dumpId;
 		}
 	}
@@ -4160,6 +4168,34 @@ has_lock_conflicts(TocEntry *te1, TocEntry *te2)
 	return false;
 }
 
+/*
+ * Check if te1 and te2 are both indexes, apparently on the same table.
+ *
+ * We don't know the table for sure, but an INDEX item depends on its table
+ * (or, after repoint_table_dependencies, the table's data), so two indexes
+ * sharing a dependency are most likely on the same table.  This is only
+ * used as a scheduling hint, so an occasional mistake doesn't matter.
+ */
+static bool
+is_sibling_index(TocEntry *te1, TocEntry *te2)
+{
+	int			j,
+				k;
+
+	if (strcmp(te1->desc, "INDEX") != 0 || strcmp(te2->desc, "INDEX") != 0)
+		return false;
+
+	for (j = 0; j < te1->nDeps; j++)
+	{
+		for (k = 0; k < te2->nDeps; k++)
+		{
+			if (te1->dependencies[j] == te2->dependencies[k])
+				return true;
+		}
+	}
+	return false;
+}
+
 
 /*
  * Initialize the header of the pending-items list.
@@ -4330,11 +4366,18 @@ move_to_ready_list(TocEntry *pending_list,
  * and no requirements for locks that are incompatible with
  * items currently running.  Items in the ready_list are known to have
  * no remaining dependencies, but we have to check for lock conflicts.
+ *
+ * Among the items that qualify, we prefer an index build on a table that
+ * already has an index being built.  The builds don't block each other, and
+ * running them together lets synchronized scans read the table's heap once
+ * for all of them, rather than once per index at different times.
  */
 static TocEntry *
 pop_next_work_item(ParallelReadyList *ready_list,
 				   ParallelState *pstate)
 {
+	int			chosen = -1;
+
 	/*
 	 * Sort the ready_list so that we'll tackle larger jobs first.
 	 */
@@ -4347,6 +4390,19 @@ pop_next_work_item(ParallelReadyList *ready_list,
 	{
 		TocEntry   *te = ready_list->tes[i];
 		bool		conflicts = false;
+		bool		sibling = false;
+
+		/*
+		 * Indexes on the same table have the same dataLength (see
+		 * repoint_table_dependencies), so they are next to each other in the
+		 * sorted list.  Once we have a candidate, there is no point in
+		 * looking past the items of its size for a sibling index, nor at
+		 * indexes of empty tables.
+		 */
+		if (chosen >= 0 &&
+			(te->dataLength == 0 ||
+			 te->dataLength != ready_list->tes[chosen]->dataLength))
+			break;
 
 		/*
 		 * Check to see if the item would need exclusive lock on something
@@ -4365,13 +4421,30 @@ pop_next_work_item(ParallelReadyList *ready_list,
 				conflicts = true;
 				break;
 			}
+			if (is_sibling_index(te, running_te))
+				sibling = true;
 		}
 
 		if (conflicts)
 			continue;
 
 		/* passed all tests, so this item can run */
-		ready_list_remove(ready_list, i);
+		if (chosen < 0)
+			chosen = i;
+
+		/* ... but keep looking for a sibling index unless this is one */
+		if (sibling)
+		{
+			chosen = i;
+			break;
+		}
+	}
+
+	if (chosen >= 0)
+	{
+		TocEntry   *te = ready_list->tes[chosen];
+
+		ready_list_remove(ready_list, chosen);
 		return te;
 	}
 
@@ -4606,6 +4679,19 @@ repoint_table_dependencies(ArchiveHandle *AH)
 				te->dataLength = Max(te->dataLength, tabledatate->dataLength);
 				pg_log_debug("transferring dependency %d -> %d to %d",
 							 te->dumpId, olddep, tabledataid);
+
+				/* if the data was split, we must wait for all of it */
+				for (tabledatate = tabledatate->nextTableData;
+					 tabledatate != NULL;
+					 tabledatate = tabledatate->nextTableData)
+				{
+					te->dependencies = (DumpId *)
+						pg_realloc(te->dependencies,
+								   (te->nDeps + 1) * sizeof(DumpId));
+					te->dependencies[te->nDeps++] = tabledatate->dumpId;
+					pg_log_debug("transferring dependency %d -> %d to %d",
+								 te->dumpId, olddep, tabledatate->dumpId);
+				}
 			}
 		}
 	}
@@ -4727,7 +4813,12 @@ mark_create_done(ArchiveHandle *AH, TocEntry *te)
 	{
 		TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
 
-		ted->created = true;
+		/*
+		 * The TRUNCATE that this allows would remove the other parts of a
+		 * table whose data was split, so don't bother in that case.
+		 */
+		if (ted->nextTableData == NULL)
+			ted->created = true;
 	}
 }
 
@@ -4743,9 +4834,12 @@ inhibit_data_for_failed_table(ArchiveHandle *AH, TocEntry *te)
 
 	if (AH->tableDataId[te->dumpId] != 0)
 	{
-		TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
+		TocEntry   *ted;
 
-		ted->reqs = 0;
+		for (ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
+			 ted != NULL;
+			 ted = ted->nextTableData)
+			ted->reqs = 0;
 	}
 }
 
@@ -395,6 +395,8 @@ struct _tocEntry
 	pgoff_t		dataLength;		/* item's data size; 0 if none or unknown */
 	int			reqs;			/* do we need schema and/or data of object (REQ_* bit mask) */
 	bool		created;		/* set for DATA member if TABLE was created */
+	struct _tocEntry *nextTableData;	/* another DATA member of the same
+										 * TABLE, if its data was split */
 
 	/* working state (needed only for parallel restore) */
 	struct _tocEntry *pending_prev; /* list links for pending-items list; */
@@ -131,6 +131,9 @@ static const CatalogId nilCatalogId = {0, 0};
 static bool have_extra_float_digits = false;
 static int	extra_float_digits;
 
+/* --split-table-size in server blocks, or 0 if we don't split table data */
+static BlockNumber split_table_blocks = 0;
+
 /*
  * The default number of rows per INSERT when
  * --inserts is specified without --rows-per-insert
@@ -247,6 +250,7 @@ static void addConstrChildIdxDeps(DumpableObject *dobj, const IndxInfo *refidx);
 static void getDomainConstraints(Archive *fout, TypeInfo *tyinfo);
 static void getTableData(DumpOptions *dopt, TableInfo *tblinfo, int numTables, char relkind);
 static void makeTableDataInfo(DumpOptions *dopt, TableInfo *tbinfo);
+static void splitTableDataInfo(TableInfo *tbinfo);
 static void buildMatViewRefreshDependencies(Archive *fout);
 static void getTableDataFKConstraints(void);
 static char *format_function_arguments(const FuncInfo *finfo, const char *funcargs,
@@ -323,6 +327,7 @@ main(int argc, char **argv)
 	const char *dumpsnapshot = NULL;
 	char	   *use_role = NULL;
 	long		rowsPerInsert;
+	long		splitTableSize;
 	int			numWorkers = 1;
 	int			compressLevel = -1;
 	int			plainText = 0;
@@ -397,6 +402,7 @@ main(int argc, char **argv)
 		{"on-conflict-do-nothing", no_argument, &dopt.do_nothing, 1},
 		{"rows-per-insert", required_argument, NULL, 10},
 		{"include-foreign-data", required_argument, NULL, 11},
+		{"split-table-size", required_argument, NULL, 12},
 
 		{NULL, 0, NULL, 0}
 	};
@@ -619,6 +625,21 @@ main(int argc, char **argv)
 										  optarg);
 				break;
 
+			case 12:			/* split table size */
+				errno = 0;
+				splitTableSize = strtol(optarg, &endptr, 10);
+
+				if (endptr == optarg || *endptr != '\0' ||
+					splitTableSize <= 0 || splitTableSize > INT_MAX ||
+					errno == ERANGE)
+				{
+					pg_log_error("split-table-size must be in range %d..%d",
+								 1, INT_MAX);
+					exit_nicely(1);
+				}
+				dopt.split_table_size = (int) splitTableSize;
+				break;
+
 			default:
 				fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
 				exit_nicely(1);
@@ -869,6 +890,31 @@ main(int argc, char **argv)
 	if (fout->remoteVersion < 80400)
 		guessConstraintInheritance(tblinfo, numTables);
 
+	/*
+	 * Splitting table data by block ranges is only worthwhile if the server
+	 * can scan a range of blocks, which it can since 14.  The block size is
+	 * the server's, not ours.
+	 */
+	if (dopt.split_table_size > 0 && !dopt.schemaOnly)
+	{
+		if (fout->remoteVersion >= 140000)
+		{
+			PGresult   *res;
+			int			blocksize;
+
+			res = ExecuteSqlQueryForSingleRow(fout,
+											  "SELECT current_setting('block_size')");
+			blocksize = atoi(PQgetvalue(res, 0, 0));
+			PQclear(res);
+
+			split_table_blocks = (BlockNumber)
+				Min((uint64) dopt.split_table_size * 1024 * 1024 / blocksize,
+					MaxBlockNumber);
+		}
+		else
+			pg_log_warning("option --split-table-size is ignored for servers older than 14");
+	}
+
 	if (!dopt.schemaOnly)
 	{
 		getTableData(&dopt, tblinfo, numTables, 0);
@@ -1078,6 +1124,7 @@ help(const char *progname)
 	printf(_("  --section=SECTION            dump named section (pre-data, data, or post-data)\n"));
 	printf(_("  --serializable-deferrable    wait until the dump can run without anomalies\n"));
 	printf(_("  --snapshot=SNAPSHOT          use given snapshot for the dump\n"));
+	printf(_("  --split-table-size=MB        dump data of larger tables in parts of this size\n"));
 	printf(_("  --strict-names               require table and/or schema include patterns to\n"
 			 "                               match at least one entity each\n"));
 	printf(_("  --use-set-session-authorization\n"
@@ -1977,7 +2024,8 @@ dumpTableData_copy(Archive *fout, const void *dcontext)
 		else
 			appendPQExpBufferStr(q, "* ");
 
-		appendPQExpBuffer(q, "FROM %s %s) TO stdout;",
+		appendPQExpBuffer(q, "FROM %s%s %s) TO stdout;",
+						  tdinfo->split ? "ONLY " : "",
 						  fmtQualifiedDumpable(tbinfo),
 						  tdinfo->filtercond ? tdinfo->filtercond : "");
 	}
@@ -2413,9 +2461,12 @@ dumpTableData(Archive *fout, const TableDataInfo *tdinfo)
 		 * However, relpages is declared as "integer" in pg_class, and hence
 		 * also in TableInfo, but it's really BlockNumber a/k/a unsigned int.
 		 * Cast so that we get the right interpretation of table sizes
-		 * exceeding INT_MAX pages.
+		 * exceeding INT_MAX pages.  The parts of a split table are all about
+		 * the same size.
 		 */
 		te->dataLength = (BlockNumber) tbinfo->relpages;
+		if (tdinfo->split)
+			te->dataLength = Min(te->dataLength, split_table_blocks);
 	}
 
 	destroyPQExpBuffer(copyBuf);
@@ -2473,7 +2524,19 @@ getTableData(DumpOptions *dopt, TableInfo *tblinfo, int numTables, char relkind)
 	{
 		if (tblinfo[i].dobj.dump & DUMP_COMPONENT_DATA &&
 			(!relkind || tblinfo[i].relkind == relkind))
+		{
+			/* config tables have their data set up already, never split */
+			if (tblinfo[i].dataObj != NULL)
+				continue;
+
 			makeTableDataInfo(dopt, &(tblinfo[i]));
+
+			if (tblinfo[i].dataObj != NULL &&
+				tblinfo[i].relkind == RELKIND_RELATION &&
+				split_table_blocks > 0 &&
+				(BlockNumber) tblinfo[i].relpages > split_table_blocks)
+				splitTableDataInfo(&(tblinfo[i]));
+		}
 	}
 }
 
@@ -2539,6 +2602,8 @@ makeTableDataInfo(DumpOptions *dopt, TableInfo *tbinfo)
 	tdinfo->dobj.namespace = tbinfo->dobj.namespace;
 	tdinfo->tdtable = tbinfo;
 	tdinfo->filtercond = NULL;	/* might get set later */
+	tdinfo->split = false;
+	tdinfo->nextpart = NULL;
 	addObjectDependency(&tdinfo->dobj, tbinfo->dobj.dumpId);
 
 	tbinfo->dataObj = tdinfo;
@@ -2547,6 +2612,56 @@ makeTableDataInfo(DumpOptions *dopt, TableInfo *tbinfo)
 	tbinfo->interesting = true;
 }
 
+/*
+ * Split the data of a large table into parts of split_table_blocks blocks
+ * each, by ranges of ctid, so that a parallel dump or restore can work on
+ * the parts at the same time.  The table's dataObj becomes the first part
+ * and the others are chained to it through nextpart.
+ *
+ * The block count comes from relpages, which may be out of date; the first
+ * and last parts are unbounded on one side so that no rows are missed.
+ */
+static void
+splitTableDataInfo(TableInfo *tbinfo)
+{
+	TableDataInfo *tdinfo = tbinfo->dataObj;
+	BlockNumber nblocks = (BlockNumber) tbinfo->relpages;
+	BlockNumber start;
+
+	Assert(tdinfo->dobj.objType == DO_TABLE_DATA);
+
+	tdinfo->split = true;
+	tdinfo->filtercond = psprintf("WHERE ctid < '(%u,0)'",
+								  split_table_blocks);
+
+	for (start = split_table_blocks;
+		 start < nblocks;
+		 start += split_table_blocks)
+	{
+		TableDataInfo *part;
+
+		part = (TableDataInfo *) pg_malloc(sizeof(TableDataInfo));
+		part->dobj.objType = DO_TABLE_DATA;
+		part->dobj.catId = tdinfo->dobj.catId;
+		AssignDumpId(&part->dobj);
+		part->dobj.name = tbinfo->dobj.name;
+		part->dobj.namespace = tbinfo->dobj.namespace;
+		part->tdtable = tbinfo;
+		part->split = true;
+		addObjectDependency(&part->dobj, tbinfo->dobj.dumpId);
+
+		if (nblocks - start <= split_table_blocks)
+			part->filtercond = psprintf("WHERE ctid >= '(%u,0)'", start);
+		else
+			part->filtercond = psprintf("WHERE ctid >= '(%u,0)' AND ctid < '(%u,0)'",
+										start, start + split_table_blocks);
+		part->nextpart = NULL;
+
+		tdinfo->nextpart = part;
+		tdinfo = part;
+	}
+}
+
 /*
  * The refresh for a materialized view must be dependent on the refresh for
  * any materialized view that this one is dependent on.
@@ -2696,10 +2811,19 @@ getTableDataFKConstraints(void)
 
 			/*
 			 * Okay, make referencing table's TABLE_DATA object depend on the
-			 * referenced table's TABLE_DATA object.
+			 * referenced table's TABLE_DATA object, for every part of either
+			 * one's data if it was split.
 			 */
-			addObjectDependency(&cinfo->contable->dataObj->dobj,
-								ftable->dataObj->dobj.dumpId);
+			for (TableDataInfo *tdinfo = cinfo->contable->dataObj;
+				 tdinfo != NULL;
+				 tdinfo = tdinfo->nextpart)
+			{
+				for (TableDataInfo *ftdinfo = ftable->dataObj;
+					 ftdinfo != NULL;
+					 ftdinfo = ftdinfo->nextpart)
+					addObjectDependency(&tdinfo->dobj,
+										ftdinfo->dobj.dumpId);
+			}
 		}
 	}
 	free(dobjs);
@@ -361,6 +361,8 @@ typedef struct _tableDataInfo
 	DumpableObject dobj;
 	TableInfo  *tdtable;		/* link to table to dump */
 	char	   *filtercond;		/* WHERE condition to limit rows dumped */
+	bool		split;			/* is this a part of the table's data? */
+	struct _tableDataInfo *nextpart;	/* next part, if split */
 } TableDataInfo;
 
 typedef struct _indxInfo
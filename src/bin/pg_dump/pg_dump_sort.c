@@ -291,6 +291,14 @@ DOTypeNameCompare(const void *p1, const void *p2)
 		if (cmpval != 0)
 			return cmpval;
 	}
+	else if (obj1->objType == DO_TABLE_DATA)
+	{
+		/* Keep the parts of a table's split data in the order made */
+		cmpval = oidcmp(obj1->catId.oid, obj2->catId.oid);
+		if (cmpval != 0)
+			return cmpval;
+		return obj1->dumpId - obj2->dumpId;
+	}
 
 	/* Usually shouldn't get here, but if we do, sort by OID */
 	return oidcmp(obj1->catId.oid, obj2->catId.oid);
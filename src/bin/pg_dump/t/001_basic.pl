@@ -7,7 +7,7 @@ use warnings;
 use Config;
 use PostgresNode;
 use TestLib;
-use Test::More tests => 82;
+use Test::More tests => 84;
 
 my $tempdir       = TestLib::tempdir;
 my $tempdir_short = TestLib::tempdir_short;
@@ -136,6 +136,11 @@ command_fails_like(
 	qr/\Qpg_dump: error: rows-per-insert must be in range 1..2147483647\E/,
 	'pg_dump: rows-per-insert must be in range 1..2147483647');
 
+command_fails_like(
+	[ 'pg_dump', '--split-table-size', '0' ],
+	qr/\Qpg_dump: error: split-table-size must be in range 1..2147483647\E/,
+	'pg_dump: split-table-size must be in range 1..2147483647');
+
 command_fails_like(
 	[ 'pg_restore', '--if-exists', '-f -' ],
 	qr/\Qpg_restore: error: option --if-exists requires option -c\/--clean\E/,
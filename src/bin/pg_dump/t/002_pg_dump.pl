@@ -3395,8 +3395,9 @@ if ($collation_check_stderr !~ /ERROR: /)
 $node->psql('postgres', 'create database regress_pg_dump_test;');
 
 # Start with number of command_fails_like()*2 tests below (each
-# command_fails_like is actually 2 tests)
-my $num_tests = 12;
+# command_fails_like is actually 2 tests), plus the --split-table-size
+# tests at the end
+my $num_tests = 12 + 6;
 
 foreach my $run (sort keys %pgdump_runs)
 {
@@ -3630,6 +3631,73 @@ foreach my $run (sort keys %pgdump_runs)
 	}
 }
 
+#########################################
+# Test dumping the data of a large table in parts with --split-table-size,
+# and restoring it in parallel.  This uses its own databases, so as not to
+# disturb the runs above.
+
+$node->safe_psql('postgres', 'CREATE DATABASE regress_split_dump');
+$node->safe_psql(
+	'regress_split_dump', q{
+CREATE TABLE big (id int PRIMARY KEY, filler text);
+INSERT INTO big SELECT i, repeat('x', 100) FROM generate_series(1, 50000) i;
+CREATE INDEX big_filler_idx ON big (filler);
+CREATE TABLE small (id int REFERENCES big);
+INSERT INTO small SELECT generate_series(1, 10);
+VACUUM ANALYZE big, small;
+});
+
+$node->command_ok(
+	[
+		'pg_dump', '-Fd', '-j2', '--split-table-size=1',
+		"--file=$tempdir/split_table", 'regress_split_dump',
+	],
+	'split table: pg_dump runs');
+
+my ($split_toc, $split_err) =
+  run_command([ 'pg_restore', '-l', "$tempdir/split_table" ]);
+my $big_parts   = () = $split_toc =~ /TABLE DATA public big /g;
+my $small_parts = () = $split_toc =~ /TABLE DATA public small /g;
+cmp_ok($big_parts, '>', 1, 'split table: large table is dumped in parts');
+is($small_parts, 1, 'split table: small table is dumped whole');
+
+$node->safe_psql('postgres', 'CREATE DATABASE regress_split_restore');
+
+# Keep the verbose log, to see in which order the items were restored
+my ($split_out, $split_log);
+ok( IPC::Run::run(
+		[
+			'pg_restore', '-j2', '--verbose', '-p', $port,
+			'-d', 'regress_split_restore', "$tempdir/split_table",
+		],
+		'>', \$split_out, '2>', \$split_log),
+	'split table: parallel pg_restore runs');
+
+my $check = q{SELECT count(*), sum(id), count(DISTINCT id) FROM big};
+is( $node->safe_psql('regress_split_restore', $check),
+	$node->safe_psql('regress_split_dump', $check),
+	'split table: all rows are restored, once');
+
+# The index and the constraints on the table mustn't be created until all
+# parts of its data have been loaded
+my ($last_data, $first_dependent);
+my $lineno = 0;
+foreach my $line (split /\n/, $split_log)
+{
+	$lineno++;
+	$last_data = $lineno if $line =~ /finished item \d+ TABLE DATA big$/;
+	$first_dependent //= $lineno
+	  if $line =~
+	  /(?:launching|processing) item \d+ (?:INDEX big_filler_idx|CONSTRAINT big big_pkey|FK CONSTRAINT small small_id_fkey)$/;
+}
+if (!ok(defined($last_data)
+		  && defined($first_dependent)
+		  && $last_data < $first_dependent,
+		'split table: index and constraints are restored after all data parts'))
+{
+	diag($split_log);
+}
+
 #########################################
 # Stop the database instance, which will be removed at the end of the tests.
 
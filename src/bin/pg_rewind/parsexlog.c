@@ -41,6 +41,18 @@ static int	xlogreadfd = -1;
 static XLogSegNo xlogreadsegno = -1;
 static char xlogfpath[MAXPGPATH];
 
+/*
+ * WAL is read from the open segment in chunks of XLOG_READ_CHUNK_SIZE bytes,
+ * rather than one page at a time, to cut down on system calls.  xlogchunk
+ * holds the chunk starting at offset xlogchunkoff of the segment, of which
+ * xlogchunklen bytes are valid.
+ */
+#define XLOG_READ_CHUNK_SIZE	Min(128 * XLOG_BLCKSZ, WalSegSz)
+
+static char *xlogchunk = NULL;
+static uint32 xlogchunkoff = 0;
+static int	xlogchunklen = 0;
+
 static bool SimpleXLogPageRead(XLogReaderState *xlogreader,
 							   const char *datadir, int *tliIndex,
 							   const char *restoreCommand);
@@ -296,6 +308,9 @@ SimpleXLogPageRead(XLogReaderState *xlogreader, const char *datadir,
 		snprintf(xlogfpath, MAXPGPATH, "%s/" XLOGDIR "/%s",
 				 xlogreader->segcxt.ws_dir, xlogfname);
 
+		/* whatever we had read of another segment is no use anymore */
+		xlogchunklen = 0;
+
 		xlogreadfd = open(xlogfpath, O_RDONLY | PG_BINARY, 0);
 
 		if (xlogreadfd < 0)
@@ -335,28 +350,39 @@ SimpleXLogPageRead(XLogReaderState *xlogreader, const char *datadir,
 	 */
 	Assert(xlogreadfd != -1);
 
-	/* Read the requested page */
-	if (lseek(xlogreadfd, (off_t) targetPageOff, SEEK_SET) < 0)
+	/* Read the chunk containing the requested page, unless we have it */
+	if (xlogchunklen == 0 ||
+		targetPageOff < xlogchunkoff ||
+		targetPageOff + XLOG_BLCKSZ > xlogchunkoff + xlogchunklen)
 	{
-		pg_log_error("could not seek in file \"%s\": %m", xlogfpath);
-		XLogReaderSetInputData(xlogreader, -1);
-		return false;
-	}
-
+		if (xlogchunk == NULL)
+			xlogchunk = pg_malloc(XLOG_READ_CHUNK_SIZE);
 
-	r = read(xlogreadfd, readBuf, XLOG_BLCKSZ);
-	if (r != XLOG_BLCKSZ)
-	{
+		xlogchunkoff = targetPageOff - targetPageOff % XLOG_READ_CHUNK_SIZE;
+		r = pg_pread(xlogreadfd, xlogchunk, XLOG_READ_CHUNK_SIZE,
+					 (off_t) xlogchunkoff);
 		if (r < 0)
+		{
 			pg_log_error("could not read file \"%s\": %m", xlogfpath);
-		else
-			pg_log_error("could not read file \"%s\": read %d of %zu",
-						 xlogfpath, r, (Size) XLOG_BLCKSZ);
+			xlogchunklen = 0;
+			XLogReaderSetInputData(xlogreader, -1);
+			return false;
+		}
+		xlogchunklen = r;
+	}
+
+	if (targetPageOff + XLOG_BLCKSZ > xlogchunkoff + xlogchunklen)
+	{
+		r = Max((int) (xlogchunkoff + xlogchunklen) - (int) targetPageOff, 0);
+		pg_log_error("could not read file \"%s\": read %d of %zu",
+					 xlogfpath, r, (Size) XLOG_BLCKSZ);
 
 		XLogReaderSetInputData(xlogreader, -1);
 		return false;
 	}
 
+	memcpy(readBuf, xlogchunk + (targetPageOff - xlogchunkoff), XLOG_BLCKSZ);
+
 	Assert(targetSegNo == xlogreadsegno);
 
 	xlogreader->seg.ws_tli = targetHistory[*tliIndex].tli;
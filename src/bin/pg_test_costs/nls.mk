@@ -0,0 +1,5 @@
+# src/bin/pg_test_costs/nls.mk
+CATALOG_NAME     = pg_test_costs
+AVAIL_LANGUAGES  =
+GETTEXT_FILES    = pg_test_costs.c
+GETTEXT_TRIGGERS = die
@@ -0,0 +1,459 @@
+/*
+ *	pg_test_costs.c
+ *		measures block read performance and suggests planner cost settings
+ */
+
+#include "postgres_fe.h"
+
+#include <limits.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "common/logging.h"
+#include "getopt_long.h"
+#include "portability/instr_time.h"
+
+/*
+ * put the temp file in the local directory
+ * unless the user specifies otherwise
+ */
+#define COSTS_FILENAME	"./pg_test_costs.out"
+
+#define BLCKSZ_K		(BLCKSZ / 1024)
+
+#define LABEL_FORMAT		"        %-30s"
+/* translator: maintain alignment with LABEL_FORMAT */
+#define OPS_FORMAT			gettext_noop("%13.3f ops/sec  %8.1f usecs/op\n")
+#define USECS_SEC			1000000
+
+/* blocks written per write() call while creating the test file */
+#define WRITE_CHUNK_BLOCKS	128
+
+/* length of the precomputed sequence of random block numbers */
+#define RANDOM_SEQUENCE_LEN 65536
+
+/* prefetch distances tried are powers of two up to this */
+#define MAX_PREFETCH_DISTANCE	256
+
+/*
+ * A prefetch distance is good enough once it reaches this fraction of the
+ * best throughput seen, and prefetching is only recommended at all if the
+ * best distance beats plain random reads by PREFETCH_MIN_GAIN.
+ */
+#define PREFETCH_GOOD_ENOUGH	0.9
+#define PREFETCH_MIN_GAIN		1.1
+
+static const char *progname;
+
+static unsigned int secs_per_test = 5;
+static unsigned int file_size_mb = 1024;
+static int	needs_unlink = 0;
+static char *filename = COSTS_FILENAME;
+static char *buf;
+static uint32 nblocks;
+static uint32 random_blocks[RANDOM_SEQUENCE_LEN];
+
+
+static void handle_args(int argc, char *argv[]);
+static void prepare_file(void);
+static void drop_cache(int fd);
+static double test_seq_read(void);
+static double test_random_read(int distance);
+static void print_suggestions(double seq_usecs, double random_usecs,
+							  int io_concurrency);
+static double elapsed_secs(instr_time start_t);
+static double print_elapse(instr_time start_t, int ops);
+static void signal_cleanup(int sig);
+
+#define die(msg) do { pg_log_error("%s: %m", _(msg)); exit(1); } while(0)
+
+
+int
+main(int argc, char *argv[])
+{
+	double		seq_usecs;
+	double		random_usecs;
+	int			io_concurrency = 0;
+	int			i;
+
+	pg_logging_init(argv[0]);
+	set_pglocale_pgservice(argv[0], PG_TEXTDOMAIN("pg_test_costs"));
+	progname = get_progname(argv[0]);
+
+	handle_args(argc, argv);
+
+	/* Prevent leaving behind the test file */
+	pqsignal(SIGINT, signal_cleanup);
+	pqsignal(SIGTERM, signal_cleanup);
+#ifdef SIGHUP
+	/* Not defined on win32 */
+	pqsignal(SIGHUP, signal_cleanup);
+#endif
+
+	prepare_file();
+
+	for (i = 0; i < RANDOM_SEQUENCE_LEN; i++)
+		random_blocks[i] = (uint32) (random() % nblocks);
+
+	printf(_("\nReads of %dkB blocks:\n"), BLCKSZ_K);
+
+	printf(LABEL_FORMAT, _("sequential"));
+	fflush(stdout);
+	seq_usecs = test_seq_read();
+
+	printf(LABEL_FORMAT, _("random"));
+	fflush(stdout);
+	random_usecs = test_random_read(0);
+
+#ifdef USE_PREFETCH
+	{
+		double		best_rate = 0;
+		double		rates[MAX_PREFETCH_DISTANCE + 1];
+		int			distance;
+
+		printf(_("\nRandom %dkB reads with prefetching:\n"), BLCKSZ_K);
+
+		for (distance = 1; distance <= MAX_PREFETCH_DISTANCE; distance *= 2)
+		{
+			char		label[64];
+
+			snprintf(label, sizeof(label), _("distance %d"), distance);
+			printf(LABEL_FORMAT, label);
+			fflush(stdout);
+			rates[distance] = 1.0 / test_random_read(distance);
+			best_rate = Max(best_rate, rates[distance]);
+		}
+
+		/* Pick the smallest distance that gets close to the best rate */
+		if (best_rate >= (1.0 / random_usecs) * PREFETCH_MIN_GAIN)
+		{
+			for (distance = 1; distance <= MAX_PREFETCH_DISTANCE; distance *= 2)
+			{
+				if (rates[distance] >= best_rate * PREFETCH_GOOD_ENOUGH)
+				{
+					io_concurrency = distance;
+					break;
+				}
+			}
+		}
+	}
+#endif
+
+	print_suggestions(seq_usecs, random_usecs, io_concurrency);
+
+	unlink(filename);
+
+	return 0;
+}
+
+static void
+handle_args(int argc, char *argv[])
+{
+	static struct option long_options[] = {
+		{"filename", required_argument, NULL, 'f'},
+		{"secs-per-test", required_argument, NULL, 's'},
+		{"file-size", required_argument, NULL, 'S'},
+		{NULL, 0, NULL, 0}
+	};
+
+	int			option;			/* Command line option */
+	int			optindex = 0;	/* used by getopt_long */
+	unsigned long optval;		/* used for option parsing */
+	char	   *endptr;
+
+	if (argc > 1)
+	{
+		if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-?") == 0)
+		{
+			printf(_("Usage: %s [-f FILENAME] [-s SECS-PER-TEST] [-S FILE-SIZE]\n"), progname);
+			exit(0);
+		}
+		if (strcmp(argv[1], "--version") == 0 || strcmp(argv[1], "-V") == 0)
+		{
+			puts("pg_test_costs (PostgreSQL) " PG_VERSION);
+			exit(0);
+		}
+	}
+
+	while ((option = getopt_long(argc, argv, "f:s:S:",
+								 long_options, &optindex)) != -1)
+	{
+		switch (option)
+		{
+			case 'f':
+				filename = pg_strdup(optarg);
+				break;
+
+			case 's':
+				errno = 0;
+				optval = strtoul(optarg, &endptr, 10);
+
+				if (endptr == optarg || *endptr != '\0' ||
+					errno != 0 || optval != (unsigned int) optval)
+				{
+					pg_log_error("invalid argument for option %s", "--secs-per-test");
+					fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+					exit(1);
+				}
+
+				secs_per_test = (unsigned int) optval;
+				if (secs_per_test == 0)
+				{
+					pg_log_error("%s must be in range %u..%u",
+								 "--secs-per-test", 1, UINT_MAX);
+					exit(1);
+				}
+				break;
+
+			case 'S':
+				errno = 0;
+				optval = strtoul(optarg, &endptr, 10);
+
+				if (endptr == optarg || *endptr != '\0' ||
+					errno != 0 || optval != (unsigned int) optval)
+				{
+					pg_log_error("invalid argument for option %s", "--file-size");
+					fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
+					exit(1);
+				}
+
+				/* keep the block count comfortably inside a uint32 */
+				file_size_mb = (unsigned int) optval;
+				if (file_size_mb == 0 || file_size_mb > 1024 * 1024)
+				{
+					pg_log_error("%s must be in range %u..%u",
+								 "--file-size", 1, 1024 * 1024);
+					exit(1);
+				}
+				break;
+
+			default:
+				fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+						progname);
+				exit(1);
+				break;
+		}
+	}
+
+	if (argc > optind)
+	{
+		pg_log_error("too many command-line arguments (first is \"%s\")",
+					 argv[optind]);
+		fprintf(stderr, _("Try \"%s --help\" for more information.\n"),
+				progname);
+		exit(1);
+	}
+
+	nblocks = (uint32) (((uint64) file_size_mb * 1024 * 1024) / BLCKSZ);
+
+	printf(_("%u MB test file\n"), file_size_mb);
+	printf(ngettext("%u second per test\n",
+					"%u seconds per test\n",
+					secs_per_test),
+		   secs_per_test);
+#ifdef USE_POSIX_FADVISE
+	printf(_("The operating system cache is dropped before each test.\n"));
+#else
+	printf(_("The operating system cache cannot be dropped on this platform;\n"
+			 "use a test file larger than RAM.\n"));
+#endif
+}
+
+/*
+ * Create the test file, filled with random data, and make sure it has
+ * reached the disk so that writeback doesn't skew the read tests.
+ */
+static void
+prepare_file(void)
+{
+	int			tmpfile;
+	char	   *chunk;
+	uint32		written;
+	int			i;
+
+	chunk = pg_malloc(WRITE_CHUNK_BLOCKS * BLCKSZ);
+	for (i = 0; i < WRITE_CHUNK_BLOCKS * BLCKSZ; i++)
+		chunk[i] = random();
+
+	buf = pg_malloc(BLCKSZ);
+
+	printf(_("\nCreating test file...\n"));
+	fflush(stdout);
+
+	if ((tmpfile = open(filename, O_RDWR | O_CREAT | PG_BINARY, S_IRUSR | S_IWUSR)) == -1)
+		die("could not open output file");
+	needs_unlink = 1;
+
+	for (written = 0; written < nblocks; written += WRITE_CHUNK_BLOCKS)
+	{
+		int			len = Min(WRITE_CHUNK_BLOCKS, nblocks - written) * BLCKSZ;
+
+		if (write(tmpfile, chunk, len) != len)
+			die("write failed");
+	}
+
+	if (fsync(tmpfile) != 0)
+		die("fsync failed");
+
+	close(tmpfile);
+	pg_free(chunk);
+}
+
+/*
+ * Ask the kernel to forget the cached pages of the test file, so that the
+ * next reads have to go to storage.  The file is clean, so this is cheap.
+ */
+static void
+drop_cache(int fd)
+{
+#ifdef USE_POSIX_FADVISE
+	(void) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
+/*
+ * Read the file sequentially, starting over when we reach the end, and
+ * return the average time per block in microseconds.
+ */
+static double
+test_seq_read(void)
+{
+	int			tmpfile;
+	int			ops;
+	uint32		blkno = 0;
+	instr_time	start_t;
+	double		usecs;
+
+	if ((tmpfile = open(filename, O_RDONLY | PG_BINARY, 0)) == -1)
+		die("could not open output file");
+	drop_cache(tmpfile);
+
+	INSTR_TIME_SET_CURRENT(start_t);
+	for (ops = 0; elapsed_secs(start_t) < secs_per_test; ops++)
+	{
+		if (pg_pread(tmpfile, buf, BLCKSZ, (off_t) blkno * BLCKSZ) != BLCKSZ)
+			die("read failed");
+		if (++blkno >= nblocks)
+		{
+			blkno = 0;
+			drop_cache(tmpfile);
+		}
+	}
+	usecs = print_elapse(start_t, ops);
+
+	close(tmpfile);
+
+	return usecs;
+}
+
+/*
+ * Read blocks in random order and return the average time per block in
+ * microseconds.  If distance > 0, hint the kernel about the block that many
+ * reads ahead before each read, the way bitmap heap scans do with
+ * effective_io_concurrency.
+ */
+static double
+test_random_read(int distance)
+{
+	int			tmpfile;
+	int			ops;
+	instr_time	start_t;
+	double		usecs;
+
+	if ((tmpfile = open(filename, O_RDONLY | PG_BINARY, 0)) == -1)
+		die("could not open output file");
+	drop_cache(tmpfile);
+
+	INSTR_TIME_SET_CURRENT(start_t);
+
+#ifdef USE_PREFETCH
+	for (ops = 0; ops < distance; ops++)
+		(void) posix_fadvise(tmpfile,
+							 (off_t) random_blocks[ops % RANDOM_SEQUENCE_LEN] * BLCKSZ,
+							 BLCKSZ, POSIX_FADV_WILLNEED);
+#endif
+
+	for (ops = 0; elapsed_secs(start_t) < secs_per_test; ops++)
+	{
+		int			pos = ops % RANDOM_SEQUENCE_LEN;
+
+		/* Start over with a cold cache when the sequence repeats */
+		if (pos == 0 && ops > 0)
+			drop_cache(tmpfile);
+
+#ifdef USE_PREFETCH
+		if (distance > 0)
+			(void) posix_fadvise(tmpfile,
+								 (off_t) random_blocks[(ops + distance) % RANDOM_SEQUENCE_LEN] * BLCKSZ,
+								 BLCKSZ, POSIX_FADV_WILLNEED);
+#endif
+
+		if (pg_pread(tmpfile, buf, BLCKSZ,
+					 (off_t) random_blocks[pos] * BLCKSZ) != BLCKSZ)
+			die("read failed");
+	}
+	usecs = print_elapse(start_t, ops);
+
+	close(tmpfile);
+
+	return usecs;
+}
+
+/*
+ * Print settings based on the measurements.  Page costs are relative to a
+ * sequential page fetch, as in the planner.
+ */
+static void
+print_suggestions(double seq_usecs, double random_usecs, int io_concurrency)
+{
+	double		random_page_cost = Max(random_usecs / seq_usecs, 1.0);
+
+	printf(_("\nSuggested settings, assuming no reads are cached:\n"));
+	printf("        seq_page_cost = 1.0\n");
+	printf("        random_page_cost = %.1f\n", random_page_cost);
+#ifdef USE_PREFETCH
+	printf("        effective_io_concurrency = %d\n", io_concurrency);
+#else
+	printf(_("        effective_io_concurrency = 0 (prefetching is not supported on this platform)\n"));
+#endif
+}
+
+static double
+elapsed_secs(instr_time start_t)
+{
+	instr_time	now;
+
+	INSTR_TIME_SET_CURRENT(now);
+	INSTR_TIME_SUBTRACT(now, start_t);
+
+	return INSTR_TIME_GET_DOUBLE(now);
+}
+
+/*
+ * print out the reads per second for tests, and return the average
+ * time per read in microseconds
+ */
+static double
+print_elapse(instr_time start_t, int ops)
+{
+	double		total_time = elapsed_secs(start_t);
+	double		per_second = ops / total_time;
+	double		avg_op_time_us = (total_time / ops) * USECS_SEC;
+
+	printf(_(OPS_FORMAT), per_second, avg_op_time_us);
+
+	return avg_op_time_us;
+}
+
+static void
+signal_cleanup(int signum)
+{
+	/* Delete the file if it exists. Ignore errors */
+	if (needs_unlink)
+		unlink(filename);
+	/* Finish incomplete line on stdout */
+	puts("");
+	exit(signum);
+}
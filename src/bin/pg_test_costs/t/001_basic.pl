@@ -0,0 +1,36 @@
+
+# Copyright (c) 2021, PostgreSQL Global Development Group
+
+use strict;
+use warnings;
+
+use Config;
+use TestLib;
+use Test::More tests => 16;
+
+#########################################
+# Basic checks
+
+program_help_ok('pg_test_costs');
+program_version_ok('pg_test_costs');
+program_options_handling_ok('pg_test_costs');
+
+#########################################
+# Test invalid option combinations
+
+command_fails_like(
+	[ 'pg_test_costs', '--secs-per-test', 'a' ],
+	qr/\Qpg_test_costs: error: invalid argument for option --secs-per-test\E/,
+	'pg_test_costs: invalid argument for option --secs-per-test');
+command_fails_like(
+	[ 'pg_test_costs', '--secs-per-test', '0' ],
+	qr/\Qpg_test_costs: error: --secs-per-test must be in range 1..4294967295\E/,
+	'pg_test_costs: --secs-per-test must be in range');
+command_fails_like(
+	[ 'pg_test_costs', '--file-size', 'a' ],
+	qr/\Qpg_test_costs: error: invalid argument for option --file-size\E/,
+	'pg_test_costs: invalid argument for option --file-size');
+command_fails_like(
+	[ 'pg_test_costs', '--file-size', '0' ],
+	qr/\Qpg_test_costs: error: --file-size must be in range 1..1048576\E/,
+	'pg_test_costs: --file-size must be in range');
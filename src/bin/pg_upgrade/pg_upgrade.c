@@ -313,9 +313,25 @@ static void
 create_new_objects(void)
 {
 	int			dbnum;
+	int			restore_jobs;
+	char		jobs_opt[32];
 
 	prep_status("Restoring database schemas in the new cluster\n");
 
+	/*
+	 * With --jobs, up to that many databases are restored at a time below.
+	 * If there are fewer databases than that, let each pg_restore use the
+	 * spare processes to restore the post-data items of its database (mostly
+	 * indexes and constraints) in parallel.  That's what matters when one
+	 * database holds most of the objects.  template1 is not counted, it's
+	 * restored on its own first.
+	 */
+	restore_jobs = user_opts.jobs / Max(old_cluster.dbarr.ndbs - 1, 1);
+	if (restore_jobs > 1)
+		snprintf(jobs_opt, sizeof(jobs_opt), "--jobs %d", restore_jobs);
+	else
+		jobs_opt[0] = '\0';
+
 	/*
 	 * We cannot process the template1 database concurrently with others,
 	 * because when it's transiently dropped, connection attempts would fail.
@@ -384,11 +400,12 @@ create_new_objects(void)
 
 		parallel_exec_prog(log_file_name,
 						   NULL,
-						   "\"%s/pg_restore\" %s %s --exit-on-error --verbose "
+						   "\"%s/pg_restore\" %s %s %s --exit-on-error --verbose "
 						   "--dbname template1 \"%s\"",
 						   new_cluster.bindir,
 						   cluster_conn_opts(&new_cluster),
 						   create_opts,
+						   jobs_opt,
 						   sql_file_name);
 	}
 
@@ -38,9 +38,11 @@
 #define ESTIMATED_BYTES_PER_MANIFEST_LINE	100
 
 /*
- * How many bytes should we try to read from a file at once?
+ * How many bytes should we try to read from a file at once?  Large reads
+ * matter, as we're reading the whole backup; the buffer is allocated only
+ * once.
  */
-#define READ_CHUNK_SIZE				4096
+#define READ_CHUNK_SIZE				(128 * 1024)
 
 /*
  * Each file described by the manifest file is parsed to produce an object
@@ -713,10 +715,13 @@ verify_file_checksum(verifier_context *context, manifest_file *m,
 	int			fd;
 	int			rc;
 	size_t		bytes_read = 0;
-	uint8		buffer[READ_CHUNK_SIZE];
+	static uint8 *buffer = NULL;
 	uint8		checksumbuf[PG_CHECKSUM_MAX_LENGTH];
 	int			checksumlen;
 
+	if (buffer == NULL)
+		buffer = pg_malloc(READ_CHUNK_SIZE);
+
 	/* Open the target file. */
 	if ((fd = open(fullpath, O_RDONLY | PG_BINARY, 0)) < 0)
 	{
@@ -13,6 +13,7 @@
 #include "postgres.h"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -292,7 +293,14 @@ WALDumpOpenSegment(XLogReaderState *state, XLogSegNo nextSegNo,
 	{
 		state->seg.ws_file = open_file_in_directory(state->segcxt.ws_dir, fname);
 		if (state->seg.ws_file >= 0)
+		{
+#ifdef USE_POSIX_FADVISE
+			/* we'll read the segment from start to end, so let it read ahead */
+			(void) posix_fadvise(state->seg.ws_file, 0, 0,
+								 POSIX_FADV_SEQUENTIAL);
+#endif
 			return;
+		}
 		if (errno == ENOENT)
 		{
 			int			save_errno = errno;
@@ -542,18 +550,29 @@ XLogDumpDisplayRecord(XLogDumpConfig *config, XLogReaderState *record)
 				   blk);
 			if (XLogRecHasBlockImage(record, block_id))
 			{
-				if (record->record->blocks[block_id].bimg_info &
-					BKPIMAGE_IS_COMPRESSED)
+				uint8		bimg_info = record->record->blocks[block_id].bimg_info;
+
+				if (BKPIMAGE_COMPRESSED(bimg_info))
 				{
+					const char *method;
+
+					if ((bimg_info & BKPIMAGE_COMPRESS_PGLZ) != 0)
+						method = "pglz";
+					else if ((bimg_info & BKPIMAGE_COMPRESS_LZ4) != 0)
+						method = "lz4";
+					else
+						method = "unknown";
+
 					printf(" (FPW%s); hole: offset: %u, length: %u, "
-						   "compression saved: %u",
+						   "compression saved: %u, method: %s",
 						   XLogRecBlockImageApply(record, block_id) ?
 						   "" : " for WAL verification",
 						   record->record->blocks[block_id].hole_offset,
 						   record->record->blocks[block_id].hole_length,
 						   BLCKSZ -
 						   record->record->blocks[block_id].hole_length -
-						   record->record->blocks[block_id].bimg_len);
+						   record->record->blocks[block_id].bimg_len,
+						   method);
 				}
 				else
 				{
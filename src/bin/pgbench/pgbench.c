@@ -306,6 +306,19 @@ typedef struct
 #define MAX_SCRIPTS		128		/* max number of SQL scripts allowed */
 #define SHELL_COMMAND_SIZE	256 /* maximum size allowed for shell command */
 
+/*
+ * Latency histogram used to report percentiles.  Values (in microseconds)
+ * below LATENCY_HIST_SUB_BUCKETS get a bucket each; above that, every power
+ * of two is split into LATENCY_HIST_SUB_BUCKETS equal sub-buckets, which
+ * keeps the relative error of a reported percentile within about 3%.  Values
+ * beyond 2^LATENCY_HIST_MAX_BITS us (about 12 days) go to the last bucket.
+ */
+#define LATENCY_HIST_SUB_BITS		5
+#define LATENCY_HIST_SUB_BUCKETS	(1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS		40
+#define LATENCY_HIST_BUCKETS \
+	(LATENCY_HIST_SUB_BUCKETS * (LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1))
+
 /*
  * Simple data structure to keep stats about something.
  *
@@ -319,6 +332,7 @@ typedef struct SimpleStats
 	double		max;			/* the maximum seen */
 	double		sum;			/* sum of values */
 	double		sum2;			/* sum of squared values */
+	int64		hist[LATENCY_HIST_BUCKETS]; /* distribution of values */
 } SimpleStats;
 
 /*
@@ -1244,6 +1258,43 @@ initSimpleStats(SimpleStats *ss)
 	memset(ss, 0, sizeof(SimpleStats));
 }
 
+/*
+ * Return the histogram bucket for a value in microseconds.
+ */
+static int
+latencyHistBucket(double val)
+{
+	uint64		v;
+	int			msb;
+
+	if (val < LATENCY_HIST_SUB_BUCKETS)
+		return (val > 0) ? (int) val : 0;
+	if (val >= (double) (UINT64CONST(1) << LATENCY_HIST_MAX_BITS))
+		return LATENCY_HIST_BUCKETS - 1;
+
+	v = (uint64) val;
+	msb = pg_leftmost_one_pos64(v);
+	return LATENCY_HIST_SUB_BUCKETS * (msb - LATENCY_HIST_SUB_BITS + 1) +
+		(int) ((v >> (msb - LATENCY_HIST_SUB_BITS)) - LATENCY_HIST_SUB_BUCKETS);
+}
+
+/*
+ * Return the midpoint of the range of values covered by a histogram bucket.
+ */
+static double
+latencyHistValue(int bucket)
+{
+	int			shift;
+	uint64		base;
+
+	if (bucket < LATENCY_HIST_SUB_BUCKETS)
+		return bucket + 0.5;
+
+	shift = bucket / LATENCY_HIST_SUB_BUCKETS - 1;
+	base = (uint64) (LATENCY_HIST_SUB_BUCKETS + bucket % LATENCY_HIST_SUB_BUCKETS) << shift;
+	return base + (double) (UINT64CONST(1) << shift) / 2;
+}
+
 /*
  * Accumulate one value into a SimpleStats struct.
  */
@@ -1257,6 +1308,31 @@ addToSimpleStats(SimpleStats *ss, double val)
 	ss->count++;
 	ss->sum += val;
 	ss->sum2 += val * val;
+	ss->hist[latencyHistBucket(val)]++;
+}
+
+/*
+ * Estimate the given percentile (0 < pct <= 100) of the values accumulated
+ * into a SimpleStats struct, which must not be empty.
+ */
+static double
+getSimpleStatsPercentile(SimpleStats *ss, double pct)
+{
+	int64		target = (int64) ceil(ss->count * pct / 100.0);
+	int64		seen = 0;
+	int			i;
+
+	Assert(ss->count > 0);
+
+	for (i = 0; i < LATENCY_HIST_BUCKETS; i++)
+	{
+		seen += ss->hist[i];
+		if (seen >= target)
+			break;
+	}
+
+	/* the midpoint can overshoot the extreme values actually seen */
+	return Max(ss->min, Min(ss->max, latencyHistValue(Min(i, LATENCY_HIST_BUCKETS - 1))));
 }
 
 /*
@@ -1272,6 +1348,8 @@ mergeSimpleStats(SimpleStats *acc, SimpleStats *ss)
 	acc->count += ss->count;
 	acc->sum += ss->sum;
 	acc->sum2 += ss->sum2;
+	for (int i = 0; i < LATENCY_HIST_BUCKETS; i++)
+		acc->hist[i] += ss->hist[i];
 }
 
 /*
@@ -5490,6 +5568,12 @@ printSimpleStats(const char *prefix, SimpleStats *ss)
 
 		printf("%s average = %.3f ms\n", prefix, 0.001 * latency);
 		printf("%s stddev = %.3f ms\n", prefix, 0.001 * stddev);
+		printf("%s percentiles (50/90/99/99.9) = %.3f/%.3f/%.3f/%.3f ms\n",
+			   prefix,
+			   0.001 * getSimpleStatsPercentile(ss, 50.0),
+			   0.001 * getSimpleStatsPercentile(ss, 90.0),
+			   0.001 * getSimpleStatsPercentile(ss, 99.0),
+			   0.001 * getSimpleStatsPercentile(ss, 99.9));
 	}
 }
 
@@ -1153,7 +1153,11 @@ for my $e (@errors)
 pgbench(
 	'-t 100 -S --rate=100000 --latency-limit=1000000 -c 2 -n -r',
 	0,
-	[ qr{processed: 200/200}, qr{builtin: select only} ],
+	[
+		qr{processed: 200/200},
+		qr{builtin: select only},
+		qr{latency percentiles \(50/90/99/99\.9\) = [\d.]+/[\d.]+/[\d.]+/[\d.]+ ms}
+	],
 	[qr{^$}],
 	'pgbench throttling');
 
@@ -19,6 +19,7 @@
 
 #include "common/jsonapi.h"
 #include "mb/pg_wchar.h"
+#include "port/simd.h"
 
 #ifdef FRONTEND
 #include "common/logging.h"
@@ -865,12 +866,41 @@ json_lex_string(JsonLexContext *lex)
 			}
 
 		}
-		else if (lex->strval != NULL)
+		else
 		{
-			if (hi_surrogate != -1)
-				return JSON_UNICODE_LOW_SURROGATE;
+			char	   *end = lex->input + lex->input_length;
+			char	   *p = s + 1;
+
+			/*
+			 * Skip ahead over the run of ordinary characters starting here,
+			 * a vector at a time while we can, and copy it in one go.
+			 */
+			while (p + sizeof(Vector8) <= end)
+			{
+				Vector8		chunk;
+
+				vector8_load(&chunk, (const uint8 *) p);
+				if (vector8_has(chunk, '"') ||
+					vector8_has(chunk, '\\') ||
+					vector8_has_le(chunk, 31))
+					break;
+				p += sizeof(Vector8);
+			}
+			while (p < end && *p != '"' && *p != '\\' &&
+				   (unsigned char) *p >= 32)
+				p++;
+
+			if (lex->strval != NULL)
+			{
+				if (hi_surrogate != -1)
+					return JSON_UNICODE_LOW_SURROGATE;
+
+				appendBinaryStringInfo(lex->strval, s, p - s);
+			}
 
-			appendStringInfoChar(lex->strval, *s);
+			/* the loop advances to p */
+			len += p - 1 - s;
+			s = p - 1;
 		}
 
 	}
@@ -63,6 +63,16 @@ extern struct varlena *detoast_attr_slice(struct varlena *attr,
 										  int32 sliceoffset,
 										  int32 slicelength);
 
+/* ----------
+ * toast_fetch_compressed_prefix() -
+ *
+ *		Fetches the start of the compressed data of a compressed external
+ *		attribute.
+ * ----------
+ */
+extern struct varlena *toast_fetch_compressed_prefix(struct varlena *attr,
+													 int32 length);
+
 /* ----------
  * toast_raw_datum_size -
  *
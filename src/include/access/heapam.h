@@ -71,6 +71,16 @@ typedef struct HeapScanDescData
 	 */
 	ParallelBlockTableScanWorkerData *rs_parallelworkerdata;
 
+	/*
+	 * Read-ahead state for serial forward scans (see heapgettup_prefetch).
+	 * rs_prefetch_target is the maximum distance to prefetch ahead of the
+	 * current page, or zero if read-ahead is disabled for this scan.
+	 */
+	int			rs_prefetch_target;
+	int			rs_prefetch_pages;	/* # of pages prefetched ahead of rs_cblock */
+	BlockNumber rs_prefetch_block;	/* last block already prefetched */
+	BlockNumber rs_prefetch_left;	/* # of blocks still to be prefetched */
+
 	/* these fields only used in page-at-a-time mode and for bitmap scans */
 	int			rs_cindex;		/* current tuple's index in vistuples */
 	int			rs_ntuples;		/* number of visible tuples on page */
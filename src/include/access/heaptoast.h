@@ -73,12 +73,11 @@
  * be small enough that the completed toast-table tuple (including the
  * ID and sequence fields and all overhead) will fit on a page.
  * The coding here sets the size on the theory that we want to fit
- * EXTERN_TUPLES_PER_PAGE tuples of maximum size onto a page.
+ * EXTERN_TUPLES_PER_PAGE tuples of maximum size onto a page; that is set in
+ * pg_config_manual.h.
  *
  * NB: Changing TOAST_MAX_CHUNK_SIZE requires an initdb.
  */
-#define EXTERN_TUPLES_PER_PAGE	4	/* tweak only this */
-
 #define EXTERN_TUPLE_MAX_SIZE	MaximumBytesPerTuple(EXTERN_TUPLES_PER_PAGE)
 
 #define TOAST_MAX_CHUNK_SIZE	\
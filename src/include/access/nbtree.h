@@ -1064,6 +1064,19 @@ typedef struct BTScanOpaqueData
 	 */
 	int			markItemIndex;	/* itemIndex, or -1 if not valid */
 
+	/*
+	 * Heap prefetch state for plain index scans.  prefetchTarget is the
+	 * number of currPos items to look ahead of itemIndex (0 disables
+	 * prefetching); prefetchIndex is the next currPos item whose heap block
+	 * has not yet been prefetched, valid only while currPos still holds
+	 * prefetchPage and we keep moving in prefetchDir.
+	 */
+	int			prefetchTarget;
+	int			prefetchIndex;
+	BlockNumber prefetchPage;
+	ScanDirection prefetchDir;
+	BlockNumber prefetchBlock;	/* last heap block prefetched */
+
 	/* keep these last in struct for efficiency */
 	BTScanPosData currPos;		/* current position data */
 	BTScanPosData markPos;		/* marked position, if any */
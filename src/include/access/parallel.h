@@ -27,6 +27,7 @@ typedef struct ParallelWorkerInfo
 	BackgroundWorkerHandle *bgwhandle;
 	shm_mq_handle *error_mqh;
 	int32		pid;
+	bool		from_pool;		/* taken from the worker pool? */
 } ParallelWorkerInfo;
 
 typedef struct ParallelContext
@@ -58,6 +59,9 @@ extern volatile bool ParallelMessagePending;
 extern PGDLLIMPORT int ParallelWorkerNumber;
 extern PGDLLIMPORT bool InitializingParallelWorker;
 
+/* GUC variable */
+extern PGDLLIMPORT int parallel_worker_idle_timeout;
+
 #define		IsParallelWorker()		(ParallelWorkerNumber >= 0)
 
 extern ParallelContext *CreateParallelContext(const char *library_name,
@@ -77,6 +81,10 @@ extern void AtEOXact_Parallel(bool isCommit);
 extern void AtEOSubXact_Parallel(bool isCommit, SubTransactionId mySubId);
 extern void ParallelWorkerReportLastRecEnd(XLogRecPtr last_xlog_end);
 
+extern Size ParallelWorkerPoolShmemSize(void);
+extern void ParallelWorkerPoolShmemInit(void);
+extern void TerminatePooledParallelWorkers(Oid databaseId);
+
 extern void ParallelWorkerMain(Datum main_arg);
 
 #endif							/* PARALLEL_H */
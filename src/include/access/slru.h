@@ -33,6 +33,16 @@
  */
 #define SLRU_PAGES_PER_SEGMENT	32
 
+/*
+ * Number of buffer slots per SLRU bank; see SlruSharedData.num_banks.
+ */
+#define SLRU_BANK_SIZE			16
+
+/*
+ * Upper limit for the configurable SLRU pool sizes, in pages.
+ */
+#define SLRU_MAX_ALLOWED_BUFFERS	((1024 * 1024 * 1024) / BLCKSZ)
+
 /*
  * Page status codes.  Note that these do not include the "dirty" bit.
  * page_dirty can be true only in the VALID or WRITE_IN_PROGRESS states;
@@ -57,6 +67,14 @@ typedef struct SlruSharedData
 	/* Number of buffers managed by this SLRU structure */
 	int			num_slots;
 
+	/*
+	 * The slots are divided into num_banks banks of (about) SLRU_BANK_SIZE
+	 * slots each, and a given page can only ever be stored in the bank
+	 * selected by SlruPageBank(), so lookups and victim selection only need
+	 * to scan that bank.
+	 */
+	int			num_banks;
+
 	/*
 	 * Arrays holding info for each buffer slot.  Page number is undefined
 	 * when status is EMPTY, as is page_lru_count.
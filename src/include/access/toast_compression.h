@@ -38,9 +38,36 @@ typedef enum ToastCompressionId
 {
 	TOAST_PGLZ_COMPRESSION_ID = 0,
 	TOAST_LZ4_COMPRESSION_ID = 1,
-	TOAST_INVALID_COMPRESSION_ID = 2
+	TOAST_BLOCKS_COMPRESSION_ID = 2,
+	TOAST_INVALID_COMPRESSION_ID = 3
 } ToastCompressionId;
 
+/*
+ * Values of more than TOAST_COMPRESS_BLOCK_SIZE bytes are compressed as a
+ * series of independently compressed blocks of that many raw bytes (the last
+ * one may be shorter), and marked with TOAST_BLOCKS_COMPRESSION_ID.  That way
+ * a slice can be decompressed, and when the value is stored externally also
+ * fetched, without going through everything before it.
+ *
+ * After the compression header, such a value has a toast_compress_blocks
+ * header holding the compression method of the blocks and the end offset of
+ * each block's compressed data, counted from the end of the header.  A block
+ * whose compressed size is its raw size is stored without compression.
+ */
+#define TOAST_COMPRESS_BLOCK_SIZE		(64 * 1024)
+
+typedef struct toast_compress_blocks
+{
+	uint32		method;			/* ToastCompressionId of the blocks */
+	uint32		blocksize;		/* raw size of each block but the last */
+	uint32		ends[FLEXIBLE_ARRAY_MEMBER];
+} toast_compress_blocks;
+
+#define TOAST_COMPRESS_BLOCKS_NBLOCKS(rawsize, blocksize) \
+	(((rawsize) + (blocksize) - 1) / (blocksize))
+#define TOAST_COMPRESS_BLOCKS_HDRSZ(nblocks) \
+	(offsetof(toast_compress_blocks, ends) + (nblocks) * sizeof(uint32))
+
 /*
  * Built-in compression methods.  pg_attribute will store this in the
  * attcompression column.
@@ -77,6 +104,14 @@ extern struct varlena *lz4_decompress_datum(const struct varlena *value);
 extern struct varlena *lz4_decompress_datum_slice(const struct varlena *value,
 												  int32 slicelength);
 
+/* routines for values compressed in blocks */
+extern struct varlena *blocks_compress_datum(const struct varlena *value,
+											 char cmethod);
+extern struct varlena *blocks_decompress(const toast_compress_blocks *hdr,
+										 int32 rawsize, const char *data,
+										 int32 datalen, int32 firstblock,
+										 int32 sliceoffset, int32 slicelength);
+
 /* other stuff */
 extern ToastCompressionId toast_get_compression_id(struct varlena *attr);
 extern char CompressionNameToMethod(const char *compression);
@@ -273,6 +273,21 @@
 #define unlikely(x) ((x) != 0)
 #endif
 
+/*
+ * pg_prefetch_mem
+ *		Hint to the CPU that the memory at the given address will be read
+ *		soon, so that the cache miss can overlap with other work.
+ *
+ * This is purely advisory and may be a no-op.  Like likely()/unlikely(), it
+ * should only be used in hot code paths where the access pattern is known to
+ * be cache-unfriendly, e.g. when walking pointer chains.
+ */
+#if defined(__GNUC__) && __GNUC__ >= 3
+#define pg_prefetch_mem(a)	__builtin_prefetch(a)
+#else
+#define pg_prefetch_mem(a)	((void) 0)
+#endif
+
 /*
  * CppAsString
  *		Convert the argument to a string, using the C preprocessor.
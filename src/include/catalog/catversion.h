@@ -53,6 +53,6 @@
  */
 
 /*							yyyymmddN */
-#define CATALOG_VERSION_NO	202105051
+#define CATALOG_VERSION_NO	202105056
 
 #endif
@@ -48,12 +48,49 @@ typedef struct CopyFormatOptions
 	bool	   *force_null_flags;	/* per-column CSV FN flags */
 	bool		convert_selectively;	/* do selective binary conversion? */
 	List	   *convert_select; /* list of column names (can be NIL) */
+	bool		parallel;		/* COPY TO may scan with parallel workers? */
+	const struct CopyFormatRoutine *routine;	/* extension-provided format,
+												 * or NULL */
 } CopyFormatOptions;
 
 /* These are private in commands/copy[from|to].c */
 typedef struct CopyFromStateData *CopyFromState;
 typedef struct CopyToStateData *CopyToState;
 
+/*
+ * A COPY format provided by an extension, which registers it with
+ * RegisterCopyFormat() and users choose with FORMAT name.
+ *
+ * The start callbacks return a pointer to the format's private state, which
+ * is passed to the other callbacks.  copy_to_one_row() is called for each
+ * row, in a memory context that is reset in between, and writes output with
+ * CopyToSendData(); it can also keep rows back and write them out in
+ * batches.  copy_from_one_row() reads input with CopyFromReadData(), and
+ * fills in values and nulls for the attributes in attnumlist (the others
+ * get their defaults), or returns false at the end of the input.  A format
+ * that only works in one direction leaves the other set of callbacks NULL.
+ */
+typedef struct CopyFormatRoutine
+{
+	const char *name;			/* name to use in the FORMAT option */
+
+	/* COPY TO */
+	void	   *(*copy_to_start) (CopyToState cstate, TupleDesc tupDesc,
+								  List *attnumlist);
+	void		(*copy_to_one_row) (CopyToState cstate, void *state,
+									TupleTableSlot *slot);
+	void		(*copy_to_end) (CopyToState cstate, void *state);
+
+	/* COPY FROM */
+	void	   *(*copy_from_start) (CopyFromState cstate, TupleDesc tupDesc,
+									List *attnumlist);
+	bool		(*copy_from_one_row) (CopyFromState cstate, void *state,
+									  Datum *values, bool *nulls);
+	void		(*copy_from_end) (CopyFromState cstate, void *state);
+} CopyFormatRoutine;
+
+extern void RegisterCopyFormat(const CopyFormatRoutine *routine);
+
 typedef int (*copy_data_source_cb) (void *outbuf, int minread, int maxread);
 
 extern void DoCopy(ParseState *state, const CopyStmt *stmt,
@@ -72,6 +109,7 @@ extern bool NextCopyFromRawFields(CopyFromState cstate,
 extern void CopyFromErrorCallback(void *arg);
 
 extern uint64 CopyFrom(CopyFromState cstate);
+extern int	CopyFromReadData(CopyFromState cstate, void *dest, int nbytes);
 
 extern DestReceiver *CreateCopyDestReceiver(void);
 
@@ -83,6 +121,8 @@ extern CopyToState BeginCopyTo(ParseState *pstate, Relation rel, RawStmt *query,
 							   List *attnamelist, List *options);
 extern void EndCopyTo(CopyToState cstate);
 extern uint64 DoCopyTo(CopyToState cstate);
+extern void CopyToSendData(CopyToState cstate, const void *databuf,
+						   int datasize);
 extern List *CopyGetAttnums(TupleDesc tupDesc, Relation rel,
 							List *attnamelist);
 
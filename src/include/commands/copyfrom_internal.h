@@ -98,6 +98,8 @@ typedef struct CopyFromStateData
 
 	TransitionCaptureState *transition_capture;
 
+	void	   *format_state;	/* private state of opts.routine, if any */
+
 	/*
 	 * These variables are used to reduce overhead in COPY FROM.
 	 *
@@ -151,4 +151,20 @@
 #define PROGRESS_COPY_TYPE_PIPE 3
 #define PROGRESS_COPY_TYPE_CALLBACK 4
 
+/* Progress parameters for PROGRESS_COMMAND_QUERY */
+#define PROGRESS_QUERY_ROWS_PROCESSED		0
+#define PROGRESS_QUERY_ROWS_SCANNED			1
+#define PROGRESS_QUERY_SORT_PHASE			2
+#define PROGRESS_QUERY_SORT_TUPLES			3
+#define PROGRESS_QUERY_HASH_BATCH			4
+#define PROGRESS_QUERY_HASH_BATCHES			5
+#define PROGRESS_QUERY_TEMP_BYTES_WRITTEN	6
+
+/* Phases of the most recently active sort (as advertised via PROGRESS_QUERY_SORT_PHASE) */
+#define PROGRESS_QUERY_SORT_PHASE_LOADING		1
+#define PROGRESS_QUERY_SORT_PHASE_WRITING_RUNS	2
+#define PROGRESS_QUERY_SORT_PHASE_SORTING		3
+#define PROGRESS_QUERY_SORT_PHASE_MERGING		4
+#define PROGRESS_QUERY_SORT_PHASE_RETURNING		5
+
 #endif
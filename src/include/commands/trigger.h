@@ -40,6 +40,7 @@ typedef struct TriggerData
 	Tuplestorestate *tg_oldtable;
 	Tuplestorestate *tg_newtable;
 	const Bitmapset *tg_updatedcols;
+	CommandId	tg_firing_id;	/* batch of AFTER events, or 0 */
 } TriggerData;
 
 /*
@@ -104,10 +104,14 @@ typedef enum ExprEvalOp
 	/*
 	 * Evaluate function call (including OpExprs etc).  For speed, we
 	 * distinguish in the opcode whether the function is strict and/or
-	 * requires usage stats tracking.
+	 * requires usage stats tracking.  Strict functions of one or two
+	 * arguments, which includes most operators, get their own opcodes so
+	 * that the NULL checks don't need a loop.
 	 */
 	EEOP_FUNCEXPR,
 	EEOP_FUNCEXPR_STRICT,
+	EEOP_FUNCEXPR_STRICT_1,
+	EEOP_FUNCEXPR_STRICT_2,
 	EEOP_FUNCEXPR_FUSAGE,
 	EEOP_FUNCEXPR_STRICT_FUSAGE,
 
@@ -574,6 +578,7 @@ typedef struct ExprEvalStep
 		struct
 		{
 			bool		has_nulls;
+			bool		inclause;	/* true for IN and false for NOT IN */
 			struct ScalarArrayOpExprHashTable *elements_tab;
 			FmgrInfo   *finfo;	/* function's lookup data */
 			FunctionCallInfo fcinfo_data;	/* arguments etc */
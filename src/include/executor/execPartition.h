@@ -95,6 +95,9 @@ typedef struct PartitionPruningData
  * do_exec_prune		true if pruning should be performed during
  *						executor run (at any hierarchy level).
  * num_partprunedata	Number of items in "partprunedata" array.
+ * result_cache			The values of the execparamids Params the last
+ *						execution-time pruning was done for, and its result,
+ *						or NULL if we can't tell whether they changed.
  * partprunedata		Array of PartitionPruningData pointers for the plan's
  *						partitioned relation(s), one for each partitioning
  *						hierarchy that requires run-time pruning.
@@ -104,6 +107,7 @@ typedef struct PartitionPruneState
 	Bitmapset  *execparamids;
 	Bitmapset  *other_subplans;
 	MemoryContext prune_context;
+	struct PartitionPruneResultCache *result_cache;
 	bool		do_initial_prune;
 	bool		do_exec_prune;
 	int			num_partprunedata;
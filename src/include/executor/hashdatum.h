@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------
+ *
+ * hashdatum.h
+ *	  inline hashing of key values for hash tables built by the executor
+ *
+ *
+ * Portions Copyright (c) 1996-2021, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/executor/hashdatum.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef HASHDATUM_H
+#define HASHDATUM_H
+
+#include "common/hashfn.h"
+#include "fmgr.h"
+#include "utils/fmgroids.h"
+
+/*
+ * ExecHashDatum
+ *
+ * Compute the hash of a non-null key value with the given hash function,
+ * as hash tables built by the executor do for every input tuple.  The hash
+ * functions of the integer types and oid are computed inline to avoid the
+ * function call overhead; they must give exactly the same results as
+ * hashfunc.c, which keeps cross-type hash joins working.
+ */
+static inline uint32
+ExecHashDatum(FmgrInfo *hashfunction, Oid collation, Datum value)
+{
+	switch (hashfunction->fn_oid)
+	{
+		case F_HASHINT2:
+			return hash_bytes_uint32((int32) DatumGetInt16(value));
+		case F_HASHINT4:
+			return hash_bytes_uint32(DatumGetInt32(value));
+		case F_HASHINT8:
+			{
+				int64		val = DatumGetInt64(value);
+				uint32		lohalf = (uint32) val;
+				uint32		hihalf = (uint32) (val >> 32);
+
+				/* see hashint8() */
+				lohalf ^= (val >= 0) ? hihalf : ~hihalf;
+				return hash_bytes_uint32(lohalf);
+			}
+		case F_HASHOID:
+			return hash_bytes_uint32((uint32) DatumGetObjectId(value));
+		default:
+			return DatumGetUInt32(FunctionCall1Coll(hashfunction, collation,
+													value));
+	}
+}
+
+#endif							/* HASHDATUM_H */
@@ -329,6 +329,14 @@ typedef struct HashJoinTableData
 	BufFile   **innerBatchFile; /* buffered virtual temp file per batch */
 	BufFile   **outerBatchFile; /* buffered virtual temp file per batch */
 
+	/*
+	 * Bloom filter of the hash values of all inner tuples, or NULL.  This is
+	 * only built for multi-batch joins in which an outer tuple without a
+	 * match can be discarded; it lets us avoid saving such tuples to the
+	 * outer batch files.
+	 */
+	struct bloom_filter *bloom;
+
 	/*
 	 * Info about the datatype-specific hash functions for the datatypes being
 	 * hashed. These are arrays of the same length as the number of hash join
@@ -344,6 +352,7 @@ typedef struct HashJoinTableData
 	Size		spacePeak;		/* peak space used */
 	Size		spaceUsedSkew;	/* skew hash table's current space usage */
 	Size		spaceAllowedSkew;	/* upper limit for skew hashtable */
+	Size		spaceBloom;		/* memory space used by the Bloom filter */
 
 	MemoryContext hashCxt;		/* context for whole-hash-join storage */
 	MemoryContext batchCxt;		/* context for this-batch-only storage */
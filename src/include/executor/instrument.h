@@ -39,6 +39,24 @@ typedef struct WalUsage
 	uint64		wal_bytes;		/* size of WAL records produced */
 } WalUsage;
 
+/* Classes of wait events that WaitUsage keeps apart */
+typedef enum WaitUsageClass
+{
+	WAIT_USAGE_LWLOCK,
+	WAIT_USAGE_LOCK,
+	WAIT_USAGE_IO,
+	WAIT_USAGE_CLIENT,
+	WAIT_USAGE_OTHER			/* all other classes, except Activity */
+} WaitUsageClass;
+
+#define NUM_WAIT_USAGE_CLASSES (WAIT_USAGE_OTHER + 1)
+
+typedef struct WaitUsage
+{
+	/* time spent waiting, tracked only if track_wait_timing is on */
+	instr_time	wait_time[NUM_WAIT_USAGE_CLASSES];
+} WaitUsage;
+
 /* Flag bits included in InstrAlloc's instrument_options bitmask */
 typedef enum InstrumentOption
 {
@@ -46,23 +64,38 @@ typedef enum InstrumentOption
 	INSTRUMENT_BUFFERS = 1 << 1,	/* needs buffer usage */
 	INSTRUMENT_ROWS = 1 << 2,	/* needs row count */
 	INSTRUMENT_WAL = 1 << 3,	/* needs WAL usage */
+	INSTRUMENT_WAITS = 1 << 4,	/* needs wait usage */
+	INSTRUMENT_TIMER_SAMPLED = 1 << 5,	/* needs timer, sampling is enough */
 	INSTRUMENT_ALL = PG_INT32_MAX
 } InstrumentOption;
 
+/*
+ * With INSTRUMENT_TIMER_SAMPLED (and not INSTRUMENT_TIMER), the first
+ * INSTR_TIMER_SAMPLE_RATE calls of each cycle of a node are timed, and after
+ * that only every INSTR_TIMER_SAMPLE_RATE'th call.  The time of the untimed
+ * calls is extrapolated from the sampled ones at the end of the cycle.
+ */
+#define INSTR_TIMER_SAMPLE_RATE 16
+
 typedef struct Instrumentation
 {
 	/* Parameters set at node creation: */
 	bool		need_timer;		/* true if we need timer data */
 	bool		need_bufusage;	/* true if we need buffer usage data */
 	bool		need_walusage;	/* true if we need WAL usage data */
+	bool		need_waitusage; /* true if we need wait usage data */
+	bool		sample_timer;	/* true if we time only a sample of calls */
 	/* Info about current plan cycle: */
 	bool		running;		/* true if we've completed first tuple */
 	instr_time	starttime;		/* start time of current iteration of node */
 	instr_time	counter;		/* accumulated runtime for this node */
+	uint64		ncalls;			/* # of calls so far this cycle, if sampling */
+	instr_time	sampled;		/* accumulated runtime of sampled calls */
 	double		firsttuple;		/* time for first tuple of this cycle */
 	double		tuplecount;		/* # of tuples emitted so far this cycle */
 	BufferUsage bufusage_start; /* buffer usage at start */
 	WalUsage	walusage_start; /* WAL usage at start */
+	WaitUsage	waitusage_start;	/* wait usage at start */
 	/* Accumulated statistics across all completed cycles: */
 	double		startup;		/* total startup time (in seconds) */
 	double		total;			/* total time (in seconds) */
@@ -73,6 +106,7 @@ typedef struct Instrumentation
 	double		nfiltered2;		/* # of tuples removed by "other" quals */
 	BufferUsage bufusage;		/* total buffer usage */
 	WalUsage	walusage;		/* total WAL usage */
+	WaitUsage	waitusage;		/* total wait usage */
 } Instrumentation;
 
 typedef struct WorkerInstrumentation
@@ -83,6 +117,7 @@ typedef struct WorkerInstrumentation
 
 extern PGDLLIMPORT BufferUsage pgBufferUsage;
 extern PGDLLIMPORT WalUsage pgWalUsage;
+extern PGDLLIMPORT WaitUsage pgWaitUsage;
 
 extern Instrumentation *InstrAlloc(int n, int instrument_options);
 extern void InstrInit(Instrumentation *instr, int instrument_options);
@@ -97,5 +132,7 @@ extern void BufferUsageAccumDiff(BufferUsage *dst,
 								 const BufferUsage *add, const BufferUsage *sub);
 extern void WalUsageAccumDiff(WalUsage *dst, const WalUsage *add,
 							  const WalUsage *sub);
+extern void WaitUsageAccumDiff(WaitUsage *dst, const WaitUsage *add,
+							   const WaitUsage *sub);
 
 #endif							/* INSTRUMENT_H */
@@ -111,6 +111,22 @@
 struct TupleTableSlotOps;
 typedef struct TupleTableSlotOps TupleTableSlotOps;
 
+/*
+ * Per-attribute information used by slot_deform_heap_tuple().  This is built
+ * from the slot's tuple descriptor the first time a tuple is deformed, and is
+ * much more compact than the descriptor's pg_attribute entries, so deforming
+ * wide tuples touches far less memory.  attcacheoff is the attribute's fixed
+ * offset within the tuple data if it has one (i.e. if all attributes before
+ * it are fixed-width and not NULL), else -1.
+ */
+typedef struct TupleDeformAttr
+{
+	int32		attcacheoff;
+	int16		attlen;
+	bool		attbyval;
+	char		attalign;
+} TupleDeformAttr;
+
 /* base tuple table slot type */
 typedef struct TupleTableSlot
 {
@@ -129,6 +145,7 @@ typedef struct TupleTableSlot
 	MemoryContext tts_mcxt;		/* slot itself is in this context */
 	ItemPointerData tts_tid;	/* stored tuple's tid */
 	Oid			tts_tableOid;	/* table oid of tuple */
+	TupleDeformAttr *tts_deformattrs;	/* NULL if not yet built */
 } TupleTableSlot;
 
 /* routines for a TupleTableSlot implementation */
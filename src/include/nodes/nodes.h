@@ -288,6 +288,7 @@ typedef enum NodeTag
 	T_AllocSetContext,
 	T_SlabContext,
 	T_GenerationContext,
+	T_BumpContext,
 
 	/*
 	 * TAGS FOR VALUE NODES (value.h)
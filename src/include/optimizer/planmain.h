@@ -46,6 +46,8 @@ extern ForeignScan *make_foreignscan(List *qptlist, List *qpqual,
 extern Plan *change_plan_targetlist(Plan *subplan, List *tlist,
 									bool tlist_parallel_safe);
 extern Plan *materialize_finished_plan(Plan *subplan);
+extern Plan *resultcache_finished_plan(Plan *subplan, List *param_exprs,
+									   List *hash_operators, bool singlerow);
 extern bool is_projection_capable_path(Path *path);
 extern bool is_projection_capable_plan(Plan *plan);
 
@@ -56,6 +56,17 @@
  */
 #define PARTITION_MAX_KEYS	32
 
+/*
+ * Number of maximum-size chunks of out-of-line values that fit on a page of
+ * a TOAST table, which determines TOAST_MAX_CHUNK_SIZE (see
+ * access/heaptoast.h).  Fewer, larger chunks mean fewer index entries and
+ * tuples to visit when reading a large value, at the cost of more wasted
+ * space in the last chunk of each value.  Must be at least 1.
+ *
+ * Changing this requires an initdb.
+ */
+#define EXTERN_TUPLES_PER_PAGE	4
+
 /*
  * Decide whether built-in 8-byte types, including float8, int8, and
  * timestamp, are passed by value.  This is on by default if sizeof(Datum) >=
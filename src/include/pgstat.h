@@ -14,6 +14,7 @@
 #include "datatype/timestamp.h"
 #include "portability/instr_time.h"
 #include "postmaster/pgarch.h" /* for MAX_XFN_CHARS */
+#include "storage/lwlock.h"
 #include "utils/backend_progress.h" /* for backward compatibility */
 #include "utils/backend_status.h" /* for backward compatibility */
 #include "utils/hsearch.h"
@@ -74,6 +75,8 @@ typedef enum StatMsgType
 	PGSTAT_MTYPE_BGWRITER,
 	PGSTAT_MTYPE_WAL,
 	PGSTAT_MTYPE_SLRU,
+	PGSTAT_MTYPE_IO,
+	PGSTAT_MTYPE_LWLOCK,
 	PGSTAT_MTYPE_RECOVERYPREFETCH,
 	PGSTAT_MTYPE_FUNCSTAT,
 	PGSTAT_MTYPE_FUNCPURGE,
@@ -138,7 +141,9 @@ typedef enum PgStat_Shared_Reset_Target
 {
 	RESET_ARCHIVER,
 	RESET_BGWRITER,
-	RESET_WAL
+	RESET_WAL,
+	RESET_IO,
+	RESET_LWLOCK
 } PgStat_Shared_Reset_Target;
 
 /* Possible object types for resetting single counters */
@@ -532,6 +537,102 @@ typedef struct PgStat_MsgSLRU
 	PgStat_Counter m_truncate;
 } PgStat_MsgSLRU;
 
+/* ----------
+ * I/O statistics are kept separately for each backend type, for the kind of
+ * object the I/O was done on and for the context it was done in, that is
+ * whether it went through the buffer pool normally or through one of the
+ * buffer access strategy rings (see GetAccessStrategy()).
+ * ----------
+ */
+typedef enum IOObject
+{
+	IOOBJECT_RELATION,			/* permanent and unlogged relations */
+	IOOBJECT_TEMP_RELATION		/* temporary relations, in local buffers */
+} IOObject;
+
+#define IOOBJECT_NUM_TYPES (IOOBJECT_TEMP_RELATION + 1)
+
+typedef enum IOContext
+{
+	IOCONTEXT_NORMAL,
+	IOCONTEXT_BULKREAD,
+	IOCONTEXT_BULKWRITE,
+	IOCONTEXT_VACUUM
+} IOContext;
+
+#define IOCONTEXT_NUM_TYPES (IOCONTEXT_VACUUM + 1)
+
+typedef enum IOOp
+{
+	IOOP_READ,
+	IOOP_WRITE,
+	IOOP_EXTEND,
+	IOOP_FSYNC
+} IOOp;
+
+#define IOOP_NUM_TYPES (IOOP_FSYNC + 1)
+
+typedef struct PgStat_IOCounters
+{
+	PgStat_Counter ops[IOOP_NUM_TYPES]; /* # of blocks or files */
+	PgStat_Counter times[IOOP_NUM_TYPES];	/* time spent, in microseconds,
+											 * if track_io_timing is on */
+} PgStat_IOCounters;
+
+/* ----------
+ * PgStat_MsgIO				Sent by a backend to update I/O statistics.
+ * ----------
+ */
+typedef struct PgStat_MsgIO
+{
+	PgStat_MsgHdr m_hdr;
+	BackendType m_backend_type;
+	PgStat_IOCounters m_counters[IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES];
+} PgStat_MsgIO;
+
+/* ----------
+ * LWLock wait statistics are kept per tranche.  All the individual LWLocks
+ * and built-in tranches have their own slot; waits on extension tranches,
+ * whose IDs differ between installations, all count toward a single last
+ * slot.
+ *
+ * Each wait is also counted in a histogram bucket by its duration: bucket
+ * 0 counts waits shorter than 1 microsecond, bucket i waits of at least
+ * 2^(i-1) and less than 2^i microseconds, and the last bucket everything
+ * longer.
+ * ----------
+ */
+#define PGSTAT_NUM_LWLOCK_TRANCHES	(LWTRANCHE_FIRST_USER_DEFINED + 1)
+#define PGSTAT_LWLOCK_HIST_BUCKETS	20
+
+typedef struct PgStat_LWLockCounters
+{
+	PgStat_Counter waits;
+	PgStat_Counter wait_time;	/* time spent waiting, in microseconds */
+	PgStat_Counter hist[PGSTAT_LWLOCK_HIST_BUCKETS];
+} PgStat_LWLockCounters;
+
+typedef struct PgStat_LWLockEntry
+{
+	int			l_tranche;
+	PgStat_LWLockCounters l_counters;
+} PgStat_LWLockEntry;
+
+/* ----------
+ * PgStat_MsgLWLock			Sent by a backend to update LWLock wait statistics.
+ * ----------
+ */
+#define PGSTAT_NUM_LWLOCKENTRIES  \
+	((PGSTAT_MSG_PAYLOAD - sizeof(int))  \
+	 / sizeof(PgStat_LWLockEntry))
+
+typedef struct PgStat_MsgLWLock
+{
+	PgStat_MsgHdr m_hdr;
+	int			m_nentries;
+	PgStat_LWLockEntry m_entry[PGSTAT_NUM_LWLOCKENTRIES];
+} PgStat_MsgLWLock;
+
 /* ----------
  * PgStat_MsgReplSlot	Sent by a backend or a wal sender to update replication
  *						slot statistics.
@@ -725,6 +826,8 @@ typedef union PgStat_Msg
 	PgStat_MsgBgWriter msg_bgwriter;
 	PgStat_MsgWal msg_wal;
 	PgStat_MsgSLRU msg_slru;
+	PgStat_MsgIO msg_io;
+	PgStat_MsgLWLock msg_lwlock;
 	PgStat_MsgRecoveryPrefetch msg_recoveryprefetch;
 	PgStat_MsgFuncstat msg_funcstat;
 	PgStat_MsgFuncpurge msg_funcpurge;
@@ -745,7 +848,7 @@ typedef union PgStat_Msg
  * ------------------------------------------------------------
  */
 
-#define PGSTAT_FILE_FORMAT_ID	0x01A5BCA2
+#define PGSTAT_FILE_FORMAT_ID	0x01A5BCA4
 
 /* ----------
  * PgStat_StatDBEntry			The collector's data per database
@@ -915,6 +1018,24 @@ typedef struct PgStat_SLRUStats
 	TimestampTz stat_reset_timestamp;
 } PgStat_SLRUStats;
 
+/*
+ * I/O statistics kept in the stats collector
+ */
+typedef struct PgStat_IOStats
+{
+	PgStat_IOCounters counters[BACKEND_NUM_TYPES][IOOBJECT_NUM_TYPES][IOCONTEXT_NUM_TYPES];
+	TimestampTz stat_reset_timestamp;
+} PgStat_IOStats;
+
+/*
+ * LWLock wait statistics kept in the stats collector
+ */
+typedef struct PgStat_LWLockStats
+{
+	PgStat_LWLockCounters tranches[PGSTAT_NUM_LWLOCK_TRANCHES];
+	TimestampTz stat_reset_timestamp;
+} PgStat_LWLockStats;
+
 /*
  * Replication slot statistics kept in the stats collector
  */
@@ -1115,6 +1236,8 @@ extern void pgstat_twophase_postabort(TransactionId xid, uint16 info,
 
 extern void pgstat_send_archiver(const char *xlog, bool failed);
 extern void pgstat_send_bgwriter(void);
+extern void pgstat_send_io(void);
+extern void pgstat_send_lwlock(void);
 extern void pgstat_send_recoveryprefetch(PgStat_RecoveryPrefetchStats *stats);
 extern void pgstat_report_wal(void);
 extern bool pgstat_send_wal(bool force);
@@ -1131,6 +1254,8 @@ extern PgStat_ArchiverStats *pgstat_fetch_stat_archiver(void);
 extern PgStat_GlobalStats *pgstat_fetch_global(void);
 extern PgStat_WalStats *pgstat_fetch_stat_wal(void);
 extern PgStat_SLRUStats *pgstat_fetch_slru(void);
+extern PgStat_IOStats *pgstat_fetch_stat_io(void);
+extern PgStat_LWLockStats *pgstat_fetch_stat_lwlock(void);
 extern PgStat_StatReplSlotEntry *pgstat_fetch_replslot(NameData slotname);
 extern PgStat_RecoveryPrefetchStats *pgstat_fetch_recoveryprefetch(void);
 
@@ -1144,4 +1269,15 @@ extern void pgstat_count_slru_truncate(int slru_idx);
 extern const char *pgstat_slru_name(int slru_idx);
 extern int	pgstat_slru_index(const char *name);
 
+extern void pgstat_count_io_ops(IOObject io_object, IOContext io_context,
+								IOOp io_op, int nops);
+extern void pgstat_count_io_time(IOObject io_object, IOContext io_context,
+								 IOOp io_op, instr_time io_time);
+#define pgstat_count_io_op(io_object, io_context, io_op) \
+	pgstat_count_io_ops(io_object, io_context, io_op, 1)
+extern const char *pgstat_io_object_name(IOObject io_object);
+extern const char *pgstat_io_context_name(IOContext io_context);
+
+extern void pgstat_count_lwlock_wait(int tranche_id, instr_time wait_time);
+
 #endif							/* PGSTAT_H */
@@ -0,0 +1,166 @@
+/*-------------------------------------------------------------------------
+ *
+ * simd.h
+ *	  Support for platform-specific vector operations.
+ *
+ * Portions Copyright (c) 1996-2021, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/port/simd.h
+ *
+ * NOTES
+ * - VectorN in this file refers to a register where the element operands
+ * are N bits wide. The vector width is platform-specific, so users that care
+ * about that will need to inspect "sizeof(VectorN)".
+ *
+ * - Only instructions that are part of the baseline of each architecture are
+ * used, SSE2 on x86-64 and Neon on AArch64, so no runtime checks are needed.
+ * Everywhere else the vector is a uint64 and the operations are done with
+ * bitwise arithmetic on it.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef SIMD_H
+#define SIMD_H
+
+#if (defined(__x86_64__) || defined(_M_AMD64))
+/*
+ * SSE2 instructions are part of the spec for the 64-bit x86 ISA. We assume
+ * that compilers targeting this architecture understand SSE2 intrinsics.
+ */
+#include <emmintrin.h>
+#define USE_SSE2
+typedef __m128i Vector8;
+
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+/*
+ * We use the Neon instructions if the compiler provides access to them (as
+ * indicated by __ARM_NEON) and we are on aarch64.  While Neon support is
+ * technically optional for aarch64, it appears that all available 64-bit
+ * hardware does have it.
+ */
+#include <arm_neon.h>
+#define USE_NEON
+typedef uint8x16_t Vector8;
+
+#else
+/*
+ * If no SIMD instructions are available, we can in some cases emulate vector
+ * operations using bitwise operations on unsigned integers.
+ */
+#define USE_NO_SIMD
+typedef uint64 Vector8;
+#endif
+
+/* load/store operations */
+static inline void vector8_load(Vector8 *v, const uint8 *s);
+
+/* assignment operations */
+static inline Vector8 vector8_broadcast(const uint8 c);
+
+/* element-wise comparisons to a scalar */
+static inline bool vector8_has(const Vector8 v, const uint8 c);
+static inline bool vector8_has_zero(const Vector8 v);
+static inline bool vector8_has_le(const Vector8 v, const uint8 c);
+
+/*
+ * Load a chunk of memory into the given vector.
+ */
+static inline void
+vector8_load(Vector8 *v, const uint8 *s)
+{
+#if defined(USE_SSE2)
+	*v = _mm_loadu_si128((const __m128i *) s);
+#elif defined(USE_NEON)
+	*v = vld1q_u8(s);
+#else
+	memcpy(v, s, sizeof(Vector8));
+#endif
+}
+
+/*
+ * Create a vector with all elements set to the same value.
+ */
+static inline Vector8
+vector8_broadcast(const uint8 c)
+{
+#if defined(USE_SSE2)
+	return _mm_set1_epi8(c);
+#elif defined(USE_NEON)
+	return vdupq_n_u8(c);
+#else
+	return ~UINT64CONST(0) / 0xFF * c;
+#endif
+}
+
+/*
+ * Return true if any elements in the vector are equal to the given scalar.
+ */
+static inline bool
+vector8_has(const Vector8 v, const uint8 c)
+{
+#if defined(USE_SSE2)
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(v, vector8_broadcast(c))) != 0;
+#elif defined(USE_NEON)
+	return vmaxvq_u8(vceqq_u8(v, vector8_broadcast(c))) != 0;
+#else
+	/* any byte equal to c becomes zero */
+	return vector8_has_zero(v ^ vector8_broadcast(c));
+#endif
+}
+
+/*
+ * Convenience function equivalent to vector8_has(v, 0)
+ */
+static inline bool
+vector8_has_zero(const Vector8 v)
+{
+#if defined(USE_NO_SIMD)
+	/*
+	 * We cannot call vector8_has() here, because for non-SIMD it calls us.
+	 * See "Determine if a word has a zero byte" at
+	 * https://graphics.stanford.edu/~seander/bithacks.html.  The borrow may
+	 * set bits above a zero byte as well, but never unless there is one.
+	 */
+	return ((v - vector8_broadcast(0x01)) & ~v & vector8_broadcast(0x80)) != 0;
+#else
+	return vector8_has(v, 0);
+#endif
+}
+
+/*
+ * Return true if any elements in the vector are less than or equal to the
+ * given scalar.
+ */
+static inline bool
+vector8_has_le(const Vector8 v, const uint8 c)
+{
+#if defined(USE_SSE2)
+	/* the unsigned minimum equals v exactly where v <= c */
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, vector8_broadcast(c)),
+											 v)) != 0;
+#elif defined(USE_NEON)
+	return vminvq_u8(v) <= c;
+#else
+	/*
+	 * The bit trick of vector8_has_zero() finds bytes less than c + 1, as
+	 * long as that is at most 0x80 and no byte has its high bit set; keep it
+	 * simple otherwise.
+	 */
+	if ((v & vector8_broadcast(0x80)) == 0 && c < 0x80)
+		return ((v - vector8_broadcast(c + 1)) & ~v & vector8_broadcast(0x80)) != 0;
+	else
+	{
+		const uint8 *bytes = (const uint8 *) &v;
+
+		for (int i = 0; i < sizeof(Vector8); i++)
+		{
+			if (bytes[i] <= c)
+				return true;
+		}
+		return false;
+	}
+#endif
+}
+
+#endif							/* SIMD_H */
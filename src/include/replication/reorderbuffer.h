@@ -600,6 +600,10 @@ struct ReorderBuffer
 	char	   *outbuf;
 	Size		outbufsize;
 
+	/* buffer collecting serialized changes before they are written out */
+	char	   *spillbuf;
+	Size		spillbufused;
+
 	/* memory accounting */
 	Size		size;
 
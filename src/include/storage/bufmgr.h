@@ -68,6 +68,7 @@ extern PGDLLIMPORT int NBuffers;
 extern bool zero_damaged_pages;
 extern int	bgwriter_lru_maxpages;
 extern double bgwriter_lru_multiplier;
+extern int	bgwriter_freelist_target;
 extern bool track_io_timing;
 extern int	effective_io_concurrency;
 extern int	maintenance_io_concurrency;
@@ -76,6 +77,11 @@ extern int	checkpoint_flush_after;
 extern int	backend_flush_after;
 extern int	bgwriter_flush_after;
 
+/* in freelist.c */
+extern int	bulk_read_ring_size;
+extern int	bulk_write_ring_size;
+extern int	vacuum_ring_size;
+
 /* in buf_init.c */
 extern PGDLLIMPORT char *BufferBlocks;
 
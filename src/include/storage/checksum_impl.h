@@ -91,6 +91,9 @@
  * largest state that fits into architecturally visible x86 SSE registers while
  * leaving some free registers for intermediate values. For future processors
  * with 256bit vector registers this will leave some performance on the table.
+ * On x86, unless we're targeting such processors anyway, we compile a second
+ * copy of the algorithm for AVX2, which has both the wider registers and
+ * pmulld, and choose between the two at runtime.
  * When vectorization is not available it might be beneficial to restructure
  * the computation to calculate a subset of the columns at a time and perform
  * multiple passes to avoid register spilling. This optimization opportunity
@@ -141,9 +144,12 @@ do { \
 /*
  * Block checksum algorithm.  The page must be adequately aligned
  * (at least on 4-byte boundary).
+ *
+ * This is always inlined into the callers below, so that each of them gets
+ * vectorized for the instruction set it is compiled for.
  */
-static uint32
-pg_checksum_block(const PGChecksummablePage *page)
+static pg_attribute_always_inline uint32
+pg_checksum_block_internal(const PGChecksummablePage *page)
 {
 	uint32		sums[N_SUMS];
 	uint32		result = 0;
@@ -173,6 +179,51 @@ pg_checksum_block(const PGChecksummablePage *page)
 	return result;
 }
 
+#if defined(USE_AVX2_WITH_RUNTIME_CHECK) && !defined(__AVX2__)
+
+static uint32
+pg_checksum_block_generic(const PGChecksummablePage *page)
+{
+	return pg_checksum_block_internal(page);
+}
+
+static uint32
+__attribute__((target("avx2")))
+pg_checksum_block_avx2(const PGChecksummablePage *page)
+{
+	return pg_checksum_block_internal(page);
+}
+
+static uint32 pg_checksum_block_choose(const PGChecksummablePage *page);
+
+static uint32 (*pg_checksum_block) (const PGChecksummablePage *page) =
+pg_checksum_block_choose;
+
+/*
+ * This gets called on the first call.  It replaces the function pointer so
+ * that subsequent calls are routed directly to the chosen implementation.
+ */
+static uint32
+pg_checksum_block_choose(const PGChecksummablePage *page)
+{
+	if (__builtin_cpu_supports("avx2"))
+		pg_checksum_block = pg_checksum_block_avx2;
+	else
+		pg_checksum_block = pg_checksum_block_generic;
+
+	return pg_checksum_block(page);
+}
+
+#else
+
+static inline uint32
+pg_checksum_block(const PGChecksummablePage *page)
+{
+	return pg_checksum_block_internal(page);
+}
+
+#endif							/* USE_AVX2_WITH_RUNTIME_CHECK && !__AVX2__ */
+
 /*
  * Compute the checksum for a Postgres page.
  *
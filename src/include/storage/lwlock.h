@@ -79,8 +79,13 @@ extern PGDLLIMPORT int NamedLWLockTrancheRequests;
  * having this file include lock.h or bufmgr.h would be backwards.
  */
 
-/* Number of partitions of the shared buffer mapping hashtable */
-#define NUM_BUFFER_PARTITIONS  128
+/*
+ * Number of partitions of the shared buffer mapping hashtable.  Every buffer
+ * lookup takes one of these locks, at least in shared mode, so on machines
+ * with many cores the partition locks' cache lines are heavily contended even
+ * for read-only workloads; more partitions spread that traffic out.
+ */
+#define NUM_BUFFER_PARTITIONS  256
 
 /* Number of partitions the shared lock tables are divided into */
 #define LOG2_NUM_LOCK_PARTITIONS  4
@@ -45,15 +45,26 @@ typedef struct PGShmemHeader	/* standard header for all Postgres shmem */
 extern int	shared_memory_type;
 extern int	huge_pages;
 extern int	huge_page_size;
+extern int	shared_memory_numa_policy;
+extern int	shared_memory_prefault_workers;
+extern int	huge_pages_status;
 
 /* Possible values for huge_pages */
 typedef enum
 {
 	HUGE_PAGES_OFF,
 	HUGE_PAGES_ON,
-	HUGE_PAGES_TRY
+	HUGE_PAGES_TRY,				/* only for huge_pages */
+	HUGE_PAGES_UNKNOWN			/* only for huge_pages_status */
 }			HugePagesType;
 
+/* Possible values for shared_memory_numa_policy */
+typedef enum
+{
+	SHMEM_NUMA_DEFAULT,
+	SHMEM_NUMA_INTERLEAVE
+}			ShmemNumaPolicy;
+
 /* Possible values for shared_memory_type */
 typedef enum
 {
@@ -23,29 +23,36 @@
 #include "storage/proclist_types.h"
 
 /*
- * Each backend advertises up to PGPROC_MAX_CACHED_SUBXIDS TransactionIds
- * for non-aborted subtransactions of its current top transaction.  These
- * have to be treated as running XIDs by other backends.
+ * Each backend advertises up to max_cached_subxids TransactionIds for
+ * non-aborted subtransactions of its current top transaction.  These have to
+ * be treated as running XIDs by other backends.
  *
  * We also keep track of whether the cache overflowed (ie, the transaction has
  * generated at least one subtransaction that didn't fit in the cache).
  * If none of the caches have overflowed, we can assume that an XID that's not
  * listed anywhere in the PGPROC array is not a running transaction.  Else we
  * have to look at pg_subtrans.
+ *
+ * PGPROC_MAX_CACHED_SUBXIDS is the minimum size of the cache.  It is also
+ * the number of subxids after which xact.c emits an XLOG_XACT_ASSIGNMENT
+ * record, so it bounds the number of subxids a hot standby has to track per
+ * primary backend, independently of max_cached_subxids.
  */
 #define PGPROC_MAX_CACHED_SUBXIDS 64	/* XXX guessed-at value */
+#define PGPROC_MAX_CACHED_SUBXIDS_LIMIT 8192
 
 typedef struct XidCacheStatus
 {
-	/* number of cached subxids, never more than PGPROC_MAX_CACHED_SUBXIDS */
-	uint8	count;
+	/* number of cached subxids, never more than max_cached_subxids */
+	uint16		count;
 	/* has PGPROC->subxids overflowed */
-	bool	overflowed;
+	bool		overflowed;
 } XidCacheStatus;
 
 struct XidCache
 {
-	TransactionId xids[PGPROC_MAX_CACHED_SUBXIDS];
+	/* points to max_cached_subxids entries in shared memory */
+	TransactionId *xids;
 };
 
 /*
@@ -66,12 +73,23 @@ struct XidCache
 	(PROC_IN_VACUUM | PROC_IN_SAFE_IC | PROC_VACUUM_FOR_WRAPAROUND)
 
 /*
- * We allow a small number of "weak" relation locks (AccessShareLock,
+ * We allow a limited number of "weak" relation locks (AccessShareLock,
  * RowShareLock, RowExclusiveLock) to be recorded in the PGPROC structure
  * rather than the main lock table.  This eases contention on the lock
  * manager LWLocks.  See storage/lmgr/README for additional details.
+ *
+ * The fast-path slots are organized in groups of FP_LOCK_SLOTS_PER_GROUP,
+ * and each relation can only use the slots of the group its OID hashes to,
+ * so that lookups only scan one group.  The number of groups is derived from
+ * max_locks_per_transaction at server start (see InitializeFastPathLocks),
+ * and the per-backend arrays live in shared memory next to the PGPROCs.
  */
-#define		FP_LOCK_SLOTS_PER_BACKEND 16
+extern int	FastPathLockGroupsPerBackend;
+
+#define		FP_LOCK_GROUPS_PER_BACKEND_MAX	1024
+#define		FP_LOCK_SLOTS_PER_GROUP		16	/* don't change: fpLockBits */
+#define		FastPathLockSlotsPerBackend() \
+	(FP_LOCK_SLOTS_PER_GROUP * FastPathLockGroupsPerBackend)
 
 /*
  * An invalid pgprocno.  Must be larger than the maximum number of PGPROC
@@ -238,8 +256,9 @@ struct PGPROC
 
 	/* Lock manager data, recording fast-path locks taken by this backend. */
 	LWLock		fpInfoLock;		/* protects per-backend fast-path state */
-	uint64		fpLockBits;		/* lock modes held for each fast-path slot */
-	Oid			fpRelId[FP_LOCK_SLOTS_PER_BACKEND]; /* slots for rel oids */
+	uint64	   *fpLockBits;		/* lock modes held for each fast-path slot,
+								 * one word per group */
+	Oid		   *fpRelId;		/* slots for rel oids */
 	bool		fpVXIDLock;		/* are we holding a fast-path VXID lock? */
 	LocalTransactionId fpLocalTransactionId;	/* lxid for fast-path VXID
 												 * lock */
@@ -382,6 +401,7 @@ extern PGDLLIMPORT int StatementTimeout;
 extern PGDLLIMPORT int LockTimeout;
 extern PGDLLIMPORT int IdleInTransactionSessionTimeout;
 extern PGDLLIMPORT int IdleSessionTimeout;
+extern PGDLLIMPORT int max_cached_subxids;
 extern bool log_lock_waits;
 
 
@@ -417,5 +437,6 @@ extern PGPROC *AuxiliaryPidGetProc(int pid);
 
 extern void BecomeLockGroupLeader(void);
 extern bool BecomeLockGroupMember(PGPROC *leader, int pid);
+extern void LeaveLockGroup(void);
 
 #endif							/* _PROC_H_ */
@@ -25,6 +25,12 @@
 #include "storage/lock.h"
 #include "storage/sinval.h"
 
+/* upper limit for sinval_queue_size */
+#define MAX_SINVAL_QUEUE_SIZE	(1 << 20)
+
+/* GUC variable */
+extern int	sinval_queue_size;
+
 /*
  * prototypes for functions in sinvaladt.c
  */
@@ -42,6 +42,16 @@ typedef enum SyncRequestHandler
 	SYNC_HANDLER_NONE
 } SyncRequestHandler;
 
+/*
+ * How ProcessSyncRequests() makes the files written since the last
+ * checkpoint durable.
+ */
+typedef enum CheckpointSyncMethod
+{
+	CHECKPOINT_SYNC_METHOD_FSYNC,	/* fsync each file */
+	CHECKPOINT_SYNC_METHOD_SYNCFS	/* syncfs each file system holding one */
+} CheckpointSyncMethod;
+
 /*
  * A tag identifying a file.  Currently it has the members required for md.c's
  * usage, but sync.c has no knowledge of the internal structure, and it is
@@ -55,6 +65,9 @@ typedef struct FileTag
 	uint32		segno;
 } FileTag;
 
+/* GUC parameter */
+extern int	checkpoint_sync_method;
+
 extern void InitSync(void);
 extern void SyncPreCheckpoint(void);
 extern void SyncPostCheckpoint(void);
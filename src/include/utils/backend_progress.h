@@ -27,11 +27,26 @@ typedef enum ProgressCommandType
 	PROGRESS_COMMAND_CLUSTER,
 	PROGRESS_COMMAND_CREATE_INDEX,
 	PROGRESS_COMMAND_BASEBACKUP,
-	PROGRESS_COMMAND_COPY
+	PROGRESS_COMMAND_COPY,
+	PROGRESS_COMMAND_QUERY
 } ProgressCommandType;
 
 #define PGSTAT_NUM_PROGRESS_PARAM	20
 
+/*
+ * Progress of query execution is counted in a local array by whichever code
+ * happens to be running, whether or not anyone is watching, and copied to
+ * the shared entry once a second from pgstat_progress_flush_query().  That
+ * keeps the cost in executor inner loops down to a plain store.
+ */
+extern PGDLLIMPORT bool pgstat_track_query_progress;
+extern PGDLLIMPORT int64 pgstat_query_progress[PGSTAT_NUM_PROGRESS_PARAM];
+
+#define pgstat_progress_query_set(index, val) \
+	(pgstat_query_progress[(index)] = (val))
+#define pgstat_progress_query_incr(index, delta) \
+	(pgstat_query_progress[(index)] += (delta))
+
 
 extern void pgstat_progress_start_command(ProgressCommandType cmdtype,
 										  Oid relid);
@@ -40,5 +55,9 @@ extern void pgstat_progress_update_multi_param(int nparam, const int *index,
 											   const int64 *val);
 extern void pgstat_progress_end_command(void);
 
+extern bool pgstat_progress_start_query(const uint64 *rows_processed);
+extern void pgstat_progress_flush_query(void);
+extern void pgstat_progress_end_query(void);
+
 
 #endif /* BACKEND_PROGRESS_H */
@@ -168,6 +168,13 @@ typedef struct PgBackendStatus
 
 	/* query identifier, optionally computed using post_parse_analyze_hook */
 	uint64		st_query_id;
+
+	/*
+	 * Bytes held in memory context blocks by this backend.  The memory
+	 * context code updates this directly, without following the
+	 * st_changecount protocol, so readers may see a slightly stale value.
+	 */
+	int64		st_allocated_bytes;
 } PgBackendStatus;
 
 
@@ -305,6 +312,8 @@ extern const char *pgstat_get_backend_current_activity(int pid, bool checkUser);
 extern const char *pgstat_get_crashed_backend_activity(int pid, char *buffer,
 													   int buflen);
 extern uint64 pgstat_get_my_query_id(void);
+extern bool pgstat_get_backend_sample(int beid, int pid,
+									  BackendState *state, uint64 *query_id);
 
 
 /* ----------
@@ -148,11 +148,35 @@ extern void MemoryContextCreate(MemoryContext node,
 extern void HandleLogMemoryContextInterrupt(void);
 extern void ProcessLogMemoryContextInterrupt(void);
 
+/* reporting memory contexts to other backends, in mcxtfuncs.c */
+extern Size MemoryContextDumpShmemSize(void);
+extern void MemoryContextDumpShmemInit(void);
+extern void HandleDumpMemoryContextInterrupt(void);
+extern void ProcessDumpMemoryContextInterrupt(void);
+
+/*
+ * Total size of the blocks that this process's memory contexts currently
+ * hold from malloc().  The context implementations maintain it when they
+ * acquire or release a block.  Once the process has a backend status
+ * entry it points there, so that other sessions can see it in
+ * pg_stat_activity; see MemoryContextSetAllocatedBytesTarget().
+ */
+extern PGDLLIMPORT int64 *MemoryContextAllocatedBytes;
+
+#define MemoryContextCountAlloc(size) \
+	(*MemoryContextAllocatedBytes += (int64) (size))
+#define MemoryContextCountFree(size) \
+	(*MemoryContextAllocatedBytes -= (int64) (size))
+
+extern void MemoryContextSetAllocatedBytesTarget(int64 *target);
+
 /*
  * Memory-context-type-specific functions
  */
 
 /* aset.c */
+extern PGDLLIMPORT int memory_block_cache_size;
+
 extern MemoryContext AllocSetContextCreateInternal(MemoryContext parent,
 												   const char *name,
 												   Size minContextSize,
@@ -185,6 +209,13 @@ extern MemoryContext GenerationContextCreate(MemoryContext parent,
 											 const char *name,
 											 Size blockSize);
 
+/* bump.c */
+extern MemoryContext BumpContextCreate(MemoryContext parent,
+									   const char *name,
+									   Size minContextSize,
+									   Size initBlockSize,
+									   Size maxBlockSize);
+
 /*
  * Recommended default alloc parameters, suitable for "ordinary" contexts
  * that might hold quite a lot of data.
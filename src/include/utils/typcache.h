@@ -206,4 +206,6 @@ extern void SharedRecordTypmodRegistryInit(SharedRecordTypmodRegistry *,
 
 extern void SharedRecordTypmodRegistryAttach(SharedRecordTypmodRegistry *);
 
+extern bool SharedRecordTypmodRegistryForget(void);
+
 #endif							/* TYPCACHE_H */
@@ -6090,6 +6090,45 @@ exec_eval_simple_expr(PLpgSQL_execstate *estate,
 	*rettype = expr->expr_simple_type;
 	*rettypmod = expr->expr_simple_typmod;
 
+	/*
+	 * If the expression is just a constant, or just a reference to a plain
+	 * variable (as in "RETURN x", "IF found THEN" or "x := 0"), there's no
+	 * need to run it through the executor.  We do what evaluating the
+	 * Const or the Param would do: return a pointer to the constant's value,
+	 * or the variable's value as read-only.
+	 */
+	if (IsA(expr->expr_simple_expr, Const))
+	{
+		Const	   *con = (Const *) expr->expr_simple_expr;
+
+		*result = con->constvalue;
+		*isNull = con->constisnull;
+		return true;
+	}
+	else if (IsA(expr->expr_simple_expr, Param) &&
+			 ((Param *) expr->expr_simple_expr)->paramkind == PARAM_EXTERN &&
+			 expr->expr_rw_param == NULL)
+	{
+		int			dno = ((Param *) expr->expr_simple_expr)->paramid - 1;
+		PLpgSQL_var *var;
+
+		Assert(dno >= 0 && dno < estate->ndatums);
+		var = (PLpgSQL_var *) estate->datums[dno];
+
+		if (var->dtype == PLPGSQL_DTYPE_VAR)
+		{
+			Assert(var->datatype->typoid == *rettype);
+			if (var->datatype->typlen == -1)
+				*result = MakeExpandedObjectReadOnly(var->value,
+													 var->isnull,
+													 -1);
+			else
+				*result = var->value;
+			*isNull = var->isnull;
+			return true;
+		}
+	}
+
 	/*
 	 * Set up ParamListInfo to pass to executor.  For safety, save and restore
 	 * estate->paramLI->parserSetupArg around our use of the param list.
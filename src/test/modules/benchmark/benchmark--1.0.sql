@@ -0,0 +1,30 @@
+/* src/test/modules/benchmark/benchmark--1.0.sql */
+
+-- complain if script is sourced in psql, rather than via CREATE EXTENSION
+\echo Use "CREATE EXTENSION benchmark" to load this file. \quit
+
+-- All of these return the time taken by the workload, in milliseconds
+
+CREATE FUNCTION bench_tuplesort(ntuples bigint)
+RETURNS pg_catalog.float8 STRICT
+AS 'MODULE_PATHNAME' LANGUAGE C;
+
+CREATE FUNCTION bench_allocset(nallocs bigint)
+RETURNS pg_catalog.float8 STRICT
+AS 'MODULE_PATHNAME' LANGUAGE C;
+
+CREATE FUNCTION bench_compress(method text, loops integer)
+RETURNS pg_catalog.float8 STRICT
+AS 'MODULE_PATHNAME' LANGUAGE C;
+
+CREATE FUNCTION bench_wal_insert(nrecords bigint, size integer)
+RETURNS pg_catalog.float8 STRICT
+AS 'MODULE_PATHNAME' LANGUAGE C;
+
+CREATE FUNCTION bench_sql(query text, loops integer)
+RETURNS pg_catalog.float8 STRICT
+AS 'MODULE_PATHNAME' LANGUAGE C;
+
+-- Writing WAL and running arbitrary queries shouldn't be open to everyone
+REVOKE ALL ON FUNCTION bench_wal_insert(bigint, integer) FROM PUBLIC;
+REVOKE ALL ON FUNCTION bench_sql(text, integer) FROM PUBLIC;
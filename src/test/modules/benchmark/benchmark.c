@@ -0,0 +1,324 @@
+/*--------------------------------------------------------------------------
+ *
+ * benchmark.c
+ *		Microbenchmarks for backend hot paths.
+ *
+ * Each function runs one workload in a tight loop and returns the time it
+ * took in milliseconds, so that the measurement doesn't include the cost of
+ * getting the query to and from the server.  All input data is generated
+ * from a fixed seed, so repeated runs do the same work.
+ *
+ * Copyright (c) 2021, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *		src/test/modules/benchmark/benchmark.c
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+#include "access/xlog.h"
+#include "access/xloginsert.h"
+#include "catalog/pg_control.h"
+#include "catalog/pg_operator_d.h"
+#include "catalog/pg_type_d.h"
+#include "common/pg_lzcompress.h"
+#include "executor/spi.h"
+#include "fmgr.h"
+#include "miscadmin.h"
+#include "portability/instr_time.h"
+#include "utils/builtins.h"
+#include "utils/memutils.h"
+#include "utils/tuplesort.h"
+
+PG_MODULE_MAGIC;
+
+/* size of the input for bench_compress() */
+#define COMPRESS_INPUT_SIZE		(1024 * 1024)
+
+/* number of chunks bench_allocset() keeps allocated at a time */
+#define ALLOCSET_LIVE_CHUNKS	1000
+
+PG_FUNCTION_INFO_V1(bench_tuplesort);
+PG_FUNCTION_INFO_V1(bench_allocset);
+PG_FUNCTION_INFO_V1(bench_compress);
+PG_FUNCTION_INFO_V1(bench_wal_insert);
+PG_FUNCTION_INFO_V1(bench_sql);
+
+/*
+ * A small deterministic pseudo-random number generator (splitmix64).  We
+ * don't use random() because its sequence depends on the platform.
+ */
+static inline uint64
+bench_random(uint64 *state)
+{
+	uint64		z = (*state += UINT64CONST(0x9E3779B97F4A7C15));
+
+	z = (z ^ (z >> 30)) * UINT64CONST(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64CONST(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+static inline Datum
+elapsed_ms(instr_time start)
+{
+	instr_time	duration;
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+
+	return Float8GetDatum(INSTR_TIME_GET_MILLISEC(duration));
+}
+
+/*
+ * Sort 'ntuples' random int8 values, and read them back.
+ */
+Datum
+bench_tuplesort(PG_FUNCTION_ARGS)
+{
+	int64		ntuples = PG_GETARG_INT64(0);
+	uint64		seed = 0;
+	Tuplesortstate *state;
+	Datum		value;
+	bool		isnull;
+	instr_time	start;
+
+	INSTR_TIME_SET_CURRENT(start);
+
+	state = tuplesort_begin_datum(INT8OID, Int8LessOperator, InvalidOid,
+								  false, work_mem, NULL, false);
+
+	for (int64 i = 0; i < ntuples; i++)
+	{
+		CHECK_FOR_INTERRUPTS();
+		tuplesort_putdatum(state,
+						   Int64GetDatum((int64) bench_random(&seed)),
+						   false);
+	}
+
+	tuplesort_performsort(state);
+
+	while (tuplesort_getdatum(state, true, &value, &isnull, NULL))
+		CHECK_FOR_INTERRUPTS();
+
+	tuplesort_end(state);
+
+	PG_RETURN_DATUM(elapsed_ms(start));
+}
+
+/*
+ * Do 'nallocs' pallocs of random sizes between 8 and 512 bytes in an
+ * AllocSet context, freeing older chunks as we go so that the freelists
+ * get exercised as well.
+ */
+Datum
+bench_allocset(PG_FUNCTION_ARGS)
+{
+	int64		nallocs = PG_GETARG_INT64(0);
+	uint64		seed = 0;
+	MemoryContext benchcxt;
+	MemoryContext oldcxt;
+	void	   *chunks[ALLOCSET_LIVE_CHUNKS] = {0};
+	instr_time	start;
+
+	INSTR_TIME_SET_CURRENT(start);
+
+	benchcxt = AllocSetContextCreate(CurrentMemoryContext,
+									 "benchmark",
+									 ALLOCSET_DEFAULT_SIZES);
+	oldcxt = MemoryContextSwitchTo(benchcxt);
+
+	for (int64 i = 0; i < nallocs; i++)
+	{
+		int			slot = i % ALLOCSET_LIVE_CHUNKS;
+
+		if (slot == 0)
+			CHECK_FOR_INTERRUPTS();
+
+		if (chunks[slot] != NULL)
+			pfree(chunks[slot]);
+		chunks[slot] = palloc(8 + bench_random(&seed) % 505);
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+	MemoryContextDelete(benchcxt);
+
+	PG_RETURN_DATUM(elapsed_ms(start));
+}
+
+/*
+ * Compress and decompress a 1MB buffer 'loops' times, with the given
+ * method.  The input is made of random words from a small vocabulary, so
+ * it compresses to roughly a third of its size, like typical text.
+ */
+Datum
+bench_compress(PG_FUNCTION_ARGS)
+{
+	char	   *method = text_to_cstring(PG_GETARG_TEXT_PP(0));
+	int32		loops = PG_GETARG_INT32(1);
+	static const char *const words[] = {
+		"select", "from", "where", "postgres", "tuple", "buffer", "index",
+		"page", "heap", "relation", "transaction", "snapshot", "vacuum",
+		"checkpoint", "the", "and", " ", "\n", "0", "42"
+	};
+	uint64		seed = 0;
+	char	   *source;
+	char	   *compressed;
+	char	   *decompressed;
+	int32		clen = 0;
+	int32		capacity;
+	int			pos = 0;
+	bool		use_lz4;
+	instr_time	start;
+
+	if (strcmp(method, "pglz") == 0)
+		use_lz4 = false;
+	else if (strcmp(method, "lz4") == 0)
+	{
+#ifndef USE_LZ4
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("compression method lz4 not supported"),
+				 errdetail("This functionality requires the server to be built with lz4 support.")));
+#endif
+		use_lz4 = true;
+	}
+	else
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("unrecognized compression method \"%s\"", method)));
+
+	source = palloc(COMPRESS_INPUT_SIZE);
+	while (pos < COMPRESS_INPUT_SIZE)
+	{
+		const char *word = words[bench_random(&seed) % lengthof(words)];
+		int			len = Min(strlen(word), COMPRESS_INPUT_SIZE - pos);
+
+		memcpy(source + pos, word, len);
+		pos += len;
+	}
+
+	capacity = PGLZ_MAX_OUTPUT(COMPRESS_INPUT_SIZE);
+#ifdef USE_LZ4
+	capacity = Max(capacity, LZ4_compressBound(COMPRESS_INPUT_SIZE));
+#endif
+	compressed = palloc(capacity);
+	decompressed = palloc(COMPRESS_INPUT_SIZE);
+
+	INSTR_TIME_SET_CURRENT(start);
+
+	for (int32 i = 0; i < loops; i++)
+	{
+		int32		rawsize = 0;
+
+		CHECK_FOR_INTERRUPTS();
+
+		if (use_lz4)
+		{
+#ifdef USE_LZ4
+			clen = LZ4_compress_default(source, compressed,
+										COMPRESS_INPUT_SIZE, capacity);
+			rawsize = LZ4_decompress_safe(compressed, decompressed,
+										  clen, COMPRESS_INPUT_SIZE);
+#endif
+		}
+		else
+		{
+			/* always compress, whatever the default strategy would say */
+			clen = pglz_compress(source, COMPRESS_INPUT_SIZE, compressed,
+								 PGLZ_strategy_always);
+			rawsize = pglz_decompress(compressed, clen, decompressed,
+									  COMPRESS_INPUT_SIZE, true);
+		}
+
+		if (clen <= 0 || rawsize != COMPRESS_INPUT_SIZE)
+			elog(ERROR, "%s compression round trip failed", method);
+	}
+
+	PG_RETURN_DATUM(elapsed_ms(start));
+}
+
+/*
+ * Insert 'nrecords' XLOG_NOOP records carrying 'size' bytes of payload.
+ */
+Datum
+bench_wal_insert(PG_FUNCTION_ARGS)
+{
+	int64		nrecords = PG_GETARG_INT64(0);
+	int32		size = PG_GETARG_INT32(1);
+	char	   *payload;
+	instr_time	start;
+
+	if (RecoveryInProgress())
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("recovery is in progress"),
+				 errhint("WAL control functions cannot be executed during recovery.")));
+
+	if (size < 0 || size > BLCKSZ)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("record size must be between 0 and %d", BLCKSZ)));
+
+	payload = palloc0(size);
+
+	INSTR_TIME_SET_CURRENT(start);
+
+	for (int64 i = 0; i < nrecords; i++)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		XLogBeginInsert();
+		XLogRegisterData(payload, size);
+		(void) XLogInsert(RM_XLOG_ID, XLOG_NOOP);
+	}
+
+	PG_RETURN_DATUM(elapsed_ms(start));
+}
+
+/*
+ * Execute a query 'loops' times.  The query is planned once, so this
+ * measures execution only; use it for paths that are best reached through
+ * SQL, such as joins, expression evaluation, heap insertion and index
+ * searches.
+ */
+Datum
+bench_sql(PG_FUNCTION_ARGS)
+{
+	char	   *query = text_to_cstring(PG_GETARG_TEXT_PP(0));
+	int32		loops = PG_GETARG_INT32(1);
+	SPIPlanPtr	plan;
+	Datum		result;
+	instr_time	start;
+
+	SPI_connect();
+
+	plan = SPI_prepare(query, 0, NULL);
+	if (plan == NULL)
+		elog(ERROR, "SPI_prepare(\"%s\") failed: %s",
+			 query, SPI_result_code_string(SPI_result));
+
+	INSTR_TIME_SET_CURRENT(start);
+
+	for (int32 i = 0; i < loops; i++)
+	{
+		int			ret;
+
+		CHECK_FOR_INTERRUPTS();
+
+		ret = SPI_execute_plan(plan, NULL, NULL, false, 0);
+		if (ret < 0)
+			elog(ERROR, "SPI_execute_plan(\"%s\") failed: %s",
+				 query, SPI_result_code_string(ret));
+	}
+
+	result = elapsed_ms(start);
+
+	SPI_finish();
+
+	PG_RETURN_DATUM(result);
+}
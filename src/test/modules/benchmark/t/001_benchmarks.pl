@@ -0,0 +1,116 @@
+# Copyright (c) 2021, PostgreSQL Global Development Group
+
+# Run the microbenchmarks and write their results to
+# tmp_check/benchmark_results.tsv.
+#
+# Each benchmark is run once to warm up, and then BENCHMARK_REPEAT times
+# (5 by default); the median, minimum and maximum of the timed runs are
+# reported, in milliseconds.  The tests only check that every benchmark
+# ran, the timings have to be compared by whoever looks at the results.
+
+use strict;
+use warnings;
+use PostgresNode;
+use TestLib;
+use Test::More;
+
+my $repeat = $ENV{BENCHMARK_REPEAT} || 5;
+
+my $node = get_new_node('main');
+$node->init;
+# Keep background activity and parallelism from adding noise
+$node->append_conf(
+	'postgresql.conf', qq{
+shared_buffers = 256MB
+work_mem = 64MB
+max_wal_size = 4GB
+checkpoint_timeout = 1h
+autovacuum = off
+jit = off
+max_parallel_workers_per_gather = 0
+});
+$node->start;
+
+$node->safe_psql(
+	'postgres', q{
+CREATE EXTENSION benchmark;
+CREATE TABLE bench_outer AS
+  SELECT g AS id, (g * 7919) % 100000 AS k, g % 1000 AS a, g AS b
+  FROM generate_series(1, 1000000) g;
+CREATE TABLE bench_inner AS
+  SELECT g AS id, md5(g::text) AS payload
+  FROM generate_series(1, 100000) g;
+CREATE INDEX ON bench_inner (id);
+CREATE TABLE bench_insert (a int, b int);
+VACUUM ANALYZE;
+});
+
+my $lz4_supported = $node->safe_psql('postgres',
+	"SELECT 'lz4' = ANY (enumvals) FROM pg_settings WHERE name = 'default_toast_compression'"
+) eq 't';
+
+# name, setup run untimed before each run, query returning milliseconds
+my @benchmarks = (
+	[ 'tuplesort_int8', undef, 'SELECT bench_tuplesort(1000000)' ],
+	[
+		'hash_join',
+		'SET enable_mergejoin = off; SET enable_nestloop = off;',
+		q{SELECT bench_sql('SELECT count(*) FROM bench_outer o JOIN bench_inner i ON o.k = i.id', 5)}
+	],
+	[
+		'expression_eval', undef,
+		q{SELECT bench_sql('SELECT sum(a * 2 + b % 7) FROM bench_outer WHERE a > 10 AND b <> 3', 5)}
+	],
+	[
+		'heap_insert', 'TRUNCATE bench_insert;',
+		q{SELECT bench_sql('INSERT INTO bench_insert SELECT g, g FROM generate_series(1, 500000) g', 1)}
+	],
+	[
+		'btree_search',
+		'SET enable_hashjoin = off; SET enable_mergejoin = off; SET enable_bitmapscan = off;',
+		q{SELECT bench_sql('SELECT count(*) FROM bench_outer o JOIN bench_inner i ON o.k = i.id', 1)}
+	],
+	[ 'wal_insert',   undef, 'SELECT bench_wal_insert(1000000, 64)' ],
+	[ 'allocset',     undef, 'SELECT bench_allocset(10000000)' ],
+	[ 'pglz_compress', undef, q{SELECT bench_compress('pglz', 50)} ]);
+
+push @benchmarks, [ 'lz4_compress', undef, q{SELECT bench_compress('lz4', 50)} ]
+  if $lz4_supported;
+
+my $results_file = "$TestLib::tmp_check/benchmark_results.tsv";
+open my $results, '>', $results_file
+  or die "could not open \"$results_file\": $!";
+print $results "benchmark\truns\tmedian_ms\tmin_ms\tmax_ms\n";
+
+foreach my $benchmark (@benchmarks)
+{
+	my ($name, $setup, $query) = @$benchmark;
+	my @timings;
+
+	for my $run (0 .. $repeat)
+	{
+		my $sql = defined $setup ? "$setup $query" : $query;
+		my $ms = $node->safe_psql('postgres', $sql);
+
+		# the first run is only a warm-up
+		push @timings, $ms if $run > 0;
+	}
+
+	@timings = sort { $a <=> $b } @timings;
+	my $median =
+	  @timings % 2
+	  ? $timings[ $#timings / 2 ]
+	  : ($timings[ @timings / 2 - 1 ] + $timings[ @timings / 2 ]) / 2;
+
+	printf $results "%s\t%d\t%.3f\t%.3f\t%.3f\n",
+	  $name, scalar(@timings), $median, $timings[0], $timings[-1];
+	note sprintf("%s: median %.3f ms", $name, $median);
+
+	ok(@timings == $repeat, "benchmark $name ran");
+}
+
+close $results;
+
+$node->stop;
+
+done_testing();
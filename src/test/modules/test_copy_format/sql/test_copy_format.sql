@@ -0,0 +1,86 @@
+LOAD 'test_copy_format';
+
+CREATE TABLE copytest (a int, b text, c date);
+INSERT INTO copytest VALUES (1, 'one', '2021-01-01'), (2, NULL, NULL),
+	(3, 'x=y', '2021-12-31');
+
+COPY copytest TO stdout (FORMAT test_copy_format);
+COPY copytest (c, a) TO stdout (FORMAT test_copy_format);
+COPY (SELECT a, b FROM copytest WHERE a = 3) TO stdout (FORMAT test_copy_format);
+
+CREATE TABLE copytest2 (LIKE copytest);
+COPY copytest2 FROM stdin (FORMAT test_copy_format);
+a=1
+b=one
+c=2021-01-01
+
+a=2
+b
+c
+
+a=3
+b=x=y
+c=2021-12-31
+
+\.
+SELECT * FROM copytest2 ORDER BY a;
+COPY copytest2 (c, a) FROM stdin (FORMAT test_copy_format);
+c=2022-02-02
+a=4
+
+\.
+SELECT * FROM copytest2 WHERE a = 4;
+
+-- omitted columns get their defaults
+CREATE TABLE copytest3 (a int, b text DEFAULT 'dflt', c date DEFAULT '2000-01-01');
+COPY copytest3 (a) FROM stdin (FORMAT test_copy_format);
+a=1
+
+a
+
+\.
+SELECT * FROM copytest3 ORDER BY a;
+
+-- round trip through a file
+\copy copytest to 'results/copytest.data' (format test_copy_format)
+CREATE TABLE copytest4 (LIKE copytest);
+\copy copytest4 from 'results/copytest.data' (format test_copy_format)
+(TABLE copytest EXCEPT TABLE copytest4)
+UNION ALL
+(TABLE copytest4 EXCEPT TABLE copytest);
+
+-- malformed input
+COPY copytest2 (a, b) FROM stdin (FORMAT test_copy_format);
+b=x
+a=5
+
+\.
+COPY copytest2 (a, b) FROM stdin (FORMAT test_copy_format);
+a=5
+\.
+COPY copytest2 (a, b) FROM stdin (FORMAT test_copy_format);
+a=5
+b=x
+c=2022-02-02
+
+\.
+-- the error context reports the row that failed
+COPY copytest2 (a, b) FROM stdin (FORMAT test_copy_format);
+a=5
+b=x
+
+a=six
+b=y
+
+\.
+COPY (SELECT E'two\nlines' AS b) TO stdout (FORMAT test_copy_format);
+
+-- options that only apply to the built-in formats
+COPY copytest TO stdout (FORMAT test_copy_format, HEADER);
+COPY copytest TO stdout (FORMAT test_copy_format, DELIMITER ',');
+COPY copytest TO stdout (FORMAT test_copy_format, NULL 'x');
+COPY copytest2 FROM stdin (FORMAT test_copy_format, HEADER);
+COPY copytest2 FROM stdin (FORMAT test_copy_format, DELIMITER ',');
+COPY copytest2 FROM stdin (FORMAT test_copy_format, NULL 'x');
+
+DROP TABLE copytest, copytest2, copytest3, copytest4;
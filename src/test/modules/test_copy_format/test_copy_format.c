@@ -0,0 +1,224 @@
+/*-------------------------------------------------------------------------
+ *
+ * test_copy_format.c
+ *		Test module for COPY formats provided by extensions.
+ *
+ * The format writes each row as one line per column, "name=value" for a
+ * value or just "name" for a null, followed by an empty line.  COPY FROM
+ * reads that back, insisting on the columns coming in the expected order.
+ * Values containing newlines can't be represented.
+ *
+ * Copyright (c) 2021, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/test/modules/test_copy_format/test_copy_format.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "commands/copy.h"
+#include "executor/tuptable.h"
+#include "fmgr.h"
+#include "lib/stringinfo.h"
+#include "utils/lsyscache.h"
+
+PG_MODULE_MAGIC;
+
+void		_PG_init(void);
+
+/* Private state of a COPY using our format */
+typedef struct TestCopyState
+{
+	TupleDesc	tupDesc;
+	List	   *attnumlist;
+	FmgrInfo   *flinfo;			/* I/O functions, indexed by attnum - 1 */
+	Oid		   *typioparams;	/* for input functions only */
+	StringInfoData line;		/* COPY FROM's current line */
+} TestCopyState;
+
+static void *test_copy_to_start(CopyToState cstate, TupleDesc tupDesc,
+								List *attnumlist);
+static void test_copy_to_one_row(CopyToState cstate, void *state,
+								 TupleTableSlot *slot);
+static void *test_copy_from_start(CopyFromState cstate, TupleDesc tupDesc,
+								  List *attnumlist);
+static bool test_copy_from_one_row(CopyFromState cstate, void *state,
+								   Datum *values, bool *nulls);
+static bool test_copy_read_line(CopyFromState cstate, StringInfo line);
+
+static const CopyFormatRoutine test_copy_format_routine = {
+	.name = "test_copy_format",
+	.copy_to_start = test_copy_to_start,
+	.copy_to_one_row = test_copy_to_one_row,
+	.copy_to_end = NULL,
+	.copy_from_start = test_copy_from_start,
+	.copy_from_one_row = test_copy_from_one_row,
+	.copy_from_end = NULL
+};
+
+/*
+ * Module load callback
+ */
+void
+_PG_init(void)
+{
+	RegisterCopyFormat(&test_copy_format_routine);
+}
+
+static void *
+test_copy_to_start(CopyToState cstate, TupleDesc tupDesc, List *attnumlist)
+{
+	TestCopyState *state = palloc0(sizeof(TestCopyState));
+	ListCell   *lc;
+
+	state->tupDesc = tupDesc;
+	state->attnumlist = attnumlist;
+	state->flinfo = palloc0(tupDesc->natts * sizeof(FmgrInfo));
+
+	foreach(lc, attnumlist)
+	{
+		int			attnum = lfirst_int(lc);
+		Form_pg_attribute attr = TupleDescAttr(tupDesc, attnum - 1);
+		Oid			func_oid;
+		bool		is_varlena;
+
+		getTypeOutputInfo(attr->atttypid, &func_oid, &is_varlena);
+		fmgr_info(func_oid, &state->flinfo[attnum - 1]);
+	}
+
+	return state;
+}
+
+static void
+test_copy_to_one_row(CopyToState cstate, void *state, TupleTableSlot *slot)
+{
+	TestCopyState *tstate = (TestCopyState *) state;
+	ListCell   *lc;
+
+	foreach(lc, tstate->attnumlist)
+	{
+		int			attnum = lfirst_int(lc);
+		char	   *name = NameStr(TupleDescAttr(tstate->tupDesc,
+												 attnum - 1)->attname);
+
+		CopyToSendData(cstate, name, strlen(name));
+		if (!slot->tts_isnull[attnum - 1])
+		{
+			char	   *value;
+
+			value = OutputFunctionCall(&tstate->flinfo[attnum - 1],
+									   slot->tts_values[attnum - 1]);
+			if (strchr(value, '\n') != NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("value of column \"%s\" contains a newline",
+								name)));
+			CopyToSendData(cstate, "=", 1);
+			CopyToSendData(cstate, value, strlen(value));
+		}
+		CopyToSendData(cstate, "\n", 1);
+	}
+	CopyToSendData(cstate, "\n", 1);
+}
+
+static void *
+test_copy_from_start(CopyFromState cstate, TupleDesc tupDesc,
+					 List *attnumlist)
+{
+	TestCopyState *state = palloc0(sizeof(TestCopyState));
+	ListCell   *lc;
+
+	state->tupDesc = tupDesc;
+	state->attnumlist = attnumlist;
+	state->flinfo = palloc0(tupDesc->natts * sizeof(FmgrInfo));
+	state->typioparams = palloc0(tupDesc->natts * sizeof(Oid));
+	initStringInfo(&state->line);
+
+	foreach(lc, attnumlist)
+	{
+		int			attnum = lfirst_int(lc);
+		Form_pg_attribute attr = TupleDescAttr(tupDesc, attnum - 1);
+		Oid			func_oid;
+
+		getTypeInputInfo(attr->atttypid, &func_oid,
+						 &state->typioparams[attnum - 1]);
+		fmgr_info(func_oid, &state->flinfo[attnum - 1]);
+	}
+
+	return state;
+}
+
+static bool
+test_copy_from_one_row(CopyFromState cstate, void *state,
+					   Datum *values, bool *nulls)
+{
+	TestCopyState *tstate = (TestCopyState *) state;
+	StringInfo	line = &tstate->line;
+	ListCell   *lc;
+	bool		first = true;
+
+	foreach(lc, tstate->attnumlist)
+	{
+		int			attnum = lfirst_int(lc);
+		Form_pg_attribute attr = TupleDescAttr(tstate->tupDesc, attnum - 1);
+		char	   *name = NameStr(attr->attname);
+		size_t		namelen = strlen(name);
+
+		if (!test_copy_read_line(cstate, line))
+		{
+			if (first)
+				return false;
+			ereport(ERROR,
+					(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+					 errmsg("missing data for column \"%s\"", name)));
+		}
+		first = false;
+
+		if (strncmp(line->data, name, namelen) != 0 ||
+			(line->data[namelen] != '\0' && line->data[namelen] != '='))
+			ereport(ERROR,
+					(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+					 errmsg("expected data for column \"%s\", got \"%s\"",
+							name, line->data)));
+
+		if (line->data[namelen] == '=')
+		{
+			values[attnum - 1] =
+				InputFunctionCall(&tstate->flinfo[attnum - 1],
+								  line->data + namelen + 1,
+								  tstate->typioparams[attnum - 1],
+								  attr->atttypmod);
+			nulls[attnum - 1] = false;
+		}
+	}
+
+	/* A row ends with an empty line */
+	if (!test_copy_read_line(cstate, line) || line->len != 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+				 errmsg("extra data after last expected column")));
+
+	return true;
+}
+
+/*
+ * Read the next line of input, without its newline.  Returns false at the
+ * end of the input.
+ */
+static bool
+test_copy_read_line(CopyFromState cstate, StringInfo line)
+{
+	char		c;
+
+	resetStringInfo(line);
+	while (CopyFromReadData(cstate, &c, 1) == 1)
+	{
+		if (c == '\n')
+			return true;
+		appendStringInfoChar(line, c);
+	}
+
+	return line->len > 0;
+}
@@ -0,0 +1,99 @@
+
+# Copyright (c) 2021, PostgreSQL Global Development Group
+
+# Verify that pooled parallel workers can serve leaders of different
+# sessions that use anonymous record types
+use strict;
+use warnings;
+use PostgresNode;
+use TestLib;
+use Test::More tests => 6;
+
+my $node = get_new_node('primary');
+$node->init();
+$node->append_conf(
+	'postgresql.conf', qq{
+parallel_worker_idle_timeout = 5min
+max_parallel_workers_per_gather = 2
+parallel_setup_cost = 0
+parallel_tuple_cost = 0
+min_parallel_table_scan_size = 0
+parallel_leader_participation = off
+});
+$node->start;
+
+$node->safe_psql(
+	'postgres', q{
+CREATE TABLE pooltab (a int) WITH (parallel_workers = 2);
+INSERT INTO pooltab SELECT generate_series(1, 1000);
+ANALYZE pooltab;
+});
+
+my $idle_workers = q{
+SELECT string_agg(pid::text, ',' ORDER BY pid) FROM pg_stat_activity
+WHERE backend_type = 'parallel worker' AND wait_event = 'ParallelWorkerIdle'};
+my $two_idle_workers = q{
+SELECT count(*) = 2 FROM pg_stat_activity
+WHERE backend_type = 'parallel worker' AND wait_event = 'ParallelWorkerIdle'};
+
+# The workers build the anonymous records, so they register the typmods in
+# the leader's shared registry, and the leader has to look them up there.
+my $result = $node->safe_psql(
+	'postgres', q{
+SELECT r FROM (SELECT ROW(a, a::text) AS r FROM pooltab) s
+WHERE (r).f1 IN (1, 1000) ORDER BY (r).f1});
+is($result, "(1,1)\n(1000,1000)", 'records from new workers');
+
+$node->poll_query_until('postgres', $two_idle_workers)
+  or die "timed out waiting for parallel workers to go idle";
+my $pids = $node->safe_psql('postgres', $idle_workers);
+
+# Another session gets the same workers.  Its first record type has the same
+# typmod as the first session's, but a different shape, so workers that
+# still remembered the old one would hand back the wrong tuple descriptor.
+$result = $node->safe_psql(
+	'postgres', q{
+SELECT r FROM (SELECT ROW(a::text, a * 2, 'x'::text) AS r FROM pooltab) s
+WHERE (r).f2 IN (2, 2000) ORDER BY (r).f2});
+is($result, "(1,2,x)\n(1000,2000,x)", 'records from pooled workers');
+
+$result = $node->safe_psql(
+	'postgres', q{
+SELECT count(*), sum((r).f1) FROM
+  (SELECT ROW(a, ROW(a, a::text)) AS r FROM pooltab) s
+WHERE ((r).f2).f2 = (r).f1::text});
+is($result, "1000|500500", 'nested records from pooled workers');
+
+$node->poll_query_until('postgres', $two_idle_workers)
+  or die "timed out waiting for parallel workers to go idle";
+is($node->safe_psql('postgres', $idle_workers),
+	$pids, 'the same workers served both sessions');
+
+# A leader that has loaded another library must not get workers that lack
+# it, or that have hooks from libraries it never loaded.
+$result = $node->safe_psql(
+	'postgres', q{
+LOAD 'plpgsql';
+SELECT count(*) FROM (SELECT ROW(a, a::text) AS r FROM pooltab) s});
+is($result, '1000', 'leader with another library loaded');
+
+my $four_idle_workers = q{
+SELECT count(*) = 4 FROM pg_stat_activity
+WHERE backend_type = 'parallel worker' AND wait_event = 'ParallelWorkerIdle'};
+$node->poll_query_until('postgres', $four_idle_workers)
+  or die "timed out waiting for new parallel workers to go idle";
+
+# Workers are only handed to leaders of the same database.
+$node->safe_psql('postgres', 'CREATE DATABASE otherdb');
+$node->safe_psql(
+	'otherdb', q{
+CREATE TABLE pooltab (a int) WITH (parallel_workers = 2);
+INSERT INTO pooltab SELECT generate_series(1, 10);
+ANALYZE pooltab;
+});
+$result = $node->safe_psql(
+	'otherdb', q{
+SELECT count(*) FROM (SELECT ROW(a, a::text) AS r FROM pooltab) s});
+is($result, '10', 'leader in another database');
+
+$node->stop;
@@ -92,6 +92,21 @@ FROM (VALUES ('-infinity'), ('infinity')) v(x);
 SELECT sum(x::numeric), avg(x::numeric), var_pop(x::numeric)
 FROM (VALUES ('-infinity'), ('-infinity')) v(x);
 
+-- verify sums of inputs with mixed scales, including inverse transitions
+SELECT sum(x::numeric), avg(x::numeric)
+FROM (VALUES ('1.25'), ('-0.5'), ('100000000000000000000.1'), ('0.001'), ('2.50')) v(x);
+SELECT sum(x::numeric), avg(x::numeric)
+FROM (VALUES ('12.34'), ('-12.34'), ('0.01')) v(x);
+SELECT i, sum(x::numeric) OVER (ORDER BY i ROWS BETWEEN 1 PRECEDING AND CURRENT ROW)
+FROM (VALUES (1, '1.5'), (2, '2.25'), (3, '-1.25'), (4, '3')) v(i, x)
+ORDER BY i;
+
+-- inputs at the edge of the int64 range of the integer sum
+SELECT sum(x::numeric), avg(x::numeric)
+FROM (VALUES ('9223372036854775807'), ('9223372036854775808'), ('-9223372036854775808')) v(x);
+SELECT sum(x::numeric), avg(x::numeric)
+FROM (VALUES ('922337203685477.5807'), ('922337203685477.9999'), ('-0.0001')) v(x);
+
 -- test accuracy with a large input offset
 SELECT avg(x::float8), var_pop(x::float8)
 FROM (VALUES (100000003), (100000004), (100000006), (100000007)) v(x);
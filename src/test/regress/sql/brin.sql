@@ -509,3 +509,12 @@ SELECT * FROM brintest_3 WHERE b < '0';
 
 DROP TABLE brintest_3;
 RESET enable_seqscan;
+
+-- Test that autosummarize summarizes each new page range as it starts,
+-- leaving nothing for brin_summarize_new_values to do
+CREATE TABLE brin_autosum (a int) WITH (fillfactor = 10);
+CREATE INDEX brin_autosum_idx ON brin_autosum USING brin (a)
+  WITH (pages_per_range = 1, autosummarize = on);
+INSERT INTO brin_autosum SELECT generate_series(1, 1000);
+SELECT brin_summarize_new_values('brin_autosum_idx');
+DROP TABLE brin_autosum;
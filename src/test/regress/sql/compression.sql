@@ -144,6 +144,20 @@ SELECT length(f1) FROM cmmove1;
 SELECT length(f1) FROM cmmove2;
 SELECT length(f1) FROM cmmove3;
 
+-- values larger than a block are compressed in blocks, so check slices
+-- that start and end in different blocks, for both external and inline values
+CREATE TABLE cmblocks (id int, f1 text COMPRESSION pglz);
+INSERT INTO cmblocks SELECT 1, string_agg(repeat(md5(g::text), 10), '' ORDER BY g)
+  FROM generate_series(1, 1000) g;
+INSERT INTO cmblocks VALUES (2, repeat('x', 100000));
+SELECT id, pg_column_compression(f1), length(f1) FROM cmblocks ORDER BY id;
+SELECT id, bool_and(substr(f1, o, 100) = substr(f1 || '', o, 100))
+  FROM cmblocks, unnest(ARRAY[1, 65500, 65536, 65537, 131000, 319950, 320001]) o
+  GROUP BY id ORDER BY id;
+SELECT md5(f1) = (SELECT md5(string_agg(repeat(md5(g::text), 10), '' ORDER BY g))
+  FROM generate_series(1, 1000) g) FROM cmblocks WHERE id = 1;
+DROP TABLE cmblocks;
+
 CREATE TABLE badcompresstbl (a text COMPRESSION I_Do_Not_Exist_Compression); -- fails
 CREATE TABLE badcompresstbl (a text);
 ALTER TABLE badcompresstbl ALTER a SET COMPRESSION I_Do_Not_Exist_Compression; -- fails
@@ -66,6 +66,7 @@ COPY x from stdin (force_not_null (a), force_not_null (b));
 COPY x from stdin (force_null (a), force_null (b));
 COPY x from stdin (convert_selectively (a), convert_selectively (b));
 COPY x from stdin (encoding 'sql_ascii', encoding 'sql_ascii');
+COPY x from stdin (parallel off, parallel on);
 
 -- too many columns in column list: should fail
 COPY x (a, b, c, d, e, d, c) from stdin;
@@ -143,6 +144,32 @@ COPY x TO stdout;
 COPY x (c, e) TO stdout;
 COPY x (b, e) TO stdout WITH NULL 'I''m null';
 
+-- PARALLEL allows a parallel scan, but temp tables are never scanned in
+-- parallel, so the order is the same
+COPY x (c, e) TO stdout (parallel);
+-- only for COPY TO
+COPY x from stdin (parallel);
+-- a plain table can get a parallel scan (see contrib/auto_explain's tests
+-- for the plan); its rows are all the same, so the order doesn't matter.
+-- As without PARALLEL, the rows of inheritance children are not included.
+CREATE TABLE copy_parallel (a int, b text) WITH (parallel_workers = 2);
+INSERT INTO copy_parallel SELECT 1, 'one' FROM generate_series(1, 5);
+CREATE TABLE copy_parallel_child () INHERITS (copy_parallel);
+INSERT INTO copy_parallel_child VALUES (2, 'two');
+ANALYZE copy_parallel;
+BEGIN;
+SET LOCAL parallel_setup_cost = 0;
+SET LOCAL parallel_tuple_cost = 0;
+SET LOCAL min_parallel_table_scan_size = 0;
+SET LOCAL max_parallel_workers_per_gather = 2;
+COPY copy_parallel TO stdout (parallel);
+COMMIT;
+-- only for plain tables
+CREATE VIEW copy_parallel_view AS SELECT * FROM copy_parallel;
+COPY copy_parallel_view TO stdout (parallel);
+DROP VIEW copy_parallel_view;
+DROP TABLE copy_parallel_child, copy_parallel;
+
 CREATE TEMP TABLE y (
 	col1 text,
 	col2 text
@@ -1829,3 +1829,20 @@ UPDATE fkpart10.tbl1 SET f1 = 2 WHERE f1 = 1;
 INSERT INTO fkpart10.tbl1 VALUES (0), (1);
 COMMIT;
 DROP SCHEMA fkpart10 CASCADE;
+
+-- test that FK checks skipped for keys already found in the same statement
+-- don't let violations through
+CREATE TABLE fkcache_pk (a text PRIMARY KEY);
+CREATE TABLE fkcache_fk (a text REFERENCES fkcache_pk);
+INSERT INTO fkcache_pk VALUES ('one'), ('two');
+INSERT INTO fkcache_fk
+  SELECT CASE WHEN g % 2 = 0 THEN 'one' ELSE 'two' END
+  FROM generate_series(1, 10) g;
+INSERT INTO fkcache_fk VALUES ('one'), ('three'), ('one');
+BEGIN;
+DELETE FROM fkcache_fk;
+DELETE FROM fkcache_pk WHERE a = 'one';
+INSERT INTO fkcache_fk VALUES ('one');
+ROLLBACK;
+SELECT a, count(*) FROM fkcache_fk GROUP BY a ORDER BY a;
+DROP TABLE fkcache_fk, fkcache_pk;
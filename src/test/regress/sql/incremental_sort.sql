@@ -205,6 +205,23 @@ delete from t;
 
 drop table t;
 
+-- Merge join whose outer input is already sorted on a prefix of the merge
+-- keys: that input gets an incremental sort, the inner one a full sort
+create table t1 (a int, b int);
+create table t2 (a int, b int);
+insert into t1 select mod(i, 10), i from generate_series(1, 1000) s(i);
+insert into t2 select mod(i, 10), i from generate_series(1, 1000) s(i);
+create index on t1 (a);
+analyze t1, t2;
+begin;
+set local enable_hashjoin = off;
+set local enable_nestloop = off;
+set local enable_seqscan = off;
+explain (costs off) select count(*) from t1 join t2 on t1.a = t2.a and t1.b = t2.b;
+select count(*) from t1 join t2 on t1.a = t2.a and t1.b = t2.b;
+rollback;
+drop table t1, t2;
+
 -- Incremental sort vs. parallel queries
 set min_parallel_table_scan_size = '1kB';
 set min_parallel_index_scan_size = '1kB';
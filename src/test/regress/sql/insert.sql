@@ -624,3 +624,21 @@ alter table returningwrtest2 drop c;
 alter table returningwrtest attach partition returningwrtest2 for values in (2);
 insert into returningwrtest values (2, 'foo') returning returningwrtest;
 drop table returningwrtest;
+
+-- check routing of runs of tuples to the same partition, for which the bound
+-- found for the previous tuples is tried first
+create table routing_cache (a int, b text) partition by range (a);
+create table routing_cache1 partition of routing_cache for values from (1) to (50);
+create table routing_cache2 partition of routing_cache for values from (50) to (100);
+create table routing_cache_def partition of routing_cache default;
+insert into routing_cache select g, 'x' from generate_series(1, 120) g;
+insert into routing_cache select g, 'y' from generate_series(120, 1, -1) g;
+select tableoid::regclass, count(*), min(a), max(a) from routing_cache group by 1 order by 1;
+drop table routing_cache;
+create table routing_cache (a int) partition by list (a);
+create table routing_cache1 partition of routing_cache for values in (1, 2);
+create table routing_cache2 partition of routing_cache for values in (3);
+create table routing_cache_def partition of routing_cache default;
+insert into routing_cache select g / 20 from generate_series(0, 99) g;
+select tableoid::regclass, count(*), min(a), max(a) from routing_cache group by 1 order by 1;
+drop table routing_cache;
@@ -386,6 +386,30 @@ select count(*) from tenk1 x where
   x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
 rollback;
 
+-- and with the greedy join search
+begin;
+set geqo = on;
+set geqo_threshold = 2;
+set geqo_greedy = on;
+select count(*) from tenk1 x where
+  x.unique1 in (select a.f1 from int4_tbl a,float8_tbl b where a.f1=b.f1) and
+  x.unique1 = 0 and
+  x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
+select count(*) from tenk1 a
+  join tenk1 b on a.unique1 = b.unique2
+  join int4_tbl c on a.unique1 = c.f1
+  left join onek d on b.unique2 = d.unique1;
+-- join order restrictions from outer joins and LATERAL references
+explain (costs off)
+  select unique2, x.*
+  from int4_tbl x left join lateral (select unique1, unique2 from tenk1 where f1 = unique1) ss on true;
+explain (costs off)
+  select * from int8_tbl a,
+    int8_tbl x left join lateral (select a.q1 from int4_tbl y) ss(z)
+      on x.q2 = ss.z
+  order by a.q1, a.q2, x.q1, x.q2, ss.z;
+rollback;
+
 --
 -- regression test: be sure we cope with proven-dummy append rels
 --
@@ -2279,3 +2303,50 @@ where exists (select 1 from j3
       and t1.unique1 < 1;
 
 drop table j3;
+
+--
+-- A multi-batch hash join builds a Bloom filter of the inner hash values,
+-- so that outer tuples it rules out aren't written to batch files.  The
+-- filter counts against hash_mem.
+--
+begin;
+set local work_mem = '4MB';
+set local hash_mem_multiplier = 1;
+set local max_parallel_workers_per_gather = 0;
+set local enable_mergejoin = off;
+set local enable_nestloop = off;
+
+create temp table bloom_inner as
+  select g as id from generate_series(1, 100000) g;
+create temp table bloom_outer as
+  select g * 2 as id from generate_series(1, 200000) g;
+analyze bloom_inner;
+analyze bloom_outer;
+
+create function bloom_hash_stats(query text)
+returns table (multi_batch bool, within_hash_mem bool) language plpgsql
+as
+$$
+declare
+  whole_plan json;
+  hash_node json;
+begin
+  for whole_plan in
+    execute 'explain (analyze, format ''json'') ' || query
+  loop
+    hash_node := json_extract_path(whole_plan, '0', 'Plan', 'Plans', '0',
+                                   'Plans', '1');
+    multi_batch := (hash_node->>'Hash Batches')::int > 1;
+    within_hash_mem := (hash_node->>'Peak Memory Usage')::bigint <=
+      pg_size_bytes(current_setting('work_mem')) / 1024;
+    return next;
+  end loop;
+end;
+$$;
+
+explain (costs off)
+select count(*) from bloom_outer o join bloom_inner i using (id);
+select count(*) from bloom_outer o join bloom_inner i using (id);
+select * from bloom_hash_stats(
+  'select count(*) from bloom_outer o join bloom_inner i using (id)');
+rollback;
@@ -473,6 +473,16 @@ SELECT '{"f2":{"f3":1},"f4":{"f5":99,"f6":"stringy"}}'::jsonb#>>array['f2'];
 SELECT '{"f2":["f3",1],"f4":{"f5":99,"f6":"stringy"}}'::jsonb#>>array['f2','0'];
 SELECT '{"f2":["f3",1],"f4":{"f5":99,"f6":"stringy"}}'::jsonb#>>array['f2','1'];
 
+-- several extractions from the same toasted document
+CREATE TEMP TABLE test_jsonb_toast AS
+SELECT i, jsonb_build_object('id', i, 'arr', jsonb_build_array(i, i + 1),
+  'pad', (SELECT string_agg(md5((i * 1000 + g)::text), '')
+          FROM generate_series(1, 200) g)) AS j
+FROM generate_series(1, 3) i;
+SELECT i, j -> 'id', j ->> 'id', j -> 'arr' -> 1, j #>> '{arr,0}', j #> '{}' = j,
+  length(j ->> 'pad')
+FROM test_jsonb_toast ORDER BY i;
+
 -- corner cases for same
 select '{"a": {"b":{"c": "foo"}}}'::jsonb #> '{}';
 select '[1,2,3]'::jsonb #> '{}';
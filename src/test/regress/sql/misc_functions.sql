@@ -39,6 +39,18 @@ SELECT num_nulls();
 --
 SELECT * FROM pg_log_backend_memory_contexts(pg_backend_pid());
 
+--
+-- pg_get_process_memory_contexts()
+--
+-- Asking for our own memory contexts goes through the same signal and
+-- shared memory handoff as asking another backend.
+--
+SELECT name, level FROM pg_get_process_memory_contexts(pg_backend_pid())
+  WHERE level = 0;
+
+SELECT allocated_bytes > 0 AS ok FROM pg_stat_activity
+  WHERE pid = pg_backend_pid();
+
 --
 -- Test some built-in SRFs
 --
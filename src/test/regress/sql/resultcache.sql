@@ -91,3 +91,19 @@ RESET max_parallel_workers_per_gather;
 RESET parallel_tuple_cost;
 RESET parallel_setup_cost;
 RESET min_parallel_table_scan_size;
+
+-- Result Cache atop correlated subplans.
+SET enable_subplan_resultcache TO on;
+-- Ensure the scalar subplan gets a Result Cache.
+EXPLAIN (COSTS OFF)
+SELECT COUNT(*), SUM((SELECT t2.unique1 FROM tenk1 t2
+                      WHERE t2.unique1 = t1.twenty))
+FROM tenk1 t1 WHERE t1.unique1 < 1000;
+SELECT COUNT(*), SUM((SELECT t2.unique1 FROM tenk1 t2
+                      WHERE t2.unique1 = t1.twenty))
+FROM tenk1 t1 WHERE t1.unique1 < 1000;
+SELECT COUNT(*) FILTER (WHERE EXISTS (SELECT 1 FROM tenk1 t2
+                                      WHERE t2.unique1 = t1.twenty
+                                      AND t2.ten = 3))
+FROM tenk1 t1 WHERE t1.unique1 < 1000;
+RESET enable_subplan_resultcache;
@@ -176,4 +176,45 @@ FROM prevstats AS pr;
 
 DROP TABLE trunc_stats_test, trunc_stats_test1, trunc_stats_test2, trunc_stats_test3, trunc_stats_test4;
 DROP TABLE prevstats;
+
+-- test that pg_stat_io counts the checkpointer's writes, and that
+-- pg_stat_reset_shared('io') resets the counters
+create function wait_for_checkpointer_writes(prev numeric) returns void as $$
+declare
+  updated bool;
+begin
+  -- we don't want to wait forever; loop will exit after 30 seconds
+  for i in 1 .. 300 loop
+    SELECT sum(writes) <> prev INTO updated
+      FROM pg_stat_io WHERE backend_type = 'checkpointer';
+
+    exit when updated;
+
+    -- wait a little
+    perform pg_sleep_for('100 milliseconds');
+
+    -- reset stats snapshot so we can test again
+    perform pg_stat_clear_snapshot();
+  end loop;
+end
+$$ language plpgsql;
+
+SELECT sum(writes) AS io_writes_before
+  FROM pg_stat_io WHERE backend_type = 'checkpointer' \gset
+CREATE TABLE io_stats_test (a int);
+INSERT INTO io_stats_test SELECT generate_series(1, 100);
+CHECKPOINT;
+SELECT wait_for_checkpointer_writes(:io_writes_before);
+SELECT sum(writes) > :io_writes_before AS writes_counted
+  FROM pg_stat_io WHERE backend_type = 'checkpointer';
+SELECT sum(writes) AS io_writes_after, max(stats_reset) AS io_stats_reset
+  FROM pg_stat_io WHERE backend_type = 'checkpointer' \gset
+SELECT pg_stat_reset_shared('io');
+SELECT wait_for_checkpointer_writes(:io_writes_after);
+SELECT sum(writes) < :io_writes_after AS writes_reset,
+       max(stats_reset) > :'io_stats_reset' AS reset_newer
+  FROM pg_stat_io WHERE backend_type = 'checkpointer';
+DROP TABLE io_stats_test;
+DROP FUNCTION wait_for_checkpointer_writes(numeric);
+
 -- End of Stats Test
@@ -227,6 +227,11 @@ SELECT regexp_matches('foobarbequebaz', $re$(bar)(beque)$re$, 'gz');
 SELECT regexp_matches('foobarbequebaz', $re$(barbeque$re$);
 SELECT regexp_matches('foobarbequebaz', $re$(bar)(beque){2,1}$re$);
 
+-- patterns starting with literal text, which a match has to contain
+SELECT 'foobarbequebaz' ~ 'beque' AS "true", 'foobarbequebaz' ~ 'bequx' AS "false";
+SELECT 'foobaz' ~ 'foox?baz' AS "true", 'fobaz' ~ 'foo*baz' AS "true", 'fobaz' ~ 'foo+baz' AS "false";
+SELECT 'xyz' ~ 'abc|xyz' AS "true", 'ABC' ~* 'abc' AS "true", 'abc' ~ 'abc$' AS "true";
+
 -- split string on regexp
 SELECT foo, length(foo) FROM regexp_split_to_table('the quick brown fox jumps over the lazy dog', $re$\s+$re$) AS foo;
 SELECT regexp_split_to_array('the quick brown fox jumps over the lazy dog', $re$\s+$re$);
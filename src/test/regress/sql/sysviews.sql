@@ -40,9 +40,22 @@ select count(*) >= 0 as ok from pg_prepared_xacts;
 -- There must be only one record
 select count(*) = 1 as ok from pg_stat_wal;
 
+-- One row per tranche, with extension tranches combined into one
+select count(*) = 3 as ok from pg_stat_lwlock
+  where tranche in ('ProcArray', 'BufferMapping', 'extension')
+    and array_length(wait_time_histogram, 1) = 20;
+
 -- We expect no walreceiver running in this test
 select count(*) = 0 as ok from pg_stat_wal_receiver;
 
+-- A query that reads pg_stat_progress_query is itself being reported
+set track_query_progress = on;
+select count(*) = 1 as ok from pg_stat_progress_query
+  where pid = pg_backend_pid() and datname = current_database();
+reset track_query_progress;
+select count(*) = 0 as ok from pg_stat_progress_query
+  where pid = pg_backend_pid();
+
 -- This is to record the prevailing planner enable_foo settings during
 -- a regression test run.
 select name, setting from pg_settings where name like 'enable%';
@@ -1328,3 +1328,26 @@ $$ LANGUAGE SQL STABLE;
 
 EXPLAIN (costs off) SELECT * FROM pg_temp.f(2);
 SELECT * FROM pg_temp.f(2);
+
+-- sliding min/max over a moving frame head
+SELECT i, min(v) OVER w, max(v) OVER w,
+       max(v) FILTER (WHERE i <> 4) OVER w AS fmax
+  FROM (VALUES (1,5),(2,3),(3,NULL),(4,8),(5,1),(6,7)) t(i,v)
+WINDOW w AS (ORDER BY i ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING);
+
+-- a frame of more than 64 rows makes the ring buffer grow; check against
+-- computing each frame's aggregates separately
+SELECT count(*) FROM
+  (SELECT i, min(v) OVER w AS mn, max(v) OVER w AS mx,
+          bit_or(v) OVER w AS bo
+     FROM (SELECT i, (i * 37) % 101 AS v FROM generate_series(1, 300) i) t
+   WINDOW w AS (ORDER BY i ROWS BETWEEN 99 PRECEDING AND 10 FOLLOWING)) s,
+  LATERAL (SELECT min(v) AS mn, max(v) AS mx, bit_or(v) AS bo
+             FROM (SELECT (j * 37) % 101 AS v
+                     FROM generate_series(greatest(s.i - 99, 1),
+                                          least(s.i + 10, 300)) j) f) c
+WHERE (s.mn, s.mx, s.bo) IS DISTINCT FROM (c.mn, c.mx, c.bo);
+
+-- float addition isn't associative, so sum(float8) must not slide
+SELECT i, sum(v) OVER (ORDER BY i ROWS BETWEEN 2 PRECEDING AND CURRENT ROW)
+  FROM (VALUES (1,1::float8),(2,1e20),(3,-1e20),(4,1),(5,1e20),(6,-1e20)) t(i,v);
@@ -60,12 +60,12 @@ my @contrib_excludes = (
 my $frontend_defines = { 'initdb' => 'FRONTEND' };
 my @frontend_uselibpq = ('pg_amcheck', 'pg_ctl', 'pg_upgrade', 'pgbench', 'psql', 'initdb');
 my @frontend_uselibpgport = (
-	'pg_amcheck',        'pg_archivecleanup', 'pg_test_fsync',
-	'pg_test_timing',    'pg_upgrade',
+	'pg_amcheck',        'pg_archivecleanup', 'pg_test_costs',
+	'pg_test_fsync',     'pg_test_timing',    'pg_upgrade',
 	'pg_waldump',        'pgbench');
 my @frontend_uselibpgcommon = (
-	'pg_amcheck',        'pg_archivecleanup', 'pg_test_fsync',
-	'pg_test_timing',    'pg_upgrade',
+	'pg_amcheck',        'pg_archivecleanup', 'pg_test_costs',
+	'pg_test_fsync',     'pg_test_timing',    'pg_upgrade',
 	'pg_waldump',        'pgbench');
 my $frontend_extralibs = {
 	'initdb'     => ['ws2_32.lib'],
@@ -314,6 +314,7 @@ sub GenerateFiles
 		HAVE_LIBXSLT                                => undef,
 		HAVE_LIBZ                   => $self->{options}->{zlib} ? 1 : undef,
 		HAVE_LINK                   => undef,
+		HAVE_LINUX_MEMPOLICY_H      => undef,
 		HAVE_LOCALE_T               => 1,
 		HAVE_LONG_INT_64            => undef,
 		HAVE_LONG_LONG_INT_64       => 1,
@@ -488,6 +489,7 @@ sub GenerateFiles
 		USE_ARMV8_CRC32C                    => undef,
 		USE_ARMV8_CRC32C_WITH_RUNTIME_CHECK => undef,
 		USE_ASSERT_CHECKING => $self->{options}->{asserts} ? 1 : undef,
+		USE_AVX2_WITH_RUNTIME_CHECK => undef,
 		USE_BONJOUR         => undef,
 		USE_BSD_AUTH        => undef,
 		USE_ICU => $self->{options}->{icu} ? 1 : undef,